@@ -0,0 +1,153 @@
+#include "BenchHarness.h"
+#include "core/MonotonicClock.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+
+namespace JTAG {
+
+    volatile uint64_t benchSink = 0;
+
+    static double percentile(const std::vector<double>& sorted, double q) {
+        if (sorted.empty()) return 0.0;
+        size_t index = static_cast<size_t>(std::ceil(q * sorted.size())) - 1;
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+
+    BenchResult BenchRunner::measure(const BenchCase& benchCase) const {
+        const uint64_t minBatchNs = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(options.minBatch).count());
+
+        // Calibración: duplicar hasta que un lote dure minBatch (el primero sirve de calentamiento)
+        size_t iterations = 1;
+        for (;;) {
+            uint64_t start = monotonicNowNs();
+            benchCase.body(iterations);
+            uint64_t elapsed = monotonicNowNs() - start;
+            if (elapsed >= minBatchNs || iterations >= (size_t(1) << 30)) break;
+
+            // Salto directo a la estimación si el lote fue muy corto (evita muchas rondas)
+            double scale = elapsed > 0 ? static_cast<double>(minBatchNs) / elapsed : 1024.0;
+            iterations = static_cast<size_t>(iterations * std::clamp(scale * 1.2, 2.0, 1024.0));
+        }
+
+        std::vector<double> perIteration;
+        perIteration.reserve(options.repetitions);
+        for (size_t r = 0; r < options.repetitions; ++r) {
+            uint64_t start = monotonicNowNs();
+            benchCase.body(iterations);
+            uint64_t elapsed = monotonicNowNs() - start;
+            perIteration.push_back(static_cast<double>(elapsed) / iterations);
+        }
+        std::sort(perIteration.begin(), perIteration.end());
+
+        BenchResult result;
+        result.name = benchCase.name;
+        result.iterations = iterations;
+        result.repetitions = perIteration.size();
+        result.medianNs = percentile(perIteration, 0.5);
+        result.minNs = perIteration.front();
+        result.p90Ns = percentile(perIteration, 0.9);
+
+        double sum = 0, sumSq = 0;
+        for (double v : perIteration) { sum += v; sumSq += v * v; }
+        result.meanNs = sum / perIteration.size();
+        double variance = sumSq / perIteration.size() - result.meanNs * result.meanNs;
+        result.cv = result.meanNs > 0 ? std::sqrt(std::max(0.0, variance)) / result.meanNs : 0.0;
+
+        if (benchCase.itemsPerIteration > 0 && result.medianNs > 0) {
+            result.itemsPerSecond = benchCase.itemsPerIteration * 1e9 / result.medianNs;
+            result.itemUnit = benchCase.itemUnit;
+        }
+        return result;
+    }
+
+    bool BenchRunner::selected(const BenchCase& benchCase) const {
+        return options.filter.empty() || benchCase.name.find(options.filter) != std::string::npos;
+    }
+
+    std::vector<std::string> BenchRunner::names() const {
+        std::vector<std::string> result;
+        for (const auto& benchCase : cases) {
+            if (selected(benchCase)) result.push_back(benchCase.name);
+        }
+        return result;
+    }
+
+    std::vector<BenchResult> BenchRunner::run() {
+        std::vector<BenchResult> results;
+        for (const auto& benchCase : cases) {
+            if (!selected(benchCase)) continue;
+
+            BenchResult result = measure(benchCase);
+            std::cerr << std::left << std::setw(44) << result.name << std::right
+                      << std::setw(14) << std::fixed << std::setprecision(1) << result.medianNs << " ns"
+                      << "  (min " << result.minNs << ", p90 " << result.p90Ns
+                      << ", cv " << std::setprecision(3) << result.cv << ")";
+            if (result.itemsPerSecond > 0) {
+                std::cerr << "  " << std::setprecision(0) << result.itemsPerSecond << " " << result.itemUnit << "/s";
+            }
+            std::cerr << "\n";
+            results.push_back(std::move(result));
+        }
+        return results;
+    }
+
+    JsonValue BenchRunner::toJson(const std::vector<BenchResult>& results) {
+        JsonValue list = JsonValue::array();
+        for (const auto& r : results) {
+            JsonValue item = JsonValue::object();
+            item.set("name", r.name);
+            item.set("iterations", static_cast<uint64_t>(r.iterations));
+            item.set("repetitions", static_cast<uint64_t>(r.repetitions));
+            item.set("median_ns", r.medianNs);
+            item.set("min_ns", r.minNs);
+            item.set("p90_ns", r.p90Ns);
+            item.set("mean_ns", r.meanNs);
+            item.set("cv", r.cv);
+            if (r.itemsPerSecond > 0) {
+                item.set("items_per_second", r.itemsPerSecond);
+                item.set("item_unit", r.itemUnit);
+            }
+            list.push(std::move(item));
+        }
+
+        JsonValue doc = JsonValue::object();
+        doc.set("format", "jtag-bench-1");
+#if defined(NDEBUG)
+        doc.set("optimized", true);
+#else
+        doc.set("optimized", false);
+#endif
+        doc.set("benchmarks", std::move(list));
+        return doc;
+    }
+
+    size_t BenchRunner::compare(const std::vector<BenchResult>& results, const JsonValue& baseline,
+                                double thresholdPercent) {
+        size_t regressions = 0;
+        const double limit = 1.0 + thresholdPercent / 100.0;
+
+        for (const auto& r : results) {
+            const JsonValue* base = nullptr;
+            for (const auto& item : baseline["benchmarks"].asArray()) {
+                if (item["name"].asString() == r.name) { base = &item; break; }
+            }
+            if (!base || (*base)["median_ns"].asNumber() <= 0) continue;
+
+            double ratio = r.medianNs / (*base)["median_ns"].asNumber();
+            if (ratio > limit) {
+                regressions++;
+                std::cerr << "REGRESSION " << r.name << ": " << std::fixed << std::setprecision(1)
+                          << (*base)["median_ns"].asNumber() << " ns -> " << r.medianNs << " ns (+"
+                          << (ratio - 1.0) * 100.0 << "%)\n";
+            } else if (ratio < 1.0 / limit) {
+                std::cerr << "improved   " << r.name << ": " << std::fixed << std::setprecision(1)
+                          << (1.0 - ratio) * 100.0 << "% faster\n";
+            }
+        }
+        return regressions;
+    }
+
+} // namespace JTAG
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+#include "core/Json.h"
+
+namespace JTAG {
+
+    // Sumidero para que el compilador no elimine el trabajo medido
+    extern volatile uint64_t benchSink;
+    inline void benchKeep(uint64_t value) { benchSink = benchSink + value; }
+
+    // Cuerpo de un benchmark: ejecuta 'iterations' repeticiones de la operación medida
+    using BenchFn = std::function<void(size_t iterations)>;
+
+    struct BenchCase {
+        std::string name;           // "grupo.operación/parámetro"
+        BenchFn body;
+        double itemsPerIteration = 0;   // > 0: se informa también items/s (celdas, bits, muestras)
+        std::string itemUnit;
+    };
+
+    struct BenchResult {
+        std::string name;
+        size_t iterations = 0;      // Iteraciones por repetición (calibradas)
+        size_t repetitions = 0;
+        double medianNs = 0;        // Por iteración; la cifra que se compara entre ejecuciones
+        double minNs = 0;
+        double p90Ns = 0;
+        double meanNs = 0;
+        double cv = 0;              // Coeficiente de variación entre repeticiones
+        double itemsPerSecond = 0;
+        std::string itemUnit;
+    };
+
+    struct BenchOptions {
+        std::string filter;                                 // Subcadena del nombre
+        size_t repetitions = 15;
+        std::chrono::milliseconds minBatch{ 20 };           // Duración mínima de cada repetición
+    };
+
+    /**
+     * @brief Ejecutor mínimo de microbenchmarks (sin dependencias externas)
+     *
+     * Cada caso se calibra duplicando iteraciones hasta que una repetición dura
+     * al menos minBatch, se calienta una vez y se mide 'repetitions' veces.
+     * La mediana por iteración es la cifra estable que se guarda y se compara
+     * con una línea base; min/p90/cv indican lo ruidosa que fue la medida.
+     */
+    class BenchRunner {
+    public:
+        explicit BenchRunner(BenchOptions options) : options(std::move(options)) {}
+
+        void add(BenchCase benchCase) { cases.push_back(std::move(benchCase)); }
+
+        std::vector<std::string> names() const;   // Casos que pasan el filtro
+        std::vector<BenchResult> run();
+
+        static JsonValue toJson(const std::vector<BenchResult>& results);
+
+        // Compara medianas con una línea base (mismo formato JSON). Devuelve el
+        // número de regresiones por encima de 'thresholdPercent'
+        static size_t compare(const std::vector<BenchResult>& results, const JsonValue& baseline,
+                              double thresholdPercent);
+
+    private:
+        bool selected(const BenchCase& benchCase) const;
+        BenchResult measure(const BenchCase& benchCase) const;
+
+        BenchOptions options;
+        std::vector<BenchCase> cases;
+    };
+
+} // namespace JTAG
@@ -0,0 +1,498 @@
+// jtag_bench - Microbenchmarks de los caminos calientes (BSDL → modelo → scan → GUI)
+//
+// Uso: jtag_bench [--filter <texto>] [--repetitions <n>] [--min-time <ms>]
+//                 [--json <salida.json | ->] [--baseline <base.json>] [--threshold <%>]
+//                 [--data <dir con .bsd/.bsdl>] [--list]
+//
+// Resultados: tabla legible en stderr y, con --json, un documento JSON por
+// benchmark (mediana/min/p90 por iteración). Con --baseline se comparan las
+// medianas y el código de salida es 2 si alguna empeora más que --threshold
+// (10 % por defecto): así CI detecta regresiones antes de llegar a las estaciones.
+//
+// El adaptador es MockAdapter sin latencia simulada: se mide solo el software.
+// Durante las medidas std::cout va al dispositivo nulo por un fichero real: el
+// formateo, los flush y las escrituras del log del camino caliente se pagan
+// como en la aplicación. Los mensajes de qDebug se descartan.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <memory>
+#include <algorithm>
+#include <filesystem>
+#include <cstdlib>
+
+#include <QApplication>
+#include <QGraphicsScene>
+#include <QImage>
+#include <QPainter>
+#include <QPen>
+
+#include "BenchHarness.h"
+#include "core/BitUtils.h"
+#include "core/BoundaryScanEngine.h"
+#include "parser/BSDLParser.h"
+#include "bsdl/DeviceModel.h"
+#include "bsdl/ModelCache.h"
+#include "hal/drivers/MockAdapter.h"
+#include "controller/ScanWorker.h"
+#include "controller/EngineExecutor.h"
+
+#ifndef JTAG_BENCH_DATA_DIR
+#define JTAG_BENCH_DATA_DIR "test_files"
+#endif
+
+namespace fs = std::filesystem;
+using namespace JTAG;
+
+namespace {
+
+    // ============================================================================
+    // DATOS DE ENTRADA
+    // ============================================================================
+
+    // BSDL sintético: grupos output3 + control + input por pin (como un FPGA grande)
+    std::string syntheticBsdl(size_t cells) {
+        const size_t pinCount = cells / 3;
+        const std::string entity = "SYNTH_" + std::to_string(cells);
+        std::ostringstream out;
+
+        out << "entity " << entity << " is\n"
+            << "  generic (PHYSICAL_PIN_MAP : string := \"BGA\");\n"
+            << "  port (\n";
+        for (size_t p = 0; p < pinCount; ++p) out << "    IO_" << p << " : inout bit;\n";
+        out << "    TCK, TDI, TMS : in bit;\n    TDO : out bit\n  );\n"
+            << "  use STD_1149_1_2001.all;\n"
+            << "  attribute PIN_MAP of " << entity << " : entity is PHYSICAL_PIN_MAP;\n"
+            << "  constant BGA : PIN_MAP_STRING :=\n";
+        for (size_t p = 0; p < pinCount; ++p) {
+            out << "    \"IO_" << p << " : " << (p + 1) << ",\" &\n";
+        }
+        out << "    \"TCK : T1, TDI : T2, TDO : T3, TMS : T4\";\n"
+            << "  attribute TAP_SCAN_IN of TDI : signal is true;\n"
+            << "  attribute TAP_SCAN_OUT of TDO : signal is true;\n"
+            << "  attribute TAP_SCAN_MODE of TMS : signal is true;\n"
+            << "  attribute TAP_SCAN_CLOCK of TCK : signal is (10.0e6, BOTH);\n"
+            << "  attribute INSTRUCTION_LENGTH of " << entity << " : entity is 10;\n"
+            << "  attribute INSTRUCTION_OPCODE of " << entity << " : entity is\n"
+            << "    \"BYPASS (1111111111), EXTEST (0000001111), SAMPLE (0000000101), IDCODE (0000000110)\";\n"
+            << "  attribute INSTRUCTION_CAPTURE of " << entity << " : entity is \"0101010101\";\n"
+            << "  attribute BOUNDARY_LENGTH of " << entity << " : entity is " << cells << ";\n"
+            << "  attribute BOUNDARY_REGISTER of " << entity << " : entity is\n";
+        for (size_t c = 0; c < cells; ++c) {
+            size_t p = c / 3;
+            out << "    \"" << c;
+            if (p >= pinCount) out << " (BC_4, *, internal, X)";
+            else if (c % 3 == 0) out << " (BC_1, IO_" << p << ", output3, X, " << c + 1 << ", 1, Z)";
+            else if (c % 3 == 1) out << " (BC_1, *, control, 1)";
+            else out << " (BC_1, IO_" << p << ", input, X)";
+            out << (c + 1 < cells ? ",\" &\n" : "\";\n");
+        }
+        out << "end " << entity << ";\n";
+        return out.str();
+    }
+
+    fs::path writeSyntheticBsdl(size_t cells) {
+        fs::path path = fs::temp_directory_path() / ("jtag_bench_synth_" + std::to_string(cells) + ".bsd");
+        std::ofstream file(path, std::ios::binary);
+        file << syntheticBsdl(cells);
+        return path;
+    }
+
+    // Engine sobre un MockAdapter de latencia cero
+    struct ScanRig {
+        MockAdapter adapter;
+        std::unique_ptr<BoundaryScanEngine> engine;
+
+        explicit ScanRig(size_t bsrLength) {
+            adapter.setLatencyEnabled(false);
+            adapter.open();
+            engine = std::make_unique<BoundaryScanEngine>(&adapter, bsrLength);
+        }
+    };
+
+    // ============================================================================
+    // CASOS
+    // ============================================================================
+
+    void addParseCases(BenchRunner& runner, const std::vector<std::pair<std::string, fs::path>>& files) {
+        for (const auto& [label, path] : files) {
+            runner.add({ "bsdl.parse/" + label, [path](size_t n) {
+                for (size_t i = 0; i < n; ++i) {
+                    BSDLParser parser;
+                    parser.parse(path);
+                    benchKeep(parser.getData().boundaryCells.size());
+                }
+            }, static_cast<double>(fs::file_size(path)), "bytes" });
+        }
+    }
+
+    void addModelCases(BenchRunner& runner, const std::string& label, const fs::path& path) {
+        BSDLParser parser;
+        if (!parser.parse(path)) return;
+        auto data = std::make_shared<BSDLData>(parser.getData());
+
+        runner.add({ "device_model.load/" + label, [data](size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                DeviceModel model;
+                model.loadFromData(*data);
+                benchKeep(model.getPinCount());
+            }
+        }, static_cast<double>(data->boundaryCells.size()), "cells" });
+
+        // Consulta por nombre de todos los pines (patrón de updatePinsTable / getPin)
+        auto model = std::make_shared<DeviceModel>();
+        model->loadFromData(*data);
+        auto names = std::make_shared<std::vector<std::string>>(model->getPinNames());
+        runner.add({ "device_model.pin_lookup/" + label, [model, names](size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                int64_t cells = 0;
+                for (const auto& name : *names) {
+                    auto info = model->getPinInfo(name);
+                    if (info) cells += info->inputCell + info->outputCell;
+                }
+                benchKeep(cells);
+            }
+        }, static_cast<double>(names->size()), "pins" });
+
+        // Mismo BSDL desde la caché compilada (hash + mmap + materializar pines)
+        auto cache = std::make_shared<ModelCache>(fs::temp_directory_path() / "jtag_bench_models");
+        fs::create_directories(cache->getDirectory());
+        if (!cache->load(path)) return;
+
+        runner.add({ "device_model.load_cached/" + label, [cache, path](size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                auto model = cache->load(path);
+                benchKeep(model ? model->getPinCount() : 0);
+            }
+        }, static_cast<double>(data->boundaryCells.size()), "cells" });
+    }
+
+    void addBitCases(BenchRunner& runner, size_t bsrLength) {
+        const std::string suffix = "/" + std::to_string(bsrLength);
+
+        auto buffer = std::make_shared<std::vector<uint8_t>>(bytesForBits(bsrLength), 0);
+        runner.add({ "bsr.bitutils_set_get" + suffix, [buffer, bsrLength](size_t n) {
+            uint8_t* bits = buffer->data();
+            for (size_t i = 0; i < n; ++i) {
+                for (size_t c = 0; c < bsrLength; ++c) setBit(bits, c, ((c + i) & 3) == 0);
+                uint64_t ones = 0;
+                for (size_t c = 0; c < bsrLength; ++c) ones += getBit(bits, c);
+                benchKeep(ones);
+            }
+        }, static_cast<double>(bsrLength), "cells" });
+
+        auto rig = std::make_shared<ScanRig>(bsrLength);
+        runner.add({ "bsr.engine_set_get_pin" + suffix, [rig, bsrLength](size_t n) {
+            BoundaryScanEngine& engine = *rig->engine;
+            for (size_t i = 0; i < n; ++i) {
+                for (size_t c = 0; c < bsrLength; ++c) {
+                    engine.setPin(c, ((c + i) & 3) == 0 ? PinLevel::HIGH : PinLevel::LOW);
+                }
+                uint64_t ones = 0;
+                for (size_t c = 0; c < bsrLength; ++c) ones += (engine.getPin(c) == PinLevel::HIGH);
+                benchKeep(ones);
+            }
+        }, static_cast<double>(bsrLength), "cells" });
+    }
+
+    void addScanCases(BenchRunner& runner, const std::string& label, const fs::path& path) {
+        BSDLParser parser;
+        if (!parser.parse(path)) return;
+        auto model = std::make_shared<DeviceModel>();
+        model->loadFromData(parser.getData());
+        const size_t bsrLength = model->getBSRLength();
+        auto rig = std::make_shared<ScanRig>(bsrLength);
+
+        // Bucle real del worker (SAMPLE continuo) sin esperas: periodo mínimo → cada ciclo
+        // es un overrun y se encadena con el siguiente. Una iteración = un ciclo completo
+        // (scan + conversión + emisión de la instantánea)
+        auto worker = std::make_shared<ScanWorker>(rig->engine.get(), model.get());
+        auto remaining = std::make_shared<size_t>(0);
+        QObject::connect(worker.get(), &ScanWorker::pinsUpdated, worker.get(),
+            [worker = worker.get(), remaining](std::shared_ptr<const PinSnapshot> snapshot) {
+                benchKeep(snapshot->sequence);
+                if (--*remaining == 0) worker->stop();
+            }, Qt::DirectConnection);
+        worker->setPollPeriod(std::chrono::nanoseconds(1));
+
+        runner.add({ "scan_worker.sample_cycle/" + label, [rig, model, worker, remaining](size_t n) {
+            *remaining = n;
+            worker->start();
+            worker->run();
+        }, 1.0, "scans" });
+
+        // Captura → instantánea para la GUI (lo que hace el worker tras cada scan)
+        rig->engine->samplePins();
+        auto decoder = std::make_shared<PinDecoder>();
+        runner.add({ "snapshot.convert/" + label, [rig, model, decoder](size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                std::vector<PinState> pins;
+                ScanWorker::convertPins(*rig->engine, *model, ScanMode::SAMPLE, *decoder, pins);
+                auto snapshot = std::make_shared<PinSnapshot>();
+                snapshot->pins = std::move(pins);
+                benchKeep(snapshot->pins.size());
+            }
+        }, static_cast<double>(model->getPinCount()), "pins" });
+
+        // Solo el bucle de decodificación, sobre un vector reutilizado
+        runner.add({ "pin_decoder.decode/" + label, [rig, model, decoder](size_t n) {
+            const PinDecodePlan& plan = model->getDecodePlan();
+            const uint8_t* capture = rig->engine->getBSRCapture().data();
+            std::vector<PinState> states;
+            for (size_t i = 0; i < n; ++i) {
+                decoder->decode(plan, capture, capture, states);
+                benchKeep(states.empty() ? 0 : states[i % states.size()].bits);
+            }
+        }, static_cast<double>(model->getPinCount()), "pins" });
+    }
+
+    // ============================================================================
+    // EXECUTOR DEL ENGINE (coste de cada llamada del controlador)
+    // ============================================================================
+
+    struct ExecutorRig {
+        JtagSession session;
+        EngineExecutor executor{ session };
+    };
+
+    void addExecutorCases(BenchRunner& runner) {
+        // Sin adaptador: solo el viaje de ida y vuelta al hilo del executor
+        auto rig = std::make_shared<ExecutorRig>();
+        runner.add({ "engine_executor.call_roundtrip", [rig](size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                benchKeep(rig->executor.call([i](JtagSession&) { return i; }));
+            }
+        }, 1.0, "calls" });
+    }
+
+    // ============================================================================
+    // WAVEFORM (misma estructura de datos y primitivas que MainWindow)
+    // ============================================================================
+
+    struct WaveformSample {
+        double timestamp;
+        PinLevel level;
+    };
+    using WaveformBuffer = std::map<std::string, std::deque<WaveformSample>>;
+    constexpr size_t MAX_WAVEFORM_SAMPLES = 10000;
+
+    struct WaveformSignal {
+        std::string name;
+        size_t dataIndex;
+    };
+
+    std::vector<WaveformSignal> makeSignals(size_t count, size_t bsrLength) {
+        std::vector<WaveformSignal> signalList;
+        for (size_t s = 0; s < count; ++s) {
+            signalList.push_back({ "IO_" + std::to_string(s), (s * 3 + 2) % bsrLength });
+        }
+        return signalList;
+    }
+
+    void addWaveformCases(BenchRunner& runner) {
+        const size_t bsrLength = 1000;
+        const size_t signalCount = 32;
+
+        // Append: una instantánea por iteración, buffers ya llenos (régimen estacionario con pop_front)
+        auto signalList = std::make_shared<std::vector<WaveformSignal>>(makeSignals(signalCount, bsrLength));
+        auto buffer = std::make_shared<WaveformBuffer>();
+        auto pins = std::make_shared<std::vector<PinLevel>>(bsrLength, PinLevel::LOW);
+        auto clock = std::make_shared<double>(0.0);
+        for (const auto& sig : *signalList) {
+            auto& samples = (*buffer)[sig.name];
+            for (size_t i = 0; i < MAX_WAVEFORM_SAMPLES; ++i) samples.push_back({ *clock + i * 1e-3, PinLevel::LOW });
+        }
+        *clock = MAX_WAVEFORM_SAMPLES * 1e-3;
+
+        runner.add({ "waveform.append/" + std::to_string(signalCount) + "sig",
+            [signalList, buffer, pins, clock](size_t n) {
+                for (size_t i = 0; i < n; ++i) {
+                    (*pins)[(i * 7) % pins->size()] = (i & 1) ? PinLevel::HIGH : PinLevel::LOW;
+                    *clock += 1e-3;
+                    for (const auto& sig : *signalList) {
+                        auto& samples = (*buffer)[sig.name];
+                        samples.push_back({ *clock, (*pins)[sig.dataIndex] });
+                        if (samples.size() > MAX_WAVEFORM_SAMPLES) samples.pop_front();
+                    }
+                }
+                benchKeep(buffer->size());
+            }, static_cast<double>(signalCount), "samples" });
+
+        // Render: escena con una línea por tramo y transición (como redrawWaveform) + pintado
+        const size_t renderSignals = 16;
+        const size_t renderSamples = 5000;
+        auto renderBuffer = std::make_shared<std::vector<std::vector<WaveformSample>>>(renderSignals);
+        for (size_t s = 0; s < renderSignals; ++s) {
+            auto& samples = (*renderBuffer)[s];
+            for (size_t i = 0; i < renderSamples; ++i) {
+                bool high = ((i >> (s % 5)) & 1) != 0;
+                samples.push_back({ i * 1e-3, high ? PinLevel::HIGH : PinLevel::LOW });
+            }
+        }
+        auto image = std::make_shared<QImage>(1600, static_cast<int>(renderSignals * 40), QImage::Format_ARGB32_Premultiplied);
+
+        runner.add({ "waveform.render/" + std::to_string(renderSignals) + "sig_" + std::to_string(renderSamples),
+            [renderBuffer, image](size_t n) {
+                const int SIGNAL_HEIGHT = 40;
+                const double PIXELS_PER_SECOND = 100.0 / 0.001;   // Timebase 1 ms/div
+                QPen signalPen(Qt::blue, 2);
+
+                for (size_t iter = 0; iter < n; ++iter) {
+                    QGraphicsScene scene;
+                    for (size_t row = 0; row < renderBuffer->size(); ++row) {
+                        const auto& samples = (*renderBuffer)[row];
+                        const int yBase = static_cast<int>(row) * SIGNAL_HEIGHT;
+                        for (size_t i = 1; i < samples.size(); ++i) {
+                            double x1 = samples[i - 1].timestamp * PIXELS_PER_SECOND;
+                            double x2 = samples[i].timestamp * PIXELS_PER_SECOND;
+                            int y1 = yBase + (samples[i - 1].level == PinLevel::HIGH ? 10 : 30);
+                            int y2 = yBase + (samples[i].level == PinLevel::HIGH ? 10 : 30);
+                            scene.addLine(x1, y1, x2, y1, signalPen);
+                            if (y1 != y2) scene.addLine(x2, y1, x2, y2, signalPen);
+                        }
+                    }
+                    image->fill(Qt::white);
+                    QPainter painter(image.get());
+                    scene.render(&painter, QRectF(image->rect()), QRectF(0, 0, image->width(), image->height()));
+                    benchKeep(static_cast<uint64_t>(scene.items().size()));
+                }
+            }, static_cast<double>(renderSignals * renderSamples), "samples" });
+    }
+
+    void discardQtMessages(QtMsgType, const QMessageLogContext&, const QString&) {}
+
+#ifdef _WIN32
+    constexpr const char* NULL_DEVICE = "NUL";
+#else
+    constexpr const char* NULL_DEVICE = "/dev/null";
+#endif
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    std::string jsonPath, baselinePath;
+    double threshold = 10.0;
+    bool list = false;
+    fs::path dataDir = JTAG_BENCH_DATA_DIR;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << arg << "\n";
+                std::exit(1);
+            }
+            return argv[++i];
+        };
+        if (arg == "--filter") options.filter = value();
+        else if (arg == "--repetitions") options.repetitions = std::max(1ul, std::strtoul(value().c_str(), nullptr, 10));
+        else if (arg == "--min-time") options.minBatch = std::chrono::milliseconds(std::strtoul(value().c_str(), nullptr, 10));
+        else if (arg == "--json") jsonPath = value();
+        else if (arg == "--baseline") baselinePath = value();
+        else if (arg == "--threshold") threshold = std::strtod(value().c_str(), nullptr);
+        else if (arg == "--data") dataDir = value();
+        else if (arg == "--list") list = true;
+        else {
+            std::cerr << "Unknown option: " << arg << "\n"
+                      << "Usage: jtag_bench [--filter <text>] [--repetitions <n>] [--min-time <ms>]\n"
+                      << "                  [--json <out.json|->] [--baseline <base.json>] [--threshold <%>]\n"
+                      << "                  [--data <dir>] [--list]\n";
+            return 1;
+        }
+    }
+
+    // Render del waveform sin ventana ni servidor gráfico
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+
+    // Log de engine/adaptador/worker al dispositivo nulo: no ensucia la tabla pero
+    // su coste (formateo + write por cada flush) sigue dentro de la medida
+    std::ofstream logSink(NULL_DEVICE);
+    std::streambuf* coutBuffer = std::cout.rdbuf();
+    if (logSink) std::cout.rdbuf(logSink.rdbuf());
+    qInstallMessageHandler(discardQtMessages);
+
+    // Ficheros reales (ordenados por nombre para que la lista sea estable) + sintéticos
+    std::vector<std::pair<std::string, fs::path>> files;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(dataDir, ec)) {
+        auto ext = entry.path().extension().string();
+        if (entry.is_regular_file() && (ext == ".bsd" || ext == ".bsdl")) {
+            files.push_back({ entry.path().filename().string(), entry.path() });
+        }
+    }
+    std::sort(files.begin(), files.end());
+    fs::path synth1k = writeSyntheticBsdl(1000);
+    fs::path synth10k = writeSyntheticBsdl(10000);
+    files.push_back({ "synthetic_1k", synth1k });
+    files.push_back({ "synthetic_10k", synth10k });
+
+    // Los casos (y sus engines/adaptadores) se destruyen antes de restaurar std::cout
+    std::vector<BenchResult> results;
+    std::vector<std::string> names;
+    {
+        BenchRunner runner(options);
+        addParseCases(runner, files);
+        if (files.size() > 2) {
+            auto largest = std::max_element(files.begin(), files.end() - 2, [](const auto& a, const auto& b) {
+                return fs::file_size(a.second) < fs::file_size(b.second);
+            });
+            addModelCases(runner, largest->first, largest->second);
+        }
+        addModelCases(runner, "synthetic_10k", synth10k);
+        addBitCases(runner, 10000);
+        addScanCases(runner, "synthetic_1k", synth1k);
+        addScanCases(runner, "synthetic_10k", synth10k);
+        addExecutorCases(runner);
+        addWaveformCases(runner);
+
+        if (list) names = runner.names();
+        else results = runner.run();
+    }
+    std::cout.rdbuf(coutBuffer);
+    fs::remove(synth1k, ec);
+    fs::remove(synth10k, ec);
+
+    if (list) {
+        for (const auto& name : names) std::cout << name << "\n";
+        return 0;
+    }
+
+    if (!jsonPath.empty()) {
+        std::string text = BenchRunner::toJson(results).dump() + "\n";
+        if (jsonPath == "-") {
+            std::cout << text;
+        } else {
+            std::ofstream out(jsonPath, std::ios::binary);
+            if (!out) {
+                std::cerr << "Cannot write " << jsonPath << "\n";
+                return 1;
+            }
+            out << text;
+        }
+    }
+
+    if (!baselinePath.empty()) {
+        std::ifstream in(baselinePath, std::ios::binary);
+        std::stringstream text;
+        text << in.rdbuf();
+        std::string error;
+        auto baseline = JsonValue::parse(text.str(), &error);
+        if (!in || !baseline) {
+            std::cerr << "Cannot read baseline " << baselinePath << ": " << error << "\n";
+            return 1;
+        }
+        size_t regressions = BenchRunner::compare(results, *baseline, threshold);
+        if (regressions > 0) {
+            std::cerr << regressions << " benchmark(s) regressed more than " << threshold << "%\n";
+            return 2;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,322 @@
+#include "BsdlLibrary.h"
+#include "../core/MappedFile.h"
+#include "../core/MonotonicClock.h"
+#include "../core/Json.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <charconv>
+#include <cstring>
+
+namespace JTAG {
+
+    static constexpr const char* INDEX_FORMAT = "jtag-bsdl-index-1";
+
+    static inline bool isAlpha(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+    static inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+    static inline bool isIdentChar(char c) { return isAlpha(c) || isDigit(c) || c == '_'; }
+    static inline char toUpper(char c) { return (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c; }
+
+    static bool iequals(std::string_view a, std::string_view b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (toUpper(a[i]) != toUpper(b[i])) return false;
+        }
+        return true;
+    }
+
+    static bool isBsdlExtension(const std::filesystem::path& path) {
+        std::string ext = path.extension().string();
+        for (char& c : ext) c = toUpper(c);
+        return ext == ".BSD" || ext == ".BSDL" || ext == ".BSM";
+    }
+
+    // ============================================================================
+    // PREFILTRO
+    // ============================================================================
+
+    bool BsdlLibrary::scanFile(const std::filesystem::path& path, BsdlLibraryEntry& entry) {
+        MappedFile file;
+        if (!file.open(path)) return false;
+
+        const char* ptr = reinterpret_cast<const char*>(file.data());
+        const char* end = ptr + file.size();
+
+        enum class Expect { NOTHING, ENTITY_NAME, IR_LENGTH, IDCODE_BITS };
+        Expect expect = Expect::NOTHING;
+        bool haveEntity = false, haveIr = false, haveIdcode = false;
+        uint32_t value = 0, mask = 0;
+        int bitCount = 0;
+
+        // Una pasada saltando comentarios y cadenas; termina al tener los tres datos
+        while (ptr < end && !(haveEntity && haveIr && haveIdcode)) {
+            const char c = *ptr;
+
+            if (c == '-' && ptr + 1 < end && ptr[1] == '-') {
+                const void* eol = std::memchr(ptr, '\n', end - ptr);
+                ptr = eol ? static_cast<const char*>(eol) + 1 : end;
+            }
+            else if (c == '"') {
+                const void* close = std::memchr(ptr + 1, '"', end - ptr - 1);
+                const char* stop = close ? static_cast<const char*>(close) : end;
+                if (expect == Expect::IDCODE_BITS) {
+                    for (const char* b = ptr + 1; b < stop; ++b) {
+                        if (*b == '0' || *b == '1') {
+                            value = (value << 1) | uint32_t(*b == '1');
+                            mask = (mask << 1) | 1u;
+                            bitCount++;
+                        } else if (*b == 'X' || *b == 'x') {
+                            value <<= 1;
+                            mask <<= 1;
+                            bitCount++;
+                        }
+                    }
+                }
+                ptr = close ? stop + 1 : end;
+            }
+            else if (c == ';') {
+                if (expect == Expect::IDCODE_BITS && bitCount == 32) {
+                    entry.idcode = value;
+                    entry.idcodeMask = mask;
+                    haveIdcode = true;
+                }
+                expect = Expect::NOTHING;
+                ptr++;
+            }
+            else if (isAlpha(c)) {
+                const char* start = ptr;
+                while (ptr < end && isIdentChar(*ptr)) ptr++;
+                std::string_view word(start, ptr - start);
+
+                if (expect == Expect::ENTITY_NAME) {
+                    entry.entityName.clear();
+                    for (char w : word) entry.entityName += toUpper(w);
+                    haveEntity = true;
+                    expect = Expect::NOTHING;
+                }
+                else if (!haveEntity && iequals(word, "ENTITY")) expect = Expect::ENTITY_NAME;
+                else if (!haveIr && iequals(word, "INSTRUCTION_LENGTH")) expect = Expect::IR_LENGTH;
+                else if (!haveIdcode && iequals(word, "IDCODE_REGISTER")) {
+                    expect = Expect::IDCODE_BITS;
+                    value = mask = 0;
+                    bitCount = 0;
+                }
+            }
+            else if (isDigit(c)) {
+                const char* start = ptr;
+                while (ptr < end && isDigit(*ptr)) ptr++;
+                if (expect == Expect::IR_LENGTH) {
+                    std::from_chars(start, ptr, entry.instructionLength);
+                    haveIr = true;
+                    expect = Expect::NOTHING;
+                }
+            }
+            else {
+                ptr++;
+            }
+        }
+        return true;
+    }
+
+    // ============================================================================
+    // ACTUALIZACIÓN INCREMENTAL
+    // ============================================================================
+
+    BsdlLibrary::RefreshStats BsdlLibrary::refresh(unsigned threads) {
+        const uint64_t start = monotonicNowNs();
+        RefreshStats stats;
+
+        std::unordered_map<std::string, const BsdlLibraryEntry*> previous;
+        previous.reserve(entries.size());
+        for (const auto& entry : entries) previous.emplace(entry.path.u8string(), &entry);
+
+        // 1. Inventario (solo stat): reutilizar lo que no ha cambiado
+        std::vector<BsdlLibraryEntry> next;
+        std::vector<size_t> pending;
+        std::unordered_set<std::string> seen;
+
+        for (const auto& dir : directories) {
+            std::error_code ec;
+            std::filesystem::recursive_directory_iterator it(
+                dir, std::filesystem::directory_options::skip_permission_denied, ec);
+            for (; !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+                const auto& item = *it;
+                std::error_code statEc;
+                if (!item.is_regular_file(statEc) || !isBsdlExtension(item.path())) continue;
+
+                std::string key = item.path().u8string();
+                if (!seen.insert(key).second) continue;   // Directorios solapados
+
+                BsdlLibraryEntry entry;
+                entry.path = item.path();
+                entry.fileSize = item.file_size(statEc);
+                entry.modified = static_cast<int64_t>(item.last_write_time(statEc).time_since_epoch().count());
+                if (statEc) continue;
+
+                // Sin IDCODE se vuelve a leer: puede ser un fallo de lectura (fichero
+                // bloqueado, a medio copiar) y no solo un BSDL sin IDCODE_REGISTER
+                auto old = previous.find(key);
+                if (old != previous.end() && old->second->hasIdcode() &&
+                    old->second->fileSize == entry.fileSize && old->second->modified == entry.modified) {
+                    next.push_back(*old->second);
+                    stats.reused++;
+                } else {
+                    pending.push_back(next.size());
+                    next.push_back(std::move(entry));
+                }
+            }
+            if (ec) {
+                std::cerr << "[BsdlLibrary] Cannot scan " << dir.string() << ": " << ec.message() << "\n";
+            }
+        }
+
+        for (const auto& [key, entry] : previous) {
+            if (!seen.count(key)) stats.removed++;
+        }
+
+        // 2. Prefiltro en paralelo sobre los ficheros nuevos o modificados
+        unsigned workers = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+        workers = static_cast<unsigned>(std::min<size_t>(workers, pending.size()));
+
+        std::atomic<size_t> cursor{ 0 };
+        auto work = [&]() {
+            for (size_t i = cursor.fetch_add(1); i < pending.size(); i = cursor.fetch_add(1)) {
+                BsdlLibraryEntry& entry = next[pending[i]];
+                scanFile(entry.path, entry);
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (unsigned w = 1; w < workers; ++w) pool.emplace_back(work);
+        if (workers > 0) work();
+        for (auto& t : pool) t.join();
+
+        std::sort(next.begin(), next.end(), [](const BsdlLibraryEntry& a, const BsdlLibraryEntry& b) {
+            return a.path < b.path;
+        });
+        entries = std::move(next);
+
+        stats.files = entries.size();
+        stats.scanned = pending.size();
+        stats.withoutIdcode = static_cast<size_t>(std::count_if(entries.begin(), entries.end(),
+            [](const BsdlLibraryEntry& e) { return !e.hasIdcode(); }));
+        stats.seconds = (monotonicNowNs() - start) / 1e9;
+
+        std::cout << "[BsdlLibrary] " << stats.files << " files (" << stats.scanned << " scanned, "
+                  << stats.reused << " unchanged, " << stats.removed << " removed, "
+                  << stats.withoutIdcode << " without IDCODE) in " << stats.seconds * 1000.0 << " ms\n";
+
+        if (!indexPath.empty() && (stats.scanned > 0 || stats.removed > 0)) saveIndex();
+        return stats;
+    }
+
+    std::vector<BsdlLibraryEntry> BsdlLibrary::findByIdcode(uint32_t idcode) const {
+        std::vector<BsdlLibraryEntry> result;
+        for (const auto& entry : entries) {
+            if (entry.matches(idcode)) result.push_back(entry);
+        }
+
+        auto fixedBits = [](uint32_t mask) {
+            int n = 0;
+            for (; mask; mask &= mask - 1) n++;
+            return n;
+        };
+        std::stable_sort(result.begin(), result.end(), [&](const BsdlLibraryEntry& a, const BsdlLibraryEntry& b) {
+            return fixedBits(a.idcodeMask) > fixedBits(b.idcodeMask);
+        });
+        return result;
+    }
+
+    // ============================================================================
+    // ÍNDICE EN DISCO
+    // ============================================================================
+
+    bool BsdlLibrary::loadIndex() {
+        entries.clear();
+        if (indexPath.empty()) return false;
+
+        MappedFile file;
+        if (!file.open(indexPath)) {
+            lastError = "No index at " + indexPath.string();
+            return false;
+        }
+
+        auto doc = JsonValue::parse(std::string_view(reinterpret_cast<const char*>(file.data()), file.size()), &lastError);
+        if (!doc || (*doc)["format"].asString() != INDEX_FORMAT) {
+            if (doc) lastError = "Unsupported index format";
+            std::cerr << "[BsdlLibrary] Ignoring " << indexPath.string() << ": " << lastError << "\n";
+            return false;
+        }
+
+        for (const auto& item : (*doc)["files"].asArray()) {
+            BsdlLibraryEntry entry;
+            entry.path = std::filesystem::u8path(item["path"].asString());
+            entry.fileSize = static_cast<uint64_t>(item["size"].asNumber());
+            // Ticks del reloj de ficheros como texto: no caben exactos en un double
+            const std::string& modified = item["modified"].asString();
+            std::from_chars(modified.data(), modified.data() + modified.size(), entry.modified);
+            entry.entityName = item["entity"].asString();
+            entry.idcode = static_cast<uint32_t>(item["idcode"].asNumber());
+            entry.idcodeMask = static_cast<uint32_t>(item["mask"].asNumber());
+            entry.instructionLength = static_cast<int>(item["ir_length"].asInt());
+            entries.push_back(std::move(entry));
+        }
+
+        std::sort(entries.begin(), entries.end(), [](const BsdlLibraryEntry& a, const BsdlLibraryEntry& b) {
+            return a.path < b.path;
+        });
+        std::cout << "[BsdlLibrary] Loaded index: " << entries.size() << " files\n";
+        return true;
+    }
+
+    bool BsdlLibrary::saveIndex() {
+        if (indexPath.empty()) return false;
+
+        JsonValue files = JsonValue::array();
+        for (const auto& entry : entries) {
+            JsonValue item = JsonValue::object();
+            item.set("path", entry.path.u8string());
+            item.set("size", entry.fileSize);
+            item.set("modified", std::to_string(entry.modified));
+            item.set("entity", entry.entityName);
+            item.set("idcode", entry.idcode);
+            item.set("mask", entry.idcodeMask);
+            item.set("ir_length", entry.instructionLength);
+            files.push(std::move(item));
+        }
+
+        JsonValue doc = JsonValue::object();
+        doc.set("format", INDEX_FORMAT);
+        doc.set("files", std::move(files));
+        const std::string text = doc.dump();
+
+        std::error_code ec;
+        if (indexPath.has_parent_path()) std::filesystem::create_directories(indexPath.parent_path(), ec);
+
+        std::filesystem::path tempPath = indexPath;
+        tempPath += ".tmp";
+        {
+            std::ofstream out(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+            out.write(text.data(), static_cast<std::streamsize>(text.size()));
+            if (!out) {
+                lastError = "Cannot write " + tempPath.string();
+                std::cerr << "[BsdlLibrary] " << lastError << "\n";
+                return false;
+            }
+        }
+
+        std::filesystem::rename(tempPath, indexPath, ec);
+        if (ec) {
+            lastError = "Cannot replace " + indexPath.string() + ": " + ec.message();
+            std::cerr << "[BsdlLibrary] " << lastError << "\n";
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+        return true;
+    }
+
+} // namespace JTAG
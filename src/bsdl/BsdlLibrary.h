@@ -0,0 +1,81 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <filesystem>
+
+namespace JTAG {
+
+    // Resumen de un fichero BSDL: solo lo necesario para identificar el dispositivo
+    struct BsdlLibraryEntry {
+        std::filesystem::path path;
+        uint64_t fileSize = 0;
+        int64_t modified = 0;          // last_write_time (ticks del reloj de ficheros)
+
+        std::string entityName;
+        uint32_t idcode = 0;           // Bits 'X' a 0
+        uint32_t idcodeMask = 0;       // 1 = bit significativo ('X' → 0, típicamente la versión)
+        int instructionLength = 0;
+
+        bool hasIdcode() const { return idcodeMask != 0; }
+        bool matches(uint32_t detected) const {
+            return hasIdcode() && (detected & idcodeMask) == (idcode & idcodeMask);
+        }
+    };
+
+    /**
+     * @brief Índice IDCODE → fichero sobre una biblioteca de BSDL
+     *
+     * refresh() recorre los directorios configurados y solo abre los ficheros
+     * nuevos, modificados (tamaño / fecha distintos a los del índice) o sin
+     * IDCODE en el índice; los que ya no existen salen del índice. Los abiertos se
+     * leen en paralelo con un prefiltro que extrae entity, IDCODE_REGISTER e
+     * INSTRUCTION_LENGTH en una pasada y se detiene al tenerlos (sin parsear el
+     * BOUNDARY_REGISTER). El índice se guarda en disco como JSON.
+     *
+     * No es thread-safe: refresh() y las consultas se llaman desde el mismo hilo.
+     * Para refrescar en segundo plano se refresca una copia y se asigna al terminar.
+     */
+    class BsdlLibrary {
+    public:
+        struct RefreshStats {
+            size_t files = 0;           // BSDL encontrados
+            size_t scanned = 0;         // Nuevos, modificados o sin IDCODE (prefiltro ejecutado)
+            size_t reused = 0;          // Sin cambios desde el último índice
+            size_t removed = 0;         // Ya no existen
+            size_t withoutIdcode = 0;   // Sin IDCODE_REGISTER utilizable
+            double seconds = 0.0;
+        };
+
+        BsdlLibrary() = default;
+
+        void setDirectories(std::vector<std::filesystem::path> dirs) { directories = std::move(dirs); }
+        const std::vector<std::filesystem::path>& getDirectories() const { return directories; }
+        void setIndexPath(const std::filesystem::path& path) { indexPath = path; }
+
+        bool loadIndex();
+        bool saveIndex();
+
+        // threads = 0 → hardware_concurrency()
+        RefreshStats refresh(unsigned threads = 0);
+
+        // Coincidencias por IDCODE, las más específicas (más bits fijos) primero
+        std::vector<BsdlLibraryEntry> findByIdcode(uint32_t idcode) const;
+
+        size_t size() const { return entries.size(); }
+        const std::vector<BsdlLibraryEntry>& getEntries() const { return entries; }
+        const std::string& getLastError() const { return lastError; }
+
+        // Prefiltro (rellena entity, IDCODE y longitud de IR). false si no se puede leer
+        static bool scanFile(const std::filesystem::path& path, BsdlLibraryEntry& entry);
+
+    private:
+        std::vector<std::filesystem::path> directories;
+        std::filesystem::path indexPath;
+        std::vector<BsdlLibraryEntry> entries;   // Ordenadas por ruta
+        std::string lastError;
+    };
+
+} // namespace JTAG
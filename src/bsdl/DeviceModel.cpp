@@ -2,53 +2,18 @@
 #include <algorithm>
 #include <iostream>
 #include <cctype>
-#include <regex>
+#include <numeric>
 
 namespace JTAG {
 
-    // Helper: Comparación alfanumérica para ordenar pines correctamente
-    // A1 < A2 < A10 < B1 (en lugar de A1 < A10 < A2)
-    static bool compareAlphanumeric(const std::string& a, const std::string& b) {
-        // ===== OPTIMIZACIÓN CRÍTICA: Compilar regex UNA VEZ =====
-        // Con 1000 pines, std::sort hace ~10,000 comparaciones.
-        // Sin static: 10,000 compilaciones de regex (~2 segundos)
-        // Con static: 1 compilación (~0.1 segundos)
-        static const std::regex numberPattern("(\\D*)(\\d*)");
-        // =========================================================
-        std::smatch matchA, matchB;
-
-        auto itA = a.begin();
-        auto itB = b.begin();
-
-        while (itA != a.end() && itB != b.end()) {
-            std::string remainA(itA, a.end());
-            std::string remainB(itB, b.end());
-
-            if (std::regex_search(remainA, matchA, numberPattern) &&
-                std::regex_search(remainB, matchB, numberPattern)) {
-
-                // Comparar parte alfabética
-                if (matchA[1] != matchB[1]) {
-                    return matchA[1] < matchB[1];
-                }
-
-                // Comparar parte numérica
-                if (!matchA[2].str().empty() && !matchB[2].str().empty()) {
-                    int numA = std::stoi(matchA[2]);
-                    int numB = std::stoi(matchB[2]);
-                    if (numA != numB) {
-                        return numA < numB;
-                    }
-                }
-
-                itA += matchA.length();
-                itB += matchB.length();
-            } else {
-                break;
-            }
+    const char* pinTypeName(PinType type) {
+        switch (type) {
+            case PinType::INPUT:   return "input";
+            case PinType::OUTPUT:  return "output";
+            case PinType::INOUT:   return "inout";
+            case PinType::LINKAGE: return "linkage";
+            default:               return "unknown";
         }
-
-        return a < b; // Fallback alfabético
     }
 
     DeviceModel::DeviceModel() {
@@ -76,38 +41,38 @@ namespace JTAG {
         }
 
         // 2. CREAR PINES DESDE LOS PUERTOS (Source of Truth)
-        // Esto asegura que VCC, GND y pines LINKAGE existan en el modelo
-        this->pins.clear();
-        std::map<std::string, PinInfo> tempPinMap;
+        // Esto asegura que VCC, GND y pines LINKAGE existan en el modelo.
+        // Registro temporal por puerto; al final se vuelca a los arrays.
+        struct PendingPin {
+            const std::string* name = nullptr;
+            const std::string* pinNumber = nullptr;
+            PinType type = PinType::UNKNOWN;
+            int outputCell = -1;
+            int inputCell = -1;
+            int controlCell = -1;
+            int disableValue = -1;
+        };
+        static const std::string noPinNumber;   // Pin lógico sin mapeo físico
+
+        std::map<std::string, PendingPin> tempPinMap;
 
         for (const auto& port : data.ports) {
-            PinInfo newPin;
-            newPin.name = port.name;
-            newPin.port = port.name;
-            newPin.type = port.direction; // "in", "out", "inout", "linkage", "buffer"
+            PendingPin newPin;
+            newPin.name = &port.name;
 
-            // Normalizar tipos para consistencia (lowercase)
-            std::string typeUpper = newPin.type;
+            // Normalizar tipos: "in", "out", "inout", "linkage", "buffer"
+            std::string typeUpper = port.direction;
             std::transform(typeUpper.begin(), typeUpper.end(), typeUpper.begin(), ::toupper);
 
-            if (typeUpper == "LINKAGE") newPin.type = "linkage";
-            else if (typeUpper == "IN") newPin.type = "input";
-            else if (typeUpper == "OUT" || typeUpper == "BUFFER") newPin.type = "output";
-            else if (typeUpper == "INOUT") newPin.type = "inout";
-            else newPin.type = "unknown";
+            if (typeUpper == "LINKAGE") newPin.type = PinType::LINKAGE;
+            else if (typeUpper == "IN") newPin.type = PinType::INPUT;
+            else if (typeUpper == "OUT" || typeUpper == "BUFFER") newPin.type = PinType::OUTPUT;
+            else if (typeUpper == "INOUT") newPin.type = PinType::INOUT;
+            else newPin.type = PinType::UNKNOWN;
 
             // Buscar Pin Físico (Mapping)
             auto mapIt = data.pinMaps.find(port.name);
-            if (mapIt != data.pinMaps.end() && !mapIt->second.empty()) {
-                newPin.pinNumber = mapIt->second[0];
-            } else {
-                newPin.pinNumber = "";  // Pin lógico sin mapeo físico
-            }
-
-            // Inicializar celdas como -1 (No conectadas al JTAG por defecto)
-            newPin.inputCell = -1;
-            newPin.outputCell = -1;
-            newPin.controlCell = -1;
+            newPin.pinNumber = (mapIt != data.pinMaps.end() && !mapIt->second.empty()) ? &mapIt->second[0] : &noPinNumber;
 
             tempPinMap[port.name] = newPin;
         }
@@ -124,7 +89,7 @@ namespace JTAG {
                 continue;
             }
 
-            PinInfo& pin = it->second;
+            PendingPin& pin = it->second;
 
             // Asignar celdas según función
             switch (cell.function) {
@@ -138,6 +103,9 @@ namespace JTAG {
                     pin.outputCell = cell.cellNumber;
                     if (cell.controlCell != -1) {
                         pin.controlCell = cell.controlCell;
+                        if (cell.disableValue != SafeBit::DONT_CARE) {
+                            pin.disableValue = (cell.disableValue == SafeBit::HIGH) ? 1 : 0;
+                        }
                     }
                     break;
 
@@ -151,6 +119,9 @@ namespace JTAG {
                     }
                     if (cell.controlCell != -1) {
                         pin.controlCell = cell.controlCell;
+                        if (cell.disableValue != SafeBit::DONT_CARE) {
+                            pin.disableValue = (cell.disableValue == SafeBit::HIGH) ? 1 : 0;
+                        }
                     }
                     break;
 
@@ -164,79 +135,180 @@ namespace JTAG {
             }
         }
 
-        // 4. Mover al vector final
-        this->pins.reserve(tempPinMap.size());
-        for (auto const& [name, info] : tempPinMap) {
-            this->pins.push_back(info);
+        // 4. Ordenar pines por número físico (layout del chip)
+        // Orden natural A1 < A2 < A10 < B1 con claves precalculadas: se ordena
+        // una permutación comparando enteros y solo en empates se compara la
+        // cadena tramo a tramo (comparePinNumbers).
+        std::vector<const PendingPin*> pending;
+        std::vector<PinNumberKey> keys;
+        pending.reserve(tempPinMap.size());
+        keys.reserve(tempPinMap.size());
+        for (const auto& [name, pin] : tempPinMap) {
+            pending.push_back(&pin);
+            keys.push_back(makePinNumberKey(*pin.pinNumber));
         }
 
-        // 5. Ordenar pines por número físico (layout del chip)
-        std::sort(this->pins.begin(), this->pins.end(), [](const PinInfo& a, const PinInfo& b) {
-            // Si ambos tienen número físico, ordenar alfanuméricamente
-            if (!a.pinNumber.empty() && !b.pinNumber.empty()) {
-                return compareAlphanumeric(a.pinNumber, b.pinNumber);
-            }
+        std::vector<uint32_t> order(pending.size());
+        std::iota(order.begin(), order.end(), 0u);
+        std::sort(order.begin(), order.end(), [&](uint32_t ia, uint32_t ib) {
+            const PendingPin& a = *pending[ia];
+            const PendingPin& b = *pending[ib];
             // Pines sin número al final, ordenados por nombre
-            if (a.pinNumber.empty() && !b.pinNumber.empty()) return false;
-            if (!a.pinNumber.empty() && b.pinNumber.empty()) return true;
-            return a.name < b.name;
+            if (a.pinNumber->empty() != b.pinNumber->empty()) return b.pinNumber->empty();
+            if (a.pinNumber->empty()) return *a.name < *b.name;
+            if (keys[ia].sortKey != keys[ib].sortKey) return keys[ia].sortKey < keys[ib].sortKey;
+            if (int order = comparePinNumbers(*a.pinNumber, *b.pinNumber)) return order < 0;
+            return *a.name < *b.name;
         });
 
+        // 5. Volcar a los arrays, internando las cadenas en el arena
+        clearPins();
+        std::unordered_map<std::string_view, StringRef> interned;
+        auto intern = [&](const std::string& s) -> StringRef {
+            auto it = interned.find(s);
+            if (it != interned.end()) return it->second;
+            StringRef ref{ static_cast<uint32_t>(stringArena.size()), static_cast<uint32_t>(s.size()) };
+            stringArena.append(s);
+            interned.emplace(s, ref);   // La clave apunta a BSDLData, que sigue viva
+            return ref;
+        };
+
+        const size_t count = order.size();
+        pinNames.reserve(count);
+        pinPorts.reserve(count);
+        pinNumbers.reserve(count);
+        pinTypes.reserve(count);
+        outputCells.reserve(count);
+        inputCells.reserve(count);
+        controlCells.reserve(count);
+        disableValues.reserve(count);
+        pinNumberKeys.reserve(count);
+        for (uint32_t idx : order) {
+            const PendingPin& pin = *pending[idx];
+            pinNames.push_back(intern(*pin.name));
+            pinPorts.push_back(pinNames.back());   // En BSDL el pin lógico es el propio puerto
+            pinNumbers.push_back(intern(*pin.pinNumber));
+            pinTypes.push_back(pin.type);
+            outputCells.push_back(pin.outputCell);
+            inputCells.push_back(pin.inputCell);
+            controlCells.push_back(pin.controlCell);
+            disableValues.push_back(static_cast<int8_t>(pin.disableValue));
+            pinNumberKeys.push_back(keys[idx]);
+        }
+
         // 6. Debug output detallado
-        size_t linkageCount = std::count_if(pins.begin(), pins.end(),
-            [](const PinInfo& p){ return p.type == "linkage"; });
-        size_t bsrCount = std::count_if(pins.begin(), pins.end(),
-            [](const PinInfo& p){ return p.inputCell != -1 || p.outputCell != -1; });
-        size_t inputCount = std::count_if(pins.begin(), pins.end(),
-            [](const PinInfo& p){ return p.type == "input"; });
-        size_t outputCount = std::count_if(pins.begin(), pins.end(),
-            [](const PinInfo& p){ return p.type == "output"; });
-        size_t inoutCount = std::count_if(pins.begin(), pins.end(),
-            [](const PinInfo& p){ return p.type == "inout"; });
-
-        std::cout << "[DeviceModel] Loaded " << this->pins.size() << " pins from BSDL data:\n";
-        std::cout << "  - " << linkageCount << " LINKAGE pins (VCC, GND, NC, etc.)\n";
-        std::cout << "  - " << inputCount << " INPUT pins\n";
-        std::cout << "  - " << outputCount << " OUTPUT pins\n";
-        std::cout << "  - " << inoutCount << " INOUT pins\n";
+        auto countType = [&](PinType type) { return std::count(pinTypes.begin(), pinTypes.end(), type); };
+        size_t bsrCount = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (inputCells[i] != -1 || outputCells[i] != -1) bsrCount++;
+        }
+
+        std::cout << "[DeviceModel] Loaded " << count << " pins from BSDL data ("
+                  << stringArena.size() << " bytes of names):\n";
+        std::cout << "  - " << countType(PinType::LINKAGE) << " LINKAGE pins (VCC, GND, NC, etc.)\n";
+        std::cout << "  - " << countType(PinType::INPUT) << " INPUT pins\n";
+        std::cout << "  - " << countType(PinType::OUTPUT) << " OUTPUT pins\n";
+        std::cout << "  - " << countType(PinType::INOUT) << " INOUT pins\n";
         std::cout << "  - " << bsrCount << " pins with BSR cells\n";
 
         // DEBUG: Mostrar primeros 10 pines para verificar clasificación
         std::cout << "[DeviceModel] Sample of first 10 pins:\n";
-        for (size_t i = 0; i < std::min(size_t(10), this->pins.size()); i++) {
-            std::cout << "  Pin[" << i << "]: name=" << this->pins[i].name
-                      << " pinNum=" << this->pins[i].pinNumber
-                      << " type=" << this->pins[i].type
-                      << " in=" << this->pins[i].inputCell
-                      << " out=" << this->pins[i].outputCell << "\n";
+        for (size_t i = 0; i < std::min(size_t(10), count); i++) {
+            std::cout << "  Pin[" << i << "]: name=" << text(pinNames[i])
+                      << " pinNum=" << text(pinNumbers[i])
+                      << " type=" << pinTypeName(pinTypes[i])
+                      << " in=" << inputCells[i]
+                      << " out=" << outputCells[i] << "\n";
         }
 
+        buildPinIndex();
+        std::cout << "[DeviceModel] Hash cache built: " << pinIndexCache.size() << " entries\n";
+    }
+
+    void DeviceModel::clearPins() {
+        stringArena.clear();
+        pinNames.clear();
+        pinPorts.clear();
+        pinNumbers.clear();
+        pinTypes.clear();
+        outputCells.clear();
+        inputCells.clear();
+        controlCells.clear();
+        disableValues.clear();
+        pinNumberKeys.clear();
+        pinIndexCache.clear();
+        inputCellToPin.clear();
+        outputCellToPin.clear();
+        decodePlan = PinDecodePlan();
+    }
+
+    void DeviceModel::buildPinIndex() {
+        const size_t count = getPinCount();
+
         // ===== OPTIMIZACIÓN: Construir hash cache UNA VEZ =====
         // Esto elimina búsquedas O(N) repetitivas en getPinInfo()
-        // Con 200 pines @ 50Hz, esto ahorra ~10,000 búsquedas O(N)/seg
+        // Las claves son vistas del arena: ni el índice ni las búsquedas copian cadenas
         pinIndexCache.clear();
-        pinIndexCache.reserve(this->pins.size());
-        for (size_t i = 0; i < this->pins.size(); ++i) {
-            pinIndexCache[this->pins[i].name] = i;
+        pinIndexCache.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            pinIndexCache.emplace(text(pinNames[i]), static_cast<uint32_t>(i));
         }
-        std::cout << "[DeviceModel] Hash cache built: " << pinIndexCache.size() << " entries\n";
         // ======================================================
+
+        // Mapas inversos densos celda → pin (cubren también celdas fuera de bsrLength)
+        size_t cellSpan = bsrLength;
+        for (size_t i = 0; i < count; ++i) {
+            cellSpan = std::max(cellSpan, static_cast<size_t>(std::max(inputCells[i], outputCells[i]) + 1));
+        }
+        inputCellToPin.assign(cellSpan, -1);
+        outputCellToPin.assign(cellSpan, -1);
+        for (size_t i = 0; i < count; ++i) {
+            if (inputCells[i] >= 0 && inputCellToPin[inputCells[i]] < 0) inputCellToPin[inputCells[i]] = static_cast<int32_t>(i);
+            if (outputCells[i] >= 0 && outputCellToPin[outputCells[i]] < 0) outputCellToPin[outputCells[i]] = static_cast<int32_t>(i);
+        }
+
+        decodePlan.build(bsrLength, inputCells, outputCells, controlCells, disableValues);
+
+        // Claves de número de pin: loadFromData ya las deja al ordenar; el modelo
+        // restaurado desde la caché (.jbmc) llega ordenado y sin ellas
+        if (pinNumberKeys.size() != count) {
+            pinNumberKeys.clear();
+            pinNumberKeys.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                pinNumberKeys.push_back(makePinNumberKey(text(pinNumbers[i])));
+            }
+        }
     }
 
+    PinView DeviceModel::getPin(size_t index) const {
+        PinView view;
+        view.name = text(pinNames[index]);
+        view.port = text(pinPorts[index]);
+        view.pinNumber = text(pinNumbers[index]);
+        view.type = pinTypes[index];
+        view.outputCell = outputCells[index];
+        view.inputCell = inputCells[index];
+        view.controlCell = controlCells[index];
+        view.disableValue = disableValues[index];
+        return view;
+    }
 
-    std::optional<PinInfo> DeviceModel::getPinInfo(const std::string& pinName) const {
+    int32_t DeviceModel::findPin(std::string_view pinName) const {
         // ===== OPTIMIZACIÓN: Usar hash cache O(1) en lugar de búsqueda O(N) =====
         auto it = pinIndexCache.find(pinName);
-        if (it != pinIndexCache.end()) {
-            return pins[it->second];  // Acceso directo O(1)
-        }
-        return std::nullopt;
-        // =======================================================================
+        return it != pinIndexCache.end() ? static_cast<int32_t>(it->second) : -1;
+    }
+
+    std::optional<PinView> DeviceModel::getPinInfo(std::string_view pinName) const {
+        int32_t index = findPin(pinName);
+        if (index < 0) return std::nullopt;
+        return getPin(static_cast<size_t>(index));
     }
 
     std::vector<std::string> DeviceModel::getPinNames() const {
         std::vector<std::string> names;
-        for (const auto& pin : pins) names.push_back(pin.name);
+        names.reserve(pinNames.size());
+        for (const auto& ref : pinNames) names.emplace_back(text(ref));
         return names;
     }
 
@@ -245,19 +317,19 @@ namespace JTAG {
         return (it != instructions.end()) ? it->second : 0xFFFFFFFF;
     }
 
-    std::string DeviceModel::getPinPort(const std::string& pinName) const {
-        auto pinInfo = getPinInfo(pinName);
-        return pinInfo ? pinInfo->port : "";
+    std::string_view DeviceModel::getPinPort(std::string_view pinName) const {
+        int32_t index = findPin(pinName);
+        return index >= 0 ? text(pinPorts[index]) : std::string_view();
     }
 
-    std::string DeviceModel::getPinType(const std::string& pinName) const {
-        auto pinInfo = getPinInfo(pinName);
-        return pinInfo ? pinInfo->type : "";
+    PinType DeviceModel::getPinType(std::string_view pinName) const {
+        int32_t index = findPin(pinName);
+        return index >= 0 ? pinTypes[index] : PinType::UNKNOWN;
     }
 
-    std::string DeviceModel::getPinNumber(const std::string& pinName) const {
-        auto pinInfo = getPinInfo(pinName);
-        return pinInfo ? pinInfo->pinNumber : "";
+    std::string_view DeviceModel::getPinNumber(std::string_view pinName) const {
+        int32_t index = findPin(pinName);
+        return index >= 0 ? text(pinNumbers[index]) : std::string_view();
     }
 
-} 
\ No newline at end of file
+}
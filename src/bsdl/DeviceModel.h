@@ -2,31 +2,92 @@
 
 // --- INCLUDES OBLIGATORIOS PARA C++ ---
 #include <string>       // Corrige: "string no es miembro de std"
+#include <string_view>
 #include <vector>       // Corrige: vectores
 #include <map>          // Corrige: mapas
 #include <unordered_map> // OPTIMIZACIÓN: Hash cache O(1)
 #include <optional>     // Corrige: optional
 #include <cstdint>      // Corrige: uint32_t
+#include <cstddef>
 // --------------------------------------
 
 #include "../parser/BSDLParser.h" // Necesario para BSDLData
+#include "PinNumberKey.h"
+#include "PinDecoder.h"
 
 namespace JTAG {
 
-    struct PinInfo {
-        std::string name;
-        std::string port;          // Puerto/señal del BSDL
-        std::string type;          // Tipo: INPUT, OUTPUT, INOUT, etc.
-        std::string pinNumber;     // Número físico del pin en el package (alfanumérico: "A1", "B2", etc.)
+    // Tipo de pin normalizado (BSDL: in → INPUT, out/buffer → OUTPUT)
+    enum class PinType : uint8_t {
+        INPUT,
+        OUTPUT,
+        INOUT,
+        LINKAGE,     // VCC, GND, NC… (sin celdas de boundary scan)
+        UNKNOWN
+    };
+
+    // Nombre en minúsculas para mostrar ("input", "output", "inout", "linkage", "unknown")
+    const char* pinTypeName(PinType type);
+
+    inline bool isDrivable(PinType type) { return type == PinType::OUTPUT || type == PinType::INOUT; }
+
+    // Vista de un pin: las cadenas apuntan al arena del DeviceModel y son válidas
+    // mientras el modelo viva y no se recargue. Construirla no reserva memoria.
+    struct PinView {
+        std::string_view name;
+        std::string_view port;       // Puerto/señal del BSDL
+        std::string_view pinNumber;  // Número físico del pin en el package (alfanumérico: "A1", "B2", etc.)
+        PinType type = PinType::UNKNOWN;
         int outputCell = -1;
         int inputCell = -1;
         int controlCell = -1;
+        int disableValue = -1;       // Valor de controlCell que deja el pin en alta impedancia (-1 = desconocido)
+    };
+
+    class DeviceModel;
+
+    // Rango indexable de PinView (getAllPins()): admite range-for, size() y operator[]
+    class PinRange {
+    public:
+        class iterator {
+        public:
+            iterator(const DeviceModel* model, size_t index) : model(model), index(index) {}
+            PinView operator*() const;
+            iterator& operator++() { ++index; return *this; }
+            bool operator!=(const iterator& other) const { return index != other.index; }
+        private:
+            const DeviceModel* model;
+            size_t index;
+        };
+
+        explicit PinRange(const DeviceModel* model) : model(model) {}
+        size_t size() const;
+        bool empty() const { return size() == 0; }
+        PinView operator[](size_t index) const;
+        iterator begin() const { return iterator(model, 0); }
+        iterator end() const { return iterator(model, size()); }
+
+    private:
+        const DeviceModel* model;
     };
 
+    /**
+     * @brief Modelo de dispositivo en estructura de arrays
+     *
+     * Cada atributo de pin vive en su propio array paralelo (índice = pin, en
+     * orden natural de número físico) y los nombres están internados en un único
+     * arena referenciado con offsets de 32 bits. Así un barrido de celdas o de
+     * tipos solo toca los bytes que usa, y las consultas por nombre o por celda
+     * (mapas inversos densos celda → pin) no reservan memoria.
+     *
+     * No se copia ni se mueve: el índice por nombre apunta dentro del arena.
+     */
     class DeviceModel {
     public:
         DeviceModel();
         ~DeviceModel() = default;
+        DeviceModel(const DeviceModel&) = delete;
+        DeviceModel& operator=(const DeviceModel&) = delete;
 
         void loadFromData(const BSDLData& data);
 
@@ -35,35 +96,84 @@ namespace JTAG {
         size_t getIRLength() const { return irLength; }
         size_t getBSRLength() const { return bsrLength; }
         std::string getPackageInfo() const { return packageInfo; }
-        size_t getPinCount() const { return pins.size(); }
+        size_t getPinCount() const { return pinTypes.size(); }
 
-        std::optional<PinInfo> getPinInfo(const std::string& pinName) const;
+        // ========== PINES ==========
+        PinView getPin(size_t index) const;
+        PinRange getAllPins() const { return PinRange(this); }
+        int32_t findPin(std::string_view pinName) const;     // -1 si no existe
+        std::optional<PinView> getPinInfo(std::string_view pinName) const;
         std::vector<std::string> getPinNames() const;
-        const std::vector<PinInfo>& getAllPins() const { return pins; }
+
+        // Paralelo a getAllPins(): clave de orden natural y posición en rejilla de cada pin
+        const std::vector<PinNumberKey>& getPinNumberKeys() const { return pinNumberKeys; }
+
+        // Arrays de celdas por pin (-1 = sin celda)
+        const std::vector<int32_t>& getOutputCells() const { return outputCells; }
+        const std::vector<int32_t>& getInputCells() const { return inputCells; }
+        const std::vector<int32_t>& getControlCells() const { return controlCells; }
+        const std::vector<PinType>& getPinTypes() const { return pinTypes; }
+
+        // Mapas inversos celda BSR → pin (-1 si la celda no es de datos de ningún pin)
+        int32_t pinForInputCell(size_t cell) const { return cell < inputCellToPin.size() ? inputCellToPin[cell] : -1; }
+        int32_t pinForOutputCell(size_t cell) const { return cell < outputCellToPin.size() ? outputCellToPin[cell] : -1; }
+
+        // Plan BSR → estado por pin (PinDecoder), construido al cargar
+        const PinDecodePlan& getDecodePlan() const { return decodePlan; }
 
         // Métodos para información adicional de pines
-        std::string getPinPort(const std::string& pinName) const;
-        std::string getPinType(const std::string& pinName) const;
-        std::string getPinNumber(const std::string& pinName) const;
+        std::string_view getPinPort(std::string_view pinName) const;
+        PinType getPinType(std::string_view pinName) const;
+        std::string_view getPinNumber(std::string_view pinName) const;
 
         uint32_t getInstruction(const std::string& instructionName) const;
         const std::map<std::string, uint32_t>& getAllInstructions() const { return instructions; }
 
     private:
+        friend class ModelCache;   // Serializa y restaura el modelo ya indexado (.jbmc)
+
+        struct StringRef {
+            uint32_t offset = 0;
+            uint32_t length = 0;
+        };
+
+        std::string_view text(StringRef ref) const { return std::string_view(stringArena.data() + ref.offset, ref.length); }
+        void clearPins();
+        void buildPinIndex();
+
         std::string deviceName;
         uint32_t idcode = 0;
         size_t irLength = 0;
         size_t bsrLength = 0;
         std::string packageInfo;
 
-        std::vector<PinInfo> pins;
+        // ===== PINES (estructura de arrays, mismo índice en todos) =====
+        std::string stringArena;                 // Nombres internados, sin terminador
+        std::vector<StringRef> pinNames;
+        std::vector<StringRef> pinPorts;
+        std::vector<StringRef> pinNumbers;
+        std::vector<PinType> pinTypes;
+        std::vector<int32_t> outputCells;
+        std::vector<int32_t> inputCells;
+        std::vector<int32_t> controlCells;
+        std::vector<int8_t> disableValues;
+        std::vector<PinNumberKey> pinNumberKeys;
+        // ===============================================================
+
         std::map<std::string, uint32_t> instructions;
 
-        // ===== OPTIMIZACIÓN: Hash cache para búsqueda O(1) =====
-        // Con 200 pines @ 50Hz, búsqueda O(N) lineal causa lag masivo
-        // Este mapa reduce getPinInfo() de O(N) a O(1)
-        std::unordered_map<std::string, size_t> pinIndexCache;
-        // =======================================================
+        // ===== OPTIMIZACIÓN: Índices derivados (buildPinIndex) =====
+        // Nombre → pin sin copiar la clave (string_view dentro del arena) y
+        // celda → pin en arrays densos del tamaño del BSR
+        std::unordered_map<std::string_view, uint32_t> pinIndexCache;
+        std::vector<int32_t> inputCellToPin;
+        std::vector<int32_t> outputCellToPin;
+        PinDecodePlan decodePlan;
+        // ===========================================================
     };
 
-}
\ No newline at end of file
+    inline PinView PinRange::iterator::operator*() const { return model->getPin(index); }
+    inline size_t PinRange::size() const { return model->getPinCount(); }
+    inline PinView PinRange::operator[](size_t index) const { return model->getPin(index); }
+
+}
@@ -0,0 +1,306 @@
+#include "ModelCache.h"
+#include "../core/MappedFile.h"
+#include "../core/MonotonicClock.h"
+#include "../parser/BSDLParser.h"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <cstring>
+
+namespace JTAG {
+
+    ModelCache::ModelCache(std::filesystem::path directory)
+        : directory(std::move(directory))
+    {
+    }
+
+    std::filesystem::path ModelCache::cachePathFor(uint64_t sourceHash) const {
+        std::ostringstream name;
+        name << std::hex << std::setw(16) << std::setfill('0') << sourceHash << ".jbmc";
+        return directory / name.str();
+    }
+
+    // ============================================================================
+    // CARGA (CACHÉ O PARSEO)
+    // ============================================================================
+
+    std::unique_ptr<DeviceModel> ModelCache::load(const std::filesystem::path& bsdlPath) {
+        const uint64_t start = monotonicNowNs();
+
+        MappedFile source;
+        if (!source.open(bsdlPath)) {
+            lastError = "Cannot read BSDL file: " + bsdlPath.string();
+            std::cerr << "[ModelCache] " << lastError << "\n";
+            return nullptr;
+        }
+
+        const uint64_t sourceHash = fnv1a64(source.data(), source.size());
+        if (auto model = lookup(sourceHash, source.size())) return model;
+
+        auto model = parse(source.data(), source.size());
+        insert(*model, sourceHash, source.size());
+
+        std::cout << "[ModelCache] Parsed " << bsdlPath.filename().string() << " in "
+                  << (monotonicNowNs() - start) / 1000 << " us\n";
+        return model;
+    }
+
+    std::unique_ptr<DeviceModel> ModelCache::lookup(uint64_t sourceHash, uint64_t sourceSize) {
+        if (!isEnabled()) return nullptr;
+
+        const uint64_t start = monotonicNowNs();
+        const std::filesystem::path cachePath = cachePathFor(sourceHash);
+        std::error_code ec;
+        if (!std::filesystem::exists(cachePath, ec)) {
+            stats.misses++;
+            return nullptr;
+        }
+
+        auto model = std::make_unique<DeviceModel>();
+        if (!read(cachePath, sourceHash, sourceSize, *model)) {
+            stats.invalidated++;
+            std::cout << "[ModelCache] Discarding " << cachePath.filename().string()
+                      << ": " << lastError << "\n";
+            return nullptr;
+        }
+
+        stats.hits++;
+        std::cout << "[ModelCache] Loaded " << model->getDeviceName() << " ("
+                  << model->getPinCount() << " pins) from " << cachePath.filename().string()
+                  << " in " << (monotonicNowNs() - start) / 1000 << " us\n";
+        return model;
+    }
+
+    std::unique_ptr<DeviceModel> ModelCache::parse(const uint8_t* source, size_t size) {
+        BSDLParser parser;
+        parser.parseText(std::string_view(reinterpret_cast<const char*>(source), size));
+
+        auto model = std::make_unique<DeviceModel>();
+        model->loadFromData(parser.getData());
+        return model;
+    }
+
+    void ModelCache::insert(const DeviceModel& model, uint64_t sourceHash, uint64_t sourceSize) {
+        if (!isEnabled()) return;
+
+        std::error_code ec;
+        std::filesystem::create_directories(directory, ec);
+        if (!write(model, sourceHash, sourceSize, cachePathFor(sourceHash))) stats.writeErrors++;
+    }
+
+    // ============================================================================
+    // LECTURA DEL FICHERO COMPILADO
+    // ============================================================================
+
+    bool ModelCache::read(const std::filesystem::path& cachePath, uint64_t sourceHash, uint64_t sourceSize,
+                          DeviceModel& model) {
+        MappedFile file;
+        if (!file.open(cachePath)) {
+            lastError = "Cannot map model file: " + cachePath.string();
+            return false;
+        }
+
+        const uint8_t* base = file.data();
+        const size_t size = file.size();
+
+        if (size < sizeof(ModelFileHeader)) {
+            lastError = "File too small for a JBMC header";
+            return false;
+        }
+
+        const auto* header = reinterpret_cast<const ModelFileHeader*>(base);
+        if (std::memcmp(header->magic, JBMC_MAGIC, sizeof(header->magic)) != 0 ||
+            header->version != JBMC_VERSION ||
+            header->headerSize != sizeof(ModelFileHeader)) {
+            lastError = "Not a JBMC v" + std::to_string(JBMC_VERSION) + " file";
+            return false;
+        }
+
+        if (header->sourceHash != sourceHash || header->sourceSize != sourceSize) {
+            lastError = "Source hash mismatch";
+            return false;
+        }
+
+        if (header->pinTableOffset + uint64_t(header->pinCount) * sizeof(ModelPinRecord) > size ||
+            header->instructionTableOffset + uint64_t(header->instructionCount) * sizeof(ModelInstructionRecord) > size ||
+            header->stringPoolOffset + header->stringPoolSize > size) {
+            lastError = "Truncated JBMC file";
+            return false;
+        }
+
+        if (fnv1a64(base + sizeof(ModelFileHeader), size - sizeof(ModelFileHeader)) != header->checksum) {
+            lastError = "JBMC checksum mismatch";
+            return false;
+        }
+
+        const char* pool = reinterpret_cast<const char*>(base + header->stringPoolOffset);
+        const uint64_t poolSize = header->stringPoolSize;
+        bool valid = true;
+        auto text = [&](const ModelString& s) -> std::string {
+            if (uint64_t(s.offset) + s.length > poolSize) {
+                valid = false;
+                return {};
+            }
+            return std::string(pool + s.offset, s.length);
+        };
+
+        model.deviceName = text(header->deviceName);
+        model.packageInfo = text(header->packageInfo);
+        model.idcode = header->idcode;
+        model.irLength = header->irLength;
+        model.bsrLength = header->bsrLength;
+
+        // Los pines ya vienen ordenados y el pool es el arena del modelo: se copia
+        // de una vez y los registros se reparten en los arrays sin tocar cadenas
+        const auto* pinRecords = reinterpret_cast<const ModelPinRecord*>(base + header->pinTableOffset);
+        auto ref = [&](const ModelString& s) -> DeviceModel::StringRef {
+            if (uint64_t(s.offset) + s.length > poolSize) valid = false;
+            return DeviceModel::StringRef{ s.offset, s.length };
+        };
+
+        model.clearPins();
+        model.stringArena.assign(pool, poolSize);
+        const uint32_t count = header->pinCount;
+        model.pinNames.reserve(count);
+        model.pinPorts.reserve(count);
+        model.pinNumbers.reserve(count);
+        model.pinTypes.reserve(count);
+        model.outputCells.reserve(count);
+        model.inputCells.reserve(count);
+        model.controlCells.reserve(count);
+        model.disableValues.reserve(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            const ModelPinRecord& rec = pinRecords[i];
+            if (rec.type > static_cast<uint8_t>(PinType::UNKNOWN)) valid = false;
+            model.pinNames.push_back(ref(rec.name));
+            model.pinPorts.push_back(ref(rec.port));
+            model.pinNumbers.push_back(ref(rec.pinNumber));
+            model.pinTypes.push_back(static_cast<PinType>(rec.type));
+            model.outputCells.push_back(rec.outputCell);
+            model.inputCells.push_back(rec.inputCell);
+            model.controlCells.push_back(rec.controlCell);
+            model.disableValues.push_back(rec.disableValue);
+        }
+
+        const auto* instrRecords = reinterpret_cast<const ModelInstructionRecord*>(base + header->instructionTableOffset);
+        model.instructions.clear();
+        for (uint32_t i = 0; i < header->instructionCount; ++i) {
+            // Ordenadas por nombre: inserción con pista al final, sin búsquedas
+            model.instructions.emplace_hint(model.instructions.end(), text(instrRecords[i].name), instrRecords[i].opcode);
+        }
+
+        if (!valid) {
+            lastError = "JBMC string reference or pin type out of range";
+            model.clearPins();
+            return false;
+        }
+
+        model.buildPinIndex();
+        return true;
+    }
+
+    // ============================================================================
+    // ESCRITURA DEL FICHERO COMPILADO
+    // ============================================================================
+
+    bool ModelCache::write(const DeviceModel& model, uint64_t sourceHash, uint64_t sourceSize,
+                           const std::filesystem::path& outputPath) {
+        // El pool empieza con el arena del modelo (ya deduplicado al cargar), así
+        // los offsets de los pines se escriben tal cual; detrás van el resto de cadenas
+        std::vector<char> pool(model.stringArena.begin(), model.stringArena.end());
+        auto append = [&](const std::string& s) -> ModelString {
+            ModelString ref{ static_cast<uint32_t>(pool.size()), static_cast<uint32_t>(s.size()) };
+            pool.insert(pool.end(), s.begin(), s.end());
+            return ref;
+        };
+        auto arenaRef = [](const DeviceModel::StringRef& r) { return ModelString{ r.offset, r.length }; };
+
+        const size_t pinCount = model.getPinCount();
+        std::vector<ModelPinRecord> pinRecords;
+        pinRecords.reserve(pinCount);
+        for (size_t i = 0; i < pinCount; ++i) {
+            ModelPinRecord rec{};
+            rec.name = arenaRef(model.pinNames[i]);
+            rec.port = arenaRef(model.pinPorts[i]);
+            rec.pinNumber = arenaRef(model.pinNumbers[i]);
+            rec.outputCell = model.outputCells[i];
+            rec.inputCell = model.inputCells[i];
+            rec.controlCell = model.controlCells[i];
+            rec.disableValue = model.disableValues[i];
+            rec.type = static_cast<uint8_t>(model.pinTypes[i]);
+            pinRecords.push_back(rec);
+        }
+
+        std::vector<ModelInstructionRecord> instrRecords;
+        instrRecords.reserve(model.instructions.size());
+        for (const auto& [name, opcode] : model.instructions) {
+            ModelInstructionRecord rec{};
+            rec.name = append(name);
+            rec.opcode = opcode;
+            instrRecords.push_back(rec);
+        }
+
+        ModelFileHeader header{};
+        std::memcpy(header.magic, JBMC_MAGIC, sizeof(header.magic));
+        header.version = JBMC_VERSION;
+        header.headerSize = sizeof(ModelFileHeader);
+        header.sourceHash = sourceHash;
+        header.sourceSize = sourceSize;
+        header.idcode = model.idcode;
+        header.irLength = static_cast<uint32_t>(model.irLength);
+        header.bsrLength = static_cast<uint32_t>(model.bsrLength);
+        header.pinCount = static_cast<uint32_t>(pinRecords.size());
+        header.instructionCount = static_cast<uint32_t>(instrRecords.size());
+        header.deviceName = append(model.deviceName);
+        header.packageInfo = append(model.packageInfo);
+        header.pinTableOffset = sizeof(ModelFileHeader);
+        header.instructionTableOffset = header.pinTableOffset + pinRecords.size() * sizeof(ModelPinRecord);
+        header.stringPoolOffset = header.instructionTableOffset + instrRecords.size() * sizeof(ModelInstructionRecord);
+        header.stringPoolSize = pool.size();
+
+        uint64_t checksum = fnv1a64(reinterpret_cast<const uint8_t*>(pinRecords.data()), pinRecords.size() * sizeof(ModelPinRecord));
+        checksum = fnv1a64(reinterpret_cast<const uint8_t*>(instrRecords.data()), instrRecords.size() * sizeof(ModelInstructionRecord), checksum);
+        checksum = fnv1a64(reinterpret_cast<const uint8_t*>(pool.data()), pool.size(), checksum);
+        header.checksum = checksum;
+
+        // Escritura a un temporal + rename: otro proceso nunca ve un fichero a medias
+        std::filesystem::path tempPath = outputPath;
+        tempPath += ".tmp";
+        {
+            std::ofstream out(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!out) {
+                lastError = "Cannot create model file: " + tempPath.string();
+                std::cerr << "[ModelCache] " << lastError << "\n";
+                return false;
+            }
+
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(pinRecords.data()), pinRecords.size() * sizeof(ModelPinRecord));
+            out.write(reinterpret_cast<const char*>(instrRecords.data()), instrRecords.size() * sizeof(ModelInstructionRecord));
+            out.write(pool.data(), pool.size());
+
+            if (!out) {
+                lastError = "Write error on " + tempPath.string();
+                std::cerr << "[ModelCache] " << lastError << "\n";
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tempPath, outputPath, ec);
+        if (ec) {
+            lastError = "Cannot replace " + outputPath.string() + ": " + ec.message();
+            std::cerr << "[ModelCache] " << lastError << "\n";
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+
+        std::cout << "[ModelCache] Wrote " << outputPath.filename().string() << ": "
+                  << pinRecords.size() << " pins, " << instrRecords.size() << " instructions, "
+                  << pool.size() << " bytes of strings\n";
+        return true;
+    }
+
+} // namespace JTAG
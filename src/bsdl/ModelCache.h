@@ -0,0 +1,66 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <filesystem>
+
+#include "DeviceModel.h"
+#include "ModelCacheFormat.h"
+
+namespace JTAG {
+
+    /**
+     * @brief Caché de modelos BSDL compilados (.jbmc) indexada por hash de contenido
+     *
+     * load() proyecta el BSDL, calcula su hash y busca <directorio>/<hash>.jbmc.
+     * Si existe y coincide (magic, versión, hash, tamaño y checksum), el modelo se
+     * restaura desde el fichero proyectado sin parsear ni ordenar. Si no, se
+     * parsea el BSDL y el modelo resultante se escribe para la próxima vez.
+     * Con el directorio vacío la caché queda desactivada (siempre se parsea).
+     */
+    class ModelCache {
+    public:
+        struct Stats {
+            size_t hits = 0;
+            size_t misses = 0;        // Sin fichero compilado
+            size_t invalidated = 0;   // Fichero presente pero obsoleto o corrupto
+            size_t writeErrors = 0;
+        };
+
+        ModelCache() = default;
+        explicit ModelCache(std::filesystem::path directory);
+
+        void setDirectory(const std::filesystem::path& dir) { directory = dir; }
+        const std::filesystem::path& getDirectory() const { return directory; }
+        bool isEnabled() const { return !directory.empty(); }
+
+        // BSDL → modelo (nullptr si el fichero no se puede leer): lookup + parse + insert
+        std::unique_ptr<DeviceModel> load(const std::filesystem::path& bsdlPath);
+
+        // Fases de load() por separado, para quien comparte la caché entre hilos:
+        // lookup()/insert() tocan el directorio y las estadísticas (van bajo su lock);
+        // parse() no tiene estado y puede ejecutarse sin él.
+        // sourceHash = fnv1a64 del contenido del BSDL
+        std::unique_ptr<DeviceModel> lookup(uint64_t sourceHash, uint64_t sourceSize);   // nullptr = fallo
+        static std::unique_ptr<DeviceModel> parse(const uint8_t* source, size_t size);
+        void insert(const DeviceModel& model, uint64_t sourceHash, uint64_t sourceSize);
+
+        // ========== API DE BAJO NIVEL ==========
+        bool write(const DeviceModel& model, uint64_t sourceHash, uint64_t sourceSize,
+                   const std::filesystem::path& outputPath);
+        bool read(const std::filesystem::path& cachePath, uint64_t sourceHash, uint64_t sourceSize,
+                  DeviceModel& model);
+        std::filesystem::path cachePathFor(uint64_t sourceHash) const;
+
+        const Stats& getStats() const { return stats; }
+        const std::string& getLastError() const { return lastError; }
+
+    private:
+        std::filesystem::path directory;
+        Stats stats;
+        std::string lastError;
+    };
+
+} // namespace JTAG
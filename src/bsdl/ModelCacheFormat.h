@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace JTAG {
+
+    // ============================================================================
+    // FORMATO BINARIO DE MODELOS COMPILADOS (.jbmc)
+    // ============================================================================
+    //
+    // [ModelFileHeader]
+    // [ModelPinRecord x pinCount]                  Pines ya ordenados (layout del chip)
+    // [ModelInstructionRecord x instructionCount]  Ordenadas por nombre
+    // [Pool de cadenas]                            Texto sin terminador, (offset, longitud)
+    //
+    // Es el DeviceModel ya construido e indexado: cargarlo no parsea BSDL ni
+    // ordena pines. Solo contiene offsets (ningún puntero), así que el fichero es
+    // reubicable y se usa directamente desde la proyección en memoria. El pool
+    // empieza con el arena de nombres del modelo tal cual: los offsets de los
+    // pines son los del arena y se restauran sin reinternar.
+    //
+    // La clave es el hash del contenido del BSDL (no su ruta ni su fecha): un
+    // fichero editado produce otra clave, y uno copiado a otra carpeta reutiliza
+    // la misma. Si cambia el parser o DeviceModel::loadFromData de forma que el
+    // modelo resultante sea distinto, hay que subir JBMC_VERSION.
+    //
+    // Todos los campos multibyte son little-endian.
+
+    constexpr char     JBMC_MAGIC[4] = { 'J', 'B', 'M', 'C' };
+    constexpr uint16_t JBMC_VERSION = 2;   // v2: tipo de pin como enum, registro de 40 bytes
+
+#pragma pack(push, 1)
+
+    struct ModelString {
+        uint32_t offset;             ///< Offset en el pool
+        uint32_t length;
+    };
+
+    struct ModelFileHeader {
+        char     magic[4];           ///< "JBMC"
+        uint16_t version;            ///< JBMC_VERSION
+        uint16_t headerSize;         ///< sizeof(ModelFileHeader)
+        uint64_t sourceHash;         ///< FNV-1a 64 del texto BSDL
+        uint64_t sourceSize;         ///< Tamaño del BSDL (descarta colisiones triviales)
+        uint32_t idcode;
+        uint32_t irLength;
+        uint32_t bsrLength;
+        uint32_t pinCount;
+        uint32_t instructionCount;
+        ModelString deviceName;
+        ModelString packageInfo;
+        uint64_t pinTableOffset;
+        uint64_t instructionTableOffset;
+        uint64_t stringPoolOffset;
+        uint64_t stringPoolSize;
+        uint64_t checksum;           ///< FNV-1a 64 de todo lo que sigue a la cabecera
+    };
+
+    struct ModelPinRecord {
+        ModelString name;
+        ModelString port;
+        ModelString pinNumber;
+        int32_t outputCell;
+        int32_t inputCell;
+        int32_t controlCell;
+        int8_t  disableValue;
+        uint8_t type;                ///< JTAG::PinType
+        uint16_t reserved;
+    };
+
+    struct ModelInstructionRecord {
+        ModelString name;
+        uint32_t opcode;
+        uint32_t reserved;
+    };
+
+#pragma pack(pop)
+
+    static_assert(sizeof(ModelPinRecord) == 40, "ModelPinRecord debe ocupar 40 bytes");
+    static_assert(sizeof(ModelInstructionRecord) == 16, "ModelInstructionRecord debe ocupar 16 bytes");
+
+    inline uint64_t fnv1a64(const uint8_t* data, size_t size, uint64_t hash = 0xCBF29CE484222325ull) {
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= data[i];
+            hash *= 0x100000001B3ull;
+        }
+        return hash;
+    }
+
+} // namespace JTAG
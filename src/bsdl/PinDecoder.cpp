@@ -0,0 +1,111 @@
+#include "PinDecoder.h"
+#include "../core/BitUtils.h"
+#include <cstring>
+
+namespace JTAG {
+
+    // ============================================================================
+    // PLAN
+    // ============================================================================
+
+    void PinDecodePlan::build(size_t bsrLength, const std::vector<int32_t>& inputCells,
+                              const std::vector<int32_t>& outputCells, const std::vector<int32_t>& controlCells,
+                              const std::vector<int8_t>& disableValues) {
+        this->bsrLength = bsrLength;
+        sentinelBit = static_cast<uint32_t>(bytesForBits(bsrLength) * 8);
+
+        const size_t count = inputCells.size();
+        readBit.resize(count);
+        driveBit.resize(count);
+        controlBit.resize(count);
+        enableXor.resize(count);
+        staticBits.resize(count);
+
+        auto bitOf = [&](int32_t cell) -> uint32_t {
+            return (cell >= 0 && static_cast<size_t>(cell) < bsrLength) ? static_cast<uint32_t>(cell) : sentinelBit;
+        };
+
+        for (size_t i = 0; i < count; ++i) {
+            readBit[i] = bitOf(inputCells[i]);
+            driveBit[i] = bitOf(outputCells[i]);
+            controlBit[i] = bitOf(controlCells[i]);
+
+            // Sin control la salida está siempre habilitada (centinela 0 ^ 1).
+            // disableValue 1: habilitada con control a 0; 0 o desconocido: con control a 1
+            const bool hasControl = controlBit[i] != sentinelBit;
+            enableXor[i] = (!hasControl || disableValues[i] == 1) ? 1 : 0;
+
+            uint8_t bits = 0;
+            if (readBit[i] != sentinelBit) bits |= PinState::READ;
+            if (driveBit[i] != sentinelBit) bits |= PinState::HAS_OUTPUT;
+            staticBits[i] = bits;
+        }
+    }
+
+    // ============================================================================
+    // DECODIFICACIÓN
+    // ============================================================================
+
+    namespace {
+        // Núcleo común: bits de entrada, salida y habilitación → byte de estado
+        inline uint8_t combine(uint8_t staticBits, uint8_t in, uint8_t out, uint8_t enabled) {
+            const uint8_t hasIn = (staticBits >> 1) & 1;    // READ
+            const uint8_t hasOut = (staticBits >> 2) & 1;   // HAS_OUTPUT
+            const uint8_t driven = hasOut & enabled;
+            const uint8_t tristated = hasOut & (enabled ^ 1);
+            const uint8_t value = (hasIn & in) | ((hasIn ^ 1) & out);
+            return static_cast<uint8_t>(staticBits | value | (driven << 3) | (tristated << 4) | (out << 5));
+        }
+
+        inline uint8_t bitAt(const uint8_t* image, uint32_t bit) {
+            return (image[bit >> 3] >> (bit & 7)) & 1;
+        }
+    }
+
+    void PinDecoder::decode(const PinDecodePlan& plan, const uint8_t* capture, const uint8_t* drive,
+                            std::vector<PinState>& states) {
+        // Copias con un byte centinela a cero al final (una imagen BSR son decenas de bytes)
+        const size_t imageBytes = bytesForBits(plan.bsrLength);
+        paddedCapture.resize(imageBytes + 1);
+        paddedDrive.resize(imageBytes + 1);
+        if (imageBytes) {
+            std::memcpy(paddedCapture.data(), capture, imageBytes);
+            std::memcpy(paddedDrive.data(), drive, imageBytes);
+        }
+        paddedCapture[imageBytes] = 0;
+        paddedDrive[imageBytes] = 0;
+
+        const size_t count = plan.size();
+        states.resize(count);
+
+        const uint8_t* cap = paddedCapture.data();
+        const uint8_t* drv = paddedDrive.data();
+        const uint32_t* readBit = plan.readBit.data();
+        const uint32_t* driveBit = plan.driveBit.data();
+        const uint32_t* controlBit = plan.controlBit.data();
+        const uint8_t* enableXor = plan.enableXor.data();
+        const uint8_t* staticBits = plan.staticBits.data();
+        uint8_t* out = reinterpret_cast<uint8_t*>(states.data());
+
+        // Arrays planos, sin ramas ni dependencias entre iteraciones: el compilador
+        // lo vectoriza (gathers) donde el objetivo lo permite
+        for (size_t i = 0; i < count; ++i) {
+            const uint8_t in = bitAt(cap, readBit[i]);
+            const uint8_t o = bitAt(drv, driveBit[i]);
+            const uint8_t enabled = bitAt(drv, controlBit[i]) ^ enableXor[i];
+            out[i] = combine(staticBits[i], in, o, enabled);
+        }
+    }
+
+    PinState PinDecoder::decodePin(const PinDecodePlan& plan, size_t pin,
+                                   const uint8_t* capture, const uint8_t* drive) {
+        auto read = [&](const uint8_t* image, uint32_t bit) -> uint8_t {
+            return bit == plan.sentinelBit ? 0 : bitAt(image, bit);
+        };
+        const uint8_t in = read(capture, plan.readBit[pin]);
+        const uint8_t o = read(drive, plan.driveBit[pin]);
+        const uint8_t enabled = read(drive, plan.controlBit[pin]) ^ plan.enableXor[pin];
+        return PinState{ combine(plan.staticBits[pin], in, o, enabled) };
+    }
+
+} // namespace JTAG
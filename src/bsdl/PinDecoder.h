@@ -0,0 +1,80 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace JTAG {
+
+    // ============================================================================
+    // DECODIFICACIÓN BSR → ESTADO LÓGICO POR PIN
+    // ============================================================================
+    // Un byte por pin. VALUE es el nivel que se muestra: el leído por la celda de
+    // entrada si existe; si no, el que conduce la celda de salida.
+
+    struct PinState {
+        static constexpr uint8_t VALUE      = 0x01;
+        static constexpr uint8_t READ       = 0x02;   // Celda de entrada muestreada
+        static constexpr uint8_t HAS_OUTPUT = 0x04;   // Tiene celda de salida
+        static constexpr uint8_t DRIVEN     = 0x08;   // Salida habilitada por su control
+        static constexpr uint8_t TRISTATED  = 0x10;   // Salida deshabilitada (alta impedancia)
+        static constexpr uint8_t OUT_VALUE  = 0x20;   // Valor en la celda de salida
+
+        uint8_t bits = 0;
+
+        bool value() const { return bits & VALUE; }
+        bool isRead() const { return bits & READ; }
+        bool isDriven() const { return bits & DRIVEN; }
+        bool isTristated() const { return bits & TRISTATED; }
+        bool outputValue() const { return bits & OUT_VALUE; }
+        bool hasData() const { return bits & (READ | HAS_OUTPUT); }
+    };
+    static_assert(sizeof(PinState) == 1, "PinState debe ocupar 1 byte");
+
+    /**
+     * @brief Plan de decodificación denso, calculado al cargar el DeviceModel
+     *
+     * Arrays paralelos a los pines con la posición de bit de cada celda. Las
+     * celdas ausentes apuntan a sentinelBit, un bit siempre a 0 en el byte de
+     * relleno que PinDecoder añade a las imágenes: el bucle no tiene ramas.
+     */
+    struct PinDecodePlan {
+        size_t bsrLength = 0;
+        uint32_t sentinelBit = 0;            // = bytesForBits(bsrLength) * 8
+
+        std::vector<uint32_t> readBit;       // Celda de entrada
+        std::vector<uint32_t> driveBit;      // Celda de salida
+        std::vector<uint32_t> controlBit;    // Celda de control
+        std::vector<uint8_t> enableXor;      // habilitada = control ^ enableXor
+        std::vector<uint8_t> staticBits;     // READ / HAS_OUTPUT según las celdas existentes
+
+        size_t size() const { return staticBits.size(); }
+
+        // inputCells/outputCells/controlCells: -1 = sin celda; disableValues: -1 = se asume 0
+        void build(size_t bsrLength, const std::vector<int32_t>& inputCells,
+                   const std::vector<int32_t>& outputCells, const std::vector<int32_t>& controlCells,
+                   const std::vector<int8_t>& disableValues);
+    };
+
+    /**
+     * @brief Convierte imágenes BSR en estados por pin con un solo bucle sin ramas
+     *
+     * capture: imagen TDO (celdas de entrada). drive: imagen de la que se leen
+     * salidas y controles; en SAMPLE es la propia captura, en EXTEST/INTEST el
+     * BSR aplicado. Mantiene buffers internos: una instancia por hilo.
+     */
+    class PinDecoder {
+    public:
+        void decode(const PinDecodePlan& plan, const uint8_t* capture, const uint8_t* drive,
+                    std::vector<PinState>& states);
+
+        // Un único pin sobre imágenes sin relleno (consultas puntuales)
+        static PinState decodePin(const PinDecodePlan& plan, size_t pin,
+                                  const uint8_t* capture, const uint8_t* drive);
+
+    private:
+        std::vector<uint8_t> paddedCapture;
+        std::vector<uint8_t> paddedDrive;
+    };
+
+} // namespace JTAG
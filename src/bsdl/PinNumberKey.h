@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+namespace JTAG {
+
+    // ============================================================================
+    // CLAVE DE ORDENACIÓN NATURAL PARA NÚMEROS DE PIN ("A1" < "A2" < "A10" < "B1")
+    // ============================================================================
+    // Se calcula una vez por pin. Ordenar pasa a ser comparar enteros; solo los
+    // empates de clave (prefijos de más de 4 letras, ceros a la izquierda o texto
+    // tras el número) recurren a comparePinNumbers(), tramo a tramo.
+    //
+    //   sortKey = [prefijo alfabético: 4 x 7 bits][número: 32 bits][0: 4 bits]
+    //
+    // El prefijo se rellena con ceros por la derecha, así que entre prefijos se
+    // mantiene el orden lexicográfico ("AA" < "B"). Si el prefijo no cabe, el
+    // número se deja a 0 para que el desempate por cadena siga siendo exacto.
+    //
+    // row/col son la posición en la rejilla de un BGA (A=0 … Z=25, AA=26; 1 → 0)
+    // cuando el número es exactamente letras + dígitos.
+
+    struct PinNumberKey {
+        uint64_t sortKey = 0;
+        int32_t row = -1;
+        int32_t col = -1;
+
+        bool isGrid() const { return col >= 0; }
+    };
+
+    inline PinNumberKey makePinNumberKey(std::string_view pinNumber) {
+        constexpr size_t PREFIX_CHARS = 4;
+
+        PinNumberKey key;
+        size_t i = 0;
+
+        uint64_t prefix = 0;
+        uint32_t gridRow = 0;   // Base 26 biyectiva: A=1, Z=26, AA=27
+        while (i < pinNumber.size() && !(pinNumber[i] >= '0' && pinNumber[i] <= '9')) {
+            const unsigned char c = static_cast<unsigned char>(pinNumber[i]);
+            if (i < PREFIX_CHARS) prefix = (prefix << 7) | (c & 0x7F);
+            const unsigned char upper = (c >= 'a' && c <= 'z') ? c - 32 : c;
+            if (upper >= 'A' && upper <= 'Z' && gridRow < 0x1000000) gridRow = gridRow * 26 + (upper - 'A' + 1);
+            else gridRow = UINT32_MAX;   // No es una fila de rejilla
+            ++i;
+        }
+        const size_t prefixLength = i;
+        for (size_t pad = prefixLength; pad < PREFIX_CHARS; ++pad) prefix <<= 7;
+
+        uint64_t number = 0;
+        const size_t digitsStart = i;
+        while (i < pinNumber.size() && pinNumber[i] >= '0' && pinNumber[i] <= '9') {
+            if (number <= UINT32_MAX) number = number * 10 + (pinNumber[i] - '0');
+            ++i;
+        }
+        if (number > UINT32_MAX || prefixLength > PREFIX_CHARS) number = 0;
+
+        key.sortKey = (prefix << 36) | (number << 4);
+
+        if (i == pinNumber.size() && i > digitsStart && number > 0 && gridRow != UINT32_MAX) {
+            key.row = prefixLength ? static_cast<int32_t>(gridRow - 1) : 0;
+            key.col = static_cast<int32_t>(number - 1);
+        }
+        return key;
+    }
+
+    // Comparación natural completa (<0, 0, >0): los tramos de dígitos se comparan
+    // por valor ("ABCDE2" < "ABCDE10", "A1B2" < "A1B10") y el resto carácter a
+    // carácter. Con el mismo valor, menos ceros a la izquierda va antes ("1" < "01").
+    inline int comparePinNumbers(std::string_view a, std::string_view b) {
+        auto isDigit = [](char c) { return c >= '0' && c <= '9'; };
+        int zerosTieBreak = 0;
+        size_t i = 0, j = 0;
+        while (i < a.size() && j < b.size()) {
+            if (isDigit(a[i]) && isDigit(b[j])) {
+                size_t za = i, zb = j;
+                while (za < a.size() && a[za] == '0') ++za;
+                while (zb < b.size() && b[zb] == '0') ++zb;
+                size_t ea = za, eb = zb;
+                while (ea < a.size() && isDigit(a[ea])) ++ea;
+                while (eb < b.size() && isDigit(b[eb])) ++eb;
+                // Sin ceros iniciales, más dígitos = mayor valor; a igual longitud, orden lexicográfico
+                if (ea - za != eb - zb) return (ea - za < eb - zb) ? -1 : 1;
+                const int digits = a.substr(za, ea - za).compare(b.substr(zb, eb - zb));
+                if (digits) return digits;
+                if (!zerosTieBreak && (za - i) != (zb - j)) zerosTieBreak = (za - i < zb - j) ? -1 : 1;
+                i = ea;
+                j = eb;
+                continue;
+            }
+            if (a[i] != b[j]) return static_cast<unsigned char>(a[i]) < static_cast<unsigned char>(b[j]) ? -1 : 1;
+            ++i;
+            ++j;
+        }
+        if (i < a.size()) return 1;
+        if (j < b.size()) return -1;
+        return zerosTieBreak;
+    }
+
+} // namespace JTAG
@@ -0,0 +1,72 @@
+#include "BusHandle.h"
+#include "../core/BitUtils.h"
+
+namespace JTAG {
+
+    std::optional<BusHandle> BusHandle::fromPins(const DeviceModel& model,
+                                                 const std::vector<std::string>& pinNames,
+                                                 std::string* error) {
+        BusHandle handle;
+        handle.pins.reserve(pinNames.size());
+
+        for (const auto& name : pinNames) {
+            auto info = model.getPinInfo(name);
+            if (!info) {
+                if (error) *error = "Pin not found: " + name;
+                return std::nullopt;
+            }
+            if (info->outputCell < 0 && info->inputCell < 0) {
+                if (error) *error = "Pin has no boundary-scan cells: " + name;
+                return std::nullopt;
+            }
+
+            BusPin pin;
+            pin.name = std::string(info->name);
+            pin.outputCell = info->outputCell;
+            pin.inputCell = info->inputCell;
+            pin.controlCell = info->controlCell;
+            pin.disableValue = info->disableValue;
+            handle.pins.push_back(pin);
+        }
+
+        return handle;
+    }
+
+    bool BusHandle::canDrive() const {
+        for (const auto& pin : pins) {
+            if (pin.outputCell < 0) return false;
+        }
+        return !pins.empty();
+    }
+
+    bool BusHandle::canRead() const {
+        for (const auto& pin : pins) {
+            if (pin.inputCell < 0) return false;
+        }
+        return !pins.empty();
+    }
+
+    void BusHandle::drive(uint8_t* image, uint64_t value) const {
+        for (size_t i = 0; i < pins.size(); ++i) {
+            const BusPin& pin = pins[i];
+            if (pin.outputCell >= 0) setBit(image, pin.outputCell, (value >> i) & 1);
+            if (pin.controlCell >= 0) setBit(image, pin.controlCell, pin.disableValue != 1);
+        }
+    }
+
+    void BusHandle::release(uint8_t* image) const {
+        for (const auto& pin : pins) {
+            if (pin.controlCell >= 0) setBit(image, pin.controlCell, pin.disableValue == 1);
+        }
+    }
+
+    uint64_t BusHandle::read(const uint8_t* capture) const {
+        uint64_t value = 0;
+        for (size_t i = 0; i < pins.size() && i < 64; ++i) {
+            int cell = pins[i].inputCell >= 0 ? pins[i].inputCell : pins[i].outputCell;
+            if (cell >= 0 && getBit(capture, cell)) value |= (1ull << i);
+        }
+        return value;
+    }
+
+} // namespace JTAG
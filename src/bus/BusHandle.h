@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <optional>
+#include <cstdint>
+
+#include "../bsdl/DeviceModel.h"
+
+namespace JTAG {
+
+    // Pin resuelto a sus celdas BSR (copia mínima de PinView)
+    struct BusPin {
+        std::string name;
+        int outputCell = -1;
+        int inputCell = -1;
+        int controlCell = -1;
+        int disableValue = -1;    // -1: se asume 0 (control activo a nivel alto)
+    };
+
+    /**
+     * @brief Grupo de pines tratado como un bus (bit 0 = primer pin de la lista)
+     *
+     * Resuelve los nombres UNA vez contra el DeviceModel; después escribir o
+     * leer un valor es solo manipulación de bits sobre imágenes BSR, sin
+     * búsquedas por nombre. Sirve tanto para buses anchos (direcciones, datos)
+     * como para señales sueltas (CE#, WE#...) con width() == 1.
+     */
+    class BusHandle {
+    public:
+        BusHandle() = default;
+
+        static std::optional<BusHandle> fromPins(const DeviceModel& model,
+                                                 const std::vector<std::string>& pinNames,
+                                                 std::string* error = nullptr);
+
+        size_t width() const { return pins.size(); }
+        bool empty() const { return pins.empty(); }
+        const std::vector<BusPin>& getPins() const { return pins; }
+
+        bool canDrive() const;   // Todos los pines tienen celda de salida
+        bool canRead() const;    // Todos los pines tienen celda de entrada
+
+        uint64_t mask() const {
+            return pins.size() >= 64 ? ~0ull : ((1ull << pins.size()) - 1);
+        }
+
+        // Operaciones sobre imágenes BSR (layout LSB-first de BoundaryScanEngine)
+        void drive(uint8_t* image, uint64_t value) const;     // Celdas de salida + habilitar driver
+        void release(uint8_t* image) const;                   // Driver en alta impedancia
+        uint64_t read(const uint8_t* capture) const;          // Celdas de entrada (TDO)
+
+    private:
+        std::vector<BusPin> pins;
+    };
+
+} // namespace JTAG
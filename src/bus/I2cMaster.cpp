@@ -0,0 +1,304 @@
+#include "I2cMaster.h"
+#include "../core/BitUtils.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+
+namespace JTAG {
+
+    namespace {
+        // Sondeos de ACK por lote tras una escritura de página de EEPROM
+        constexpr size_t ACK_POLLS_PER_BATCH = 8;
+    }
+
+    I2cMaster::I2cMaster(IJTAGAdapter* adapter, const DeviceModel& model, std::vector<uint8_t> baseImage)
+        : adapter(adapter)
+        , model(model)
+        , bsrLength(model.getBSRLength())
+        , image(std::move(baseImage))
+    {
+        image.resize(bytesForBits(bsrLength), 0);
+    }
+
+    bool I2cMaster::fail(const std::string& message) {
+        lastError = message;
+        std::cerr << "[I2cMaster] " << message << "\n";
+        return false;
+    }
+
+    bool I2cMaster::configure(const I2cPins& pins) {
+        configured = false;
+        std::string error;
+
+        auto resolve = [&](const std::string& name, BusHandle& out, const char* what) {
+            if (name.empty()) return fail(std::string(what) + " pin not assigned");
+            auto handle = BusHandle::fromPins(model, { name }, &error);
+            if (!handle) return fail(std::string(what) + ": " + error);
+            if (!handle->canDrive() || !handle->canRead()) {
+                return fail(std::string(what) + ": pin must be bidirectional");
+            }
+            out = std::move(*handle);
+            return true;
+        };
+
+        if (!resolve(pins.scl, sclLine, "SCL")) return false;
+        if (!resolve(pins.sda, sdaLine, "SDA")) return false;
+
+        sdaCell = static_cast<size_t>(sdaLine.getPins().front().inputCell);
+        if (sclLine.getPins().front().controlCell < 0 || sdaLine.getPins().front().controlCell < 0) {
+            std::cout << "[I2cMaster] Warning: pin without control cell, driven push-pull\n";
+        }
+
+        configured = true;
+        std::cout << "[I2cMaster] Configured (SCL=" << pins.scl << ", SDA=" << pins.sda << ")\n";
+        return true;
+    }
+
+    // ============================================================================
+    // COMPILACIÓN
+    // ============================================================================
+
+    void I2cMaster::setLine(uint8_t* img, const BusHandle& line, bool high) const {
+        if (!high) {
+            line.drive(img, 0);
+        } else if (line.getPins().front().controlCell >= 0) {
+            line.release(img);
+        } else {
+            line.drive(img, 1);
+        }
+    }
+
+    void I2cMaster::start(ScanSequence& seq) const {
+        // Válido también como START repetido (SCL puede estar bajo)
+        uint8_t* img = seq.image();
+        setLine(img, sdaLine, true);
+        seq.commit();
+        setLine(img, sclLine, true);
+        seq.commit();
+        setLine(img, sdaLine, false);
+        seq.commit();
+        setLine(img, sclLine, false);
+        seq.commit();
+    }
+
+    void I2cMaster::stop(ScanSequence& seq) const {
+        uint8_t* img = seq.image();
+        setLine(img, sdaLine, false);
+        seq.commit();
+        setLine(img, sclLine, true);
+        seq.commit();
+        setLine(img, sdaLine, true);
+        seq.commit();
+    }
+
+    size_t I2cMaster::writeByte(ScanSequence& seq, uint8_t value) const {
+        uint8_t* img = seq.image();
+        for (int bit = 7; bit >= 0; --bit) {
+            setLine(img, sdaLine, (value >> bit) & 1);
+            seq.commit();
+            setLine(img, sclLine, true);
+            seq.commit();
+            setLine(img, sclLine, false);
+            seq.commit();
+        }
+
+        // ACK: el esclavo baja SDA durante el noveno pulso
+        setLine(img, sdaLine, true);
+        seq.commit();
+        setLine(img, sclLine, true);
+        size_t slot = seq.commit(true);
+        setLine(img, sclLine, false);
+        seq.commit();
+        return slot;
+    }
+
+    size_t I2cMaster::readByte(ScanSequence& seq, bool ack) const {
+        uint8_t* img = seq.image();
+        setLine(img, sdaLine, true);
+        seq.commit();
+
+        size_t firstSlot = 0;
+        for (int bit = 7; bit >= 0; --bit) {
+            setLine(img, sclLine, true);
+            size_t slot = seq.commit(true);
+            if (bit == 7) firstSlot = slot;
+            setLine(img, sclLine, false);
+            seq.commit();
+        }
+
+        // ACK del maestro (NACK en el último byte)
+        setLine(img, sdaLine, !ack);
+        seq.commit();
+        setLine(img, sclLine, true);
+        seq.commit();
+        setLine(img, sclLine, false);
+        seq.commit();
+        setLine(img, sdaLine, true);
+        seq.commit();
+        return firstSlot;
+    }
+
+    uint8_t I2cMaster::decodeByte(const ScanSequence& seq, size_t firstSlot) const {
+        uint8_t value = 0;
+        for (size_t i = 0; i < 8; ++i) {
+            value = static_cast<uint8_t>((value << 1) | (seq.captureBit(firstSlot + i, sdaCell) ? 1 : 0));
+        }
+        return value;
+    }
+
+    void I2cMaster::compileTransaction(ScanSequence& seq, uint8_t address, const std::vector<uint8_t>& tx,
+                                       size_t rxCount, std::vector<size_t>& ackSlots,
+                                       std::vector<size_t>& rxSlots) const {
+        if (!tx.empty() || rxCount == 0) {
+            start(seq);
+            ackSlots.push_back(writeByte(seq, static_cast<uint8_t>(address << 1)));
+            for (uint8_t b : tx) ackSlots.push_back(writeByte(seq, b));
+        }
+        if (rxCount > 0) {
+            start(seq);
+            ackSlots.push_back(writeByte(seq, static_cast<uint8_t>((address << 1) | 1)));
+            for (size_t i = 0; i < rxCount; ++i) rxSlots.push_back(readByte(seq, i + 1 < rxCount));
+        }
+        stop(seq);
+    }
+
+    bool I2cMaster::checkAcks(const ScanSequence& seq, const std::vector<size_t>& ackSlots, uint8_t address) {
+        for (size_t i = 0; i < ackSlots.size(); ++i) {
+            if (!ackAt(seq, ackSlots[i])) {
+                stats.nacks++;
+                std::ostringstream msg;
+                msg << "NACK from 0x" << std::hex << std::setw(2) << std::setfill('0') << int(address)
+                    << std::dec << (i == 0 ? " (address)" : " at byte ");
+                if (i > 0) msg << i - 1;
+                return fail(msg.str());
+            }
+        }
+        return true;
+    }
+
+    bool I2cMaster::run(ScanSequence& seq) {
+        if (!configured) return fail("I2C pins not configured");
+        if (!seq.execute(adapter, maxImagesPerBatch)) return fail("Adapter batch transfer failed");
+
+        stats.batches += seq.getBatchCount();
+        stats.images += seq.size();
+        image.assign(seq.image(), seq.image() + bytesForBits(bsrLength));
+        return true;
+    }
+
+    // ============================================================================
+    // TRANSACCIONES
+    // ============================================================================
+
+    bool I2cMaster::writeRead(uint8_t address, const std::vector<uint8_t>& tx, size_t rxCount,
+                              std::vector<uint8_t>& rx) {
+        ScanSequence seq(bsrLength, image);
+        std::vector<size_t> ackSlots, rxSlots;
+        compileTransaction(seq, address, tx, rxCount, ackSlots, rxSlots);
+
+        if (!run(seq)) return false;
+        if (!checkAcks(seq, ackSlots, address)) return false;
+
+        rx.resize(rxSlots.size());
+        for (size_t i = 0; i < rxSlots.size(); ++i) rx[i] = decodeByte(seq, rxSlots[i]);
+        return true;
+    }
+
+    bool I2cMaster::write(uint8_t address, const std::vector<uint8_t>& data) {
+        std::vector<uint8_t> rx;
+        return writeRead(address, data, 0, rx);
+    }
+
+    bool I2cMaster::read(uint8_t address, size_t count, std::vector<uint8_t>& out) {
+        return writeRead(address, {}, count, out);
+    }
+
+    bool I2cMaster::probe(uint8_t address, bool& present) {
+        ScanSequence seq(bsrLength, image);
+        std::vector<size_t> ackSlots, rxSlots;
+        compileTransaction(seq, address, {}, 0, ackSlots, rxSlots);
+
+        if (!run(seq)) return false;
+        present = ackAt(seq, ackSlots[0]);
+        return true;
+    }
+
+    bool I2cMaster::scanBus(std::vector<uint8_t>& found, uint8_t first, uint8_t last) {
+        found.clear();
+        if (first > last) return true;
+
+        // Todas las direcciones en un lote: START + dirección + STOP por cada una
+        ScanSequence seq(bsrLength, image);
+        std::vector<size_t> ackSlots, rxSlots;
+        for (unsigned a = first; a <= last; ++a) {
+            compileTransaction(seq, static_cast<uint8_t>(a), {}, 0, ackSlots, rxSlots);
+        }
+
+        if (!run(seq)) return false;
+
+        for (unsigned a = first; a <= last; ++a) {
+            if (ackAt(seq, ackSlots[a - first])) found.push_back(static_cast<uint8_t>(a));
+        }
+
+        std::cout << "[I2cMaster] Bus scan: " << found.size() << " device(s) in "
+                  << seq.size() << " scans\n";
+        return true;
+    }
+
+    // ============================================================================
+    // EEPROM 24Cxx
+    // ============================================================================
+
+    bool I2cMaster::eepromRead(uint8_t address, uint32_t memAddress, int addrBytes, size_t count,
+                               std::vector<uint8_t>& out) {
+        std::vector<uint8_t> tx;
+        for (int i = addrBytes - 1; i >= 0; --i) tx.push_back(static_cast<uint8_t>(memAddress >> (8 * i)));
+
+        // Lectura secuencial: un único START repetido para todo el bloque
+        return writeRead(address, tx, count, out);
+    }
+
+    bool I2cMaster::eepromWrite(uint8_t address, uint32_t memAddress, int addrBytes,
+                                const std::vector<uint8_t>& data, size_t pageSize, uint32_t timeoutMs) {
+        if (pageSize == 0) pageSize = 1;
+
+        size_t done = 0;
+        while (done < data.size()) {
+            uint32_t a = memAddress + static_cast<uint32_t>(done);
+            size_t n = std::min(pageSize - (a % pageSize), data.size() - done);
+
+            std::vector<uint8_t> tx;
+            for (int i = addrBytes - 1; i >= 0; --i) tx.push_back(static_cast<uint8_t>(a >> (8 * i)));
+            tx.insert(tx.end(), data.begin() + done, data.begin() + done + n);
+            if (!write(address, tx)) return false;
+
+            // Sondeo de ACK: la EEPROM no responde mientras dura el ciclo de escritura
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+            bool ready = false;
+            while (!ready) {
+                ScanSequence seq(bsrLength, image);
+                std::vector<size_t> ackSlots, rxSlots;
+                for (size_t p = 0; p < ACK_POLLS_PER_BATCH; ++p) {
+                    compileTransaction(seq, address, {}, 0, ackSlots, rxSlots);
+                }
+                if (!run(seq)) return false;
+
+                for (size_t slot : ackSlots) {
+                    if (ackAt(seq, slot)) { ready = true; break; }
+                }
+                if (!ready && std::chrono::steady_clock::now() > deadline) {
+                    return fail("EEPROM write cycle timeout");
+                }
+            }
+
+            done += n;
+        }
+
+        std::cout << "[I2cMaster] Wrote " << data.size() << " bytes to EEPROM 0x" << std::hex
+                  << int(address) << std::dec << "\n";
+        return true;
+    }
+
+} // namespace JTAG
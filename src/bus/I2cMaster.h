@@ -0,0 +1,93 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "BusHandle.h"
+#include "ScanSequence.h"
+#include "../hal/IJTAGAdapter.h"
+
+namespace JTAG {
+
+    struct I2cPins {
+        std::string scl;
+        std::string sda;
+    };
+
+    /**
+     * @brief Maestro I2C bit-bang sobre pines de boundary scan (EXTEST)
+     *
+     * Drenador abierto emulado: nivel bajo = driver activo a 0, nivel alto =
+     * driver en alta impedancia (pull-up externo). Si el pin no tiene celda de
+     * control se conduce a 1 (push-pull).
+     *
+     * La transacción completa (START, bits, muestreo de ACK, STOP) se compila
+     * a una ScanSequence y se envía en un lote; ACK y datos se decodifican
+     * después de las capturas. No se soporta clock stretching: con EXTEST cada
+     * semiciclo de SCL dura un scan completo del BSR.
+     */
+    class I2cMaster {
+    public:
+        struct Stats {
+            size_t batches = 0;
+            size_t images = 0;
+            size_t nacks = 0;
+        };
+
+        I2cMaster(IJTAGAdapter* adapter, const DeviceModel& model, std::vector<uint8_t> baseImage);
+        ~I2cMaster() = default;
+
+        bool configure(const I2cPins& pins);
+        void setMaxImagesPerBatch(size_t images) { maxImagesPerBatch = images ? images : 1; }
+
+        // Direcciones de 7 bits
+        bool write(uint8_t address, const std::vector<uint8_t>& data);
+        bool read(uint8_t address, size_t count, std::vector<uint8_t>& out);
+        bool writeRead(uint8_t address, const std::vector<uint8_t>& tx, size_t rxCount, std::vector<uint8_t>& rx);
+
+        // Sondeo de direcciones (todas en un único lote)
+        bool probe(uint8_t address, bool& present);
+        bool scanBus(std::vector<uint8_t>& found, uint8_t first = 0x08, uint8_t last = 0x77);
+
+        // EEPROM serie (24Cxx): addrBytes = 1 o 2 bytes de dirección interna
+        bool eepromRead(uint8_t address, uint32_t memAddress, int addrBytes, size_t count,
+                        std::vector<uint8_t>& out);
+        bool eepromWrite(uint8_t address, uint32_t memAddress, int addrBytes, const std::vector<uint8_t>& data,
+                         size_t pageSize, uint32_t timeoutMs = 50);
+
+        const std::vector<uint8_t>& getImage() const { return image; }
+        const Stats& getStats() const { return stats; }
+        const std::string& getLastError() const { return lastError; }
+
+    private:
+        void setLine(uint8_t* img, const BusHandle& line, bool high) const;
+        void start(ScanSequence& seq) const;
+        void stop(ScanSequence& seq) const;
+        size_t writeByte(ScanSequence& seq, uint8_t value) const;        // Devuelve observación del ACK
+        size_t readByte(ScanSequence& seq, bool ack) const;              // Primera de 8 observaciones
+        bool ackAt(const ScanSequence& seq, size_t slot) const { return !seq.captureBit(slot, sdaCell); }
+        uint8_t decodeByte(const ScanSequence& seq, size_t firstSlot) const;
+
+        // Compila START + dirección + escritura (+ START repetido + lectura) + STOP
+        void compileTransaction(ScanSequence& seq, uint8_t address, const std::vector<uint8_t>& tx,
+                                size_t rxCount, std::vector<size_t>& ackSlots, std::vector<size_t>& rxSlots) const;
+        bool checkAcks(const ScanSequence& seq, const std::vector<size_t>& ackSlots, uint8_t address);
+        bool run(ScanSequence& seq);
+        bool fail(const std::string& message);
+
+        IJTAGAdapter* adapter;
+        const DeviceModel& model;
+        size_t bsrLength;
+        std::vector<uint8_t> image;
+
+        BusHandle sclLine, sdaLine;
+        size_t sdaCell = 0;
+        bool configured = false;
+
+        size_t maxImagesPerBatch = 4096;
+        Stats stats;
+        std::string lastError;
+    };
+
+} // namespace JTAG
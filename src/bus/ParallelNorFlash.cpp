@@ -0,0 +1,495 @@
+#include "ParallelNorFlash.h"
+#include "../core/BitUtils.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+
+namespace JTAG {
+
+    namespace {
+        // Comandos JEDEC / AMD (conjunto 0x0002)
+        constexpr uint16_t CMD_UNLOCK1       = 0xAA;
+        constexpr uint16_t CMD_UNLOCK2       = 0x55;
+        constexpr uint16_t CMD_PROGRAM       = 0xA0;
+        constexpr uint16_t CMD_ERASE_SETUP   = 0x80;
+        constexpr uint16_t CMD_SECTOR_ERASE  = 0x30;
+        constexpr uint16_t CMD_CHIP_ERASE    = 0x10;
+        constexpr uint16_t CMD_WRITE_BUFFER  = 0x25;
+        constexpr uint16_t CMD_BUFFER_CONFIRM = 0x29;
+        constexpr uint16_t CMD_RESET         = 0xF0;
+        constexpr uint16_t CMD_CFI_QUERY     = 0x98;
+
+        constexpr uint16_t DQ5 = 0x20;
+        constexpr uint16_t DQ6 = 0x40;
+
+        // Lecturas por lote durante el sondeo de estado
+        constexpr size_t POLL_READS = 8;
+    }
+
+    ParallelNorFlash::ParallelNorFlash(IJTAGAdapter* adapter, const DeviceModel& model,
+                                       std::vector<uint8_t> baseImage)
+        : adapter(adapter)
+        , model(model)
+        , bsrLength(model.getBSRLength())
+        , image(std::move(baseImage))
+    {
+        image.resize(bytesForBits(bsrLength), 0);
+    }
+
+    bool ParallelNorFlash::fail(const std::string& message) {
+        lastError = message;
+        std::cerr << "[ParallelNorFlash] " << message << "\n";
+        return false;
+    }
+
+    // ============================================================================
+    // CONFIGURACIÓN
+    // ============================================================================
+
+    bool ParallelNorFlash::configure(const NorFlashPins& pins) {
+        configured = false;
+        std::string error;
+
+        auto resolve = [&](const std::vector<std::string>& names, BusHandle& out, const char* what) {
+            auto handle = BusHandle::fromPins(model, names, &error);
+            if (!handle) return fail(std::string(what) + ": " + error);
+            if (!handle->canDrive()) return fail(std::string(what) + ": all pins need an output cell");
+            out = std::move(*handle);
+            return true;
+        };
+        auto resolveLine = [&](const std::string& name, BusHandle& out, const char* what, bool optional) {
+            if (name.empty()) {
+                out = BusHandle{};
+                return optional ? true : fail(std::string(what) + " pin not assigned");
+            }
+            return resolve({ name }, out, what);
+        };
+
+        if (pins.address.empty()) return fail("Address bus is empty");
+        if (pins.data.size() != 8 && pins.data.size() != 16) return fail("Data bus must be 8 or 16 bits wide");
+
+        if (!resolve(pins.address, addressBus, "Address bus")) return false;
+        if (!resolve(pins.data, dataBus, "Data bus")) return false;
+        if (!dataBus.canRead()) return fail("Data bus: all pins need an input cell");
+
+        if (!resolveLine(pins.ce, ceLine, "CE#", false)) return false;
+        if (!resolveLine(pins.oe, oeLine, "OE#", false)) return false;
+        if (!resolveLine(pins.we, weLine, "WE#", false)) return false;
+        if (!resolveLine(pins.reset, resetLine, "RESET#", true)) return false;
+        if (!resolveLine(pins.wp, wpLine, "WP#", true)) return false;
+
+        // Direcciones de desbloqueo: en modo x8 el bus direcciona bytes
+        if (dataBus.width() == 8) {
+            unlockAddr1 = 0xAAA;
+            unlockAddr2 = 0x555;
+        } else {
+            unlockAddr1 = 0x555;
+            unlockAddr2 = 0x2AA;
+        }
+
+        configured = true;
+        std::cout << "[ParallelNorFlash] Configured: " << addressBus.width() << " address bits, x"
+                  << dataBus.width() << " data\n";
+        return true;
+    }
+
+    // ============================================================================
+    // COMPILACIÓN DE CICLOS DE BUS
+    // ============================================================================
+
+    ScanSequence ParallelNorFlash::newSequence() const {
+        return ScanSequence(bsrLength, image);
+    }
+
+    void ParallelNorFlash::busIdle(ScanSequence& seq) const {
+        uint8_t* img = seq.image();
+        ceLine.drive(img, 1);
+        oeLine.drive(img, 1);
+        weLine.drive(img, 1);
+        if (!resetLine.empty()) resetLine.drive(img, 1);
+        if (!wpLine.empty()) wpLine.drive(img, 1);
+        dataBus.release(img);
+    }
+
+    void ParallelNorFlash::writeCycle(ScanSequence& seq, uint32_t address, uint16_t data) const {
+        uint8_t* img = seq.image();
+
+        // 1. Setup: dirección + dato, CE# bajo, OE#/WE# altos
+        addressBus.drive(img, address);
+        dataBus.drive(img, data);
+        ceLine.drive(img, 0);
+        oeLine.drive(img, 1);
+        weLine.drive(img, 1);
+        seq.commit();
+
+        // 2. WE# bajo (la flash captura la dirección en el flanco de bajada)
+        weLine.drive(img, 0);
+        seq.commit();
+
+        // 3. WE# alto (captura del dato en el flanco de subida)
+        weLine.drive(img, 1);
+        seq.commit();
+    }
+
+    size_t ParallelNorFlash::readCycle(ScanSequence& seq, uint32_t address) const {
+        uint8_t* img = seq.image();
+        dataBus.release(img);
+        addressBus.drive(img, address);
+        weLine.drive(img, 1);
+        ceLine.drive(img, 0);
+        oeLine.drive(img, 0);
+        return seq.commit(true);
+    }
+
+    void ParallelNorFlash::unlock(ScanSequence& seq) const {
+        writeCycle(seq, unlockAddr1, CMD_UNLOCK1);
+        writeCycle(seq, unlockAddr2, CMD_UNLOCK2);
+    }
+
+    bool ParallelNorFlash::run(ScanSequence& seq) {
+        if (!configured) return fail("Flash pins not configured");
+
+        if (!seq.execute(adapter, maxImagesPerBatch)) {
+            return fail("Adapter batch transfer failed");
+        }
+
+        stats.batches += seq.getBatchCount();
+        stats.images += seq.size();
+
+        // La última imagen enviada es el nuevo estado de los pines
+        image.assign(seq.image(), seq.image() + bytesForBits(bsrLength));
+        return true;
+    }
+
+    uint16_t ParallelNorFlash::dataAt(const ScanSequence& seq, size_t slot) const {
+        return static_cast<uint16_t>(dataBus.read(seq.capture(slot)) & dataBus.mask());
+    }
+
+    // ============================================================================
+    // SONDEO DE ESTADO (DQ6 toggle / DQ5 timeout)
+    // ============================================================================
+
+    bool ParallelNorFlash::waitReady(uint32_t address, uint32_t timeoutMs) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+
+        while (true) {
+            // Cada lectura necesita su propio flanco de OE# para que DQ6 conmute
+            ScanSequence seq = newSequence();
+            std::vector<size_t> readSlots;
+            for (size_t i = 0; i < POLL_READS; ++i) {
+                readSlots.push_back(readCycle(seq, address));
+                oeLine.drive(seq.image(), 1);
+                seq.commit();
+            }
+            busIdle(seq);
+            seq.commit();
+
+            if (!run(seq)) return false;
+            stats.pollRounds++;
+
+            for (size_t i = 0; i + 1 < readSlots.size(); ++i) {
+                uint16_t a = dataAt(seq, readSlots[i]);
+                uint16_t b = dataAt(seq, readSlots[i + 1]);
+                if (((a ^ b) & DQ6) == 0) return true;   // DQ6 ya no conmuta: operación terminada
+
+                if (a & DQ5) {
+                    // DQ5 con DQ6 todavía conmutando en las siguientes lecturas: fallo interno
+                    if (i + 2 < readSlots.size() && ((b ^ dataAt(seq, readSlots[i + 2])) & DQ6)) {
+                        resetCommand();
+                        return fail("Device reported DQ5 timeout");
+                    }
+                }
+            }
+
+            if (std::chrono::steady_clock::now() > deadline) {
+                resetCommand();
+                return fail("Timeout waiting for flash operation");
+            }
+        }
+    }
+
+    // ============================================================================
+    // OPERACIONES
+    // ============================================================================
+
+    bool ParallelNorFlash::resetCommand() {
+        ScanSequence seq = newSequence();
+        writeCycle(seq, 0, CMD_RESET);
+        busIdle(seq);
+        seq.commit();
+        return run(seq);
+    }
+
+    bool ParallelNorFlash::readCFI(CfiInfo& info) {
+        info = CfiInfo{};
+
+        // Todo el query en un único lote: entrar, leer 0x10..0x3C, salir
+        const uint32_t scale = (dataBus.width() == 8) ? 2 : 1;   // x8: direcciones de byte
+        constexpr uint32_t first = 0x10, last = 0x3C;
+
+        ScanSequence seq = newSequence();
+        writeCycle(seq, 0x55 * scale, CMD_CFI_QUERY);
+        std::vector<size_t> readSlots;
+        for (uint32_t off = first; off <= last; ++off) {
+            readSlots.push_back(readCycle(seq, off * scale));
+        }
+        busIdle(seq);
+        seq.commit();
+        writeCycle(seq, 0, CMD_RESET);
+        busIdle(seq);
+        seq.commit();
+
+        if (!run(seq)) return false;
+
+        auto q = [&](uint32_t off) -> uint32_t { return dataAt(seq, readSlots[off - first]) & 0xFF; };
+
+        if (q(0x10) != 'Q' || q(0x11) != 'R' || q(0x12) != 'Y') {
+            return fail("CFI signature 'QRY' not found");
+        }
+
+        info.valid = true;
+        info.primaryCommandSet = static_cast<uint16_t>(q(0x13) | (q(0x14) << 8));
+        info.typicalWordProgramUs = q(0x1F) ? (1u << q(0x1F)) : 0;
+        info.typicalBufferProgramUs = q(0x20) ? (1u << q(0x20)) : 0;
+        info.typicalSectorEraseMs = q(0x21) ? (1u << q(0x21)) : 0;
+        info.maxSectorEraseMs = info.typicalSectorEraseMs * (q(0x25) ? (1u << q(0x25)) : 1);
+        info.deviceSizeBytes = (q(0x27) < 32) ? (1u << q(0x27)) : 0;
+        info.interfaceCode = static_cast<uint16_t>(q(0x28) | (q(0x29) << 8));
+        uint32_t bufferExp = q(0x2A) | (q(0x2B) << 8);
+        info.writeBufferBytes = (bufferExp > 0 && bufferExp < 16) ? (1u << bufferExp) : 0;
+
+        uint32_t regions = std::min<uint32_t>(q(0x2C), 4);
+        for (uint32_t r = 0; r < regions; ++r) {
+            uint32_t base = 0x2D + r * 4;
+            CfiEraseRegion region;
+            region.blockCount = (q(base) | (q(base + 1) << 8)) + 1;
+            uint32_t size = q(base + 2) | (q(base + 3) << 8);
+            region.blockSizeBytes = size ? size * 256 : 128;
+            info.eraseRegions.push_back(region);
+        }
+
+        std::cout << "[ParallelNorFlash] CFI: command set 0x" << std::hex << std::setw(4) << std::setfill('0')
+                  << info.primaryCommandSet << std::dec << ", " << info.deviceSizeBytes / 1024 << " KB, buffer "
+                  << info.writeBufferBytes << " bytes, " << info.eraseRegions.size() << " erase region(s)\n";
+        return true;
+    }
+
+    bool ParallelNorFlash::read(uint32_t wordAddress, size_t count, std::vector<uint16_t>& out) {
+        out.clear();
+        out.reserve(count);
+
+        // Lectura segmentada: una imagen por palabra (el TDO del scan siguiente
+        // captura el dato de la dirección actual)
+        const size_t chunk = std::max<size_t>(maxImagesPerBatch - 2, 1);
+
+        for (size_t done = 0; done < count; done += chunk) {
+            size_t n = std::min(chunk, count - done);
+            ScanSequence seq = newSequence();
+            std::vector<size_t> readSlots;
+            readSlots.reserve(n);
+            for (size_t i = 0; i < n; ++i) {
+                readSlots.push_back(readCycle(seq, static_cast<uint32_t>(wordAddress + done + i)));
+            }
+            busIdle(seq);
+            seq.commit();
+
+            if (!run(seq)) return false;
+            for (size_t slot : readSlots) out.push_back(dataAt(seq, slot));
+        }
+        return true;
+    }
+
+    bool ParallelNorFlash::eraseSector(uint32_t sectorWordAddress, uint32_t timeoutMs) {
+        ScanSequence seq = newSequence();
+        unlock(seq);
+        writeCycle(seq, unlockAddr1, CMD_ERASE_SETUP);
+        unlock(seq);
+        writeCycle(seq, sectorWordAddress, CMD_SECTOR_ERASE);
+        busIdle(seq);
+        seq.commit();
+
+        if (!run(seq)) return false;
+        if (!waitReady(sectorWordAddress, timeoutMs)) return false;
+
+        std::cout << "[ParallelNorFlash] Sector at 0x" << std::hex << sectorWordAddress << std::dec << " erased\n";
+        return true;
+    }
+
+    bool ParallelNorFlash::eraseChip(uint32_t timeoutMs) {
+        ScanSequence seq = newSequence();
+        unlock(seq);
+        writeCycle(seq, unlockAddr1, CMD_ERASE_SETUP);
+        unlock(seq);
+        writeCycle(seq, unlockAddr1, CMD_CHIP_ERASE);
+        busIdle(seq);
+        seq.commit();
+
+        if (!run(seq)) return false;
+        return waitReady(0, timeoutMs);
+    }
+
+    bool ParallelNorFlash::programWords(uint32_t wordAddress, const std::vector<uint16_t>& data,
+                                        const ProgressCallback& progress) {
+        const uint16_t busMask = static_cast<uint16_t>(dataBus.mask());
+
+        struct Pending { uint32_t address; uint16_t value; size_t statusSlot; };
+        std::vector<Pending> pending;
+
+        size_t index = 0;
+        while (index < data.size()) {
+            ScanSequence seq = newSequence();
+            pending.clear();
+
+            // Compilar hasta wordsPerBatch palabras (las ya borradas, 0xFFFF, se saltan)
+            while (index < data.size() && pending.size() < wordsPerBatch) {
+                uint16_t value = data[index] & busMask;
+                uint32_t address = static_cast<uint32_t>(wordAddress + index);
+                index++;
+                if (value == busMask) continue;
+
+                unlock(seq);
+                writeCycle(seq, unlockAddr1, CMD_PROGRAM);
+                writeCycle(seq, address, value);
+
+                // Lectura de estado: con el scan a velocidad JTAG la programación
+                // típica (decenas de µs) ya ha terminado y el bus devuelve el dato
+                size_t slot = readCycle(seq, address);
+                oeLine.drive(seq.image(), 1);
+                seq.commit();
+                pending.push_back({ address, value, slot });
+            }
+            busIdle(seq);
+            seq.commit();
+
+            if (pending.empty()) continue;
+            if (!run(seq)) return false;
+
+            // Palabras todavía ocupadas: sondeo individual y relectura
+            for (const auto& p : pending) {
+                if (dataAt(seq, p.statusSlot) == p.value) continue;
+
+                if (!waitReady(p.address, 100)) return false;
+
+                std::vector<uint16_t> readBack;
+                if (!read(p.address, 1, readBack)) return false;
+                if (readBack[0] != p.value) {
+                    std::ostringstream msg;
+                    msg << "Program failed at 0x" << std::hex << p.address << ": wrote 0x" << p.value
+                        << ", read 0x" << readBack[0];
+                    return fail(msg.str());
+                }
+            }
+
+            if (progress && !progress(index, data.size())) return fail("Cancelled");
+        }
+
+        std::cout << "[ParallelNorFlash] Programmed " << data.size() << " words in "
+                  << stats.batches << " batches\n";
+        return true;
+    }
+
+    bool ParallelNorFlash::programBuffered(uint32_t wordAddress, const std::vector<uint16_t>& data,
+                                           size_t bufferWords, const ProgressCallback& progress) {
+        if (bufferWords <= 1) return programWords(wordAddress, data, progress);
+
+        const uint16_t busMask = static_cast<uint16_t>(dataBus.mask());
+
+        struct Pending { uint32_t lastAddress; uint16_t lastValue; size_t statusSlot; };
+        std::vector<Pending> pending;
+
+        size_t index = 0;
+        std::vector<uint16_t> readBack;
+        while (index < data.size()) {
+            ScanSequence seq = newSequence();
+            pending.clear();
+            const size_t batchStart = index;
+            size_t wordsInBatch = 0;
+
+            while (index < data.size() && wordsInBatch < wordsPerBatch) {
+                // Página de buffer: no puede cruzar un límite de bufferWords
+                uint32_t address = static_cast<uint32_t>(wordAddress + index);
+                uint32_t pageBase = address - (address % bufferWords);
+                size_t n = std::min(bufferWords - (address - pageBase), data.size() - index);
+
+                unlock(seq);
+                writeCycle(seq, pageBase, CMD_WRITE_BUFFER);
+                writeCycle(seq, pageBase, static_cast<uint16_t>(n - 1));
+                for (size_t i = 0; i < n; ++i) {
+                    writeCycle(seq, address + static_cast<uint32_t>(i), data[index + i] & busMask);
+                }
+                writeCycle(seq, pageBase, CMD_BUFFER_CONFIRM);
+
+                uint32_t lastAddress = address + static_cast<uint32_t>(n - 1);
+                size_t slot = readCycle(seq, lastAddress);
+                oeLine.drive(seq.image(), 1);
+                seq.commit();
+                pending.push_back({ lastAddress, static_cast<uint16_t>(data[index + n - 1] & busMask), slot });
+
+                index += n;
+                wordsInBatch += n;
+            }
+            busIdle(seq);
+            seq.commit();
+
+            if (!run(seq)) return false;
+
+            for (const auto& p : pending) {
+                if (dataAt(seq, p.statusSlot) == p.lastValue) continue;
+                if (!waitReady(p.lastAddress, 100)) return false;
+            }
+
+            // El estado solo mira la última palabra de cada página: releer el lote completo
+            if (!read(static_cast<uint32_t>(wordAddress + batchStart), index - batchStart, readBack)) return false;
+            for (size_t i = 0; i < readBack.size(); ++i) {
+                uint16_t value = data[batchStart + i] & busMask;
+                if (readBack[i] != value) {
+                    std::ostringstream msg;
+                    msg << "Program failed at 0x" << std::hex << (wordAddress + batchStart + i) << ": wrote 0x"
+                        << value << ", read 0x" << readBack[i];
+                    return fail(msg.str());
+                }
+            }
+
+            if (progress && !progress(index, data.size())) return fail("Cancelled");
+        }
+
+        std::cout << "[ParallelNorFlash] Buffer-programmed " << data.size() << " words in "
+                  << stats.batches << " batches\n";
+        return true;
+    }
+
+    bool ParallelNorFlash::verify(uint32_t wordAddress, const std::vector<uint16_t>& expected,
+                                  const std::vector<uint16_t>& mask, size_t* firstMismatch,
+                                  const ProgressCallback& progress) {
+        // Máscara vacía = comparar todo; si se da, una entrada por palabra
+        if (!mask.empty() && mask.size() < expected.size()) {
+            return fail("Verify mask shorter than expected data");
+        }
+
+        const uint16_t busMask = static_cast<uint16_t>(dataBus.mask());
+        const size_t chunk = std::max<size_t>(maxImagesPerBatch - 2, 1);
+        std::vector<uint16_t> actual;
+
+        for (size_t done = 0; done < expected.size(); done += chunk) {
+            size_t n = std::min(chunk, expected.size() - done);
+            if (!read(static_cast<uint32_t>(wordAddress + done), n, actual)) return false;
+
+            for (size_t i = 0; i < n; ++i) {
+                uint16_t m = busMask & (mask.empty() ? 0xFFFF : mask[done + i]);
+                if ((actual[i] ^ expected[done + i]) & m) {
+                    if (firstMismatch) *firstMismatch = done + i;
+                    std::ostringstream msg;
+                    msg << "Verify mismatch at 0x" << std::hex << (wordAddress + done + i)
+                        << ": expected 0x" << expected[done + i] << ", read 0x" << actual[i];
+                    return fail(msg.str());
+                }
+            }
+
+            if (progress && !progress(done + n, expected.size())) return fail("Cancelled");
+        }
+        return true;
+    }
+
+} // namespace JTAG
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+#include "BusHandle.h"
+#include "ScanSequence.h"
+#include "../hal/IJTAGAdapter.h"
+
+namespace JTAG {
+
+    // Conexión de la flash a pines del dispositivo con boundary scan
+    struct NorFlashPins {
+        std::vector<std::string> address;   // A0..An (LSB primero, direcciones de palabra)
+        std::vector<std::string> data;      // DQ0..DQ7 o DQ0..DQ15
+        std::string ce;                     // CE#  (activo bajo)
+        std::string oe;                     // OE#  (activo bajo)
+        std::string we;                     // WE#  (activo bajo)
+        std::string reset;                  // RESET# opcional (se mantiene alto)
+        std::string wp;                     // WP#/ACC opcional (se mantiene alto)
+    };
+
+    struct CfiEraseRegion {
+        uint32_t blockCount = 0;
+        uint32_t blockSizeBytes = 0;
+    };
+
+    struct CfiInfo {
+        bool valid = false;
+        uint16_t primaryCommandSet = 0;     // 0x0002 = AMD/Spansion, 0x0001 = Intel
+        uint32_t deviceSizeBytes = 0;
+        uint16_t interfaceCode = 0;         // 0 = x8, 1 = x16, 2 = x8/x16
+        uint32_t writeBufferBytes = 0;      // 0 = sin buffer de escritura
+        uint32_t typicalWordProgramUs = 0;
+        uint32_t typicalBufferProgramUs = 0;
+        uint32_t typicalSectorEraseMs = 0;
+        uint32_t maxSectorEraseMs = 0;
+        std::vector<CfiEraseRegion> eraseRegions;
+    };
+
+    /**
+     * @brief Programación de NOR paralela (comandos AMD/JEDEC) a través de EXTEST
+     *
+     * Cada ciclo de bus se compila a imágenes BSR (ScanSequence) y se envía en
+     * lote al adaptador: un viaje USB por bloque de palabras en lugar de uno
+     * por flanco de WE#. Las lecturas van segmentadas: una imagen por palabra,
+     * porque el TDO de cada scan captura el dato de la dirección anterior.
+     *
+     * Requiere el dispositivo en EXTEST con el resto de pines en estado seguro
+     * (baseImage, normalmente BoundaryScanEngine::getBSR()).
+     */
+    class ParallelNorFlash {
+    public:
+        // (palabras procesadas, total). Devolver false cancela.
+        using ProgressCallback = std::function<bool(size_t, size_t)>;
+
+        struct Stats {
+            size_t batches = 0;       // Viajes de ida y vuelta al adaptador
+            size_t images = 0;        // Imágenes BSR enviadas
+            size_t pollRounds = 0;    // Lotes extra de sondeo de estado
+        };
+
+        ParallelNorFlash(IJTAGAdapter* adapter, const DeviceModel& model, std::vector<uint8_t> baseImage);
+        ~ParallelNorFlash() = default;
+
+        bool configure(const NorFlashPins& pins);
+        void setWordsPerBatch(size_t words) { wordsPerBatch = words ? words : 1; }
+        void setMaxImagesPerBatch(size_t images) { maxImagesPerBatch = images ? images : 1; }
+
+        // Operaciones de flash
+        bool readCFI(CfiInfo& info);
+        bool resetCommand();
+        bool read(uint32_t wordAddress, size_t count, std::vector<uint16_t>& out);
+        bool eraseSector(uint32_t sectorWordAddress, uint32_t timeoutMs = 10000);
+        bool eraseChip(uint32_t timeoutMs = 300000);
+        bool programWords(uint32_t wordAddress, const std::vector<uint16_t>& data,
+                          const ProgressCallback& progress = nullptr);
+        // Write-buffer por páginas de bufferWords; relee cada lote para verificarlo
+        bool programBuffered(uint32_t wordAddress, const std::vector<uint16_t>& data,
+                             size_t bufferWords, const ProgressCallback& progress = nullptr);
+
+        // Verificación enmascarada: ((leído ^ esperado) & mask) == 0
+        // mask vacío = todos los bits del bus de datos; si no, al menos una entrada por palabra
+        bool verify(uint32_t wordAddress, const std::vector<uint16_t>& expected,
+                    const std::vector<uint16_t>& mask = {}, size_t* firstMismatch = nullptr,
+                    const ProgressCallback& progress = nullptr);
+
+        const std::vector<uint8_t>& getImage() const { return image; }
+        const Stats& getStats() const { return stats; }
+        const std::string& getLastError() const { return lastError; }
+
+    private:
+        ScanSequence newSequence() const;
+        void busIdle(ScanSequence& seq) const;
+        void writeCycle(ScanSequence& seq, uint32_t address, uint16_t data) const;
+        size_t readCycle(ScanSequence& seq, uint32_t address) const;
+        void unlock(ScanSequence& seq) const;
+        bool run(ScanSequence& seq);
+        uint16_t dataAt(const ScanSequence& seq, size_t slot) const;
+
+        // Sondeo DQ6 (toggle) / DQ5 (timeout) hasta fin de operación
+        bool waitReady(uint32_t address, uint32_t timeoutMs);
+        bool fail(const std::string& message);
+
+        IJTAGAdapter* adapter;
+        const DeviceModel& model;
+        size_t bsrLength;
+        std::vector<uint8_t> image;   // Última imagen enviada (estado actual de los pines)
+
+        BusHandle addressBus, dataBus, ceLine, oeLine, weLine, resetLine, wpLine;
+        uint32_t unlockAddr1 = 0x555;   // x16: 0x555 / 0x2AA, x8: 0xAAA / 0x555
+        uint32_t unlockAddr2 = 0x2AA;
+        bool configured = false;
+
+        size_t wordsPerBatch = 64;
+        size_t maxImagesPerBatch = 2048;
+        Stats stats;
+        std::string lastError;
+    };
+
+} // namespace JTAG
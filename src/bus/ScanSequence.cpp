@@ -0,0 +1,104 @@
+#include "ScanSequence.h"
+#include "../core/BitUtils.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+namespace JTAG {
+
+    ScanSequence::ScanSequence(size_t bsrLength, const std::vector<uint8_t>& initialImage)
+        : bsrLength(bsrLength)
+        , stride(bytesForBits(bsrLength))
+        , working(initialImage)
+    {
+        working.resize(stride, 0);
+        base = working;
+        previous = working;
+        stepOffsets.push_back(0);
+    }
+
+    size_t ScanSequence::commit(bool observe) {
+        // Delta respecto al paso anterior: índices de los bits que cambian
+        for (size_t i = 0; i < stride; ++i) {
+            uint8_t diff = working[i] ^ previous[i];
+            if (!diff) continue;
+            for (unsigned b = 0; b < 8; ++b) {
+                if (diff & (1u << b)) deltaBits.push_back(static_cast<uint32_t>(i * 8 + b));
+            }
+            previous[i] = working[i];
+        }
+        stepOffsets.push_back(static_cast<uint32_t>(deltaBits.size()));
+        size_t step = stepCount++;
+
+        if (observe) {
+            observeSteps.push_back(step);
+            return observeSteps.size() - 1;
+        }
+        return step;
+    }
+
+    void ScanSequence::clear() {
+        base = working;
+        previous = working;
+        deltaBits.clear();
+        stepOffsets.assign(1, 0);
+        stepCount = 0;
+        observeSteps.clear();
+        captures.clear();
+        batchCount = 0;
+    }
+
+    bool ScanSequence::execute(IJTAGAdapter* adapter, size_t maxImagesPerBatch) {
+        if (!adapter || stepCount == 0) return stepCount == 0;
+
+        // El resultado del último paso observado se lee en el scan siguiente:
+        // se envía un paso repetido extra sin añadirlo a la secuencia (execute()
+        // puede repetirse con el mismo resultado)
+        const bool trailingStep = !observeSteps.empty() && observeSteps.back() + 1 >= stepCount;
+        const size_t scanCount = stepCount + (trailingStep ? 1 : 0);
+
+        captures.assign(observeSteps.size() * stride, 0);
+        maxImagesPerBatch = std::max<size_t>(maxImagesPerBatch, 1);
+        const bool needTdo = !observeSteps.empty();
+        batchCount = 0;
+
+        std::vector<uint8_t> current = base;
+        size_t nextObs = 0;
+        for (size_t first = 0; first < scanCount; first += maxImagesPerBatch) {
+            size_t count = std::min(maxImagesPerBatch, scanCount - first);
+
+            // Reconstruir las imágenes del lote aplicando los deltas
+            tdiBatch.resize(count * stride);
+            for (size_t i = 0; i < count; ++i) {
+                size_t step = first + i;
+                if (step < stepCount) {
+                    for (uint32_t d = stepOffsets[step]; d < stepOffsets[step + 1]; ++d) {
+                        uint32_t bit = deltaBits[d];
+                        current[bit >> 3] ^= static_cast<uint8_t>(1u << (bit & 7));
+                    }
+                }
+                std::memcpy(tdiBatch.data() + i * stride, current.data(), stride);
+            }
+
+            if (needTdo) tdoBatch.resize(count * stride);
+            if (!adapter->scanDRBatch(bsrLength, count, tdiBatch.data(),
+                                      needTdo ? tdoBatch.data() : nullptr)) {
+                std::cerr << "[ScanSequence] scanDRBatch failed at step " << first << "\n";
+                return false;
+            }
+            batchCount++;
+
+            // Copiar las observaciones cuyo TDO (paso + 1) cae en este lote
+            while (nextObs < observeSteps.size()) {
+                size_t tdoStep = observeSteps[nextObs] + 1;
+                if (tdoStep >= first + count) break;
+                std::memcpy(captures.data() + nextObs * stride,
+                            tdoBatch.data() + (tdoStep - first) * stride, stride);
+                nextObs++;
+            }
+        }
+
+        return true;
+    }
+
+} // namespace JTAG
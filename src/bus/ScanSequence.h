@@ -0,0 +1,81 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "../hal/IJTAGAdapter.h"
+
+namespace JTAG {
+
+    /**
+     * @brief Secuencia precompilada de imágenes BSR (EXTEST) ejecutada en lote
+     *
+     * Se edita una imagen de trabajo (BusHandle::drive/release...) y cada
+     * commit() la añade como un paso. execute() envía todos los pasos con
+     * IJTAGAdapter::scanDRBatch: un único viaje de ida y vuelta por lote en lugar
+     * de un applyChanges() por flanco.
+     *
+     * Observación: el TDO de un scan refleja los pines ANTES de su Update-DR,
+     * es decir, el efecto del paso anterior. commit(true) marca el paso para
+     * observar su resultado; internamente se toma el TDO del paso siguiente
+     * (enviando una imagen repetida al final si hace falta, sin añadirla a la
+     * secuencia: execute() no modifica los pasos y puede repetirse).
+     *
+     * Almacenamiento: cada paso se guarda como la lista de bits que cambian
+     * respecto al anterior (codificación delta). Un flanco de reloj es 1 bit
+     * en lugar de una imagen completa; las imágenes se reconstruyen por lotes
+     * en execute() dentro de un único buffer reutilizado.
+     */
+    class ScanSequence {
+    public:
+        ScanSequence(size_t bsrLength, const std::vector<uint8_t>& initialImage);
+
+        uint8_t* image() { return working.data(); }
+        const uint8_t* image() const { return working.data(); }
+        size_t getBSRLength() const { return bsrLength; }
+
+        // Añade la imagen de trabajo. Con observe=true devuelve el índice de
+        // captura (para capture()); si no, devuelve el número de paso.
+        size_t commit(bool observe = false);
+
+        size_t size() const { return stepCount; }
+        size_t observationCount() const { return observeSteps.size(); }
+
+        // Descarta los pasos (conserva la imagen de trabajo como punto de partida)
+        void clear();
+
+        bool execute(IJTAGAdapter* adapter, size_t maxImagesPerBatch = 1024);
+
+        // Imagen TDO del resultado de la observación 'slot' (válida tras execute)
+        const uint8_t* capture(size_t slot) const { return captures.data() + slot * stride; }
+        bool captureBit(size_t slot, size_t cell) const {
+            return (captures[slot * stride + (cell >> 3)] >> (cell & 7)) & 1;
+        }
+
+        size_t getBatchCount() const { return batchCount; }
+
+        // Memoria ocupada por los pasos codificados (sin buffers de lote)
+        size_t getEncodedBytes() const {
+            return deltaBits.size() * sizeof(uint32_t) + stepOffsets.size() * sizeof(uint32_t) + 2 * stride;
+        }
+
+    private:
+        size_t bsrLength;
+        size_t stride;
+        std::vector<uint8_t> working;
+
+        std::vector<uint8_t> base;           // Imagen previa al primer paso
+        std::vector<uint8_t> previous;       // Último paso añadido (para calcular el delta)
+        std::vector<uint32_t> deltaBits;     // Bits que conmutan, concatenados paso a paso
+        std::vector<uint32_t> stepOffsets;   // Inicio de cada paso en deltaBits (+1 centinela)
+        size_t stepCount = 0;
+        std::vector<size_t> observeSteps;    // Pasos cuyo resultado se quiere observar
+
+        std::vector<uint8_t> captures;       // observationCount() imágenes TDO
+        std::vector<uint8_t> tdiBatch;       // Imágenes reconstruidas del lote actual
+        std::vector<uint8_t> tdoBatch;       // Buffer de lote reutilizado
+        size_t batchCount = 0;
+    };
+
+} // namespace JTAG
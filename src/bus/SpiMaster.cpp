@@ -0,0 +1,188 @@
+#include "SpiMaster.h"
+#include "../core/BitUtils.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+namespace JTAG {
+
+    SpiMaster::SpiMaster(IJTAGAdapter* adapter, const DeviceModel& model, std::vector<uint8_t> baseImage)
+        : adapter(adapter)
+        , model(model)
+        , bsrLength(model.getBSRLength())
+        , image(std::move(baseImage))
+    {
+        image.resize(bytesForBits(bsrLength), 0);
+    }
+
+    bool SpiMaster::fail(const std::string& message) {
+        lastError = message;
+        std::cerr << "[SpiMaster] " << message << "\n";
+        return false;
+    }
+
+    bool SpiMaster::configure(const SpiPins& pins, int mode) {
+        configured = false;
+        std::string error;
+
+        auto resolve = [&](const std::string& name, BusHandle& out, const char* what, bool output) {
+            if (name.empty()) return fail(std::string(what) + " pin not assigned");
+            auto handle = BusHandle::fromPins(model, { name }, &error);
+            if (!handle) return fail(std::string(what) + ": " + error);
+            if (output ? !handle->canDrive() : !handle->canRead()) {
+                return fail(std::string(what) + (output ? ": pin has no output cell" : ": pin has no input cell"));
+            }
+            out = std::move(*handle);
+            return true;
+        };
+
+        if (mode < 0 || mode > 3) return fail("SPI mode must be 0..3");
+        if (!resolve(pins.sck, sckLine, "SCK", true)) return false;
+        if (!resolve(pins.mosi, mosiLine, "MOSI", true)) return false;
+        if (!resolve(pins.miso, misoLine, "MISO", false)) return false;
+        if (!resolve(pins.cs, csLine, "CS#", true)) return false;
+
+        misoCell = static_cast<size_t>(misoLine.getPins().front().inputCell);
+        cpol = (mode & 2) != 0;
+        cpha = (mode & 1) != 0;
+        configured = true;
+
+        std::cout << "[SpiMaster] Configured mode " << mode << " (SCK=" << pins.sck << ", MISO cell "
+                  << misoCell << ")\n";
+        return true;
+    }
+
+    // ============================================================================
+    // COMPILACIÓN
+    // ============================================================================
+
+    void SpiMaster::idle(ScanSequence& seq) const {
+        uint8_t* img = seq.image();
+        sckLine.drive(img, cpol);
+        csLine.drive(img, 1);
+        mosiLine.drive(img, 1);
+        misoLine.release(img);
+    }
+
+    size_t SpiMaster::compileByte(ScanSequence& seq, uint8_t value) const {
+        uint8_t* img = seq.image();
+        size_t firstSlot = 0;
+
+        for (int bit = 7; bit >= 0; --bit) {
+            bool level = (value >> bit) & 1;
+            size_t slot;
+            if (!cpha) {
+                // CPHA=0: dato estable antes del flanco de ataque, muestreo en él
+                mosiLine.drive(img, level);
+                sckLine.drive(img, cpol);
+                seq.commit();
+                sckLine.drive(img, !cpol);
+                slot = seq.commit(true);
+            } else {
+                // CPHA=1: dato en el flanco de ataque, muestreo en el de salida
+                mosiLine.drive(img, level);
+                sckLine.drive(img, !cpol);
+                seq.commit();
+                sckLine.drive(img, cpol);
+                slot = seq.commit(true);
+            }
+            if (bit == 7) firstSlot = slot;
+        }
+        return firstSlot;
+    }
+
+    uint8_t SpiMaster::decodeByte(const ScanSequence& seq, size_t firstSlot) const {
+        uint8_t value = 0;
+        for (size_t i = 0; i < 8; ++i) {
+            value = static_cast<uint8_t>((value << 1) | (seq.captureBit(firstSlot + i, misoCell) ? 1 : 0));
+        }
+        return value;
+    }
+
+    bool SpiMaster::run(ScanSequence& seq) {
+        if (!configured) return fail("SPI pins not configured");
+        if (!seq.execute(adapter, maxImagesPerBatch)) return fail("Adapter batch transfer failed");
+
+        stats.batches += seq.getBatchCount();
+        stats.images += seq.size();
+        image.assign(seq.image(), seq.image() + bytesForBits(bsrLength));
+        return true;
+    }
+
+    // ============================================================================
+    // TRANSFERENCIAS
+    // ============================================================================
+
+    bool SpiMaster::transferBatch(std::vector<SpiTransfer>& transfers) {
+        ScanSequence seq(bsrLength, image);
+        std::vector<std::vector<size_t>> byteSlots(transfers.size());
+
+        idle(seq);
+        seq.commit();
+
+        for (size_t t = 0; t < transfers.size(); ++t) {
+            const SpiTransfer& xfer = transfers[t];
+            byteSlots[t].reserve(xfer.tx.size() + xfer.rxCount);
+
+            csLine.drive(seq.image(), 0);
+            seq.commit();
+            for (uint8_t b : xfer.tx) byteSlots[t].push_back(compileByte(seq, b));
+            for (size_t i = 0; i < xfer.rxCount; ++i) byteSlots[t].push_back(compileByte(seq, 0xFF));
+
+            idle(seq);
+            seq.commit();
+        }
+
+        if (!run(seq)) return false;
+
+        // Decodificación en bloque desde las capturas
+        for (size_t t = 0; t < transfers.size(); ++t) {
+            auto& rx = transfers[t].rx;
+            rx.resize(byteSlots[t].size());
+            for (size_t i = 0; i < byteSlots[t].size(); ++i) rx[i] = decodeByte(seq, byteSlots[t][i]);
+        }
+        return true;
+    }
+
+    bool SpiMaster::transfer(const std::vector<uint8_t>& tx, size_t rxCount, std::vector<uint8_t>& rx) {
+        std::vector<SpiTransfer> batch(1);
+        batch[0].tx = tx;
+        batch[0].rxCount = rxCount;
+        if (!transferBatch(batch)) return false;
+        rx = std::move(batch[0].rx);
+        return true;
+    }
+
+    bool SpiMaster::readJedecId(uint32_t& id) {
+        std::vector<uint8_t> rx;
+        if (!transfer({ 0x9F }, 3, rx)) return false;
+
+        id = (static_cast<uint32_t>(rx[1]) << 16) | (static_cast<uint32_t>(rx[2]) << 8) | rx[3];
+        std::cout << "[SpiMaster] JEDEC ID: 0x" << std::hex << std::setw(6) << std::setfill('0') << id
+                  << std::dec << "\n";
+        return true;
+    }
+
+    bool SpiMaster::readFlash(uint32_t address, size_t count, std::vector<uint8_t>& out, bool address4Byte) {
+        out.clear();
+        out.reserve(count);
+
+        // 16 imágenes por byte: trocear para no exceder la memoria de captura
+        const size_t chunk = std::max<size_t>(maxImagesPerBatch / 16, 1) * 4;
+
+        for (size_t done = 0; done < count; done += chunk) {
+            size_t n = std::min(chunk, count - done);
+            uint32_t a = address + static_cast<uint32_t>(done);
+
+            std::vector<uint8_t> cmd;
+            if (address4Byte) cmd = { 0x13, uint8_t(a >> 24), uint8_t(a >> 16), uint8_t(a >> 8), uint8_t(a) };
+            else cmd = { 0x03, uint8_t(a >> 16), uint8_t(a >> 8), uint8_t(a) };
+
+            std::vector<uint8_t> rx;
+            if (!transfer(cmd, n, rx)) return false;
+            out.insert(out.end(), rx.begin() + cmd.size(), rx.end());
+        }
+        return true;
+    }
+
+} // namespace JTAG
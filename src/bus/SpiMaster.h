@@ -0,0 +1,85 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "BusHandle.h"
+#include "ScanSequence.h"
+#include "../hal/IJTAGAdapter.h"
+
+namespace JTAG {
+
+    struct SpiPins {
+        std::string sck;
+        std::string mosi;
+        std::string miso;
+        std::string cs;     // CS# (activo bajo)
+    };
+
+    // Una transacción con CS# propio: se envía tx y se reciben rxCount bytes
+    // adicionales (rellenando MOSI con 0xFF). rx contiene tx.size() + rxCount bytes.
+    struct SpiTransfer {
+        std::vector<uint8_t> tx;
+        size_t rxCount = 0;
+        std::vector<uint8_t> rx;
+    };
+
+    /**
+     * @brief Maestro SPI bit-bang sobre pines de boundary scan (EXTEST)
+     *
+     * Cada bit son dos imágenes BSR (flanco de ataque y de salida de SCK). Las
+     * transacciones se compilan a una ScanSequence, se envían con scanDRBatch
+     * y MISO se decodifica después directamente de la celda de entrada en las
+     * capturas. Varias transacciones pueden ir en un único lote (transferBatch).
+     */
+    class SpiMaster {
+    public:
+        struct Stats {
+            size_t batches = 0;
+            size_t images = 0;
+        };
+
+        SpiMaster(IJTAGAdapter* adapter, const DeviceModel& model, std::vector<uint8_t> baseImage);
+        ~SpiMaster() = default;
+
+        // mode 0..3 (bit 1 = CPOL, bit 0 = CPHA)
+        bool configure(const SpiPins& pins, int mode = 0);
+        void setMaxImagesPerBatch(size_t images) { maxImagesPerBatch = images ? images : 1; }
+
+        bool transfer(const std::vector<uint8_t>& tx, size_t rxCount, std::vector<uint8_t>& rx);
+        bool transferBatch(std::vector<SpiTransfer>& transfers);
+
+        // Comandos comunes de flash SPI (JEDEC)
+        bool readJedecId(uint32_t& id);
+        bool readFlash(uint32_t address, size_t count, std::vector<uint8_t>& out, bool address4Byte = false);
+
+        const std::vector<uint8_t>& getImage() const { return image; }
+        const Stats& getStats() const { return stats; }
+        const std::string& getLastError() const { return lastError; }
+
+    private:
+        void idle(ScanSequence& seq) const;
+        // Compila un byte; devuelve la primera observación (8 consecutivas, MSB primero)
+        size_t compileByte(ScanSequence& seq, uint8_t value) const;
+        uint8_t decodeByte(const ScanSequence& seq, size_t firstSlot) const;
+        bool run(ScanSequence& seq);
+        bool fail(const std::string& message);
+
+        IJTAGAdapter* adapter;
+        const DeviceModel& model;
+        size_t bsrLength;
+        std::vector<uint8_t> image;
+
+        BusHandle sckLine, mosiLine, misoLine, csLine;
+        size_t misoCell = 0;
+        bool cpol = false;
+        bool cpha = false;
+        bool configured = false;
+
+        size_t maxImagesPerBatch = 4096;
+        Stats stats;
+        std::string lastError;
+    };
+
+} // namespace JTAG
@@ -0,0 +1,39 @@
+#include "BsdlLoadTask.h"
+
+namespace JTAG {
+
+    BsdlLoadTask::BsdlLoadTask(uint64_t id, std::filesystem::path path, Prepare prepare)
+        : id(id)
+        , path(std::move(path))
+        , prepare(std::move(prepare))
+    {
+    }
+
+    std::string BsdlLoadTask::getError() const {
+        std::lock_guard<std::mutex> lock(resultMutex);
+        return error;
+    }
+
+    void BsdlLoadTask::reportProgress(int percent, const std::string& stage) {
+        // Monótono: una etapa tardía no puede hacer retroceder la barra
+        if (percent <= progress.load(std::memory_order_relaxed)) return;
+        progress.store(percent, std::memory_order_relaxed);
+        if (onProgress) onProgress(*this, percent, stage);
+    }
+
+    void BsdlLoadTask::finish(Status result, std::unique_ptr<DeviceModel> loaded, std::string message) {
+        {
+            std::lock_guard<std::mutex> lock(resultMutex);
+            model = std::move(loaded);
+            error = std::move(message);
+        }
+        // release: quien lea FINISHED ve el modelo y el trabajo de preparación completos
+        status.store(result, std::memory_order_release);
+    }
+
+    std::unique_ptr<DeviceModel> BsdlLoadTask::takeModel() {
+        std::lock_guard<std::mutex> lock(resultMutex);
+        return std::move(model);
+    }
+
+} // namespace JTAG
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "../bsdl/DeviceModel.h"
+
+namespace JTAG {
+
+    /**
+     * @brief Carga de un BSDL en segundo plano (ScanController::loadBSDLAsync)
+     *
+     * Se ejecuta en el pool de carga del controlador: primero el modelo (caché
+     * .jbmc o parseo completo) y después el paso de preparación opcional del
+     * llamante sobre el modelo ya construido (p.ej. la geometría del chip).
+     * El modelo resultante no se usa hasta que ScanController::adoptLoadedBSDL
+     * lo instala desde el hilo del controlador.
+     *
+     * cancel() es cooperativo: se comprueba entre etapas y dentro de la
+     * preparación (isCancelled()).
+     */
+    class BsdlLoadTask {
+    public:
+        enum class Status {
+            PENDING,
+            RUNNING,
+            FINISHED,    // Modelo listo para adoptLoadedBSDL
+            FAILED,      // Ver getError()
+            CANCELLED
+        };
+
+        // Trabajo extra en el hilo del pool; devuelve false si se abandona (cancelación)
+        using Prepare = std::function<bool(const DeviceModel& model, BsdlLoadTask& task)>;
+        // Progreso 0..100 y etapa; se invoca desde el hilo del pool
+        using ProgressCallback = std::function<void(const BsdlLoadTask& task, int percent, const std::string& stage)>;
+
+        BsdlLoadTask(uint64_t id, std::filesystem::path path, Prepare prepare);
+
+        BsdlLoadTask(const BsdlLoadTask&) = delete;
+        BsdlLoadTask& operator=(const BsdlLoadTask&) = delete;
+
+        uint64_t getId() const { return id; }
+        const std::filesystem::path& getPath() const { return path; }
+
+        void cancel() { cancelled.store(true, std::memory_order_relaxed); }
+        bool isCancelled() const { return cancelled.load(std::memory_order_relaxed); }
+
+        Status getStatus() const { return status.load(std::memory_order_acquire); }
+        int getProgress() const { return progress.load(std::memory_order_relaxed); }
+        std::string getError() const;
+
+        // Hilo del pool: el paso de preparación puede informar de su propio avance
+        void reportProgress(int percent, const std::string& stage);
+
+    private:
+        friend class ScanController;
+
+        void setProgressCallback(ProgressCallback callback) { onProgress = std::move(callback); }
+        bool runPrepare(const DeviceModel& model) { return !prepare || prepare(model, *this); }
+        void finish(Status result, std::unique_ptr<DeviceModel> loaded = nullptr, std::string message = {});
+        std::unique_ptr<DeviceModel> takeModel();
+
+        const uint64_t id;
+        const std::filesystem::path path;
+        Prepare prepare;
+        ProgressCallback onProgress;
+
+        std::atomic<bool> cancelled{ false };
+        std::atomic<Status> status{ Status::PENDING };
+        std::atomic<int> progress{ 0 };
+
+        mutable std::mutex resultMutex;
+        std::unique_ptr<DeviceModel> model;
+        std::string error;
+    };
+
+} // namespace JTAG
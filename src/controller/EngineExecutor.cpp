@@ -0,0 +1,297 @@
+#include "EngineExecutor.h"
+#include <iostream>
+#include <map>
+
+namespace JTAG {
+
+    // ============================================================================
+    // CICLO DE VIDA
+    // ============================================================================
+
+    EngineExecutor::EngineExecutor(JtagSession& session)
+        : session(session)
+    {
+        thread = std::thread([this]() { loop(); });
+        threadId = thread.get_id();
+    }
+
+    EngineExecutor::~EngineExecutor() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quitting = true;
+            periodic.reset();
+        }
+        wake.notify_all();
+        thread.join();
+    }
+
+    // ============================================================================
+    // ENCOLADO
+    // ============================================================================
+
+    void EngineExecutor::enqueue(Command command) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!quitting) {
+                queue.push_back(std::move(command));
+                wake.notify_one();
+                return;
+            }
+        }
+        // Executor destruyéndose: el comando no se ejecuta
+        if (command.done) command.done(false);
+    }
+
+    void EngineExecutor::post(std::function<void(JtagSession&)> fn) {
+        Command command;
+        command.run = std::move(fn);
+        enqueue(std::move(command));
+    }
+
+    std::future<bool> EngineExecutor::writePins(std::vector<CellWrite> writes, bool apply) {
+        auto promise = std::make_shared<std::promise<bool>>();
+        auto future = promise->get_future();
+        writePins(std::move(writes), apply, [promise](bool ok) { promise->set_value(ok); });
+        return future;
+    }
+
+    void EngineExecutor::writePins(std::vector<CellWrite> writes, bool apply, Completion done) {
+        Command command;
+        command.kind = Kind::WRITE;
+        command.writes = std::move(writes);
+        command.apply = apply;
+        command.done = std::move(done);
+        enqueue(std::move(command));
+    }
+
+    std::future<bool> EngineExecutor::sample() {
+        auto promise = std::make_shared<std::promise<bool>>();
+        auto future = promise->get_future();
+        sample([promise](bool ok) { promise->set_value(ok); });
+        return future;
+    }
+
+    void EngineExecutor::sample(Completion done) {
+        Command command;
+        command.kind = Kind::SAMPLE;
+        command.done = std::move(done);
+        enqueue(std::move(command));
+    }
+
+    // ============================================================================
+    // TRABAJO PERIÓDICO
+    // ============================================================================
+
+    void EngineExecutor::startPeriodic(PeriodicJob job, SampleScheduler& scheduler) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            periodic = std::make_shared<Periodic>(Periodic{ std::move(job), &scheduler });
+        }
+        wake.notify_all();
+    }
+
+    void EngineExecutor::stopPeriodic() {
+        std::unique_lock<std::mutex> lock(mutex);
+        periodic.reset();
+        wake.notify_all();
+        // Desde el propio hilo (un comando o el ciclo) no se puede esperar al ciclo
+        if (isExecutorThread()) return;
+        // También la espera: waitNext sigue tocando el scheduler del trabajo retirado
+        cycleDone.wait(lock, [this]() { return !cycleRunning && !waiting; });
+    }
+
+    bool EngineExecutor::isPeriodicActive() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return periodic != nullptr;
+    }
+
+    EngineExecutor::Stats EngineExecutor::getStats() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stats;
+    }
+
+    // ============================================================================
+    // HILO DEL EXECUTOR
+    // ============================================================================
+
+    void EngineExecutor::loop() {
+        std::shared_ptr<Periodic> current;
+        bool cycleDue = false;
+
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            // 1. Comandos: siempre antes que el siguiente ciclo
+            if (!queue.empty()) {
+                std::deque<Command> batch;
+                batch.swap(queue);
+                stats.batches++;
+                lock.unlock();
+                runBatch(batch);
+                lock.lock();
+                continue;
+            }
+            if (quitting) break;
+
+            // Trabajo retirado o sustituido: el hilo vuelve a su planificación normal
+            // (SCHED_FIFO / afinidad del trabajo anterior no pasan a comandos ni a otro trabajo)
+            if (current && periodic != current) {
+                current.reset();
+                if (threadTuned) {
+                    threadTuned = false;
+                    lock.unlock();
+                    SampleScheduler::restoreDefaultThreadOptions();
+                    lock.lock();
+                    continue;
+                }
+            }
+
+            if (!periodic) {
+                wake.wait(lock, [this]() { return !queue.empty() || quitting || periodic; });
+                continue;
+            }
+
+            // 2. Ciclo periódico (inmediato si el trabajo es nuevo)
+            if (periodic != current) {
+                current = periodic;
+                cycleDue = true;
+            }
+            if (cycleDue) {
+                cycleRunning = true;
+                lock.unlock();
+                const bool keep = runCycle(*current);
+                threadTuned = threadTuned || current->scheduler->hasThreadOptionsActive();
+                lock.lock();
+                cycleRunning = false;
+                cycleDue = false;
+                if (!keep && periodic == current) periodic.reset();
+                cycleDone.notify_all();
+                continue;
+            }
+
+            // 3. Espera al deadline; un comando nuevo (o un cambio de trabajo) la interrumpe
+            waiting = true;
+            lock.unlock();
+            cycleDue = current->scheduler->waitNext([this, &current](SampleScheduler::Clock::time_point wakeAt) {
+                std::unique_lock<std::mutex> sleepLock(mutex);
+                return !wake.wait_until(sleepLock, wakeAt, [this, &current]() {
+                    return !queue.empty() || quitting || periodic != current;
+                });
+            });
+            lock.lock();
+            waiting = false;
+            cycleDone.notify_all();
+        }
+    }
+
+    bool EngineExecutor::runCycle(const Periodic& job) {
+        try {
+            return job.job();
+        }
+        catch (const std::exception& e) {
+            std::cerr << "[EngineExecutor] Periodic job failed: " << e.what() << "\n";
+            return true;
+        }
+    }
+
+    void EngineExecutor::runBatch(std::deque<Command>& batch) {
+        while (!batch.empty()) {
+            switch (batch.front().kind) {
+            case Kind::WRITE:
+                runWrites(batch);
+                break;
+            case Kind::SAMPLE:
+                runSamples(batch);
+                break;
+            case Kind::BARRIER: {
+                Command command = std::move(batch.front());
+                batch.pop_front();
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    stats.commands++;
+                }
+                try {
+                    command.run(session);
+                }
+                catch (const std::exception& e) {
+                    std::cerr << "[EngineExecutor] Command failed: " << e.what() << "\n";
+                }
+                break;
+            }
+            }
+        }
+    }
+
+    void EngineExecutor::runWrites(std::deque<Command>& batch) {
+        // Grupo: escrituras consecutivas. Tras la primera que aplica solo entran otras
+        // que también aplican y no cambian ninguna celda ya escrita en el grupo
+        std::vector<Command> group;
+        std::map<size_t, PinLevel> written;
+        bool applied = false;
+        while (!batch.empty() && batch.front().kind == Kind::WRITE) {
+            const Command& next = batch.front();
+            if (applied) {
+                if (!next.apply) break;
+                bool conflict = false;
+                for (const auto& write : next.writes) {
+                    auto it = written.find(write.cell);
+                    if (it != written.end() && it->second != write.level) {
+                        conflict = true;
+                        break;
+                    }
+                }
+                if (conflict) break;
+            }
+            for (const auto& write : next.writes) written[write.cell] = write.level;
+            applied |= next.apply;
+            group.push_back(std::move(batch.front()));
+            batch.pop_front();
+        }
+
+        BoundaryScanEngine* engine = session.getEngine();
+        std::vector<bool> writesOk(group.size(), engine != nullptr);
+        for (size_t i = 0; i < group.size() && engine; ++i) {
+            for (const auto& write : group[i].writes) {
+                if (!engine->setPin(write.cell, write.level)) writesOk[i] = false;
+            }
+        }
+
+        // Un único Update-DR para todas las que lo pedían
+        size_t applyCount = 0;
+        for (const auto& command : group) applyCount += command.apply ? 1 : 0;
+        const bool scanOk = applyCount > 0 && session.applyChanges();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stats.commands += group.size();
+            if (applyCount > 0) {
+                stats.scans++;
+                stats.mergedScans += applyCount - 1;
+            }
+        }
+        for (size_t i = 0; i < group.size(); ++i) {
+            if (group[i].done) group[i].done(writesOk[i] && (!group[i].apply || scanOk));
+        }
+    }
+
+    void EngineExecutor::runSamples(std::deque<Command>& batch) {
+        // Todas las capturas pendientes consecutivas comparten un scan
+        std::vector<Command> group;
+        while (!batch.empty() && batch.front().kind == Kind::SAMPLE) {
+            group.push_back(std::move(batch.front()));
+            batch.pop_front();
+        }
+
+        const bool ok = session.samplePins();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stats.commands += group.size();
+            stats.scans++;
+            stats.mergedScans += group.size() - 1;
+        }
+        for (auto& command : group) {
+            if (command.done) command.done(ok);
+        }
+    }
+
+} // namespace JTAG
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "JtagSession.h"
+#include "SampleScheduler.h"
+
+namespace JTAG {
+
+    /**
+     * @brief Hilo único propietario del adaptador y el engine de una JtagSession
+     *
+     * Cualquier hilo encola comandos (cola multi-productor) y recibe el resultado
+     * con un future o un callback. Solo el hilo del executor toca la sonda y el
+     * BSR: GUI, servidor RPC y polling ya no usan el engine a la vez.
+     *
+     * Al vaciar la cola se fusionan los comandos compatibles consecutivos:
+     * - writePins: las escrituras se aplican en orden y todas las que piden
+     *   Update-DR comparten un único scanDR, salvo que una cambie una celda ya
+     *   escrita en el grupo (ese estado intermedio tiene que llegar al pin).
+     * - sample: las capturas pendientes comparten un único scan.
+     * submit/call/post son barreras: se ejecutan solas y en orden de llegada.
+     *
+     * El trabajo periódico (ciclo de polling de ScanWorker) corre en el mismo
+     * hilo entre lotes; un comando nuevo interrumpe la espera hasta su deadline.
+     * Si el trabajo aplicó SCHED_FIFO o afinidad, el hilo vuelve a la
+     * planificación normal al retirarlo.
+     */
+    class EngineExecutor {
+    public:
+        struct CellWrite {
+            size_t cell;
+            PinLevel level;
+        };
+        using Completion = std::function<void(bool ok)>;
+        using PeriodicJob = std::function<bool()>;      // Un ciclo; false = retirarse (single-shot)
+
+        struct Stats {
+            uint64_t commands = 0;      // Comandos ejecutados
+            uint64_t batches = 0;       // Lotes sacados de la cola
+            uint64_t scans = 0;         // scanDR de writePins/sample
+            uint64_t mergedScans = 0;   // scanDR ahorrados por fusión
+        };
+
+        explicit EngineExecutor(JtagSession& session);   // Arranca el hilo
+        ~EngineExecutor();                               // Ejecuta lo pendiente y termina
+
+        EngineExecutor(const EngineExecutor&) = delete;
+        EngineExecutor& operator=(const EngineExecutor&) = delete;
+
+        bool isExecutorThread() const { return std::this_thread::get_id() == threadId; }
+
+        // ---------- Barreras ----------
+        template <typename F>
+        auto submit(F&& fn) -> std::future<std::invoke_result_t<F&, JtagSession&>>;
+        // Síncrono; desde el propio hilo del executor se ejecuta directamente
+        template <typename F>
+        auto call(F&& fn) -> std::invoke_result_t<F&, JtagSession&>;
+        void post(std::function<void(JtagSession&)> fn);   // Sin resultado (excepciones al log)
+
+        // ---------- Fusionables ----------
+        std::future<bool> writePins(std::vector<CellWrite> writes, bool apply);
+        void writePins(std::vector<CellWrite> writes, bool apply, Completion done);
+        std::future<bool> sample();
+        void sample(Completion done);
+
+        // ---------- Trabajo periódico ----------
+        // Sustituye al anterior; el primer ciclo es inmediato y los siguientes siguen
+        // los deadlines de 'scheduler' (debe vivir mientras esté instalado)
+        void startPeriodic(PeriodicJob job, SampleScheduler& scheduler);
+        void stopPeriodic();        // Al volver el hilo ya no usa el trabajo ni su scheduler
+        bool isPeriodicActive() const;
+
+        Stats getStats() const;
+
+    private:
+        enum class Kind { BARRIER, WRITE, SAMPLE };
+
+        struct Command {
+            Kind kind = Kind::BARRIER;
+            std::function<void(JtagSession&)> run;  // BARRIER
+            std::vector<CellWrite> writes;          // WRITE
+            bool apply = false;
+            Completion done;                        // WRITE / SAMPLE
+        };
+
+        struct Periodic {
+            PeriodicJob job;
+            SampleScheduler* scheduler;
+        };
+
+        void enqueue(Command command);
+        void loop();
+        void runBatch(std::deque<Command>& batch);
+        void runWrites(std::deque<Command>& batch);
+        void runSamples(std::deque<Command>& batch);
+        bool runCycle(const Periodic& periodic);
+
+        JtagSession& session;
+
+        mutable std::mutex mutex;
+        std::condition_variable wake;       // Cola, trabajo periódico o salida
+        std::condition_variable cycleDone;  // stopPeriodic espera al ciclo o la espera en curso
+        std::deque<Command> queue;
+        std::shared_ptr<Periodic> periodic;
+        bool cycleRunning = false;
+        bool waiting = false;               // Dentro de scheduler->waitNext()
+        bool threadTuned = false;           // Solo el hilo: un trabajo aplicó tiempo real/afinidad
+        bool quitting = false;
+        Stats stats;
+
+        std::thread thread;
+        std::thread::id threadId;
+    };
+
+    template <typename F>
+    auto EngineExecutor::submit(F&& fn) -> std::future<std::invoke_result_t<F&, JtagSession&>> {
+        using Result = std::invoke_result_t<F&, JtagSession&>;
+        // packaged_task: las excepciones llegan al future; si se descarta, broken_promise
+        auto task = std::make_shared<std::packaged_task<Result(JtagSession&)>>(std::forward<F>(fn));
+        auto future = task->get_future();
+
+        Command command;
+        command.run = [task](JtagSession& session) { (*task)(session); };
+        enqueue(std::move(command));
+        return future;
+    }
+
+    template <typename F>
+    auto EngineExecutor::call(F&& fn) -> std::invoke_result_t<F&, JtagSession&> {
+        if (isExecutorThread()) return fn(session);
+        return submit(std::forward<F>(fn)).get();
+    }
+
+} // namespace JTAG
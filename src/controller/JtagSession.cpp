@@ -0,0 +1,521 @@
+#include "JtagSession.h"
+#include "../parser/BSDLParser.h"
+#include "../bsdl/PinDecoder.h"
+#include "../hal/factory/AdapterFactory.h"
+#include "../hal/drivers/ReplayAdapter.h"
+#include "../vector/VectorCompiler.h"
+#include "../vector/VectorExecutor.h"
+#include "../core/MappedFile.h"
+#include "../core/MonotonicClock.h"
+#include <iostream>
+#include <iomanip>
+
+namespace JTAG {
+
+    // ============================================================================
+    // CONSTRUCTOR / DESTRUCTOR
+    // ============================================================================
+
+    JtagSession::JtagSession() = default;
+
+    JtagSession::~JtagSession() {
+        disconnectAdapter();
+    }
+
+    bool JtagSession::fail(const std::string& message) {
+        lastError = message;
+        std::cerr << "[JtagSession] ERROR: " << message << "\n";
+        return false;
+    }
+
+    // ============================================================================
+    // GESTIÓN DE ADAPTADOR
+    // ============================================================================
+
+    bool JtagSession::connectAdapter(AdapterType type, uint32_t clockSpeed) {
+        AdapterDescriptor descriptor;
+        descriptor.type = type;
+        return connectAdapter(descriptor, clockSpeed);
+    }
+
+    bool JtagSession::connectAdapter(const AdapterDescriptor& descriptor, uint32_t clockSpeed) {
+        std::cout << "[JtagSession] connectAdapter: type=" << static_cast<int>(descriptor.type)
+                  << " clockSpeed=" << clockSpeed << "\n";
+
+        if (adapter) disconnectAdapter();
+
+        try {
+            // deviceID vacío = primera sonda de ese tipo
+            auto created = descriptor.deviceID.empty()
+                ? AdapterFactory::create(descriptor.type)
+                : AdapterFactory::create(descriptor.type, descriptor.deviceID);
+            if (!created) return fail("Failed to create adapter");
+
+            // Decorador de grabación siempre instalado (inactivo hasta startRecording)
+            auto recording = std::make_unique<RecordingAdapter>(std::move(created));
+            recorder = recording.get();
+            adapter = std::move(recording);
+
+            if (!adapter->open()) {
+                adapter.reset();
+                recorder = nullptr;
+                return fail("Failed to open adapter");
+            }
+
+            adapter->setClockSpeed(clockSpeed);
+            initialized = false;
+            detectedIDCODE = 0;
+
+            // MockAdapter: auto-generar DeviceModel
+            if (descriptor.type == AdapterType::MOCK) {
+                createMockDeviceModel();
+                std::cout << "[JtagSession] MockAdapter connected - auto-generated DeviceModel\n";
+            }
+
+            // Replay de una sesión grabada con MockAdapter: mismo modelo simulado
+            if (descriptor.type == AdapterType::REPLAY) {
+                auto* replay = static_cast<ReplayAdapter*>(recorder->getInner());
+                if (replay->getRecordedAdapterName() == "Mock JTAG Simulator") {
+                    createMockDeviceModel();
+                }
+            }
+
+            std::cout << "[JtagSession] Connected to: " << adapter->getInfo() << "\n";
+            return true;
+        }
+        catch (const std::exception& e) {
+            adapter.reset();
+            recorder = nullptr;
+            return fail(std::string("Exception connecting adapter: ") + e.what());
+        }
+        catch (...) {
+            adapter.reset();
+            recorder = nullptr;
+            return fail("Unknown exception connecting adapter");
+        }
+    }
+
+    void JtagSession::disconnectAdapter() {
+        if (adapter) {
+            adapter->close();
+            adapter.reset();
+        }
+        recorder = nullptr;
+        engine.reset();
+        deviceModel.reset();
+        initialized = false;
+        detectedIDCODE = 0;
+    }
+
+    bool JtagSession::isConnected() const {
+        return adapter && adapter->isConnected();
+    }
+
+    std::string JtagSession::getAdapterInfo() const {
+        return adapter ? adapter->getInfo() : "";
+    }
+
+    // ============================================================================
+    // DISPOSITIVO
+    // ============================================================================
+
+    uint32_t JtagSession::detectDevice() {
+        std::cout << "[JtagSession] detectDevice: Reading IDCODE...\n";
+
+        if (!adapter) {
+            fail("No adapter connected");
+            return 0;
+        }
+
+        // Engine temporal solo para IDCODE
+        auto tempEngine = std::make_unique<BoundaryScanEngine>(adapter.get(), 0);
+        detectedIDCODE = tempEngine->readIDCODE();
+
+        std::cout << "[JtagSession] IDCODE read: 0x" << std::hex << std::setw(8) << std::setfill('0')
+                  << detectedIDCODE << std::dec << std::setfill(' ') << "\n";
+
+        if (detectedIDCODE == 0 || detectedIDCODE == 0xFFFFFFFF) {
+            fail("Invalid IDCODE (0x00000000 or 0xFFFFFFFF)");
+            detectedIDCODE = 0;
+            return 0;
+        }
+        return detectedIDCODE;
+    }
+
+    bool JtagSession::loadBSDL(const std::filesystem::path& bsdlPath) {
+        std::cout << "[JtagSession] loadBSDL: Loading file: " << bsdlPath.string() << "\n";
+
+        auto model = loadModel(bsdlPath);
+        if (!model) return fail("Failed to parse BSDL file: " + bsdlPath.string());
+
+        installDeviceModel(std::move(model));
+        return true;
+    }
+
+    std::unique_ptr<DeviceModel> JtagSession::loadModel(const std::filesystem::path& bsdlPath) {
+        // Modelo compilado si el contenido no ha cambiado; si no, parseo completo.
+        // El lock cubre solo la consulta y la escritura de la caché: dos hilos
+        // pueden parsear BSDL distintos a la vez
+        MappedFile source;
+        if (!source.open(bsdlPath)) {
+            std::cerr << "[JtagSession] Cannot read BSDL file: " << bsdlPath.string() << "\n";
+            return nullptr;
+        }
+        const uint64_t sourceHash = fnv1a64(source.data(), source.size());
+        {
+            std::lock_guard<std::mutex> lock(modelCacheMutex);
+            if (auto model = modelCache.lookup(sourceHash, source.size())) return model;
+        }
+
+        const uint64_t start = monotonicNowNs();
+        auto model = ModelCache::parse(source.data(), source.size());
+        std::cout << "[JtagSession] Parsed " << bsdlPath.filename().string() << " in "
+                  << (monotonicNowNs() - start) / 1000 << " us\n";
+
+        std::lock_guard<std::mutex> lock(modelCacheMutex);
+        modelCache.insert(*model, sourceHash, source.size());
+        return model;
+    }
+
+    void JtagSession::installDeviceModel(std::unique_ptr<DeviceModel> model) {
+        deviceModel = std::move(model);
+        modelGeneration++;
+        initialized = false;
+
+        std::cout << "[JtagSession] Device: " << deviceModel->getDeviceName()
+                  << " BSR Length: " << deviceModel->getBSRLength() << " bits\n";
+
+        // Recrear engine con tamaño BSR correcto
+        if (adapter) {
+            engine = std::make_unique<BoundaryScanEngine>(adapter.get(), deviceModel->getBSRLength());
+        }
+    }
+
+    void JtagSession::unloadBSDL() {
+        // Mantener SOLO el adaptador (sonda) conectado
+        engine.reset();
+        deviceModel.reset();
+        initialized = false;
+        detectedIDCODE = 0;
+        std::cout << "[JtagSession] BSDL unloaded - adapter still connected\n";
+    }
+
+    void JtagSession::setModelCacheDirectory(const std::filesystem::path& dir) {
+        std::lock_guard<std::mutex> lock(modelCacheMutex);
+        modelCache.setDirectory(dir);
+    }
+
+    ModelCache::Stats JtagSession::getModelCacheStats() const {
+        std::lock_guard<std::mutex> lock(modelCacheMutex);
+        return modelCache.getStats();
+    }
+
+    // ============================================================================
+    // SECUENCIAS DE INSTRUCCIÓN
+    // ============================================================================
+
+    bool JtagSession::initialize() {
+        std::cout << "[JtagSession] initialize: Starting device initialization...\n";
+        initialized = false;
+
+        if (!adapter || !deviceModel || !engine) {
+            return fail(std::string("Missing components - adapter:") + (adapter ? "OK" : "NULL")
+                        + " deviceModel:" + (deviceModel ? "OK" : "NULL")
+                        + " engine:" + (engine ? "OK" : "NULL"));
+        }
+
+        // Reset TAP a estado conocido
+        if (!engine->reset()) return fail("Failed to reset TAP");
+
+        // ========== SECUENCIA IEEE 1149.1 (Solución A) ==========
+
+        // Paso 1: Cargar instrucción SAMPLE/PRELOAD
+        uint32_t sampleInstr = deviceModel->getInstruction("SAMPLE/PRELOAD");
+        if (sampleInstr == 0xFFFFFFFF) {
+            // Fallback si no existe SAMPLE/PRELOAD
+            sampleInstr = deviceModel->getInstruction("SAMPLE");
+        }
+
+        std::cout << "[JtagSession] SAMPLE instruction opcode: 0x" << std::hex << sampleInstr << std::dec << "\n";
+
+        if (!engine->loadInstruction(sampleInstr, deviceModel->getIRLength())) {
+            return fail("Failed to load SAMPLE instruction");
+        }
+
+        // Paso 2: Sample para capturar estado actual seguro
+        if (!engine->samplePins()) return fail("Failed to sample pins");
+
+        // Paso 3: Precargar esos valores en el registro de actualización
+        // (sin cambiar pines físicos, porque estamos en SAMPLE/PRELOAD)
+        if (!engine->preloadBSR()) return fail("Failed to preload BSR");
+
+        // Paso 4: Cargar instrucción EXTEST
+        // Los pines tomarán los valores precargados de forma segura
+        uint32_t extestInstr = deviceModel->getInstruction("EXTEST");
+        if (!engine->loadInstruction(extestInstr, deviceModel->getIRLength())) {
+            return fail("Failed to load EXTEST instruction");
+        }
+
+        // ========== FIN SECUENCIA IEEE 1149.1 ==========
+
+        initialized = true;
+        return true;
+    }
+
+    bool JtagSession::reset() {
+        if (!engine) return false;
+        initialized = false;
+        return engine->reset();
+    }
+
+    bool JtagSession::enterSAMPLE() {
+        if (!engine || !deviceModel) return fail("No device loaded");
+
+        // SAMPLE/PRELOAD suele ser la instrucción segura por defecto
+        uint32_t opcode = deviceModel->getInstruction("SAMPLE");
+        if (opcode == 0xFFFFFFFF) opcode = deviceModel->getInstruction("SAMPLE/PRELOAD");
+
+        if (!engine->loadInstruction(opcode, deviceModel->getIRLength())) {
+            return fail("Failed to load SAMPLE instruction");
+        }
+
+        // Setear modo antes de samplePins
+        engine->setOperationMode(BoundaryScanEngine::OperationMode::SAMPLE);
+
+        // Ejecutar un ciclo de sampleo inicial
+        return engine->samplePins() || fail("Failed to sample pins");
+    }
+
+    bool JtagSession::enterEXTEST() {
+        if (!engine || !deviceModel) return fail("No device loaded");
+
+        // ========== SECUENCIA IEEE 1149.1 (Solución A) ==========
+
+        // Paso 1: Cargar SAMPLE/PRELOAD
+        uint32_t sampleInstr = deviceModel->getInstruction("SAMPLE/PRELOAD");
+        if (sampleInstr == 0xFFFFFFFF) {
+            sampleInstr = deviceModel->getInstruction("SAMPLE");
+        }
+
+        if (!engine->loadInstruction(sampleInstr, deviceModel->getIRLength())) {
+            return fail("Failed to load SAMPLE for EXTEST sequence");
+        }
+
+        // Paso 2: Sample para capturar estado actual
+        if (!engine->samplePins()) return fail("Failed to sample pins for EXTEST sequence");
+
+        // Paso 3: Precargar valores seguros
+        if (!engine->preloadBSR()) return fail("Failed to preload BSR for EXTEST sequence");
+
+        // Paso 4: Cargar EXTEST (sin scanDR después)
+        uint32_t extestInstr = deviceModel->getInstruction("EXTEST");
+        if (!engine->loadInstruction(extestInstr, deviceModel->getIRLength())) {
+            return fail("Failed to load EXTEST instruction");
+        }
+
+        // ========== FIN SECUENCIA IEEE 1149.1 ==========
+
+        // Setear modo al final
+        engine->setOperationMode(BoundaryScanEngine::OperationMode::EXTEST);
+        return true;
+    }
+
+    bool JtagSession::enterBYPASS() {
+        if (!engine || !deviceModel) return fail("No device loaded");
+        engine->setOperationMode(BoundaryScanEngine::OperationMode::BYPASS);
+        uint32_t opcode = deviceModel->getInstruction("BYPASS");
+        return engine->loadInstruction(opcode, deviceModel->getIRLength())
+            || fail("Failed to load BYPASS instruction");
+    }
+
+    bool JtagSession::enterINTEST() {
+        if (!engine || !deviceModel) return fail("No device loaded");
+
+        // Secuencia segura IEEE 1149.1 (igual que EXTEST)
+        // INTEST prueba la lógica interna del chip, no los pines externos
+
+        // Paso 1: Cargar SAMPLE/PRELOAD
+        uint32_t sampleInstr = deviceModel->getInstruction("SAMPLE/PRELOAD");
+        if (sampleInstr == 0xFFFFFFFF) {
+            sampleInstr = deviceModel->getInstruction("SAMPLE");
+        }
+
+        if (!engine->loadInstruction(sampleInstr, deviceModel->getIRLength())) {
+            return fail("Failed to load SAMPLE for INTEST sequence");
+        }
+
+        // Paso 2: Capturar estado actual
+        if (!engine->samplePins()) return fail("Failed to sample pins for INTEST sequence");
+
+        // Paso 3: Precargar valores seguros en el update latch
+        if (!engine->preloadBSR()) return fail("Failed to preload BSR for INTEST sequence");
+
+        // Paso 4: Cargar instrucción INTEST
+        uint32_t intestInstr = deviceModel->getInstruction("INTEST");
+        if (intestInstr == 0xFFFFFFFF) return fail("INTEST instruction not found in BSDL");
+
+        if (!engine->loadInstruction(intestInstr, deviceModel->getIRLength())) {
+            return fail("Failed to load INTEST instruction");
+        }
+
+        // Setear modo al final
+        engine->setOperationMode(BoundaryScanEngine::OperationMode::INTEST);
+
+        std::cout << "[JtagSession] Successfully entered INTEST mode\n";
+        return true;
+    }
+
+    // ============================================================================
+    // CONTROL DE PINES
+    // ============================================================================
+
+    bool JtagSession::setPin(const std::string& pinName, PinLevel level) {
+        if (!deviceModel || !engine) return fail("No device loaded");
+
+        auto pinInfo = deviceModel->getPinInfo(pinName);
+        if (!pinInfo) return fail("Pin not found: " + pinName);
+
+        // PROTECCIÓN: Si outputCell es negativo, NO INTENTAR ESCRIBIR
+        if (pinInfo->outputCell < 0) return fail("Pin has no output cell: " + pinName);
+
+        return engine->setPin(pinInfo->outputCell, level);
+    }
+
+    std::optional<PinLevel> JtagSession::getPin(const std::string& pinName) const {
+        if (!deviceModel || !engine) {
+            return std::nullopt;
+        }
+
+        const int32_t pin = deviceModel->findPin(pinName);
+        const PinDecodePlan& plan = deviceModel->getDecodePlan();
+        if (pin < 0 || engine->getBSRLength() != plan.bsrLength) {
+            return std::nullopt;
+        }
+
+        // Mismo plan que las instantáneas del worker:
+        // 1. Si tiene celda INPUT, nivel del buffer CAPTURADO (TDO)
+        // 2. Si solo tiene celda OUTPUT, valor del buffer DESEADO (TDI), o Z si su
+        //    celda de control la deshabilita (lo que estamos enviando al pin)
+        PinState state = PinDecoder::decodePin(plan, static_cast<size_t>(pin),
+                                               engine->getBSRCapture().data(), engine->getBSR().data());
+        return toPinLevel(state);
+    }
+
+    bool JtagSession::applyChanges() {
+        return (engine && initialized) ? engine->applyChanges() : false;
+    }
+
+    bool JtagSession::samplePins() {
+        return (engine && initialized) ? engine->samplePins() : false;
+    }
+
+    bool JtagSession::runTest(size_t numCycles) {
+        return engine ? engine->runTestCycles(numCycles) : false;
+    }
+
+    // ============================================================================
+    // VECTORES Y GRABACIÓN
+    // ============================================================================
+
+    bool JtagSession::compileSVF(const std::filesystem::path& svfPath, const std::filesystem::path& jvecPath) {
+        VectorCompiler::Options options;
+        if (deviceModel) {
+            // Describir la cadena actual en la cabecera (informativo para el ejecutor)
+            options.chain.push_back({ deviceModel->getIDCODE(), deviceModel->getIRLength(),
+                                      deviceModel->getDeviceName() });
+        }
+
+        VectorCompiler compiler(options);
+        if (!compiler.compileSVF(svfPath)) {
+            return fail("SVF compile failed: " + compiler.getLastError());
+        }
+        return compiler.write(jvecPath) || fail("Cannot write " + jvecPath.string());
+    }
+
+    bool JtagSession::runVectorFile(const std::filesystem::path& jvecPath, uint32_t* failedLine) {
+        if (failedLine) *failedLine = 0;
+        if (!adapter) return fail("No adapter connected");
+
+        VectorExecutor executor(adapter.get());
+        if (!executor.open(jvecPath)) {
+            return fail("Cannot open vector file: " + jvecPath.string());
+        }
+
+        auto result = executor.run();
+        if (!result.ok) {
+            if (failedLine) *failedLine = result.sourceLine;
+            return fail("Vector file failed at SVF line " + std::to_string(result.sourceLine)
+                        + ": " + result.error);
+        }
+        return true;
+    }
+
+    bool JtagSession::startRecording(const std::filesystem::path& tracePath) {
+        if (!recorder) return fail("No adapter connected");
+        return recorder->startRecording(tracePath) || fail("Cannot start recording: " + tracePath.string());
+    }
+
+    void JtagSession::stopRecording() {
+        if (recorder) recorder->stopRecording();
+    }
+
+    bool JtagSession::isRecording() const {
+        return recorder && recorder->isRecording();
+    }
+
+    // ============================================================================
+    // MODELO SIMULADO
+    // ============================================================================
+
+    void JtagSession::createMockDeviceModel() {
+        // Crear BSDL data simulado para MockAdapter
+        BSDLData mockData;
+        mockData.entityName = "MOCK_DEVICE";
+        mockData.idCode = 0x12345678;
+        mockData.boundaryLength = 256;  // 256 bits de BSR
+        mockData.instructionLength = 8;
+        mockData.physicalPinMap = "BGA";
+
+        // Agregar instrucciones básicas
+        Instruction sampInstr;
+        sampInstr.name = "SAMPLE";
+        sampInstr.opcodes.push_back("00000001");
+        mockData.instructions.push_back(sampInstr);
+
+        Instruction extestInstr;
+        extestInstr.name = "EXTEST";
+        extestInstr.opcodes.push_back("00000000");
+        mockData.instructions.push_back(extestInstr);
+
+        // Crear 32 pines simulados (8 bits por pin = 256 bits totales)
+        for (int i = 0; i < 32; i++) {
+            // Celda INPUT para cada pin
+            BoundaryCell inputCell;
+            inputCell.cellNumber = i * 8;
+            inputCell.portName = "MOCK_PIN_" + std::to_string(i);
+            inputCell.function = CellFunction::INPUT;
+            inputCell.safeValue = SafeBit::DONT_CARE;
+            inputCell.controlCell = -1;
+            inputCell.disableValue = SafeBit::DONT_CARE;
+            mockData.boundaryCells.push_back(inputCell);
+
+            // Agregar pin mapping (nombre de pin → número físico)
+            mockData.pinMaps["MOCK_PIN_" + std::to_string(i)].push_back(std::to_string(i + 1));
+        }
+
+        // Crear DeviceModel y cargar datos simulados
+        deviceModel = std::make_unique<DeviceModel>();
+        deviceModel->loadFromData(mockData);
+        modelGeneration++;
+
+        // Configurar IDCODE detectado
+        detectedIDCODE = 0x12345678;
+
+        // Engine acorde al modelo: la sesión queda lista para initialize() sin BSDL
+        engine = std::make_unique<BoundaryScanEngine>(adapter.get(), deviceModel->getBSRLength());
+
+        std::cout << "[JtagSession] Created mock DeviceModel with "
+                  << deviceModel->getAllPins().size() << " pins\n";
+    }
+
+} // namespace JTAG
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "../core/BoundaryScanEngine.h"
+#include "../bsdl/DeviceModel.h"
+#include "../bsdl/ModelCache.h"
+#include "../bsdl/PinDecoder.h"
+#include "../hal/IJTAGAdapter.h"
+#include "../hal/drivers/RecordingAdapter.h"
+
+namespace JTAG {
+
+    // Estado decodificado → nivel para mostrar: entrada leída, salida conducida,
+    // Z si la salida está deshabilitada; nullopt sin celdas (LINKAGE) o sin datos
+    inline std::optional<PinLevel> toPinLevel(PinState state) {
+        if (state.isRead() || state.isDriven()) return state.value() ? PinLevel::HIGH : PinLevel::LOW;
+        if (state.isTristated()) return PinLevel::HIGH_Z;
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Sesión boundary scan síncrona y sin Qt: sonda + modelo + engine
+     *
+     * Contiene la parte del controlador que no necesita hilos ni señales:
+     * conexión del adaptador (siempre envuelto en RecordingAdapter), IDCODE,
+     * carga del BSDL con caché de modelos, secuencias de instrucción IEEE
+     * 1149.1, acceso a pines por nombre, vectores y grabación de sesión.
+     *
+     * No es thread-safe: ScanController la usa solo desde el hilo de su
+     * EngineExecutor; la CLI (jtag_cli) la usa directamente.
+     */
+    class JtagSession {
+    public:
+        JtagSession();
+        ~JtagSession();
+
+        JtagSession(const JtagSession&) = delete;
+        JtagSession& operator=(const JtagSession&) = delete;
+
+        // ========== ADAPTADOR ==========
+        bool connectAdapter(AdapterType type, uint32_t clockSpeed = 1000000);
+        bool connectAdapter(const AdapterDescriptor& descriptor, uint32_t clockSpeed);
+        void disconnectAdapter();   // Libera también engine y modelo
+        bool isConnected() const;
+        std::string getAdapterInfo() const;
+        IJTAGAdapter* getAdapter() const { return adapter.get(); }
+
+        // ========== DISPOSITIVO ==========
+        uint32_t detectDevice();    // 0 si no hay IDCODE válido
+        uint32_t getIDCODE() const { return detectedIDCODE; }
+
+        bool loadBSDL(const std::filesystem::path& bsdlPath);
+        // Solo construye el modelo (caché .jbmc o parseo); seguro desde otros hilos
+        std::unique_ptr<DeviceModel> loadModel(const std::filesystem::path& bsdlPath);
+        // Sustituye modelo y engine (el llamante garantiza que nadie los está usando)
+        void installDeviceModel(std::unique_ptr<DeviceModel> model);
+        void unloadBSDL();          // Mantiene el adaptador conectado
+
+        // Directorio de modelos compilados (.jbmc); vacío = parsear siempre
+        void setModelCacheDirectory(const std::filesystem::path& dir);
+        ModelCache::Stats getModelCacheStats() const;
+
+        const DeviceModel* getDeviceModel() const { return deviceModel.get(); }
+        // Cambia con cada modelo instalado (un modelo nuevo puede reutilizar la dirección del anterior)
+        uint64_t getModelGeneration() const { return modelGeneration; }
+        BoundaryScanEngine* getEngine() const { return engine.get(); }
+
+        // ========== SECUENCIAS DE INSTRUCCIÓN ==========
+        // SAMPLE/PRELOAD → sample → preload → EXTEST (estado seguro antes de conducir)
+        bool initialize();
+        bool isInitialized() const { return initialized; }
+        bool reset();               // TAP a Test-Logic-Reset; hay que volver a inicializar
+
+        bool enterSAMPLE();         // Carga SAMPLE y hace una captura (requiere initialize())
+        bool enterEXTEST();
+        bool enterBYPASS();
+        bool enterINTEST();
+
+        // ========== PINES ==========
+        bool setPin(const std::string& pinName, PinLevel level);   // Solo el buffer; applyChanges() lo envía
+        std::optional<PinLevel> getPin(const std::string& pinName) const;
+        bool applyChanges();
+        bool samplePins();
+        bool runTest(size_t numCycles);
+
+        // ========== VECTORES Y GRABACIÓN ==========
+        // SVF → .jvec; la cabecera describe el dispositivo cargado si lo hay
+        bool compileSVF(const std::filesystem::path& svfPath, const std::filesystem::path& jvecPath);
+        // Toma el TAP en exclusiva; tras ejecutarlo la instrucción cargada es desconocida.
+        // failedLine: línea SVF del primer fallo (0 si no aplica)
+        bool runVectorFile(const std::filesystem::path& jvecPath, uint32_t* failedLine = nullptr);
+
+        bool startRecording(const std::filesystem::path& tracePath);
+        void stopRecording();
+        bool isRecording() const;
+
+        const std::string& getLastError() const { return lastError; }
+
+    private:
+        void createMockDeviceModel();   // Auto-genera modelo para MockAdapter
+        bool fail(const std::string& message);
+
+        std::unique_ptr<IJTAGAdapter> adapter;
+        RecordingAdapter* recorder = nullptr;  // Decorador instalado sobre 'adapter' (no propietario)
+        std::unique_ptr<BoundaryScanEngine> engine;
+        std::unique_ptr<DeviceModel> deviceModel;
+
+        ModelCache modelCache;
+        mutable std::mutex modelCacheMutex;    // Solo lookup/insert: el parseo de loadModel va sin lock
+
+        uint64_t modelGeneration = 0;
+        uint32_t detectedIDCODE = 0;
+        bool initialized = false;
+        std::string lastError;
+    };
+
+} // namespace JTAG
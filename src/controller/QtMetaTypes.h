@@ -0,0 +1,15 @@
+#pragma once
+
+// ============================================================================
+// METATIPOS Qt DE LOS TIPOS DEL NÚCLEO
+// ============================================================================
+// El núcleo (parser, modelo, engine, HAL) no depende de Qt: las declaraciones
+// para QVariant y señales entre hilos viven aquí, en la capa Qt.
+
+#include <QMetaType>
+
+#include "../core/BoundaryScanEngine.h"
+#include "../hal/IJTAGAdapter.h"
+
+Q_DECLARE_METATYPE(JTAG::PinLevel)
+Q_DECLARE_METATYPE(JTAG::AdapterDescriptor)
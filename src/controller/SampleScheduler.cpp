@@ -0,0 +1,275 @@
+#include "SampleScheduler.h"
+#include "../core/Instrumentation.h"
+#include <iostream>
+#include <thread>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <cerrno>
+#endif
+
+namespace JTAG {
+
+    namespace {
+
+#if !defined(_WIN32)
+        // Planificación y afinidad que tenía el hilo antes del primer
+        // applyThreadOptions(): es lo que se restaura (el proceso puede estar
+        // limitado con taskset/cgroups a un subconjunto de CPUs)
+        struct OriginalThreadState {
+            bool saved = false;
+            int policy = SCHED_OTHER;
+            sched_param param{};
+#if defined(__linux__)
+            bool maskSaved = false;
+            cpu_set_t mask;
+#endif
+        };
+        thread_local OriginalThreadState originalState;
+
+        void saveOriginalThreadState(pthread_t thread) {
+            if (originalState.saved) return;
+            if (pthread_getschedparam(thread, &originalState.policy, &originalState.param) != 0) {
+                originalState.policy = SCHED_OTHER;
+                originalState.param = sched_param{};
+            }
+#if defined(__linux__)
+            CPU_ZERO(&originalState.mask);
+            originalState.maskSaved =
+                pthread_getaffinity_np(thread, sizeof(originalState.mask), &originalState.mask) == 0;
+#endif
+            originalState.saved = true;
+        }
+#endif
+
+    } // namespace
+
+    void SampleScheduler::setOptions(const SchedulerOptions& newOptions) {
+        std::lock_guard<std::mutex> lock(mutex);
+        bool periodChanged = (newOptions.period != options.period);
+        options = newOptions;
+        if (options.period.count() <= 0) options.period = std::chrono::milliseconds(1);
+        if (periodChanged) started = false;   // Re-alinear deadlines al nuevo periodo
+    }
+
+    SchedulerOptions SampleScheduler::getOptions() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return options;
+    }
+
+    // ============================================================================
+    // OPCIONES DE HILO (prioridad tiempo real y afinidad)
+    // ============================================================================
+
+    bool SampleScheduler::applyThreadOptions(std::string* error) {
+        SchedulerOptions opts = getOptions();
+        std::string errors;
+        bool rt = false, affinity = false;
+
+#if defined(_WIN32)
+        HANDLE thread = GetCurrentThread();
+        int priority = opts.realtime ? THREAD_PRIORITY_TIME_CRITICAL : THREAD_PRIORITY_NORMAL;
+        if (SetThreadPriority(thread, priority)) rt = opts.realtime;
+        else errors += "SetThreadPriority failed (" + std::to_string(GetLastError()) + "); ";
+
+        DWORD_PTR processMask = ~DWORD_PTR(0), systemMask = 0;
+        GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask);
+        DWORD_PTR mask = (opts.cpu >= 0 && opts.cpu < 64) ? (DWORD_PTR(1) << opts.cpu) : processMask;
+        if (SetThreadAffinityMask(thread, mask)) affinity = (opts.cpu >= 0);
+        else if (opts.cpu >= 0) errors += "SetThreadAffinityMask failed (" + std::to_string(GetLastError()) + "); ";
+#else
+        pthread_t thread = pthread_self();
+        saveOriginalThreadState(thread);
+
+        sched_param param = originalState.param;
+        int policy = originalState.policy;
+        if (opts.realtime) {
+            policy = SCHED_FIFO;
+            param.sched_priority = std::clamp(opts.priority, sched_get_priority_min(SCHED_FIFO),
+                                              sched_get_priority_max(SCHED_FIFO));
+        }
+        int rc = pthread_setschedparam(thread, policy, &param);
+        if (rc == 0) rt = opts.realtime;
+        else errors += std::string("SCHED_FIFO: ") + std::strerror(rc) + "; ";
+
+#if defined(__linux__)
+        // Sin CPU fija: la máscara original, no todas las CPUs de la máquina
+        if (opts.cpu >= 0 || originalState.maskSaved) {
+            cpu_set_t set;
+            if (opts.cpu >= 0) {
+                CPU_ZERO(&set);
+                CPU_SET(opts.cpu, &set);
+            } else {
+                set = originalState.mask;
+            }
+            rc = pthread_setaffinity_np(thread, sizeof(set), &set);
+            if (rc == 0) affinity = (opts.cpu >= 0);
+            else if (opts.cpu >= 0) errors += std::string("CPU affinity: ") + std::strerror(rc) + "; ";
+        }
+#else
+        if (opts.cpu >= 0) errors += "CPU affinity not supported on this platform; ";
+#endif
+#endif
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            realtimeActive = rt;
+            affinityActive = affinity;
+        }
+
+        if (!errors.empty()) {
+            std::cerr << "[SampleScheduler] Thread options partially applied: " << errors << "\n";
+            if (error) *error = errors;
+            return false;
+        }
+        std::cout << "[SampleScheduler] Thread options: realtime=" << rt
+                  << " cpu=" << (affinity ? std::to_string(opts.cpu) : std::string("any")) << "\n";
+        return true;
+    }
+
+    bool SampleScheduler::hasThreadOptionsActive() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return realtimeActive || affinityActive;
+    }
+
+    void SampleScheduler::restoreDefaultThreadOptions() {
+        // Bajar prioridad y ampliar afinidad no requiere permisos
+#if defined(_WIN32)
+        HANDLE thread = GetCurrentThread();
+        SetThreadPriority(thread, THREAD_PRIORITY_NORMAL);
+        DWORD_PTR processMask = 0, systemMask = 0;
+        if (GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask)) {
+            SetThreadAffinityMask(thread, processMask);
+        }
+#else
+        // Nada aplicado en este hilo: no hay nada que deshacer
+        if (!originalState.saved) return;
+        pthread_t thread = pthread_self();
+        int rc = pthread_setschedparam(thread, originalState.policy, &originalState.param);
+        if (rc != 0) std::cerr << "[SampleScheduler] Cannot restore scheduling policy: " << std::strerror(rc) << "\n";
+
+#if defined(__linux__)
+        if (originalState.maskSaved) {
+            rc = pthread_setaffinity_np(thread, sizeof(originalState.mask), &originalState.mask);
+            if (rc != 0) std::cerr << "[SampleScheduler] Cannot restore CPU affinity: " << std::strerror(rc) << "\n";
+        }
+#endif
+        originalState.saved = false;
+#endif
+    }
+
+    // ============================================================================
+    // ESPERA POR DEADLINE ABSOLUTO
+    // ============================================================================
+
+    void SampleScheduler::start() {
+        std::lock_guard<std::mutex> lock(mutex);
+        next = Clock::now() + options.period;
+        started = true;
+    }
+
+    void SampleScheduler::sleepUntil(Clock::time_point deadline) const {
+#if defined(__linux__)
+        // steady_clock es CLOCK_MONOTONIC: el time_point se traduce directamente
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+        timespec ts;
+        ts.tv_sec = static_cast<time_t>(ns / 1000000000LL);
+        ts.tv_nsec = static_cast<long>(ns % 1000000000LL);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+#else
+        std::this_thread::sleep_until(deadline);
+#endif
+    }
+
+    bool SampleScheduler::waitNext(const Sleeper& sleeper) {
+        Clock::time_point deadline;
+        std::chrono::nanoseconds spin, period;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!started) {
+                next = Clock::now() + options.period;
+                started = true;
+            }
+            deadline = next;
+            spin = options.spinWindow;
+            period = options.period;
+        }
+
+        // Overrun: el trabajo del ciclo terminó después del deadline. Se muestrea ya
+        // y se saltan los deadlines perdidos (no se dispara una ráfaga para recuperar)
+        Clock::time_point now = Clock::now();
+        uint64_t missed = 0;
+        bool overrun = (now > deadline);
+        if (overrun) {
+            auto behind = (now - deadline) / period;
+            missed = static_cast<uint64_t>(behind);
+            deadline += period * behind;
+        } else {
+            // Dormir hasta (deadline - spin) y esperar activamente el resto
+            Clock::time_point wake = deadline - spin;
+            if (now < wake) {
+                if (!sleeper) sleepUntil(wake);
+                else if (!sleeper(wake)) return false;
+            }
+            if (spin.count() > 0) {
+                while (Clock::now() < deadline) {}
+            }
+            now = Clock::now();
+        }
+        double latencyUs = std::chrono::duration<double, std::micro>(now - deadline).count();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!started) return true;   // setOptions() cambió el periodo mientras dormíamos
+
+        next = deadline + period;
+        stats.ticks++;
+        if (overrun) {
+            stats.overruns++;
+            stats.missedPeriods += missed;
+            Instrumentation::instance().add(Counter::DROPPED_FRAMES, missed);
+            return true;   // El retraso de un overrun no es jitter del despertar
+        }
+
+        uint64_t onTime = stats.ticks - stats.overruns;
+        latencySum += latencyUs;
+        latencySumSq += latencyUs * latencyUs;
+        if (onTime == 1) {
+            stats.minLatencyUs = stats.maxLatencyUs = latencyUs;
+        } else {
+            stats.minLatencyUs = std::min(stats.minLatencyUs, latencyUs);
+            stats.maxLatencyUs = std::max(stats.maxLatencyUs, latencyUs);
+        }
+        return true;
+    }
+
+    SchedulerStats SampleScheduler::getStats() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        SchedulerStats result = stats;
+        result.periodUs = std::chrono::duration<double, std::micro>(options.period).count();
+        uint64_t onTime = stats.ticks - stats.overruns;
+        if (onTime > 0) {
+            result.meanLatencyUs = latencySum / onTime;
+            double variance = latencySumSq / onTime - result.meanLatencyUs * result.meanLatencyUs;
+            result.stddevLatencyUs = std::sqrt(std::max(0.0, variance));
+        }
+        result.realtimeActive = realtimeActive;
+        result.affinityActive = affinityActive;
+        return result;
+    }
+
+    void SampleScheduler::resetStats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats = SchedulerStats{};
+        latencySum = latencySumSq = 0.0;
+    }
+
+} // namespace JTAG
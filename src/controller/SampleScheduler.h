@@ -0,0 +1,85 @@
+#pragma once
+
+#include <string>
+#include <functional>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+
+namespace JTAG {
+
+    struct SchedulerOptions {
+        std::chrono::nanoseconds period{ std::chrono::milliseconds(100) };
+        // Últimos 'spinWindow' antes del deadline en espera activa (0 = solo dormir).
+        // Necesario para periodos < 1 ms, donde la latencia de despertar domina.
+        std::chrono::nanoseconds spinWindow{ 0 };
+        bool realtime = false;      // SCHED_FIFO (Linux) / TIME_CRITICAL (Windows)
+        int priority = 50;          // Prioridad SCHED_FIFO (1..99)
+        int cpu = -1;               // Afinidad a una CPU (-1 = sin fijar)
+    };
+
+    struct SchedulerStats {
+        uint64_t ticks = 0;
+        uint64_t overruns = 0;          // Ciclos cuyo trabajo superó el periodo
+        uint64_t missedPeriods = 0;     // Deadlines saltados para no acumular retraso
+        double periodUs = 0.0;
+        double meanLatencyUs = 0.0;     // Retraso del despertar respecto al deadline (ciclos a tiempo)
+        double stddevLatencyUs = 0.0;
+        double minLatencyUs = 0.0;
+        double maxLatencyUs = 0.0;
+        bool realtimeActive = false;
+        bool affinityActive = false;
+    };
+
+    /**
+     * @brief Planificador de muestreo periódico con deadlines absolutos
+     *
+     * El deadline k es start + k·periodo, independiente de lo que tarde el scan:
+     * la separación entre muestras no acumula el tiempo de trabajo ni el jitter.
+     * Si un ciclo se pasa de su deadline se cuenta como overrun y se saltan los
+     * periodos perdidos (no se dispara una ráfaga para "recuperar").
+     *
+     * Linux: clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME). Resto: sleep_until.
+     * Con spinWindow > 0 se duerme hasta deadline - spinWindow y el resto se
+     * espera activamente.
+     */
+    class SampleScheduler {
+    public:
+        using Clock = std::chrono::steady_clock;
+        // Duerme hasta 'wake'; false si se despertó antes por otro trabajo
+        using Sleeper = std::function<bool(Clock::time_point wake)>;
+
+        void setOptions(const SchedulerOptions& options);
+        SchedulerOptions getOptions() const;
+
+        // Aplica prioridad/afinidad al hilo que llama (el del worker).
+        // Sin permisos (EPERM) devuelve false y se sigue con la planificación normal.
+        bool applyThreadOptions(std::string* error = nullptr);
+        bool hasThreadOptionsActive() const;   // Tiempo real o afinidad aplicados
+        // Devuelve el hilo que llama a la planificación y afinidad que tenía antes
+        // del primer applyThreadOptions() (hilo compartido cuyo trabajo periódico se retira)
+        static void restoreDefaultThreadOptions();
+
+        void start();       // Primer deadline = ahora + periodo
+        // Espera al siguiente deadline y actualiza estadísticas. Con 'sleeper' la parte
+        // dormida puede interrumpirse: devuelve false sin consumir el deadline
+        bool waitNext(const Sleeper& sleeper = {});
+
+        SchedulerStats getStats() const;
+        void resetStats();
+
+    private:
+        void sleepUntil(Clock::time_point deadline) const;
+
+        mutable std::mutex mutex;   // Opciones y estadísticas (lecturas desde la GUI)
+        SchedulerOptions options;
+        Clock::time_point next;
+        bool started = false;
+
+        SchedulerStats stats;
+        double latencySum = 0.0, latencySumSq = 0.0;
+        bool realtimeActive = false;
+        bool affinityActive = false;
+    };
+
+} // namespace JTAG
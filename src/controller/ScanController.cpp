@@ -1,6 +1,7 @@
 #include "ScanController.h"
-#include "../parser/BSDLParser.h"
 #include "../core/BoundaryScanEngine.h"
+#include "../hal/trace/TraceReader.h"
+#include "../hal/trace/TraceExport.h"
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
@@ -15,17 +16,16 @@ namespace JTAG {
 
     ScanController::ScanController()
         : QObject(nullptr)
-        , adapter(nullptr)
-        , engine(nullptr)
-        , deviceModel(nullptr)
-        , detectedIDCODE(0)
-        , initialized(false)
     {
-        workerThread = new QThread(this);
+        // Una carga activa más una cancelada que aún no ha llegado a su siguiente comprobación
+        loadPool.setMaxThreadCount(2);
         std::cout << "[ScanController] Constructor: ScanController created\n";
     }
 
     ScanController::~ScanController() {
+        // Las tareas del pool usan this (caché de modelos, señales)
+        cancelBSDLLoad();
+        loadPool.waitForDone();
         disconnectAdapter();
     }
 
@@ -43,272 +43,224 @@ namespace JTAG {
     // ============================================================================
 
     bool ScanController::connectAdapter(AdapterType type, uint32_t clockSpeed) {
-        std::cout << "[ScanController] connectAdapter: type=" << static_cast<int>(type)
-                  << " clockSpeed=" << clockSpeed << "\n";
-
-        if (adapter) {
-            std::cout << "[ScanController] Disconnecting existing adapter\n";
-            disconnectAdapter();
-        }
-
-        try {
-            adapter = AdapterFactory::create(type);
-
-            if (!adapter) {
-                std::cerr << "[ScanController] ERROR: Failed to create adapter\n";
-                return false;
-            }
-
-            std::cout << "[ScanController] Opening adapter...\n";
-            if (!adapter->open()) {
-                std::cerr << "[ScanController] ERROR: Failed to open adapter\n";
-                adapter.reset();
-                return false;
-            }
-
-            std::cout << "[ScanController] Setting clock speed to " << clockSpeed << " Hz\n";
-            adapter->setClockSpeed(clockSpeed);
-            initialized = false;
-            detectedIDCODE = 0;
-
-            // NUEVO: Si es MockAdapter, auto-generar DeviceModel
-            if (type == AdapterType::MOCK) {
-                createMockDeviceModel();
-                qDebug() << "[ScanController] MockAdapter connected - auto-generated DeviceModel";
-            }
-
-            return true;
-
-        }
-        catch (...) {
-            adapter.reset();
-            return false;
-        }
+        if (session.getAdapter()) disconnectAdapter();
+        return executor.call([&](JtagSession& s) { return s.connectAdapter(type, clockSpeed); });
     }
 
     bool ScanController::connectAdapter(const AdapterDescriptor& descriptor, uint32_t clockSpeed) {
-        if (adapter) disconnectAdapter();
-
-        try {
-            // Use factory with deviceID to create specific adapter instance
-            adapter = AdapterFactory::create(descriptor.type, descriptor.deviceID);
-
-            if (!adapter) return false;
-
-            if (!adapter->open()) {
-                adapter.reset();
-                return false;
-            }
-
-            adapter->setClockSpeed(clockSpeed);
-            initialized = false;
-            detectedIDCODE = 0;
-
-            // NUEVO: Si es MockAdapter, auto-generar DeviceModel
-            if (descriptor.type == AdapterType::MOCK) {
-                createMockDeviceModel();
-                qDebug() << "[ScanController] MockAdapter connected - auto-generated DeviceModel";
-            }
-
-            std::cout << "[ScanController] Connected to: " << descriptor.name
-                      << " (" << descriptor.serialNumber << ")\n";
-
-            return true;
-
-        }
-        catch (const std::exception& e) {
-            std::cerr << "[ScanController] Exception connecting adapter: " << e.what() << "\n";
-            adapter.reset();
-            return false;
-        }
-        catch (...) {
-            adapter.reset();
-            return false;
-        }
+        if (session.getAdapter()) disconnectAdapter();
+        return executor.call([&](JtagSession& s) { return s.connectAdapter(descriptor, clockSpeed); });
     }
 
     void ScanController::disconnectAdapter() {
-        if (adapter) {
-            adapter->close();
-            adapter.reset();
-        }
-        engine.reset();
-        deviceModel.reset();
-        initialized = false;
-        detectedIDCODE = 0;
+        // El worker usa el engine de la sesión: pararlo antes de liberarlo
+        releaseWorker();
+        executor.call([](JtagSession& s) { s.disconnectAdapter(); });
     }
 
     void ScanController::unloadBSDL() {
-        // Detener polling si está activo
-        stopPolling();
-
-        // Limpiar el modelo del dispositivo, engine e IDCODE del target
-        // Mantener SOLO el adaptador (sonda) conectado
-        engine.reset();
-        deviceModel.reset();
-        initialized = false;
-        detectedIDCODE = 0;  // Limpiar IDCODE del target
+        // Detener polling si está activo; una carga en curso ya no se adoptará
+        releaseWorker();
+        cancelBSDLLoad();
 
         // NO tocar: adapter (la sonda sigue conectada)
-        std::cout << "[ScanController] BSDL unloaded - adapter still connected\n";
+        executor.call([](JtagSession& s) { s.unloadBSDL(); });
     }
 
     bool ScanController::isConnected() const {
-        return adapter && adapter->isConnected();
+        return executor.call([](JtagSession& s) { return s.isConnected(); });
     }
 
     std::string ScanController::getAdapterInfo() const {
-        return adapter ? adapter->getInfo() : "";
+        return executor.call([](JtagSession& s) { return s.getAdapterInfo(); });
     }
 
     uint32_t ScanController::detectDevice() {
-        std::cout << "[ScanController] detectDevice: Reading IDCODE...\n";
-
-        if (!adapter) {
-            std::cerr << "[ScanController] ERROR: No adapter connected\n";
-            return 0;
-        }
-
-        // Engine temporal solo para IDCODE
-        auto tempEngine = std::make_unique<BoundaryScanEngine>(adapter.get(), 0);
-        detectedIDCODE = tempEngine->readIDCODE();
-
-        std::cout << "[ScanController] IDCODE read: 0x" << std::hex << std::setw(8) << std::setfill('0')
-                  << detectedIDCODE << std::dec << "\n";
-
-        if (detectedIDCODE == 0 || detectedIDCODE == 0xFFFFFFFF) {
-            std::cerr << "[ScanController] WARNING: Invalid IDCODE (0x00000000 or 0xFFFFFFFF)\n";
-            detectedIDCODE = 0;
-            return 0;
-        }
-        return detectedIDCODE;
+        return executor.call([](JtagSession& s) { return s.detectDevice(); });
     }
 
     bool ScanController::loadBSDL(const std::filesystem::path& bsdlPath) {
         std::cout << "[ScanController] loadBSDL: Loading file: " << bsdlPath.string() << "\n";
 
-        BSDLParser parser;
-        if (!parser.parse(bsdlPath)) {
+        auto model = session.loadModel(bsdlPath);
+        if (!model) {
             std::cerr << "[ScanController] ERROR: Failed to parse BSDL file\n";
             return false;
         }
+        installDeviceModel(std::move(model));
+        return true;
+    }
 
-        deviceModel = std::make_unique<DeviceModel>();
-        deviceModel->loadFromData(parser.getData());
-
-        std::cout << "[ScanController] Device: " << deviceModel->getDeviceName()
-                  << " BSR Length: " << deviceModel->getBSRLength() << " bits\n";
-
-        // Recrear engine con tamaño BSR correcto
-        if (adapter) {
-            engine = std::make_unique<BoundaryScanEngine>(adapter.get(), deviceModel->getBSRLength());
-            std::cout << "[ScanController] BoundaryScanEngine recreated with BSR length: "
-                      << deviceModel->getBSRLength() << "\n";
-        }
-
+    void ScanController::installDeviceModel(std::unique_ptr<DeviceModel> model) {
+        // El worker usa engine y modelo: no se sustituyen con el polling en marcha
+        releaseWorker();
+        executor.call([&model](JtagSession& s) { s.installDeviceModel(std::move(model)); });
         std::cout << "[ScanController] BSDL loaded successfully\n";
-        return true;
     }
 
-    std::string ScanController::getDeviceName() const {
-        return deviceModel ? deviceModel->getDeviceName() : "";
+    void ScanController::releaseWorker() {
+        stopPolling();
+        // Sin ciclos en curso ni pendientes: nadie más usa el worker
+        delete scanWorker;
+        scanWorker = nullptr;
     }
 
-    std::string ScanController::getPackageInfo() const {
-        return deviceModel ? deviceModel->getPackageInfo() : "";
+    void ScanController::setModelCacheDirectory(const std::filesystem::path& dir) {
+        session.setModelCacheDirectory(dir);
+    }
+
+    ModelCache::Stats ScanController::getModelCacheStats() const {
+        return session.getModelCacheStats();
     }
 
     // ============================================================================
-    // INICIALIZACIÓN Y CONTROL
+    // CARGA ASÍNCRONA DE BSDL
     // ============================================================================
 
-    bool ScanController::initialize() {
-        std::cout << "[ScanController] initialize: Starting device initialization...\n";
+    std::shared_ptr<BsdlLoadTask> ScanController::loadBSDLAsync(const std::filesystem::path& bsdlPath,
+                                                                BsdlLoadTask::Prepare prepare) {
+        std::cout << "[ScanController] loadBSDLAsync: Queuing file: " << bsdlPath.string() << "\n";
 
-        if (!adapter || !deviceModel || !engine) {
-            std::cerr << "[ScanController] ERROR: Missing components - adapter:" << (adapter ? "OK" : "NULL")
-                      << " deviceModel:" << (deviceModel ? "OK" : "NULL")
-                      << " engine:" << (engine ? "OK" : "NULL") << "\n";
-            return false;
-        }
+        // Cambio de placa: la carga anterior ya no interesa
+        cancelBSDLLoad();
 
-        // Reset TAP a estado conocido
-        std::cout << "[ScanController] Resetting TAP controller...\n";
-        if (!engine->reset()) {
-            std::cerr << "[ScanController] ERROR: Failed to reset TAP\n";
-            return false;
-        }
+        auto task = std::make_shared<BsdlLoadTask>(++loadSequence, bsdlPath, std::move(prepare));
+        task->setProgressCallback([this](const BsdlLoadTask& t, int percent, const std::string& stage) {
+            emit bsdlLoadProgress(t.getId(), percent, QString::fromStdString(stage));
+        });
+        currentLoad = task;
+
+        // La tarea se captura por shared_ptr: sobrevive aunque se sustituya currentLoad
+        loadPool.start([this, task]() { runLoadTask(*task); });
+        return task;
+    }
 
-        // ========== SECUENCIA IEEE 1149.1 (Solución A) ==========
+    void ScanController::runLoadTask(BsdlLoadTask& task) {
+        task.status.store(BsdlLoadTask::Status::RUNNING, std::memory_order_relaxed);
 
-        // Paso 1: Cargar instrucción SAMPLE/PRELOAD
-        std::cout << "[ScanController] Loading SAMPLE/PRELOAD instruction...\n";
-        uint32_t sampleInstr = deviceModel->getInstruction("SAMPLE/PRELOAD");
-        if (sampleInstr == 0xFFFFFFFF) {
-            // Fallback si no existe SAMPLE/PRELOAD
-            std::cout << "[ScanController] SAMPLE/PRELOAD not found, trying SAMPLE...\n";
-            sampleInstr = deviceModel->getInstruction("SAMPLE");
+        if (task.isCancelled()) {
+            task.finish(BsdlLoadTask::Status::CANCELLED);
+        } else {
+            task.reportProgress(5, "Loading device model");
+            auto model = session.loadModel(task.getPath());
+
+            if (!model) {
+                task.finish(BsdlLoadTask::Status::FAILED, nullptr, "Failed to load or parse BSDL file");
+            } else if (task.isCancelled()) {
+                task.finish(BsdlLoadTask::Status::CANCELLED);
+            } else {
+                task.reportProgress(50, "Device model ready");
+                if (!task.runPrepare(*model) || task.isCancelled()) {
+                    task.finish(BsdlLoadTask::Status::CANCELLED);
+                } else {
+                    task.reportProgress(100, "Done");
+                    task.finish(BsdlLoadTask::Status::FINISHED, std::move(model));
+                }
+            }
         }
 
-        std::cout << "[ScanController] SAMPLE instruction opcode: 0x" << std::hex << sampleInstr << std::dec << "\n";
+        std::cout << "[ScanController] BSDL load task #" << task.getId() << " "
+                  << (task.getStatus() == BsdlLoadTask::Status::FINISHED ? "finished"
+                      : task.getStatus() == BsdlLoadTask::Status::CANCELLED ? "cancelled" : "failed")
+                  << ": " << task.getPath().string() << "\n";
+        emit bsdlLoadFinished(task.getId());
+    }
 
-        if (!engine->loadInstruction(sampleInstr, deviceModel->getIRLength())) {
-            std::cerr << "[ScanController] ERROR: Failed to load SAMPLE instruction\n";
+    bool ScanController::adoptLoadedBSDL(BsdlLoadTask& task) {
+        // Solo la última carga pedida; una sustituida o cancelada se descarta
+        if (!currentLoad || currentLoad.get() != &task
+            || task.getStatus() != BsdlLoadTask::Status::FINISHED) {
             return false;
         }
+        currentLoad.reset();
 
-        // Paso 2: Sample para capturar estado actual seguro
-        if (!engine->samplePins()) {
-            std::cerr << "[ScanController] Failed to sample pins\n";
-            return false;
-        }
+        auto model = task.takeModel();
+        if (!model) return false;
+        installDeviceModel(std::move(model));
+        return true;
+    }
 
-        // Paso 3: Precargar esos valores en el registro de actualización
-        // (sin cambiar pines físicos, porque estamos en SAMPLE/PRELOAD)
-        if (!engine->preloadBSR()) {
-            std::cerr << "[ScanController] Failed to preload BSR\n";
-            return false;
+    void ScanController::cancelBSDLLoad() {
+        if (currentLoad) {
+            currentLoad->cancel();
+            currentLoad.reset();
         }
+    }
 
-        // Paso 4: Cargar instrucción EXTEST
-        // Los pines tomarán los valores precargados de forma segura
-        uint32_t extestInstr = deviceModel->getInstruction("EXTEST");
-        if (!engine->loadInstruction(extestInstr, deviceModel->getIRLength())) {
-            std::cerr << "[ScanController] Failed to load EXTEST instruction\n";
-            return false;
+    std::vector<BsdlLibraryEntry> ScanController::findBSDLCandidates(uint32_t idcode) {
+        auto candidates = bsdlLibrary.findByIdcode(idcode);
+        const bool missingFile = std::any_of(candidates.begin(), candidates.end(), [](const BsdlLibraryEntry& e) {
+            std::error_code ec;
+            return !std::filesystem::exists(e.path, ec);
+        });
+        if ((candidates.empty() || missingFile) && !bsdlLibrary.getDirectories().empty()) {
+            // Índice desactualizado (ficheros añadidos o borrados desde el último escaneo):
+            // solo se reabren los nuevos o modificados y los borrados salen del índice
+            bsdlLibrary.refresh();
+            candidates = bsdlLibrary.findByIdcode(idcode);
         }
+        std::cout << "[ScanController] BSDL library: " << candidates.size()
+                  << " candidate(s) for IDCODE 0x" << std::hex << idcode << std::dec << "\n";
+        return candidates;
+    }
 
-        // NO ejecutar samplePins() o applyChanges() aquí
-        // El worker lo hará en su primer ciclo
+    std::string ScanController::getDeviceName() const {
+        const DeviceModel* model = session.getDeviceModel();
+        return model ? model->getDeviceName() : "";
+    }
 
-        // ========== FIN SECUENCIA IEEE 1149.1 ==========
+    std::string ScanController::getPackageInfo() const {
+        const DeviceModel* model = session.getDeviceModel();
+        return model ? model->getPackageInfo() : "";
+    }
 
-        // Crear worker y moverlo al thread
-        scanWorker = new ScanWorker(engine.get(), deviceModel.get());
-        scanWorker->moveToThread(workerThread);
+    // ============================================================================
+    // INICIALIZACIÓN Y CONTROL
+    // ============================================================================
+
+    bool ScanController::initialize() {
+        // Secuencia IEEE 1149.1 segura (termina en EXTEST sin scanDR); el worker
+        // hará el primer samplePins()/applyChanges() en su primer ciclo
+        if (!executor.call([](JtagSession& s) { return s.initialize(); })) return false;
+
+        // Mismo engine y modelo: se conserva el worker (y sus suscripciones); la
+        // secuencia ha cambiado la instrucción cargada
+        if (scanWorker) {
+            scanWorker->forceReloadInstruction();
+            return true;
+        }
 
-        // Conectar señales (especificar Qt::QueuedConnection explícitamente para cross-thread)
-        connect(workerThread, &QThread::started, scanWorker, &ScanWorker::run);
+        // Crear worker; sus ciclos los ejecuta el executor (startPolling)
+        scanWorker = new ScanWorker(session.getEngine(), session.getDeviceModel());
+        scanWorker->setSchedulerOptions(schedulerOptions);
+        scanWorker->setContentionDetection(contentionEnabled, contentionSafeState);
+
+        // Las señales se emiten desde el hilo del executor (Qt::QueuedConnection explícito)
         connect(scanWorker, &ScanWorker::pinsUpdated,
                 this, &ScanController::onPinsUpdated, Qt::QueuedConnection);
         connect(scanWorker, &ScanWorker::errorOccurred,
                 this, &ScanController::onWorkerError, Qt::QueuedConnection);
         connect(scanWorker, &ScanWorker::stopped,
                 this, &ScanController::onWorkerStopped, Qt::QueuedConnection);
+        connect(scanWorker, &ScanWorker::pinFaultDetected,
+                this, &ScanController::pinFaultDetected, Qt::QueuedConnection);
+        connect(scanWorker, &ScanWorker::triggerCaptured,
+                this, &ScanController::triggerCaptured, Qt::QueuedConnection);
+        connect(scanWorker, &ScanWorker::burstCaptured,
+                this, &ScanController::burstCaptured, Qt::QueuedConnection);
 
-        initialized = true;
         return true;
     }
 
     bool ScanController::reset() {
-        if (!engine) return false;
-        initialized = false;
-        return engine->reset();
+        return executor.call([](JtagSession& s) { return s.reset(); });
     }
 
     bool ScanController::resetJTAGStateMachine() {
-        if (!engine) return false;
-        return engine->resetJTAGStateMachine();
+        return executor.call([](JtagSession& s) {
+            BoundaryScanEngine* engine = s.getEngine();
+            return engine ? engine->resetJTAGStateMachine() : false;
+        });
     }
 
     // ============================================================================
@@ -316,62 +268,33 @@ namespace JTAG {
     // ============================================================================
 
     bool ScanController::setPin(const std::string& pinName, PinLevel level) {
-        if (!deviceModel || !engine) return false;
-
-        auto pinInfo = deviceModel->getPinInfo(pinName);
-        if (!pinInfo) {
-            qWarning() << "setPin: Pin not found" << QString::fromStdString(pinName);
-            return false;
-        }
-
-        // PROTECCIÓN: Si outputCell es negativo, NO INTENTAR ESCRIBIR
-        if (pinInfo->outputCell < 0) {
-            // Es un input (como CLKIN), ignoramos la escritura silenciosamente o con aviso debug
-            qDebug() << "[ScanController] Skipping write to input pin:" << QString::fromStdString(pinName);
+        const DeviceModel* model = session.getDeviceModel();
+        auto pinInfo = model ? model->getPinInfo(pinName) : std::nullopt;
+        if (!pinInfo || pinInfo->outputCell < 0) {
+            std::cerr << "[ScanController] setPin: pin not found or without output cell: " << pinName << "\n";
             return false;
         }
-
-        return engine->setPin(pinInfo->outputCell, level);
+        // Sin esperar: el applyChanges() siguiente va detrás en la cola y comparte su scan
+        executor.writePins({ { static_cast<size_t>(pinInfo->outputCell), level } }, false, {});
+        return true;
     }
 
     std::optional<PinLevel> ScanController::getPin(const std::string& pinName) const {
-        if (!deviceModel || !engine) {
-            return std::nullopt;
-        }
-
-        auto pinInfo = deviceModel->getPinInfo(pinName);
-        if (!pinInfo) {
-            return std::nullopt;
-        }
-
-        // Leer del buffer correcto según el tipo de celda:
-
-        // 1. Si tiene celda INPUT, leer del buffer CAPTURADO (TDO)
-        if (pinInfo->inputCell != -1) {
-            auto level = engine->getPinReadback(pinInfo->inputCell);
-            return level;
-        }
-
-        // 2. Si solo tiene celda OUTPUT, leer del buffer DESEADO (TDI)
-        //    (para mostrar al usuario qué valor estamos enviando)
-        if (pinInfo->outputCell != -1) {
-            auto level = engine->getPin(pinInfo->outputCell);
-            return level;
-        }
-
-        return std::nullopt;
+        return executor.call([&pinName](JtagSession& s) { return s.getPin(pinName); });
     }
 
     std::vector<std::string> ScanController::getPinList() const {
-        return deviceModel ? deviceModel->getPinNames() : std::vector<std::string>{};
+        const DeviceModel* model = session.getDeviceModel();
+        return model ? model->getPinNames() : std::vector<std::string>{};
     }
 
     bool ScanController::applyChanges() {
-        return (engine && initialized) ? engine->applyChanges() : false;
+        // Se fusiona con las escrituras y aplicaciones pendientes de otros hilos (RPC)
+        return executor.writePins({}, true).get();
     }
 
     bool ScanController::samplePins() {
-        return (engine && initialized) ? engine->samplePins() : false;
+        return executor.sample().get();
     }
 
     bool ScanController::setPins(const std::map<std::string, PinLevel>& pins) {
@@ -381,148 +304,224 @@ namespace JTAG {
     }
 
     std::map<std::string, PinLevel> ScanController::getPins(const std::vector<std::string>& pinNames) const {
-        std::map<std::string, PinLevel> result;
-        for (const auto& name : pinNames) {
-            auto val = getPin(name);
-            if (val) result[name] = *val;
-        }
-        return result;
+        // Una sola visita al executor para todos los pines
+        return executor.call([&pinNames](JtagSession& s) {
+            std::map<std::string, PinLevel> result;
+            for (const auto& name : pinNames) {
+                auto val = s.getPin(name);
+                if (val) result[name] = *val;
+            }
+            return result;
+        });
     }
 
     bool ScanController::runTest(size_t numCycles) {
-        return engine ? engine->runTestCycles(numCycles) : false;
+        return executor.call([numCycles](JtagSession& s) { return s.runTest(numCycles); });
     }
 
-    bool ScanController::enterSAMPLE() {
-        if (!initialize()) return false; // Asegura que BSDL esté cargado
-        // SAMPLE/PRELOAD suele ser la instrucción segura por defecto
-        uint32_t opcode = deviceModel->getInstruction("SAMPLE");
-        if (opcode == 0xFFFFFFFF) opcode = deviceModel->getInstruction("SAMPLE/PRELOAD");
+    bool ScanController::compileSVF(const std::filesystem::path& svfPath, const std::filesystem::path& jvecPath) {
+        return session.compileSVF(svfPath, jvecPath);
+    }
 
-        if (!engine->loadInstruction(opcode, deviceModel->getIRLength())) return false;
+    bool ScanController::runVectorFile(const std::filesystem::path& jvecPath) {
+        if (!session.getAdapter()) return false;
 
-        // Setear modo antes de samplePins
-        engine->setOperationMode(BoundaryScanEngine::OperationMode::SAMPLE);
+        // El fichero toma el control exclusivo del TAP: pausar el polling
+        bool wasPolling = isPolling();
+        stopPolling();
+
+        std::string error;
+        bool ok = executor.call([&](JtagSession& s) {
+            if (s.runVectorFile(jvecPath)) return true;
+            error = s.getLastError();
+            return false;
+        });
+        if (!ok) {
+            emit errorOccurred(QString::fromStdString(error));
+        }
 
-        // Ejecutar un ciclo de sampleo inicial
-        return engine->samplePins();
+        // Los vectores han cambiado la instrucción cargada: recargarla en el siguiente ciclo
+        forceReloadInstruction();
+        if (wasPolling) startPolling();
+
+        return ok;
     }
 
-    bool ScanController::enterEXTEST() {
-        if (!engine || !deviceModel) return false;
+    bool ScanController::startRecording(const std::filesystem::path& tracePath) {
+        return executor.call([&tracePath](JtagSession& s) { return s.startRecording(tracePath); });
+    }
 
-        // ========== SECUENCIA IEEE 1149.1 (Solución A) ==========
+    void ScanController::stopRecording() {
+        executor.call([](JtagSession& s) { s.stopRecording(); });
+    }
 
-        // Paso 1: Cargar SAMPLE/PRELOAD
-        uint32_t sampleInstr = deviceModel->getInstruction("SAMPLE/PRELOAD");
-        if (sampleInstr == 0xFFFFFFFF) {
-            sampleInstr = deviceModel->getInstruction("SAMPLE");
-        }
+    bool ScanController::isRecording() const {
+        return executor.call([](JtagSession& s) { return s.isRecording(); });
+    }
 
-        if (!engine->loadInstruction(sampleInstr, deviceModel->getIRLength())) {
-            return false;
-        }
+    bool ScanController::exportTraceToSVF(const std::filesystem::path& tracePath, const std::filesystem::path& svfPath) {
+        TraceReader reader;
+        if (!reader.open(tracePath)) return false;
+        return TraceExport::toSVF(reader, svfPath);
+    }
 
-        // Paso 2: Sample para capturar estado actual
-        if (!engine->samplePins()) {
-            return false;
-        }
+    bool ScanController::prepareBusAccess() {
+        BoundaryScanEngine* engine = session.getEngine();
+        if (!session.getAdapter() || !engine || !session.getDeviceModel()) return false;
 
-        // Paso 3: Precargar valores seguros
-        if (!engine->preloadBSR()) {
-            return false;
-        }
+        // Los ciclos de bus van directos al adaptador: sin polling concurrente
+        stopPolling();
 
-        // Paso 4: Cargar EXTEST (sin scanDR después)
-        uint32_t extestInstr = deviceModel->getInstruction("EXTEST");
-        if (!engine->loadInstruction(extestInstr, deviceModel->getIRLength())) {
+        const bool inExtest = executor.call([engine](JtagSession&) {
+            return engine->getOperationMode() == BoundaryScanEngine::OperationMode::EXTEST;
+        });
+        if (!inExtest && !enterEXTEST()) {
+            emit errorOccurred("Cannot enter EXTEST for bus access");
             return false;
         }
-
-        // ========== FIN SECUENCIA IEEE 1149.1 ==========
-
-        // Setear modo al final
-        engine->setOperationMode(BoundaryScanEngine::OperationMode::EXTEST);
-
         return true;
     }
 
-    bool ScanController::enterBYPASS() {
-        if (!engine) return false;
-        engine->setOperationMode(BoundaryScanEngine::OperationMode::BYPASS);
-        uint32_t opcode = deviceModel->getInstruction("BYPASS");
-        return engine->loadInstruction(opcode, deviceModel->getIRLength());
+    template <typename Master, typename Configure>
+    bool ScanController::runBusMaster(Configure configure, const std::function<bool(Master&)>& operation) {
+        std::string error;
+        bool ok = executor.call([&](JtagSession& s) {
+            BoundaryScanEngine* engine = s.getEngine();
+            Master master(s.getAdapter(), *s.getDeviceModel(), engine->getBSR());
+            bool done = configure(master) && operation(master);
+            if (!done) error = master.getLastError();
+            // Los pines quedan como los dejó el bus: el siguiente Update-DR no los revierte
+            engine->setBSR(master.getImage());
+            return done;
+        });
+        if (!ok) {
+            emit errorOccurred(QString::fromStdString(error.empty() ? "Bus operation failed" : error));
+        }
+        return ok;
     }
 
-    bool ScanController::enterINTEST() {
-        if (!engine || !deviceModel) return false;
+    bool ScanController::runParallelFlash(const NorFlashPins& pins,
+                                          const std::function<bool(ParallelNorFlash&)>& operation) {
+        if (!prepareBusAccess()) return false;
+        return runBusMaster<ParallelNorFlash>([&](ParallelNorFlash& flash) { return flash.configure(pins); },
+                                              operation);
+    }
 
-        // Secuencia segura IEEE 1149.1 (igual que EXTEST)
-        // INTEST prueba la lógica interna del chip, no los pines externos
+    bool ScanController::runSpiMaster(const SpiPins& pins, int mode,
+                                      const std::function<bool(SpiMaster&)>& operation) {
+        if (!prepareBusAccess()) return false;
+        return runBusMaster<SpiMaster>([&](SpiMaster& spi) { return spi.configure(pins, mode); }, operation);
+    }
 
-        // Paso 1: Cargar SAMPLE/PRELOAD
-        uint32_t sampleInstr = deviceModel->getInstruction("SAMPLE/PRELOAD");
-        if (sampleInstr == 0xFFFFFFFF) {
-            sampleInstr = deviceModel->getInstruction("SAMPLE");
-        }
+    bool ScanController::runI2cMaster(const I2cPins& pins, const std::function<bool(I2cMaster&)>& operation) {
+        if (!prepareBusAccess()) return false;
+        return runBusMaster<I2cMaster>([&](I2cMaster& i2c) { return i2c.configure(pins); }, operation);
+    }
 
-        if (!engine->loadInstruction(sampleInstr, deviceModel->getIRLength())) {
-            std::cerr << "[ScanController] Failed to load SAMPLE for INTEST sequence\n";
+    bool ScanController::runInterconnectTest(const std::vector<InterconnectNet>& nets, InterconnectReport& report) {
+        if (!prepareBusAccess()) return false;
+
+        // Todo el test en el hilo del executor (un único comando)
+        std::string error;
+        bool ok = executor.call([&](JtagSession& s) {
+            InterconnectTest test(s.getAdapter(), *s.getDeviceModel(), s.getEngine()->getBSR());
+            if (test.setNets(nets) && test.run(report)) return true;
+            error = test.getLastError();
             return false;
+        });
+        if (!ok) {
+            emit errorOccurred(QString::fromStdString(error));
         }
+        return ok;
+    }
 
-        // Paso 2: Capturar estado actual
-        if (!engine->samplePins()) {
-            std::cerr << "[ScanController] Failed to sample pins for INTEST sequence\n";
+    bool ScanController::loadNetlist(const std::filesystem::path& path, const std::string& refdes) {
+        std::string error;
+        RawNetlist raw;
+        if (!NetlistImporter::load(path, raw, &error)) {
+            emit errorOccurred(QString::fromStdString(error));
             return false;
         }
 
-        // Paso 3: Precargar valores seguros en el update latch
-        if (!engine->preloadBSR()) {
-            std::cerr << "[ScanController] Failed to preload BSR for INTEST sequence\n";
-            return false;
+        netlist = std::move(raw);
+        netlistRefdes = refdes;
+        boardNetlist.reset();
+
+        if (const DeviceModel* model = session.getDeviceModel()) {
+            boardNetlist = std::make_unique<BoardNetlist>();
+            boardNetlistGeneration = session.getModelGeneration();
+            if (!boardNetlist->build(netlist, { { netlistRefdes, model } }, &error)) {
+                boardNetlist.reset();
+                emit errorOccurred(QString::fromStdString(error));
+                return false;
+            }
         }
+        return true;
+    }
 
-        // Paso 4: Cargar instrucción INTEST
-        uint32_t intestInstr = deviceModel->getInstruction("INTEST");
-        if (intestInstr == 0xFFFFFFFF) {
-            std::cerr << "[ScanController] INTEST instruction not found in BSDL\n";
-            return false;
+    bool ScanController::runInterconnectTest(InterconnectReport& report) {
+        const DeviceModel* model = session.getDeviceModel();
+        if (!model || netlist.nets.empty()) return false;
+
+        // El índice guarda punteros al modelo: reconstruir si se cargó otro BSDL.
+        // Se compara la generación, no el puntero (el nuevo modelo puede ocupar la misma dirección)
+        if (!boardNetlist || boardNetlistGeneration != session.getModelGeneration()) {
+            boardNetlist = std::make_unique<BoardNetlist>();
+            boardNetlistGeneration = session.getModelGeneration();
+            if (!boardNetlist->build(netlist, { { netlistRefdes, model } })) {
+                boardNetlist.reset();
+                return false;
+            }
         }
 
-        if (!engine->loadInstruction(intestInstr, deviceModel->getIRLength())) {
-            std::cerr << "[ScanController] Failed to load INTEST instruction\n";
+        auto nets = boardNetlist->toInterconnectNets(0);
+        if (nets.empty()) {
+            emit errorOccurred("Netlist has no nets testable on " + QString::fromStdString(netlistRefdes));
             return false;
         }
+        return runInterconnectTest(nets, report);
+    }
 
-        // Setear modo al final
-        engine->setOperationMode(BoundaryScanEngine::OperationMode::INTEST);
+    bool ScanController::enterSAMPLE() {
+        if (!initialize()) return false; // Asegura que BSDL esté cargado
+        return executor.call([](JtagSession& s) { return s.enterSAMPLE(); });
+    }
 
-        std::cout << "[ScanController] Successfully entered INTEST mode\n";
-        return true;
+    bool ScanController::enterEXTEST() {
+        return executor.call([](JtagSession& s) { return s.enterEXTEST(); });
+    }
+
+    bool ScanController::enterBYPASS() {
+        return executor.call([](JtagSession& s) { return s.enterBYPASS(); });
+    }
+
+    bool ScanController::enterINTEST() {
+        return executor.call([](JtagSession& s) { return s.enterINTEST(); });
     }
 
     void ScanController::setEngineOperationMode(BoundaryScanEngine::OperationMode mode) {
-        if (engine) {
-            engine->setOperationMode(mode);
-        }
+        executor.post([mode](JtagSession& s) {
+            if (BoundaryScanEngine* engine = s.getEngine()) engine->setOperationMode(mode);
+        });
     }
 
     bool ScanController::writeBus(const std::vector<std::string>& pinNames, uint32_t value) {
-        if (!engine) return false;
+        const DeviceModel* model = session.getDeviceModel();
+        if (!model || !session.getEngine()) return false;
 
-        // Desglosar el valor entero a bits para cada pin
+        // Desglosar el valor entero a bits para cada pin.
+        // Asumiremos que pinNames[0] es LSB.
+        std::vector<EngineExecutor::CellWrite> writes;
+        writes.reserve(pinNames.size());
         for (size_t i = 0; i < pinNames.size(); i++) {
-            // Bit 0 es el último pin de la lista (LSB), o el primero según tu convención.
-            // Asumiremos que pinNames[0] es LSB.
+            auto pinInfo = model->getPinInfo(pinNames[i]);
+            if (!pinInfo || pinInfo->outputCell < 0) continue;
             bool bitVal = (value >> i) & 1;
-
-            // setPin en el engine solo actualiza memoria
-            setPin(pinNames[i], bitVal ? PinLevel::HIGH : PinLevel::LOW);
+            writes.push_back({ static_cast<size_t>(pinInfo->outputCell), bitVal ? PinLevel::HIGH : PinLevel::LOW });
         }
 
         // Aplicar todos los cambios en una sola transacción JTAG
-        return applyChanges();
+        return executor.writePins(std::move(writes), true).get();
     }
 
     bool ScanController::loadDeviceModel(const std::string& path) {
@@ -538,16 +537,19 @@ namespace JTAG {
         return initialize();
     }
 
-    std::string ScanController::getPinPort(const std::string& pinName) const {
-        return deviceModel ? deviceModel->getPinPort(pinName) : "";
+    std::string_view ScanController::getPinPort(const std::string& pinName) const {
+        const DeviceModel* model = session.getDeviceModel();
+        return model ? model->getPinPort(pinName) : std::string_view();
     }
 
-    std::string ScanController::getPinType(const std::string& pinName) const {
-        return deviceModel ? deviceModel->getPinType(pinName) : "";
+    PinType ScanController::getPinType(const std::string& pinName) const {
+        const DeviceModel* model = session.getDeviceModel();
+        return model ? model->getPinType(pinName) : PinType::UNKNOWN;
     }
 
-    std::string ScanController::getPinNumber(const std::string& pinName) const {
-        return deviceModel ? deviceModel->getPinNumber(pinName) : "";
+    std::string_view ScanController::getPinNumber(const std::string& pinName) const {
+        const DeviceModel* model = session.getDeviceModel();
+        return model ? model->getPinNumber(pinName) : std::string_view();
     }
 
     // ============================================================================
@@ -556,31 +558,53 @@ namespace JTAG {
 
     void ScanController::startPolling() {
         qDebug() << "[ScanController::startPolling] Called";
-        if (scanWorker && !workerThread->isRunning()) {
-            qDebug() << "[ScanController::startPolling] Starting worker thread";
+        if (scanWorker && !executor.isPeriodicActive()) {
+            qDebug() << "[ScanController::startPolling] Starting polling on the engine executor";
             scanWorker->start();
-            workerThread->start();
+            ScanWorker* worker = scanWorker;
+            executor.startPeriodic([worker]() { return worker->pollCycle(); }, worker->getScheduler());
         } else {
             qDebug() << "[ScanController::startPolling] SKIPPED - worker:" << (scanWorker != nullptr)
-                     << "running:" << (workerThread ? workerThread->isRunning() : false);
+                     << "running:" << executor.isPeriodicActive();
         }
     }
 
     void ScanController::stopPolling() {
         if (scanWorker) {
             scanWorker->stop();
-            workerThread->quit();
-            workerThread->wait();
+            executor.stopPeriodic();   // Espera al ciclo en curso
         }
     }
 
+    bool ScanController::isPolling() const {
+        return executor.isPeriodicActive();
+    }
+
     void ScanController::setPollInterval(int ms) {
         pollIntervalMs = ms;
+        setPollPeriod(std::chrono::milliseconds(ms));
+    }
+
+    void ScanController::setPollPeriod(std::chrono::nanoseconds period) {
+        schedulerOptions.period = period;
         if (scanWorker) {
-            scanWorker->setPollInterval(ms);
+            scanWorker->setPollPeriod(period);
         }
     }
 
+    void ScanController::setSchedulerOptions(const SchedulerOptions& options) {
+        std::chrono::nanoseconds period = schedulerOptions.period;
+        schedulerOptions = options;
+        schedulerOptions.period = period;
+        if (scanWorker) {
+            scanWorker->setSchedulerOptions(schedulerOptions);
+        }
+    }
+
+    SchedulerStats ScanController::getSchedulerStats() const {
+        return scanWorker ? scanWorker->getSchedulerStats() : SchedulerStats{};
+    }
+
     void ScanController::forceReloadInstruction() {
         if (scanWorker) {
             scanWorker->forceReloadInstruction();
@@ -588,106 +612,156 @@ namespace JTAG {
     }
 
     void ScanController::setPinAsync(const std::string& pinName, PinLevel level) {
-        if (!deviceModel || !scanWorker) return;
+        const DeviceModel* model = session.getDeviceModel();
+        if (!model || !scanWorker) return;
 
-        auto pinInfo = deviceModel->getPinInfo(pinName);
+        auto pinInfo = model->getPinInfo(pinName);
         if (pinInfo && pinInfo->outputCell >= 0) {
             scanWorker->markDirtyPin(pinInfo->outputCell, level);
         }
     }
 
-    // Slot para recibir datos del worker
-    // FASE 2: Recibe shared_ptr, NO hace copia, solo re-emite el puntero
-    void ScanController::onPinsUpdated(std::shared_ptr<const std::vector<PinLevel>> pins) {
-        qDebug() << "[ScanController::onPinsUpdated] Received" << pins->size() << "pins from worker (shared_ptr)";
-        // Actualizar cache local si es necesario
-        // Reemitir señal para la GUI (esto hace que MainWindow la reciba)
-        // NO COPIA: solo incrementa refcount del shared_ptr
-        emit pinsDataReady(pins);
-        qDebug() << "[ScanController::onPinsUpdated] Signal pinsDataReady emitted";
+    void ScanController::setContentionDetection(bool enabled, bool autoSafeState) {
+        contentionEnabled = enabled;
+        contentionSafeState = autoSafeState;
+        if (scanWorker) {
+            scanWorker->setContentionDetection(enabled, autoSafeState);
+        }
     }
 
-    void ScanController::onWorkerError(QString message) {
-        qWarning() << "Worker error:" << message;
-        // Reemitir error para la GUI
-        emit errorOccurred(message);
+    bool ScanController::armTrigger(const TriggerSpec& spec, QString* error) {
+        if (!scanWorker) {
+            if (error) *error = "Scan worker not initialized";
+            return false;
+        }
+        return scanWorker->armTrigger(spec, error);
     }
 
-    void ScanController::onWorkerStopped() {
-        qDebug() << "[ScanController::onWorkerStopped] Worker stopped (single-shot complete)";
-        // Detener el thread cuando el worker se detiene (para modo single-shot)
-        if (workerThread && workerThread->isRunning()) {
-            workerThread->quit();
-            workerThread->wait();
-            qDebug() << "[ScanController::onWorkerStopped] Thread stopped";
+    void ScanController::disarmTrigger() {
+        if (scanWorker) {
+            scanWorker->disarmTrigger();
         }
     }
 
-    void ScanController::createMockDeviceModel() {
-        qDebug() << "[ScanController] Creating mock DeviceModel for MockAdapter";
+    bool ScanController::isTriggerArmed() const {
+        return scanWorker && scanWorker->isTriggerArmed();
+    }
 
-        // Crear BSDL data simulado para MockAdapter
-        BSDLData mockData;
-        mockData.entityName = "MOCK_DEVICE";
-        mockData.idCode = 0x12345678;
-        mockData.boundaryLength = 256;  // 256 bits de BSR
-        mockData.instructionLength = 8;
-        mockData.physicalPinMap = "BGA";
+    bool ScanController::resolveWatchCells(const std::vector<std::string>& pinNames, WatchSpec& spec) {
+        const DeviceModel* model = session.getDeviceModel();
+        if (!model || !scanWorker) {
+            emit errorOccurred("Pin watch requires an initialized device");
+            return false;
+        }
+        spec.cells.clear();
+        for (const auto& name : pinNames) {
+            auto pinInfo = model->getPinInfo(name);
+            if (!pinInfo || pinInfo->inputCell < 0) {
+                emit errorOccurred(QString("Pin %1 has no input cell to watch").arg(QString::fromStdString(name)));
+                return false;
+            }
+            spec.cells.push_back(static_cast<size_t>(pinInfo->inputCell));
+        }
+        return true;
+    }
 
-        // Agregar instrucciones básicas
-        Instruction sampInstr;
-        sampInstr.name = "SAMPLE";
-        sampInstr.opcodes.push_back("00000001");
-        mockData.instructions.push_back(sampInstr);
+    uint64_t ScanController::watchPins(const std::vector<std::string>& pinNames, WatchSpec spec, WatchCallback callback) {
+        if (!resolveWatchCells(pinNames, spec)) return 0;
 
-        Instruction extestInstr;
-        extestInstr.name = "EXTEST";
-        extestInstr.opcodes.push_back("00000000");
-        mockData.instructions.push_back(extestInstr);
+        std::string error;
+        uint64_t id = scanWorker->getPinWatcher().subscribe(spec, std::move(callback), &error);
+        if (id == 0) emit errorOccurred(QString::fromStdString(error));
+        return id;
+    }
+
+    std::future<WatchEvent> ScanController::waitForPins(const std::vector<std::string>& pinNames, WatchSpec spec) {
+        if (!resolveWatchCells(pinNames, spec)) return {};
 
-        // Crear 32 pines simulados (8 bits por pin = 256 bits totales)
-        for (int i = 0; i < 32; i++) {
-            // Celda INPUT para cada pin
-            BoundaryCell inputCell;
-            inputCell.cellNumber = i * 8;
-            inputCell.portName = "MOCK_PIN_" + std::to_string(i);
-            inputCell.function = CellFunction::INPUT;
-            inputCell.safeValue = SafeBit::DONT_CARE;
-            inputCell.controlCell = -1;
-            inputCell.disableValue = SafeBit::DONT_CARE;
-            mockData.boundaryCells.push_back(inputCell);
+        std::string error;
+        auto future = scanWorker->getPinWatcher().watchOnce(spec, &error);
+        if (!future.valid()) emit errorOccurred(QString::fromStdString(error));
+        return future;
+    }
 
-            // Agregar pin mapping (nombre de pin → número físico)
-            mockData.pinMaps["MOCK_PIN_" + std::to_string(i)].push_back(std::to_string(i + 1));
+    bool ScanController::unwatch(uint64_t id) {
+        return scanWorker && scanWorker->getPinWatcher().unsubscribe(id);
+    }
+
+    bool ScanController::requestBurst(const BurstSpec& spec) {
+        if (!scanWorker || !session.getDeviceModel()) {
+            emit errorOccurred("Burst capture requires an initialized device");
+            return false;
+        }
+        if (spec.samples == 0) {
+            emit errorOccurred("Burst capture needs at least one sample");
+            return false;
+        }
+        // La ráfaga solo corre con SAMPLE cargado; no se cambia de modo por ella
+        // (pasar de EXTEST a SAMPLE soltaría los pines que se están conduciendo)
+        const ScanMode mode = scanWorker->getScanMode();
+        if (mode != ScanMode::SAMPLE && mode != ScanMode::SAMPLE_SINGLE_SHOT) {
+            emit errorOccurred("Burst capture requires SAMPLE mode");
+            return false;
         }
+        scanWorker->requestBurst(spec);
+        startPolling();
+        return true;
+    }
 
-        // Crear DeviceModel y cargar datos simulados
-        deviceModel = std::make_unique<JTAG::DeviceModel>();
-        deviceModel->loadFromData(mockData);
+    void ScanController::abortBurst() {
+        if (scanWorker) {
+            scanWorker->abortBurst();
+        }
+    }
 
-        // Configurar IDCODE detectado
-        detectedIDCODE = 0x12345678;
+    // Slot para recibir datos del worker
+    // FASE 2: Recibe shared_ptr, NO hace copia, solo re-emite el puntero
+    void ScanController::onPinsUpdated(std::shared_ptr<const PinSnapshot> snapshot) {
+        qDebug() << "[ScanController::onPinsUpdated] Received" << snapshot->pins.size() << "pins from worker (shared_ptr), seq"
+                 << snapshot->sequence;
+        // Actualizar cache local si es necesario
+        // Reemitir señal para la GUI (esto hace que MainWindow la reciba)
+        // NO COPIA: solo incrementa refcount del shared_ptr
+        emit pinsDataReady(snapshot);
+        qDebug() << "[ScanController::onPinsUpdated] Signal pinsDataReady emitted";
+    }
+
+    void ScanController::onWorkerError(QString message) {
+        qWarning() << "Worker error:" << message;
+        // Reemitir error para la GUI
+        emit errorOccurred(message);
+    }
 
-        qDebug() << "[ScanController] Created mock DeviceModel with"
-                 << deviceModel->getAllPins().size() << "pins";
+    void ScanController::onWorkerStopped() {
+        // Single-shot: pollCycle() devolvió false y el executor ya retiró el trabajo
+        qDebug() << "[ScanController::onWorkerStopped] Worker stopped (single-shot complete)";
     }
 
     bool ScanController::isNoTargetDetected() const {
-        if (!engine) return false;
-        return engine->isNoTargetDetected();
+        return executor.call([](JtagSession& s) {
+            BoundaryScanEngine* engine = s.getEngine();
+            return engine ? engine->isNoTargetDetected() : false;
+        });
     }
+
     void ScanController::setScanMode(ScanMode mode) {
         if (scanWorker) {
             scanWorker->setScanMode(mode);
 
-            // Auto-iniciar el thread si el modo requiere polling y no está corriendo
+            // Sincronizar modo con el engine en su hilo (puede haber un ciclo en curso)
+            executor.post([mode](JtagSession& s) {
+                if (BoundaryScanEngine* engine = s.getEngine()) {
+                    engine->setOperationMode(ScanWorker::toOperationMode(mode));
+                }
+            });
+
+            // Auto-iniciar el polling si el modo lo requiere y no está corriendo
             // BYPASS no necesita polling (modo estático)
             bool needsPolling = (mode != ScanMode::BYPASS);
 
-            if (needsPolling && workerThread && !workerThread->isRunning()) {
-                qDebug() << "[ScanController] Auto-starting thread for mode:" << static_cast<int>(mode);
-                scanWorker->start();
-                workerThread->start();
+            if (needsPolling && !executor.isPeriodicActive()) {
+                qDebug() << "[ScanController] Auto-starting polling for mode:" << static_cast<int>(mode);
+                startPolling();
             }
         }
     }
@@ -1,21 +1,42 @@
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
 #include <map>
 #include <filesystem>
 #include <QObject>
-#include <QThread>
+#include <QThreadPool>
 
 #include "../core/BoundaryScanEngine.h"
 #include "../bsdl/DeviceModel.h"
+#include "../bsdl/ModelCache.h"
+#include "../bsdl/BsdlLibrary.h"
 #include "../hal/IJTAGAdapter.h"       // Define AdapterDescriptor
 #include "../hal/factory/AdapterFactory.h"
+#include "../bus/ParallelNorFlash.h"
+#include "../bus/SpiMaster.h"
+#include "../bus/I2cMaster.h"
+#include "../interconnect/InterconnectTest.h"
+#include "../interconnect/Netlist.h"
 #include "ScanWorker.h"
+#include "BsdlLoadTask.h"
+#include "JtagSession.h"
+#include "EngineExecutor.h"
 
 namespace JTAG {
 
+    /**
+     * @brief Controlador de la GUI: JtagSession + worker de polling + señales Qt
+     *
+     * Las operaciones síncronas (adaptador, BSDL, secuencias de instrucción,
+     * vectores) se delegan en JtagSession a través del EngineExecutor: su hilo
+     * es el único que toca adaptador y engine, también para los ciclos de
+     * polling del ScanWorker. Aquí se añade parar el polling antes de
+     * sustituir engine o modelo, la carga asíncrona de BSDL y la reemisión de
+     * señales hacia la GUI. Los métodos se llaman desde el hilo del controlador.
+     */
     class ScanController : public QObject {
         Q_OBJECT
     public:
@@ -41,6 +62,21 @@ namespace JTAG {
         // Gestión de Dispositivo
         uint32_t detectDevice();
         bool loadBSDL(const std::filesystem::path& bsdlPath);
+        // Carga en el pool de carga (no bloquea): cancela la carga anterior, informa con
+        // bsdlLoadProgress/bsdlLoadFinished. 'prepare' corre en el mismo hilo tras el modelo
+        std::shared_ptr<BsdlLoadTask> loadBSDLAsync(const std::filesystem::path& bsdlPath,
+                                                    BsdlLoadTask::Prepare prepare = {});
+        // Instala el modelo de la carga en curso si terminó bien (hilo del controlador)
+        bool adoptLoadedBSDL(BsdlLoadTask& task);
+        void cancelBSDLLoad();
+        // Directorio de modelos compilados (.jbmc); vacío = parsear siempre
+        void setModelCacheDirectory(const std::filesystem::path& dir);
+        ModelCache::Stats getModelCacheStats() const;
+
+        // Biblioteca de BSDL indexada por IDCODE (directorios + índice en disco)
+        BsdlLibrary& getBsdlLibrary() { return bsdlLibrary; }
+        // Candidatos para un IDCODE; si no hay ninguno, actualiza el índice y repite
+        std::vector<BsdlLibraryEntry> findBSDLCandidates(uint32_t idcode);
         std::string getDeviceName() const;
         std::string getPackageInfo() const;
 
@@ -57,17 +93,44 @@ namespace JTAG {
         bool samplePins();
 
         // Información adicional de pines
-        std::string getPinPort(const std::string& pinName) const;
-        std::string getPinType(const std::string& pinName) const;
-        std::string getPinNumber(const std::string& pinName) const;
+        // Vistas sobre el DeviceModel cargado (válidas hasta el próximo loadBSDL)
+        std::string_view getPinPort(const std::string& pinName) const;
+        PinType getPinType(const std::string& pinName) const;
+        std::string_view getPinNumber(const std::string& pinName) const;
 
         // Avanzado
         bool setPins(const std::map<std::string, PinLevel>& pins);
         std::map<std::string, PinLevel> getPins(const std::vector<std::string>& pinNames) const;
         bool runTest(size_t numCycles);
 
-        uint32_t getIDCODE() const { return detectedIDCODE; }
-        bool isInitialized() const { return initialized; }
+        // Vectores compilados (SVF → .jvec) ejecutados directamente sobre el adaptador
+        bool compileSVF(const std::filesystem::path& svfPath, const std::filesystem::path& jvecPath);
+        bool runVectorFile(const std::filesystem::path& jvecPath);
+
+        // Grabación de sesión (traza binaria .jtr de todas las transacciones JTAG)
+        bool startRecording(const std::filesystem::path& tracePath);
+        void stopRecording();
+        bool isRecording() const;
+        static bool exportTraceToSVF(const std::filesystem::path& tracePath, const std::filesystem::path& svfPath);
+
+        // Buses externos vía EXTEST (NOR paralela, SPI, I2C). Detienen el polling,
+        // entran en EXTEST y ejecutan 'operation' como un único comando del executor
+        // (nada se intercala con el tráfico del bus); al terminar, la última imagen
+        // del bus pasa al BSR del engine
+        bool runParallelFlash(const NorFlashPins& pins, const std::function<bool(ParallelNorFlash&)>& operation);
+        bool runSpiMaster(const SpiPins& pins, int mode, const std::function<bool(SpiMaster&)>& operation);
+        bool runI2cMaster(const I2cPins& pins, const std::function<bool(I2cMaster&)>& operation);
+
+        // Test de interconexión (EXTEST, patrones de conteo en un solo lote)
+        bool runInterconnectTest(const std::vector<InterconnectNet>& nets, InterconnectReport& report);
+
+        // Netlist de placa (CSV/JSON). refdes = designador del dispositivo escaneado
+        bool loadNetlist(const std::filesystem::path& path, const std::string& refdes);
+        const BoardNetlist* getBoardNetlist() const { return boardNetlist.get(); }
+        bool runInterconnectTest(InterconnectReport& report);   // Redes locales de la netlist
+
+        uint32_t getIDCODE() const { return session.getIDCODE(); }
+        bool isInitialized() const { return session.isInitialized(); }
 
         bool enterSAMPLE();
         bool enterEXTEST();
@@ -85,7 +148,10 @@ namespace JTAG {
         bool initializeDevice();
 
         // NUEVO: Exponer DeviceModel para visualización
-        const DeviceModel* getDeviceModel() const { return deviceModel.get(); }
+        const DeviceModel* getDeviceModel() const { return session.getDeviceModel(); }
+
+        // Cola de comandos hacia el hilo propietario del adaptador y el engine
+        EngineExecutor& getExecutor() { return executor; }
 
         // Target detection - check if BSR shows no target (all 0xFF)
         bool isNoTargetDetected() const;
@@ -93,38 +159,89 @@ namespace JTAG {
         // Threading control
         void startPolling();
         void stopPolling();
+        bool isPolling() const;
         void setPollInterval(int ms);
+        void setPollPeriod(std::chrono::nanoseconds period);   // Periodos < 1 ms (usar con spinWindow)
+        // Espera híbrida, SCHED_FIFO y afinidad del hilo de polling (el periodo se conserva)
+        void setSchedulerOptions(const SchedulerOptions& options);
+        SchedulerStats getSchedulerStats() const;
         void forceReloadInstruction();  // Force reload current instruction after JTAG reset
 
         // Thread-safe pin control (marca como dirty sin bloquear)
         void setPinAsync(const std::string& pinName, PinLevel level);
 
+        // Detección de contención / pin bloqueado en EXTEST (ver ContentionDetector)
+        // (se conserva para workers recreados)
+        void setContentionDetection(bool enabled, bool autoSafeState = false);
+        bool isContentionDetectionEnabled() const { return contentionEnabled; }
+        bool isContentionSafeStateEnabled() const { return contentionSafeState; }
+
+        // Captura con disparo (ver TriggerEngine); los términos usan índices de celda BSR
+        bool armTrigger(const TriggerSpec& spec, QString* error = nullptr);
+        void disarmTrigger();
+        bool isTriggerArmed() const;
+
+        // Suscripciones a pines por nombre (celda de entrada; pinNames[0] = bit 0).
+        // Se evalúan en cada captura del polling; los callbacks llegan en el hilo
+        // despachador del PinWatcher. Devuelven 0 / future inválido si algún pin no es legible.
+        uint64_t watchPins(const std::vector<std::string>& pinNames, WatchSpec spec, WatchCallback callback);
+        std::future<WatchEvent> waitForPins(const std::vector<std::string>& pinNames, WatchSpec spec);
+        bool unwatch(uint64_t id);
+
+        // Ráfaga de capturas SAMPLE a máxima velocidad (ver BurstSampler). Arranca el
+        // polling si está parado; false si el modo de escaneo no es SAMPLE.
+        bool requestBurst(const BurstSpec& spec);
+        void abortBurst();
+
     signals:
         // FASE 2: shared_ptr evita copias profundas en la cadena Worker→Controller→MainWindow
-        void pinsDataReady(std::shared_ptr<const std::vector<PinLevel>> pins);
+        void pinsDataReady(std::shared_ptr<const PinSnapshot> snapshot);
         void errorOccurred(QString message);
+        void pinFaultDetected(QString pinName, bool drivenHigh, bool safeStateApplied);
+        void triggerCaptured(std::shared_ptr<const TriggerCapture> capture);
+        void burstCaptured(std::shared_ptr<const TriggerCapture> capture, double samplesPerSecond);
+        // Emitidas desde el pool de carga (conexión en cola hacia la GUI)
+        void bsdlLoadProgress(quint64 taskId, int percent, QString stage);
+        void bsdlLoadFinished(quint64 taskId);
 
     private slots:
         // Slots para recibir señales del worker y re-emitirlas
-        void onPinsUpdated(std::shared_ptr<const std::vector<PinLevel>> pins);
+        void onPinsUpdated(std::shared_ptr<const PinSnapshot> snapshot);
         void onWorkerError(QString message);
         void onWorkerStopped();  // Handle worker stop (for single-shot)
 
     private:
         // Helper methods
-        void createMockDeviceModel();  // Auto-genera modelo para MockAdapter
-
-        std::unique_ptr<IJTAGAdapter> adapter;
-        std::unique_ptr<BoundaryScanEngine> engine;
-        std::unique_ptr<DeviceModel> deviceModel;
-
-        // Threading
-        QThread* workerThread = nullptr;
+        bool prepareBusAccess();       // Polling parado + EXTEST (para maestros de bus)
+        // Crea el maestro sobre el BSR del engine y ejecuta configure + operation en el executor
+        template <typename Master, typename Configure>
+        bool runBusMaster(Configure configure, const std::function<bool(Master&)>& operation);
+        bool resolveWatchCells(const std::vector<std::string>& pinNames, WatchSpec& spec);
+        void installDeviceModel(std::unique_ptr<DeviceModel> model);   // Para el polling antes
+        void releaseWorker();   // Para el polling y destruye el worker (engine o modelo cambian)
+        void runLoadTask(BsdlLoadTask& task);   // Hilo del pool de carga
+
+        JtagSession session;                   // Adaptador, engine, modelo y caché de modelos
+        mutable EngineExecutor executor{ session };    // Único hilo que usa adaptador y engine
+        BsdlLibrary bsdlLibrary;
+
+        // Carga asíncrona de BSDL: solo la última tarea puede adoptarse
+        QThreadPool loadPool;
+        std::shared_ptr<BsdlLoadTask> currentLoad;
+        uint64_t loadSequence = 0;
+
+        // Netlist importada; el índice se reconstruye si cambia el DeviceModel
+        RawNetlist netlist;
+        std::string netlistRefdes;
+        std::unique_ptr<BoardNetlist> boardNetlist;
+        uint64_t boardNetlistGeneration = 0;   // getModelGeneration() con el que se construyó
+
+        // Polling: los ciclos del worker corren en el hilo del executor
         ScanWorker* scanWorker = nullptr;
         int pollIntervalMs = 100;
-
-        uint32_t detectedIDCODE;
-        bool initialized;
+        SchedulerOptions schedulerOptions;     // Se aplica también a workers recreados
+        bool contentionEnabled = false;
+        bool contentionSafeState = false;
     };
 
 } // namespace JTAG
@@ -0,0 +1,740 @@
+#include "ScanControllerRpc.h"
+
+#include <chrono>
+#include <cstdio>
+#include <QDir>
+#include <QTemporaryFile>
+#include <QThread>
+
+namespace JTAG {
+
+    namespace {
+
+        constexpr auto WAIT_SLICE = std::chrono::milliseconds(100);
+        constexpr auto BURST_MARGIN = std::chrono::seconds(10);    // Sobre la duración pedida
+
+        [[noreturn]] void fail(const std::string& message) {
+            throw RpcError{ RpcErrorCode::OPERATION_FAILED, message };
+        }
+
+        [[noreturn]] void invalidParams(const std::string& message) {
+            throw RpcError{ RpcErrorCode::INVALID_PARAMS, message };
+        }
+
+        const std::string& requireString(const JsonValue& params, std::string_view key) {
+            const JsonValue& value = params[key];
+            if (!value.isString() || value.asString().empty()) {
+                invalidParams("Missing string parameter '" + std::string(key) + "'");
+            }
+            return value.asString();
+        }
+
+        // Lista opcional de nombres de pin (ausente = todos)
+        std::vector<std::string> stringList(const JsonValue& params, std::string_view key) {
+            std::vector<std::string> names;
+            const JsonValue& value = params[key];
+            if (value.isNull()) return names;
+            if (!value.isArray()) invalidParams("'" + std::string(key) + "' must be an array of pin names");
+            for (const JsonValue& item : value.asArray()) {
+                if (!item.isString()) invalidParams("'" + std::string(key) + "' must be an array of pin names");
+                names.push_back(item.asString());
+            }
+            return names;
+        }
+
+        // Array de bytes 0..255 (ausente = vacío)
+        std::vector<uint8_t> byteList(const JsonValue& params, std::string_view key) {
+            std::vector<uint8_t> bytes;
+            const JsonValue& value = params[key];
+            if (value.isNull()) return bytes;
+            if (!value.isArray()) invalidParams("'" + std::string(key) + "' must be an array of bytes");
+            for (const JsonValue& item : value.asArray()) {
+                if (!item.isNumber() || item.asInt(-1) < 0 || item.asInt(-1) > 255) {
+                    invalidParams("'" + std::string(key) + "' must be an array of bytes");
+                }
+                bytes.push_back(static_cast<uint8_t>(item.asInt()));
+            }
+            return bytes;
+        }
+
+        JsonValue byteArray(const std::vector<uint8_t>& bytes) {
+            JsonValue array = JsonValue::array();
+            for (uint8_t byte : bytes) array.push(static_cast<uint64_t>(byte));
+            return array;
+        }
+
+        // Entero sin signo en [0, max]
+        uint64_t requireCount(const JsonValue& params, std::string_view key, uint64_t max) {
+            const JsonValue& value = params[key];
+            if (!value.isNumber() || value.asInt(-1) < 0 || static_cast<uint64_t>(value.asInt()) > max) {
+                invalidParams("'" + std::string(key) + "' must be an integer in 0.." + std::to_string(max));
+            }
+            return static_cast<uint64_t>(value.asInt());
+        }
+
+        // 0/1, true/false o "0"/"1"/"L"/"H"
+        PinLevel parseLevel(const std::string& pin, const JsonValue& value) {
+            if (value.isBool()) return value.asBool() ? PinLevel::HIGH : PinLevel::LOW;
+            if (value.isNumber() && (value.asInt() == 0 || value.asInt() == 1)) {
+                return value.asInt() ? PinLevel::HIGH : PinLevel::LOW;
+            }
+            if (value.isString()) {
+                const std::string& text = value.asString();
+                if (text == "1" || text == "H" || text == "h") return PinLevel::HIGH;
+                if (text == "0" || text == "L" || text == "l") return PinLevel::LOW;
+            }
+            invalidParams("Invalid level for pin " + pin + " (expected 0 or 1)");
+        }
+
+        JsonValue levelJson(std::optional<PinLevel> level) {
+            if (!level) return nullptr;
+            switch (*level) {
+            case PinLevel::HIGH: return "1";
+            case PinLevel::LOW:  return "0";
+            default:             return "Z";
+            }
+        }
+
+        std::string hex32(uint32_t value) {
+            char text[11];
+            std::snprintf(text, sizeof(text), "0x%08X", value);
+            return text;
+        }
+
+        ScanMode parseMode(const std::string& name) {
+            if (name == "SAMPLE") return ScanMode::SAMPLE;
+            if (name == "SAMPLE_SINGLE_SHOT") return ScanMode::SAMPLE_SINGLE_SHOT;
+            if (name == "EXTEST") return ScanMode::EXTEST;
+            if (name == "INTEST") return ScanMode::INTEST;
+            if (name == "BYPASS") return ScanMode::BYPASS;
+            invalidParams("Unknown mode: " + name);
+        }
+
+        WatchCondition parseCondition(const std::string& name) {
+            if (name.empty() || name == "change") return WatchCondition::ANY_CHANGE;
+            if (name == "rising") return WatchCondition::RISING;
+            if (name == "falling") return WatchCondition::FALLING;
+            if (name == "equals") return WatchCondition::EQUALS;
+            invalidParams("Unknown watch condition: " + name);
+        }
+
+        // Pausa el polling mientras dura la operación (el TAP es de la petición)
+        class PollingPause {
+        public:
+            explicit PollingPause(ScanController& controller)
+                : controller(controller), wasPolling(controller.isPolling()) {
+                controller.stopPolling();
+            }
+            ~PollingPause() {
+                if (wasPolling) controller.startPolling();
+            }
+        private:
+            ScanController& controller;
+            bool wasPolling;
+        };
+
+    } // namespace
+
+    // ============================================================================
+    // CICLO DE VIDA
+    // ============================================================================
+
+    ScanControllerRpc::ScanControllerRpc(ScanController& controller)
+        : controller(controller)
+        , server(std::make_shared<RpcServer>())
+    {
+        registerMethods();
+
+        // Resultado de capture.burst (hilo del controlador)
+        QObject::connect(&controller, &ScanController::burstCaptured, &signalContext,
+            [this](std::shared_ptr<const TriggerCapture> capture, double samplesPerSecond) {
+                std::shared_ptr<std::promise<JsonValue>> promise;
+                std::vector<std::string> names;
+                {
+                    std::lock_guard<std::mutex> lock(stateMutex);
+                    promise = std::move(pendingBurst);
+                    names = std::move(burstPins);
+                }
+                if (!promise) return;   // Ráfaga pedida desde la GUI
+
+                const DeviceModel* model = this->controller.getDeviceModel();
+                JsonValue pins = JsonValue::object();
+                for (const auto& name : names) {
+                    auto info = model ? model->getPinInfo(name) : std::nullopt;
+                    const int cell = !info ? -1 : info->inputCell >= 0 ? info->inputCell : info->outputCell;
+                    if (cell < 0 || static_cast<size_t>(cell) >= capture->bsrLength) {
+                        pins.set(name, nullptr);
+                        continue;
+                    }
+                    // Un carácter por muestra, en orden temporal
+                    std::string bits(capture->sampleCount, '0');
+                    for (size_t i = 0; i < capture->sampleCount; ++i) {
+                        if ((capture->sample(i)[cell / 8] >> (cell % 8)) & 1) bits[i] = '1';
+                    }
+                    pins.set(name, std::move(bits));
+                }
+
+                JsonValue result = JsonValue::object();
+                result.set("samples", static_cast<uint64_t>(capture->sampleCount));
+                result.set("samplesPerSecond", samplesPerSecond);
+                if (!capture->timestampsNs.empty()) {
+                    result.set("startNs", capture->timestampsNs.front());
+                    result.set("endNs", capture->timestampsNs.back());
+                }
+                result.set("pins", std::move(pins));
+                promise->set_value(std::move(result));
+            });
+    }
+
+    ScanControllerRpc::~ScanControllerRpc() {
+        stop();
+    }
+
+    bool ScanControllerRpc::listenTcp(uint16_t port) {
+        return server->listenTcp(port);
+    }
+
+    bool ScanControllerRpc::listenUnix(const std::filesystem::path& path) {
+        return server->listenUnix(path);
+    }
+
+    void ScanControllerRpc::stop() {
+        server->stop();
+
+        // Sin clientes ya no hay a quién notificar: retirar sus suscripciones
+        std::map<uint64_t, uint64_t> remaining;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            remaining.swap(watches);
+        }
+        for (const auto& [id, clientId] : remaining) controller.unwatch(id);
+    }
+
+    // ============================================================================
+    // DESPACHO AL HILO DEL CONTROLADOR
+    // ============================================================================
+
+    JsonValue ScanControllerRpc::onController(Task task) {
+        if (QThread::currentThread() == signalContext.thread()) return task();
+
+        auto promise = std::make_shared<std::promise<JsonValue>>();
+        auto future = promise->get_future();
+        // Contexto propio (mismo hilo): Qt descarta la tarea si este objeto se destruye antes
+        QMetaObject::invokeMethod(&signalContext, [task = std::move(task), promise]() {
+            try {
+                promise->set_value(task());
+            }
+            catch (...) {
+                promise->set_exception(std::current_exception());
+            }
+        }, Qt::QueuedConnection);
+
+        // La GUI puede estar cerrando (y esperando a este hilo en stop())
+        while (future.wait_for(WAIT_SLICE) != std::future_status::ready) {
+            if (server->isStopping()) {
+                throw RpcError{ RpcErrorCode::INTERNAL_ERROR, "Server shutting down" };
+            }
+        }
+        return future.get();
+    }
+
+    void ScanControllerRpc::registerOnController(const std::string& name,
+                                                 std::function<JsonValue(const JsonValue& params)> handler) {
+        server->registerMethod(name, [this, handler](const JsonValue& params, const RpcContext&) {
+            // Copia de params: la tarea puede sobrevivir a la petición si el servidor se detiene
+            return onController([handler, params]() { return handler(params); });
+        });
+    }
+
+    // ============================================================================
+    // MÉTODOS
+    // ============================================================================
+
+    void ScanControllerRpc::registerMethods() {
+        auto deviceInfo = [&c = controller]() {
+            const DeviceModel* model = c.getDeviceModel();
+            if (!model) fail("No BSDL loaded");
+            JsonValue device = JsonValue::object();
+            device.set("name", model->getDeviceName());
+            device.set("package", model->getPackageInfo());
+            device.set("idcode", hex32(model->getIDCODE()));
+            device.set("irLength", static_cast<uint64_t>(model->getIRLength()));
+            device.set("bsrLength", static_cast<uint64_t>(model->getBSRLength()));
+            device.set("pins", static_cast<uint64_t>(model->getPinCount()));
+            device.set("initialized", c.isInitialized());
+            return device;
+        };
+
+        // ---------- Adaptador ----------
+        registerOnController("adapter.list", [&c = controller](const JsonValue&) {
+            JsonValue adapters = JsonValue::array();
+            for (const auto& descriptor : c.getDetectedAdapters()) {
+                JsonValue entry = JsonValue::object();
+                entry.set("type", AdapterFactory::typeToString(descriptor.type));
+                entry.set("name", descriptor.name);
+                entry.set("serial", descriptor.serialNumber);
+                entry.set("id", descriptor.deviceID);
+                adapters.push(std::move(entry));
+            }
+            return adapters;
+        });
+
+        // {type, id?, clockHz?}; id como en adapter.list ("JLINK_<serie>", "REPLAY_<traza>")
+        registerOnController("adapter.connect", [&c = controller](const JsonValue& params) {
+            AdapterDescriptor descriptor;
+            try {
+                descriptor.type = AdapterFactory::stringToType(requireString(params, "type"));
+            }
+            catch (const std::runtime_error& e) {
+                invalidParams(e.what());
+            }
+            descriptor.deviceID = params["id"].asString();
+            const auto clock = static_cast<uint32_t>(params["clockHz"].asInt(1000000));
+
+            if (!c.connectAdapter(descriptor, clock)) fail("Cannot connect adapter");
+            JsonValue result = JsonValue::object();
+            result.set("info", c.getAdapterInfo());
+            return result;
+        });
+
+        registerOnController("adapter.disconnect", [&c = controller](const JsonValue&) {
+            c.disconnectAdapter();
+            return JsonValue::object();
+        });
+
+        // ---------- Dispositivo ----------
+        registerOnController("device.detect", [&c = controller](const JsonValue&) {
+            const uint32_t idcode = c.detectDevice();
+            if (idcode == 0) fail("No valid IDCODE (check target power and cabling)");
+
+            JsonValue candidates = JsonValue::array();
+            for (const auto& entry : c.findBSDLCandidates(idcode)) {
+                JsonValue candidate = JsonValue::object();
+                candidate.set("path", entry.path.u8string());
+                candidate.set("entity", entry.entityName);
+                candidates.push(std::move(candidate));
+            }
+            JsonValue result = JsonValue::object();
+            result.set("idcode", hex32(idcode));
+            result.set("candidates", std::move(candidates));
+            return result;
+        });
+
+        registerOnController("device.loadBsdl", [&c = controller, deviceInfo](const JsonValue& params) {
+            if (!c.loadBSDL(std::filesystem::u8path(requireString(params, "path")))) fail("Cannot load BSDL");
+            return deviceInfo();
+        });
+
+        registerOnController("device.unloadBsdl", [&c = controller](const JsonValue&) {
+            c.unloadBSDL();
+            return JsonValue::object();
+        });
+
+        registerOnController("device.info", [deviceInfo](const JsonValue&) {
+            return deviceInfo();
+        });
+
+        // Secuencia segura SAMPLE/PRELOAD → EXTEST y creación del worker
+        registerOnController("device.initialize", [&c = controller, deviceInfo](const JsonValue&) {
+            if (!c.initialize()) fail("Device initialization failed");
+            return deviceInfo();
+        });
+
+        registerOnController("mode.set", [&c = controller](const JsonValue& params) {
+            const ScanMode mode = parseMode(requireString(params, "mode"));
+            if (!c.isInitialized()) fail("Device not initialized (call device.initialize)");
+            c.setScanMode(mode);
+            JsonValue result = JsonValue::object();
+            result.set("polling", c.isPolling());
+            return result;
+        });
+
+        // ---------- Pines ----------
+        registerOnController("pins.list", [&c = controller](const JsonValue&) {
+            const DeviceModel* model = c.getDeviceModel();
+            if (!model) fail("No BSDL loaded");
+            JsonValue pins = JsonValue::array();
+            for (const PinView pin : model->getAllPins()) {
+                JsonValue entry = JsonValue::object();
+                entry.set("name", std::string(pin.name));
+                entry.set("number", std::string(pin.pinNumber));
+                entry.set("port", std::string(pin.port));
+                entry.set("type", pinTypeName(pin.type));
+                entry.set("drivable", pin.outputCell >= 0);
+                pins.push(std::move(entry));
+            }
+            return pins;
+        });
+
+        registerOnController("pins.read", [this](const JsonValue& params) { return readPins(params, false); });
+        registerOnController("pins.sample", [this](const JsonValue& params) { return readPins(params, true); });
+        registerOnController("pins.apply", [this](const JsonValue& params) { return applyPins(params); });
+
+        // {pins:[LSB..MSB], value}: un único scan DR
+        registerOnController("bus.write", [&c = controller](const JsonValue& params) {
+            const std::vector<std::string> pins = stringList(params, "pins");
+            if (pins.empty() || pins.size() > 32) invalidParams("'pins' must list 1..32 pins (LSB first)");
+            if (!params["value"].isNumber()) invalidParams("Missing numeric parameter 'value'");
+            if (!c.isInitialized()) fail("Device not initialized (call device.initialize)");
+
+            PollingPause pause(c);
+            if (!c.writeBus(pins, static_cast<uint32_t>(params["value"].asInt()))) fail("Bus write failed");
+            return JsonValue::object();
+        });
+
+        // ---------- Buses externos (EXTEST) ----------
+        // Cada petición es un único comando del executor: configurar, transferir y
+        // dejar la imagen del bus en el BSR. El polling queda como estaba
+
+        // {pins:{sck,mosi,miso,cs}, mode?, tx:[bytes], rxCount?} → {rx: tx.size()+rxCount bytes}
+        registerOnController("spi.transfer", [&c = controller](const JsonValue& params) {
+            const JsonValue& pinsParam = params["pins"];
+            SpiPins pins{ requireString(pinsParam, "sck"), requireString(pinsParam, "mosi"),
+                          requireString(pinsParam, "miso"), requireString(pinsParam, "cs") };
+            const int mode = static_cast<int>(params.contains("mode") ? requireCount(params, "mode", 3) : 0);
+            const std::vector<uint8_t> tx = byteList(params, "tx");
+            const size_t rxCount = params.contains("rxCount") ? requireCount(params, "rxCount", 65536) : 0;
+            if (tx.empty() && rxCount == 0) invalidParams("Nothing to transfer ('tx' or 'rxCount')");
+            if (!c.isInitialized()) fail("Device not initialized (call device.initialize)");
+
+            PollingPause pause(c);
+            std::vector<uint8_t> rx;
+            std::string error;
+            if (!c.runSpiMaster(pins, mode, [&](SpiMaster& spi) {
+                    if (spi.transfer(tx, rxCount, rx)) return true;
+                    error = spi.getLastError();
+                    return false;
+                })) {
+                fail(error.empty() ? "SPI transfer failed" : error);
+            }
+            JsonValue result = JsonValue::object();
+            result.set("rx", byteArray(rx));
+            return result;
+        });
+
+        // {pins:{scl,sda}, address, tx?:[bytes], rxCount?}: escritura, lectura o
+        // escritura + START repetido + lectura
+        registerOnController("i2c.transfer", [&c = controller](const JsonValue& params) {
+            const JsonValue& pinsParam = params["pins"];
+            I2cPins pins{ requireString(pinsParam, "scl"), requireString(pinsParam, "sda") };
+            const uint8_t address = static_cast<uint8_t>(requireCount(params, "address", 0x7F));
+            const std::vector<uint8_t> tx = byteList(params, "tx");
+            const size_t rxCount = params.contains("rxCount") ? requireCount(params, "rxCount", 4096) : 0;
+            if (tx.empty() && rxCount == 0) invalidParams("Nothing to transfer ('tx' or 'rxCount')");
+            if (!c.isInitialized()) fail("Device not initialized (call device.initialize)");
+
+            PollingPause pause(c);
+            std::vector<uint8_t> rx;
+            std::string error;
+            if (!c.runI2cMaster(pins, [&](I2cMaster& i2c) {
+                    const bool ok = rxCount == 0 ? i2c.write(address, tx)
+                                  : tx.empty()   ? i2c.read(address, rxCount, rx)
+                                                 : i2c.writeRead(address, tx, rxCount, rx);
+                    if (!ok) error = i2c.getLastError();
+                    return ok;
+                })) {
+                fail(error.empty() ? "I2C transfer failed" : error);
+            }
+            JsonValue result = JsonValue::object();
+            result.set("rx", byteArray(rx));
+            return result;
+        });
+
+        // {pins:{address:[A0..], data:[DQ0..], ce, oe, we, reset?, wp?}, address, count} → {words}
+        registerOnController("flash.read", [&c = controller](const JsonValue& params) {
+            const JsonValue& pinsParam = params["pins"];
+            NorFlashPins pins;
+            pins.address = stringList(pinsParam, "address");
+            pins.data = stringList(pinsParam, "data");
+            if (pins.address.empty() || pins.data.empty()) invalidParams("'pins' needs 'address' and 'data' lists");
+            pins.ce = requireString(pinsParam, "ce");
+            pins.oe = requireString(pinsParam, "oe");
+            pins.we = requireString(pinsParam, "we");
+            pins.reset = pinsParam["reset"].asString();
+            pins.wp = pinsParam["wp"].asString();
+            const uint32_t address = static_cast<uint32_t>(requireCount(params, "address", 0xFFFFFFFFu));
+            const size_t count = requireCount(params, "count", 65536);
+            if (!c.isInitialized()) fail("Device not initialized (call device.initialize)");
+
+            PollingPause pause(c);
+            std::vector<uint16_t> words;
+            std::string error;
+            if (!c.runParallelFlash(pins, [&](ParallelNorFlash& flash) {
+                    if (flash.read(address, count, words)) return true;
+                    error = flash.getLastError();
+                    return false;
+                })) {
+                fail(error.empty() ? "Flash read failed" : error);
+            }
+            JsonValue result = JsonValue::object();
+            JsonValue array = JsonValue::array();
+            for (uint16_t word : words) array.push(static_cast<uint64_t>(word));
+            result.set("words", std::move(array));
+            return result;
+        });
+
+        // ---------- Polling ----------
+        registerOnController("polling.start", [&c = controller](const JsonValue&) {
+            c.startPolling();
+            JsonValue result = JsonValue::object();
+            result.set("polling", c.isPolling());
+            return result;
+        });
+
+        registerOnController("polling.stop", [&c = controller](const JsonValue&) {
+            c.stopPolling();
+            return JsonValue::object();
+        });
+
+        // {ms} o {us} (periodos < 1 ms)
+        registerOnController("polling.setPeriod", [&c = controller](const JsonValue& params) {
+            if (params["us"].isNumber()) {
+                c.setPollPeriod(std::chrono::microseconds(params["us"].asInt()));
+            } else if (params["ms"].isNumber()) {
+                c.setPollPeriod(std::chrono::milliseconds(params["ms"].asInt()));
+            } else {
+                invalidParams("Expected 'ms' or 'us'");
+            }
+            return JsonValue::object();
+        });
+
+        // ---------- Contención ----------
+        // {enabled, autoSafeState}: comparación captura/imagen conducida en EXTEST;
+        // autoSafeState pone los drivers en alta impedancia al primer fallo
+        registerOnController("contention.set", [&c = controller](const JsonValue& params) {
+            if (!params["enabled"].isBool()) invalidParams("Missing boolean parameter 'enabled'");
+            c.setContentionDetection(params["enabled"].asBool(false), params["autoSafeState"].asBool(false));
+            JsonValue result = JsonValue::object();
+            result.set("enabled", c.isContentionDetectionEnabled());
+            result.set("autoSafeState", c.isContentionSafeStateEnabled());
+            return result;
+        });
+
+        // Espera en el hilo de la conexión, no en el del controlador
+        server->registerMethod("capture.burst", [this](const JsonValue& params, const RpcContext&) {
+            return captureBurst(params);
+        });
+
+        // ---------- Suscripciones ----------
+        server->registerMethod("watch.subscribe", [this](const JsonValue& params, const RpcContext& context) {
+            RpcContext client = context;
+            return onController([this, params, client]() { return subscribeWatch(params, client); });
+        });
+
+        // Solo el cliente que creó la suscripción puede retirarla
+        server->registerMethod("watch.unsubscribe", [this](const JsonValue& params, const RpcContext& context) {
+            const uint64_t id = static_cast<uint64_t>(params["subscription"].asInt());
+            bool owned = false;
+            {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                auto it = watches.find(id);
+                if (it != watches.end() && it->second == context.getClientId()) {
+                    watches.erase(it);
+                    owned = true;
+                }
+            }
+            bool removed = false;
+            if (owned) removed = onController([this, id]() { return JsonValue(controller.unwatch(id)); }).asBool(false);
+            JsonValue result = JsonValue::object();
+            result.set("removed", removed);
+            return result;
+        });
+
+        // ---------- Vectores y grabación ----------
+        registerOnController("vectors.run", [&c = controller](const JsonValue& params) {
+            if (!c.runVectorFile(std::filesystem::u8path(requireString(params, "path")))) {
+                fail("Vector file failed (see adapter log)");
+            }
+            return JsonValue::object();
+        });
+
+        registerOnController("svf.run", [&c = controller](const JsonValue& params) {
+            const std::filesystem::path svf = std::filesystem::u8path(requireString(params, "path"));
+            // Nombre impredecible creado en exclusiva (0600): nadie puede colocar
+            // antes un fichero o enlace con ese nombre. Se borra al salir
+            QTemporaryFile temp(QDir::tempPath() + "/jtag_rpc_XXXXXX.jvec");
+            if (!temp.open()) fail("Cannot create temporary vector file");
+            temp.close();
+            const std::filesystem::path jvec = std::filesystem::u8path(temp.fileName().toStdString());
+            if (!c.compileSVF(svf, jvec)) fail("SVF compile failed");
+            if (!c.runVectorFile(jvec)) fail("SVF execution failed");
+            return JsonValue::object();
+        });
+
+        registerOnController("recording.start", [&c = controller](const JsonValue& params) {
+            if (!c.startRecording(std::filesystem::u8path(requireString(params, "path")))) {
+                fail("Cannot start recording");
+            }
+            return JsonValue::object();
+        });
+
+        registerOnController("recording.stop", [&c = controller](const JsonValue&) {
+            c.stopRecording();
+            return JsonValue::object();
+        });
+    }
+
+    // {set:{PIN:0|1,...}, read:[PIN,...]}: todo el lote en un único scan DR
+    JsonValue ScanControllerRpc::applyPins(const JsonValue& params) {
+        const DeviceModel* model = controller.getDeviceModel();
+        if (!model) fail("No BSDL loaded");
+        if (!controller.isInitialized()) fail("Device not initialized (call device.initialize)");
+
+        const JsonValue& set = params["set"];
+        if (!set.isObject()) invalidParams("'set' must be an object {pin: level}");
+
+        // Validar el lote completo antes de tocar el BSR
+        std::vector<std::pair<std::string, PinLevel>> writes;
+        writes.reserve(set.size());
+        for (const auto& [name, value] : set.asObject()) {
+            auto info = model->getPinInfo(name);
+            if (!info) invalidParams("Unknown pin: " + name);
+            if (info->outputCell < 0) invalidParams("Pin has no output cell: " + name);
+            writes.emplace_back(name, parseLevel(name, value));
+        }
+        const std::vector<std::string> reads = stringList(params, "read");
+        for (const auto& name : reads) {
+            if (model->findPin(name) < 0) invalidParams("Unknown pin: " + name);
+        }
+
+        PollingPause pause(controller);
+        for (const auto& [name, level] : writes) controller.setPin(name, level);
+        if (!controller.applyChanges()) fail("JTAG transaction failed");
+
+        JsonValue pins = JsonValue::object();
+        for (const auto& name : reads) pins.set(name, levelJson(controller.getPin(name)));
+
+        JsonValue result = JsonValue::object();
+        result.set("applied", static_cast<uint64_t>(writes.size()));
+        result.set("pins", std::move(pins));
+        return result;
+    }
+
+    // {pins?:[...]}: sample = una captura nueva (un scan DR); si no, último estado conocido
+    JsonValue ScanControllerRpc::readPins(const JsonValue& params, bool sample) {
+        const DeviceModel* model = controller.getDeviceModel();
+        if (!model) fail("No BSDL loaded");
+
+        std::vector<std::string> names = stringList(params, "pins");
+        if (names.empty()) names = model->getPinNames();
+        for (const auto& name : names) {
+            if (model->findPin(name) < 0) invalidParams("Unknown pin: " + name);
+        }
+
+        if (sample) {
+            if (!controller.isInitialized()) fail("Device not initialized (call device.initialize)");
+            PollingPause pause(controller);
+            if (!controller.samplePins()) fail("JTAG transaction failed");
+        }
+
+        JsonValue pins = JsonValue::object();
+        for (const auto& name : names) pins.set(name, levelJson(controller.getPin(name)));
+
+        JsonValue result = JsonValue::object();
+        result.set("pins", std::move(pins));
+        return result;
+    }
+
+    // {samples, durationMs?, batchSize?, pins:[...]}: ráfaga SAMPLE, un string de bits por pin
+    JsonValue ScanControllerRpc::captureBurst(const JsonValue& params) {
+        BurstSpec spec;
+        spec.samples = static_cast<size_t>(params["samples"].asInt(static_cast<int64_t>(spec.samples)));
+        spec.duration = std::chrono::milliseconds(params["durationMs"].asInt(0));
+        spec.batchSize = static_cast<size_t>(params["batchSize"].asInt(static_cast<int64_t>(spec.batchSize)));
+        std::vector<std::string> pins = stringList(params, "pins");
+        if (pins.empty()) invalidParams("'pins' must list at least one pin");
+
+        auto promise = std::make_shared<std::promise<JsonValue>>();
+        auto future = promise->get_future();
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (pendingBurst) fail("Another burst capture is in progress");
+            pendingBurst = promise;
+            burstPins = pins;
+        }
+        auto cancel = [this, &promise]() {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (pendingBurst == promise) {
+                pendingBurst.reset();
+                burstPins.clear();
+            }
+        };
+
+        try {
+            onController([this, spec, pins]() {
+                const DeviceModel* model = controller.getDeviceModel();
+                for (const auto& name : pins) {
+                    if (!model || model->findPin(name) < 0) invalidParams("Unknown pin: " + name);
+                }
+                if (!controller.requestBurst(spec)) fail("Burst capture rejected (device not initialized or scan mode is not SAMPLE)");
+                return JsonValue();
+            });
+        }
+        catch (...) {
+            cancel();
+            throw;
+        }
+
+        const auto deadline = std::chrono::steady_clock::now() + spec.duration + BURST_MARGIN;
+        while (future.wait_for(WAIT_SLICE) != std::future_status::ready) {
+            if (server->isStopping() || std::chrono::steady_clock::now() > deadline) {
+                cancel();
+                if (!server->isStopping()) {
+                    QMetaObject::invokeMethod(&controller, [c = &controller]() { c->abortBurst(); },
+                                              Qt::QueuedConnection);
+                }
+                fail("Burst capture timed out");
+            }
+        }
+        return future.get();
+    }
+
+    // {pins:[LSB..], condition?: change|rising|falling|equals, value?, timeoutMs?, oneShot?}
+    JsonValue ScanControllerRpc::subscribeWatch(const JsonValue& params, const RpcContext& context) {
+        const std::vector<std::string> pins = stringList(params, "pins");
+        if (pins.empty() || pins.size() > 64) invalidParams("'pins' must list 1..64 pins (LSB first)");
+
+        WatchSpec spec;
+        spec.condition = parseCondition(params["condition"].asString());
+        spec.value = static_cast<uint64_t>(params["value"].asInt(0));
+        spec.timeout = std::chrono::milliseconds(params["timeoutMs"].asInt(0));
+        spec.oneShot = params["oneShot"].asBool(false);
+
+        // Los eventos llegan en el hilo despachador del PinWatcher
+        std::weak_ptr<RpcServer> weakServer = server;
+        const uint64_t clientId = context.getClientId();
+        const uint64_t id = controller.watchPins(pins, spec, [weakServer, clientId](const WatchEvent& event) {
+            auto target = weakServer.lock();
+            if (!target) return;
+            JsonValue payload = JsonValue::object();
+            payload.set("subscription", event.id);
+            payload.set("value", event.value);
+            payload.set("previousValue", event.previousValue);
+            payload.set("timedOut", event.timedOut);
+            payload.set("scan", event.scan);
+            payload.set("timestampNs", event.timestampNs);
+            target->notify(clientId, "watch.event", std::move(payload));
+        });
+        if (id == 0) fail("Cannot watch pins (device initialized and pins readable?)");
+
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            watches[id] = clientId;
+        }
+        // Al desconectar el cliente (hilo de la conexión, antes de que stop() termine);
+        // el controlador solo se toca desde su hilo
+        context.onClose([this, id]() {
+            {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                watches.erase(id);
+            }
+            QMetaObject::invokeMethod(&controller, [c = &controller, id]() { c->unwatch(id); },
+                                      Qt::QueuedConnection);
+        });
+
+        JsonValue result = JsonValue::object();
+        result.set("subscription", id);
+        return result;
+    }
+
+} // namespace JTAG
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <QObject>
+
+#include "../rpc/RpcServer.h"
+#include "ScanController.h"
+
+namespace JTAG {
+
+    /**
+     * @brief Expone ScanController por JSON-RPC local (RpcServer)
+     *
+     * Cada método se ejecuta en el hilo del controlador (cola de eventos Qt)
+     * mientras el hilo de la conexión espera el resultado. Las operaciones de
+     * pines en lote (pins.apply, pins.sample, bus.write) pausan el polling y
+     * van en una sola transacción JTAG. Los eventos de watch llegan como
+     * notificaciones "watch.event" al cliente que se suscribió.
+     *
+     * Métodos: adapter.list/connect/disconnect, device.detect/loadBsdl/
+     * unloadBsdl/info/initialize, mode.set, pins.list/read/apply/sample,
+     * bus.write, spi.transfer, i2c.transfer, flash.read,
+     * polling.start/stop/setPeriod, contention.set, capture.burst,
+     * watch.subscribe/unsubscribe, vectors.run, svf.run, recording.start/stop.
+     */
+    class ScanControllerRpc {
+    public:
+        explicit ScanControllerRpc(ScanController& controller);
+        ~ScanControllerRpc();
+
+        ScanControllerRpc(const ScanControllerRpc&) = delete;
+        ScanControllerRpc& operator=(const ScanControllerRpc&) = delete;
+
+        bool listenTcp(uint16_t port);
+        bool listenUnix(const std::filesystem::path& path);
+        void stop();
+
+        RpcServer& getServer() { return *server; }
+        const std::string& getLastError() const { return server->getLastError(); }
+
+    private:
+        using Task = std::function<JsonValue()>;
+
+        void registerMethods();
+        void registerOnController(const std::string& name,
+                                  std::function<JsonValue(const JsonValue& params)> handler);
+        // Ejecuta en el hilo del controlador y espera (aborta si el servidor se detiene)
+        JsonValue onController(Task task);
+
+        JsonValue applyPins(const JsonValue& params);
+        JsonValue readPins(const JsonValue& params, bool sample);
+        JsonValue captureBurst(const JsonValue& params);
+        JsonValue subscribeWatch(const JsonValue& params, const RpcContext& context);
+
+        ScanController& controller;
+        std::shared_ptr<RpcServer> server;   // Los callbacks de watch lo guardan como weak_ptr
+        QObject signalContext;               // Señales del controlador y tareas encoladas (hilo GUI)
+
+        std::mutex stateMutex;
+        std::map<uint64_t, uint64_t> watches; // Suscripción → cliente RPC que la creó
+        std::shared_ptr<std::promise<JsonValue>> pendingBurst;
+        std::vector<std::string> burstPins;
+    };
+
+} // namespace JTAG
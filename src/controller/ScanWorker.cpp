@@ -1,14 +1,18 @@
 #include "ScanWorker.h"
-#include <QThread>
 #include <QDebug>
+#include <chrono>
+#include "../core/BitUtils.h"
+#include "../core/MonotonicClock.h"
+#include "../core/Instrumentation.h"
 
 namespace JTAG {
 
-    ScanWorker::ScanWorker(BoundaryScanEngine* engine, DeviceModel* model, QObject* parent)
+    ScanWorker::ScanWorker(BoundaryScanEngine* engine, const DeviceModel* model, QObject* parent)
         : QObject(parent)
         , engine(engine)
         , deviceModel(model)
     {
+        if (deviceModel) pinWatcher.setBSRLength(deviceModel->getBSRLength());
     }
 
     ScanWorker::~ScanWorker() {
@@ -16,6 +20,7 @@ namespace JTAG {
     }
 
     void ScanWorker::start() {
+        restart = true;
         running = true;
         emit started();
     }
@@ -26,7 +31,18 @@ namespace JTAG {
     }
 
     void ScanWorker::setPollInterval(int ms) {
-        pollIntervalMs = ms;
+        setPollPeriod(std::chrono::milliseconds(ms));
+    }
+
+    void ScanWorker::setPollPeriod(std::chrono::nanoseconds period) {
+        SchedulerOptions options = scheduler.getOptions();
+        options.period = period;
+        scheduler.setOptions(options);
+    }
+
+    void ScanWorker::setSchedulerOptions(const SchedulerOptions& options) {
+        scheduler.setOptions(options);
+        threadOptionsChanged = true;
     }
 
     void ScanWorker::forceReloadInstruction() {
@@ -37,33 +53,20 @@ namespace JTAG {
     void ScanWorker::setScanMode(ScanMode mode) {
         currentMode = mode;
 
-        // Sincronizar modo con el engine
-        if (engine) {
-            BoundaryScanEngine::OperationMode engineMode;
-            switch (mode) {
-                case ScanMode::SAMPLE:
-                    engineMode = BoundaryScanEngine::OperationMode::SAMPLE;
-                    break;
-                case ScanMode::SAMPLE_SINGLE_SHOT:
-                    engineMode = BoundaryScanEngine::OperationMode::SAMPLE;
-                    // EXCEPCIÓN: Single-shot auto-inicia porque es una operación única
-                    if (!running) {
-                        start();
-                    }
-                    break;
-                case ScanMode::EXTEST:
-                    engineMode = BoundaryScanEngine::OperationMode::EXTEST;
-                    break;
-                case ScanMode::INTEST:
-                    engineMode = BoundaryScanEngine::OperationMode::INTEST;
-                    break;
-                case ScanMode::BYPASS:
-                    engineMode = BoundaryScanEngine::OperationMode::BYPASS;
-                    break;
-                default:
-                    engineMode = BoundaryScanEngine::OperationMode::SAMPLE;
-            }
-            engine->setOperationMode(engineMode);
+        // EXCEPCIÓN: Single-shot auto-inicia porque es una operación única
+        if (mode == ScanMode::SAMPLE_SINGLE_SHOT && !running) {
+            start();
+        }
+    }
+
+    BoundaryScanEngine::OperationMode ScanWorker::toOperationMode(ScanMode mode) {
+        switch (mode) {
+            case ScanMode::EXTEST: return BoundaryScanEngine::OperationMode::EXTEST;
+            case ScanMode::INTEST: return BoundaryScanEngine::OperationMode::INTEST;
+            case ScanMode::BYPASS: return BoundaryScanEngine::OperationMode::BYPASS;
+            case ScanMode::SAMPLE:
+            case ScanMode::SAMPLE_SINGLE_SHOT:
+            default:               return BoundaryScanEngine::OperationMode::SAMPLE;
         }
     }
 
@@ -77,156 +80,250 @@ namespace JTAG {
         return !dirtyPins.empty();
     }
 
+    void ScanWorker::setContentionDetection(bool enabled, bool autoSafeState) {
+        contentionSafeState = autoSafeState;
+        contentionRestart = true;   // La imagen previa guardada puede estar obsoleta
+        contentionEnabled = enabled;
+    }
+
+    bool ScanWorker::armTrigger(const TriggerSpec& spec, QString* error) {
+        if (!deviceModel || deviceModel->getBSRLength() == 0) {
+            if (error) *error = "No device model loaded";
+            return false;
+        }
+        // Validar aquí para informar del error al llamante; el worker vuelve a compilar
+        std::string compileError;
+        TriggerEngine probe;
+        if (!probe.configure(spec, deviceModel->getBSRLength(), &compileError)) {
+            if (error) *error = QString::fromStdString(compileError);
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(triggerMutex);
+        pendingTrigger = std::make_unique<TriggerSpec>(spec);
+        triggerChanged = true;
+        triggerArmed = true;
+        return true;
+    }
+
+    void ScanWorker::disarmTrigger() {
+        std::lock_guard<std::mutex> lock(triggerMutex);
+        pendingTrigger.reset();
+        triggerChanged = true;
+        triggerArmed = false;
+    }
+
+    void ScanWorker::requestBurst(const BurstSpec& spec) {
+        std::lock_guard<std::mutex> lock(burstMutex);
+        pendingBurst = std::make_unique<BurstSpec>(spec);
+        burstAbort = false;
+        burstRequested = true;
+    }
+
+    void ScanWorker::abortBurst() {
+        burstAbort = true;
+    }
+
     // --------------------------------------------------------------------------
     // LÓGICA PRINCIPAL DEL HILO
     // --------------------------------------------------------------------------
     void ScanWorker::run() {
-        qDebug() << "[ScanWorker] Thread started";
+        qDebug() << "[ScanWorker] Loop started";
+        while (pollCycle()) {
+            scheduler.waitNext();
+        }
+        qDebug() << "[ScanWorker] Loop stopped";
+    }
 
-        ScanMode lastMode = ScanMode::SAMPLE;
-        bool firstRun = true;
+    bool ScanWorker::pollCycle() {
+        if (!running) return false;
+
+        if (restart.exchange(false)) {
+            // Primer ciclo tras start(): el estado del engine es desconocido
+            lastMode = ScanMode::SAMPLE;
+            firstRun = true;
+
+            // Deadlines absolutos: el periodo no incluye el tiempo de scan ni acumula jitter.
+            // Prioridad y afinidad se aplican al hilo que ejecuta los ciclos (el del executor)
+            threadOptionsChanged = false;
+            SchedulerOptions schedOptions = scheduler.getOptions();
+            if (schedOptions.realtime || schedOptions.cpu >= 0) scheduler.applyThreadOptions();
+            scheduler.resetStats();
+            scheduler.start();
+        }
 
-        // ===== OPTIMIZACIÓN: Mover vector FUERA del loop =====
+        // ===== OPTIMIZACIÓN: vector reutilizado entre ciclos =====
         // Evita malloc/free en cada iteración (hot path)
-        // Con 200 pines @ 50Hz = 10,000 allocations/sec → 0 allocations
-        std::vector<PinLevel> pins;
-        if (deviceModel) {
-            pins.reserve(deviceModel->getBSRLength());
-        }
-        // =====================================================
-
-        while (running) {
-            try {
-                if (!deviceModel) {
-                    QThread::msleep(50);
-                    continue;
-                }
+        if (deviceModel && pins.capacity() < deviceModel->getPinCount()) {
+            pins.reserve(deviceModel->getPinCount());
+        }
 
-                ScanMode targetMode = currentMode.load();
+        try {
+            if (!deviceModel) return running;   // El executor espera al siguiente periodo
 
-                // 1. CARGA DE INSTRUCCIÓN (Solo cuando cambia el modo)
-                // Optimización: Solo cargamos instrucción cuando:
-                // - Es la primera ejecución
-                // - El modo cambió (SAMPLE -> EXTEST, etc.)
-                // - Se solicitó recarga forzada (después de JTAG reset)
-                bool forceReloadRequested = forceReload.exchange(false); // Leer y resetear flag
-                bool modeChanged = (targetMode != lastMode) || firstRun || forceReloadRequested;
+            ScanMode targetMode = currentMode.load();
+            if (triggerChanged) applyPendingTrigger();
+            const uint64_t sequenceBefore = engine->getLastScanTiming().sequence;
 
-                if (modeChanged) {
-                    std::string instrName = "SAMPLE"; // Default
-                    if (targetMode == ScanMode::SAMPLE_SINGLE_SHOT) instrName = "SAMPLE";
-                    if (targetMode == ScanMode::EXTEST) instrName = "EXTEST";
-                    if (targetMode == ScanMode::INTEST) instrName = "INTEST";
-                    if (targetMode == ScanMode::BYPASS) instrName = "BYPASS";
+            // 1. CARGA DE INSTRUCCIÓN (Solo cuando cambia el modo)
+            // Optimización: Solo cargamos instrucción cuando:
+            // - Es la primera ejecución
+            // - El modo cambió (SAMPLE -> EXTEST, etc.)
+            // - Se solicitó recarga forzada (después de JTAG reset)
+            bool forceReloadRequested = forceReload.exchange(false); // Leer y resetear flag
+            bool modeChanged = (targetMode != lastMode) || firstRun || forceReloadRequested;
 
-                    uint32_t opcode = deviceModel->getInstruction(instrName);
+            if (modeChanged) {
+                std::string instrName = "SAMPLE"; // Default
+                if (targetMode == ScanMode::SAMPLE_SINGLE_SHOT) instrName = "SAMPLE";
+                if (targetMode == ScanMode::EXTEST) instrName = "EXTEST";
+                if (targetMode == ScanMode::INTEST) instrName = "INTEST";
+                if (targetMode == ScanMode::BYPASS) instrName = "BYPASS";
 
-                    // Fallback para SAMPLE
-                    if (opcode == 0xFFFFFFFF && targetMode == ScanMode::SAMPLE)
-                        opcode = deviceModel->getInstruction("SAMPLE/PRELOAD");
+                uint32_t opcode = deviceModel->getInstruction(instrName);
 
-                    size_t irLen = deviceModel->getIRLength();
+                // Fallback para SAMPLE
+                if (opcode == 0xFFFFFFFF && targetMode == ScanMode::SAMPLE)
+                    opcode = deviceModel->getInstruction("SAMPLE/PRELOAD");
 
-                    // Cargar la instrucción
-                    if (!engine->loadInstruction(opcode, irLen)) {
-                        qDebug() << "[ScanWorker] Failed to load instruction:" << QString::fromStdString(instrName);
-                    } else {
-                        qDebug() << "[ScanWorker] Loaded instruction:" << QString::fromStdString(instrName);
-                    }
+                size_t irLen = deviceModel->getIRLength();
 
-                    lastMode = targetMode;
-                    firstRun = false;
+                // Cargar la instrucción
+                if (!engine->loadInstruction(opcode, irLen)) {
+                    qDebug() << "[ScanWorker] Failed to load instruction:" << QString::fromStdString(instrName);
+                } else {
+                    qDebug() << "[ScanWorker] Loaded instruction:" << QString::fromStdString(instrName);
                 }
 
-                // 2. EJECUCIÓN DEL MODO
-                if (targetMode == ScanMode::EXTEST || targetMode == ScanMode::INTEST) {
-                    // Ambos modos EXTEST e INTEST usan el mismo mecanismo BSR
-                    // Solo difiere la instrucción cargada (EXTEST vs INTEST)
-                    // EXTEST: controla pines externos
-                    // INTEST: prueba lógica interna
-
-                    // A) Procesar cambios nuevos de la GUI
-                    if (hasDirtyPins()) {
-                        processDirtyPins();
-
-                        // B) Aplicar cambios INMEDIATAMENTE
-                        // Como BoundaryScanEngine ahora mantiene bsr separado,
-                        // no necesitamos restaurar manualmente los valores
-                        if (!engine->applyChanges()) {
-                            QString modeStr = (targetMode == ScanMode::EXTEST) ? "EXTEST" : "INTEST";
-                            emit errorOccurred(QString("Failed to apply changes in %1").arg(modeStr));
-                        }
-                    }
-                    // Si no hay cambios, NO hacer applyChanges innecesario
-                    // (optimización para reducir tráfico JTAG)
-                }
-                else if (targetMode == ScanMode::SAMPLE || targetMode == ScanMode::SAMPLE_SINGLE_SHOT) {
-                    // Modo SAMPLE (Solo lectura) - continuo o single-shot
-                    engine->samplePins();
-                }
-                else if (targetMode == ScanMode::BYPASS) {
-                    // Modo BYPASS: instrucción ya cargada, no hacer operaciones BSR
-                    // El chip está en bypass, el BSR no es accesible
-                    // Modo estático: no polling necesario
+                lastMode = targetMode;
+                firstRun = false;
+
+                // Nueva instrucción: la próxima captura no corresponde a una imagen conocida
+                if (contentionDetector) contentionDetector->reset();
+                if (triggerEngine.isActive()) triggerEngine.arm();
+                pinWatcher.resetBaseline();
+            }
+
+            // Ráfaga pendiente de un SAMPLE anterior: cambiar de instrucción por ella
+            // alteraría los pines conducidos, así que se descarta
+            const bool sampleMode = (targetMode == ScanMode::SAMPLE || targetMode == ScanMode::SAMPLE_SINGLE_SHOT);
+            if (burstRequested && !sampleMode) {
+                {
+                    std::lock_guard<std::mutex> lock(burstMutex);
+                    pendingBurst.reset();
+                    burstRequested = false;
                 }
+                emit errorOccurred("Burst capture cancelled: scan mode is no longer SAMPLE");
+            }
 
-                // 3. ACTUALIZAR GUI
-                size_t bsrLen = engine->getBSRLength();
-
-                // ===== OPTIMIZACIÓN: resize() en lugar de declarar nuevo vector =====
-                // Mantiene capacidad pre-alocada, solo ajusta tamaño lógico
-                pins.resize(bsrLen);
-                // ===================================================================
-
-                if (targetMode != ScanMode::BYPASS) {
-                    // MODE-AWARE: Lectura según el modo activo
-                    // EXTEST/INTEST: Usuario edita → leer buffer de escritura (bsr estable)
-                    // SAMPLE: Solo lectura → leer buffer capturado (bsrCapture actualizado)
-                    for (size_t i = 0; i < bsrLen; ++i) {
-                        auto level = (targetMode == ScanMode::EXTEST || targetMode == ScanMode::INTEST)
-                            ? engine->getPin(i)          // EXTEST/INTEST: lee bsr (ediciones del usuario)
-                            : engine->getPinReadback(i); // SAMPLE: lee bsrCapture (estado real del chip)
-
-                        // ===== OPTIMIZACIÓN: Asignación directa (no push_back) =====
-                        pins[i] = level.value_or(PinLevel::HIGH_Z);
-                        // ===========================================================
-                    }
-                } else {
-                    // En modo BYPASS, el BSR no es accesible
-                    // Enviar estados high-Z a la GUI
-                    for (size_t i = 0; i < bsrLen; ++i) {
-                        pins[i] = PinLevel::HIGH_Z;  // Asignación directa
+            // 2. EJECUCIÓN DEL MODO
+            if (targetMode == ScanMode::EXTEST || targetMode == ScanMode::INTEST) {
+                // Ambos modos EXTEST e INTEST usan el mismo mecanismo BSR
+                // Solo difiere la instrucción cargada (EXTEST vs INTEST)
+                // EXTEST: controla pines externos
+                // INTEST: prueba lógica interna
+
+                // Detección de contención / disparo / suscripciones: scan en cada ciclo para evaluar capturas
+                bool contention = (targetMode == ScanMode::EXTEST && contentionEnabled);
+                if (contention || triggerEngine.isActive() || pinWatcher.hasSubscriptions()) {
+                    if (hasDirtyPins()) processDirtyPins();
+                    if (engine->applyChanges()) {
+                        if (contention) checkContention();
+                        processCapture();
+                    } else {
+                        emit errorOccurred("Failed to apply changes in EXTEST");
                     }
                 }
-
-                // FASE 2: Usar std::make_shared para asignación eficiente
-                // make_shared asigna el bloque de control y el objeto en UNA SOLA llamada al heap
-                // Evita 3 copias profundas (Qt::QueuedConnection solo incrementa refcount)
-                auto pinsPtr = std::make_shared<const std::vector<PinLevel>>(std::move(pins));
-                emit pinsUpdated(pinsPtr);
-
-                // Si estamos en modo single-shot, detener automáticamente después de la captura
-                if (targetMode == ScanMode::SAMPLE_SINGLE_SHOT) {
-                    qDebug() << "[ScanWorker] Single-shot capture complete, stopping";
-                    running = false;
-                    emit stopped();
+                // A) Procesar cambios nuevos de la GUI
+                else if (hasDirtyPins()) {
+                    processDirtyPins();
+
+                    // B) Aplicar cambios INMEDIATAMENTE
+                    // Como BoundaryScanEngine ahora mantiene bsr separado,
+                    // no necesitamos restaurar manualmente los valores
+                    if (!engine->applyChanges()) {
+                        QString modeStr = (targetMode == ScanMode::EXTEST) ? "EXTEST" : "INTEST";
+                        emit errorOccurred(QString("Failed to apply changes in %1").arg(modeStr));
+                    }
                 }
-
+                // Si no hay cambios, NO hacer applyChanges innecesario
+                // (optimización para reducir tráfico JTAG)
+            }
+            else if (targetMode == ScanMode::SAMPLE || targetMode == ScanMode::SAMPLE_SINGLE_SHOT) {
+                // Modo SAMPLE (Solo lectura) - continuo o single-shot
+                // Ráfaga: sin pausas ni emisión por muestra; la GUI recibe la ventana completa
+                if (burstRequested && runPendingBurst()) return running;
+                if (engine->samplePins()) processCapture();
             }
-            catch (const std::exception& e) {
-                emit errorOccurred(QString("Worker exception: %1").arg(e.what()));
+            else if (targetMode == ScanMode::BYPASS) {
+                // Modo BYPASS: instrucción ya cargada, no hacer operaciones BSR
+                // El chip está en bypass, el BSR no es accesible
+                // Modo estático: no polling necesario
             }
 
-            QThread::msleep(pollIntervalMs);
+            // 3. ACTUALIZAR GUI
+            // Con el disparo armado la GUI recibe la ventana completa en triggerCaptured()
+            if (triggerEngine.isActive()) return running;
+
+            const uint64_t conversionStart = monotonicNowNs();
+            convertPins(*engine, *deviceModel, targetMode, pinDecoder, pins);
+
+            // FASE 2: Usar std::make_shared para asignación eficiente
+            // make_shared asigna el bloque de control y el objeto en UNA SOLA llamada al heap
+            // Evita 3 copias profundas (Qt::QueuedConnection solo incrementa refcount)
+            // La instantánea lleva el momento real del scan (no el de llegada a la GUI)
+            const ScanTiming& timing = engine->getLastScanTiming();
+            auto snapshot = std::make_shared<PinSnapshot>();
+            snapshot->pins = std::move(pins);
+            snapshot->sequence = timing.sequence;
+            snapshot->scanStartNs = timing.startNs;
+            snapshot->scanEndNs = timing.endNs;
+            snapshot->fresh = (timing.sequence != sequenceBefore);
+            snapshot->publishedNs = monotonicNowNs();
+            auto& stats = Instrumentation::instance();
+            stats.record(Stage::SNAPSHOT_CONVERSION, snapshot->publishedNs - conversionStart);
+            stats.add(Counter::TRACKED_ALLOCATIONS);   // Instantánea + vector de pines (movido)
+            emit pinsUpdated(std::shared_ptr<const PinSnapshot>(std::move(snapshot)));
+
+            // Si estamos en modo single-shot, detener automáticamente después de la captura
+            if (targetMode == ScanMode::SAMPLE_SINGLE_SHOT) {
+                qDebug() << "[ScanWorker] Single-shot capture complete, stopping";
+                running = false;
+                emit stopped();
+            }
+
+        }
+        catch (const std::exception& e) {
+            emit errorOccurred(QString("Worker exception: %1").arg(e.what()));
         }
 
-        qDebug() << "[ScanWorker] Thread stopped";
-    } // <--- ESTA LLAVE CIERRA LA FUNCIÓN RUN()
+        if (threadOptionsChanged.exchange(false)) scheduler.applyThreadOptions();
+        return running;
+    }
 
     // --------------------------------------------------------------------------
     // FUNCIONES AUXILIARES (FUERA DE RUN)
     // --------------------------------------------------------------------------
 
+    void ScanWorker::convertPins(const BoundaryScanEngine& engine, const DeviceModel& model, ScanMode mode,
+                                 PinDecoder& decoder, std::vector<PinState>& pins) {
+        const PinDecodePlan& plan = model.getDecodePlan();
+
+        // Motor y modelo deben coincidir en longitud; si no, el plan no es aplicable
+        if (mode == ScanMode::BYPASS || engine.getBSRLength() != plan.bsrLength) {
+            // En modo BYPASS el BSR no es accesible: ningún pin tiene datos
+            pins.assign(plan.size(), PinState{});
+            return;
+        }
+
+        // MODE-AWARE: de qué imagen salen salidas y controles
+        // EXTEST/INTEST: Usuario edita → buffer de escritura (bsr estable)
+        // SAMPLE: Solo lectura → buffer capturado (estado real del chip)
+        const bool editable = (mode == ScanMode::EXTEST || mode == ScanMode::INTEST);
+        const uint8_t* capture = engine.getBSRCapture().data();
+        decoder.decode(plan, capture, editable ? engine.getBSR().data() : capture, pins);
+    }
+
     void ScanWorker::processDirtyPins() {
         std::lock_guard<std::mutex> lock(dirtyMutex);
         for (const auto& [cellIndex, level] : dirtyPins) {
@@ -237,6 +334,94 @@ namespace JTAG {
         dirtyPins.clear();
     }
 
+    void ScanWorker::checkContention() {
+        if (!contentionDetector) {
+            contentionDetector = std::make_unique<ContentionDetector>(*deviceModel);
+            contentionDetector->setFaultCallback([this](const PinFaultEvent& event) {
+                pendingFaults.push_back(event);
+            });
+        }
+        if (contentionRestart.exchange(false)) contentionDetector->reset();
+
+        // La captura de este scan corresponde a la imagen del scan anterior
+        contentionDetector->check(engine->getBSRCapture(), engine->getBSR());
+        if (pendingFaults.empty()) return;
+
+        bool safeApplied = false;
+        if (contentionSafeState) {
+            // Todos los drivers a alta impedancia en el siguiente Update-DR
+            engine->setBSR(contentionDetector->makeSafeImage(engine->getBSR()));
+            safeApplied = engine->applyChanges();
+            contentionDetector->reset();
+        }
+
+        for (const auto& fault : pendingFaults) {
+            qWarning() << "[ScanWorker] Pin fault on" << QString::fromStdString(fault.pinName)
+                       << "driven" << (fault.drivenHigh ? "HIGH" : "LOW") << "at scan" << fault.scan;
+            emit pinFaultDetected(QString::fromStdString(fault.pinName), fault.drivenHigh, safeApplied);
+        }
+        pendingFaults.clear();
+    }
+
+    void ScanWorker::applyPendingTrigger() {
+        std::lock_guard<std::mutex> lock(triggerMutex);
+        triggerChanged = false;
+        if (!pendingTrigger) {
+            triggerEngine.disarm();
+            return;
+        }
+        if (triggerEngine.configure(*pendingTrigger, engine->getBSRLength())) {
+            triggerEngine.arm();
+        } else {
+            triggerArmed = false;
+            emit errorOccurred("Failed to arm trigger");
+        }
+        pendingTrigger.reset();
+    }
+
+    bool ScanWorker::runPendingBurst() {
+        BurstSpec spec;
+        {
+            std::lock_guard<std::mutex> lock(burstMutex);
+            burstRequested = false;
+            if (!pendingBurst) return false;
+            spec = *pendingBurst;
+            pendingBurst.reset();
+        }
+
+        BurstSampler sampler(engine);
+        if (!sampler.prepare(spec)) {
+            emit errorOccurred(QString("Burst capture: %1").arg(QString::fromStdString(sampler.getLastError())));
+            return false;
+        }
+        auto capture = sampler.run(burstAbort);
+        if (!capture) {
+            emit errorOccurred(QString("Burst capture: %1").arg(QString::fromStdString(sampler.getLastError())));
+            return false;
+        }
+        emit burstCaptured(capture, sampler.getStats().samplesPerSecond);
+        scheduler.start();   // Re-alinear: el tiempo de la ráfaga no cuenta como overrun
+        return true;
+    }
+
+    void ScanWorker::processCapture() {
+        const bool watching = pinWatcher.hasSubscriptions();
+        if (!triggerEngine.isActive() && !watching) return;
+
+        const auto& capture = engine->getBSRCapture();
+        if (capture.size() < bytesForBits(engine->getBSRLength())) return;
+
+        // Mismo instante para disparo y suscripciones: el del scan, no el de la evaluación
+        const uint64_t now = engine->getLastScanTiming().captureNs();
+        if (watching) pinWatcher.evaluate(capture.data(), now);
+        if (!triggerEngine.isActive() || !triggerEngine.feed(capture.data(), now)) return;
+
+        auto window = triggerEngine.takeCapture();
+        if (!triggerEngine.isActive()) triggerArmed = false;   // Modo single: se desarma solo
+        qDebug() << "[ScanWorker] Trigger fired, window of" << window->sampleCount << "samples";
+        emit triggerCaptured(window);
+    }
+
     // Función auxiliar (aunque ahora hacemos la carga en el bucle, la mantenemos por compatibilidad)
     void ScanWorker::applyMode(ScanMode mode) {
         // La lógica real está ahora integrada en run() para mayor robustez
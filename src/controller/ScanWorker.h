@@ -9,6 +9,11 @@
 #include <map>
 #include "../core/BoundaryScanEngine.h"
 #include "../bsdl/DeviceModel.h"
+#include "../monitor/ContentionDetector.h"
+#include "../monitor/TriggerEngine.h"
+#include "../monitor/PinWatcher.h"
+#include "../monitor/BurstSampler.h"
+#include "SampleScheduler.h"
 
 namespace JTAG {
 
@@ -21,19 +26,49 @@ namespace JTAG {
         BYPASS
     };
 
+    // Instantánea de pines con el momento real del scan que la produjo.
+    // Viaja sin copias por pinsUpdated → pinsDataReady hasta la GUI.
+    struct PinSnapshot {
+        std::vector<PinState> pins; // Uno por pin del DeviceModel (mismo índice que getAllPins())
+        uint64_t sequence = 0;      // ScanTiming::sequence del scan (repetido si no hubo scan)
+        uint64_t scanStartNs = 0;   // monotonicNowNs() alrededor de scanDR
+        uint64_t scanEndNs = 0;
+        uint64_t publishedNs = 0;   // Momento de emisión desde el worker
+        bool fresh = false;         // false: sin scan en este ciclo (EXTEST sin cambios, BYPASS)
+
+        // Timestamp de la muestra: punto medio del scan, o emisión si no hubo scan
+        uint64_t captureNs() const { return fresh ? scanStartNs + (scanEndNs - scanStartNs) / 2 : publishedNs; }
+    };
+
     class ScanWorker : public QObject {
         Q_OBJECT
 
     public:
-        explicit ScanWorker(BoundaryScanEngine* engine, DeviceModel* model, QObject* parent = nullptr);
+        explicit ScanWorker(BoundaryScanEngine* engine, const DeviceModel* model, QObject* parent = nullptr);
         ~ScanWorker();
 
         void start();
         void stop();
+
+        // Un ciclo de polling (scan + instantánea). Lo ejecuta el EngineExecutor en su
+        // hilo entre lotes de comandos; false = retirarse (stop() o single-shot)
+        bool pollCycle();
+        // Bucle propio sin executor: ciclos + esperas en el hilo que llama (benchmarks)
+        void run();
+        SampleScheduler& getScheduler() { return scheduler; }
         void setPollInterval(int ms);
 
-        // Nuevo: Control de Modo explícito
+        // Muestreo periódico con deadlines absolutos (ver SampleScheduler).
+        // Prioridad/afinidad se aplican en el hilo del worker en el siguiente ciclo.
+        void setPollPeriod(std::chrono::nanoseconds period);
+        void setSchedulerOptions(const SchedulerOptions& options);
+        SchedulerStats getSchedulerStats() const { return scheduler.getStats(); }
+
+        // Nuevo: Control de Modo explícito. Solo el modo deseado; el modo del engine
+        // lo sincroniza el controlador desde el hilo del executor (toOperationMode)
         void setScanMode(ScanMode mode);
+        ScanMode getScanMode() const { return currentMode.load(); }
+        static BoundaryScanEngine::OperationMode toOperationMode(ScanMode mode);
 
         // Thread-safe: Forzar recarga de instrucción (útil después de JTAG reset)
         void forceReloadInstruction();
@@ -44,40 +79,102 @@ namespace JTAG {
         // Método auxiliar para saber si hay cambios pendientes
         bool hasDirtyPins() const;
 
+        // Thread-safe: detección de contención en EXTEST (scan continuo mientras esté activa)
+        // autoSafeState: ante un fallo se aplica la imagen segura (todos los drivers en Z)
+        void setContentionDetection(bool enabled, bool autoSafeState);
+
+        // Thread-safe: disparo tipo analizador lógico sobre cada captura.
+        // Mientras está armado se escanea en cada ciclo (también en EXTEST) y
+        // la ventana completa se entrega con triggerCaptured()
+        bool armTrigger(const TriggerSpec& spec, QString* error = nullptr);
+        void disarmTrigger();
+        bool isTriggerArmed() const { return triggerArmed; }
+
+        // Suscripciones a cambios de pines (thread-safe). Con alguna activa se
+        // escanea en cada ciclo y cada captura se evalúa una vez
+        PinWatcher& getPinWatcher() { return pinWatcher; }
+
+        // Thread-safe: ráfaga de scans SAMPLE sin pausas (se ejecuta en el siguiente
+        // ciclo en modo SAMPLE; el resultado llega con burstCaptured()). Si el modo
+        // deja de ser SAMPLE antes de ejecutarla se descarta con errorOccurred()
+        void requestBurst(const BurstSpec& spec);
+        void abortBurst();
+
+        // Última captura del engine → estado por pin con el plan del modelo (reutiliza la
+        // capacidad de 'pins'). Entradas desde bsrCapture; salidas y controles desde bsr en
+        // EXTEST/INTEST (ediciones del usuario) o desde bsrCapture en SAMPLE. BYPASS → sin datos
+        static void convertPins(const BoundaryScanEngine& engine, const DeviceModel& model, ScanMode mode,
+                                PinDecoder& decoder, std::vector<PinState>& pins);
+
     signals:
         // FASE 2: shared_ptr evita 3 copias profundas en Qt::QueuedConnection
-        void pinsUpdated(std::shared_ptr<const std::vector<PinLevel>> pins);
+        void pinsUpdated(std::shared_ptr<const PinSnapshot> snapshot);
         void errorOccurred(QString message);
+        void pinFaultDetected(QString pinName, bool drivenHigh, bool safeStateApplied);
+        void triggerCaptured(std::shared_ptr<const TriggerCapture> capture);
+        void burstCaptured(std::shared_ptr<const TriggerCapture> capture, double samplesPerSecond);
         void started();
         void stopped();
 
-    public slots:
-        void run();
-
     private:
         void processDirtyPins();
-
+        void checkContention();
+        void applyPendingTrigger();
+        void processCapture();   // Disparo + suscripciones sobre la última captura
+        bool runPendingBurst();
 
         // Funciones de conmutación de bajo nivel
         void applyMode(ScanMode mode);
 
         BoundaryScanEngine* engine;
-        DeviceModel* deviceModel;
+        const DeviceModel* deviceModel;
+        PinDecoder pinDecoder;   // Solo desde el hilo del worker
 
         std::atomic<bool> running{ false };
-        std::atomic<int> pollIntervalMs{ 50 };
+        std::atomic<bool> restart{ false };     // start(): preparar el primer ciclo
+        SampleScheduler scheduler;
+        std::atomic<bool> threadOptionsChanged{ false };
         std::atomic<bool> forceReload{ false }; // Flag para forzar recarga de instrucción
 
         // Estado del modo deseado (Atómico para thread-safety)
         std::atomic<ScanMode> currentMode{ ScanMode::SAMPLE };
-        ScanMode lastAppliedMode{ ScanMode::SAMPLE }; // Para detectar cambios
+
+        // Estado entre ciclos (solo desde el hilo que ejecuta pollCycle)
+        ScanMode lastMode{ ScanMode::SAMPLE };
+        bool firstRun = true;
+        std::vector<PinState> pins;
 
         mutable std::mutex dirtyMutex;
         std::map<size_t, PinLevel> dirtyPins;
         std::map<size_t, PinLevel> desiredOutputs;
+
+        // Detector de contención (solo se usa desde el hilo del worker)
+        std::atomic<bool> contentionEnabled{ false };
+        std::atomic<bool> contentionSafeState{ false };
+        std::atomic<bool> contentionRestart{ false };
+        std::unique_ptr<ContentionDetector> contentionDetector;
+        std::vector<PinFaultEvent> pendingFaults;
+
+        // Disparo: la especificación se pasa al hilo del worker, que es el único que usa el engine
+        std::mutex triggerMutex;
+        std::unique_ptr<TriggerSpec> pendingTrigger;
+        std::atomic<bool> triggerChanged{ false };
+        std::atomic<bool> triggerArmed{ false };
+        TriggerEngine triggerEngine;
+
+        PinWatcher pinWatcher;
+
+        std::mutex burstMutex;
+        std::unique_ptr<BurstSpec> pendingBurst;
+        std::atomic<bool> burstRequested{ false };
+        std::atomic<bool> burstAbort{ false };
     };
 
 } // namespace JTAG
 
+#include "QtMetaTypes.h"
+
 // FASE 2: Registrar shared_ptr para señales Qt cross-thread
-Q_DECLARE_METATYPE(std::shared_ptr<const std::vector<JTAG::PinLevel>>)
\ No newline at end of file
+Q_DECLARE_METATYPE(std::shared_ptr<const std::vector<JTAG::PinLevel>>)
+Q_DECLARE_METATYPE(std::shared_ptr<const JTAG::PinSnapshot>)
+Q_DECLARE_METATYPE(std::shared_ptr<const JTAG::TriggerCapture>)
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+namespace JTAG {
+
+    // ============================================================================
+    // UTILIDADES DE BITS (LSB-first, mismo layout que bsr / bsrCapture)
+    // ============================================================================
+    // Bit i de un buffer = (buf[i / 8] >> (i % 8)) & 1
+    // Es el orden en que los bits salen por TDI (y entran por TDO).
+
+    inline bool getBit(const uint8_t* buf, size_t bit) {
+        return (buf[bit >> 3] >> (bit & 7)) & 1;
+    }
+
+    inline void setBit(uint8_t* buf, size_t bit, bool value) {
+        if (value) buf[bit >> 3] |= static_cast<uint8_t>(1u << (bit & 7));
+        else       buf[bit >> 3] &= static_cast<uint8_t>(~(1u << (bit & 7)));
+    }
+
+    inline size_t bytesForBits(size_t numBits) {
+        return (numBits + 7) / 8;
+    }
+
+    // Copia numBits desde src[srcOffset] a dst[dstOffset] (offsets en bits).
+    // Camino rápido con memcpy cuando ambos offsets están alineados a byte.
+    inline void copyBits(const uint8_t* src, size_t srcOffset,
+                         uint8_t* dst, size_t dstOffset, size_t numBits) {
+        if (numBits == 0) return;
+
+        if ((srcOffset & 7) == 0 && (dstOffset & 7) == 0) {
+            size_t fullBytes = numBits / 8;
+            std::memcpy(dst + dstOffset / 8, src + srcOffset / 8, fullBytes);
+            for (size_t i = fullBytes * 8; i < numBits; ++i) {
+                setBit(dst, dstOffset + i, getBit(src, srcOffset + i));
+            }
+            return;
+        }
+
+        for (size_t i = 0; i < numBits; ++i) {
+            setBit(dst, dstOffset + i, getBit(src, srcOffset + i));
+        }
+    }
+
+} // namespace JTAG
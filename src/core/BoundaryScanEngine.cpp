@@ -1,5 +1,9 @@
 #include "BoundaryScanEngine.h"
+#include "BitUtils.h"
+#include "MonotonicClock.h"
+#include "Instrumentation.h"
 #include <iostream>
+#include <iomanip>
 #include <algorithm>
 #include <cstring>
 
@@ -8,6 +12,18 @@ namespace JTAG {
     // NOTA: Hemos eliminado TAP_TRANSITION_TABLE y tapStateToString de aquí.
     // Ahora se usa la lógica centralizada en JtagStateMachine.
 
+    // Volcado hex de diagnóstico por std::cout (mismo stream que el resto del log, redirigible)
+    static void dumpHex(const std::vector<uint8_t>& bytes, const char* separator) {
+        std::ios_base::fmtflags flags = std::cout.flags();
+        char fill = std::cout.fill('0');
+        std::cout << std::hex << std::uppercase;
+        for (auto byte : bytes) {
+            std::cout << std::setw(2) << static_cast<int>(byte) << separator;
+        }
+        std::cout.flags(flags);
+        std::cout.fill(fill);
+    }
+
     // ============================================================================
     // IMPLEMENTACIÓN DE BoundaryScanEngine
     // ============================================================================
@@ -108,6 +124,7 @@ namespace JTAG {
     // ============================================================================
 
     bool BoundaryScanEngine::loadInstruction(uint32_t instruction, size_t irLength) {
+        ScopedStageTimer timer(Stage::IR_LOAD);
         std::cout << "BoundaryScanEngine::loadInstruction(0x" << std::hex << instruction
             << std::dec << ", " << irLength << " bits)\n";
 
@@ -121,9 +138,7 @@ namespace JTAG {
 
         // **DIAGNÓSTICO CRÍTICO**: Mostrar el buffer que se enviará
         std::cout << "  -> Sending IR bytes: 0x";
-        for (size_t i = 0; i < numBytes; i++) {
-            printf("%02X", dataIn[i]);
-        }
+        dumpHex(dataIn, "");
         std::cout << "\n";
 
         // Usar método transaccional de alto nivel
@@ -136,6 +151,7 @@ namespace JTAG {
 
         // El adapter nos deja en Run-Test/Idle después de scanIR
         currentState = TAPState::RUN_TEST_IDLE;
+        Instrumentation::instance().add(Counter::BITS_SHIFTED, irLength);
         return true;
     }
 
@@ -213,17 +229,14 @@ namespace JTAG {
         // - bsrCapture (TDO) recibe lo que el chip CAPTURÓ
 
         std::vector<uint8_t> dataOut;
+        Instrumentation::instance().add(Counter::TRACKED_ALLOCATIONS);   // dataOut por scan
+        uint64_t scanStart = monotonicNowNs();
         if (!adapter->scanDR(bsrLength, bsr, dataOut)) {
             std::cerr << "BoundaryScanEngine::applyChanges() - scanDR failed\n";
             return false;
         }
-
-        // DEBUG: mostrar datos capturados del chip (TDO)
-        std::cout << "DEBUG CAPTURED (TDO): ";
-        for (auto byte : dataOut) {
-            printf("%02X ", byte);
-        }
-        std::cout << std::endl;
+        lastScan = { lastScan.sequence + 1, scanStart, monotonicNowNs() };
+        countScan(1);
 
         // CORRECCIÓN: Guardar en buffer separado, NO sobrescribir bsr
         bsrCapture = dataOut;  // Guardar lectura del chip en buffer TDO
@@ -241,16 +254,14 @@ namespace JTAG {
         // Lo importante es la respuesta en dataOut (TDO)
 
         std::vector<uint8_t> dataOut;
+        Instrumentation::instance().add(Counter::TRACKED_ALLOCATIONS);   // dataOut por scan
+        uint64_t scanStart = monotonicNowNs();
         if (!adapter->scanDR(bsrLength, bsr, dataOut)) {
             std::cerr << "BoundaryScanEngine::samplePins() - scanDR failed\n";
             return false;
         }
-
-        std::cout << "RAW BSR SAMPLE (" << bsrLength << " bits): ";
-        for (auto byte : dataOut) {
-            printf("%02X ", byte);
-        }
-        std::cout << "\n";
+        lastScan = { lastScan.sequence + 1, scanStart, monotonicNowNs() };
+        countScan(1);
 
         // Guardar lectura en buffer separado
         bsrCapture = dataOut;
@@ -267,6 +278,43 @@ namespace JTAG {
         return true;
     }
 
+    void BoundaryScanEngine::countScan(size_t count) {
+        auto& stats = Instrumentation::instance();
+        stats.add(Counter::SCANS, count);
+        stats.add(Counter::BITS_SHIFTED, count * bsrLength);
+    }
+
+    bool BoundaryScanEngine::sampleBatch(size_t count, uint8_t* tdoImages) {
+        if (bsrLength == 0 || count == 0 || !tdoImages) return false;
+
+        const size_t stride = bytesForBits(bsrLength);
+        if (batchTdi.size() < count * stride) {
+            batchTdi.resize(count * stride);
+        }
+        // Se re-desplaza el bsr actual: en SAMPLE solo llega al latch de update
+        for (size_t i = 0; i < count; ++i) {
+            std::memcpy(batchTdi.data() + i * stride, bsr.data(), stride);
+        }
+
+        uint64_t scanStart = monotonicNowNs();
+        if (!adapter->scanDRBatch(bsrLength, count, batchTdi.data(), tdoImages)) {
+            std::cerr << "BoundaryScanEngine::sampleBatch() - scanDRBatch failed\n";
+            return false;
+        }
+        lastScan = { lastScan.sequence + count, scanStart, monotonicNowNs() };
+        countScan(count);
+
+        const uint8_t* last = tdoImages + (count - 1) * stride;
+        bsrCapture.assign(last, last + stride);
+        if (operationMode == OperationMode::SAMPLE ||
+            operationMode == OperationMode::BYPASS) {
+            bsr = bsrCapture;
+        }
+
+        currentState = TAPState::RUN_TEST_IDLE;
+        return true;
+    }
+
     bool BoundaryScanEngine::preloadBSR() {
         if (bsrLength == 0) return false;
 
@@ -7,7 +7,6 @@
 #include <memory>
 #include <optional>
 #include <cstddef> // Para size_t
-#include <QMetaType> // Para Q_DECLARE_METATYPE
 // -----------------------------
 
 #include "../hal/IJTAGAdapter.h"
@@ -21,6 +20,17 @@ namespace JTAG {
         HIGH_Z = 2
     };
 
+    // Momento del último scan DR con datos (monotonicNowNs() justo antes y
+    // después de la llamada al adaptador) y número de captura acumulado
+    struct ScanTiming {
+        uint64_t sequence = 0;      // sampleBatch() avanza una unidad por captura
+        uint64_t startNs = 0;
+        uint64_t endNs = 0;
+
+        // Capture-DR ocurre dentro de [start, end]: el punto medio acota el error a la mitad
+        uint64_t captureNs() const { return startNs + (endNs - startNs) / 2; }
+    };
+
     class BoundaryScanEngine {
     public:
         explicit BoundaryScanEngine(IJTAGAdapter* adapter, size_t bsrLength = 0);
@@ -47,6 +57,11 @@ namespace JTAG {
         bool applyChanges();
         bool samplePins();
 
+        // count scans SAMPLE consecutivos en una sola transacción del adaptador
+        // (scanDRBatch). tdoImages: count × bytesForBits(bsrLength) bytes.
+        // Sin conversión ni logging por muestra; bsrCapture queda con la última.
+        bool sampleBatch(size_t count, uint8_t* tdoImages);
+
         const std::vector<uint8_t>& getBSR() const { return bsr; }
         bool setBSR(const std::vector<uint8_t>& data);
 
@@ -56,6 +71,7 @@ namespace JTAG {
         // Métodos de lectura del buffer capturado (TDO)
         std::optional<PinLevel> getPinReadback(size_t cellIndex) const;
         const std::vector<uint8_t>& getBSRCapture() const { return bsrCapture; }
+        const ScanTiming& getLastScanTiming() const { return lastScan; }
 
         // Método para precarga IEEE 1149.1 (Solución A)
         bool preloadBSR();
@@ -73,6 +89,7 @@ namespace JTAG {
 
     private:
         TAPState getNextState(TAPState current, bool tms) const;
+        void countScan(size_t count);   // Contadores de instrumentación
 
         IJTAGAdapter* adapter;
         TAPState currentState;
@@ -84,11 +101,13 @@ namespace JTAG {
         // Buffer TDO (Read): Mantiene el estado "real" leído del chip
         std::vector<uint8_t> bsrCapture;
 
+        ScanTiming lastScan;
+
+        // Imágenes TDI repetidas para sampleBatch() (solo crece)
+        std::vector<uint8_t> batchTdi;
+
         // Tracking de modo JTAG para operaciones context-aware
         OperationMode operationMode = OperationMode::SAMPLE;
     };
 
 } // namespace JTAG
-
-// Declarar JTAG::PinLevel como metatype para Qt signals/slots
-Q_DECLARE_METATYPE(JTAG::PinLevel)
\ No newline at end of file
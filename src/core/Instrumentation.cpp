@@ -0,0 +1,183 @@
+#include "Instrumentation.h"
+#include "Json.h"
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+namespace JTAG {
+
+    const char* stageName(Stage stage) {
+        switch (stage) {
+            case Stage::IR_LOAD:             return "ir_load";
+            case Stage::TMS_NAVIGATION:      return "tms_navigation";
+            case Stage::SHIFT:               return "shift";
+            case Stage::ADAPTER_SYNC:        return "adapter_sync";
+            case Stage::SNAPSHOT_CONVERSION: return "snapshot_conversion";
+            case Stage::SIGNAL_DELIVERY:     return "signal_delivery";
+            case Stage::TABLE_UPDATE:        return "table_update";
+            case Stage::WAVEFORM_CAPTURE:    return "waveform_capture";
+            case Stage::RENDER:              return "render";
+            default:                         return "unknown";
+        }
+    }
+
+    const char* counterName(Counter counter) {
+        switch (counter) {
+            case Counter::SCANS:               return "scans";
+            case Counter::BITS_SHIFTED:        return "bits_shifted";
+            case Counter::DROPPED_FRAMES:      return "dropped_frames";
+            case Counter::TRACKED_ALLOCATIONS: return "tracked_allocations";
+            default:                           return "unknown";
+        }
+    }
+
+    // ============================================================================
+    // HISTOGRAMA
+    // ============================================================================
+
+    size_t LatencyHistogram::bucketFor(uint64_t value) {
+        if (value < SUB_BUCKETS) return static_cast<size_t>(value);   // Grupo 0: exacto
+
+        unsigned msb = 63;
+        while (!((value >> msb) & 1)) msb--;
+        unsigned exponent = msb - SUB_BITS + 1;            // >= 1
+        if (exponent > MAX_EXPONENT) return BUCKETS - 1;
+        size_t sub = static_cast<size_t>((value >> (exponent - 1)) & (SUB_BUCKETS - 1));
+        return exponent * SUB_BUCKETS + sub;
+    }
+
+    uint64_t LatencyHistogram::bucketValue(size_t bucket) {
+        size_t exponent = bucket / SUB_BUCKETS;
+        uint64_t sub = bucket % SUB_BUCKETS;
+        if (exponent == 0) return sub;
+        uint64_t width = 1ull << (exponent - 1);
+        uint64_t low = (SUB_BUCKETS + sub) << (exponent - 1);
+        return low + width / 2;
+    }
+
+    void LatencyHistogram::record(uint64_t valueNs) {
+        buckets[bucketFor(valueNs)].fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(valueNs, std::memory_order_relaxed);
+
+        uint64_t current = maximum.load(std::memory_order_relaxed);
+        while (valueNs > current && !maximum.compare_exchange_weak(current, valueNs, std::memory_order_relaxed)) {}
+    }
+
+    void LatencyHistogram::reset() {
+        for (auto& b : buckets) b.store(0, std::memory_order_relaxed);
+        total.store(0, std::memory_order_relaxed);
+        sum.store(0, std::memory_order_relaxed);
+        maximum.store(0, std::memory_order_relaxed);
+    }
+
+    uint64_t LatencyHistogram::percentileNs(double q) const {
+        uint64_t n = count();
+        if (n == 0) return 0;
+        uint64_t target = static_cast<uint64_t>(q * static_cast<double>(n - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            seen += buckets[i].load(std::memory_order_relaxed);
+            if (seen >= target) return std::min(bucketValue(i), maxNs());
+        }
+        return maxNs();
+    }
+
+    // ============================================================================
+    // REGISTRO GLOBAL
+    // ============================================================================
+
+    Instrumentation& Instrumentation::instance() {
+        static Instrumentation registry;
+        return registry;
+    }
+
+    Instrumentation::Instrumentation() {
+        resetAtNs.store(monotonicNowNs());
+    }
+
+    void Instrumentation::reset() {
+        for (auto& h : histograms) h.reset();
+        for (auto& c : counters) c.store(0, std::memory_order_relaxed);
+        resetAtNs.store(monotonicNowNs());
+    }
+
+    InstrumentationSnapshot Instrumentation::snapshot() const {
+        InstrumentationSnapshot snap;
+        snap.uptimeSeconds = (monotonicNowNs() - resetAtNs.load()) * 1e-9;
+
+        for (size_t i = 0; i < histograms.size(); ++i) {
+            const auto& h = histograms[i];
+            StageSummary s;
+            s.name = stageName(static_cast<Stage>(i));
+            s.count = h.count();
+            if (s.count > 0) {
+                s.meanUs = h.sumNs() / 1e3 / s.count;
+                s.p50Us = h.percentileNs(0.50) / 1e3;
+                s.p90Us = h.percentileNs(0.90) / 1e3;
+                s.p99Us = h.percentileNs(0.99) / 1e3;
+                s.maxUs = h.maxNs() / 1e3;
+                s.totalMs = h.sumNs() / 1e6;
+            }
+            snap.stages.push_back(std::move(s));
+        }
+
+        for (size_t i = 0; i < counters.size(); ++i) {
+            snap.counters.push_back({ counterName(static_cast<Counter>(i)), counters[i].load(std::memory_order_relaxed) });
+        }
+
+        if (snap.uptimeSeconds > 0) {
+            snap.scansPerSecond = counters[static_cast<size_t>(Counter::SCANS)].load() / snap.uptimeSeconds;
+            snap.bitsPerSecond = counters[static_cast<size_t>(Counter::BITS_SHIFTED)].load() / snap.uptimeSeconds;
+        }
+        return snap;
+    }
+
+    // ============================================================================
+    // EXPORTACIÓN
+    // ============================================================================
+
+    std::string InstrumentationSnapshot::toJson() const {
+        JsonValue root = JsonValue::object();
+        root.set("uptime_s", uptimeSeconds);
+        root.set("scans_per_second", scansPerSecond);
+        root.set("bits_per_second", bitsPerSecond);
+
+        JsonValue counterObj = JsonValue::object();
+        for (const auto& [name, value] : counters) counterObj.set(name, value);
+        root.set("counters", std::move(counterObj));
+
+        JsonValue stageArr = JsonValue::array();
+        for (const auto& s : stages) {
+            JsonValue st = JsonValue::object();
+            st.set("stage", s.name);
+            st.set("count", s.count);
+            st.set("mean_us", s.meanUs);
+            st.set("p50_us", s.p50Us);
+            st.set("p90_us", s.p90Us);
+            st.set("p99_us", s.p99Us);
+            st.set("max_us", s.maxUs);
+            st.set("total_ms", s.totalMs);
+            stageArr.push(std::move(st));
+        }
+        root.set("stages", std::move(stageArr));
+        return root.dump();
+    }
+
+    std::string InstrumentationSnapshot::toCsv() const {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(3);
+        out << "kind,name,count,mean_us,p50_us,p90_us,p99_us,max_us,total_ms\n";
+        for (const auto& s : stages) {
+            out << "stage," << s.name << ',' << s.count << ',' << s.meanUs << ',' << s.p50Us << ','
+                << s.p90Us << ',' << s.p99Us << ',' << s.maxUs << ',' << s.totalMs << '\n';
+        }
+        for (const auto& [name, value] : counters) {
+            out << "counter," << name << ',' << value << ",,,,,,\n";
+        }
+        out << "rate,scans_per_second," << scansPerSecond << ",,,,,,\n";
+        out << "rate,bits_per_second," << bitsPerSecond << ",,,,,,\n";
+        return out.str();
+    }
+
+} // namespace JTAG
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+#include "MonotonicClock.h"
+
+namespace JTAG {
+
+    // Etapas del camino scan → pantalla
+    enum class Stage {
+        IR_LOAD,              // BoundaryScanEngine::loadInstruction
+        TMS_NAVIGATION,       // Movimientos solo-TMS en el adaptador
+        SHIFT,                // Desplazamiento de datos (StoreGetRaw / scanDR)
+        ADAPTER_SYNC,         // Espera a que el adaptador vacíe su cola (SyncBits)
+        SNAPSHOT_CONVERSION,  // Bits → PinLevel + instantánea en el worker
+        SIGNAL_DELIVERY,      // Emisión en el worker → slot en el hilo GUI
+        TABLE_UPDATE,         // Tabla de pines + panel de control
+        WAVEFORM_CAPTURE,     // captureWaveformSample
+        RENDER,               // redrawWaveform
+        COUNT
+    };
+
+    enum class Counter {
+        SCANS,           // Capturas DR
+        BITS_SHIFTED,    // Bits de datos desplazados (DR + IR)
+        DROPPED_FRAMES,  // Periodos de muestreo perdidos por overrun
+        // Reservas del camino caliente contadas a mano donde se hacen (no intercepta
+        // el heap): un buffer TDO por scan del engine y una instantánea por publicación
+        // del worker. Una reserva nueva en ese camino debe añadir su add() aquí
+        TRACKED_ALLOCATIONS,
+        COUNT
+    };
+
+    const char* stageName(Stage stage);
+    const char* counterName(Counter counter);
+
+    /**
+     * @brief Histograma de latencias estilo HDR, sin locks
+     *
+     * Cubos log-lineales: la potencia de 2 del valor (en ns) elige el grupo y
+     * los SUB_BITS bits siguientes el cubo dentro del grupo, con lo que el
+     * error relativo es < 1/2^SUB_BITS (~6 %) de 1 ns a 2^(MAX_EXPONENT + SUB_BITS)
+     * ns = 2^44 ns (~4,9 horas); los valores mayores caen en el último cubo.
+     * record() son unas pocas operaciones atómicas relajadas: se puede llamar
+     * desde cualquier hilo a ritmo de scan.
+     */
+    class LatencyHistogram {
+    public:
+        static constexpr unsigned SUB_BITS = 4;
+        static constexpr unsigned SUB_BUCKETS = 1u << SUB_BITS;
+        static constexpr unsigned MAX_EXPONENT = 40;
+        static constexpr size_t BUCKETS = (MAX_EXPONENT + 1) * SUB_BUCKETS;
+
+        void record(uint64_t valueNs);
+        void reset();
+
+        uint64_t count() const { return total.load(std::memory_order_relaxed); }
+        uint64_t sumNs() const { return sum.load(std::memory_order_relaxed); }
+        uint64_t maxNs() const { return maximum.load(std::memory_order_relaxed); }
+        uint64_t percentileNs(double q) const;   // q en [0, 1]
+
+    private:
+        static size_t bucketFor(uint64_t value);
+        static uint64_t bucketValue(size_t bucket);   // Punto medio del cubo
+
+        std::array<std::atomic<uint64_t>, BUCKETS> buckets{};
+        std::atomic<uint64_t> total{ 0 };
+        std::atomic<uint64_t> sum{ 0 };
+        std::atomic<uint64_t> maximum{ 0 };
+    };
+
+    struct StageSummary {
+        std::string name;
+        uint64_t count = 0;
+        double meanUs = 0, p50Us = 0, p90Us = 0, p99Us = 0, maxUs = 0;
+        double totalMs = 0;
+    };
+
+    struct InstrumentationSnapshot {
+        double uptimeSeconds = 0;
+        std::vector<StageSummary> stages;
+        std::vector<std::pair<std::string, uint64_t>> counters;
+        double scansPerSecond = 0;     // Desde el último reset
+        double bitsPerSecond = 0;
+
+        std::string toJson() const;
+        std::string toCsv() const;
+    };
+
+    /**
+     * @brief Registro global de tiempos por etapa y contadores
+     *
+     * Un único objeto de proceso (las etapas están repartidas entre engine,
+     * adaptadores, worker y GUI). Desactivado, record()/add() solo leen un flag.
+     */
+    class Instrumentation {
+    public:
+        static Instrumentation& instance();
+
+        void setEnabled(bool on) { enabled.store(on, std::memory_order_relaxed); }
+        bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+        void record(Stage stage, uint64_t durationNs) {
+            if (isEnabled()) histograms[static_cast<size_t>(stage)].record(durationNs);
+        }
+        void add(Counter counter, uint64_t amount = 1) {
+            if (isEnabled()) counters[static_cast<size_t>(counter)].fetch_add(amount, std::memory_order_relaxed);
+        }
+
+        InstrumentationSnapshot snapshot() const;
+        void reset();
+
+    private:
+        Instrumentation();
+
+        std::atomic<bool> enabled{ true };
+        std::atomic<uint64_t> resetAtNs{ 0 };
+        std::array<LatencyHistogram, static_cast<size_t>(Stage::COUNT)> histograms;
+        std::array<std::atomic<uint64_t>, static_cast<size_t>(Counter::COUNT)> counters{};
+    };
+
+    // Mide el ámbito actual y lo registra en la etapa al salir
+    class ScopedStageTimer {
+    public:
+        explicit ScopedStageTimer(Stage stage) : stage(stage), start(monotonicNowNs()) {}
+        ~ScopedStageTimer() { Instrumentation::instance().record(stage, monotonicNowNs() - start); }
+
+        ScopedStageTimer(const ScopedStageTimer&) = delete;
+        ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+    private:
+        Stage stage;
+        uint64_t start;
+    };
+
+} // namespace JTAG
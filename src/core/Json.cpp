@@ -0,0 +1,374 @@
+#include "Json.h"
+#include <cstdio>
+#include <cmath>
+#include <charconv>
+
+namespace JTAG {
+
+    namespace {
+
+        const JsonValue& nullValue() {
+            static const JsonValue value;
+            return value;
+        }
+
+        // ============================================================================
+        // PARSER RECURSIVO DESCENDENTE
+        // ============================================================================
+
+        class Parser {
+        public:
+            explicit Parser(std::string_view text) : text(text) {}
+
+            bool parseDocument(JsonValue& out) {
+                skipWhitespace();
+                if (!parseValue(out, 0)) return false;
+                skipWhitespace();
+                if (pos != text.size()) return fail("Unexpected trailing characters");
+                return true;
+            }
+
+            std::string error;
+            size_t pos = 0;
+
+        private:
+            static constexpr int MAX_DEPTH = 256;
+
+            bool fail(const char* message) {
+                if (error.empty()) error = std::string(message) + " at offset " + std::to_string(pos);
+                return false;
+            }
+
+            void skipWhitespace() {
+                while (pos < text.size() &&
+                       (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r')) {
+                    pos++;
+                }
+            }
+
+            bool consume(char c) {
+                skipWhitespace();
+                if (pos < text.size() && text[pos] == c) { pos++; return true; }
+                return false;
+            }
+
+            bool literal(std::string_view word) {
+                if (text.substr(pos, word.size()) != word) return false;
+                pos += word.size();
+                return true;
+            }
+
+            bool parseValue(JsonValue& out, int depth) {
+                if (depth > MAX_DEPTH) return fail("Nesting too deep");
+                skipWhitespace();
+                if (pos >= text.size()) return fail("Unexpected end of input");
+
+                char c = text[pos];
+                if (c == '{') return parseObject(out, depth);
+                if (c == '[') return parseArray(out, depth);
+                if (c == '"') {
+                    std::string s;
+                    if (!parseString(s)) return false;
+                    out = JsonValue(std::move(s));
+                    return true;
+                }
+                if (c == '-' || (c >= '0' && c <= '9')) return parseNumber(out);
+                if (literal("true")) { out = JsonValue(true); return true; }
+                if (literal("false")) { out = JsonValue(false); return true; }
+                if (literal("null")) { out = JsonValue(); return true; }
+                return fail("Unexpected character");
+            }
+
+            bool parseObject(JsonValue& out, int depth) {
+                pos++;   // '{'
+                JsonValue::Object members;
+                if (consume('}')) { out = JsonValue(std::move(members)); return true; }
+
+                do {
+                    skipWhitespace();
+                    std::string key;
+                    if (pos >= text.size() || text[pos] != '"' || !parseString(key)) return fail("Expected member name");
+                    if (!consume(':')) return fail("Expected ':'");
+                    JsonValue value;
+                    if (!parseValue(value, depth + 1)) return false;
+                    members.emplace_back(std::move(key), std::move(value));
+                } while (consume(','));
+
+                if (!consume('}')) return fail("Expected '}'");
+                out = JsonValue(std::move(members));
+                return true;
+            }
+
+            bool parseArray(JsonValue& out, int depth) {
+                pos++;   // '['
+                JsonValue::Array items;
+                if (consume(']')) { out = JsonValue(std::move(items)); return true; }
+
+                do {
+                    JsonValue value;
+                    if (!parseValue(value, depth + 1)) return false;
+                    items.push_back(std::move(value));
+                } while (consume(','));
+
+                if (!consume(']')) return fail("Expected ']'");
+                out = JsonValue(std::move(items));
+                return true;
+            }
+
+            static void appendUtf8(std::string& s, uint32_t cp) {
+                if (cp < 0x80) {
+                    s += static_cast<char>(cp);
+                } else if (cp < 0x800) {
+                    s += static_cast<char>(0xC0 | (cp >> 6));
+                    s += static_cast<char>(0x80 | (cp & 0x3F));
+                } else if (cp < 0x10000) {
+                    s += static_cast<char>(0xE0 | (cp >> 12));
+                    s += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                    s += static_cast<char>(0x80 | (cp & 0x3F));
+                } else {
+                    s += static_cast<char>(0xF0 | (cp >> 18));
+                    s += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+                    s += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                    s += static_cast<char>(0x80 | (cp & 0x3F));
+                }
+            }
+
+            bool parseHex4(uint32_t& cp) {
+                if (pos + 4 > text.size()) return fail("Truncated \\u escape");
+                cp = 0;
+                for (int i = 0; i < 4; ++i) {
+                    char h = text[pos++];
+                    cp <<= 4;
+                    if (h >= '0' && h <= '9') cp |= h - '0';
+                    else if (h >= 'a' && h <= 'f') cp |= h - 'a' + 10;
+                    else if (h >= 'A' && h <= 'F') cp |= h - 'A' + 10;
+                    else return fail("Invalid \\u escape");
+                }
+                return true;
+            }
+
+            bool parseString(std::string& out) {
+                pos++;   // '"'
+                size_t runStart = pos;
+                while (pos < text.size()) {
+                    char c = text[pos];
+                    if (c == '"') {
+                        out.append(text.data() + runStart, pos - runStart);
+                        pos++;
+                        return true;
+                    }
+                    if (static_cast<unsigned char>(c) < 0x20) return fail("Control character in string");
+                    if (c != '\\') { pos++; continue; }
+
+                    out.append(text.data() + runStart, pos - runStart);
+                    pos++;
+                    if (pos >= text.size()) break;
+                    char e = text[pos++];
+                    switch (e) {
+                    case '"': out += '"'; break;
+                    case '\\': out += '\\'; break;
+                    case '/': out += '/'; break;
+                    case 'b': out += '\b'; break;
+                    case 'f': out += '\f'; break;
+                    case 'n': out += '\n'; break;
+                    case 'r': out += '\r'; break;
+                    case 't': out += '\t'; break;
+                    case 'u': {
+                        uint32_t cp = 0;
+                        if (!parseHex4(cp)) return false;
+                        // Sustitutos: solo en pareja alto + bajo (si no, el UTF-8 sería inválido)
+                        if (cp >= 0xDC00 && cp < 0xE000) return fail("Invalid surrogate");
+                        if (cp >= 0xD800 && cp < 0xDC00) {
+                            if (text.substr(pos, 2) != "\\u") return fail("Invalid surrogate");
+                            pos += 2;
+                            uint32_t low = 0;
+                            if (!parseHex4(low)) return false;
+                            if (low < 0xDC00 || low >= 0xE000) return fail("Invalid surrogate");
+                            cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                        }
+                        appendUtf8(out, cp);
+                        break;
+                    }
+                    default:
+                        return fail("Invalid escape");
+                    }
+                    runStart = pos;
+                }
+                return fail("Unterminated string");
+            }
+
+            // Gramática estricta de RFC 8259: -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+            bool parseNumber(JsonValue& out) {
+                size_t start = pos;
+                if (text[pos] == '-') pos++;
+                if (pos < text.size() && text[pos] == '0') pos++;
+                else if (!skipDigits()) return fail("Invalid number");
+                if (pos < text.size() && text[pos] == '.') {
+                    pos++;
+                    if (!skipDigits()) return fail("Invalid number");
+                }
+                if (pos < text.size() && (text[pos] == 'e' || text[pos] == 'E')) {
+                    pos++;
+                    if (pos < text.size() && (text[pos] == '+' || text[pos] == '-')) pos++;
+                    if (!skipDigits()) return fail("Invalid number");
+                }
+                // from_chars no depende de LC_NUMERIC (strtod sí: Qt lo cambia en locales con coma decimal)
+                double value = 0.0;
+                const char* first = text.data() + start;
+                const char* last = text.data() + pos;
+                const auto result = std::from_chars(first, last, value);
+                if (result.ec == std::errc::invalid_argument || result.ptr != last) return fail("Invalid number");
+                if (result.ec == std::errc::result_out_of_range) return fail("Number out of range");
+                out = JsonValue(value);
+                return true;
+            }
+
+            bool skipDigits() {
+                size_t start = pos;
+                while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') pos++;
+                return pos > start;
+            }
+
+            std::string_view text;
+        };
+
+        void dumpString(std::string& out, const std::string& s) {
+            out += '"';
+            for (unsigned char c : s) {
+                switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (c < 0x20) {
+                        char buf[8];
+                        std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                        out += buf;
+                    } else {
+                        out += static_cast<char>(c);
+                    }
+                }
+            }
+            out += '"';
+        }
+
+    } // namespace
+
+    // ============================================================================
+    // ACCESO
+    // ============================================================================
+
+    const JsonValue* JsonValue::find(std::string_view key) const {
+        if (type != Type::Object) return nullptr;
+        for (const auto& member : objectValue) {
+            if (member.first == key) return &member.second;
+        }
+        return nullptr;
+    }
+
+    const JsonValue& JsonValue::operator[](std::string_view key) const {
+        const JsonValue* value = find(key);
+        return value ? *value : nullValue();
+    }
+
+    const JsonValue& JsonValue::operator[](size_t index) const {
+        if (type != Type::Array || index >= arrayValue.size()) return nullValue();
+        return arrayValue[index];
+    }
+
+    size_t JsonValue::size() const {
+        if (type == Type::Array) return arrayValue.size();
+        if (type == Type::Object) return objectValue.size();
+        return 0;
+    }
+
+    JsonValue& JsonValue::set(std::string key, JsonValue value) {
+        if (type != Type::Object) {
+            *this = object();
+        }
+        for (auto& member : objectValue) {
+            if (member.first == key) {
+                member.second = std::move(value);
+                return member.second;
+            }
+        }
+        objectValue.emplace_back(std::move(key), std::move(value));
+        return objectValue.back().second;
+    }
+
+    JsonValue& JsonValue::push(JsonValue value) {
+        if (type != Type::Array) {
+            *this = array();
+        }
+        arrayValue.push_back(std::move(value));
+        return arrayValue.back();
+    }
+
+    // ============================================================================
+    // PARSEO / SERIALIZACIÓN
+    // ============================================================================
+
+    std::optional<JsonValue> JsonValue::parse(std::string_view text, std::string* error) {
+        Parser parser(text);
+        JsonValue value;
+        if (!parser.parseDocument(value)) {
+            if (error) *error = parser.error;
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    std::string JsonValue::dump() const {
+        std::string out;
+        dump(out);
+        return out;
+    }
+
+    void JsonValue::dump(std::string& out) const {
+        switch (type) {
+        case Type::Null:
+            out += "null";
+            break;
+        case Type::Bool:
+            out += boolValue ? "true" : "false";
+            break;
+        case Type::Number: {
+            if (!std::isfinite(numberValue)) {
+                out += "null";
+            } else if (numberValue == std::floor(numberValue) && std::fabs(numberValue) < 9.007199254740992e15) {
+                out += std::to_string(static_cast<int64_t>(numberValue));
+            } else {
+                // Representación más corta que vuelve al mismo double, sin locale
+                char buf[32];
+                const auto result = std::to_chars(buf, buf + sizeof(buf), numberValue);
+                out.append(buf, result.ptr);
+            }
+            break;
+        }
+        case Type::String:
+            dumpString(out, stringValue);
+            break;
+        case Type::Array:
+            out += '[';
+            for (size_t i = 0; i < arrayValue.size(); ++i) {
+                if (i) out += ',';
+                arrayValue[i].dump(out);
+            }
+            out += ']';
+            break;
+        case Type::Object:
+            out += '{';
+            for (size_t i = 0; i < objectValue.size(); ++i) {
+                if (i) out += ',';
+                dumpString(out, objectValue[i].first);
+                out += ':';
+                objectValue[i].second.dump(out);
+            }
+            out += '}';
+            break;
+        }
+    }
+
+} // namespace JTAG
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <optional>
+#include <cstdint>
+
+namespace JTAG {
+
+    /**
+     * @brief Valor JSON mínimo (sin dependencias de Qt)
+     *
+     * Lo justo para ficheros de netlist/configuración y mensajes de
+     * automatización: parseo recursivo descendente y serialización compacta.
+     * Los objetos conservan el orden de inserción.
+     */
+    class JsonValue {
+    public:
+        enum class Type { Null, Bool, Number, String, Array, Object };
+
+        using Array = std::vector<JsonValue>;
+        using Object = std::vector<std::pair<std::string, JsonValue>>;
+
+        JsonValue() = default;
+        JsonValue(std::nullptr_t) {}
+        JsonValue(bool value) : type(Type::Bool), boolValue(value) {}
+        JsonValue(int value) : type(Type::Number), numberValue(value) {}
+        JsonValue(int64_t value) : type(Type::Number), numberValue(static_cast<double>(value)) {}
+        JsonValue(uint64_t value) : type(Type::Number), numberValue(static_cast<double>(value)) {}
+        JsonValue(uint32_t value) : type(Type::Number), numberValue(value) {}
+        JsonValue(double value) : type(Type::Number), numberValue(value) {}
+        JsonValue(const char* value) : type(Type::String), stringValue(value) {}
+        JsonValue(std::string value) : type(Type::String), stringValue(std::move(value)) {}
+        JsonValue(Array value) : type(Type::Array), arrayValue(std::move(value)) {}
+        JsonValue(Object value) : type(Type::Object), objectValue(std::move(value)) {}
+
+        static JsonValue array() { return JsonValue(Array{}); }
+        static JsonValue object() { return JsonValue(Object{}); }
+
+        Type getType() const { return type; }
+        bool isNull() const { return type == Type::Null; }
+        bool isBool() const { return type == Type::Bool; }
+        bool isNumber() const { return type == Type::Number; }
+        bool isString() const { return type == Type::String; }
+        bool isArray() const { return type == Type::Array; }
+        bool isObject() const { return type == Type::Object; }
+
+        bool asBool(bool fallback = false) const { return isBool() ? boolValue : fallback; }
+        double asNumber(double fallback = 0.0) const { return isNumber() ? numberValue : fallback; }
+        int64_t asInt(int64_t fallback = 0) const { return isNumber() ? static_cast<int64_t>(numberValue) : fallback; }
+        const std::string& asString() const { return stringValue; }
+        const Array& asArray() const { return arrayValue; }
+        const Object& asObject() const { return objectValue; }
+
+        // Acceso de lectura: miembros/elementos inexistentes devuelven null
+        const JsonValue& operator[](std::string_view key) const;
+        const JsonValue& operator[](size_t index) const;
+        const JsonValue* find(std::string_view key) const;
+        bool contains(std::string_view key) const { return find(key) != nullptr; }
+        size_t size() const;
+
+        // Construcción
+        JsonValue& set(std::string key, JsonValue value);   // Objeto (sustituye si existe)
+        JsonValue& push(JsonValue value);                   // Array
+
+        static std::optional<JsonValue> parse(std::string_view text, std::string* error = nullptr);
+        std::string dump() const;
+        void dump(std::string& out) const;
+
+    private:
+        Type type = Type::Null;
+        bool boolValue = false;
+        double numberValue = 0.0;
+        std::string stringValue;
+        Array arrayValue;
+        Object objectValue;
+    };
+
+} // namespace JTAG
@@ -0,0 +1,124 @@
+#include "MappedFile.h"
+#include <utility>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace JTAG {
+
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+#if defined(_WIN32)
+            fileHandle = std::exchange(other.fileHandle, nullptr);
+            mappingHandle = std::exchange(other.mappingHandle, nullptr);
+#else
+            fd = std::exchange(other.fd, -1);
+#endif
+        }
+        return *this;
+    }
+
+#if defined(_WIN32)
+
+    bool MappedFile::open(const std::filesystem::path& path) {
+        close();
+
+        HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ,
+                                  nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+            CloseHandle(file);
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) {
+            CloseHandle(file);
+            return false;
+        }
+
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!view) {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+
+        fileHandle = file;
+        mappingHandle = mapping;
+        data_ = static_cast<const uint8_t*>(view);
+        size_ = static_cast<size_t>(fileSize.QuadPart);
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (data_) UnmapViewOfFile(data_);
+        if (mappingHandle) CloseHandle(static_cast<HANDLE>(mappingHandle));
+        if (fileHandle) CloseHandle(static_cast<HANDLE>(fileHandle));
+        data_ = nullptr;
+        size_ = 0;
+        mappingHandle = nullptr;
+        fileHandle = nullptr;
+    }
+
+#else
+
+    bool MappedFile::open(const std::filesystem::path& path) {
+        close();
+
+        int file = ::open(path.c_str(), O_RDONLY);
+        if (file < 0) return false;
+
+        struct stat st;
+        if (fstat(file, &st) != 0 || st.st_size == 0) {
+            ::close(file);
+            return false;
+        }
+
+        void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        if (view == MAP_FAILED) {
+            ::close(file);
+            return false;
+        }
+
+        // Los consumidores recorren el fichero de forma secuencial
+        madvise(view, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+
+        fd = file;
+        data_ = static_cast<const uint8_t*>(view);
+        size_ = static_cast<size_t>(st.st_size);
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (data_) munmap(const_cast<uint8_t*>(data_), size_);
+        if (fd >= 0) ::close(fd);
+        data_ = nullptr;
+        size_ = 0;
+        fd = -1;
+    }
+
+#endif
+
+} // namespace JTAG
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <filesystem>
+
+namespace JTAG {
+
+    /**
+     * @brief Fichero de solo lectura proyectado en memoria (mmap / MapViewOfFile)
+     *
+     * Permite acceder a ficheros binarios grandes (vectores compilados, caché de
+     * modelos) sin copiarlos a heap: el sistema operativo pagina bajo demanda.
+     */
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        bool open(const std::filesystem::path& path);
+        void close();
+
+        bool isOpen() const { return data_ != nullptr; }
+        const uint8_t* data() const { return data_; }
+        size_t size() const { return size_; }
+
+    private:
+        const uint8_t* data_ = nullptr;
+        size_t size_ = 0;
+
+#if defined(_WIN32)
+        void* fileHandle = nullptr;
+        void* mappingHandle = nullptr;
+#else
+        int fd = -1;
+#endif
+    };
+
+} // namespace JTAG
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace JTAG {
+
+    // ============================================================================
+    // RELOJ MONÓTONO COMÚN
+    // ============================================================================
+    // Todos los timestamps de captura (scans, disparos, ráfagas, suscripciones)
+    // usan esta base: steady_clock en nanosegundos (CLOCK_MONOTONIC en Linux).
+    // Son comparables entre hilos y no saltan con cambios de hora del sistema.
+
+    inline uint64_t monotonicNowNs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+} // namespace JTAG
@@ -0,0 +1,165 @@
+#include "BsdlLibraryDialog.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFileDialog>
+#include <QSettings>
+#include <QMetaObject>
+
+// Rutas Qt ↔ std::filesystem con soporte Unicode completo en Windows
+static std::filesystem::path toFilesystemPath(const QString &path)
+{
+#ifdef _WIN32
+    return std::filesystem::path(path.toStdWString());
+#else
+    return std::filesystem::path(path.toStdString());
+#endif
+}
+
+static QString fromFilesystemPath(const std::filesystem::path &path)
+{
+#ifdef _WIN32
+    return QString::fromStdWString(path.wstring());
+#else
+    return QString::fromStdString(path.string());
+#endif
+}
+
+BsdlLibraryDialog::BsdlLibraryDialog(JTAG::BsdlLibrary &library, QWidget *parent)
+    : QDialog(parent)
+    , library(library)
+{
+    setWindowTitle("BSDL Library");
+    setMinimumSize(560, 340);
+    refreshPool.setMaxThreadCount(1);
+    setupUI();
+}
+
+BsdlLibraryDialog::~BsdlLibraryDialog()
+{
+    // El worker usa su propia copia, pero entrega el resultado a este objeto
+    refreshPool.waitForDone();
+}
+
+void BsdlLibraryDialog::setupUI()
+{
+    QVBoxLayout *layout = new QVBoxLayout(this);
+
+    QLabel *helpLabel = new QLabel("Folders searched (recursively) for BSDL files. "
+                                   "Examine Chain matches the detected IDCODE against this library.", this);
+    helpLabel->setWordWrap(true);
+    layout->addWidget(helpLabel);
+
+    folderList = new QListWidget(this);
+    for (const auto &dir : library.getDirectories()) {
+        folderList->addItem(fromFilesystemPath(dir));
+    }
+    layout->addWidget(folderList);
+
+    statusLabel = new QLabel(QString("%1 BSDL files indexed").arg(library.size()), this);
+    layout->addWidget(statusLabel);
+
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+    addButton = new QPushButton("Add Folder...", this);
+    removeButton = new QPushButton("Remove", this);
+    rescanButton = new QPushButton("Rescan", this);
+    closeButton = new QPushButton("Close", this);
+    buttonLayout->addWidget(addButton);
+    buttonLayout->addWidget(removeButton);
+    buttonLayout->addWidget(rescanButton);
+    buttonLayout->addStretch();
+    buttonLayout->addWidget(closeButton);
+    layout->addLayout(buttonLayout);
+
+    connect(addButton, &QPushButton::clicked, this, &BsdlLibraryDialog::onAddFolder);
+    connect(removeButton, &QPushButton::clicked, this, &BsdlLibraryDialog::onRemoveFolder);
+    connect(rescanButton, &QPushButton::clicked, this, &BsdlLibraryDialog::startRefresh);
+    connect(closeButton, &QPushButton::clicked, this, &QDialog::accept);
+}
+
+void BsdlLibraryDialog::done(int result)
+{
+    // onRefreshFinished() sustituye la biblioteca: el diálogo espera al escaneo
+    if (refreshing) {
+        return;
+    }
+    QDialog::done(result);
+}
+
+void BsdlLibraryDialog::onAddFolder()
+{
+    QString dir = QFileDialog::getExistingDirectory(this, "Add BSDL Folder");
+    if (dir.isEmpty() || !folderList->findItems(dir, Qt::MatchExactly).isEmpty()) {
+        return;
+    }
+    folderList->addItem(dir);
+    applyFolders();
+    startRefresh();
+}
+
+void BsdlLibraryDialog::onRemoveFolder()
+{
+    QList<QListWidgetItem*> selected = folderList->selectedItems();
+    if (selected.isEmpty()) {
+        return;
+    }
+    qDeleteAll(selected);
+    applyFolders();
+    startRefresh();
+}
+
+void BsdlLibraryDialog::applyFolders()
+{
+    QStringList dirs;
+    std::vector<std::filesystem::path> paths;
+    for (int i = 0; i < folderList->count(); ++i) {
+        dirs << folderList->item(i)->text();
+        paths.push_back(toFilesystemPath(folderList->item(i)->text()));
+    }
+    QSettings settings("TopJTAG", "BoundaryScanner");
+    settings.setValue("bsdl/libraryDirs", dirs);
+    library.setDirectories(std::move(paths));
+}
+
+void BsdlLibraryDialog::startRefresh()
+{
+    if (refreshing) {
+        return;
+    }
+    setRefreshing(true);
+    statusLabel->setText("Scanning BSDL folders...");
+
+    // Copia: el hilo de la GUI puede seguir consultando la biblioteca mientras tanto
+    auto scanned = std::make_shared<JTAG::BsdlLibrary>(library);
+    refreshPool.start([this, scanned]() {
+        JTAG::BsdlLibrary::RefreshStats stats = scanned->refresh();
+        QMetaObject::invokeMethod(this, [this, scanned, stats]() {
+            onRefreshFinished(scanned, stats);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void BsdlLibraryDialog::onRefreshFinished(std::shared_ptr<JTAG::BsdlLibrary> scanned,
+                                          const JTAG::BsdlLibrary::RefreshStats &stats)
+{
+    library = std::move(*scanned);
+    setRefreshing(false);
+    statusLabel->setText(QString("%1 BSDL files indexed (%2 scanned, %3 unchanged, %4 removed, "
+                                 "%5 without IDCODE) in %6 ms")
+                             .arg(stats.files).arg(stats.scanned).arg(stats.reused).arg(stats.removed)
+                             .arg(stats.withoutIdcode).arg(stats.seconds * 1000.0, 0, 'f', 0));
+}
+
+void BsdlLibraryDialog::setRefreshing(bool on)
+{
+    refreshing = on;
+    addButton->setEnabled(!on);
+    removeButton->setEnabled(!on);
+    rescanButton->setEnabled(!on);
+    closeButton->setEnabled(!on);
+    folderList->setEnabled(!on);
+    if (on) {
+        setCursor(Qt::BusyCursor);
+    } else {
+        unsetCursor();
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef BSDLLIBRARYDIALOG_H
+#define BSDLLIBRARYDIALOG_H
+
+#include <QDialog>
+#include <QListWidget>
+#include <QLabel>
+#include <QPushButton>
+#include <QThreadPool>
+#include <memory>
+
+#include "../bsdl/BsdlLibrary.h"
+
+/**
+ * @brief Folders of the BSDL library used for IDCODE auto-match
+ *
+ * Folders are searched recursively; the index (entity, IDCODE, IR length) is
+ * refreshed incrementally on a worker thread and saved next to the model cache.
+ * The worker scans a copy of the library that replaces the original when it
+ * finishes, so BsdlLibrary itself stays single-threaded. Examine Chain uses the
+ * library to propose the device BSDL.
+ */
+class BsdlLibraryDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit BsdlLibraryDialog(JTAG::BsdlLibrary &library, QWidget *parent = nullptr);
+    ~BsdlLibraryDialog();
+
+    void done(int result) override;   // Ignored while a rescan is running
+
+private slots:
+    void onAddFolder();
+    void onRemoveFolder();
+    void startRefresh();
+
+private:
+    void setupUI();
+    void applyFolders();
+    void onRefreshFinished(std::shared_ptr<JTAG::BsdlLibrary> scanned,
+                           const JTAG::BsdlLibrary::RefreshStats &stats);
+    void setRefreshing(bool on);
+
+    JTAG::BsdlLibrary &library;
+
+    QListWidget *folderList;
+    QLabel *statusLabel;
+    QPushButton *addButton;
+    QPushButton *removeButton;
+    QPushButton *rescanButton;
+    QPushButton *closeButton;
+
+    QThreadPool refreshPool;   // One worker; the destructor waits for it
+    bool refreshing = false;
+};
+
+#endif // BSDLLIBRARYDIALOG_H
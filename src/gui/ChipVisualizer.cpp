@@ -336,27 +336,10 @@ void ChipVisualizer::updatePinName(const QString& oldName, const QString& newNam
 // ============================================================================
 
 ChipVisualizer::ParsedPin ChipVisualizer::parsePinNumber(const QString& pinNumber) {
-    ParsedPin result{0, 0, false};
-    if (pinNumber.isEmpty()) return result;
-
-    // Separar letras (row) y números (col)
-    int i = 0;
-    int rowVal = 0;
-
-    // Parsear letras: A=0, B=1, ..., Z=25, AA=26, AB=27
-    while (i < pinNumber.size() && pinNumber[i].isLetter()) {
-        rowVal = rowVal * 26 + (pinNumber[i].toUpper().toLatin1() - 'A');
-        i++;
-    }
-
-    // Parsear números: "7" → 6 (0-based)
-    QString colStr = pinNumber.mid(i);
-    if (colStr.isEmpty()) return result;
-
-    result.row = rowVal;
-    result.col = colStr.toInt() - 1;
-    result.valid = true;
-    return result;
+    // Mismo parseo que las claves de orden de DeviceModel (A=0 … Z=25, AA=26; "7" → 6)
+    const QByteArray latin = pinNumber.toLatin1();
+    const JTAG::PinNumberKey key = JTAG::makePinNumberKey(std::string_view(latin.constData(), latin.size()));
+    return ParsedPin{ key.row, key.col, key.isGrid() };
 }
 
 ChipVisualizer::PinSide ChipVisualizer::determineSide(int row, int col, int maxRow, int maxCol) {
@@ -422,47 +405,51 @@ void ChipVisualizer::addPin(const QString& name, const QString& number, double x
 }
 
 void ChipVisualizer::renderFromDeviceModel(const JTAG::DeviceModel& model, const QString& customDeviceName) {
-    // 1. Limpieza obligatoria de la escena (Qt)
-    m_scene->clear();
-    m_pins.clear();
-    m_chipBody = nullptr;
-
-    // 2. Obtener pines
-    auto pins = model.getAllPins();
-    if (pins.empty()) return;
-
-    // Detectar tipo de pin automáticamente
-    using PinType = typename std::decay<decltype(pins[0])>::type;
-
-    // -----------------------------------------------------------------------
-    // LÓGICA DE ORDENACIÓN (C++ PURO - SIN QT)
-    // -----------------------------------------------------------------------
-    // Ordena: P1, P2, P3... P10 (numérico) en lugar de P1, P10, P2 (alfabético)
-    std::sort(pins.begin(), pins.end(), [](const PinType& a, const PinType& b) {
-        std::string sA = a.pinNumber;
-        std::string sB = b.pinNumber;
-
-        // Función lambda local para extraer números de std::string
-        auto extractNumber = [](const std::string& s) -> int {
-            std::string numStr;
-            for (char c : s) {
-                if (std::isdigit(static_cast<unsigned char>(c))) {
-                    numStr += c;
-                }
-            }
-            return numStr.empty() ? 0 : std::stoi(numStr);
-            };
-
-        int nA = extractNumber(sA);
-        int nB = extractNumber(sB);
+    ChipLayout layout;
+    if (!computeLayout(model, layoutParams(customDeviceName), layout)) {
+        // Modelo sin pines: escena vacía
+        m_scene->clear();
+        m_pins.clear();
+        m_chipBody = nullptr;
+        return;
+    }
+    applyLayout(layout);
+}
+
+ChipLayoutParams ChipVisualizer::layoutParams(const QString& customDeviceName) const {
+    ChipLayoutParams params;
+    params.width = m_chipWidth;
+    params.height = m_chipHeight;
+    params.edgePins = (m_layoutMode == LayoutMode::EDGE_PINS);
+    params.customDeviceName = customDeviceName;
+    return params;
+}
+
+/**
+ * @brief Calcula la posición de cada pin sin tocar la escena
+ *
+ * Solo lee el modelo y los parámetros: se puede llamar desde el pool de carga
+ * de BSDL mientras la GUI sigue respondiendo.
+ */
+bool ChipVisualizer::computeLayout(const JTAG::DeviceModel& model, const ChipLayoutParams& params, ChipLayout& layout,
+                                   const std::function<bool()>& cancelled) {
+    layout = ChipLayout();
+
+    // 1. Obtener pines
+    // DeviceModel ya los entrega en orden natural (P1, P2 … P10; A1, A2 … B1)
+    // con las claves de número de pin precalculadas: no se copian ni se reordenan.
+    const JTAG::PinRange pins = model.getAllPins();
+    const auto& pinKeys = model.getPinNumberKeys();
+    if (pins.empty()) return false;
+
+    auto toQString = [](std::string_view text) {
+        return QString::fromUtf8(text.data(), static_cast<int>(text.size()));
+    };
 
-        // Prioridad: Orden numérico si existen números distintos
-        if (nA != 0 && nB != 0 && nA != nB) {
-            return nA < nB;
-        }
-        // Fallback: Orden alfabético
-        return sA < sB;
-        });
+    // Comprobación de cancelación cada bloque de pines (no por pin)
+    auto abandoned = [&cancelled](size_t index) {
+        return cancelled && (index & 255) == 0 && cancelled();
+    };
 
     // -----------------------------------------------------------------------
     // PREPARACIÓN DE DATOS
@@ -472,153 +459,142 @@ void ChipVisualizer::renderFromDeviceModel(const JTAG::DeviceModel& model, const
     uint32_t actualIdCode = model.getIDCODE();
 
     // Usar nombre personalizado si se proporciona, sino usar el del BSDL
-    QString deviceName;
-    if (!customDeviceName.isEmpty()) {
-        deviceName = customDeviceName;
+    if (!params.customDeviceName.isEmpty()) {
+        layout.deviceName = params.customDeviceName;
     } else {
-        deviceName = QString::fromStdString(model.getDeviceName());
+        layout.deviceName = QString::fromStdString(model.getDeviceName());
     }
 
     // Formatear texto para mostrar
     char idBuffer[64];
     std::snprintf(idBuffer, sizeof(idBuffer), "0x%08X", actualIdCode);
-    QString idCodeText = QString::fromLatin1(idBuffer);
+    layout.idCodeText = QString::fromLatin1(idBuffer);
 
     int totalPins = static_cast<int>(pins.size());
 
     // --- TAMAÑO DEL CHIP ---
-    // NOTA: He puesto esto como variables locales para solucionar tu error de compilación.
-    // Si quieres usar valores del Wizard, asegúrate de pasarlos a esta clase.
-    double w = this->m_chipWidth;
-    double h = this->m_chipHeight;
-    qDebug() << "[ChipVisualizer] renderFromDeviceModel using dimensions:" << w << "x" << h;
-
-    // TODO: Si en el futuro añades las variables al .h, descomenta esto:
-    // w = this->m_chipWidth;
-    // h = this->m_chipHeight;
-    // if (w <= 50.0) w = 400.0; // Protección
-    // if (h <= 50.0) h = 400.0;
+    double w = params.width;
+    double h = params.height;
+    qDebug() << "[ChipVisualizer] computeLayout using dimensions:" << w << "x" << h;
+
+    layout.edgePins = params.edgePins;
+    layout.width = w;
+    layout.height = h;
+    layout.pins.reserve(pins.size());
 
     double hw = w / 2.0;
     double hh = h / 2.0;
 
-    // --- DISTRIBUCIÓN DE PINES ---
-    // Distribución PROPORCIONAL a las dimensiones del chip
-    // para mantener spacing uniforme entre todos los pines
-    int nTop = 0, nRight = 0, nBottom = 0, nLeft = 0;
-
-    // Calcular perímetro total y densidad de pines
-    double perimeterTotal = 2.0 * w + 2.0 * h;
-    double pinsPerUnit = static_cast<double>(totalPins) / perimeterTotal;
-
-    // Asignar pines proporcionalmente a cada lado según su longitud
-    nTop = static_cast<int>(std::round(w * pinsPerUnit));
-    nBottom = static_cast<int>(std::round(w * pinsPerUnit));
-    nLeft = static_cast<int>(std::round(h * pinsPerUnit));
-    nRight = static_cast<int>(std::round(h * pinsPerUnit));
-
-    // Ajustar diferencia por redondeo
-    int assigned = nTop + nBottom + nLeft + nRight;
-    int diff = totalPins - assigned;
-
-    if (diff > 0) {
-        // Faltan pines: agregar al lado más largo
-        if (w >= h) {
-            nTop += diff;  // Agregar al lado horizontal
-        } else {
-            nLeft += diff;  // Agregar al lado vertical
-        }
-    } else if (diff < 0) {
-        // Sobran pines: quitar del lado más largo
-        if (w >= h) {
-            nTop += diff;  // diff es negativo, resta
-        } else {
-            nLeft += diff;
-        }
-    }
-
-    qDebug() << "[ChipVisualizer] Pin distribution for" << w << "x" << h
-             << ": Top=" << nTop << ", Right=" << nRight
-             << ", Bottom=" << nBottom << ", Left=" << nLeft
-             << "(Total=" << (nTop + nBottom + nLeft + nRight) << ")";
-
-    // --- CALCULAR TAMAÑO DE FUENTE ÓPTIMO ---
-    // Basado en el mínimo spacing entre pines
-    const double margin = 40.0;
-    double minSpacing = 1000.0;  // Valor inicial grande
-
-    if (nLeft > 1) {
-        double spacing = (h - 2 * margin) / (nLeft - 1);
-        minSpacing = std::min(minSpacing, spacing);
-    }
-    if (nRight > 1) {
-        double spacing = (h - 2 * margin) / (nRight - 1);
-        minSpacing = std::min(minSpacing, spacing);
-    }
-    if (nTop > 1) {
-        double spacing = (w - 2 * margin) / (nTop - 1);
-        minSpacing = std::min(minSpacing, spacing);
-    }
-    if (nBottom > 1) {
-        double spacing = (w - 2 * margin) / (nBottom - 1);
-        minSpacing = std::min(minSpacing, spacing);
-    }
+    auto place = [&](size_t index, double x, double y, ChipLayout::Side side) {
+        const JTAG::PinView pin = pins[index];
+        ChipLayout::Pin placed;
+        placed.name = toQString(pin.name);
+        placed.number = toQString(pin.pinNumber);
+        placed.type = QString::fromLatin1(JTAG::pinTypeName(pin.type));
+        placed.x = x;
+        placed.y = y;
+        placed.side = side;
+        layout.pins.push_back(std::move(placed));
+    };
 
-    // Calcular tamaño de fuente: entre 4pt y 8pt basado en spacing
-    // Si spacing < 15 → fuente 4pt
-    // Si spacing > 30 → fuente 8pt
-    // Entre 15-30 → interpolación lineal
-    int labelFontSize = 7;  // Default
-    if (minSpacing < 1000.0) {  // Si se calculó algo
-        if (minSpacing < 15.0) {
-            labelFontSize = 4;
-        } else if (minSpacing > 30.0) {
-            labelFontSize = 8;
-        } else {
-            // Interpolación lineal: 15→4pt, 30→8pt
-            labelFontSize = 4 + static_cast<int>((minSpacing - 15.0) / 15.0 * 4.0);
+    if (params.edgePins) {
+
+        // --- DISTRIBUCIÓN DE PINES ---
+        // Distribución PROPORCIONAL a las dimensiones del chip
+        // para mantener spacing uniforme entre todos los pines
+        int nTop = 0, nRight = 0, nBottom = 0, nLeft = 0;
+
+        // Calcular perímetro total y densidad de pines
+        double perimeterTotal = 2.0 * w + 2.0 * h;
+        double pinsPerUnit = static_cast<double>(totalPins) / perimeterTotal;
+
+        // Asignar pines proporcionalmente a cada lado según su longitud
+        nTop = static_cast<int>(std::round(w * pinsPerUnit));
+        nBottom = static_cast<int>(std::round(w * pinsPerUnit));
+        nLeft = static_cast<int>(std::round(h * pinsPerUnit));
+        nRight = static_cast<int>(std::round(h * pinsPerUnit));
+
+        // Ajustar diferencia por redondeo
+        int assigned = nTop + nBottom + nLeft + nRight;
+        int diff = totalPins - assigned;
+
+        if (diff > 0) {
+            // Faltan pines: agregar al lado más largo
+            if (w >= h) {
+                nTop += diff;  // Agregar al lado horizontal
+            } else {
+                nLeft += diff;  // Agregar al lado vertical
+            }
+        } else if (diff < 0) {
+            // Sobran pines: quitar del lado más largo
+            if (w >= h) {
+                nTop += diff;  // diff es negativo, resta
+            } else {
+                nLeft += diff;
+            }
         }
-    }
 
-    // --- CALCULAR TAMAÑO DE PIN UNIFORME ---
-    // CRÍTICO: Todos los pines deben tener el MISMO tamaño
-    // Usamos el spacing mínimo como restricción global
-    double uniformPinSize = 8.0;  // Default
-    if (minSpacing < 1000.0) {
-        uniformPinSize = minSpacing * 0.8;
-        // Clamp entre 4px y 18px
-        if (uniformPinSize > 18.0) uniformPinSize = 18.0;
-        if (uniformPinSize < 4.0) uniformPinSize = 4.0;
-    }
-    qDebug() << "[ChipVisualizer] Uniform pin size:" << uniformPinSize
-             << "(based on min spacing:" << minSpacing << ")";
+        qDebug() << "[ChipVisualizer] Pin distribution for" << w << "x" << h
+                 << ": Top=" << nTop << ", Right=" << nRight
+                 << ", Bottom=" << nBottom << ", Left=" << nLeft
+                 << "(Total=" << (nTop + nBottom + nLeft + nRight) << ")";
 
-    // -----------------------------------------------------------------------
-    // RENDERIZADO (DIBUJO EN SCENE)
-    // -----------------------------------------------------------------------
+        // --- CALCULAR TAMAÑO DE FUENTE ÓPTIMO ---
+        // Basado en el mínimo spacing entre pines
+        const double margin = 40.0;
+        double minSpacing = 1000.0;  // Valor inicial grande
 
-    if (m_layoutMode == LayoutMode::EDGE_PINS) {
+        if (nLeft > 1) {
+            double spacing = (h - 2 * margin) / (nLeft - 1);
+            minSpacing = std::min(minSpacing, spacing);
+        }
+        if (nRight > 1) {
+            double spacing = (h - 2 * margin) / (nRight - 1);
+            minSpacing = std::min(minSpacing, spacing);
+        }
+        if (nTop > 1) {
+            double spacing = (w - 2 * margin) / (nTop - 1);
+            minSpacing = std::min(minSpacing, spacing);
+        }
+        if (nBottom > 1) {
+            double spacing = (w - 2 * margin) / (nBottom - 1);
+            minSpacing = std::min(minSpacing, spacing);
+        }
 
-        // Cuerpo y Marca
-        m_chipBody = m_scene->addRect(-hw, -hh, w, h, QPen(Qt::black, 2), QBrush(Qt::white));
-        m_scene->addEllipse(-hw + 8, -hh + 8, 15, 15, QPen(Qt::black, 2), QBrush(Qt::white));
+        // Calcular tamaño de fuente: entre 4pt y 8pt basado en spacing
+        // Si spacing < 15 → fuente 4pt
+        // Si spacing > 30 → fuente 8pt
+        // Entre 15-30 → interpolación lineal
+        int labelFontSize = 7;  // Default
+        if (minSpacing < 1000.0) {  // Si se calculó algo
+            if (minSpacing < 15.0) {
+                labelFontSize = 4;
+            } else if (minSpacing > 30.0) {
+                labelFontSize = 8;
+            } else {
+                // Interpolación lineal: 15→4pt, 30→8pt
+                labelFontSize = 4 + static_cast<int>((minSpacing - 15.0) / 15.0 * 4.0);
+            }
+        }
 
-        // Texto del nombre del device (arriba) - Con más margen para evitar colisión con pines
-        QFont nameFont; nameFont.setPointSize(16); nameFont.setBold(true);
-        QGraphicsTextItem* nameItem = m_scene->addText(deviceName, nameFont);
-        QRectF nameRect = nameItem->boundingRect();
-        nameItem->setPos(-nameRect.width() / 2.0, -hh - nameRect.height() - 70);
+        // --- CALCULAR TAMAÑO DE PIN UNIFORME ---
+        // CRÍTICO: Todos los pines deben tener el MISMO tamaño
+        // Usamos el spacing mínimo como restricción global
+        double uniformPinSize = 8.0;  // Default
+        if (minSpacing < 1000.0) {
+            uniformPinSize = minSpacing * 0.8;
+            // Clamp entre 4px y 18px
+            if (uniformPinSize > 18.0) uniformPinSize = 18.0;
+            if (uniformPinSize < 4.0) uniformPinSize = 4.0;
+        }
+        qDebug() << "[ChipVisualizer] Uniform pin size:" << uniformPinSize
+                 << "(based on min spacing:" << minSpacing << ")";
 
-        // Texto IDCODE (debajo del nombre) - Posicionado entre el nombre y los pines
-        QFont idFont; idFont.setPointSize(12);
-        QGraphicsTextItem* idItem = m_scene->addText(QString("IDCODE: ") + idCodeText, idFont);
-        idItem->setDefaultTextColor(QColor(100, 100, 100));
-        QRectF idRect = idItem->boundingRect();
-        idItem->setPos(-idRect.width() / 2.0, -hh - idRect.height() - 40);
+        layout.pinSize = uniformPinSize;
+        layout.labelFontSize = labelFontSize;
 
         // --- BUCLE DE COLOCACIÓN (Orden Anti-Horario: Left -> Bottom -> Right -> Top) ---
         int pIdx = 0;
-        const double margin = 40.0;
 
         // 1. IZQUIERDO (Left): De Arriba hacia Abajo -> Pin 1 empieza aquí (arriba a la izquierda)
         if (nLeft > 0) {
@@ -626,13 +602,11 @@ void ChipVisualizer::renderFromDeviceModel(const JTAG::DeviceModel& model, const
             double spacing = (nLeft > 1) ? available / (nLeft - 1) : available;
 
             for (int i = 0; i < nLeft && pIdx < totalPins; ++i) {
+                if (abandoned(pIdx)) return false;
                 // Avanzamos de arriba hacia abajo
                 double y = -hh + margin + (i * spacing) - (uniformPinSize / 2.0);
                 // X = Borde izquierdo (-hw) menos tamaño del pin (hacia fuera)
-                addPin(QString::fromStdString(pins[pIdx].name),
-                    QString::fromStdString(pins[pIdx].pinNumber),
-                    -hw - uniformPinSize, y, PinSide::LEFT, uniformPinSize, labelFontSize,
-                    QString::fromStdString(pins[pIdx].type));
+                place(pIdx, -hw - uniformPinSize, y, ChipLayout::Side::LEFT);
                 pIdx++;
             }
         }
@@ -643,13 +617,11 @@ void ChipVisualizer::renderFromDeviceModel(const JTAG::DeviceModel& model, const
             double spacing = (nBottom > 1) ? available / (nBottom - 1) : available;
 
             for (int i = 0; i < nBottom && pIdx < totalPins; ++i) {
+                if (abandoned(pIdx)) return false;
                 // Avanzamos de izquierda a derecha
                 double x = -hw + margin + (i * spacing) - (uniformPinSize / 2.0);
                 // Y = Borde inferior (+hh)
-                addPin(QString::fromStdString(pins[pIdx].name),
-                    QString::fromStdString(pins[pIdx].pinNumber),
-                    x, hh, PinSide::BOTTOM, uniformPinSize, labelFontSize,
-                    QString::fromStdString(pins[pIdx].type));
+                place(pIdx, x, hh, ChipLayout::Side::BOTTOM);
                 pIdx++;
             }
         }
@@ -660,13 +632,11 @@ void ChipVisualizer::renderFromDeviceModel(const JTAG::DeviceModel& model, const
             double spacing = (nRight > 1) ? available / (nRight - 1) : available;
 
             for (int i = 0; i < nRight && pIdx < totalPins; ++i) {
+                if (abandoned(pIdx)) return false;
                 // Avanzamos de abajo hacia arriba
                 double y = hh - margin - (i * spacing) - (uniformPinSize / 2.0);
                 // X = Borde derecho (+hw)
-                addPin(QString::fromStdString(pins[pIdx].name),
-                    QString::fromStdString(pins[pIdx].pinNumber),
-                    hw, y, PinSide::RIGHT, uniformPinSize, labelFontSize,
-                    QString::fromStdString(pins[pIdx].type));
+                place(pIdx, hw, y, ChipLayout::Side::RIGHT);
                 pIdx++;
             }
         }
@@ -677,13 +647,11 @@ void ChipVisualizer::renderFromDeviceModel(const JTAG::DeviceModel& model, const
             double spacing = (nTop > 1) ? available / (nTop - 1) : available;
 
             for (int i = 0; i < nTop && pIdx < totalPins; ++i) {
+                if (abandoned(pIdx)) return false;
                 // Avanzamos de derecha a izquierda
                 double x = hw - margin - (i * spacing) - (uniformPinSize / 2.0);
                 // Y = Borde superior (-hh) menos tamaño del pin (hacia fuera)
-                addPin(QString::fromStdString(pins[pIdx].name),
-                    QString::fromStdString(pins[pIdx].pinNumber),
-                    x, -hh - uniformPinSize, PinSide::TOP, uniformPinSize, labelFontSize,
-                    QString::fromStdString(pins[pIdx].type));
+                place(pIdx, x, -hh - uniformPinSize, ChipLayout::Side::TOP);
                 pIdx++;
             }
         }
@@ -692,7 +660,33 @@ void ChipVisualizer::renderFromDeviceModel(const JTAG::DeviceModel& model, const
     else {
         // --- MODO BGA / CENTER GRID ---
 
-        // 1. Cálculo inteligente de filas/cols basado en el Aspect Ratio (Ancho/Alto)
+        // 1. Rejilla real del encapsulado si todos los pines son fila+columna (A1, AB12)
+        // Las filas/columnas se compactan a las que existen (JEDEC omite I, O, Q…)
+        std::vector<int> rowSlot, colSlot;
+        bool realGrid = pinKeys.size() == pins.size();
+        for (size_t i = 0; realGrid && i < pinKeys.size(); ++i) {
+            realGrid = pinKeys[i].isGrid();
+        }
+        if (realGrid) {
+            auto compact = [](std::vector<int> values) {
+                std::sort(values.begin(), values.end());
+                values.erase(std::unique(values.begin(), values.end()), values.end());
+                return values;
+            };
+            std::vector<int> rawRows, rawCols;
+            rawRows.reserve(pinKeys.size());
+            rawCols.reserve(pinKeys.size());
+            for (const auto& key : pinKeys) {
+                rawRows.push_back(key.row);
+                rawCols.push_back(key.col);
+            }
+            rowSlot = compact(std::move(rawRows));
+            colSlot = compact(std::move(rawCols));
+            // Una sola fila o columna no es un BGA (p.ej. P1..P144): reparto secuencial
+            realGrid = rowSlot.size() > 1 && colSlot.size() > 1;
+        }
+
+        // Cálculo inteligente de filas/cols basado en el Aspect Ratio (Ancho/Alto)
         // Esto "adapta la altura al tamaño" distribuyendo los pines mejor.
         double aspectRatio = (h > 0) ? w / h : 1.0;
 
@@ -705,6 +699,11 @@ void ChipVisualizer::renderFromDeviceModel(const JTAG::DeviceModel& model, const
         // Ajuste fino por si el redondeo dejó huecos o sobrantes
         while (rows * cols < totalPins) cols++;
 
+        if (realGrid) {
+            rows = static_cast<int>(rowSlot.size());
+            cols = static_cast<int>(colSlot.size());
+        }
+
         // 2. Cálculos de espaciado
         // Márgenes internos para que no toque el borde exacto
         double padding = 40.0;
@@ -729,46 +728,83 @@ void ChipVisualizer::renderFromDeviceModel(const JTAG::DeviceModel& model, const
             labelFontSize = 4 + static_cast<int>((minSp - 15.0) / 15.0 * 4.0);
         }
 
-        // 3. Dibujar Cuerpo (FONDO BLANCO SOLICITADO)
-        // Usamos Qt::white en lugar de QColor(50,50,50)
-        m_chipBody = m_scene->addRect(-hw, -hh, w, h, QPen(Qt::black, 3), QBrush(Qt::white));
+        layout.pinSize = size;
+        layout.labelFontSize = labelFontSize;
 
-        // Marca de Pin 1 (Círculo negro en esquina superior izquierda)
-        m_scene->addEllipse(-hw + 8, -hh + 8, 15, 15, QPen(Qt::black, 2), QBrush(Qt::black));
+        // 3. Bucle de colocación (Izquierda -> Derecha, Arriba -> Abajo)
+        for (size_t idx = 0; idx < pins.size(); ++idx) {
+            if (abandoned(idx)) return false;
 
-        // Texto del nombre del device (arriba) - Modo BGA (con más margen)
-        QFont nameFontBGA; nameFontBGA.setPointSize(16); nameFontBGA.setBold(true);
-        QGraphicsTextItem* nameItemBGA = m_scene->addText(deviceName, nameFontBGA);
-        QRectF nameRectBGA = nameItemBGA->boundingRect();
-        nameItemBGA->setPos(-nameRectBGA.width() / 2.0, -hh - nameRectBGA.height() - 70);
-
-        // Texto IDCODE (debajo del nombre) - Modo BGA (posicionado entre nombre y chip)
-        QFont idFontBGA; idFontBGA.setPointSize(12);
-        QGraphicsTextItem* idItemBGA = m_scene->addText(QString("IDCODE: ") + idCodeText, idFontBGA);
-        idItemBGA->setDefaultTextColor(QColor(100, 100, 100));
-        QRectF idRectBGA = idItemBGA->boundingRect();
-        idItemBGA->setPos(-idRectBGA.width() / 2.0, -hh - idRectBGA.height() - 40);
-
-        // 4. Bucle de colocación (Izquierda -> Derecha, Arriba -> Abajo)
-        int idx = 0;
-        for (const auto& p : pins) {
             // Calcular fila y columna actual
-            int r = idx / cols;
-            int c = idx % cols;
+            int r = static_cast<int>(idx) / cols;
+            int c = static_cast<int>(idx) % cols;
+            if (realGrid) {
+                r = static_cast<int>(std::lower_bound(rowSlot.begin(), rowSlot.end(), pinKeys[idx].row) - rowSlot.begin());
+                c = static_cast<int>(std::lower_bound(colSlot.begin(), colSlot.end(), pinKeys[idx].col) - colSlot.begin());
+            }
 
             // Coordenadas: Inicio (-hw) + Margen + (Columna * Espacio) - Centro del Pin
             double x = -hw + (padding / 2.0) + (c * spX) - (size / 2.0);
             double y = -hh + (padding / 2.0) + (r * spY) - (size / 2.0);
 
             // Side: En BGA (CENTER_GRID), todos los labels van DEBAJO para evitar colisiones
-            PinSide labelSide = BOTTOM;
+            place(idx, x, y, ChipLayout::Side::BOTTOM);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Crea los items de la escena a partir de una geometría ya calculada
+ */
+void ChipVisualizer::applyLayout(const ChipLayout& layout) {
+    // 1. Limpieza obligatoria de la escena (Qt)
+    m_scene->clear();
+    m_pins.clear();
+    m_chipBody = nullptr;
+
+    const double w = layout.width;
+    const double h = layout.height;
+    const double hw = w / 2.0;
+    const double hh = h / 2.0;
+
+    // -----------------------------------------------------------------------
+    // RENDERIZADO (DIBUJO EN SCENE)
+    // -----------------------------------------------------------------------
+
+    // Cuerpo y marca de pin 1 (BGA: trazo más grueso y marca rellena en negro)
+    if (layout.edgePins) {
+        m_chipBody = m_scene->addRect(-hw, -hh, w, h, QPen(Qt::black, 2), QBrush(Qt::white));
+        m_scene->addEllipse(-hw + 8, -hh + 8, 15, 15, QPen(Qt::black, 2), QBrush(Qt::white));
+    } else {
+        m_chipBody = m_scene->addRect(-hw, -hh, w, h, QPen(Qt::black, 3), QBrush(Qt::white));
+        m_scene->addEllipse(-hw + 8, -hh + 8, 15, 15, QPen(Qt::black, 2), QBrush(Qt::black));
+    }
 
-            addPin(QString::fromStdString(p.name),
-                QString::fromStdString(p.pinNumber),
-                x, y, labelSide, size, labelFontSize,
-                QString::fromStdString(p.type));
-            idx++;
+    // Texto del nombre del device (arriba) - Con más margen para evitar colisión con pines
+    QFont nameFont; nameFont.setPointSize(16); nameFont.setBold(true);
+    QGraphicsTextItem* nameItem = m_scene->addText(layout.deviceName, nameFont);
+    QRectF nameRect = nameItem->boundingRect();
+    nameItem->setPos(-nameRect.width() / 2.0, -hh - nameRect.height() - 70);
+
+    // Texto IDCODE (debajo del nombre) - Posicionado entre el nombre y los pines
+    QFont idFont; idFont.setPointSize(12);
+    QGraphicsTextItem* idItem = m_scene->addText(QString("IDCODE: ") + layout.idCodeText, idFont);
+    idItem->setDefaultTextColor(QColor(100, 100, 100));
+    QRectF idRect = idItem->boundingRect();
+    idItem->setPos(-idRect.width() / 2.0, -hh - idRect.height() - 40);
+
+    // Pines: solo creación de items, la geometría ya viene calculada
+    for (const auto& pin : layout.pins) {
+        PinSide side = BOTTOM;
+        switch (pin.side) {
+        case ChipLayout::Side::LEFT: side = LEFT; break;
+        case ChipLayout::Side::RIGHT: side = RIGHT; break;
+        case ChipLayout::Side::TOP: side = TOP; break;
+        case ChipLayout::Side::BOTTOM: side = BOTTOM; break;
         }
+        addPin(pin.name, pin.number, pin.x, pin.y, side, layout.pinSize, layout.labelFontSize, pin.type);
     }
 
     // --- LEYENDA (Usando Qt para pintar) ---
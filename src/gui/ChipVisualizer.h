@@ -9,6 +9,8 @@
 #include <QString>
 #include <vector> // Necesario para std::vector
 #include <string> // Necesario para std::string
+#include <functional>
+#include "../bsdl/PinNumberKey.h"
 
 // NUEVO: Para renderFromDeviceModel()
 namespace JTAG {
@@ -83,6 +85,45 @@ private:
     double m_customHeight = 400.0;
 };
 
+/**
+ * @brief Parámetros de layout leídos del visualizador en el hilo GUI
+ */
+struct ChipLayoutParams {
+    double width = 400.0;
+    double height = 400.0;
+    bool edgePins = false;        // EDGE (TQFP) o CENTER (BGA)
+    QString customDeviceName;     // Vacío = nombre del BSDL
+};
+
+/**
+ * @brief Geometría completa del chip en datos planos
+ *
+ * ChipVisualizer::computeLayout la calcula solo a partir del DeviceModel, sin
+ * tocar la escena, así que puede ejecutarse fuera del hilo GUI (carga
+ * asíncrona del BSDL). applyLayout se limita a crear los items.
+ */
+struct ChipLayout {
+    enum class Side { LEFT, RIGHT, TOP, BOTTOM };
+
+    struct Pin {
+        QString name;
+        QString number;
+        QString type;
+        double x = 0.0;
+        double y = 0.0;
+        Side side = Side::BOTTOM;
+    };
+
+    bool edgePins = false;
+    double width = 400.0;
+    double height = 400.0;
+    double pinSize = 8.0;
+    int labelFontSize = 7;
+    QString deviceName;
+    QString idCodeText;
+    std::vector<Pin> pins;
+};
+
 /**
  * @brief Chip visualization widget (TopJTAG style)
  */
@@ -104,6 +145,13 @@ public:
     // NUEVO: Renderizar desde DeviceModel con layout real
     void renderFromDeviceModel(const JTAG::DeviceModel& model, const QString& customDeviceName = QString());
 
+    // Render en dos fases: computeLayout en cualquier hilo (cancelled() se consulta
+    // durante la colocación; devuelve false si se abandona), applyLayout en el hilo GUI
+    ChipLayoutParams layoutParams(const QString& customDeviceName = QString()) const;
+    static bool computeLayout(const JTAG::DeviceModel& model, const ChipLayoutParams& params, ChipLayout& layout,
+                              const std::function<bool()>& cancelled = {});
+    void applyLayout(const ChipLayout& layout);
+
     // NEW: Color-coded visualization API
     void updatePinState(const QString& pinName, VisualPinState state);
     void highlightPin(const QString& pinName);
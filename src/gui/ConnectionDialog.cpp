@@ -3,6 +3,7 @@
 #include <QHBoxLayout>
 #include <QGroupBox>
 #include <QMessageBox>
+#include <QFileDialog>
 
 // Usamos el namespace para no escribir JTAG:: todo el rato en el cpp
 using namespace JTAG;
@@ -122,6 +123,9 @@ void ConnectionDialog::updateDescription() {
         case AdapterType::PICO:
             description = "<b>Raspberry Pi Pico</b><br>Low cost USB-JTAG.";
             break;
+        case AdapterType::REPLAY:
+            description = "<b>Trace Replay</b><br>Replays a recorded session (.jtr) without hardware.";
+            break;
         default:
             description = "Unknown adapter.";
             break;
@@ -148,6 +152,16 @@ void ConnectionDialog::onConnectClicked() {
         m_selectedAdapter = m_selectedDescriptor.type;
     }
 
+    // Replay: la traza se elige aquí y viaja en el deviceID
+    if (m_selectedAdapter == AdapterType::REPLAY) {
+        QString tracePath = QFileDialog::getOpenFileName(this, "Select Session Trace", "",
+            "JTAG Trace (*.jtr);;All Files (*)");
+        if (tracePath.isEmpty()) return;
+
+        m_selectedDescriptor.deviceID = "REPLAY_" + tracePath.toStdString();
+        m_selectedDescriptor.serialNumber = tracePath.toStdString();
+    }
+
     accept();
 }
 
@@ -8,7 +8,8 @@
 #include <vector>
 // Aseg�rate de que esta ruta sea accesible. Con el CMakeLists que te di, 
 // "hal/IJTAGAdapter.h" deber�a funcionar si 'src' est� en include_directories.
-#include "../hal/IJTAGAdapter.h" 
+#include "../hal/IJTAGAdapter.h"
+#include "../controller/QtMetaTypes.h"
 
 class ConnectionDialog : public QDialog {
     Q_OBJECT
@@ -8,6 +8,7 @@
 #include <vector>
 #include <string>
 #include "../core/BoundaryScanEngine.h"
+#include "../controller/QtMetaTypes.h"
 
 namespace JTAG {
     class ScanController;
@@ -49,6 +49,9 @@
 #include <QDialogButtonBox>
 #include <QMetaType>
 #include <QSettings>
+#include <QStandardPaths>
+#include <QApplication>
+#include <QProgressBar>
 
 // Standard Library
 #include <iostream>
@@ -57,11 +60,36 @@
 
 // Backend Headers
 #include "../controller/ScanController.h"
+#include "../controller/ScanControllerRpc.h"
+#include "../core/BitUtils.h"
+#include "../core/MonotonicClock.h"
+#include "../core/Instrumentation.h"
 #include "../hal/JtagProtocol.h"
 #include "ConnectionDialog.h"
 #include "ChainExamineDialog.h"
 #include "NewProjectWizard.h"
 #include "SettingsDialog.h"
+#include "PerformanceDialog.h"
+#include "BsdlLibraryDialog.h"
+
+// Rutas Qt ↔ std::filesystem con soporte Unicode completo en Windows
+static std::filesystem::path toFilesystemPath(const QString &path)
+{
+#ifdef _WIN32
+    return std::filesystem::path(path.toStdWString());
+#else
+    return std::filesystem::path(path.toStdString());
+#endif
+}
+
+static QString fromFilesystemPath(const std::filesystem::path &path)
+{
+#ifdef _WIN32
+    return QString::fromStdWString(path.wstring());
+#else
+    return QString::fromStdString(path.string());
+#endif
+}
 
 /**
  * @brief Constructor de la ventana principal
@@ -170,6 +198,12 @@ MainWindow::MainWindow(QWidget *parent)
     QSettings settings("TopJTAG", "BoundaryScanner");
     currentPollInterval = settings.value("performance/pollInterval", 100).toInt();
     currentSampleDecimation = settings.value("performance/sampleDecimation", 1).toInt();
+    currentPreciseTiming = settings.value("performance/preciseTiming", false).toBool();
+    currentRealtime = settings.value("performance/realtimePriority", false).toBool();
+    currentCpuAffinity = settings.value("performance/cpuAffinity", -1).toInt();
+    if (currentPreciseTiming || currentRealtime || currentCpuAffinity >= 0) {
+        onTimingOptionsChanged(currentPreciseTiming, currentRealtime, currentCpuAffinity);
+    }
 }
 
 /**
@@ -185,6 +219,9 @@ MainWindow::~MainWindow()
     // Save window state before closing
     saveWindowState();
 
+    // Sin clientes de automatización antes de tocar el controlador
+    automationServer.reset();
+
     // Detener polling si está activo
     if (scanController && isCapturing) {
         scanController->stopPolling();
@@ -205,6 +242,19 @@ void MainWindow::initializeUI()
 {
     resize(1200, 800);
     updateStatusBar("Ready");
+
+    // Progreso de la carga asíncrona de BSDL (visible solo mientras hay una en curso)
+    bsdlLoadProgressBar = new QProgressBar(this);
+    bsdlLoadProgressBar->setRange(0, 100);
+    bsdlLoadProgressBar->setMaximumWidth(260);
+    bsdlLoadProgressBar->hide();
+    bsdlLoadCancelButton = new QToolButton(this);
+    bsdlLoadCancelButton->setText("Cancel");
+    bsdlLoadCancelButton->setToolTip("Cancel BSDL load");
+    bsdlLoadCancelButton->hide();
+    statusBar()->addPermanentWidget(bsdlLoadProgressBar);
+    statusBar()->addPermanentWidget(bsdlLoadCancelButton);
+    connect(bsdlLoadCancelButton, &QToolButton::clicked, this, &MainWindow::onCancelBsdlLoad);
 }
 
 /**
@@ -228,11 +278,141 @@ void MainWindow::setupBackend()
         return;
     }
 
+    // Modelos BSDL compilados: abrir de nuevo un proyecto no vuelve a parsear
+    QString modelCacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (!modelCacheDir.isEmpty()) {
+        scanController->setModelCacheDirectory(toFilesystemPath(modelCacheDir + "/bsdl"));
+    }
+
+    // Biblioteca de BSDL: carpetas en QSettings, índice junto a la caché de modelos
+    QSettings librarySettings("TopJTAG", "BoundaryScanner");
+    std::vector<std::filesystem::path> libraryDirs;
+    for (const QString &dir : librarySettings.value("bsdl/libraryDirs").toStringList()) {
+        libraryDirs.push_back(toFilesystemPath(dir));
+    }
+    JTAG::BsdlLibrary &library = scanController->getBsdlLibrary();
+    library.setDirectories(std::move(libraryDirs));
+    if (!modelCacheDir.isEmpty()) {
+        library.setIndexPath(toFilesystemPath(modelCacheDir + "/bsdl_index.json"));
+        library.loadIndex();
+    }
+
     // Conectar señales del ScanController al MainWindow para comunicación asíncrona
     connect(scanController.get(), &JTAG::ScanController::pinsDataReady,
             this, &MainWindow::onPinsDataReady);
     connect(scanController.get(), &JTAG::ScanController::errorOccurred,
             this, &MainWindow::onScanError);
+    connect(scanController.get(), &JTAG::ScanController::triggerCaptured,
+            this, &MainWindow::onTriggerCaptured);
+    connect(scanController.get(), &JTAG::ScanController::bsdlLoadProgress,
+            this, &MainWindow::onBsdlLoadProgress);
+    connect(scanController.get(), &JTAG::ScanController::bsdlLoadFinished,
+            this, &MainWindow::onBsdlLoadFinished);
+    connect(scanController.get(), &JTAG::ScanController::burstCaptured, this,
+            [this](std::shared_ptr<const JTAG::TriggerCapture> capture, double samplesPerSecond) {
+                onTriggerCaptured(capture);
+                updateStatusBar(QString("Burst captured: %1 samples at %2 samples/s")
+                                    .arg(capture->sampleCount).arg(samplesPerSecond, 0, 'f', 0));
+            });
+    connect(scanController.get(), &JTAG::ScanController::pinFaultDetected,
+            this, &MainWindow::onPinFaultDetected);
+
+    setupContentionMonitor();
+    setupAutomationServer();
+}
+
+/**
+ * @brief Añade al menú Scan las opciones de detección de contención
+ *
+ * En EXTEST el worker compara cada captura con lo que conducen las celdas de
+ * salida (ver ContentionDetector). "Auto Safe-State" pone todos los drivers en
+ * alta impedancia al primer fallo. Estado en QSettings (monitor/contentionDetection,
+ * monitor/autoSafeState).
+ */
+void MainWindow::setupContentionMonitor()
+{
+    QSettings settings("TopJTAG", "BoundaryScanner");
+
+    ui->menuScan->addSeparator();
+    contentionAction = ui->menuScan->addAction("Contention Detection (EXTEST)");
+    contentionAction->setCheckable(true);
+    contentionAction->setChecked(settings.value("monitor/contentionDetection", false).toBool());
+    contentionAction->setToolTip("Compare captured pins with driven outputs on every EXTEST scan");
+
+    contentionSafeStateAction = ui->menuScan->addAction("Auto Safe-State on Pin Fault");
+    contentionSafeStateAction->setCheckable(true);
+    contentionSafeStateAction->setChecked(settings.value("monitor/autoSafeState", false).toBool());
+    contentionSafeStateAction->setToolTip("Release all drivers to high-Z when a pin fault is detected");
+
+    connect(contentionAction, &QAction::toggled, this, &MainWindow::onContentionOptionsChanged);
+    connect(contentionSafeStateAction, &QAction::toggled, this, &MainWindow::onContentionOptionsChanged);
+    onContentionOptionsChanged();
+}
+
+/**
+ * @brief Arranca el servidor JSON-RPC de automatización si está configurado
+ *
+ * Línea de comandos (--rpc-port <puerto>, --rpc-socket <ruta>) o QSettings
+ * (automation/tcpPort, automation/socketPath); la línea de comandos sustituye a
+ * ambas claves. Sin configuración no se abre ningún socket. Un puerto fuera de
+ * 1..65535 o puerto y socket a la vez se rechazan sin abrir nada. Solo
+ * escucha en 127.0.0.1.
+ *
+ * Cada sesión genera un token nuevo que los clientes envían con rpc.auth; se
+ * guarda con permisos 0600 en automation/tokenFile (por defecto rpc-token en
+ * el directorio de datos de la aplicación) y se borra al cerrar.
+ */
+void MainWindow::setupAutomationServer()
+{
+    QSettings settings("TopJTAG", "BoundaryScanner");
+    QString portText = settings.value("automation/tcpPort", 0).toString();
+    QString socketPath = settings.value("automation/socketPath").toString();
+
+    // La línea de comandos sustituye a la configuración guardada (ambas claves)
+    const QStringList args = QCoreApplication::arguments();
+    bool fromCommandLine = false;
+    for (int i = 1; i + 1 < args.size(); ++i) {
+        if (args[i] != "--rpc-port" && args[i] != "--rpc-socket") continue;
+        if (!fromCommandLine) {
+            portText = "0";
+            socketPath.clear();
+            fromCommandLine = true;
+        }
+        if (args[i] == "--rpc-port") portText = args[i + 1];
+        else socketPath = args[i + 1];
+    }
+
+    bool portValid = false;
+    const int tcpPort = portText.toInt(&portValid);
+    if (!portValid || tcpPort < 0 || tcpPort > 65535) {
+        std::cout << "[MainWindow] Automation server not started: invalid RPC port '"
+                  << portText.toStdString() << "' (1..65535)" << std::endl;
+        return;
+    }
+    if (tcpPort == 0 && socketPath.isEmpty()) return;
+    if (tcpPort > 0 && !socketPath.isEmpty()) {
+        std::cout << "[MainWindow] Automation server not started: both a TCP port and a socket path "
+                     "are configured; use only one" << std::endl;
+        return;
+    }
+
+    automationServer = std::make_unique<JTAG::ScanControllerRpc>(*scanController);
+    const QString tokenFile = settings.value("automation/tokenFile",
+        QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/rpc-token").toString();
+    automationServer->getServer().setAuthToken(JTAG::RpcServer::generateToken());
+
+    const bool listening = automationServer->getServer().writeTokenFile(toFilesystemPath(tokenFile))
+        && (tcpPort > 0 ? automationServer->listenTcp(static_cast<uint16_t>(tcpPort))
+                        : automationServer->listenUnix(toFilesystemPath(socketPath)));
+    if (!listening) {
+        std::cout << "[MainWindow] Automation server not started: "
+                  << automationServer->getLastError() << std::endl;
+        automationServer.reset();
+        return;
+    }
+    std::cout << "[MainWindow] Automation server listening on "
+              << (tcpPort > 0 ? "127.0.0.1:" + std::to_string(tcpPort) : socketPath.toStdString())
+              << " (token in " << tokenFile.toStdString() << ")" << std::endl;
 }
 
 /**
@@ -570,6 +750,7 @@ void MainWindow::setupConnections()
     
     // View menu connections
     connect(ui->actionSettings, &QAction::triggered, this, &MainWindow::onSettings);
+    connect(ui->actionPerformance_Monitor, &QAction::triggered, this, &MainWindow::onPerformanceMonitor);
 
     // Scan menu connections
     connect(ui->actionJTAG_Connection, &QAction::triggered, this, &MainWindow::onJTAGConnection);
@@ -578,6 +759,7 @@ void MainWindow::setupConnections()
     connect(ui->actionReset, &QAction::triggered, this, &MainWindow::onReset);
     connect(ui->actionJTAG_Reset, &QAction::triggered, this, &MainWindow::onJTAGReset);
     connect(ui->actionDevice_BSDL_File, &QAction::triggered, this, &MainWindow::onDeviceBSDLFile);
+    connect(ui->actionBSDL_Library, &QAction::triggered, this, &MainWindow::onBsdlLibrary);
     connect(ui->actionDevice_Package, &QAction::triggered, this, &MainWindow::onDevicePackage);
     connect(ui->actionDevice_Properties, &QAction::triggered, this, &MainWindow::onDeviceProperties);
     
@@ -798,8 +980,17 @@ void MainWindow::onNewProjectWizard()
         // Usamos un QTimer::singleShot con 0ms para dejar que el UI se refresque
         // y el wizard se cierre visualmente antes de abrir el explorador de archivos.
         QTimer::singleShot(100, this, [this]() {
+            if (!autoMatchedBsdl.isEmpty()) {
+                // BSDL ya elegido de la biblioteca en Examine Chain: sin diálogo de fichero
+                QString fileName = autoMatchedBsdl;
+                autoMatchedBsdl.clear();
+                loadBsdlFile(fileName);
+                return;
+            }
             onDeviceBSDLFile(); // <--- Redirección automática
             });
+    } else {
+        autoMatchedBsdl.clear();
     }
 }
 
@@ -854,15 +1045,28 @@ void MainWindow::onSettings()
     SettingsDialog dialog(this);
     dialog.setPollingInterval(currentPollInterval);
     dialog.setSampleDecimation(currentSampleDecimation);
+    dialog.setTimingOptions(currentPreciseTiming, currentRealtime, currentCpuAffinity);
 
     connect(&dialog, &SettingsDialog::pollingIntervalChanged,
             this, &MainWindow::onPollingIntervalChanged);
     connect(&dialog, &SettingsDialog::sampleDecimationChanged,
             this, &MainWindow::onSampleDecimationChanged);
+    connect(&dialog, &SettingsDialog::timingOptionsChanged,
+            this, &MainWindow::onTimingOptionsChanged);
 
     dialog.exec();
 }
 
+void MainWindow::onPerformanceMonitor()
+{
+    if (!performanceDialog) {
+        performanceDialog = new PerformanceDialog(scanController.get(), this);
+    }
+    performanceDialog->show();
+    performanceDialog->raise();
+    performanceDialog->activateWindow();
+}
+
 void MainWindow::onPollingIntervalChanged(int ms)
 {
     currentPollInterval = ms;
@@ -879,6 +1083,26 @@ void MainWindow::onPollingIntervalChanged(int ms)
     updateStatusBar(QString("Polling interval: %1 ms").arg(ms));
 }
 
+void MainWindow::onTimingOptionsChanged(bool precise, bool realtime, int cpu)
+{
+    currentPreciseTiming = precise;
+    currentRealtime = realtime;
+    currentCpuAffinity = cpu;
+
+    if (scanController) {
+        JTAG::SchedulerOptions options;
+        options.spinWindow = precise ? std::chrono::microseconds(200) : std::chrono::nanoseconds(0);
+        options.realtime = realtime;
+        options.cpu = cpu;
+        scanController->setSchedulerOptions(options);
+    }
+
+    QSettings settings("TopJTAG", "BoundaryScanner");
+    settings.setValue("performance/preciseTiming", precise);
+    settings.setValue("performance/realtimePriority", realtime);
+    settings.setValue("performance/cpuAffinity", cpu);
+}
+
 void MainWindow::onSampleDecimationChanged(int decimation)
 {
     currentSampleDecimation = decimation;
@@ -1045,6 +1269,12 @@ void MainWindow::onJTAGConnection()
                                "This is an unexpected error.";
                     break;
 
+                case JTAG::AdapterType::REPLAY:
+                    errorMsg += "Trace replay troubleshooting:\n"
+                               "• Check the file is a session trace (.jtr)\n"
+                               "• Check the file is not truncated";
+                    break;
+
                 default:
                     errorMsg += "Check adapter connection and try again.";
                     break;
@@ -1072,13 +1302,17 @@ void MainWindow::onExamineChain()
         ChainExamineDialog dialog(idcode, this);
         dialog.exec();
 
+        // Buscar el BSDL en la biblioteca; se carga al terminar el wizard
+        autoMatchedBsdl = chooseLibraryBsdl(idcode);
+
         // Actualizar combo
         ui->comboBoxDevice->clear();
         ui->comboBoxDevice->addItem(
             QString("Device 0x%1").arg(idcode, 8, 16, QChar('0')));
 
-        updateStatusBar(QString("Device detected - IDCODE: 0x%1 (BSDL not loaded)")
-            .arg(idcode, 8, 16, QChar('0')));
+        updateStatusBar(QString("Device detected - IDCODE: 0x%1 (%2)")
+            .arg(idcode, 8, 16, QChar('0'))
+            .arg(autoMatchedBsdl.isEmpty() ? "BSDL not loaded" : "BSDL found in library"));
 
         // LANZAR New Project Wizard
         onNewProjectWizard();
@@ -1105,7 +1339,7 @@ void MainWindow::onRun()
         // Entrar en modo SAMPLE para capturar pines (el worker lo maneja)
         if (scanController->enterSAMPLE()) {
             isCapturing = true;
-            captureTimer.restart();  // W1: Resetear a 0 (no continuar desde antes)
+            captureStartNs = JTAG::monotonicNowNs();  // W1: Resetear a 0 (no continuar desde antes)
             scanController->startPolling();  // Iniciar worker thread
             updateStatusBar("Running - capturing pin states");
             ui->actionRun->setText("Stop");
@@ -1289,40 +1523,171 @@ void MainWindow::onDeviceBSDLFile()
         tr("Open BSDL File"), "", tr("BSDL Files (*.bsd *.bsdl);;All Files (*)"));
 
     if (!fileName.isEmpty() && scanController) {
-        // Convertir QString a std::filesystem::path para soporte Unicode completo
-        #ifdef _WIN32
-            std::filesystem::path bsdlPath(fileName.toStdWString());
-        #else
-            std::filesystem::path bsdlPath(fileName.toStdString());
-        #endif
-
-        if (scanController->loadBSDL(bsdlPath)) {
-            updateStatusBar("BSDL loaded: " + fileName);
-
-            if (scanController->initializeDevice()) {
-                isDeviceInitialized = true;
-
-                updatePinsTable();
-                renderChipVisualization();
-
-                // NUEVO: Auto-entrar en SAMPLE y empezar polling
-                if (scanController->enterSAMPLE()) {
-                    isCapturing = true;
-                    captureTimer.start();
-                    scanController->startPolling();
-                    updateStatusBar("SAMPLE mode active - reading pins continuously");
-                    ui->actionRun->setText("Stop");
-                }
+        loadBsdlFile(fileName);
+    }
+}
 
-                enableControlsAfterConnection(true);
-            }
-        } else {
-            QMessageBox::critical(this, "Error",
-                "Failed to load or parse BSDL file");
+/**
+ * @brief Lanza la carga de un BSDL en segundo plano
+ *
+ * Compartido por el diálogo de fichero y por la coincidencia automática de la
+ * biblioteca de BSDL tras Examine Chain. El modelo y la geometría del chip se
+ * calculan en el pool de carga del ScanController; onBsdlLoadFinished instala
+ * el modelo, inicializa el dispositivo y arranca SAMPLE + polling. Una carga
+ * nueva cancela la anterior.
+ *
+ * @return true si la carga se ha encolado
+ */
+bool MainWindow::loadBsdlFile(const QString& fileName)
+{
+    // Parámetros del visualizador leídos aquí: el pool no toca widgets
+    const ChipLayoutParams layoutParams = chipVisualizer->layoutParams(customDeviceName);
+    auto layout = std::make_shared<ChipLayout>();
+
+    bsdlLoad = scanController->loadBSDLAsync(toFilesystemPath(fileName),
+        [layoutParams, layout](const JTAG::DeviceModel& model, JTAG::BsdlLoadTask& task) {
+            task.reportProgress(60, "Computing chip layout");
+            return ChipVisualizer::computeLayout(model, layoutParams, *layout,
+                                                 [&task]() { return task.isCancelled(); });
+        });
+    bsdlLoadLayout = layout;
+    bsdlLoadFileName = fileName;
+
+    bsdlLoadProgressBar->setValue(0);
+    bsdlLoadProgressBar->show();
+    bsdlLoadCancelButton->show();
+    updateStatusBar("Loading BSDL: " + fileName);
+    return true;
+}
+
+void MainWindow::onBsdlLoadProgress(quint64 taskId, int percent, QString stage)
+{
+    // Progreso de una carga ya sustituida: se ignora
+    if (!bsdlLoad || bsdlLoad->getId() != taskId) return;
+
+    bsdlLoadProgressBar->setValue(percent);
+    bsdlLoadProgressBar->setFormat(stage + " %p%");
+}
+
+void MainWindow::onCancelBsdlLoad()
+{
+    if (bsdlLoad) {
+        // El resultado llega igualmente por bsdlLoadFinished (estado cancelado)
+        scanController->cancelBSDLLoad();
+        updateStatusBar("Cancelling BSDL load...");
+    }
+}
+
+/**
+ * @brief Fin de una carga de BSDL: instala el modelo y pinta la geometría precalculada
+ *
+ * Solo queda en el hilo GUI lo inevitable: poblar la escena del chip y la
+ * tabla de pines.
+ */
+void MainWindow::onBsdlLoadFinished(quint64 taskId)
+{
+    if (!bsdlLoad || bsdlLoad->getId() != taskId) return;
+
+    std::shared_ptr<JTAG::BsdlLoadTask> task = std::move(bsdlLoad);
+    std::shared_ptr<ChipLayout> layout = std::move(bsdlLoadLayout);
+    const QString fileName = bsdlLoadFileName;
+    bsdlLoadProgressBar->hide();
+    bsdlLoadCancelButton->hide();
+
+    if (task->isCancelled() || task->getStatus() == JTAG::BsdlLoadTask::Status::CANCELLED) {
+        updateStatusBar("BSDL load cancelled: " + fileName);
+        return;
+    }
+    if (task->getStatus() != JTAG::BsdlLoadTask::Status::FINISHED) {
+        QMessageBox::critical(this, "Error",
+            QString::fromStdString(task->getError()));
+        return;
+    }
+
+    // El controlador detiene el polling antes de sustituir engine y modelo
+    if (isCapturing) {
+        isCapturing = false;
+        ui->actionRun->setText("Run");
+    }
+    if (!scanController->adoptLoadedBSDL(*task)) {
+        updateStatusBar("BSDL load discarded: " + fileName);
+        return;
+    }
+
+    updateStatusBar("BSDL loaded: " + fileName);
+
+    if (scanController->initializeDevice()) {
+        isDeviceInitialized = true;
+
+        updatePinsTable();
+        chipVisualizer->applyLayout(*layout);
+
+        // NUEVO: Auto-entrar en SAMPLE y empezar polling
+        if (scanController->enterSAMPLE()) {
+            isCapturing = true;
+            captureStartNs = JTAG::monotonicNowNs();
+            scanController->startPolling();
+            updateStatusBar("SAMPLE mode active - reading pins continuously");
+            ui->actionRun->setText("Stop");
         }
+
+        enableControlsAfterConnection(true);
     }
 }
 
+/**
+ * @brief Busca en la biblioteca los BSDL cuyo IDCODE coincide y deja elegir uno
+ *
+ * Con una sola coincidencia pide confirmación; con varias (revisiones o
+ * encapsulados distintos del mismo dispositivo) muestra la lista, ordenada
+ * de la más específica a la más genérica.
+ *
+ * @return Ruta del BSDL elegido, o vacío si no hay coincidencias o se cancela
+ */
+QString MainWindow::chooseLibraryBsdl(uint32_t idcode)
+{
+    std::vector<JTAG::BsdlLibraryEntry> candidates = scanController->findBSDLCandidates(idcode);
+    if (candidates.empty()) {
+        return QString();
+    }
+
+    QStringList items;
+    for (const auto& entry : candidates) {
+        items << QString("%1  (%2)").arg(QString::fromStdString(entry.entityName), fromFilesystemPath(entry.path));
+    }
+
+    if (items.size() == 1) {
+        auto answer = QMessageBox::question(this, "BSDL Found",
+            QString("The BSDL library matches IDCODE 0x%1:\n\n%2\n\nLoad it after the project wizard?")
+                .arg(idcode, 8, 16, QChar('0')).arg(items.first()));
+        return answer == QMessageBox::Yes ? fromFilesystemPath(candidates.front().path) : QString();
+    }
+
+    bool ok = false;
+    QString choice = QInputDialog::getItem(this, "BSDL Found",
+        QString("%1 BSDL files match IDCODE 0x%2:").arg(items.size()).arg(idcode, 8, 16, QChar('0')),
+        items, 0, false, &ok);
+    if (!ok) {
+        return QString();
+    }
+    return fromFilesystemPath(candidates[items.indexOf(choice)].path);
+}
+
+/**
+ * @brief Configura las carpetas de la biblioteca de BSDL (ver BsdlLibraryDialog)
+ *
+ * El índice se actualiza en segundo plano y se guarda en la caché de la
+ * aplicación. Examine Chain lo usa para proponer el BSDL del dispositivo.
+ */
+void MainWindow::onBsdlLibrary()
+{
+    if (!scanController) {
+        return;
+    }
+    BsdlLibraryDialog dialog(scanController->getBsdlLibrary(), this);
+    dialog.exec();
+}
+
 void MainWindow::onDevicePackage()
 {
     if (!scanController || !isDeviceDetected) {
@@ -1766,6 +2131,8 @@ void MainWindow::onWaveformAddSignal()
                     } else {
                         sigInfo.dataIndex = -1;  // Pin sin celdas JTAG (no se puede monitorear)
                     }
+                    sigInfo.pinIndex = sigInfo.dataIndex >= 0
+                        ? scanController->getDeviceModel()->findPin(pinName) : -1;
 
                     waveformSignals.push_back(sigInfo);
                     waveformBuffer[pinName].clear();
@@ -2081,7 +2448,7 @@ void MainWindow::onWaveGoto()
 //       Las actualizaciones de UI se hacen en onPinsDataReady() que recibe señales del worker
 // ============================================================================
 
-void MainWindow::updatePinsTable()
+void MainWindow::updatePinsTable(const std::vector<JTAG::PinState>* pinStates)
 {
     if (!scanController) return;
 
@@ -2099,13 +2466,19 @@ void MainWindow::updatePinsTable()
 
     // ===== OPTIMIZACIÓN: Obtener todos los pines UNA VEZ =====
     // En lugar de llamar getPinType(), getPinNumber() etc. repetidamente,
-    // obtenemos todo el vector una vez y creamos hash map O(1)
-    const auto& allPins = scanController->getDeviceModel()->getAllPins();
-    QHash<QString, const JTAG::PinInfo*> pinInfoCache;
-    pinInfoCache.reserve(allPins.size());
-    for (const auto& pin : allPins) {
-        pinInfoCache[QString::fromStdString(pin.name)] = &pin;
-    }
+    // indexamos los pines del modelo una vez (QString → índice de pin) y
+    // leemos las vistas, sin copiar cadenas del modelo
+    const JTAG::DeviceModel* model = scanController->getDeviceModel();
+    const JTAG::PinRange allPins = model->getAllPins();
+    QHash<QString, int> pinIndexByName;
+    pinIndexByName.reserve(static_cast<int>(allPins.size()));
+    for (size_t i = 0; i < allPins.size(); ++i) {
+        const std::string_view name = allPins[i].name;
+        pinIndexByName.insert(QString::fromUtf8(name.data(), static_cast<int>(name.size())), static_cast<int>(i));
+    }
+    auto toQString = [](std::string_view text) {
+        return QString::fromUtf8(text.data(), static_cast<int>(text.size()));
+    };
     // =========================================================
 
     // Obtener lista de pines del modelo
@@ -2128,19 +2501,21 @@ void MainWindow::updatePinsTable()
             ui->tableWidgetPins->setItem(row, 0, nameItem);
 
             // ===== OPTIMIZACIÓN: Usar cache en lugar de llamadas =====
-            const JTAG::PinInfo* pinInfo = pinInfoCache.value(qPinName, nullptr);
-            if (pinInfo) {
+            const int pinIndex = pinIndexByName.value(qPinName, -1);
+            if (pinIndex >= 0) {
+                const JTAG::PinView pinInfo = allPins[pinIndex];
+
                 // Col 1: Pin #
-                ui->tableWidgetPins->setItem(row, 1, new QTableWidgetItem(QString::fromStdString(pinInfo->pinNumber)));
+                ui->tableWidgetPins->setItem(row, 1, new QTableWidgetItem(toQString(pinInfo.pinNumber)));
 
                 // Col 2: Port
-                ui->tableWidgetPins->setItem(row, 2, new QTableWidgetItem(QString::fromStdString(pinInfo->port)));
+                ui->tableWidgetPins->setItem(row, 2, new QTableWidgetItem(toQString(pinInfo.port)));
 
                 // Col 3: I/O Value (Inicial)
                 ui->tableWidgetPins->setItem(row, 3, new QTableWidgetItem("?"));
 
                 // Col 4: Type
-                ui->tableWidgetPins->setItem(row, 4, new QTableWidgetItem(QString::fromStdString(pinInfo->type)));
+                ui->tableWidgetPins->setItem(row, 4, new QTableWidgetItem(QString::fromLatin1(JTAG::pinTypeName(pinInfo.type))));
             } else {
                 // Fallback si no está en cache (no debería pasar)
                 ui->tableWidgetPins->setItem(row, 1, new QTableWidgetItem(""));
@@ -2164,21 +2539,23 @@ void MainWindow::updatePinsTable()
         std::string pinName = realName.toStdString(); // <--- Aquí definimos pinName
 
         // ===== OPTIMIZACIÓN: Obtener tipo del cache O(1) =====
-        const JTAG::PinInfo* pinInfo = pinInfoCache.value(realName, nullptr);
-        if (!pinInfo) continue; // Pin no encontrado (no debería pasar)
+        const int pinIndex = pinIndexByName.value(realName, -1);
+        if (pinIndex < 0) continue; // Pin no encontrado (no debería pasar)
 
-        QString type = QString::fromStdString(pinInfo->type);
+        const JTAG::PinType type = model->getPinTypes()[pinIndex];
         // =====================================================
 
-        // 3. Leer estado del pin
-        auto level = scanController->getPin(pinName);
+        // 3. Leer estado del pin: de la instantánea si viene una del mismo modelo
+        auto level = (pinStates && pinStates->size() == allPins.size())
+            ? JTAG::toPinLevel((*pinStates)[pinIndex])
+            : scanController->getPin(pinName);
 
         if (level.has_value()) {
             QString valueStr;
             VisualPinState visualState;
 
             // Verificar si es un pin LINKAGE (no controlable)
-            if (type.toLower() == "linkage") {
+            if (type == JTAG::PinType::LINKAGE) {
                 valueStr = "-";
                 visualState = VisualPinState::LINKAGE;
             }
@@ -2213,10 +2590,7 @@ void MainWindow::updatePinsTable()
                 // --- Lógica de Edición (EXTEST) ---
                 // Permitir editar si es EXTEST y es una salida (incluyendo output2 del hack)
                 // NOTA: Los pines LINKAGE nunca son editables
-                QString typeLower = type.toLower();
-                bool isEditable = (currentJTAGMode == JTAGMode::EXTEST) &&
-                    (typeLower == "output" || typeLower == "inout" || typeLower == "output2") &&
-                    (typeLower != "linkage");
+                bool isEditable = (currentJTAGMode == JTAGMode::EXTEST) && JTAG::isDrivable(type);
 
                 // ===== OPTIMIZACIÓN: Diffing de color también =====
                 QColor targetColor = isEditable ? QColor(255, 255, 200) : Qt::white;
@@ -2248,7 +2622,7 @@ void MainWindow::updatePinsTable()
 
             QTableWidgetItem* valueItem = ui->tableWidgetPins->item(row, 3);
             if (valueItem) {
-                if (type.toLower() == "linkage") {
+                if (type == JTAG::PinType::LINKAGE) {
                     // Pin LINKAGE (VCC, GND, NC) - no controlable vía JTAG
                     valueItem->setText("-");
                     valueItem->setFlags(valueItem->flags() & ~Qt::ItemIsEditable);
@@ -2300,24 +2674,7 @@ QString MainWindow::resolveRealPinName(const QString& displayName) const
     return displayName;
 }
 
-void MainWindow::renderChipVisualization()
-{
-    // Check if controller and device are initialized
-    if (!scanController || !scanController->isInitialized()) {
-        return;
-    }
-
-    // Get the DeviceModel from the controller
-    const auto* deviceModel = scanController->getDeviceModel();
-    if (!deviceModel) {
-        return;
-    }
-
-    // Render the chip visualization using the device model with custom name
-    chipVisualizer->renderFromDeviceModel(*deviceModel, customDeviceName);
-}
-
-void MainWindow::updateControlPanel(const std::vector<JTAG::PinLevel>& pinLevels)
+void MainWindow::updateControlPanel(const std::vector<JTAG::PinState>& pinStates)
 {
     // El Control Panel es SOLO para edición del usuario en modos EXTEST/INTEST
     // NO debe actualizarse automáticamente desde el backend, ya que eso
@@ -2328,15 +2685,17 @@ void MainWindow::updateControlPanel(const std::vector<JTAG::PinLevel>& pinLevels
     // backend actualiza → GUI mantiene el valor seleccionado por el usuario
 
     // Por tanto, este método NO hace nada intencionalmente
-    Q_UNUSED(pinLevels);
+    Q_UNUSED(pinStates);
 }
 
-void MainWindow::captureWaveformSample(const std::vector<JTAG::PinLevel>& currentPins)
+void MainWindow::captureWaveformSample(const std::vector<JTAG::PinState>& currentPins, uint64_t captureNs)
 {
     // ==================== PUNTO DE INTEGRACIÓN 13 ====================
     if (waveformSignals.empty()) return;
 
-    double currentTime = captureTimer.elapsed() / 1000.0; // Convert ms to seconds
+    // Momento del scan (no el de llegada al hilo GUI): los retrasos de la cola
+    // de eventos no deforman la línea de tiempo
+    double currentTime = (static_cast<int64_t>(captureNs) - static_cast<int64_t>(captureStartNs)) * 1e-9;
 
     // ===== OPTIMIZACIÓN MÁXIMA: Acceso directo por índice =====
     // Elimina TODAS las búsquedas, hash lookups y llamadas de función
@@ -2344,9 +2703,9 @@ void MainWindow::captureWaveformSample(const std::vector<JTAG::PinLevel>& curren
     // Ahora: 20 señales × 1000Hz × acceso[i] = acceso directo a memoria
     for (const auto& sigInfo : waveformSignals) {
         // Validación de seguridad (bounds checking)
-        if (sigInfo.dataIndex >= 0 && sigInfo.dataIndex < static_cast<int>(currentPins.size())) {
+        if (sigInfo.pinIndex >= 0 && sigInfo.pinIndex < static_cast<int>(currentPins.size())) {
             // *** ACCESO DIRECTO A MEMORIA - INSTANTÁNEO ***
-            JTAG::PinLevel level = currentPins[sigInfo.dataIndex];
+            JTAG::PinLevel level = JTAG::toPinLevel(currentPins[sigInfo.pinIndex]).value_or(JTAG::PinLevel::HIGH_Z);
 
             // Add sample to buffer
             waveformBuffer[sigInfo.name].push_back({currentTime, level});
@@ -2371,6 +2730,38 @@ void MainWindow::captureWaveformSample(const std::vector<JTAG::PinLevel>& curren
     // ================================================
 }
 
+/**
+ * @brief Vuelca una ventana de disparo (pre + disparo + post) en el waveform
+ *
+ * Sustituye el contenido del buffer de cada señal por la ventana; t = 0 es la
+ * muestra de disparo, de modo que las muestras previas quedan en tiempo negativo.
+ */
+void MainWindow::onTriggerCaptured(std::shared_ptr<const JTAG::TriggerCapture> capture)
+{
+    if (!capture || capture->sampleCount == 0) return;
+
+    const double t0 = capture->timestampsNs[capture->triggerIndex] * 1e-9;
+    for (const auto& sigInfo : waveformSignals) {
+        auto& samples = waveformBuffer[sigInfo.name];
+        samples.clear();
+        if (sigInfo.dataIndex < 0 || static_cast<size_t>(sigInfo.dataIndex) >= capture->bsrLength) continue;
+
+        for (size_t i = 0; i < capture->sampleCount; ++i) {
+            bool high = JTAG::getBit(capture->sample(i), static_cast<size_t>(sigInfo.dataIndex));
+            samples.push_back({capture->timestampsNs[i] * 1e-9 - t0,
+                               high ? JTAG::PinLevel::HIGH : JTAG::PinLevel::LOW});
+        }
+    }
+
+    updateStatusBar(QString("Trigger captured: %1 samples (%2 before trigger)")
+                        .arg(capture->sampleCount).arg(capture->triggerIndex));
+
+    m_waveformNeedsRedraw = true;
+    if (!m_waveformRenderTimer->isActive() && !waveformSignals.empty()) {
+        m_waveformRenderTimer->start();
+    }
+}
+
 void MainWindow::redrawWaveform()
 {
     // ===== OPTIMIZACIÓN: No dibujar si no es visible =====
@@ -2382,6 +2773,7 @@ void MainWindow::redrawWaveform()
     // BUG FIX 3: Prevenir redibujado recursivo
     if (isRedrawing) return;
     isRedrawing = true;
+    JTAG::ScopedStageTimer renderTimer(JTAG::Stage::RENDER);
 
     // BUG FIX 1: Si no hay señales añadidas, mantener waveform vacío (limpio)
     if (waveformSignals.empty()) {
@@ -2726,11 +3118,18 @@ void MainWindow::updateStatusBar(const QString &message)
 // NUEVOS SLOTS PARA THREADING (RECIBEN SEÑALES DEL SCANWORKER)
 // ============================================================================
 
-void MainWindow::onPinsDataReady(std::shared_ptr<const std::vector<JTAG::PinLevel>> pins)
+void MainWindow::onPinsDataReady(std::shared_ptr<const JTAG::PinSnapshot> snapshot)
 {
     // FASE 2: Dereferencia shared_ptr UNA VEZ para obtener referencia al vector
     // NO HACE COPIA - solo accede al objeto compartido
-    const std::vector<JTAG::PinLevel>& pinsRef = *pins;
+    const std::vector<JTAG::PinState>& pinsRef = snapshot->pins;
+
+    // Latencia extremo a extremo: fin del scan → este slot
+    const uint64_t arrivedNs = JTAG::monotonicNowNs();
+    JTAG::Instrumentation::instance().record(JTAG::Stage::SIGNAL_DELIVERY, arrivedNs - snapshot->publishedNs);
+    if (snapshot->fresh) {
+        lastPipelineLatencyMs = (arrivedNs - snapshot->scanEndNs) * 1e-6;
+    }
 
     // Este slot se ejecuta en GUI thread (thread-safe vía Qt signals)
     // Reemplaza el código que estaba en onPollTimer()
@@ -2756,8 +3155,9 @@ void MainWindow::onPinsDataReady(std::shared_ptr<const std::vector<JTAG::PinLeve
     static int updateCount = 0;
     updateCount++;
     if (!warningShown) { // Only show update count if no warning
-        statusBar()->showMessage(QString("Updates received: %1 (pins: %2)")
-                                .arg(updateCount).arg(pinsRef.size()), 100);
+        statusBar()->showMessage(QString("Updates received: %1 (pins: %2, scan #%3, latency %4 ms)")
+                                .arg(updateCount).arg(pinsRef.size())
+                                .arg(snapshot->sequence).arg(lastPipelineLatencyMs, 0, 'f', 2), 100);
     }
 
     if (!scanController || !isCapturing) {
@@ -2775,22 +3175,61 @@ void MainWindow::onPinsDataReady(std::shared_ptr<const std::vector<JTAG::PinLeve
         sampleCounter = 0;  // Reset for next cycle
     }
 
-    // 1. Actualizar tabla de pines
-    updatePinsTable();
+    {
+        JTAG::ScopedStageTimer timer(JTAG::Stage::TABLE_UPDATE);
 
-    // 2. Actualizar Control Panel (reemplaza updateWatchTable)
-    updateControlPanel(pinsRef);
+        // 1. Actualizar tabla de pines (estados ya decodificados en el hilo de scan)
+        updatePinsTable(&pinsRef);
+
+        // 2. Actualizar Control Panel (reemplaza updateWatchTable)
+        updateControlPanel(pinsRef);
+    }
 
     // 3. Capturar muestra para waveform (SOLO SI ES VISIBLE)
     // ===== OPTIMIZACIÓN: Pasar vector BSR completo para acceso directo =====
     // En lugar de que waveform llame a getPin() por cada señal,
     // le pasamos el vector completo y hace acceso[index] directo
     if (ui->dockWaveform->isVisible()) {
-        captureWaveformSample(pinsRef);  // ← Pasar vector BSR completo
+        JTAG::ScopedStageTimer timer(JTAG::Stage::WAVEFORM_CAPTURE);
+        captureWaveformSample(pinsRef, snapshot->captureNs());  // ← Pasar vector BSR completo
     }
     // ====================================================================
 }
 
+void MainWindow::onContentionOptionsChanged()
+{
+    const bool enabled = contentionAction->isChecked();
+    const bool autoSafeState = contentionSafeStateAction->isChecked();
+    contentionSafeStateAction->setEnabled(enabled);
+
+    QSettings settings("TopJTAG", "BoundaryScanner");
+    settings.setValue("monitor/contentionDetection", enabled);
+    settings.setValue("monitor/autoSafeState", autoSafeState);
+
+    scanController->setContentionDetection(enabled, autoSafeState);
+}
+
+/**
+ * @brief Aviso de pin en contención / bloqueado (solo fallos nuevos)
+ *
+ * Si el worker ya aplicó el estado seguro se avisa con un diálogo: las
+ * salidas han dejado de conducir y el usuario debe revisar la placa.
+ */
+void MainWindow::onPinFaultDetected(QString pinName, bool drivenHigh, bool safeStateApplied)
+{
+    const QString message = QString("Pin fault on %1: driven %2 but captured %3")
+                                .arg(pinName, drivenHigh ? "HIGH" : "LOW", drivenHigh ? "LOW" : "HIGH");
+    updateStatusBar(message);
+
+    if (safeStateApplied && !pinFaultDialogOpen) {
+        pinFaultDialogOpen = true;
+        QMessageBox::warning(this, "Pin Fault",
+            message + "\n\nAll drivers were released to high-Z (safe state). "
+                      "Check the board before driving outputs again.");
+        pinFaultDialogOpen = false;
+    }
+}
+
 void MainWindow::onScanError(QString message)
 {
     // Mostrar error en status bar
@@ -2888,12 +3327,9 @@ void MainWindow::onJTAGModeChanged(int modeId)
 
             auto pinList = scanController->getPinList();
             for (const auto& pinName : pinList) {
-                std::string type = scanController->getPinType(pinName);
-                // Solo añadir pines editables (OUTPUT y INOUT) - normalizar a lowercase
-                std::string typeLower = type;
-                std::transform(typeLower.begin(), typeLower.end(), typeLower.begin(), ::tolower);
-                if (typeLower == "output" || typeLower == "inout" || typeLower == "output2" || typeLower == "inout2") {
-                    std::string pinNumber = scanController->getPinNumber(pinName);
+                // Solo añadir pines editables (OUTPUT y INOUT)
+                if (JTAG::isDrivable(scanController->getPinType(pinName))) {
+                    std::string pinNumber(scanController->getPinNumber(pinName));
                     controlPanel->addPin(pinName, pinNumber);
 
                     // Obtener valor actual del pin desde la tabla de pines
@@ -2954,8 +3390,7 @@ void MainWindow::onSetAllTo1()
     int count = 0;
 
     for (const auto& pinName : pinList) {
-        std::string type = scanController->getPinType(pinName);
-        if (type == "OUTPUT" || type == "INOUT") {
+        if (JTAG::isDrivable(scanController->getPinType(pinName))) {
             if (scanController->setPin(pinName, JTAG::PinLevel::HIGH)) {
                 count++;
             }
@@ -2977,8 +3412,7 @@ void MainWindow::onSetAllToZ()
     int count = 0;
 
     for (const auto& pinName : pinList) {
-        std::string type = scanController->getPinType(pinName);
-        if (type == "OUTPUT" || type == "INOUT") {
+        if (JTAG::isDrivable(scanController->getPinType(pinName))) {
             if (scanController->setPin(pinName, JTAG::PinLevel::HIGH_Z)) {
                 count++;
             }
@@ -3000,8 +3434,7 @@ void MainWindow::onSetAllTo0()
     int count = 0;
 
     for (const auto& pinName : pinList) {
-        std::string type = scanController->getPinType(pinName);
-        if (type == "OUTPUT" || type == "INOUT") {
+        if (JTAG::isDrivable(scanController->getPinType(pinName))) {
             if (scanController->setPin(pinName, JTAG::PinLevel::LOW)) {
                 count++;
             }
@@ -7,7 +7,6 @@
 #include <QComboBox>
 #include <QLabel>
 #include <QActionGroup>
-#include <QElapsedTimer>
 #include <QTableWidgetItem>
 #include <memory>
 #include <deque>
@@ -19,9 +18,15 @@
 #include "ControlPanelWidget.h"
 
 // Forward declarations for your backend
+class QProgressBar;
+class QToolButton;
+
 namespace JTAG {
     class ScanController;
+    class ScanControllerRpc;
+    class BsdlLoadTask;
     enum class PinLevel;
+    struct PinState;
 }
 
 QT_BEGIN_NAMESPACE
@@ -49,8 +54,10 @@ private slots:
     void onToggleWaveform(bool checked);
     void onZoom();
     void onSettings();                          // Open settings dialog
+    void onPerformanceMonitor();                // Stage latencies and counters
     void onPollingIntervalChanged(int ms);      // Handle polling interval change
     void onSampleDecimationChanged(int decimation);  // Handle sample decimation change
+    void onTimingOptionsChanged(bool precise, bool realtime, int cpu);  // Scheduler options
 
     // Scan menu actions
     void onJTAGConnection();
@@ -59,6 +66,7 @@ private slots:
     void onReset();
     void onJTAGReset();
     void onDeviceBSDLFile();
+    void onBsdlLibrary();                       // Library folders for IDCODE auto-match
     void onDevicePackage();
     void onDeviceProperties();
 
@@ -108,8 +116,16 @@ private slots:
 
     // NUEVOS slots para recibir datos del worker
     // FASE 2: shared_ptr evita copias innecesarias del vector completo
-    void onPinsDataReady(std::shared_ptr<const std::vector<JTAG::PinLevel>> pins);
+    void onPinsDataReady(std::shared_ptr<const JTAG::PinSnapshot> snapshot);
     void onScanError(QString message);
+    void onTriggerCaptured(std::shared_ptr<const JTAG::TriggerCapture> capture);
+    void onPinFaultDetected(QString pinName, bool drivenHigh, bool safeStateApplied);
+    void onContentionOptionsChanged();
+
+    // Carga asíncrona de BSDL (pool del ScanController)
+    void onBsdlLoadProgress(quint64 taskId, int percent, QString stage);
+    void onBsdlLoadFinished(quint64 taskId);
+    void onCancelBsdlLoad();
 
     // JTAG Mode selection slots
     void onJTAGModeChanged(int modeId);
@@ -128,6 +144,8 @@ private:
     
     // Backend controller - AQUÍ CONECTARÁS TU SCANCONTROLLER
     std::unique_ptr<JTAG::ScanController> scanController;
+    // Servidor JSON-RPC local (opcional); se destruye antes que scanController
+    std::unique_ptr<JTAG::ScanControllerRpc> automationServer;
 
     // Graphics scenes for rendering
     QGraphicsScene *waveformScene;
@@ -142,6 +160,9 @@ private:
     // Control Panel (reemplaza Watch)
     ControlPanelWidget *controlPanel;
 
+    // Performance monitor (no modal, se crea al abrirlo por primera vez)
+    class PerformanceDialog *performanceDialog = nullptr;
+
     // Toolbar widgets
     QComboBox *zoomComboBox;
 
@@ -169,6 +190,7 @@ private:
 
     // Device configuration from wizard
     QString customDeviceName;
+    QString autoMatchedBsdl;    // BSDL elegido de la biblioteca en Examine Chain (se carga tras el wizard)
 
     // JTAG Mode state
     enum class JTAGMode { SAMPLE, SAMPLE_SINGLE_SHOT, EXTEST, INTEST, BYPASS };
@@ -190,12 +212,28 @@ private:
         JTAG::PinLevel level;
     };
     std::map<std::string, std::deque<WaveformSample>> waveformBuffer;
-    QElapsedTimer captureTimer;
+    uint64_t captureStartNs = 0;    // monotonicNowNs() al iniciar la captura (t = 0 del waveform)
+    double lastPipelineLatencyMs = 0.0;  // Scan → GUI de la última instantánea
     const size_t MAX_WAVEFORM_SAMPLES = 10000;  // Circular buffer limit
 
+    // Carga de BSDL en curso: modelo y geometría del chip se calculan fuera del hilo GUI
+    std::shared_ptr<JTAG::BsdlLoadTask> bsdlLoad;
+    std::shared_ptr<ChipLayout> bsdlLoadLayout;   // Escrita por el pool hasta bsdlLoadFinished
+    QString bsdlLoadFileName;
+    QProgressBar* bsdlLoadProgressBar = nullptr;
+    QToolButton* bsdlLoadCancelButton = nullptr;
+
+    // Detección de contención en EXTEST (menú Scan, persistida en QSettings)
+    QAction* contentionAction = nullptr;
+    QAction* contentionSafeStateAction = nullptr;
+    bool pinFaultDialogOpen = false;    // Varios fallos en el mismo scan: un solo diálogo
+
     // Performance settings
     int currentPollInterval = 100;      // Polling interval in ms (default: 100ms)
     int currentSampleDecimation = 1;    // Sample decimation (1 = all samples)
+    bool currentPreciseTiming = false;  // Sleep + spin hasta cada deadline
+    bool currentRealtime = false;       // SCHED_FIFO / TIME_CRITICAL en el hilo de scan
+    int currentCpuAffinity = -1;        // -1 = cualquier CPU
     int sampleCounter = 0;              // Counter for sample decimation
 
     // ===== OPTIMIZACIÓN: Cache de índices directos para waveform =====
@@ -205,6 +243,7 @@ private:
         std::string name;
         int dataIndex;   // Índice directo en vector BSR (inputCell o outputCell)
                         // -1 si el pin no tiene celdas JTAG
+        int pinIndex;    // Índice del pin en PinSnapshot::pins (-1 si no monitorizable)
     };
     std::vector<WaveformSignalInfo> waveformSignals;  // Cache de señales con índices
     // =================================================================
@@ -223,17 +262,20 @@ private:
     void setupGraphicsViews();
     void setupTables();
     void setupBackend();
+    void setupAutomationServer();
+    void setupContentionMonitor();
     void initializeUI();
     void updateWindowTitle(const QString &filename = QString());
     void updateStatusBar(const QString &message);
 
     // Backend integration helpers
-    void updatePinsTable();
-    void updateControlPanel(const std::vector<JTAG::PinLevel>& pinLevels);
-    void captureWaveformSample(const std::vector<JTAG::PinLevel>& currentPins);
+    void updatePinsTable(const std::vector<JTAG::PinState>* pinStates = nullptr);
+    void updateControlPanel(const std::vector<JTAG::PinState>& pinStates);
+    void captureWaveformSample(const std::vector<JTAG::PinState>& currentPins, uint64_t captureNs);
     void redrawWaveform();
     void enableControlsAfterConnection(bool enable);
-    void renderChipVisualization();
+    bool loadBsdlFile(const QString& fileName);
+    QString chooseLibraryBsdl(uint32_t idcode);
 
     // Pin name resolution helper
     QString resolveRealPinName(const QString& displayName) const;
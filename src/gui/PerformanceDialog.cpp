@@ -0,0 +1,199 @@
+#include "PerformanceDialog.h"
+#include "../controller/ScanController.h"
+#include "../core/Instrumentation.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QGroupBox>
+#include <QHeaderView>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QFile>
+
+PerformanceDialog::PerformanceDialog(const JTAG::ScanController *controller, QWidget *parent)
+    : QDialog(parent)
+    , controller(controller)
+{
+    setWindowTitle("Performance Monitor");
+    setMinimumSize(640, 520);
+    setModal(false);
+    setupUI();
+
+    refreshTimer = new QTimer(this);
+    refreshTimer->setInterval(500);
+    connect(refreshTimer, &QTimer::timeout, this, &PerformanceDialog::refresh);
+}
+
+PerformanceDialog::~PerformanceDialog()
+{
+}
+
+void PerformanceDialog::setupUI()
+{
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+
+    // === STAGE LATENCIES ===
+    QGroupBox *stagesGroup = new QGroupBox("Stage Latency (scan → screen)", this);
+    QVBoxLayout *stagesLayout = new QVBoxLayout(stagesGroup);
+
+    stagesTable = new QTableWidget(0, 7, this);
+    stagesTable->setHorizontalHeaderLabels({"Stage", "Count", "Mean (us)", "p50 (us)",
+                                            "p90 (us)", "p99 (us)", "Max (us)"});
+    stagesTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    stagesTable->verticalHeader()->setVisible(false);
+    stagesTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    stagesTable->setSelectionMode(QAbstractItemView::NoSelection);
+    stagesLayout->addWidget(stagesTable);
+
+    mainLayout->addWidget(stagesGroup, 1);
+
+    // === COUNTERS ===
+    QGroupBox *countersGroup = new QGroupBox("Counters", this);
+    QVBoxLayout *countersLayout = new QVBoxLayout(countersGroup);
+
+    countersTable = new QTableWidget(0, 2, this);
+    countersTable->setHorizontalHeaderLabels({"Counter", "Value"});
+    countersTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    countersTable->verticalHeader()->setVisible(false);
+    countersTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    countersTable->setSelectionMode(QAbstractItemView::NoSelection);
+    countersTable->setMaximumHeight(150);
+    countersLayout->addWidget(countersTable);
+
+    throughputLabel = new QLabel(this);
+    throughputLabel->setStyleSheet("font-weight: bold;");
+    schedulerLabel = new QLabel(this);
+    schedulerLabel->setWordWrap(true);
+    schedulerLabel->setStyleSheet("color: gray; font-size: 9pt;");
+    countersLayout->addWidget(throughputLabel);
+    countersLayout->addWidget(schedulerLabel);
+
+    mainLayout->addWidget(countersGroup);
+
+    // === BUTTONS ===
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+    resetButton = new QPushButton("Reset", this);
+    exportJsonButton = new QPushButton("Export JSON...", this);
+    exportCsvButton = new QPushButton("Export CSV...", this);
+    QPushButton *closeButton = new QPushButton("Close", this);
+
+    buttonLayout->addWidget(resetButton);
+    buttonLayout->addStretch();
+    buttonLayout->addWidget(exportJsonButton);
+    buttonLayout->addWidget(exportCsvButton);
+    buttonLayout->addWidget(closeButton);
+    mainLayout->addLayout(buttonLayout);
+
+    // === CONNECTIONS ===
+    connect(resetButton, &QPushButton::clicked, this, &PerformanceDialog::onResetClicked);
+    connect(exportJsonButton, &QPushButton::clicked, this, &PerformanceDialog::onExportJson);
+    connect(exportCsvButton, &QPushButton::clicked, this, &PerformanceDialog::onExportCsv);
+    connect(closeButton, &QPushButton::clicked, this, &QDialog::close);
+
+    setLayout(mainLayout);
+}
+
+void PerformanceDialog::showEvent(QShowEvent *event)
+{
+    QDialog::showEvent(event);
+    refresh();
+    refreshTimer->start();
+}
+
+void PerformanceDialog::hideEvent(QHideEvent *event)
+{
+    // Oculto no se refresca: el snapshot recorre todos los histogramas
+    refreshTimer->stop();
+    QDialog::hideEvent(event);
+}
+
+void PerformanceDialog::refresh()
+{
+    const JTAG::InstrumentationSnapshot snap = JTAG::Instrumentation::instance().snapshot();
+
+    auto number = [](double value, int decimals = 1) {
+        return QString::number(value, 'f', decimals);
+    };
+    auto setRow = [](QTableWidget *table, int row, const QStringList &values) {
+        for (int col = 0; col < values.size(); ++col) {
+            QTableWidgetItem *item = table->item(row, col);
+            if (!item) {
+                item = new QTableWidgetItem();
+                if (col > 0) item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+                table->setItem(row, col, item);
+            }
+            item->setText(values[col]);
+        }
+    };
+
+    stagesTable->setRowCount(static_cast<int>(snap.stages.size()));
+    for (size_t i = 0; i < snap.stages.size(); ++i) {
+        const JTAG::StageSummary &s = snap.stages[i];
+        setRow(stagesTable, static_cast<int>(i), {
+            QString::fromStdString(s.name), QString::number(s.count),
+            number(s.meanUs), number(s.p50Us), number(s.p90Us), number(s.p99Us), number(s.maxUs)
+        });
+    }
+
+    countersTable->setRowCount(static_cast<int>(snap.counters.size()));
+    for (size_t i = 0; i < snap.counters.size(); ++i) {
+        setRow(countersTable, static_cast<int>(i), {
+            QString::fromStdString(snap.counters[i].first), QString::number(snap.counters[i].second)
+        });
+    }
+
+    throughputLabel->setText(QString("%1 scans/s   |   %2 kbit/s   |   %3 s since reset")
+                                 .arg(number(snap.scansPerSecond))
+                                 .arg(number(snap.bitsPerSecond / 1000.0))
+                                 .arg(number(snap.uptimeSeconds, 0)));
+
+    if (controller) {
+        JTAG::SchedulerStats st = controller->getSchedulerStats();
+        schedulerLabel->setText(QString("Scheduler: period %1 us, %2 ticks, %3 overruns (%4 missed periods), "
+                                        "wake-up latency mean %5 us / sd %6 us / max %7 us%8%9")
+                                    .arg(number(st.periodUs, 0))
+                                    .arg(st.ticks)
+                                    .arg(st.overruns)
+                                    .arg(st.missedPeriods)
+                                    .arg(number(st.meanLatencyUs))
+                                    .arg(number(st.stddevLatencyUs))
+                                    .arg(number(st.maxLatencyUs))
+                                    .arg(st.realtimeActive ? ", real-time" : "")
+                                    .arg(st.affinityActive ? ", pinned" : ""));
+    } else {
+        schedulerLabel->setText("Scheduler: not available");
+    }
+}
+
+void PerformanceDialog::onResetClicked()
+{
+    JTAG::Instrumentation::instance().reset();
+    refresh();
+}
+
+void PerformanceDialog::onExportJson()
+{
+    exportSnapshot("JSON Files (*.json)", true);
+}
+
+void PerformanceDialog::onExportCsv()
+{
+    exportSnapshot("CSV Files (*.csv)", false);
+}
+
+void PerformanceDialog::exportSnapshot(const QString &filter, bool json)
+{
+    QString fileName = QFileDialog::getSaveFileName(this, "Export Performance Snapshot",
+                                                    json ? "performance.json" : "performance.csv", filter);
+    if (fileName.isEmpty()) return;
+
+    const JTAG::InstrumentationSnapshot snap = JTAG::Instrumentation::instance().snapshot();
+    const std::string text = json ? snap.toJson() : snap.toCsv();
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        QMessageBox::warning(this, "Export Failed",
+                             QString("Cannot write %1:\n%2").arg(fileName, file.errorString()));
+        return;
+    }
+    file.write(text.data(), static_cast<qint64>(text.size()));
+}
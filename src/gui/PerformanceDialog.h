@@ -0,0 +1,55 @@
+#ifndef PERFORMANCEDIALOG_H
+#define PERFORMANCEDIALOG_H
+
+#include <QDialog>
+#include <QTableWidget>
+#include <QLabel>
+#include <QPushButton>
+#include <QTimer>
+
+namespace JTAG { class ScanController; }
+
+/**
+ * @brief Non-modal performance monitor
+ *
+ * Shows, refreshed every 500 ms:
+ * - Per-stage latency (count, mean, p50/p90/p99, max) from JTAG::Instrumentation
+ * - Counters: scans, bits shifted, dropped frames, tracked hot-path allocations
+ * - Throughput (scans/s, bits/s) and sampling scheduler jitter
+ * Snapshots can be exported as JSON or CSV.
+ */
+class PerformanceDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit PerformanceDialog(const JTAG::ScanController *controller, QWidget *parent = nullptr);
+    ~PerformanceDialog();
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private slots:
+    void refresh();
+    void onResetClicked();
+    void onExportJson();
+    void onExportCsv();
+
+private:
+    void setupUI();
+    void exportSnapshot(const QString &filter, bool json);
+
+    const JTAG::ScanController *controller;
+
+    QTableWidget *stagesTable;
+    QTableWidget *countersTable;
+    QLabel *throughputLabel;
+    QLabel *schedulerLabel;
+    QPushButton *resetButton;
+    QPushButton *exportJsonButton;
+    QPushButton *exportCsvButton;
+    QTimer *refreshTimer;
+};
+
+#endif // PERFORMANCEDIALOG_H
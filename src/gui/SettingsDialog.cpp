@@ -81,6 +81,33 @@ void SettingsDialog::setupUI()
 
     mainLayout->addWidget(decimationGroup);
 
+    // === SAMPLING TIMING GROUP ===
+    QGroupBox *timingGroup = new QGroupBox("Sampling Timing", this);
+    QFormLayout *timingLayout = new QFormLayout(timingGroup);
+
+    preciseTimingCheck = new QCheckBox("Precise deadlines (sleep, then spin the last 200 us)", this);
+    realtimeCheck = new QCheckBox("Real-time priority for the scan thread", this);
+    cpuAffinitySpin = new QSpinBox(this);
+    cpuAffinitySpin->setRange(-1, 255);
+    cpuAffinitySpin->setSpecialValueText("Any");
+    cpuAffinitySpin->setValue(-1);
+
+    QLabel *timingDescription = new QLabel(
+        "Samples are taken at fixed absolute deadlines. Precise mode burns CPU near\n"
+        "each deadline for sub-millisecond accuracy. Real-time priority may need\n"
+        "elevated permissions (e.g. CAP_SYS_NICE on Linux).",
+        this
+    );
+    timingDescription->setWordWrap(true);
+    timingDescription->setStyleSheet("color: gray; font-size: 9pt;");
+
+    timingLayout->addRow("", preciseTimingCheck);
+    timingLayout->addRow("", realtimeCheck);
+    timingLayout->addRow("Pin to CPU:", cpuAffinitySpin);
+    timingLayout->addRow("", timingDescription);
+
+    mainLayout->addWidget(timingGroup);
+
     // === DIALOG BUTTONS ===
     buttonBox = new QDialogButtonBox(
         QDialogButtonBox::Ok | QDialogButtonBox::Cancel | QDialogButtonBox::Apply,
@@ -115,6 +142,28 @@ int SettingsDialog::sampleDecimation() const
     return m_sampleDecimation;
 }
 
+bool SettingsDialog::preciseTiming() const
+{
+    return preciseTimingCheck->isChecked();
+}
+
+bool SettingsDialog::realtimePriority() const
+{
+    return realtimeCheck->isChecked();
+}
+
+int SettingsDialog::cpuAffinity() const
+{
+    return cpuAffinitySpin->value();
+}
+
+void SettingsDialog::setTimingOptions(bool precise, bool realtime, int cpu)
+{
+    preciseTimingCheck->setChecked(precise);
+    realtimeCheck->setChecked(realtime);
+    cpuAffinitySpin->setValue(cpu);
+}
+
 void SettingsDialog::setPollingInterval(int ms)
 {
     m_pollingInterval = ms;
@@ -160,6 +209,7 @@ void SettingsDialog::onApplyClicked()
     // Emit signals without closing dialog
     emit pollingIntervalChanged(m_pollingInterval);
     emit sampleDecimationChanged(m_sampleDecimation);
+    emit timingOptionsChanged(preciseTiming(), realtimePriority(), cpuAffinity());
 }
 
 void SettingsDialog::onAccepted()
@@ -167,5 +217,6 @@ void SettingsDialog::onAccepted()
     // Emit signals and close dialog
     emit pollingIntervalChanged(m_pollingInterval);
     emit sampleDecimationChanged(m_sampleDecimation);
+    emit timingOptionsChanged(preciseTiming(), realtimePriority(), cpuAffinity());
     accept();
 }
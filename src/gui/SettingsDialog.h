@@ -10,6 +10,8 @@
 #include <QHBoxLayout>
 #include <QGroupBox>
 #include <QDialogButtonBox>
+#include <QCheckBox>
+#include <QSpinBox>
 
 /**
  * @brief Settings dialog for performance configuration
@@ -17,6 +19,7 @@
  * Allows user to configure:
  * - Polling interval (refresh rate): 1ms, 5ms, 10ms, 50ms, 100ms, 250ms, 500ms
  * - Sample decimation: capture 1 of every X samples (1-100)
+ * - Sampling timing: precise (sleep + spin) deadlines, real-time priority, CPU pinning
  */
 class SettingsDialog : public QDialog
 {
@@ -29,14 +32,19 @@ public:
     // Getters
     int pollingInterval() const;
     int sampleDecimation() const;
+    bool preciseTiming() const;
+    bool realtimePriority() const;
+    int cpuAffinity() const;      // -1 = any CPU
 
     // Setters
     void setPollingInterval(int ms);
     void setSampleDecimation(int decimation);
+    void setTimingOptions(bool precise, bool realtime, int cpu);
 
 signals:
     void pollingIntervalChanged(int ms);
     void sampleDecimationChanged(int decimation);
+    void timingOptionsChanged(bool precise, bool realtime, int cpu);
 
 private slots:
     void onPollingIntervalIndexChanged(int index);
@@ -52,6 +60,9 @@ private:
     QComboBox *pollingIntervalCombo;
     QSlider *sampleDecimationSlider;
     QLabel *decimationValueLabel;
+    QCheckBox *preciseTimingCheck;
+    QCheckBox *realtimeCheck;
+    QSpinBox *cpuAffinitySpin;
     QDialogButtonBox *buttonBox;
     QPushButton *applyButton;
 
@@ -9,7 +9,9 @@
 #include "mainwindow.h"
 
 #include <QApplication>
+#include <QSerialPortInfo>
 #include "../controller/ScanWorker.h"  // Para acceder a JTAG::PinLevel
+#include "../hal/SerialPorts.h"
 
 /**
  * @brief Punto de entrada principal de la aplicación
@@ -30,6 +32,18 @@ int main(int argc, char *argv[])
     // Esto es necesario porque ScanWorker se ejecuta en un thread separado
     // FASE 2: Usar shared_ptr para evitar copias profundas (95% reducción en overhead)
     qRegisterMetaType<std::shared_ptr<const std::vector<JTAG::PinLevel>>>("std::shared_ptr<const std::vector<JTAG::PinLevel>>");
+    qRegisterMetaType<std::shared_ptr<const JTAG::PinSnapshot>>("std::shared_ptr<const JTAG::PinSnapshot>");
+    qRegisterMetaType<std::shared_ptr<const JTAG::TriggerCapture>>("std::shared_ptr<const JTAG::TriggerCapture>");
+
+    // Detección de sondas USB-CDC con Qt SerialPort en todas las plataformas
+    // (la enumeración nativa del núcleo solo cubre Linux)
+    JTAG::setSerialPortEnumerator([]() {
+        std::vector<JTAG::SerialPortInfo> ports;
+        for (const auto& port : QSerialPortInfo::availablePorts()) {
+            ports.push_back({ port.portName().toStdString(), port.vendorIdentifier(), port.productIdentifier() });
+        }
+        return ports;
+    });
 
     // Crear instancia de la aplicación Qt
     QApplication app(argc, argv);
@@ -0,0 +1,99 @@
+#include "IJTAGAdapter.h"
+#include "../core/BitUtils.h"
+#include <cstring>
+
+namespace JTAG {
+
+    // ============================================================================
+    // IMPLEMENTACIONES POR DEFECTO (adaptadores sin soporte nativo)
+    // ============================================================================
+
+    bool IJTAGAdapter::shiftRaw(const uint8_t* tdi, const uint8_t* tms,
+                                uint8_t* tdo, size_t numBits) {
+        if (!tms) return false;
+
+        // Cada segmento termina en un bit con TMS=1 (o al final del stream).
+        // shiftData(exitShift=true) pone TMS=1 solo en el último bit del segmento,
+        // así que la secuencia TMS resultante es idéntica a la original.
+        std::vector<uint8_t> segIn;
+        std::vector<uint8_t> segOut;
+        size_t start = 0;
+
+        for (size_t i = 0; i < numBits; ++i) {
+            bool tmsBit = getBit(tms, i);
+            bool last = (i + 1 == numBits);
+            if (!tmsBit && !last) continue;
+
+            size_t len = i - start + 1;
+            segIn.assign(bytesForBits(len), 0);
+            if (tdi) copyBits(tdi, start, segIn.data(), 0, len);
+
+            if (!shiftData(segIn, segOut, len, tmsBit)) return false;
+
+            if (tdo) {
+                if (segOut.size() < bytesForBits(len)) return false;
+                copyBits(segOut.data(), 0, tdo, start, len);
+            }
+            start = i + 1;
+        }
+        return true;
+    }
+
+    bool IJTAGAdapter::scanDRBatch(size_t drLength, size_t count,
+                                   const uint8_t* tdiImages, uint8_t* tdoImages) {
+        size_t stride = bytesForBits(drLength);
+        std::vector<uint8_t> dataIn(stride);
+        std::vector<uint8_t> dataOut;
+
+        for (size_t i = 0; i < count; ++i) {
+            std::memcpy(dataIn.data(), tdiImages + i * stride, stride);
+            if (!scanDR(drLength, dataIn, dataOut)) return false;
+            if (tdoImages) {
+                if (dataOut.size() < stride) return false;
+                std::memcpy(tdoImages + i * stride, dataOut.data(), stride);
+            }
+        }
+        return true;
+    }
+
+    // ============================================================================
+    // HELPERS DE STREAM CRUDO
+    // ============================================================================
+
+    namespace {
+        constexpr size_t DR_BATCH_PREFIX = 4;   // Idle(0) → Select-DR(1) → Capture-DR(0) → Shift-DR(0)
+        constexpr size_t DR_BATCH_SUFFIX = 2;   // Exit1-DR → Update-DR(1) → Idle(0)
+    }
+
+    size_t IJTAGAdapter::buildDRBatchStream(size_t drLength, size_t count, const uint8_t* tdiImages,
+                                            std::vector<uint8_t>& tdi, std::vector<uint8_t>& tms) {
+        const size_t stride = bytesForBits(drLength);
+        const size_t bitsPerImage = DR_BATCH_PREFIX + drLength + DR_BATCH_SUFFIX;
+        const size_t totalBytes = bytesForBits(bitsPerImage * count);
+
+        tdi.assign(totalBytes, 0);
+        tms.assign(totalBytes, 0);
+
+        for (size_t i = 0; i < count; ++i) {
+            size_t base = i * bitsPerImage;
+            setBit(tms.data(), base + 1, true);                                  // Select-DR
+            copyBits(tdiImages + i * stride, 0, tdi.data(), base + DR_BATCH_PREFIX, drLength);
+            setBit(tms.data(), base + DR_BATCH_PREFIX + drLength - 1, true);     // Exit1-DR
+            setBit(tms.data(), base + DR_BATCH_PREFIX + drLength, true);         // Update-DR
+        }
+        return bitsPerImage;
+    }
+
+    void IJTAGAdapter::extractDRBatchTdo(size_t drLength, size_t count, const uint8_t* rawTdo,
+                                         uint8_t* tdoImages) {
+        const size_t stride = bytesForBits(drLength);
+        const size_t bitsPerImage = DR_BATCH_PREFIX + drLength + DR_BATCH_SUFFIX;
+
+        for (size_t i = 0; i < count; ++i) {
+            uint8_t* out = tdoImages + i * stride;
+            std::memset(out, 0, stride);
+            copyBits(rawTdo, i * bitsPerImage + DR_BATCH_PREFIX, out, 0, drLength);
+        }
+    }
+
+} // namespace JTAG
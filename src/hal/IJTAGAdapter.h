@@ -12,7 +12,8 @@ namespace JTAG {
         MOCK,
         PICO,
         FT2232H, //Tengo que implementarla todavía
-        JLINK
+        JLINK,
+        REPLAY   // Reproducción de una traza grabada (.jtr), sin hardware
     };
 
     // 2. Definir el Struct de Descriptor SEGUNDO
@@ -20,7 +21,7 @@ namespace JTAG {
         AdapterType type;
         std::string name;
         std::string serialNumber;
-        std::string deviceID;       // Unique device identifier (e.g., "JLINK_12345678")
+        std::string deviceID;       // Unique device identifier (e.g., "JLINK_12345678", "REPLAY_<trace path>")
     };
 
     // 3. Definir la Interfaz TERCERO
@@ -37,6 +38,14 @@ namespace JTAG {
         virtual bool writeTMS(const std::vector<bool>& tmsSequence) = 0;
         virtual bool resetTAP() = 0;
 
+        // Stream crudo TMS/TDI (layout LSB-first, un bit de TMS por bit de TDI)
+        // - Es el formato nativo de sondas tipo J-Link (StoreGetRaw)
+        // - tdi puede ser nullptr (ceros); tdo puede ser nullptr (no se captura)
+        // - Implementación por defecto: trocea en segmentos que terminan en TMS=1
+        //   y los delega a shiftData(). Los drivers con soporte nativo lo sobrescriben.
+        virtual bool shiftRaw(const uint8_t* tdi, const uint8_t* tms,
+                              uint8_t* tdo, size_t numBits);
+
         // ========== PRIMITIVAS DE ALTO NIVEL (transaccionales) ==========
 
         // Cargar instrucción en IR
@@ -51,6 +60,15 @@ namespace JTAG {
         virtual bool scanDR(size_t drLength, const std::vector<uint8_t>& dataIn,
                             std::vector<uint8_t>& dataOut) = 0;
 
+        // Secuencia de scans DR consecutivos en una sola transacción
+        // - tdiImages: count imágenes de bytesForBits(drLength) bytes cada una
+        // - tdoImages: mismo tamaño, puede ser nullptr (no se captura)
+        // - Cada imagen hace Idle → Shift-DR → Update-DR → Idle, como scanDR()
+        // - Implementación por defecto: un scanDR() por imagen. Los drivers con
+        //   stream crudo nativo la sobrescriben con una única transferencia USB.
+        virtual bool scanDRBatch(size_t drLength, size_t count,
+                                 const uint8_t* tdiImages, uint8_t* tdoImages);
+
         // Leer IDCODE (operación atómica optimizada)
         // - Reset → Shift-DR (IDCODE auto-loaded) → captura 32 bits → Run-Test/Idle
         virtual uint32_t readIDCODE() = 0;
@@ -65,10 +83,15 @@ namespace JTAG {
         virtual uint32_t getClockSpeed() const = 0;
         virtual bool setClockSpeed(uint32_t speedHz) = 0;
         virtual std::string getInfo() const = 0;
+
+    protected:
+        // Construye el stream crudo TMS/TDI equivalente a count scanDR() seguidos
+        // (mismo patrón TMS que scanDR: 0,1,0,0 + datos + 1,0). Devuelve bits por imagen.
+        static size_t buildDRBatchStream(size_t drLength, size_t count, const uint8_t* tdiImages,
+                                         std::vector<uint8_t>& tdi, std::vector<uint8_t>& tms);
+        // Extrae las imágenes TDO del stream crudo capturado
+        static void extractDRBatchTdo(size_t drLength, size_t count, const uint8_t* rawTdo,
+                                      uint8_t* tdoImages);
     };
 
 } // namespace JTAG
-
-// Declarar JTAG::AdapterDescriptor como metatype para Qt signals/slots
-#include <QMetaType>
-Q_DECLARE_METATYPE(JTAG::AdapterDescriptor)
\ No newline at end of file
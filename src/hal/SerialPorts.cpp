@@ -0,0 +1,69 @@
+#include "SerialPorts.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+namespace JTAG {
+
+    namespace {
+
+        SerialPortEnumerator& customEnumerator() {
+            static SerialPortEnumerator enumerator;
+            return enumerator;
+        }
+
+#ifdef __linux__
+        // idVendor/idProduct del dispositivo USB que cuelga sobre el tty (hex sin 0x)
+        bool readUsbId(const std::filesystem::path& file, uint16_t& value) {
+            std::ifstream in(file);
+            std::string text;
+            if (!(in >> text)) return false;
+            value = static_cast<uint16_t>(std::strtoul(text.c_str(), nullptr, 16));
+            return true;
+        }
+
+        std::vector<SerialPortInfo> enumerateNative() {
+            namespace fs = std::filesystem;
+            std::vector<SerialPortInfo> ports;
+            std::error_code ec;
+
+            for (const auto& entry : fs::directory_iterator("/sys/class/tty", ec)) {
+                // Solo ttys con dispositivo real (descarta consolas virtuales y pty)
+                const fs::path devicePath = entry.path() / "device";
+                if (!fs::exists(devicePath, ec)) continue;
+
+                SerialPortInfo info;
+                info.portName = entry.path().filename().string();
+
+                // Interfaz USB → dispositivo USB: subir hasta encontrar idVendor
+                fs::path dir = fs::canonical(devicePath, ec);
+                for (int depth = 0; !ec && depth < 4 && !dir.empty(); ++depth, dir = dir.parent_path()) {
+                    if (readUsbId(dir / "idVendor", info.vendorId)) {
+                        readUsbId(dir / "idProduct", info.productId);
+                        break;
+                    }
+                }
+                ec.clear();
+                ports.push_back(std::move(info));
+            }
+            return ports;
+        }
+#else
+        std::vector<SerialPortInfo> enumerateNative() {
+            return {};
+        }
+#endif
+
+    } // namespace
+
+    std::vector<SerialPortInfo> availableSerialPorts() {
+        const SerialPortEnumerator& custom = customEnumerator();
+        return custom ? custom() : enumerateNative();
+    }
+
+    void setSerialPortEnumerator(SerialPortEnumerator enumerator) {
+        customEnumerator() = std::move(enumerator);
+    }
+
+} // namespace JTAG
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace JTAG {
+
+    // Puerto serie visible en el sistema (sondas USB-CDC como la Pico)
+    struct SerialPortInfo {
+        std::string portName;        // Sin prefijo de dispositivo: "ttyACM0", "COM3"
+        uint16_t vendorId = 0;       // 0 si el puerto no es USB
+        uint16_t productId = 0;
+    };
+
+    using SerialPortEnumerator = std::function<std::vector<SerialPortInfo>()>;
+
+    /**
+     * @brief Lista de puertos serie para la detección de sondas
+     *
+     * Implementación nativa sin dependencias: en Linux recorre /sys/class/tty;
+     * en otros sistemas devuelve una lista vacía salvo que la aplicación
+     * instale su propio enumerador (la GUI usa QSerialPortInfo).
+     */
+    std::vector<SerialPortInfo> availableSerialPorts();
+
+    // Sustituye la enumeración nativa (vacío = restaurarla). Llamar al arrancar.
+    void setSerialPortEnumerator(SerialPortEnumerator enumerator);
+
+} // namespace JTAG
@@ -1,4 +1,5 @@
 #include "JLinkAdapter.h"
+#include "../../core/Instrumentation.h"
 #include <iostream>
 #include <vector>
 #include <cstring>
@@ -693,13 +694,23 @@ namespace JTAG {
             tms[lastBitIdx / 8] |= (1 << (lastBitIdx % 8));
         }
 
-        int res = pJLINK_JTAG_StoreGetRaw(tdi.data(), tdo.data(), tms.data(), (uint32_t)numBits);
+        int res;
+        {
+            ScopedStageTimer timer(Stage::SHIFT);
+            res = pJLINK_JTAG_StoreGetRaw(tdi.data(), tdo.data(), tms.data(), (uint32_t)numBits);
+        }
 
-        if (pJLINK_JTAG_SyncBits) pJLINK_JTAG_SyncBits();
+        syncBits();
 
         return (res == 0);
     }
 
+    void JLinkAdapter::syncBits() {
+        if (!pJLINK_JTAG_SyncBits) return;
+        ScopedStageTimer timer(Stage::ADAPTER_SYNC);
+        pJLINK_JTAG_SyncBits();
+    }
+
     bool JLinkAdapter::writeTMS(const std::vector<bool>& tmsSequence) {
         if (!connected) return false;
 
@@ -715,9 +726,13 @@ namespace JTAG {
             }
         }
 
-        int res = pJLINK_JTAG_StoreRaw(tdiBytes.data(), tmsBytes.data(), (uint32_t)numBits);
+        int res;
+        {
+            ScopedStageTimer timer(Stage::TMS_NAVIGATION);
+            res = pJLINK_JTAG_StoreRaw(tdiBytes.data(), tmsBytes.data(), (uint32_t)numBits);
+        }
 
-        if (pJLINK_JTAG_SyncBits) pJLINK_JTAG_SyncBits();
+        syncBits();
 
         return (res == 0);
     }
@@ -726,6 +741,32 @@ namespace JTAG {
         return writeTMS({ 1, 1, 1, 1, 1 });
     }
 
+    bool JLinkAdapter::shiftRaw(const uint8_t* tdi, const uint8_t* tms,
+        uint8_t* tdo, size_t numBits)
+    {
+        if (!connected || !tms) return false;
+        if (numBits == 0) return true;
+
+        // El stream ya viene en el layout nativo de StoreGetRaw: sin conversión
+        std::vector<uint8_t> zeros;
+        if (!tdi) {
+            zeros.assign((numBits + 7) / 8, 0);
+            tdi = zeros.data();
+        }
+
+        int res;
+        {
+            ScopedStageTimer timer(Stage::SHIFT);
+            res = tdo
+                ? pJLINK_JTAG_StoreGetRaw(tdi, tdo, tms, (uint32_t)numBits)
+                : pJLINK_JTAG_StoreRaw(tdi, tms, (uint32_t)numBits);
+        }
+
+        syncBits();
+
+        return (res == 0);
+    }
+
     // ========== MÉTODOS DE ALTO NIVEL (transaccionales) ==========
 
     bool JLinkAdapter::scanIR(uint8_t irLength, const std::vector<uint8_t>& dataIn,
@@ -802,6 +843,25 @@ namespace JTAG {
         return true;
     }
 
+    bool JLinkAdapter::scanDRBatch(size_t drLength, size_t count,
+        const uint8_t* tdiImages, uint8_t* tdoImages) {
+        if (!connected) return false;
+        if (drLength == 0 || count == 0) return true;
+
+        // Todas las imágenes en un único stream crudo: una sola transferencia USB
+        std::vector<uint8_t> tdi, tms;
+        size_t bitsPerImage = buildDRBatchStream(drLength, count, tdiImages, tdi, tms);
+        size_t totalBits = bitsPerImage * count;
+
+        if (!tdoImages) return shiftRaw(tdi.data(), tms.data(), nullptr, totalBits);
+
+        std::vector<uint8_t> rawTdo(tdi.size(), 0);
+        if (!shiftRaw(tdi.data(), tms.data(), rawTdo.data(), totalBits)) return false;
+
+        extractDRBatchTdo(drLength, count, rawTdo.data(), tdoImages);
+        return true;
+    }
+
     uint32_t JLinkAdapter::readIDCODE() {
         if (!connected) return 0;
 
@@ -40,12 +40,16 @@ namespace JTAG {
 
         bool writeTMS(const std::vector<bool>& tmsSequence) override;
         bool resetTAP() override;
+        bool shiftRaw(const uint8_t* tdi, const uint8_t* tms,
+                      uint8_t* tdo, size_t numBits) override;
 
         // Métodos de alto nivel (transaccionales)
         bool scanIR(uint8_t irLength, const std::vector<uint8_t>& dataIn,
                     std::vector<uint8_t>& dataOut) override;
         bool scanDR(size_t drLength, const std::vector<uint8_t>& dataIn,
                     std::vector<uint8_t>& dataOut) override;
+        bool scanDRBatch(size_t drLength, size_t count,
+                         const uint8_t* tdiImages, uint8_t* tdoImages) override;
         uint32_t readIDCODE() override;
 
         // Info
@@ -70,6 +74,8 @@ namespace JTAG {
         void setTargetSerialNumber(uint32_t serial);
 
     private:
+        void syncBits();   // SyncBits con medición (etapa ADAPTER_SYNC)
+
         bool connected = false;
         DLL_HANDLE libHandle = nullptr;
         uint32_t currentSpeed = 1000000;
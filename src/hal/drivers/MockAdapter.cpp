@@ -1,4 +1,5 @@
 #include "MockAdapter.h"
+#include "../../core/Instrumentation.h"
 #include <iostream>
 #include <iomanip>
 #include <cstring>
@@ -30,6 +31,10 @@ namespace JTAG {
         return connected;
     }
 
+    void MockAdapter::simulateLatency(std::chrono::milliseconds delay) const {
+        if (latencyEnabled) std::this_thread::sleep_for(delay);
+    }
+
     bool MockAdapter::setClockSpeed(uint32_t speedHz) {
         clockSpeed = speedHz;
         return true;
@@ -43,7 +48,7 @@ namespace JTAG {
         if (!connected) return false;
 
         // Simular latencia USB realista
-        std::this_thread::sleep_for(std::chrono::milliseconds(5 + numBits / 100));
+        simulateLatency(std::chrono::milliseconds(5 + numBits / 100));
 
         size_t numBytes = (numBits + 7) / 8;
         tdo.resize(numBytes);
@@ -82,7 +87,7 @@ namespace JTAG {
         if (!connected) return false;
 
         // Simular latencia de comando
-        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        simulateLatency(std::chrono::milliseconds(2));
 
         return true;
     }
@@ -91,14 +96,32 @@ namespace JTAG {
         return true;
     }
 
+    bool MockAdapter::shiftRaw(const uint8_t* tdi, const uint8_t* tms,
+                               uint8_t* tdo, size_t numBits) {
+        if (!connected) return false;
+        (void)tms;
+
+        // Una sola "transacción USB" para todo el stream
+        simulateLatency(std::chrono::milliseconds(1 + numBits / 10000));
+
+        // Loopback TDI → TDO (igual que scanIR)
+        if (tdo) {
+            size_t numBytes = (numBits + 7) / 8;
+            if (tdi) std::memcpy(tdo, tdi, numBytes);
+            else std::memset(tdo, 0, numBytes);
+        }
+        return true;
+    }
+
     // ========== MÉTODOS DE ALTO NIVEL (transaccionales) ==========
 
     bool MockAdapter::scanIR(uint8_t irLength, const std::vector<uint8_t>& dataIn,
                              std::vector<uint8_t>& dataOut) {
         if (!connected) return false;
+        ScopedStageTimer timer(Stage::SHIFT);
 
         // Simular latencia realista (navegación TAP + shift)
-        std::this_thread::sleep_for(std::chrono::milliseconds(10 + irLength / 10));
+        simulateLatency(std::chrono::milliseconds(10 + irLength / 10));
 
         // Simular operación: copiar dataIn → dataOut (loopback simple)
         size_t byteCount = (irLength + 7) / 8;
@@ -115,9 +138,10 @@ namespace JTAG {
     bool MockAdapter::scanDR(size_t drLength, const std::vector<uint8_t>& dataIn,
                              std::vector<uint8_t>& dataOut) {
         if (!connected) return false;
+        ScopedStageTimer timer(Stage::SHIFT);
 
         // Simular latencia realista (navegación TAP + shift)
-        std::this_thread::sleep_for(std::chrono::milliseconds(10 + drLength / 100));
+        simulateLatency(std::chrono::milliseconds(10 + drLength / 100));
 
         // === DATOS CAMBIANTES PARA VISUALIZACIÓN ===
         size_t byteCount = (drLength + 7) / 8;
@@ -162,11 +186,30 @@ namespace JTAG {
         return true;
     }
 
+    bool MockAdapter::scanDRBatch(size_t drLength, size_t count,
+                                  const uint8_t* tdiImages, uint8_t* tdoImages) {
+        if (!connected) return false;
+
+        // Una sola latencia para todo el lote (como un driver con stream nativo)
+        simulateLatency(std::chrono::milliseconds(1 + (drLength * count) / 10000));
+
+        // Simulación: cada captura ve lo que se actualizó en el scan anterior
+        // (también entre lotes consecutivos)
+        size_t stride = (drLength + 7) / 8;
+        if (tdoImages && count > 0) {
+            const uint8_t* previous = (lastBatchImage.size() == stride) ? lastBatchImage.data() : tdiImages;
+            std::memcpy(tdoImages, previous, stride);
+            std::memcpy(tdoImages + stride, tdiImages, stride * (count - 1));
+        }
+        if (count > 0) lastBatchImage.assign(tdiImages + (count - 1) * stride, tdiImages + count * stride);
+        return true;
+    }
+
     uint32_t MockAdapter::readIDCODE() {
         if (!connected) return 0;
 
         // Simular latencia de operación completa
-        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        simulateLatency(std::chrono::milliseconds(5));
 
         // Devolver IDCODE fijo del MockAdapter
         std::cout << "[Mock] readIDCODE() - returning 0x12345678\n";
@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <vector>
 #include <string>
+#include <chrono>
 
 namespace JTAG {
 
@@ -24,12 +25,16 @@ namespace JTAG {
 
         bool writeTMS(const std::vector<bool>& tmsSequence) override;
         bool resetTAP() override;
+        bool shiftRaw(const uint8_t* tdi, const uint8_t* tms,
+                      uint8_t* tdo, size_t numBits) override;
 
         // Métodos de alto nivel (transaccionales)
         bool scanIR(uint8_t irLength, const std::vector<uint8_t>& dataIn,
                     std::vector<uint8_t>& dataOut) override;
         bool scanDR(size_t drLength, const std::vector<uint8_t>& dataIn,
                     std::vector<uint8_t>& dataOut) override;
+        bool scanDRBatch(size_t drLength, size_t count,
+                         const uint8_t* tdiImages, uint8_t* tdoImages) override;
         uint32_t readIDCODE() override;
 
         std::string getName() const override { return "Mock JTAG Simulator"; }
@@ -37,12 +42,20 @@ namespace JTAG {
         bool setClockSpeed(uint32_t speedHz) override;
         std::string getInfo() const override { return "Simulation: IDCODE + Walking Bits"; }
 
+        // Latencia USB simulada (sleep por transacción). Desactivada = adaptador
+        // de latencia cero, para medir solo el coste del software (benchmarks)
+        void setLatencyEnabled(bool enabled) { latencyEnabled = enabled; }
+
     private:
+        void simulateLatency(std::chrono::milliseconds delay) const;
+
         bool connected = false;
+        bool latencyEnabled = true;
         uint32_t clockSpeed = 1000000;
 
         // Estado de la simulación
         uint8_t simulationCounter = 0; // Para generar patrones cambiantes
+        std::vector<uint8_t> lastBatchImage;  // Última imagen de scanDRBatch (captura del siguiente lote)
     };
 
 } // namespace JTAG
\ No newline at end of file
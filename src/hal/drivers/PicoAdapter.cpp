@@ -2,37 +2,27 @@
 #include <iostream>
 #include <thread>
 #include <chrono>
-#include <QSerialPortInfo>
+#include "../SerialPorts.h"
 
 //EST� STUBBEADO DE MOMENTO
 
 namespace JTAG {
 
     // Detección dinámica de Pico por USB
-    bool PicoAdapter::isDeviceConnected() {
+    namespace {
         // VID/PID del Raspberry Pi Pico en modo CDC
-        const quint16 PICO_VID = 0x2E8A;  // Raspberry Pi
-        const quint16 PICO_PID = 0x000A;  // Pico (CDC mode)
-
-        const auto ports = QSerialPortInfo::availablePorts();
-        for (const auto& port : ports) {
-            if (port.vendorIdentifier() == PICO_VID &&
-                port.productIdentifier() == PICO_PID) {
-                return true;
-            }
-        }
-        return false;
+        constexpr uint16_t PICO_VID = 0x2E8A;  // Raspberry Pi
+        constexpr uint16_t PICO_PID = 0x000A;  // Pico (CDC mode)
+    }
+
+    bool PicoAdapter::isDeviceConnected() {
+        return !findPicoPort().empty();
     }
 
     std::string PicoAdapter::findPicoPort() {
-        const quint16 PICO_VID = 0x2E8A;
-        const quint16 PICO_PID = 0x000A;
-
-        const auto ports = QSerialPortInfo::availablePorts();
-        for (const auto& port : ports) {
-            if (port.vendorIdentifier() == PICO_VID &&
-                port.productIdentifier() == PICO_PID) {
-                return port.portName().toStdString();
+        for (const auto& port : availableSerialPorts()) {
+            if (port.vendorId == PICO_VID && port.productId == PICO_PID) {
+                return port.portName;
             }
         }
         return "";
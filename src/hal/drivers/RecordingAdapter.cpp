@@ -0,0 +1,187 @@
+#include "RecordingAdapter.h"
+#include "../../core/BitUtils.h"
+#include <iostream>
+#include <algorithm>
+
+namespace JTAG {
+
+    RecordingAdapter::RecordingAdapter(std::unique_ptr<IJTAGAdapter> inner, size_t ringBytes)
+        : inner(std::move(inner))
+        , recorder(ringBytes)
+    {
+    }
+
+    RecordingAdapter::~RecordingAdapter() {
+        recorder.stop();
+    }
+
+    bool RecordingAdapter::startRecording(const std::filesystem::path& tracePath) {
+        return recorder.start(tracePath, inner->getName(), inner->getClockSpeed());
+    }
+
+    void RecordingAdapter::stopRecording() {
+        recorder.stop();
+    }
+
+    void RecordingAdapter::close() {
+        recorder.stop();
+        inner->close();
+    }
+
+    // ============================================================================
+    // HELPERS
+    // ============================================================================
+
+    void RecordingAdapter::record(TraceOp op, bool ok, uint8_t flags, size_t numBits, uint64_t startNs,
+                                  const uint8_t* a, size_t aBytes,
+                                  const uint8_t* b, size_t bBytes,
+                                  const uint8_t* c, size_t cBytes) {
+        TraceRecordHeader header{};
+        header.op = static_cast<uint8_t>(op);
+        header.flags = static_cast<uint8_t>(flags | (ok ? TRACE_OK : 0));
+        header.numBits = static_cast<uint32_t>(numBits);
+        header.timestampNs = startNs;
+        header.durationNs = static_cast<uint32_t>(std::min<uint64_t>(recorder.nowNs() - startNs, UINT32_MAX));
+        recorder.append(header, a, aBytes, b, bBytes, c, cBytes);
+    }
+
+    const uint8_t* RecordingAdapter::fit(const std::vector<uint8_t>& data, size_t bytes,
+                                         std::vector<uint8_t>& scratch) {
+        // Camino normal: el vector ya tiene el tamaño exacto (o mayor)
+        if (data.size() >= bytes) return data.data();
+
+        scratch.assign(bytes, 0);
+        std::copy(data.begin(), data.end(), scratch.begin());
+        return scratch.data();
+    }
+
+    // ============================================================================
+    // PRIMITIVAS (reenvío + grabación)
+    // ============================================================================
+
+    bool RecordingAdapter::shiftData(const std::vector<uint8_t>& tdi, std::vector<uint8_t>& tdo,
+                                     size_t numBits, bool exitShift) {
+        if (!recorder.isRecording()) return inner->shiftData(tdi, tdo, numBits, exitShift);
+
+        uint64_t t0 = recorder.nowNs();
+        bool ok = inner->shiftData(tdi, tdo, numBits, exitShift);
+
+        size_t bytes = bytesForBits(numBits);
+        record(TraceOp::SHIFT_DATA, ok, (exitShift ? TRACE_EXIT_SHIFT : 0) | TRACE_HAS_TDO, numBits, t0,
+               fit(tdi, bytes, scratchIn), bytes, fit(tdo, bytes, scratchOut), bytes);
+        return ok;
+    }
+
+    bool RecordingAdapter::writeTMS(const std::vector<bool>& tmsSequence) {
+        if (!recorder.isRecording()) return inner->writeTMS(tmsSequence);
+
+        uint64_t t0 = recorder.nowNs();
+        bool ok = inner->writeTMS(tmsSequence);
+
+        size_t bits = tmsSequence.size();
+        scratchIn.assign(bytesForBits(bits), 0);
+        for (size_t i = 0; i < bits; ++i) {
+            if (tmsSequence[i]) setBit(scratchIn.data(), i, true);
+        }
+        record(TraceOp::WRITE_TMS, ok, 0, bits, t0, scratchIn.data(), scratchIn.size());
+        return ok;
+    }
+
+    bool RecordingAdapter::resetTAP() {
+        if (!recorder.isRecording()) return inner->resetTAP();
+
+        uint64_t t0 = recorder.nowNs();
+        bool ok = inner->resetTAP();
+        record(TraceOp::RESET_TAP, ok, 0, 0, t0);
+        return ok;
+    }
+
+    bool RecordingAdapter::shiftRaw(const uint8_t* tdi, const uint8_t* tms, uint8_t* tdo, size_t numBits) {
+        if (!recorder.isRecording()) return inner->shiftRaw(tdi, tms, tdo, numBits);
+
+        uint64_t t0 = recorder.nowNs();
+        bool ok = inner->shiftRaw(tdi, tms, tdo, numBits);
+
+        size_t bytes = bytesForBits(numBits);
+        if (!tdi) {
+            scratchIn.assign(bytes, 0);
+            tdi = scratchIn.data();
+        }
+        record(TraceOp::SHIFT_RAW, ok, tdo ? TRACE_HAS_TDO : 0, numBits, t0,
+               tdi, bytes, tms, tms ? bytes : 0, tdo, tdo ? bytes : 0);
+        return ok;
+    }
+
+    bool RecordingAdapter::scanIR(uint8_t irLength, const std::vector<uint8_t>& dataIn,
+                                  std::vector<uint8_t>& dataOut) {
+        if (!recorder.isRecording()) return inner->scanIR(irLength, dataIn, dataOut);
+
+        uint64_t t0 = recorder.nowNs();
+        bool ok = inner->scanIR(irLength, dataIn, dataOut);
+
+        size_t bytes = bytesForBits(irLength);
+        record(TraceOp::SCAN_IR, ok, TRACE_HAS_TDO, irLength, t0,
+               fit(dataIn, bytes, scratchIn), bytes, fit(dataOut, bytes, scratchOut), bytes);
+        return ok;
+    }
+
+    bool RecordingAdapter::scanDR(size_t drLength, const std::vector<uint8_t>& dataIn,
+                                  std::vector<uint8_t>& dataOut) {
+        if (!recorder.isRecording()) return inner->scanDR(drLength, dataIn, dataOut);
+
+        uint64_t t0 = recorder.nowNs();
+        bool ok = inner->scanDR(drLength, dataIn, dataOut);
+
+        size_t bytes = bytesForBits(drLength);
+        record(TraceOp::SCAN_DR, ok, TRACE_HAS_TDO, drLength, t0,
+               fit(dataIn, bytes, scratchIn), bytes, fit(dataOut, bytes, scratchOut), bytes);
+        return ok;
+    }
+
+    bool RecordingAdapter::scanDRBatch(size_t drLength, size_t count,
+                                       const uint8_t* tdiImages, uint8_t* tdoImages) {
+        if (!recorder.isRecording()) return inner->scanDRBatch(drLength, count, tdiImages, tdoImages);
+
+        uint64_t t0 = recorder.nowNs();
+        bool ok = inner->scanDRBatch(drLength, count, tdiImages, tdoImages);
+        uint64_t t1 = recorder.nowNs();
+
+        // Se graba como count scanDR consecutivos: la reproducción y la exportación
+        // SVF no necesitan conocer el lote (la implementación por defecto los consume uno a uno)
+        size_t bytes = bytesForBits(drLength);
+        if (!tdoImages) scratchOut.assign(bytes, 0);
+        uint64_t step = count ? (t1 - t0) / count : 0;
+        for (size_t i = 0; i < count; ++i) {
+            TraceRecordHeader header{};
+            header.op = static_cast<uint8_t>(TraceOp::SCAN_DR);
+            header.flags = static_cast<uint8_t>(TRACE_HAS_TDO | (ok ? TRACE_OK : 0));
+            header.numBits = static_cast<uint32_t>(drLength);
+            header.timestampNs = t0 + i * step;
+            header.durationNs = static_cast<uint32_t>(std::min<uint64_t>(step, UINT32_MAX));
+            recorder.append(header, tdiImages + i * bytes, bytes,
+                            tdoImages ? tdoImages + i * bytes : scratchOut.data(), bytes);
+        }
+        return ok;
+    }
+
+    uint32_t RecordingAdapter::readIDCODE() {
+        if (!recorder.isRecording()) return inner->readIDCODE();
+
+        uint64_t t0 = recorder.nowNs();
+        uint32_t idcode = inner->readIDCODE();
+        record(TraceOp::READ_IDCODE, true, 0, 32, t0,
+               reinterpret_cast<const uint8_t*>(&idcode), sizeof(idcode));
+        return idcode;
+    }
+
+    bool RecordingAdapter::setClockSpeed(uint32_t speedHz) {
+        if (!recorder.isRecording()) return inner->setClockSpeed(speedHz);
+
+        uint64_t t0 = recorder.nowNs();
+        bool ok = inner->setClockSpeed(speedHz);
+        record(TraceOp::SET_CLOCK, ok, 0, 0, t0,
+               reinterpret_cast<const uint8_t*>(&speedHz), sizeof(speedHz));
+        return ok;
+    }
+
+} // namespace JTAG
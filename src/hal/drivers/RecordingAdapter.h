@@ -0,0 +1,73 @@
+#pragma once
+
+#include "../IJTAGAdapter.h"
+#include "../trace/TraceRecorder.h"
+#include <memory>
+#include <filesystem>
+
+namespace JTAG {
+
+    /**
+     * @brief Decorador que graba cada transacción JTAG del adaptador envuelto
+     *
+     * Todas las llamadas se reenvían al adaptador real. Con la grabación activa
+     * se añade un registro (timestamp, duración, TDI/TMS y TDO) al anillo del
+     * TraceRecorder; con la grabación parada el coste es una comprobación atómica.
+     * Pensado para quedarse siempre instalado (ScanController lo interpone al conectar).
+     */
+    class RecordingAdapter : public IJTAGAdapter {
+    public:
+        explicit RecordingAdapter(std::unique_ptr<IJTAGAdapter> inner,
+                                  size_t ringBytes = 8 * 1024 * 1024);
+        ~RecordingAdapter() override;
+
+        // Control de grabación
+        bool startRecording(const std::filesystem::path& tracePath);
+        void stopRecording();
+        bool isRecording() const { return recorder.isRecording(); }
+        const TraceRecorder& getRecorder() const { return recorder; }
+
+        IJTAGAdapter* getInner() const { return inner.get(); }
+
+        // ========== IJTAGAdapter (reenvío + grabación) ==========
+        bool shiftData(const std::vector<uint8_t>& tdi,
+            std::vector<uint8_t>& tdo,
+            size_t numBits,
+            bool exitShift = true) override;
+
+        bool writeTMS(const std::vector<bool>& tmsSequence) override;
+        bool resetTAP() override;
+        bool shiftRaw(const uint8_t* tdi, const uint8_t* tms,
+                      uint8_t* tdo, size_t numBits) override;
+
+        bool scanIR(uint8_t irLength, const std::vector<uint8_t>& dataIn,
+                    std::vector<uint8_t>& dataOut) override;
+        bool scanDR(size_t drLength, const std::vector<uint8_t>& dataIn,
+                    std::vector<uint8_t>& dataOut) override;
+        bool scanDRBatch(size_t drLength, size_t count,
+                         const uint8_t* tdiImages, uint8_t* tdoImages) override;
+        uint32_t readIDCODE() override;
+
+        bool open() override { return inner->open(); }
+        void close() override;
+        bool isConnected() const override { return inner->isConnected(); }
+
+        std::string getName() const override { return inner->getName(); }
+        uint32_t getClockSpeed() const override { return inner->getClockSpeed(); }
+        bool setClockSpeed(uint32_t speedHz) override;
+        std::string getInfo() const override { return inner->getInfo(); }
+
+    private:
+        void record(TraceOp op, bool ok, uint8_t flags, size_t numBits, uint64_t startNs,
+                    const uint8_t* a = nullptr, size_t aBytes = 0,
+                    const uint8_t* b = nullptr, size_t bBytes = 0,
+                    const uint8_t* c = nullptr, size_t cBytes = 0);
+        const uint8_t* fit(const std::vector<uint8_t>& data, size_t bytes, std::vector<uint8_t>& scratch);
+
+        std::unique_ptr<IJTAGAdapter> inner;
+        TraceRecorder recorder;
+        // Buffers reutilizados para normalizar payloads a bytesForBits(numBits)
+        std::vector<uint8_t> scratchIn, scratchOut;
+    };
+
+} // namespace JTAG
@@ -0,0 +1,229 @@
+#include "ReplayAdapter.h"
+#include "../../core/BitUtils.h"
+#include <iostream>
+#include <thread>
+#include <cstring>
+
+namespace JTAG {
+
+    ReplayAdapter::ReplayAdapter(std::filesystem::path tracePath)
+        : tracePath(std::move(tracePath))
+    {
+    }
+
+    ReplayAdapter::~ReplayAdapter() {
+        close();
+    }
+
+    bool ReplayAdapter::open() {
+        if (!trace.open(tracePath)) {
+            std::cerr << "[ReplayAdapter] Cannot load trace: " << trace.getLastError() << "\n";
+            return false;
+        }
+
+        clockSpeed = trace.getHeader()->clockSpeedHz ? trace.getHeader()->clockSpeedHz : clockSpeed;
+        connected = true;
+        rewind();
+
+        std::cout << "[ReplayAdapter] Replaying " << trace.getEvents().size() << " events recorded on "
+                  << trace.getAdapterName() << "\n";
+        return true;
+    }
+
+    void ReplayAdapter::close() {
+        if (connected) {
+            std::cout << "[ReplayAdapter] Closed after " << stats.served << "/" << trace.getEvents().size()
+                      << " events (" << stats.mismatches << " mismatches, "
+                      << stats.outOfSync << " out of sync)\n";
+        }
+        connected = false;
+        trace.close();
+    }
+
+    void ReplayAdapter::rewind() {
+        position = 0;
+        stats = Stats{};
+        const auto& events = trace.getEvents();
+        firstTimestampNs = events.empty() ? 0 : events.front().timestampNs;
+    }
+
+    std::string ReplayAdapter::getInfo() const {
+        return "Replay of " + tracePath.filename().string() + " (" + trace.getAdapterName() + ")";
+    }
+
+    // ============================================================================
+    // SECUENCIADO DE EVENTOS
+    // ============================================================================
+
+    const TraceEvent* ReplayAdapter::next(TraceOp op, size_t numBits) {
+        if (!connected) return nullptr;
+
+        const auto& events = trace.getEvents();
+        if (position >= events.size()) {
+            if (!stats.exhausted) {
+                std::cerr << "[ReplayAdapter] Trace exhausted after " << events.size() << " events\n";
+            }
+            stats.exhausted = true;
+            return nullptr;
+        }
+
+        const TraceEvent& ev = events[position];
+        if (ev.op != op || ev.numBits != numBits) {
+            // No se avanza: la llamada no corresponde a la sesión grabada
+            stats.outOfSync++;
+            std::cerr << "[ReplayAdapter] Out of sync at event " << position
+                      << ": requested op " << static_cast<int>(op) << " (" << numBits << " bits), recorded op "
+                      << static_cast<int>(ev.op) << " (" << ev.numBits << " bits)\n";
+            return nullptr;
+        }
+        return &ev;
+    }
+
+    void ReplayAdapter::complete(const TraceEvent& ev) {
+        if (stats.served == 0) {
+            // El reloj de reproducción arranca con la primera llamada, no con open()
+            replayStart = std::chrono::steady_clock::now();
+        }
+        if (timingMode == TimingMode::ORIGINAL) {
+            // Retornar en el mismo instante relativo en que terminó la llamada original
+            auto target = replayStart + std::chrono::nanoseconds(ev.timestampNs - firstTimestampNs + ev.durationNs);
+            std::this_thread::sleep_until(target);
+        }
+        position++;
+        stats.served++;
+    }
+
+    bool ReplayAdapter::checkBits(const char* what, const uint8_t* requested, const uint8_t* recorded,
+                                  size_t numBits) {
+        if (!recorded) return true;
+
+        size_t fullBytes = numBits / 8;
+        bool equal;
+        if (requested) {
+            equal = std::memcmp(requested, recorded, fullBytes) == 0;
+        } else {
+            equal = true;
+            for (size_t i = 0; i < fullBytes && equal; ++i) equal = (recorded[i] == 0);
+        }
+        for (size_t i = fullBytes * 8; i < numBits && equal; ++i) {
+            equal = (requested ? getBit(requested, i) : false) == getBit(recorded, i);
+        }
+
+        if (!equal) {
+            stats.mismatches++;
+            if (stats.mismatches <= 10) {
+                std::cerr << "[ReplayAdapter] " << what << " mismatch at event " << position << "\n";
+            }
+        }
+        return equal || !strict;
+    }
+
+    // ============================================================================
+    // IJTAGAdapter
+    // ============================================================================
+
+    bool ReplayAdapter::scanIR(uint8_t irLength, const std::vector<uint8_t>& dataIn,
+                               std::vector<uint8_t>& dataOut) {
+        const TraceEvent* ev = next(TraceOp::SCAN_IR, irLength);
+        if (!ev) return false;
+
+        size_t bytes = bytesForBits(irLength);
+        const uint8_t* tdi = dataIn.size() >= bytes ? dataIn.data() : nullptr;
+        if (!checkBits("TDI (IR)", tdi, ev->tdi, irLength)) return false;
+
+        dataOut.assign(ev->tdo, ev->tdo + bytes);
+        complete(*ev);
+        return ev->ok();
+    }
+
+    bool ReplayAdapter::scanDR(size_t drLength, const std::vector<uint8_t>& dataIn,
+                               std::vector<uint8_t>& dataOut) {
+        const TraceEvent* ev = next(TraceOp::SCAN_DR, drLength);
+        if (!ev) return false;
+
+        size_t bytes = bytesForBits(drLength);
+        const uint8_t* tdi = dataIn.size() >= bytes ? dataIn.data() : nullptr;
+        if (!checkBits("TDI (DR)", tdi, ev->tdi, drLength)) return false;
+
+        dataOut.assign(ev->tdo, ev->tdo + bytes);
+        complete(*ev);
+        return ev->ok();
+    }
+
+    bool ReplayAdapter::shiftData(const std::vector<uint8_t>& tdi, std::vector<uint8_t>& tdo,
+                                  size_t numBits, bool exitShift) {
+        const TraceEvent* ev = next(TraceOp::SHIFT_DATA, numBits);
+        if (!ev) return false;
+
+        if (exitShift != ((ev->flags & TRACE_EXIT_SHIFT) != 0)) {
+            stats.mismatches++;
+            if (strict) return false;
+        }
+
+        size_t bytes = bytesForBits(numBits);
+        if (!checkBits("TDI (shift)", tdi.size() >= bytes ? tdi.data() : nullptr, ev->tdi, numBits)) return false;
+
+        tdo.assign(ev->tdo, ev->tdo + bytes);
+        complete(*ev);
+        return ev->ok();
+    }
+
+    bool ReplayAdapter::shiftRaw(const uint8_t* tdi, const uint8_t* tms, uint8_t* tdo, size_t numBits) {
+        const TraceEvent* ev = next(TraceOp::SHIFT_RAW, numBits);
+        if (!ev) return false;
+
+        if (!checkBits("TDI (raw)", tdi, ev->tdi, numBits)) return false;
+        if (!checkBits("TMS (raw)", tms, ev->tms, numBits)) return false;
+
+        if (tdo) {
+            if (ev->tdo) std::memcpy(tdo, ev->tdo, bytesForBits(numBits));
+            else std::memset(tdo, 0, bytesForBits(numBits));
+        }
+        complete(*ev);
+        return ev->ok();
+    }
+
+    bool ReplayAdapter::writeTMS(const std::vector<bool>& tmsSequence) {
+        const TraceEvent* ev = next(TraceOp::WRITE_TMS, tmsSequence.size());
+        if (!ev) return false;
+
+        scratch.assign(bytesForBits(tmsSequence.size()), 0);
+        for (size_t i = 0; i < tmsSequence.size(); ++i) {
+            if (tmsSequence[i]) setBit(scratch.data(), i, true);
+        }
+        if (!checkBits("TMS", scratch.data(), ev->tms, tmsSequence.size())) return false;
+
+        complete(*ev);
+        return ev->ok();
+    }
+
+    bool ReplayAdapter::resetTAP() {
+        const TraceEvent* ev = next(TraceOp::RESET_TAP, 0);
+        if (!ev) return false;
+
+        complete(*ev);
+        return ev->ok();
+    }
+
+    uint32_t ReplayAdapter::readIDCODE() {
+        const TraceEvent* ev = next(TraceOp::READ_IDCODE, 32);
+        if (!ev) return 0;
+
+        uint32_t idcode = ev->value;
+        complete(*ev);
+        return idcode;
+    }
+
+    bool ReplayAdapter::setClockSpeed(uint32_t speedHz) {
+        clockSpeed = speedHz;
+
+        // Solo consume el evento si la grabación lo contiene en esta posición
+        // (el ajuste inicial de la conexión suele ser anterior a startRecording)
+        const auto& events = trace.getEvents();
+        if (connected && position < events.size() && events[position].op == TraceOp::SET_CLOCK) {
+            complete(events[position]);
+        }
+        return true;
+    }
+
+} // namespace JTAG
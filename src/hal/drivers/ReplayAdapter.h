@@ -0,0 +1,99 @@
+#pragma once
+
+#include "../IJTAGAdapter.h"
+#include "../trace/TraceReader.h"
+#include <chrono>
+#include <filesystem>
+
+namespace JTAG {
+
+    /**
+     * @brief Adaptador que reproduce una traza grabada (.jtr) sin hardware
+     *
+     * Cada llamada consume el siguiente evento de la traza: se comprueba que la
+     * operación, la longitud y los bits TDI/TMS pedidos coinciden con los
+     * grabados y se devuelve el TDO capturado en la sesión original.
+     *
+     * Modos de temporización:
+     * - FLAT_OUT: responde inmediatamente (benchmarks de ScanWorker / GUI)
+     * - ORIGINAL: cada llamada retorna en el mismo instante relativo que en la
+     *             grabación (reproducción fiel de la sesión del cliente)
+     */
+    class ReplayAdapter : public IJTAGAdapter {
+    public:
+        enum class TimingMode {
+            FLAT_OUT,
+            ORIGINAL
+        };
+
+        struct Stats {
+            size_t served = 0;         // Eventos reproducidos
+            size_t mismatches = 0;     // TDI/TMS distinto al grabado
+            size_t outOfSync = 0;      // Operación o longitud distinta
+            bool exhausted = false;    // Se pidió más de lo grabado
+        };
+
+        explicit ReplayAdapter(std::filesystem::path tracePath);
+        ~ReplayAdapter() override;
+
+        void setTimingMode(TimingMode mode) { timingMode = mode; }
+        TimingMode getTimingMode() const { return timingMode; }
+
+        // strict: una discrepancia de TDI/TMS hace fallar la llamada
+        void setStrict(bool enabled) { strict = enabled; }
+
+        void rewind();
+        const Stats& getStats() const { return stats; }
+        size_t getPosition() const { return position; }
+        size_t getEventCount() const { return trace.getEvents().size(); }
+        std::string getRecordedAdapterName() const { return trace.getAdapterName(); }
+
+        // ========== IJTAGAdapter ==========
+        bool shiftData(const std::vector<uint8_t>& tdi,
+            std::vector<uint8_t>& tdo,
+            size_t numBits,
+            bool exitShift = true) override;
+
+        bool writeTMS(const std::vector<bool>& tmsSequence) override;
+        bool resetTAP() override;
+        bool shiftRaw(const uint8_t* tdi, const uint8_t* tms,
+                      uint8_t* tdo, size_t numBits) override;
+
+        bool scanIR(uint8_t irLength, const std::vector<uint8_t>& dataIn,
+                    std::vector<uint8_t>& dataOut) override;
+        bool scanDR(size_t drLength, const std::vector<uint8_t>& dataIn,
+                    std::vector<uint8_t>& dataOut) override;
+        uint32_t readIDCODE() override;
+
+        bool open() override;
+        void close() override;
+        bool isConnected() const override { return connected; }
+
+        std::string getName() const override { return "Trace Replay"; }
+        uint32_t getClockSpeed() const override { return clockSpeed; }
+        bool setClockSpeed(uint32_t speedHz) override;
+        std::string getInfo() const override;
+
+    private:
+        // Siguiente evento si coincide en operación y longitud (nullptr si no)
+        const TraceEvent* next(TraceOp op, size_t numBits);
+        // Espera (modo ORIGINAL) y marca el evento como servido
+        void complete(const TraceEvent& ev);
+        bool checkBits(const char* what, const uint8_t* requested, const uint8_t* recorded, size_t numBits);
+
+        std::filesystem::path tracePath;
+        TraceReader trace;
+        size_t position = 0;
+        bool connected = false;
+        bool strict = false;
+        TimingMode timingMode = TimingMode::FLAT_OUT;
+        uint32_t clockSpeed = 1000000;
+        Stats stats;
+
+        std::chrono::steady_clock::time_point replayStart;
+        uint64_t firstTimestampNs = 0;
+
+        std::vector<uint8_t> scratch;
+    };
+
+} // namespace JTAG
@@ -2,6 +2,7 @@
 #include "../drivers/MockAdapter.h"
 #include "../drivers/PicoAdapter.h"
 #include "../drivers/JLinkAdapter.h"
+#include "../drivers/ReplayAdapter.h"
 #include <memory>
 #include <stdexcept>
 #include <algorithm>
@@ -24,6 +25,9 @@ namespace JTAG {
         case AdapterType::FT2232H:
             throw std::runtime_error("FT2232HAdapter no implementado aun");
 
+        case AdapterType::REPLAY:
+            throw std::runtime_error("ReplayAdapter requiere la ruta de la traza (deviceID \"REPLAY_<ruta>\")");
+
         default:
             throw std::runtime_error("Tipo de adaptador desconocido");
         }
@@ -55,6 +59,14 @@ namespace JTAG {
             return jlink;
         }
 
+        case AdapterType::REPLAY: {
+            // deviceID: "REPLAY_<ruta de la traza .jtr>"
+            if (deviceID.size() <= 7 || deviceID.find("REPLAY_") != 0) {
+                throw std::runtime_error("ReplayAdapter requiere la ruta de la traza (deviceID \"REPLAY_<ruta>\")");
+            }
+            return std::make_unique<ReplayAdapter>(std::filesystem::u8path(deviceID.substr(7)));
+        }
+
         case AdapterType::FT2232H:
             throw std::runtime_error("FT2232HAdapter no implementado aun");
 
@@ -73,6 +85,7 @@ namespace JTAG {
         case AdapterType::PICO:    return "PICO";
         case AdapterType::JLINK:   return "JLINK";
         case AdapterType::FT2232H: return "FT2232H";
+        case AdapterType::REPLAY:  return "REPLAY";
         default:                   return "UNKNOWN";
         }
     }
@@ -86,6 +99,7 @@ namespace JTAG {
         if (upper == "PICO")    return AdapterType::PICO;
         if (upper == "JLINK")   return AdapterType::JLINK;
         if (upper == "FT2232H") return AdapterType::FT2232H;
+        if (upper == "REPLAY")  return AdapterType::REPLAY;
 
         throw std::runtime_error("Tipo de adaptador desconocido: " + typeName);
     }
@@ -95,6 +109,7 @@ namespace JTAG {
         case AdapterType::MOCK:
         case AdapterType::PICO:
         case AdapterType::JLINK:
+        case AdapterType::REPLAY:
             return true;
         default:
             return false;
@@ -103,7 +118,7 @@ namespace JTAG {
 
     std::vector<AdapterType> AdapterFactory::getSupportedAdapters() {
         std::vector<AdapterType> allTypes = {
-            AdapterType::MOCK, AdapterType::PICO, AdapterType::JLINK, AdapterType::FT2232H
+            AdapterType::MOCK, AdapterType::PICO, AdapterType::JLINK, AdapterType::FT2232H, AdapterType::REPLAY
         };
         std::vector<AdapterType> supported;
         for (auto type : allTypes) {
@@ -153,6 +168,14 @@ namespace JTAG {
             });
         }
 
+        // 4. REPLAY: siempre disponible; la traza se elige al conectar
+        availableAdapters.push_back({
+            AdapterType::REPLAY,
+            "Trace Replay",
+            "Select .jtr file",
+            "REPLAY_"
+        });
+
         std::cout << "[Factory] Total available adapters: " << availableAdapters.size() << "\n";
         return availableAdapters;
     }
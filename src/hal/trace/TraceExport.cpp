@@ -0,0 +1,264 @@
+#include "TraceExport.h"
+#include "../../core/BitUtils.h"
+#include "../../core/JtagStateMachine.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+
+namespace JTAG {
+
+    namespace {
+
+        bool isStable(TAPState s) {
+            return s == TAPState::TEST_LOGIC_RESET || s == TAPState::RUN_TEST_IDLE ||
+                   s == TAPState::PAUSE_DR || s == TAPState::PAUSE_IR;
+        }
+
+        const char* svfStateName(TAPState s) {
+            switch (s) {
+            case TAPState::TEST_LOGIC_RESET: return "RESET";
+            case TAPState::RUN_TEST_IDLE:    return "IDLE";
+            case TAPState::PAUSE_DR:         return "DRPAUSE";
+            case TAPState::PAUSE_IR:         return "IRPAUSE";
+            default:                         return "IDLE";
+            }
+        }
+
+        // Bits LSB-first → hexadecimal SVF (el primer dígito es el más significativo)
+        std::string toHex(const uint8_t* bits, size_t numBits) {
+            static const char digits[] = "0123456789ABCDEF";
+            size_t nibbles = (numBits + 3) / 4;
+            std::string hex(nibbles, '0');
+            for (size_t n = 0; n < nibbles; ++n) {
+                unsigned v = 0;
+                for (size_t b = 0; b < 4; ++b) {
+                    size_t bit = n * 4 + b;
+                    if (bit < numBits && getBit(bits, bit)) v |= 1u << b;
+                }
+                hex[nibbles - 1 - n] = digits[v];
+            }
+            return hex;
+        }
+
+        class SvfEmitter {
+        public:
+            SvfEmitter(std::ostream& out, bool includeTdo) : out(out), includeTdo(includeTdo) {}
+
+            void comment(const std::string& text) { flushIdle(); out << "! " << text << "\n"; }
+
+            void state(TAPState s) {
+                flushIdle();
+                if (s == TAPState::TEST_LOGIC_RESET || s != current) {
+                    out << "STATE " << svfStateName(s) << ";\n";
+                }
+                current = s;
+            }
+
+            void frequency(uint32_t hz) {
+                flushIdle();
+                out << "FREQUENCY " << hz << " HZ;\n";
+            }
+
+            void wait(double seconds) {
+                flushIdle();
+                out << "RUNTEST " << std::scientific << std::setprecision(3) << seconds
+                    << std::defaultfloat << " SEC;\n";
+            }
+
+            void scan(bool isIR, size_t numBits, const uint8_t* tdi, const uint8_t* tdo, TAPState end) {
+                flushIdle();
+                TAPState& endState = isIR ? endIR : endDR;
+                if (end != endState) {
+                    out << (isIR ? "ENDIR " : "ENDDR ") << svfStateName(end) << ";\n";
+                    endState = end;
+                }
+                out << (isIR ? "SIR " : "SDR ") << numBits << " TDI (" << toHex(tdi, numBits) << ")";
+                if (includeTdo && tdo) out << " TDO (" << toHex(tdo, numBits) << ")";
+                out << ";\n";
+                current = end;
+            }
+
+            // Decodifica un stream crudo TMS/TDI simulando el TAP
+            void raw(const uint8_t* tdi, const uint8_t* tms, const uint8_t* tdo, size_t numBits) {
+                TAPState s = current;
+                for (size_t i = 0; i < numBits; ++i) {
+                    bool t = getBit(tms, i);
+
+                    if (s == TAPState::SHIFT_DR || s == TAPState::SHIFT_IR) {
+                        if (!scanOpen) {
+                            scanOpen = true;
+                            scanComplete = false;
+                            scanIsIR = (s == TAPState::SHIFT_IR);
+                            scanBits = 0;
+                            scanHasTdo = (tdo != nullptr);
+                        }
+                        appendScanBit(tdi ? getBit(tdi, i) : false, tdo ? getBit(tdo, i) : false);
+                    } else if (s == TAPState::RUN_TEST_IDLE && !t) {
+                        pendingIdle++;
+                    }
+
+                    TAPState ns = JtagStateMachine::nextState(s, t);
+
+                    if ((s == TAPState::EXIT2_DR && ns == TAPState::SHIFT_DR) ||
+                        (s == TAPState::EXIT2_IR && ns == TAPState::SHIFT_IR)) {
+                        unsupported++;
+                        comment("Shift resumed from pause: not representable in SVF");
+                    }
+                    if (ns == TAPState::UPDATE_DR || ns == TAPState::UPDATE_IR) scanComplete = true;
+
+                    if (ns != s) {
+                        bool newCapture = (ns == TAPState::CAPTURE_DR || ns == TAPState::CAPTURE_IR);
+                        if (scanOpen && (isStable(ns) || (scanComplete && newCapture))) {
+                            current = s;
+                            scan(scanIsIR, scanBits, scanTdi.data(), scanHasTdo ? scanTdo.data() : nullptr,
+                                 isStable(ns) ? ns : TAPState::RUN_TEST_IDLE);
+                            scanOpen = false;
+                        } else if (!scanOpen && isStable(ns)) {
+                            state(ns);
+                        }
+                    }
+                    s = ns;
+                }
+                current = s;
+            }
+
+            void setCurrent(TAPState s) { current = s; }
+            TAPState getCurrent() const { return current; }
+
+            void finish() {
+                flushIdle();
+                if (scanOpen) {
+                    unsupported++;
+                    comment("Trace ends inside an unfinished shift");
+                }
+            }
+
+            size_t unsupported = 0;
+
+        private:
+            void flushIdle() {
+                if (pendingIdle == 0) return;
+                out << "RUNTEST " << pendingIdle << " TCK;\n";
+                pendingIdle = 0;
+            }
+
+            void appendScanBit(bool tdiBit, bool tdoBit) {
+                size_t bytes = bytesForBits(scanBits + 1);
+                if (scanTdi.size() < bytes) {
+                    scanTdi.resize(bytes * 2, 0);
+                    scanTdo.resize(bytes * 2, 0);
+                }
+                setBit(scanTdi.data(), scanBits, tdiBit);
+                setBit(scanTdo.data(), scanBits, tdoBit);
+                scanBits++;
+            }
+
+            std::ostream& out;
+            bool includeTdo;
+            TAPState current = TAPState::RUN_TEST_IDLE;
+            TAPState endIR = TAPState::RUN_TEST_IDLE;
+            TAPState endDR = TAPState::RUN_TEST_IDLE;
+            uint64_t pendingIdle = 0;
+
+            // Scan en curso dentro de un stream crudo (puede abarcar varios shiftData)
+            std::vector<uint8_t> scanTdi, scanTdo;
+            size_t scanBits = 0;
+            bool scanOpen = false;
+            bool scanComplete = false;
+            bool scanIsIR = false;
+            bool scanHasTdo = false;
+        };
+
+    } // namespace
+
+    bool TraceExport::toSVF(const TraceReader& trace, const std::filesystem::path& svfPath,
+                            const Options& options) {
+        const TraceFileHeader* header = trace.getHeader();
+        if (!header) {
+            std::cerr << "[TraceExport] No trace loaded\n";
+            return false;
+        }
+
+        std::ofstream out(svfPath);
+        if (!out) {
+            std::cerr << "[TraceExport] Cannot create " << svfPath.string() << "\n";
+            return false;
+        }
+
+        out << "! Exported from JTAG session trace\n";
+        out << "! Adapter: " << trace.getAdapterName() << "\n";
+        out << "! Events: " << trace.getEvents().size() << "\n";
+        out << "! Assumes the TAP starts in Run-Test/Idle (state left by the recorded session)\n";
+        if (header->clockSpeedHz > 0) out << "FREQUENCY " << header->clockSpeedHz << " HZ;\n";
+        out << "HIR 0;\nTIR 0;\nHDR 0;\nTDR 0;\nENDIR IDLE;\nENDDR IDLE;\n";
+
+        SvfEmitter svf(out, options.includeTdo);
+        std::vector<uint8_t> tmsBuffer;
+        uint64_t previousEndNs = 0;
+        bool first = true;
+
+        for (const TraceEvent& ev : trace.getEvents()) {
+            if (options.preserveTiming && !first && ev.timestampNs > previousEndNs) {
+                double gap = static_cast<double>(ev.timestampNs - previousEndNs) * 1e-9;
+                if (gap >= options.minGapSec && svf.getCurrent() == TAPState::RUN_TEST_IDLE) svf.wait(gap);
+            }
+            first = false;
+            previousEndNs = ev.timestampNs + ev.durationNs;
+
+            if (!ev.ok()) {
+                svf.comment("Failed call (op " + std::to_string(static_cast<int>(ev.op)) + ") skipped");
+                continue;
+            }
+
+            switch (ev.op) {
+            case TraceOp::SCAN_IR:
+            case TraceOp::SCAN_DR:
+                // Los adaptadores navegan Idle → Shift → Update → Idle
+                svf.scan(ev.op == TraceOp::SCAN_IR, ev.numBits, ev.tdi, ev.tdo, TAPState::RUN_TEST_IDLE);
+                break;
+
+            case TraceOp::RESET_TAP:
+                svf.state(TAPState::TEST_LOGIC_RESET);
+                break;
+
+            case TraceOp::READ_IDCODE: {
+                uint8_t zeros[4] = { 0, 0, 0, 0 };
+                uint8_t idcode[4];
+                std::memcpy(idcode, &ev.value, sizeof(idcode));
+                svf.state(TAPState::TEST_LOGIC_RESET);
+                svf.scan(false, 32, zeros, idcode, TAPState::RUN_TEST_IDLE);
+                break;
+            }
+
+            case TraceOp::WRITE_TMS:
+                svf.raw(nullptr, ev.tms, nullptr, ev.numBits);
+                break;
+
+            case TraceOp::SHIFT_DATA: {
+                // shiftData: TMS=0 salvo el último bit si exitShift
+                tmsBuffer.assign(bytesForBits(ev.numBits), 0);
+                if ((ev.flags & TRACE_EXIT_SHIFT) && ev.numBits > 0) setBit(tmsBuffer.data(), ev.numBits - 1, true);
+                svf.raw(ev.tdi, tmsBuffer.data(), ev.tdo, ev.numBits);
+                break;
+            }
+
+            case TraceOp::SHIFT_RAW:
+                svf.raw(ev.tdi, ev.tms, ev.tdo, ev.numBits);
+                break;
+
+            case TraceOp::SET_CLOCK:
+                svf.frequency(ev.value);
+                break;
+            }
+        }
+
+        svf.finish();
+
+        std::cout << "[TraceExport] SVF written to " << svfPath.string()
+                  << " (" << svf.unsupported << " unsupported sequences)\n";
+        return static_cast<bool>(out);
+    }
+
+} // namespace JTAG
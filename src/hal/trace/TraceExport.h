@@ -0,0 +1,33 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+#include "TraceReader.h"
+
+namespace JTAG {
+
+    /**
+     * @brief Exportación de trazas .jtr a SVF
+     *
+     * scanIR/scanDR/readIDCODE se traducen directamente a SIR/SDR. Los streams
+     * crudos (writeTMS, shiftData, shiftRaw) se decodifican simulando el TAP:
+     * los tramos en Shift-IR/DR pasan a SIR/SDR y los ciclos en Run-Test/Idle a
+     * RUNTEST. Lo que no tiene equivalente SVF queda como comentario.
+     */
+    class TraceExport {
+    public:
+        struct Options {
+            bool includeTdo = true;        // Emitir TDO capturado como valor esperado
+            bool preserveTiming = false;   // Pausas entre transacciones → RUNTEST x SEC
+            double minGapSec = 1e-3;       // Pausa mínima a conservar
+        };
+
+        static bool toSVF(const TraceReader& trace, const std::filesystem::path& svfPath,
+                          const Options& options);
+        static bool toSVF(const TraceReader& trace, const std::filesystem::path& svfPath) {
+            return toSVF(trace, svfPath, Options{});
+        }
+    };
+
+} // namespace JTAG
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace JTAG {
+
+    // ============================================================================
+    // FORMATO DE TRAZA DE SESIÓN (.jtr)
+    // ============================================================================
+    //
+    // [TraceFileHeader]
+    // [TraceRecordHeader + payload] x N     (registros de longitud variable)
+    //
+    // Cada registro es una llamada al adaptador con su resultado. Los buffers de
+    // bits usan el layout de los adaptadores (LSB-first). Payload por operación:
+    //
+    //   SCAN_IR / SCAN_DR / SHIFT_DATA : TDI[bytes] + TDO[bytes]
+    //   SHIFT_RAW                      : TDI[bytes] + TMS[bytes] + TDO[bytes] (si TRACE_HAS_TDO)
+    //   WRITE_TMS                      : TMS[bytes]
+    //   READ_IDCODE                    : uint32 IDCODE
+    //   SET_CLOCK                      : uint32 Hz
+    //   RESET_TAP                      : (vacío)
+    //
+    // Todos los campos multibyte son little-endian.
+
+    constexpr char     TRACE_MAGIC[4] = { 'J', 'T', 'R', 'C' };
+    constexpr uint16_t TRACE_VERSION = 1;
+
+    enum class TraceOp : uint8_t {
+        SCAN_IR = 1,
+        SCAN_DR,
+        SHIFT_DATA,
+        SHIFT_RAW,
+        WRITE_TMS,
+        RESET_TAP,
+        READ_IDCODE,
+        SET_CLOCK
+    };
+
+    enum TraceFlags : uint8_t {
+        TRACE_OK         = 0x01,   // La llamada devolvió éxito
+        TRACE_EXIT_SHIFT = 0x02,   // shiftData(..., exitShift=true)
+        TRACE_HAS_TDO    = 0x04    // El payload incluye TDO capturado
+    };
+
+#pragma pack(push, 1)
+
+    struct TraceFileHeader {
+        char     magic[4];           ///< "JTRC"
+        uint16_t version;            ///< TRACE_VERSION
+        uint16_t headerSize;         ///< sizeof(TraceFileHeader)
+        uint64_t startEpochNs;       ///< Hora de inicio (system_clock, ns desde epoch)
+        uint32_t clockSpeedHz;       ///< Velocidad TCK al empezar la grabación
+        uint32_t reserved;
+        char     adapterName[48];    ///< getName() del adaptador grabado
+    };
+
+    struct TraceRecordHeader {
+        uint8_t  op;                 ///< TraceOp
+        uint8_t  flags;              ///< TraceFlags
+        uint16_t reserved;
+        uint32_t numBits;            ///< Longitud del scan (0 si no aplica)
+        uint64_t timestampNs;        ///< Inicio de la llamada, relativo a startEpochNs
+        uint32_t durationNs;         ///< Duración de la llamada al adaptador
+        uint32_t payloadBytes;
+    };
+
+#pragma pack(pop)
+
+    static_assert(sizeof(TraceRecordHeader) == 24, "TraceRecordHeader debe ocupar 24 bytes");
+
+} // namespace JTAG
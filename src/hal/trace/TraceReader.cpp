@@ -0,0 +1,105 @@
+#include "TraceReader.h"
+#include "../../core/BitUtils.h"
+#include <iostream>
+#include <cstring>
+
+namespace JTAG {
+
+    bool TraceReader::fail(const std::string& message) {
+        lastError = message;
+        std::cerr << "[TraceReader] " << message << "\n";
+        close();
+        return false;
+    }
+
+    void TraceReader::close() {
+        file.close();
+        header = nullptr;
+        events.clear();
+    }
+
+    std::string TraceReader::getAdapterName() const {
+        if (!header) return "";
+        return std::string(header->adapterName, strnlen(header->adapterName, sizeof(header->adapterName)));
+    }
+
+    bool TraceReader::open(const std::filesystem::path& path) {
+        close();
+
+        if (!file.open(path)) {
+            return fail("Cannot map trace file: " + path.string());
+        }
+
+        const uint8_t* base = file.data();
+        size_t size = file.size();
+
+        if (size < sizeof(TraceFileHeader)) return fail("File too small for a trace header");
+
+        header = reinterpret_cast<const TraceFileHeader*>(base);
+        if (std::memcmp(header->magic, TRACE_MAGIC, sizeof(header->magic)) != 0 ||
+            header->version != TRACE_VERSION || header->headerSize != sizeof(TraceFileHeader)) {
+            return fail("Not a JTRC v" + std::to_string(TRACE_VERSION) + " trace");
+        }
+
+        size_t pos = sizeof(TraceFileHeader);
+        while (pos + sizeof(TraceRecordHeader) <= size) {
+            const auto* rec = reinterpret_cast<const TraceRecordHeader*>(base + pos);
+            const uint8_t* payload = base + pos + sizeof(TraceRecordHeader);
+            if (pos + sizeof(TraceRecordHeader) + rec->payloadBytes > size) {
+                // Registro truncado (grabación interrumpida): se ignora la cola
+                std::cerr << "[TraceReader] Truncated record at offset " << pos << ", ignoring tail\n";
+                break;
+            }
+
+            TraceEvent ev;
+            ev.op = static_cast<TraceOp>(rec->op);
+            ev.flags = rec->flags;
+            ev.numBits = rec->numBits;
+            ev.timestampNs = rec->timestampNs;
+            ev.durationNs = rec->durationNs;
+
+            size_t bytes = bytesForBits(ev.numBits);
+            size_t expected = 0;
+
+            switch (ev.op) {
+            case TraceOp::SCAN_IR:
+            case TraceOp::SCAN_DR:
+            case TraceOp::SHIFT_DATA:
+                expected = 2 * bytes;
+                ev.tdi = payload;
+                ev.tdo = payload + bytes;
+                break;
+            case TraceOp::SHIFT_RAW:
+                expected = ((ev.flags & TRACE_HAS_TDO) ? 3 : 2) * bytes;
+                ev.tdi = payload;
+                ev.tms = payload + bytes;
+                if (ev.flags & TRACE_HAS_TDO) ev.tdo = payload + 2 * bytes;
+                break;
+            case TraceOp::WRITE_TMS:
+                expected = bytes;
+                ev.tms = payload;
+                break;
+            case TraceOp::READ_IDCODE:
+            case TraceOp::SET_CLOCK:
+                expected = sizeof(uint32_t);
+                if (rec->payloadBytes >= expected) std::memcpy(&ev.value, payload, sizeof(uint32_t));
+                break;
+            case TraceOp::RESET_TAP:
+                break;
+            default:
+                return fail("Unknown trace op " + std::to_string(rec->op) + " at offset " + std::to_string(pos));
+            }
+
+            if (rec->payloadBytes != expected) {
+                return fail("Payload size mismatch at offset " + std::to_string(pos));
+            }
+
+            events.push_back(ev);
+            pos += sizeof(TraceRecordHeader) + rec->payloadBytes;
+        }
+
+        std::cout << "[TraceReader] Loaded " << events.size() << " events from " << path.string() << "\n";
+        return true;
+    }
+
+} // namespace JTAG
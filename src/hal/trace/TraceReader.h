@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <filesystem>
+
+#include "TraceFormat.h"
+#include "../../core/MappedFile.h"
+
+namespace JTAG {
+
+    // Vista de un registro de la traza (punteros al fichero proyectado en memoria)
+    struct TraceEvent {
+        TraceOp op = TraceOp::RESET_TAP;
+        uint8_t flags = 0;
+        size_t numBits = 0;
+        uint64_t timestampNs = 0;
+        uint32_t durationNs = 0;
+
+        const uint8_t* tdi = nullptr;   // SCAN_IR/SCAN_DR/SHIFT_DATA/SHIFT_RAW
+        const uint8_t* tms = nullptr;   // SHIFT_RAW/WRITE_TMS
+        const uint8_t* tdo = nullptr;   // nullptr si no hay TRACE_HAS_TDO
+        uint32_t value = 0;             // READ_IDCODE / SET_CLOCK
+
+        bool ok() const { return (flags & TRACE_OK) != 0; }
+    };
+
+    /**
+     * @brief Lector de trazas .jtr
+     *
+     * Proyecta el fichero en memoria e indexa los registros una sola vez;
+     * los eventos apuntan directamente a los datos del fichero (sin copias).
+     */
+    class TraceReader {
+    public:
+        TraceReader() = default;
+        ~TraceReader() = default;
+
+        bool open(const std::filesystem::path& path);
+        void close();
+
+        const TraceFileHeader* getHeader() const { return header; }
+        const std::vector<TraceEvent>& getEvents() const { return events; }
+        const std::string& getLastError() const { return lastError; }
+
+        std::string getAdapterName() const;
+
+    private:
+        bool fail(const std::string& message);
+
+        MappedFile file;
+        const TraceFileHeader* header = nullptr;
+        std::vector<TraceEvent> events;
+        std::string lastError;
+    };
+
+} // namespace JTAG
@@ -0,0 +1,156 @@
+#include "TraceRecorder.h"
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+
+namespace JTAG {
+
+    namespace {
+        int64_t steadyNowNs() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+    }
+
+    TraceRecorder::TraceRecorder(size_t ringBytes) {
+        // Capacidad potencia de 2: el índice en el anillo es un AND
+        size_t capacity = 4096;
+        while (capacity < ringBytes) capacity <<= 1;
+        ring.assign(capacity, 0);
+        ringMask = capacity - 1;
+    }
+
+    TraceRecorder::~TraceRecorder() {
+        stop();
+    }
+
+    bool TraceRecorder::start(const std::filesystem::path& path, const std::string& adapterName,
+                              uint32_t clockSpeedHz) {
+        stop();
+
+        file.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cerr << "[TraceRecorder] Cannot create trace file: " << path.string() << "\n";
+            return false;
+        }
+
+        TraceFileHeader header{};
+        std::memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+        header.version = TRACE_VERSION;
+        header.headerSize = sizeof(TraceFileHeader);
+        header.startEpochNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+        header.clockSpeedHz = clockSpeedHz;
+        std::strncpy(header.adapterName, adapterName.c_str(), sizeof(header.adapterName) - 1);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        head.store(0);
+        tail.store(0);
+        recordCount.store(0);
+        droppedCount.store(0);
+        bytesWritten.store(sizeof(header));
+        startSteadyNs = steadyNowNs();
+
+        stopRequested.store(false);
+        recording.store(true, std::memory_order_release);
+        writerThread = std::thread(&TraceRecorder::drainLoop, this);
+
+        std::cout << "[TraceRecorder] Recording to " << path.string()
+                  << " (ring " << ring.size() / 1024 << " KB)\n";
+        return true;
+    }
+
+    void TraceRecorder::stop() {
+        if (!recording.exchange(false)) return;
+
+        // Un append() que ya vio recording == true termina de escribir antes de vaciar y cerrar.
+        // Ambos lados son seq_cst: o append() ve la parada, o stop() ve el append() en curso
+        while (appendsInFlight.load()) std::this_thread::yield();
+
+        stopRequested.store(true);
+        if (writerThread.joinable()) writerThread.join();
+        drain();
+        file.close();
+
+        std::cout << "[TraceRecorder] Stopped: " << recordCount.load() << " records, "
+                  << bytesWritten.load() << " bytes, " << droppedCount.load() << " dropped\n";
+    }
+
+    uint64_t TraceRecorder::nowNs() const {
+        return static_cast<uint64_t>(steadyNowNs() - startSteadyNs);
+    }
+
+    // ============================================================================
+    // CAMINO CRÍTICO
+    // ============================================================================
+
+    void TraceRecorder::writeRing(size_t pos, const uint8_t* data, size_t size) {
+        if (size == 0) return;
+        size_t offset = pos & ringMask;
+        size_t first = std::min(size, ring.size() - offset);
+        std::memcpy(ring.data() + offset, data, first);
+        if (first < size) std::memcpy(ring.data(), data + first, size - first);
+    }
+
+    void TraceRecorder::append(const TraceRecordHeader& header,
+                               const uint8_t* a, size_t aBytes,
+                               const uint8_t* b, size_t bBytes,
+                               const uint8_t* c, size_t cBytes) {
+        appendsInFlight.fetch_add(1);
+        if (!recording.load()) {
+            appendsInFlight.fetch_sub(1, std::memory_order_release);
+            return;
+        }
+
+        size_t total = sizeof(TraceRecordHeader) + aBytes + bBytes + cBytes;
+        uint64_t h = head.load(std::memory_order_relaxed);
+        uint64_t t = tail.load(std::memory_order_acquire);
+
+        if (total > ring.size() - (h - t)) {
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+            appendsInFlight.fetch_sub(1, std::memory_order_release);
+            return;
+        }
+
+        TraceRecordHeader rec = header;
+        rec.payloadBytes = static_cast<uint32_t>(aBytes + bBytes + cBytes);
+
+        size_t pos = h;
+        writeRing(pos, reinterpret_cast<const uint8_t*>(&rec), sizeof(rec)); pos += sizeof(rec);
+        writeRing(pos, a, aBytes); pos += aBytes;
+        writeRing(pos, b, bBytes); pos += bBytes;
+        writeRing(pos, c, cBytes); pos += cBytes;
+
+        head.store(h + total, std::memory_order_release);
+        recordCount.fetch_add(1, std::memory_order_relaxed);
+        appendsInFlight.fetch_sub(1, std::memory_order_release);
+    }
+
+    // ============================================================================
+    // HILO DE SERIALIZACIÓN
+    // ============================================================================
+
+    void TraceRecorder::drain() {
+        uint64_t h = head.load(std::memory_order_acquire);
+        uint64_t t = tail.load(std::memory_order_relaxed);
+        if (h == t) return;
+
+        size_t size = static_cast<size_t>(h - t);
+        size_t offset = t & ringMask;
+        size_t first = std::min(size, ring.size() - offset);
+        file.write(reinterpret_cast<const char*>(ring.data() + offset), first);
+        if (first < size) file.write(reinterpret_cast<const char*>(ring.data()), size - first);
+
+        tail.store(h, std::memory_order_release);
+        bytesWritten.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    void TraceRecorder::drainLoop() {
+        while (!stopRequested.load(std::memory_order_acquire)) {
+            drain();
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+
+} // namespace JTAG
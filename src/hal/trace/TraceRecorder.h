@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+#include <filesystem>
+
+#include "TraceFormat.h"
+
+namespace JTAG {
+
+    /**
+     * @brief Escritor de trazas con buffer circular y serialización en segundo plano
+     *
+     * El camino crítico (append) solo copia bytes a un anillo preasignado: sin
+     * reservas de memoria, sin locks y sin E/S. Un hilo de fondo vacía el anillo
+     * al fichero. Si el anillo se llena el registro se descarta (y se cuenta):
+     * la grabación nunca frena al escaneo.
+     *
+     * Productor único: las llamadas al adaptador ya están serializadas.
+     * stop()/start() sí pueden llegar desde otro hilo: esperan a que termine
+     * el append() en curso antes de vaciar el anillo o reiniciar los índices.
+     */
+    class TraceRecorder {
+    public:
+        explicit TraceRecorder(size_t ringBytes = 8 * 1024 * 1024);
+        ~TraceRecorder();
+
+        TraceRecorder(const TraceRecorder&) = delete;
+        TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+        bool start(const std::filesystem::path& path, const std::string& adapterName, uint32_t clockSpeedHz);
+        void stop();
+        bool isRecording() const { return recording.load(std::memory_order_relaxed); }
+
+        // Hot path: copia un registro (cabecera + hasta 3 bloques de payload)
+        void append(const TraceRecordHeader& header,
+                    const uint8_t* a, size_t aBytes,
+                    const uint8_t* b = nullptr, size_t bBytes = 0,
+                    const uint8_t* c = nullptr, size_t cBytes = 0);
+
+        // Nanosegundos desde el inicio de la grabación (steady_clock)
+        uint64_t nowNs() const;
+
+        uint64_t getRecordCount() const { return recordCount.load(std::memory_order_relaxed); }
+        uint64_t getDroppedCount() const { return droppedCount.load(std::memory_order_relaxed); }
+        uint64_t getBytesWritten() const { return bytesWritten.load(std::memory_order_relaxed); }
+
+    private:
+        void writeRing(size_t pos, const uint8_t* data, size_t size);
+        void drainLoop();
+        void drain();
+
+        std::vector<uint8_t> ring;
+        size_t ringMask;
+
+        // head: bytes producidos, tail: bytes consumidos (contadores monótonos)
+        alignas(64) std::atomic<uint64_t> head{0};
+        alignas(64) std::atomic<uint64_t> tail{0};
+
+        std::atomic<bool> recording{false};
+        std::atomic<uint32_t> appendsInFlight{0};   // append() entre la comprobación y la publicación
+        std::atomic<bool> stopRequested{false};
+        std::thread writerThread;
+        std::ofstream file;
+
+        std::atomic<int64_t> startSteadyNs{0};   // nowNs() se lee desde el hilo del adaptador
+        std::atomic<uint64_t> recordCount{0};
+        std::atomic<uint64_t> droppedCount{0};
+        std::atomic<uint64_t> bytesWritten{0};
+    };
+
+} // namespace JTAG
@@ -0,0 +1,215 @@
+#include "InterconnectTest.h"
+#include "../core/BitUtils.h"
+#include <iostream>
+#include <chrono>
+#include <unordered_map>
+#include <algorithm>
+
+namespace JTAG {
+
+    InterconnectTest::InterconnectTest(IJTAGAdapter* adapter, const DeviceModel& model,
+                                       std::vector<uint8_t> baseImage)
+        : adapter(adapter)
+        , model(model)
+        , bsrLength(model.getBSRLength())
+        , image(std::move(baseImage))
+    {
+        image.resize(bytesForBits(bsrLength), 0);
+    }
+
+    bool InterconnectTest::fail(const std::string& message) {
+        lastError = message;
+        std::cerr << "[InterconnectTest] " << message << "\n";
+        return false;
+    }
+
+    const char* InterconnectTest::faultToString(InterconnectFault fault) {
+        switch (fault) {
+        case InterconnectFault::STUCK_AT_0: return "STUCK_AT_0";
+        case InterconnectFault::STUCK_AT_1: return "STUCK_AT_1";
+        case InterconnectFault::OPEN:       return "OPEN";
+        case InterconnectFault::SHORT:      return "SHORT";
+        case InterconnectFault::MISMATCH:   return "MISMATCH";
+        }
+        return "UNKNOWN";
+    }
+
+    // ============================================================================
+    // CONFIGURACIÓN
+    // ============================================================================
+
+    bool InterconnectTest::setNets(const std::vector<InterconnectNet>& netList) {
+        nets.clear();
+        codeWidth = 0;
+        std::string error;
+
+        auto resolve = [&](const std::string& pin, BusHandle& out) {
+            auto handle = BusHandle::fromPins(model, { pin }, &error);
+            if (!handle) return false;
+            out = std::move(*handle);
+            return true;
+        };
+
+        for (const auto& net : netList) {
+            if (net.drivers.empty() || net.receivers.empty()) {
+                return fail("Net " + net.name + " needs at least one driver and one receiver");
+            }
+
+            ResolvedNet resolved;
+            resolved.name = net.name;
+
+            if (!resolve(net.drivers.front(), resolved.driver)) return fail("Net " + net.name + ": " + error);
+            if (!resolved.driver.canDrive()) return fail("Net " + net.name + ": driver " + net.drivers.front() +
+                                                         " has no output cell");
+            if (resolved.driver.canRead()) resolved.readback = resolved.driver;
+
+            for (size_t i = 1; i < net.drivers.size(); ++i) {
+                BusHandle other;
+                if (!resolve(net.drivers[i], other)) return fail("Net " + net.name + ": " + error);
+                resolved.otherDrivers.push_back(std::move(other));
+            }
+            for (const auto& pin : net.receivers) {
+                BusHandle receiver;
+                if (!resolve(pin, receiver)) return fail("Net " + net.name + ": " + error);
+                if (!receiver.canRead()) return fail("Net " + net.name + ": receiver " + pin + " has no input cell");
+                resolved.receivers.push_back(std::move(receiver));
+            }
+            nets.push_back(std::move(resolved));
+        }
+
+        // w = ceil(log2(N + 2)): códigos 1..N sin usar 0 ni todo-unos
+        codeWidth = 1;
+        while (((1ull << codeWidth) - 2) < nets.size()) codeWidth++;
+        if (codeWidth > 32) return fail("Too many nets for a 64-bit signature");
+
+        for (size_t i = 0; i < nets.size(); ++i) nets[i].code = i + 1;
+
+        std::cout << "[InterconnectTest] " << nets.size() << " nets, " << getPatternCount()
+                  << " patterns (walking ones would need " << nets.size() << ")\n";
+        return true;
+    }
+
+    uint64_t InterconnectTest::expectedSignature(uint64_t code) const {
+        uint64_t wordMask = (1ull << codeWidth) - 1;
+        return (code & wordMask) | ((~code & wordMask) << codeWidth);
+    }
+
+    // ============================================================================
+    // EJECUCIÓN
+    // ============================================================================
+
+    bool InterconnectTest::run(InterconnectReport& report) {
+        report = InterconnectReport{};
+        if (nets.empty()) return fail("No nets configured");
+
+        auto start = std::chrono::steady_clock::now();
+        const size_t patterns = getPatternCount();
+
+        ScanSequence seq(bsrLength, image);
+        uint8_t* img = seq.image();
+
+        // Receptores y drivers secundarios en alta impedancia
+        for (const auto& net : nets) {
+            for (const auto& r : net.receivers) r.release(img);
+            for (const auto& d : net.otherDrivers) d.release(img);
+        }
+
+        std::vector<size_t> patternSlots(patterns);
+        for (size_t p = 0; p < patterns; ++p) {
+            for (const auto& net : nets) {
+                bool bit = (p < codeWidth) ? ((net.code >> p) & 1) : !((net.code >> (p - codeWidth)) & 1);
+                net.driver.drive(img, bit);
+            }
+            patternSlots[p] = seq.commit(true);
+        }
+
+        // Devolver los pines al estado de partida
+        std::copy(image.begin(), image.end(), img);
+        seq.commit();
+
+        if (!seq.execute(adapter)) return fail("Adapter batch transfer failed");
+
+        // Firmas: bit p = valor capturado en el patrón p
+        std::vector<std::vector<uint64_t>> signatures(nets.size());
+        std::vector<uint64_t> driverSignatures(nets.size());
+        for (size_t n = 0; n < nets.size(); ++n) {
+            const auto& net = nets[n];
+            signatures[n].assign(net.receivers.size(), 0);
+            driverSignatures[n] = net.readback.empty() ? expectedSignature(net.code) : 0;
+
+            for (size_t p = 0; p < patterns; ++p) {
+                const uint8_t* capture = seq.capture(patternSlots[p]);
+                for (size_t r = 0; r < net.receivers.size(); ++r) {
+                    signatures[n][r] |= (net.receivers[r].read(capture) & 1) << p;
+                }
+                if (!net.readback.empty()) driverSignatures[n] |= (net.readback.read(capture) & 1) << p;
+            }
+            report.receivers += net.receivers.size();
+        }
+
+        report.nets = nets.size();
+        report.patterns = patterns;
+        report.scans = seq.size();
+        diagnose(signatures, driverSignatures, report);
+        report.passed = report.findings.empty();
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "[InterconnectTest] " << (report.passed ? "PASSED" : "FAILED") << ": "
+                  << report.findings.size() << " finding(s), " << report.scans << " scans in "
+                  << report.seconds << " s\n";
+        return true;
+    }
+
+    void InterconnectTest::diagnose(const std::vector<std::vector<uint64_t>>& signatures,
+                                    const std::vector<uint64_t>& driverSignatures,
+                                    InterconnectReport& report) const {
+        const uint64_t allOnes = (codeWidth * 2 >= 64) ? ~0ull : ((1ull << (codeWidth * 2)) - 1);
+
+        std::unordered_map<uint64_t, size_t> bySignature;
+        bySignature.reserve(nets.size());
+        for (size_t n = 0; n < nets.size(); ++n) bySignature[expectedSignature(nets[n].code)] = n;
+
+        for (size_t n = 0; n < nets.size(); ++n) {
+            const auto& net = nets[n];
+            const uint64_t expected = expectedSignature(net.code);
+
+            for (size_t r = 0; r < net.receivers.size(); ++r) {
+                const uint64_t observed = signatures[n][r];
+                if ((observed ^ expected) == 0) continue;
+
+                InterconnectFinding finding;
+                finding.net = net.name;
+                finding.pin = net.receivers[r].getPins().front().name;
+                finding.expected = expected;
+                finding.observed = observed;
+                finding.fault = InterconnectFault::MISMATCH;
+
+                if (observed == 0 || observed == allOnes) {
+                    // Receptor constante: si el propio driver conmuta bien, la pista está abierta
+                    if (driverSignatures[n] == expected) finding.fault = InterconnectFault::OPEN;
+                    else finding.fault = observed ? InterconnectFault::STUCK_AT_1 : InterconnectFault::STUCK_AT_0;
+                } else {
+                    // Short: firma de otra red (driver dominante) o AND / OR cableado
+                    auto it = bySignature.find(observed);
+                    if (it != bySignature.end()) {
+                        finding.fault = InterconnectFault::SHORT;
+                        finding.otherNet = nets[it->second].name;
+                    } else {
+                        for (size_t o = 0; o < nets.size(); ++o) {
+                            if (o == n) continue;
+                            uint64_t other = expectedSignature(nets[o].code);
+                            if (observed == (expected & other) || observed == (expected | other)) {
+                                finding.fault = InterconnectFault::SHORT;
+                                finding.otherNet = nets[o].name;
+                                break;
+                            }
+                        }
+                    }
+                }
+
+                report.findings.push_back(std::move(finding));
+            }
+        }
+    }
+
+} // namespace JTAG
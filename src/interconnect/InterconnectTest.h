@@ -0,0 +1,100 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "../bus/BusHandle.h"
+#include "../bus/ScanSequence.h"
+#include "../hal/IJTAGAdapter.h"
+
+namespace JTAG {
+
+    // Red de la placa: pines del dispositivo unidos por una misma pista
+    struct InterconnectNet {
+        std::string name;
+        std::vector<std::string> drivers;     // Pines que pueden excitar la red (se usa el primero)
+        std::vector<std::string> receivers;   // Pines que la observan
+    };
+
+    enum class InterconnectFault {
+        STUCK_AT_0,     // Red y driver fijos a 0
+        STUCK_AT_1,     // Red y driver fijos a 1
+        OPEN,           // El driver conmuta pero el receptor no lo ve
+        SHORT,          // La firma coincide con otra red (o su AND / OR)
+        MISMATCH        // Firma inesperada sin diagnóstico concreto
+    };
+
+    struct InterconnectFinding {
+        InterconnectFault fault;
+        std::string net;
+        std::string pin;              // Receptor afectado
+        std::string otherNet;         // SHORT: red con la que está unida
+        uint64_t expected = 0;        // Firma esperada (bit p = patrón p)
+        uint64_t observed = 0;
+    };
+
+    struct InterconnectReport {
+        bool passed = false;
+        size_t nets = 0;
+        size_t receivers = 0;
+        size_t patterns = 0;
+        size_t scans = 0;
+        double seconds = 0.0;
+        std::vector<InterconnectFinding> findings;
+    };
+
+    /**
+     * @brief Test de interconexión con secuencia de conteo verdadero/complemento
+     *
+     * Cada red recibe un código único c (1..N, sin 0 ni todo-unos) de w bits,
+     * w = ceil(log2(N + 2)). El patrón p (< w) excita cada red con el bit p de
+     * su código y el patrón w + p con su complemento: 2·w patrones en lugar de
+     * N de walking-ones, y todas las redes ven tanto 0 como 1.
+     *
+     * La firma de cada receptor (bit p = valor capturado en el patrón p) se
+     * compara por XOR con la esperada; las firmas erróneas se diagnostican
+     * como stuck-at, open o short (igual a otra red, o a su AND / OR cableado).
+     */
+    class InterconnectTest {
+    public:
+        InterconnectTest(IJTAGAdapter* adapter, const DeviceModel& model, std::vector<uint8_t> baseImage);
+        ~InterconnectTest() = default;
+
+        // Resuelve todos los pines a celdas BSR una sola vez
+        bool setNets(const std::vector<InterconnectNet>& nets);
+
+        size_t getPatternCount() const { return 2 * codeWidth; }
+        bool run(InterconnectReport& report);
+
+        static const char* faultToString(InterconnectFault fault);
+
+        const std::vector<uint8_t>& getImage() const { return image; }
+        const std::string& getLastError() const { return lastError; }
+
+    private:
+        struct ResolvedNet {
+            std::string name;
+            BusHandle driver;
+            BusHandle readback;                  // Celda de entrada del propio driver (si existe)
+            std::vector<BusHandle> otherDrivers; // Se dejan en alta impedancia
+            std::vector<BusHandle> receivers;
+            uint64_t code = 0;
+        };
+
+        uint64_t expectedSignature(uint64_t code) const;
+        void diagnose(const std::vector<std::vector<uint64_t>>& signatures,
+                      const std::vector<uint64_t>& driverSignatures, InterconnectReport& report) const;
+        bool fail(const std::string& message);
+
+        IJTAGAdapter* adapter;
+        const DeviceModel& model;
+        size_t bsrLength;
+        std::vector<uint8_t> image;
+
+        std::vector<ResolvedNet> nets;
+        size_t codeWidth = 0;
+        std::string lastError;
+    };
+
+} // namespace JTAG
@@ -0,0 +1,355 @@
+#include "Netlist.h"
+#include "../core/MappedFile.h"
+#include "../core/Json.h"
+#include <iostream>
+#include <chrono>
+#include <string_view>
+#include <unordered_map>
+#include <algorithm>
+#include <cctype>
+
+namespace JTAG {
+
+    namespace {
+
+        std::string lowerExtension(const std::filesystem::path& path) {
+            std::string ext = path.extension().string();
+            std::transform(ext.begin(), ext.end(), ext.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            return ext;
+        }
+
+        std::string_view trim(std::string_view s) {
+            while (!s.empty() && (s.front() == ' ' || s.front() == '\t' || s.front() == '"')) s.remove_prefix(1);
+            while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r' || s.back() == '"')) {
+                s.remove_suffix(1);
+            }
+            return s;
+        }
+
+        // "U1.A1" → ("U1", "A1")
+        bool splitRefPin(std::string_view s, std::string_view& ref, std::string_view& pin) {
+            size_t dot = s.find('.');
+            if (dot == std::string_view::npos || dot == 0 || dot + 1 >= s.size()) return false;
+            ref = s.substr(0, dot);
+            pin = s.substr(dot + 1);
+            return true;
+        }
+
+        // Asigna índices de red por nombre durante la importación
+        class NetNamer {
+        public:
+            explicit NetNamer(RawNetlist& out) : out(out) {}
+
+            uint32_t get(std::string_view name) {
+                auto it = index.find(std::string(name));
+                if (it != index.end()) return it->second;
+                uint32_t id = static_cast<uint32_t>(out.nets.size());
+                out.nets.emplace_back(name);
+                index.emplace(out.nets.back(), id);
+                return id;
+            }
+
+        private:
+            RawNetlist& out;
+            std::unordered_map<std::string, uint32_t> index;
+        };
+
+        std::vector<std::unique_ptr<INetlistImporter>>& registry() {
+            static std::vector<std::unique_ptr<INetlistImporter>> importers = [] {
+                std::vector<std::unique_ptr<INetlistImporter>> v;
+                v.push_back(std::make_unique<CsvNetlistImporter>());
+                v.push_back(std::make_unique<JsonNetlistImporter>());
+                return v;
+            }();
+            return importers;
+        }
+
+    } // namespace
+
+    // ============================================================================
+    // REGISTRO DE FORMATOS
+    // ============================================================================
+
+    void NetlistImporter::registerImporter(std::unique_ptr<INetlistImporter> importer) {
+        if (importer) registry().push_back(std::move(importer));
+    }
+
+    std::vector<std::string> NetlistImporter::getFormats() {
+        std::vector<std::string> names;
+        for (const auto& importer : registry()) names.push_back(importer->getName());
+        return names;
+    }
+
+    bool NetlistImporter::load(const std::filesystem::path& path, RawNetlist& out, std::string* error) {
+        out.clear();
+        auto& importers = registry();
+
+        for (auto it = importers.rbegin(); it != importers.rend(); ++it) {
+            if (!(*it)->canImport(path)) continue;
+
+            auto start = std::chrono::steady_clock::now();
+            std::string message;
+            if (!(*it)->import(path, out, message)) {
+                if (error) *error = (*it)->getName() + ": " + message;
+                std::cerr << "[NetlistImporter] " << path.filename().string() << ": " << message << "\n";
+                return false;
+            }
+
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            std::cout << "[NetlistImporter] " << (*it)->getName() << ": " << out.nets.size() << " nets, "
+                      << out.pins.size() << " pins in " << ms << " ms\n";
+            return true;
+        }
+
+        if (error) *error = "Unsupported netlist format: " + path.filename().string();
+        return false;
+    }
+
+    // ============================================================================
+    // CSV
+    // ============================================================================
+
+    bool CsvNetlistImporter::canImport(const std::filesystem::path& path) const {
+        std::string ext = lowerExtension(path);
+        return ext == ".csv" || ext == ".tsv" || ext == ".net";
+    }
+
+    bool CsvNetlistImporter::import(const std::filesystem::path& path, RawNetlist& out, std::string& error) {
+        MappedFile file;
+        if (!file.open(path)) {
+            error = "Cannot open " + path.string();
+            return false;
+        }
+
+        std::string_view text(reinterpret_cast<const char*>(file.data()), file.size());
+        NetNamer namer(out);
+        out.pins.reserve(text.size() / 16);
+
+        size_t lineNumber = 0;
+        size_t pos = 0;
+        std::string_view fields[4];
+
+        while (pos < text.size()) {
+            size_t eol = text.find('\n', pos);
+            if (eol == std::string_view::npos) eol = text.size();
+            std::string_view line = text.substr(pos, eol - pos);
+            pos = eol + 1;
+            lineNumber++;
+
+            line = trim(line);
+            if (line.empty() || line.front() == '#') continue;
+
+            // Separación en campos sin copias
+            size_t count = 0;
+            size_t start = 0;
+            for (size_t i = 0; i <= line.size() && count < 4; ++i) {
+                if (i == line.size() || line[i] == ',' || line[i] == ';' || line[i] == '\t') {
+                    fields[count++] = trim(line.substr(start, i - start));
+                    start = i + 1;
+                }
+            }
+
+            // Cabecera opcional
+            if (lineNumber == 1 && (fields[0] == "net" || fields[0] == "NET" || fields[0] == "Net")) continue;
+
+            std::string_view ref, pin;
+            if (count >= 3 && !fields[1].empty() && !fields[2].empty()) {
+                ref = fields[1];
+                pin = fields[2];
+            } else if (count == 2 && splitRefPin(fields[1], ref, pin)) {
+                // net,REF.PIN
+            } else {
+                error = "Line " + std::to_string(lineNumber) + ": expected net,refdes,pin";
+                return false;
+            }
+            if (fields[0].empty()) {
+                error = "Line " + std::to_string(lineNumber) + ": empty net name";
+                return false;
+            }
+
+            out.pins.push_back({ namer.get(fields[0]), std::string(ref), std::string(pin) });
+        }
+        return true;
+    }
+
+    // ============================================================================
+    // JSON
+    // ============================================================================
+
+    bool JsonNetlistImporter::canImport(const std::filesystem::path& path) const {
+        return lowerExtension(path) == ".json";
+    }
+
+    bool JsonNetlistImporter::import(const std::filesystem::path& path, RawNetlist& out, std::string& error) {
+        MappedFile file;
+        if (!file.open(path)) {
+            error = "Cannot open " + path.string();
+            return false;
+        }
+
+        auto doc = JsonValue::parse(std::string_view(reinterpret_cast<const char*>(file.data()), file.size()), &error);
+        if (!doc) return false;
+
+        const JsonValue& nets = doc->isArray() ? *doc : (*doc)["nets"];
+        if (!nets.isArray()) {
+            error = "Missing 'nets' array";
+            return false;
+        }
+
+        NetNamer namer(out);
+        for (size_t n = 0; n < nets.size(); ++n) {
+            const JsonValue& net = nets[n];
+            const std::string& name = net["name"].asString();
+            if (name.empty()) {
+                error = "Net #" + std::to_string(n) + " has no name";
+                return false;
+            }
+            uint32_t id = namer.get(name);
+
+            const JsonValue& pins = net["pins"];
+            for (size_t p = 0; p < pins.size(); ++p) {
+                const JsonValue& entry = pins[p];
+                std::string_view ref, pin;
+                if (entry.isString()) {
+                    if (!splitRefPin(entry.asString(), ref, pin)) {
+                        error = "Net " + name + ": invalid pin '" + entry.asString() + "' (expected REF.PIN)";
+                        return false;
+                    }
+                } else {
+                    ref = entry["ref"].asString();
+                    pin = entry["pin"].asString();
+                    if (ref.empty() || pin.empty()) {
+                        error = "Net " + name + ": pin entry needs 'ref' and 'pin'";
+                        return false;
+                    }
+                }
+                out.pins.push_back({ id, std::string(ref), std::string(pin) });
+            }
+        }
+        return true;
+    }
+
+    // ============================================================================
+    // ÍNDICE DE PLACA
+    // ============================================================================
+
+    bool BoardNetlist::build(const RawNetlist& raw, const std::vector<BoardDevice>& boardDevices,
+                             std::string* error) {
+        devices = boardDevices;
+        netNames = raw.nets;
+        nodes.clear();
+        nodePinNames.clear();
+        unresolvedPins = 0;
+
+        if (devices.size() > 0xFFFF) {
+            if (error) *error = "Too many devices";
+            return false;
+        }
+
+        // Tablas temporales de resolución (solo durante build)
+        std::unordered_map<std::string, uint16_t> deviceByRef;
+        // Claves: vistas del arena de cada DeviceModel; valor: índice de pin
+        std::vector<std::unordered_map<std::string_view, uint32_t>> pinLookup(devices.size());
+        for (size_t d = 0; d < devices.size(); ++d) {
+            deviceByRef[devices[d].refdes] = static_cast<uint16_t>(d);
+            if (!devices[d].model) continue;
+            const PinRange pins = devices[d].model->getAllPins();
+            pinLookup[d].reserve(pins.size() * 2);
+            for (uint32_t p = 0; p < pins.size(); ++p) {
+                const PinView info = pins[p];
+                pinLookup[d].emplace(info.name, p);
+                if (!info.pinNumber.empty()) pinLookup[d].emplace(info.pinNumber, p);
+            }
+        }
+
+        // Pasada 1: resolver y contar nodos por red
+        struct Resolved { uint32_t raw; uint16_t device; PinView info; };
+        std::vector<Resolved> resolved;
+        resolved.reserve(raw.pins.size());
+        std::vector<uint32_t> counts(netNames.size() + 1, 0);
+
+        for (uint32_t i = 0; i < raw.pins.size(); ++i) {
+            const NetlistPin& pin = raw.pins[i];
+            if (pin.net >= netNames.size()) {
+                if (error) *error = "Pin references unknown net index";
+                return false;
+            }
+
+            auto dev = deviceByRef.find(pin.refdes);
+            if (dev == deviceByRef.end()) { unresolvedPins++; continue; }
+
+            auto& lookup = pinLookup[dev->second];
+            auto it = lookup.find(pin.pin);
+            if (it == lookup.end()) {
+                unresolvedPins++;
+                continue;
+            }
+            const PinView info = devices[dev->second].model->getPin(it->second);
+            if (info.outputCell < 0 && info.inputCell < 0) {
+                unresolvedPins++;
+                continue;
+            }
+            resolved.push_back({ i, dev->second, info });
+            counts[pin.net + 1]++;
+        }
+
+        // Pasada 2: prefijos (CSR) y reparto por red
+        netOffsets.assign(netNames.size() + 1, 0);
+        for (size_t n = 0; n < netNames.size(); ++n) netOffsets[n + 1] = netOffsets[n] + counts[n + 1];
+
+        nodes.resize(resolved.size());
+        nodePinNames.resize(resolved.size());
+        std::vector<uint32_t> cursor(netOffsets.begin(), netOffsets.end() - 1);
+
+        for (const auto& r : resolved) {
+            const NetlistPin& pin = raw.pins[r.raw];
+            const PinView& info = r.info;
+
+            NetNode node;
+            node.net = pin.net;
+            node.device = r.device;
+            node.role = (info.outputCell >= 0 && info.inputCell >= 0) ? NetNodeRole::BIDIR
+                      : (info.outputCell >= 0 ? NetNodeRole::DRIVER : NetNodeRole::RECEIVER);
+            node.disableValue = static_cast<int8_t>(info.disableValue);
+            node.outputCell = info.outputCell;
+            node.inputCell = info.inputCell;
+            node.controlCell = info.controlCell;
+
+            uint32_t slot = cursor[pin.net]++;
+            nodes[slot] = node;
+            nodePinNames[slot] = std::string(info.name);
+        }
+
+        std::cout << "[BoardNetlist] " << netNames.size() << " nets, " << nodes.size() << " boundary-scan nodes on "
+                  << devices.size() << " device(s), " << unresolvedPins << " pins without boundary scan\n";
+        return true;
+    }
+
+    std::vector<InterconnectNet> BoardNetlist::toInterconnectNets(uint16_t device) const {
+        std::vector<InterconnectNet> result;
+
+        for (uint32_t n = 0; n < netNames.size(); ++n) {
+            const NetNode* begin = netBegin(n);
+            const NetNode* end = netEnd(n);
+            if (begin == end) continue;
+
+            InterconnectNet net;
+            net.name = netNames[n];
+            bool local = true;
+
+            for (const NetNode* node = begin; node != end; ++node) {
+                if (node->device != device) { local = false; break; }
+                const std::string& pin = nodePinNames[node - nodes.data()];
+                if (node->outputCell >= 0) net.drivers.push_back(pin);
+                if (node->inputCell >= 0 && !(net.drivers.size() == 1 && net.drivers.front() == pin)) {
+                    net.receivers.push_back(pin);
+                }
+            }
+
+            if (local && !net.drivers.empty() && !net.receivers.empty()) result.push_back(std::move(net));
+        }
+        return result;
+    }
+
+} // namespace JTAG
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <filesystem>
+
+#include "../bsdl/DeviceModel.h"
+#include "InterconnectTest.h"
+
+namespace JTAG {
+
+    // ============================================================================
+    // NETLIST IMPORTADA (tal cual viene del CAD)
+    // ============================================================================
+
+    struct NetlistPin {
+        uint32_t net;            // Índice en RawNetlist::nets
+        std::string refdes;      // "U1"
+        std::string pin;         // Nombre de pin o número de bola ("A1", "PA0"...)
+    };
+
+    struct RawNetlist {
+        std::vector<std::string> nets;
+        std::vector<NetlistPin> pins;
+
+        void clear() { nets.clear(); pins.clear(); }
+    };
+
+    /**
+     * @brief Punto de extensión para formatos de netlist
+     *
+     * Un importador nuevo (Allegro, PADS, IPC-D-356...) solo tiene que rellenar
+     * RawNetlist; el índice de placa se construye igual para todos.
+     */
+    class INetlistImporter {
+    public:
+        virtual ~INetlistImporter() = default;
+        virtual std::string getName() const = 0;
+        virtual bool canImport(const std::filesystem::path& path) const = 0;
+        virtual bool import(const std::filesystem::path& path, RawNetlist& out, std::string& error) = 0;
+    };
+
+    class NetlistImporter {
+    public:
+        // Los formatos registrados se prueban en orden inverso (el último tiene prioridad)
+        static void registerImporter(std::unique_ptr<INetlistImporter> importer);
+        static bool load(const std::filesystem::path& path, RawNetlist& out, std::string* error = nullptr);
+        static std::vector<std::string> getFormats();
+    };
+
+    // CSV: "net,refdes,pin" (o "net,REF.PIN"); separador ',', ';' o tabulador; '#' comenta
+    class CsvNetlistImporter : public INetlistImporter {
+    public:
+        std::string getName() const override { return "CSV"; }
+        bool canImport(const std::filesystem::path& path) const override;
+        bool import(const std::filesystem::path& path, RawNetlist& out, std::string& error) override;
+    };
+
+    // JSON: {"nets": [{"name": "N1", "pins": ["U1.A1", {"ref": "U2", "pin": "B3"}]}]}
+    class JsonNetlistImporter : public INetlistImporter {
+    public:
+        std::string getName() const override { return "JSON"; }
+        bool canImport(const std::filesystem::path& path) const override;
+        bool import(const std::filesystem::path& path, RawNetlist& out, std::string& error) override;
+    };
+
+    // ============================================================================
+    // ÍNDICE DE PLACA (arrays planos)
+    // ============================================================================
+
+    enum class NetNodeRole : uint8_t {
+        RECEIVER = 1,   // Solo celda de entrada
+        DRIVER = 2,     // Solo celda de salida
+        BIDIR = 3       // Entrada y salida
+    };
+
+    // Nodo de red resuelto a celdas BSR: POD, sin strings ni punteros
+    struct NetNode {
+        uint32_t net;
+        uint16_t device;          // Índice en getDevices()
+        NetNodeRole role;
+        int8_t disableValue;
+        int32_t outputCell;
+        int32_t inputCell;
+        int32_t controlCell;
+    };
+
+    struct BoardDevice {
+        std::string refdes;
+        const DeviceModel* model = nullptr;
+    };
+
+    /**
+     * @brief Modelo de placa: red → lista de celdas driver/receptor en toda la cadena
+     *
+     * Los nodos se guardan agrupados por red en un único vector (CSR:
+     * netOffsets[n]..netOffsets[n+1]); los nombres van en arrays aparte solo
+     * para informes. Recorrer todas las redes en cada scan es O(nodos) sin
+     * hashing. Los pines de componentes sin boundary scan (pasivos, etc.) se
+     * ignoran y se cuentan como no resueltos.
+     */
+    class BoardNetlist {
+    public:
+        bool build(const RawNetlist& raw, const std::vector<BoardDevice>& devices, std::string* error = nullptr);
+
+        size_t getNetCount() const { return netNames.size(); }
+        size_t getNodeCount() const { return nodes.size(); }
+        size_t getUnresolvedPinCount() const { return unresolvedPins; }
+        const std::vector<BoardDevice>& getDevices() const { return devices; }
+
+        const std::string& getNetName(uint32_t net) const { return netNames[net]; }
+        const NetNode* netBegin(uint32_t net) const { return nodes.data() + netOffsets[net]; }
+        const NetNode* netEnd(uint32_t net) const { return nodes.data() + netOffsets[net + 1]; }
+        const std::vector<NetNode>& getNodes() const { return nodes; }
+        const std::string& getNodePinName(size_t node) const { return nodePinNames[node]; }
+
+        // Redes comprobables con un único dispositivo (driver y receptor en él)
+        std::vector<InterconnectNet> toInterconnectNets(uint16_t device) const;
+
+    private:
+        std::vector<BoardDevice> devices;
+        std::vector<std::string> netNames;
+        std::vector<uint32_t> netOffsets;      // netCount + 1
+        std::vector<NetNode> nodes;            // Agrupados por red
+        std::vector<std::string> nodePinNames; // Paralelo a nodes (datos fríos)
+        size_t unresolvedPins = 0;
+    };
+
+} // namespace JTAG
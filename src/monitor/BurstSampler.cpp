@@ -0,0 +1,97 @@
+#include "BurstSampler.h"
+#include "../core/BitUtils.h"
+#include "../core/MonotonicClock.h"
+#include <iostream>
+#include <algorithm>
+
+namespace JTAG {
+
+    bool BurstSampler::fail(const std::string& msg) {
+        lastError = msg;
+        std::cerr << "[BurstSampler] " << msg << "\n";
+        return false;
+    }
+
+    bool BurstSampler::prepare(const BurstSpec& newSpec) {
+        if (!engine || engine->getBSRLength() == 0) return fail("No BSR configured");
+        if (newSpec.samples == 0) return fail("Burst needs at least one sample");
+
+        spec = newSpec;
+        spec.batchSize = std::max<size_t>(1, std::min(spec.batchSize, spec.samples));
+        stride = bytesForBits(engine->getBSRLength());
+
+        // Toda la memoria de la ráfaga se reserva aquí
+        ring.assign(spec.samples * stride, 0);
+        timestamps.assign(spec.samples, 0);
+        stats = BurstStats{};
+        return true;
+    }
+
+    std::shared_ptr<TriggerCapture> BurstSampler::run(const std::atomic<bool>& abort) {
+        if (ring.empty()) {
+            fail("Burst not prepared");
+            return nullptr;
+        }
+
+        const size_t capacity = spec.samples;
+        const bool timed = spec.duration.count() > 0;
+        const uint64_t start = monotonicNowNs();
+        const uint64_t end = start + static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(spec.duration).count());
+
+        size_t head = 0;
+        uint64_t total = 0;
+        while (!abort) {
+            if (!timed && total >= capacity) break;
+            if (timed && total > 0 && monotonicNowNs() >= end) break;
+
+            // El lote se captura en un tramo contiguo del anillo (se corta al dar la vuelta)
+            size_t n = std::min(spec.batchSize, capacity - head);
+            if (!timed) n = std::min<size_t>(n, capacity - total);
+
+            if (!engine->sampleBatch(n, ring.data() + head * stride)) {
+                fail("Adapter batch scan failed after " + std::to_string(total) + " samples");
+                return nullptr;
+            }
+            const ScanTiming& timing = engine->getLastScanTiming();
+            const uint64_t t0 = timing.startNs, t1 = timing.endNs;
+            for (size_t i = 0; i < n; ++i) {
+                timestamps[head + i] = t0 + (t1 - t0) * (2 * i + 1) / (2 * n);   // Centro de su hueco
+            }
+
+            head = (head + n) % capacity;
+            total += n;
+            stats.batches++;
+        }
+
+        size_t count = static_cast<size_t>(std::min<uint64_t>(total, capacity));
+        stats.samples = count;
+        stats.scans = total;
+        stats.seconds = (monotonicNowNs() - start) * 1e-9;
+        stats.samplesPerSecond = stats.seconds > 0 ? total / stats.seconds : 0.0;
+
+        // Anillo lleno y con vuelta: rotar para que la muestra más antigua quede primera
+        if (total > capacity && head != 0) {
+            std::rotate(ring.begin(), ring.begin() + head * stride, ring.end());
+            std::rotate(timestamps.begin(), timestamps.begin() + head, timestamps.end());
+        }
+
+        auto capture = std::make_shared<TriggerCapture>();
+        capture->bsrLength = engine->getBSRLength();
+        capture->stride = stride;
+        capture->sampleCount = count;
+        capture->triggerIndex = 0;
+        ring.resize(count * stride);
+        timestamps.resize(count);
+        capture->images = std::move(ring);
+        capture->timestampsNs = std::move(timestamps);
+        ring.clear();
+        timestamps.clear();
+
+        std::cout << "[BurstSampler] " << count << " samples (" << total << " scans, "
+                  << stats.batches << " batches) in " << stats.seconds << " s = "
+                  << static_cast<uint64_t>(stats.samplesPerSecond) << " samples/s\n";
+        return capture;
+    }
+
+} // namespace JTAG
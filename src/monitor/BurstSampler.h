@@ -0,0 +1,65 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "../core/BoundaryScanEngine.h"
+#include "TriggerEngine.h"   // TriggerCapture: misma ventana de muestras crudas + timestamps
+
+namespace JTAG {
+
+    struct BurstSpec {
+        size_t samples = 10000;                  // Capacidad del anillo
+        std::chrono::milliseconds duration{ 0 }; // 0 = parar al llenar el anillo; >0 = conservar las últimas 'samples'
+        size_t batchSize = 256;                  // Scans por transacción del adaptador
+    };
+
+    struct BurstStats {
+        size_t samples = 0;          // Muestras entregadas
+        uint64_t scans = 0;          // Scans realizados (> samples si el anillo dio la vuelta)
+        uint64_t batches = 0;
+        double seconds = 0.0;
+        double samplesPerSecond = 0.0;
+    };
+
+    /**
+     * @brief Ráfaga de scans SAMPLE consecutivos a la máxima velocidad del adaptador
+     *
+     * prepare() reserva el anillo (samples × stride) y los timestamps; run() no
+     * asigna memoria: cada lote de batchSize scans se captura directamente en su
+     * hueco del anillo con BoundaryScanEngine::sampleBatch(). El timestamp de
+     * cada muestra se interpola dentro de su lote. Al terminar, el anillo se
+     * ordena en su sitio y se entrega sin copiar como TriggerCapture
+     * (triggerIndex = 0).
+     *
+     * La instrucción SAMPLE debe estar cargada; run() se ejecuta en el hilo que
+     * posee el engine.
+     */
+    class BurstSampler {
+    public:
+        explicit BurstSampler(BoundaryScanEngine* engine) : engine(engine) {}
+
+        bool prepare(const BurstSpec& spec);
+        std::shared_ptr<TriggerCapture> run(const std::atomic<bool>& abort);
+
+        const BurstStats& getStats() const { return stats; }
+        const std::string& getLastError() const { return lastError; }
+
+    private:
+        bool fail(const std::string& msg);
+
+        BoundaryScanEngine* engine;
+        BurstSpec spec;
+        BurstStats stats;
+        std::string lastError;
+
+        size_t stride = 0;
+        std::vector<uint8_t> ring;
+        std::vector<uint64_t> timestamps;
+    };
+
+} // namespace JTAG
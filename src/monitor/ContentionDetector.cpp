@@ -0,0 +1,174 @@
+#include "ContentionDetector.h"
+#include "../core/BitUtils.h"
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+
+namespace JTAG {
+
+    ContentionDetector::ContentionDetector(const DeviceModel& model)
+        : model(model)
+        , bsrLength(model.getBSRLength())
+        , words((model.getBSRLength() + 63) / 64)
+    {
+        controlInvert.assign(words, 0);
+        alwaysEnabled.assign(words, 0);
+        inputCellToPin.assign(bsrLength, -1);
+
+        const PinRange pins = model.getAllPins();
+        for (size_t i = 0; i < pins.size(); ++i) {
+            const PinView pin = pins[i];
+            if (pin.outputCell < 0 || pin.inputCell < 0 || pin.outputCell == pin.inputCell) continue;
+            if (static_cast<size_t>(pin.inputCell) >= bsrLength || static_cast<size_t>(pin.outputCell) >= bsrLength) continue;
+            if (inputCellToPin[pin.inputCell] >= 0) continue;
+
+            inputCellToPin[pin.inputCell] = static_cast<int32_t>(i);
+            addToGroup(outputGroups, pin.inputCell - pin.outputCell, pin.outputCell);
+
+            if (pin.controlCell >= 0 && static_cast<size_t>(pin.controlCell) < bsrLength) {
+                addToGroup(controlGroups, pin.inputCell - pin.controlCell, pin.controlCell);
+                if (pin.disableValue == 1) controlInvert[pin.controlCell / 64] |= 1ull << (pin.controlCell % 64);
+            } else {
+                alwaysEnabled[pin.inputCell / 64] |= 1ull << (pin.inputCell % 64);
+            }
+            monitoredPins++;
+        }
+
+        previousApplied.assign(words, 0);
+        captureWords.assign(words, 0);
+        expected.assign(words, 0);
+        enabled.assign(words, 0);
+        controlState.assign(words, 0);
+        scratch.assign(words, 0);
+        faultWords.assign(words, 0);
+        pinActive.assign(pins.size(), 0);
+
+        std::cout << "[ContentionDetector] Monitoring " << monitoredPins << " pins with "
+                  << getShiftGroupCount() << " shift groups\n";
+    }
+
+    void ContentionDetector::addToGroup(std::vector<ShiftGroup>& groups, int shift, int sourceBit) {
+        auto it = std::find_if(groups.begin(), groups.end(), [shift](const ShiftGroup& g) { return g.shift == shift; });
+        if (it == groups.end()) {
+            groups.push_back({ shift, std::vector<uint64_t>(words, 0) });
+            it = groups.end() - 1;
+        }
+        it->mask[sourceBit / 64] |= 1ull << (sourceBit % 64);
+    }
+
+    void ContentionDetector::reset() {
+        havePrevious = false;
+        for (size_t pin : activePins) pinActive[pin] = 0;
+        activePins.clear();
+    }
+
+    // ============================================================================
+    // OPERACIONES DE PALABRA
+    // ============================================================================
+
+    void ContentionDetector::loadWords(const std::vector<uint8_t>& bytes, std::vector<uint64_t>& out) const {
+        // Layout LSB-first: en un host little-endian el bit i del buffer de bytes es
+        // el bit (i % 64) de la palabra i / 64
+        std::fill(out.begin(), out.end(), 0);
+        std::memcpy(out.data(), bytes.data(), std::min(bytes.size(), words * sizeof(uint64_t)));
+        size_t tailBits = bsrLength % 64;
+        if (tailBits && words) out[words - 1] &= (1ull << tailBits) - 1;
+    }
+
+    void ContentionDetector::shiftOr(std::vector<uint64_t>& dst, const std::vector<uint64_t>& src,
+                                     const ShiftGroup& group, std::vector<uint64_t>& tmp) const {
+        for (size_t i = 0; i < words; ++i) tmp[i] = src[i] & group.mask[i];
+
+        const size_t distance = static_cast<size_t>(group.shift < 0 ? -group.shift : group.shift);
+        const size_t wordShift = distance / 64;
+        const unsigned bitShift = distance % 64;
+        if (wordShift >= words) return;
+
+        if (group.shift >= 0) {
+            // Hacia índices de celda mayores
+            for (size_t i = words; i-- > wordShift;) {
+                uint64_t v = tmp[i - wordShift] << bitShift;
+                if (bitShift && i > wordShift) v |= tmp[i - wordShift - 1] >> (64 - bitShift);
+                dst[i] |= v;
+            }
+        } else {
+            for (size_t i = 0; i + wordShift < words; ++i) {
+                uint64_t v = tmp[i + wordShift] >> bitShift;
+                if (bitShift && i + wordShift + 1 < words) v |= tmp[i + wordShift + 1] << (64 - bitShift);
+                dst[i] |= v;
+            }
+        }
+    }
+
+    // ============================================================================
+    // COMPROBACIÓN POR SCAN
+    // ============================================================================
+
+    size_t ContentionDetector::check(const std::vector<uint8_t>& capture, const std::vector<uint8_t>& appliedNow) {
+        scans++;
+
+        if (havePrevious && monitoredPins > 0) {
+            loadWords(capture, captureWords);
+
+            // esperado: salidas llevadas a la posición de su entrada
+            std::fill(expected.begin(), expected.end(), 0);
+            for (const auto& group : outputGroups) shiftOr(expected, previousApplied, group, scratch);
+
+            // habilitado: control != disableValue, llevado a la posición de la entrada
+            std::copy(alwaysEnabled.begin(), alwaysEnabled.end(), enabled.begin());
+            for (size_t i = 0; i < words; ++i) controlState[i] = previousApplied[i] ^ controlInvert[i];
+            for (const auto& group : controlGroups) shiftOr(enabled, controlState, group, scratch);
+
+            bool anyFault = false;
+            for (size_t i = 0; i < words; ++i) {
+                faultWords[i] = (captureWords[i] ^ expected[i]) & enabled[i];
+                anyFault |= (faultWords[i] != 0);
+            }
+
+            if (anyFault || !activePins.empty()) {
+                // Camino lento (solo con fallos): traducir bits a pines
+                std::vector<size_t> nowActive;
+                for (size_t w = 0; w < words; ++w) {
+                    uint64_t bits = faultWords[w];
+                    while (bits) {
+                        unsigned b = 0;
+                        while (!((bits >> b) & 1)) b++;
+                        bits &= bits - 1;
+
+                        size_t cell = w * 64 + b;
+                        int32_t pin = inputCellToPin[cell];
+                        if (pin < 0) continue;
+                        nowActive.push_back(static_cast<size_t>(pin));
+
+                        if (!pinActive[pin] && onFault) {
+                            const PinView info = model.getPin(static_cast<size_t>(pin));
+                            PinFaultEvent event{ static_cast<size_t>(pin), std::string(info.name),
+                                                 ((expected[w] >> b) & 1) != 0, scans };
+                            onFault(event);
+                        }
+                    }
+                }
+
+                for (size_t pin : activePins) pinActive[pin] = 0;
+                for (size_t pin : nowActive) pinActive[pin] = 1;
+                activePins.swap(nowActive);
+            }
+        }
+
+        loadWords(appliedNow, previousApplied);
+        havePrevious = true;
+        return activePins.size();
+    }
+
+    std::vector<uint8_t> ContentionDetector::makeSafeImage(const std::vector<uint8_t>& image) const {
+        std::vector<uint8_t> safe = image;
+        safe.resize(bytesForBits(bsrLength), 0);
+
+        for (const PinView pin : model.getAllPins()) {
+            if (pin.controlCell < 0 || static_cast<size_t>(pin.controlCell) >= bsrLength) continue;
+            setBit(safe.data(), pin.controlCell, pin.disableValue == 1);
+        }
+        return safe;
+    }
+
+} // namespace JTAG
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+#include "../bsdl/DeviceModel.h"
+
+namespace JTAG {
+
+    struct PinFaultEvent {
+        size_t pinIndex;           // Índice en DeviceModel::getAllPins()
+        std::string pinName;
+        bool drivenHigh;           // Valor que conducía la celda de salida
+        uint64_t scan;             // Número de scan en que se detectó
+    };
+
+    /**
+     * @brief Detector de contención / pin bloqueado en EXTEST a ritmo de scan
+     *
+     * Compara cada captura (TDO) con lo que se estaba conduciendo: para cada
+     * pin con celdas de salida y entrada,
+     *
+     *     esperado  = valor de la celda de salida, llevado a la posición de la entrada
+     *     habilitado = celda de control != disableValue (o siempre, sin control)
+     *     fallo     = (captura ^ esperado) & habilitado
+     *
+     * Las celdas de un pin suelen estar a distancia fija (p. ej. entrada = salida - 1),
+     * así que los pines se agrupan por desplazamiento y "llevar a la posición de
+     * la entrada" es un AND + desplazamiento de toda la imagen por grupo: solo
+     * operaciones de palabra de 64 bits, sin recorrer pines salvo cuando hay fallo.
+     *
+     * La captura de un scan refleja la imagen aplicada en el scan ANTERIOR;
+     * check() guarda la imagen actual para compararla con la siguiente captura.
+     */
+    class ContentionDetector {
+    public:
+        using FaultCallback = std::function<void(const PinFaultEvent&)>;
+
+        explicit ContentionDetector(const DeviceModel& model);
+
+        // Reinicia el seguimiento (nueva instrucción, imagen desconocida)
+        void reset();
+
+        // appliedNow: imagen TDI enviada en el mismo scan que produjo 'capture'.
+        // Devuelve el número de pines en fallo (nuevos o persistentes).
+        size_t check(const std::vector<uint8_t>& capture, const std::vector<uint8_t>& appliedNow);
+
+        void setFaultCallback(FaultCallback callback) { onFault = std::move(callback); }
+
+        // Imagen segura: todas las celdas de control en su valor de alta impedancia
+        std::vector<uint8_t> makeSafeImage(const std::vector<uint8_t>& image) const;
+
+        const std::vector<size_t>& getActiveFaults() const { return activePins; }
+        size_t getMonitoredPinCount() const { return monitoredPins; }
+        size_t getShiftGroupCount() const { return outputGroups.size() + controlGroups.size(); }
+        uint64_t getScanCount() const { return scans; }
+
+    private:
+        // Bits de origen 'mask' desplazados 'shift' posiciones hasta la celda de entrada
+        struct ShiftGroup {
+            int shift;
+            std::vector<uint64_t> mask;
+        };
+
+        void addToGroup(std::vector<ShiftGroup>& groups, int shift, int sourceBit);
+        void loadWords(const std::vector<uint8_t>& bytes, std::vector<uint64_t>& words) const;
+        // dst |= (src & mask) desplazado 'shift' bits (positivo = hacia índices mayores)
+        void shiftOr(std::vector<uint64_t>& dst, const std::vector<uint64_t>& src,
+                     const ShiftGroup& group, std::vector<uint64_t>& scratch) const;
+
+        const DeviceModel& model;
+        size_t bsrLength;
+        size_t words;
+
+        std::vector<ShiftGroup> outputGroups;     // Celda de salida → celda de entrada
+        std::vector<ShiftGroup> controlGroups;    // Celda de control → celda de entrada
+        std::vector<uint64_t> controlInvert;      // 1 en controles cuyo disableValue es 1
+        std::vector<uint64_t> alwaysEnabled;      // Entradas de pines sin celda de control
+        std::vector<int32_t> inputCellToPin;      // Solo se consulta cuando hay fallo
+        size_t monitoredPins = 0;
+
+        // Estado por scan (buffers reutilizados: sin asignaciones en check())
+        std::vector<uint64_t> previousApplied, captureWords, expected, enabled, controlState, scratch, faultWords;
+        bool havePrevious = false;
+        uint64_t scans = 0;
+
+        std::vector<uint8_t> pinActive;           // 1 si el pin estaba en fallo en el scan anterior
+        std::vector<size_t> activePins;
+        FaultCallback onFault;
+    };
+
+} // namespace JTAG
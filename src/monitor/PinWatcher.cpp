@@ -0,0 +1,272 @@
+#include "PinWatcher.h"
+#include "../core/BitUtils.h"
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+
+namespace JTAG {
+
+    PinWatcher::~PinWatcher() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        if (dispatcher.joinable()) dispatcher.join();
+    }
+
+    void PinWatcher::setBSRLength(size_t length) {
+        std::lock_guard<std::mutex> lock(mutex);
+        bsrLength = length;
+        unionDirty = true;
+        haveBaseline = false;
+        freshCount = 0;
+        for (auto& sub : subscriptions) {
+            if (sub->removed) continue;
+            sub->hasBaseline = false;
+            freshCount++;
+        }
+    }
+
+    // ============================================================================
+    // SUSCRIPCIONES
+    // ============================================================================
+
+    uint64_t PinWatcher::subscribe(const WatchSpec& spec, WatchCallback callback, std::string* error) {
+        return addSubscription(spec, std::move(callback), nullptr, error);
+    }
+
+    std::future<WatchEvent> PinWatcher::watchOnce(WatchSpec spec, std::string* error) {
+        auto promise = std::make_shared<std::promise<WatchEvent>>();
+        auto future = promise->get_future();
+        spec.oneShot = true;
+        if (addSubscription(spec, nullptr, promise, error) == 0) return {};
+        return future;
+    }
+
+    uint64_t PinWatcher::addSubscription(const WatchSpec& spec, WatchCallback callback,
+                                         std::shared_ptr<std::promise<WatchEvent>> promise, std::string* error) {
+        auto fail = [&](const std::string& msg) -> uint64_t {
+            if (error) *error = msg;
+            std::cerr << "[PinWatcher] " << msg << "\n";
+            return 0;
+        };
+
+        if (spec.cells.empty() || spec.cells.size() > 64) return fail("Watch needs 1..64 cells");
+        if ((spec.condition == WatchCondition::RISING || spec.condition == WatchCondition::FALLING) && spec.cells.size() != 1)
+            return fail("Edge conditions apply to a single cell");
+
+        auto sub = std::make_unique<Subscription>();
+        sub->spec = spec;
+        sub->callback = std::move(callback);
+        sub->promise = std::move(promise);
+
+        for (size_t cell : spec.cells) {
+            uint32_t index = static_cast<uint32_t>(cell / 64);
+            uint64_t bit = 1ull << (cell % 64);
+            auto it = std::find_if(sub->words.begin(), sub->words.end(),
+                                   [index](const auto& w) { return w.first == index; });
+            if (it == sub->words.end()) sub->words.push_back({ index, bit });
+            else it->second |= bit;
+        }
+
+        uint64_t id;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t cell : spec.cells) {
+                if (bsrLength > 0 && cell >= bsrLength)
+                    return fail("Watch cell " + std::to_string(cell) + " out of range");
+            }
+            id = nextId++;
+            sub->id = id;
+            if (spec.timeout.count() > 0) sub->deadline = std::chrono::steady_clock::now() + spec.timeout;
+            subscriptions.push_back(std::move(sub));
+            activeCount++;
+            freshCount++;
+            unionDirty = true;
+            if (!dispatcher.joinable()) startDispatcher();
+        }
+        wake.notify_all();   // Puede haber un deadline más próximo
+        return id;
+    }
+
+    bool PinWatcher::unsubscribe(uint64_t id) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& sub : subscriptions) {
+            if (sub->id != id || sub->removed) continue;
+            if (!sub->hasBaseline) freshCount--;
+            sub->removed = true;
+            activeCount--;
+            unionDirty = true;
+            return true;
+        }
+        return false;
+    }
+
+    void PinWatcher::rebuildUnion() {
+        subscriptions.erase(std::remove_if(subscriptions.begin(), subscriptions.end(),
+                                           [](const auto& s) { return s->removed; }),
+                            subscriptions.end());
+
+        size_t words = (bsrLength + 63) / 64;
+        unionMask.assign(words, 0);
+        current.resize(words, 0);
+        previous.resize(words, 0);
+        unionWords.clear();
+        for (const auto& sub : subscriptions) {
+            for (const auto& [index, mask] : sub->words) {
+                if (index >= words) continue;
+                if (unionMask[index] == 0) unionWords.push_back(index);
+                unionMask[index] |= mask;
+            }
+        }
+        unionDirty = false;
+    }
+
+    void PinWatcher::resetBaseline() {
+        std::lock_guard<std::mutex> lock(mutex);
+        haveBaseline = false;
+        freshCount = 0;
+        for (auto& sub : subscriptions) {
+            if (sub->removed) continue;
+            sub->hasBaseline = false;
+            freshCount++;
+        }
+    }
+
+    // ============================================================================
+    // EVALUACIÓN POR CAPTURA (hilo del worker)
+    // ============================================================================
+
+    void PinWatcher::evaluate(const uint8_t* capture, uint64_t timestampNs) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (bsrLength == 0) return;
+        if (unionDirty) rebuildUnion();
+        scans++;
+
+        // Camino rápido: cargar solo las palabras vigiladas y ver si alguna cambió
+        const size_t stride = bytesForBits(bsrLength);
+        bool anyChange = !haveBaseline;
+        for (uint32_t w : unionWords) {
+            previous[w] = current[w];
+            uint64_t value = 0;
+            size_t offset = static_cast<size_t>(w) * 8;
+            std::memcpy(&value, capture + offset, std::min<size_t>(8, stride - offset));
+            current[w] = value & unionMask[w];
+            anyChange |= (current[w] != previous[w]);
+        }
+        const bool baselineValid = haveBaseline;
+        haveBaseline = true;
+        if (!anyChange && freshCount == 0) return;
+
+        bool removedAny = false;
+        for (auto& subPtr : subscriptions) {
+            Subscription& sub = *subPtr;
+            if (sub.removed) continue;
+
+            if (sub.hasBaseline && baselineValid) {
+                bool changed = false;
+                for (const auto& [index, mask] : sub.words) {
+                    if (index < current.size() && ((current[index] ^ previous[index]) & mask)) { changed = true; break; }
+                }
+                if (!changed) continue;
+            }
+
+            uint64_t value = 0;
+            for (size_t i = 0; i < sub.spec.cells.size(); ++i) {
+                size_t cell = sub.spec.cells[i];
+                if (cell < bsrLength && getBit(capture, cell)) value |= 1ull << i;
+            }
+
+            bool fire = false;
+            if (!sub.hasBaseline) {
+                fire = (sub.spec.condition == WatchCondition::EQUALS && value == sub.spec.value);
+                sub.hasBaseline = true;
+                freshCount--;
+            } else {
+                switch (sub.spec.condition) {
+                    case WatchCondition::RISING:     fire = (sub.last == 0 && value == 1); break;
+                    case WatchCondition::FALLING:    fire = (sub.last == 1 && value == 0); break;
+                    case WatchCondition::ANY_CHANGE: fire = (value != sub.last); break;
+                    case WatchCondition::EQUALS:     fire = (value == sub.spec.value && sub.last != sub.spec.value); break;
+                }
+            }
+
+            if (fire) {
+                WatchEvent event;
+                event.id = sub.id;
+                event.value = value;
+                event.previousValue = sub.last;
+                event.scan = scans;
+                event.timestampNs = timestampNs;
+                queueEvent(sub, event);
+                removedAny |= sub.removed;
+            }
+            sub.last = value;
+        }
+
+        if (removedAny) unionDirty = true;
+        if (!queue.empty()) wake.notify_one();
+    }
+
+    void PinWatcher::queueEvent(Subscription& sub, const WatchEvent& event) {
+        queue.push_back({ event, sub.callback, sub.promise });
+        if (sub.spec.oneShot || event.timedOut) {
+            sub.removed = true;
+            activeCount--;
+        } else if (sub.spec.timeout.count() > 0) {
+            sub.deadline = std::chrono::steady_clock::now() + sub.spec.timeout;
+        }
+    }
+
+    // ============================================================================
+    // DESPACHADOR (callbacks, promesas y timeouts)
+    // ============================================================================
+
+    void PinWatcher::startDispatcher() {
+        dispatcher = std::thread([this]() { dispatchLoop(); });
+    }
+
+    void PinWatcher::dispatchLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopping) {
+            if (!queue.empty()) {
+                Delivery delivery = std::move(queue.front());
+                queue.pop_front();
+                lock.unlock();
+                if (delivery.callback) delivery.callback(delivery.event);
+                if (delivery.promise) delivery.promise->set_value(delivery.event);
+                lock.lock();
+                continue;
+            }
+
+            // Timeouts: suscripciones sin evento antes de su deadline
+            auto now = std::chrono::steady_clock::now();
+            auto next = std::chrono::steady_clock::time_point::max();
+            bool expired = false;
+            for (auto& sub : subscriptions) {
+                if (sub->removed || sub->spec.timeout.count() == 0) continue;
+                if (sub->deadline <= now) {
+                    WatchEvent event;
+                    event.id = sub->id;
+                    event.value = event.previousValue = sub->last;
+                    event.timedOut = true;
+                    event.scan = scans;
+                    if (!sub->hasBaseline) freshCount--;
+                    queueEvent(*sub, event);
+                    expired = true;
+                } else {
+                    next = std::min(next, sub->deadline);
+                }
+            }
+            if (expired) {
+                unionDirty = true;
+                continue;
+            }
+
+            if (next == std::chrono::steady_clock::time_point::max()) wake.wait(lock);
+            else wake.wait_until(lock, next);
+        }
+    }
+
+} // namespace JTAG
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <future>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <cstdint>
+
+namespace JTAG {
+
+    enum class WatchCondition {
+        RISING,       // Solo 1 celda: 0 → 1
+        FALLING,      // Solo 1 celda: 1 → 0
+        ANY_CHANGE,   // Cualquier cambio del valor del grupo
+        EQUALS        // El grupo pasa a valer 'value' (o ya lo vale al suscribirse)
+    };
+
+    struct WatchSpec {
+        std::vector<size_t> cells;               // Celdas BSR; cells[0] = bit 0 del valor (máx. 64)
+        WatchCondition condition = WatchCondition::ANY_CHANGE;
+        uint64_t value = 0;                      // Para EQUALS
+        std::chrono::milliseconds timeout{ 0 };  // 0 = sin timeout; se reinicia tras cada evento
+        bool oneShot = false;
+    };
+
+    struct WatchEvent {
+        uint64_t id = 0;
+        uint64_t value = 0;
+        uint64_t previousValue = 0;
+        bool timedOut = false;      // La suscripción expiró sin cumplirse (y se elimina)
+        uint64_t scan = 0;          // Número de captura evaluada
+        uint64_t timestampNs = 0;   // steady_clock de la captura
+    };
+
+    using WatchCallback = std::function<void(const WatchEvent&)>;
+
+    /**
+     * @brief Suscripciones a cambios de celdas/buses evaluadas a ritmo de scan
+     *
+     * evaluate() se llama desde el hilo del worker con cada captura. La unión de
+     * las celdas vigiladas se guarda como máscara de palabras de 64 bits: si
+     * ninguna cambió desde la captura anterior, la evaluación termina tras unos
+     * XOR/AND. Solo las suscripciones cuyas palabras cambiaron se recorren.
+     *
+     * Los eventos se entregan en un hilo despachador propio (los callbacks
+     * nunca se ejecutan en el hilo de scan ni con el lock tomado), que además
+     * genera los eventos de timeout aunque no lleguen capturas.
+     */
+    class PinWatcher {
+    public:
+        PinWatcher() = default;
+        ~PinWatcher();
+
+        void setBSRLength(size_t length);
+
+        // Devuelve el id de la suscripción (0 = error)
+        uint64_t subscribe(const WatchSpec& spec, WatchCallback callback, std::string* error = nullptr);
+        bool unsubscribe(uint64_t id);
+
+        // Suscripción de un solo disparo; el future se resuelve con el evento (o el timeout)
+        std::future<WatchEvent> watchOnce(WatchSpec spec, std::string* error = nullptr);
+
+        bool hasSubscriptions() const { return activeCount.load() > 0; }
+
+        // Hilo del worker
+        void resetBaseline();   // La siguiente captura no se compara con la anterior
+        void evaluate(const uint8_t* capture, uint64_t timestampNs);
+
+    private:
+        struct Subscription {
+            uint64_t id;
+            WatchSpec spec;
+            std::vector<std::pair<uint32_t, uint64_t>> words;   // {palabra, máscara}
+            WatchCallback callback;
+            std::shared_ptr<std::promise<WatchEvent>> promise;
+            std::chrono::steady_clock::time_point deadline;
+            bool hasBaseline = false;
+            uint64_t last = 0;
+            bool removed = false;
+        };
+        struct Delivery {
+            WatchEvent event;
+            WatchCallback callback;
+            std::shared_ptr<std::promise<WatchEvent>> promise;
+        };
+
+        uint64_t addSubscription(const WatchSpec& spec, WatchCallback callback,
+                                 std::shared_ptr<std::promise<WatchEvent>> promise, std::string* error);
+        void rebuildUnion();
+        void queueEvent(Subscription& sub, const WatchEvent& event);
+        void startDispatcher();
+        void dispatchLoop();
+
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::vector<std::unique_ptr<Subscription>> subscriptions;
+        std::deque<Delivery> queue;
+        std::atomic<size_t> activeCount{ 0 };
+        uint64_t nextId = 1;
+        size_t bsrLength = 0;
+
+        // Máscara unión (solo palabras usadas) y última captura de esas palabras
+        bool unionDirty = true;
+        std::vector<uint32_t> unionWords;
+        std::vector<uint64_t> unionMask, current, previous;
+        bool haveBaseline = false;
+        size_t freshCount = 0;      // Suscripciones aún sin valor de referencia
+        uint64_t scans = 0;
+
+        std::thread dispatcher;
+        bool stopping = false;
+    };
+
+} // namespace JTAG
@@ -0,0 +1,190 @@
+#include "TriggerEngine.h"
+#include "../core/BitUtils.h"
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+
+namespace JTAG {
+
+    // ============================================================================
+    // CONFIGURACIÓN
+    // ============================================================================
+
+    bool TriggerEngine::configure(const TriggerSpec& newSpec, size_t newBsrLength, std::string* error) {
+        auto fail = [&](const std::string& msg) {
+            if (error) *error = msg;
+            std::cerr << "[TriggerEngine] " << msg << "\n";
+            state = State::IDLE;
+            return false;
+        };
+
+        if (newBsrLength == 0) return fail("BSR length is zero");
+        if (newSpec.stages.empty()) return fail("Trigger has no stages");
+
+        bsrLength = newBsrLength;
+        stride = bytesForBits(bsrLength);
+        words = (bsrLength + 63) / 64;
+
+        stages.clear();
+        touchedWords.clear();
+        for (size_t s = 0; s < newSpec.stages.size(); ++s) {
+            const auto& stageSpec = newSpec.stages[s];
+            if (stageSpec.terms.empty()) return fail("Trigger stage " + std::to_string(s + 1) + " has no terms");
+
+            CompiledStage compiled;
+            for (const auto& term : stageSpec.terms) {
+                if (term.cell >= bsrLength)
+                    return fail("Trigger cell " + std::to_string(term.cell) + " out of range");
+
+                uint32_t index = static_cast<uint32_t>(term.cell / 64);
+                uint64_t bit = 1ull << (term.cell % 64);
+
+                auto it = std::find_if(compiled.words.begin(), compiled.words.end(),
+                                       [index](const StageWord& w) { return w.index == index; });
+                if (it == compiled.words.end()) {
+                    compiled.words.push_back({ index, 0, 0, 0, 0, 0 });
+                    it = compiled.words.end() - 1;
+                }
+
+                switch (term.kind) {
+                    case TriggerTerm::Kind::LOW:         it->mask |= bit; it->value &= ~bit; break;
+                    case TriggerTerm::Kind::HIGH:        it->mask |= bit; it->value |= bit; break;
+                    case TriggerTerm::Kind::RISING:      it->rise |= bit; break;
+                    case TriggerTerm::Kind::FALLING:     it->fall |= bit; break;
+                    case TriggerTerm::Kind::EITHER_EDGE: it->anyEdge |= bit; compiled.needsAnyEdge = true; break;
+                }
+            }
+
+            for (const auto& w : compiled.words) {
+                if ((w.rise & w.fall) != 0)
+                    return fail("Trigger stage " + std::to_string(s + 1) + " requires rising and falling edge on the same cell");
+                if (std::find(touchedWords.begin(), touchedWords.end(), w.index) == touchedWords.end())
+                    touchedWords.push_back(w.index);
+            }
+            stages.push_back(std::move(compiled));
+        }
+
+        spec = newSpec;
+        current.assign(words, 0);
+        previous.assign(words, 0);
+
+        // Toda la memoria del anillo se reserva aquí, nunca en feed()
+        capacity = spec.preTriggerSamples + 1 + spec.postTriggerSamples;
+        ring.assign(capacity * stride, 0);
+        ringTimestamps.assign(capacity, 0);
+
+        std::cout << "[TriggerEngine] Configured " << stages.size() << " stage(s), "
+                  << touchedWords.size() << " word(s) evaluated, window "
+                  << spec.preTriggerSamples << "+1+" << spec.postTriggerSamples << " samples\n";
+        state = State::IDLE;
+        return true;
+    }
+
+    void TriggerEngine::arm() {
+        if (stages.empty()) return;
+        head = 0;
+        stored = 0;
+        postRemaining = 0;
+        triggerPosition = 0;
+        stage = 0;
+        havePrevious = false;
+        state = State::ARMED;
+    }
+
+    void TriggerEngine::disarm() {
+        state = State::IDLE;
+    }
+
+    // ============================================================================
+    // EVALUACIÓN POR MUESTRA
+    // ============================================================================
+
+    bool TriggerEngine::matches(const CompiledStage& compiled) const {
+        bool anyEdgeSeen = !compiled.needsAnyEdge;
+        for (const auto& w : compiled.words) {
+            const uint64_t c = current[w.index];
+            const uint64_t p = previous[w.index];
+
+            if (((c ^ w.value) & w.mask) != 0) return false;
+            if ((w.rise | w.fall | w.anyEdge) == 0) continue;
+            if (!havePrevious) return false;   // Sin muestra previa no hay flancos
+
+            if ((~p & c & w.rise) != w.rise) return false;
+            if ((p & ~c & w.fall) != w.fall) return false;
+            if ((p ^ c) & w.anyEdge) anyEdgeSeen = true;
+        }
+        return anyEdgeSeen;
+    }
+
+    void TriggerEngine::store(const uint8_t* capture, uint64_t timestampNs) {
+        std::memcpy(ring.data() + head * stride, capture, stride);
+        ringTimestamps[head] = timestampNs;
+        head = (head + 1) % capacity;
+        if (stored < capacity) stored++;
+    }
+
+    bool TriggerEngine::feed(const uint8_t* capture, uint64_t timestampNs) {
+        if (state != State::ARMED && state != State::TRIGGERED) return state == State::COMPLETE;
+
+        store(capture, timestampNs);
+
+        if (state == State::TRIGGERED) {
+            if (postRemaining > 0) postRemaining--;
+            if (postRemaining == 0) state = State::COMPLETE;
+            return state == State::COMPLETE;
+        }
+
+        // Solo se cargan las palabras que usa alguna etapa (layout LSB-first:
+        // en little-endian el bit i es el bit i % 64 de la palabra i / 64)
+        for (uint32_t w : touchedWords) {
+            previous[w] = current[w];
+            uint64_t value = 0;
+            size_t offset = static_cast<size_t>(w) * 8;
+            std::memcpy(&value, capture + offset, std::min<size_t>(8, stride - offset));
+            if (w == words - 1 && (bsrLength % 64) != 0) value &= (1ull << (bsrLength % 64)) - 1;
+            current[w] = value;
+        }
+
+        bool matched = matches(stages[stage]);
+        havePrevious = true;
+        if (!matched) return false;
+
+        if (++stage < stages.size()) return false;
+
+        // Disparo: la muestra actual es la de disparo
+        triggerCount++;
+        triggerPosition = stored - 1;   // Índice (desde la más antigua) dentro del anillo
+        postRemaining = spec.postTriggerSamples;
+        state = (postRemaining == 0) ? State::COMPLETE : State::TRIGGERED;
+        return state == State::COMPLETE;
+    }
+
+    std::shared_ptr<TriggerCapture> TriggerEngine::takeCapture() {
+        if (state != State::COMPLETE) return nullptr;
+
+        // Ventana = min(pre, disponibles) + disparo + post; siempre cabe en el anillo
+        size_t preCount = std::min(spec.preTriggerSamples, triggerPosition);
+        size_t count = preCount + 1 + spec.postTriggerSamples;
+        count = std::min(count, stored);
+        size_t oldest = (head + capacity - count) % capacity;
+
+        auto capture = std::make_shared<TriggerCapture>();
+        capture->bsrLength = bsrLength;
+        capture->stride = stride;
+        capture->sampleCount = count;
+        capture->triggerIndex = preCount;
+        capture->images.resize(count * stride);
+        capture->timestampsNs.resize(count);
+
+        for (size_t i = 0; i < count; ++i) {
+            size_t slot = (oldest + i) % capacity;
+            std::memcpy(capture->images.data() + i * stride, ring.data() + slot * stride, stride);
+            capture->timestampsNs[i] = ringTimestamps[slot];
+        }
+
+        if (spec.rearm) arm();
+        else state = State::IDLE;
+        return capture;
+    }
+
+} // namespace JTAG
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+namespace JTAG {
+
+    // ============================================================================
+    // ESPECIFICACIÓN (lo que configura el usuario)
+    // ============================================================================
+
+    struct TriggerTerm {
+        enum class Kind { LOW, HIGH, RISING, FALLING, EITHER_EDGE };
+        size_t cell;     // Índice de celda BSR (posición en la captura)
+        Kind kind;
+    };
+
+    // Todas las condiciones de nivel/flanco deben cumplirse en la misma muestra;
+    // los términos EITHER_EDGE se combinan en OR (cualquier cambio en esas celdas)
+    struct TriggerStage {
+        std::vector<TriggerTerm> terms;
+    };
+
+    struct TriggerSpec {
+        std::vector<TriggerStage> stages;     // Secuencia: etapa 1 → etapa 2 → ... → disparo
+        size_t preTriggerSamples = 64;
+        size_t postTriggerSamples = 256;
+        bool rearm = false;                   // false = single, true = normal (re-arma tras cada ventana)
+    };
+
+    // Ventana capturada: muestras consecutivas, triggerIndex = muestra de disparo
+    struct TriggerCapture {
+        size_t bsrLength = 0;
+        size_t stride = 0;
+        size_t sampleCount = 0;
+        size_t triggerIndex = 0;
+        std::vector<uint8_t> images;          // sampleCount × stride (layout LSB-first)
+        std::vector<uint64_t> timestampsNs;   // steady_clock por muestra
+
+        const uint8_t* sample(size_t i) const { return images.data() + i * stride; }
+    };
+
+    /**
+     * @brief Disparo tipo analizador lógico evaluado sobre cada captura
+     *
+     * Cada etapa se compila a palabras de 64 bits {valor, máscara, subida,
+     * bajada, cualquier flanco} solo para las palabras del BSR que tocan sus
+     * términos; evaluar una muestra cuesta unas pocas operaciones por palabra
+     * afectada. Las muestras previas se guardan en un anillo preasignado de
+     * preTriggerSamples; tras el disparo se recogen postTriggerSamples más y la
+     * ventana completa se entrega con takeCapture().
+     */
+    class TriggerEngine {
+    public:
+        enum class State { IDLE, ARMED, TRIGGERED, COMPLETE };
+
+        bool configure(const TriggerSpec& spec, size_t bsrLength, std::string* error = nullptr);
+        void arm();          // Vacía el anillo y vuelve a la etapa 0
+        void disarm();
+
+        // Devuelve true cuando la ventana está completa (State::COMPLETE)
+        bool feed(const uint8_t* capture, uint64_t timestampNs);
+
+        // Extrae la ventana (ordenada) y re-arma si spec.rearm
+        std::shared_ptr<TriggerCapture> takeCapture();
+
+        State getState() const { return state; }
+        bool isActive() const { return state == State::ARMED || state == State::TRIGGERED; }
+        size_t getCurrentStage() const { return stage; }
+        uint64_t getTriggerCount() const { return triggerCount; }
+
+    private:
+        struct StageWord {
+            uint32_t index;
+            uint64_t value, mask;       // Nivel: ((c ^ value) & mask) == 0
+            uint64_t rise, fall;        // Flancos obligatorios
+            uint64_t anyEdge;           // Al menos un cambio (OR sobre la etapa)
+        };
+        struct CompiledStage {
+            std::vector<StageWord> words;
+            bool needsAnyEdge = false;
+        };
+
+        bool matches(const CompiledStage& compiled) const;
+        void store(const uint8_t* capture, uint64_t timestampNs);
+
+        TriggerSpec spec;
+        std::vector<CompiledStage> stages;
+        std::vector<uint32_t> touchedWords;   // Palabras usadas por alguna etapa
+
+        size_t bsrLength = 0;
+        size_t stride = 0;
+        size_t words = 0;
+        std::vector<uint64_t> current, previous;
+        bool havePrevious = false;
+
+        // Anillo preasignado: pre + 1 + post muestras
+        std::vector<uint8_t> ring;
+        std::vector<uint64_t> ringTimestamps;
+        size_t capacity = 0;
+        size_t head = 0;           // Siguiente posición de escritura
+        size_t stored = 0;         // Muestras válidas en el anillo
+        size_t postRemaining = 0;
+        size_t triggerPosition = 0;
+
+        State state = State::IDLE;
+        size_t stage = 0;
+        uint64_t triggerCount = 0;
+    };
+
+} // namespace JTAG
@@ -1,61 +1,54 @@
 #include "BSDLParser.h"
-#include <iostream>
-#include <fstream>
+#include "../core/MappedFile.h"
 #include <algorithm>
-#include <cctype>
 #include <charconv>
+#include <cstdlib>
 #include <vector>
 
 // --- HELPERS ESTÁTICOS ---
 
+// Clasificación ASCII en línea: BSDL es ASCII y <cctype> consulta la tabla de locale por carácter
+static inline bool isSpace(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+static inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+static inline bool isAlpha(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+static inline bool isIdentChar(char c) { return isAlpha(c) || isDigit(c) || c == '_'; }
+static inline char toUpper(char c) { return (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c; }
+
 static std::string_view trim(std::string_view sv) {
-    while (!sv.empty() && std::isspace(static_cast<unsigned char>(sv.front()))) sv.remove_prefix(1);
-    while (!sv.empty() && std::isspace(static_cast<unsigned char>(sv.back()))) sv.remove_suffix(1);
+    while (!sv.empty() && isSpace(sv.front())) sv.remove_prefix(1);
+    while (!sv.empty() && isSpace(sv.back())) sv.remove_suffix(1);
     return sv;
 }
 
-static bool parseVhdlRange(std::string_view typeStr, int& start, int& end) {
-    auto openParen = typeStr.find('(');
-    auto closeParen = typeStr.find(')');
-    if (openParen == std::string_view::npos || closeParen == std::string_view::npos) return false;
-    auto rangeContent = trim(typeStr.substr(openParen + 1, closeParen - openParen - 1));
-    std::string s(rangeContent); // Copia necesaria para transformación
-    // En el parser parse() ya convertimos todo a mayúsculas, así que esto podría simplificarse,
-    // pero lo dejamos por seguridad.
-    size_t dirPos = s.find(" DOWNTO ");
-    bool isDownto = (dirPos != std::string::npos);
-    size_t splitPos = isDownto ? dirPos : s.find(" TO ");
-    if (splitPos == std::string::npos) return false;
-    try {
-        start = std::stoi(s.substr(0, splitPos));
-        end = std::stoi(s.substr(splitPos + (isDownto ? 8 : 4)));
-        return true;
+static bool iequals(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (toUpper(a[i]) != toUpper(b[i])) return false;
     }
-    catch (...) { return false; }
+    return true;
 }
 
-static std::vector<std::string_view> splitSv(std::string_view str, char delimiter) {
-    std::vector<std::string_view> tokens;
-    size_t start = 0;
-    size_t end = str.find(delimiter);
-    while (end != std::string_view::npos) {
-        tokens.push_back(str.substr(start, end - start));
-        start = end + 1;
-        end = str.find(delimiter, start);
-    }
-    tokens.push_back(str.substr(start));
-    return tokens;
+static bool icontains(std::string_view haystack, std::string_view needle) {
+    auto it = std::search(haystack.begin(), haystack.end(), needle.begin(), needle.end(),
+        [](char a, char b) { return toUpper(a) == toUpper(b); });
+    return it != haystack.end();
+}
+
+// Los identificadores de BSDL no distinguen mayúsculas: se guardan normalizados
+static std::string upper(std::string_view sv) {
+    std::string out(sv);
+    for (char& c : out) c = toUpper(c);
+    return out;
 }
 
-// --- NUEVOS HELPERS PARA ENUMS ---
 static CellFunction stringToFunction(std::string_view s) {
-    if (s == "INPUT") return CellFunction::INPUT;
-    if (s == "CLOCK") return CellFunction::CLOCK;
-    if (s == "OUTPUT2") return CellFunction::OUTPUT2;
-    if (s == "OUTPUT3") return CellFunction::OUTPUT3;
-    if (s == "BIDIR") return CellFunction::BIDIR;
-    if (s == "CONTROL") return CellFunction::CONTROL;
-    if (s == "INTERNAL") return CellFunction::INTERNAL;
+    if (iequals(s, "INPUT")) return CellFunction::INPUT;
+    if (iequals(s, "CLOCK")) return CellFunction::CLOCK;
+    if (iequals(s, "OUTPUT2")) return CellFunction::OUTPUT2;
+    if (iequals(s, "OUTPUT3")) return CellFunction::OUTPUT3;
+    if (iequals(s, "BIDIR")) return CellFunction::BIDIR;
+    if (iequals(s, "CONTROL")) return CellFunction::CONTROL;
+    if (iequals(s, "INTERNAL")) return CellFunction::INTERNAL;
     return CellFunction::UNKNOWN;
 }
 
@@ -65,304 +58,462 @@ static SafeBit stringToSafeBit(std::string_view s) {
     return SafeBit::DONT_CARE; // 'X' o cualquier otra cosa
 }
 
-// --- PARSER PRINCIPAL ---
+// ============================================================================
+// LEXER
+// ============================================================================
 
-bool BSDLParser::parse(const std::filesystem::path& filename) {
-    // std::ifstream en C++17 acepta std::filesystem::path directamente
-    // y maneja Unicode correctamente en todas las plataformas
-    std::ifstream in(filename, std::ios::in | std::ios::binary);
-    if (!in) return false;
-
-    in.seekg(0, std::ios::end);
-    std::string rawBuffer;
-    rawBuffer.resize(in.tellg());
-    in.seekg(0, std::ios::beg);
-    in.read(&rawBuffer[0], rawBuffer.size());
-    in.close();
-
-    std::string cleanBuffer;
-    cleanBuffer.reserve(rawBuffer.size());
-
-    bool inComment = false;
-    for (size_t i = 0; i < rawBuffer.size(); ++i) {
-        char c = rawBuffer[i];
-        if (!inComment && c == '-' && i + 1 < rawBuffer.size() && rawBuffer[i + 1] == '-') {
-            inComment = true; i++; continue;
-        }
-        if (c == '\n' || c == '\r') {
-            inComment = false; cleanBuffer += ' '; continue;
-        }
-        if (!inComment) {
-            if (c == '\t') cleanBuffer += ' ';
-            else cleanBuffer += std::toupper(static_cast<unsigned char>(c));
-        }
-    }
+/**
+ * Tokenizador de BSDL sobre un buffer que no se copia ni se modifica.
+ * Los comentarios "--" se descartan al avanzar; ":=" es un único símbolo.
+ */
+class BSDLLexer {
+public:
+    enum class Kind { END, IDENT, NUMBER, STRING, SYMBOL };
 
-    fileBuffer = std::move(cleanBuffer);
-    std::string_view content(fileBuffer);
+    struct Token {
+        Kind kind = Kind::END;
+        std::string_view text;   // STRING: contenido sin comillas
+    };
 
-    // 1. ENTITY
-    if (auto pos = content.find("ENTITY"); pos != std::string_view::npos) {
-        size_t nameStart = pos + 6;
-        while (nameStart < content.size() && std::isspace(content[nameStart])) nameStart++;
-        auto end = content.find(" IS", nameStart);
-        if (end != std::string_view::npos) {
-            data.entityName = std::string(trim(content.substr(nameStart, end - nameStart)));
-        }
+    explicit BSDLLexer(std::string_view source) : src(source) { current = lex(); }
+
+    const Token& peek() const { return current; }
+
+    Token next() {
+        Token token = current;
+        current = lex();
+        return token;
     }
 
-    // 2. GENERIC
-    if (auto pos = content.find("GENERIC"); pos != std::string_view::npos) {
-        auto assignPos = content.find(":=", pos);
-        if (assignPos != std::string_view::npos) {
-            auto startQuote = content.find('"', assignPos);
-            auto endSemi = content.find(";", assignPos);
-            if (startQuote != std::string_view::npos && endSemi != std::string_view::npos && startQuote < endSemi) {
-                auto endQuote = content.find('"', startQuote + 1);
-                if (endQuote != std::string_view::npos && endQuote < endSemi) {
-                    auto raw = content.substr(startQuote + 1, endQuote - startQuote - 1);
-                    data.physicalPinMap = std::string(trim(raw));
-                }
-            }
-        }
+    bool atSymbol(std::string_view symbol) const {
+        return current.kind == Kind::SYMBOL && current.text == symbol;
     }
 
-    // 3. PORT
-    if (auto pos = content.find("PORT"); pos != std::string_view::npos) {
-        auto startParen = content.find('(', pos);
-        if (startParen != std::string_view::npos) {
-            auto endParen = content.find(");", startParen);
-            if (endParen != std::string_view::npos) {
-                parsePortsRaw(content.substr(startParen + 1, endParen - startParen - 1));
-            }
-        }
+    bool accept(std::string_view symbol) {
+        if (!atSymbol(symbol)) return false;
+        current = lex();
+        return true;
     }
 
-    // 4. BOUNDARY LENGTH
-    if (auto pos = content.find("BOUNDARY_LENGTH"); pos != std::string_view::npos) {
-        auto start = content.find("IS", pos);
-        auto end = content.find(";", pos);
-        if (start != std::string_view::npos) {
-            auto numSv = trim(content.substr(start + 2, end - (start + 2)));
-            std::from_chars(numSv.data(), numSv.data() + numSv.size(), data.boundaryLength);
-        }
+    bool acceptWord(std::string_view word) {
+        if (current.kind != Kind::IDENT || !iequals(current.text, word)) return false;
+        current = lex();
+        return true;
     }
 
-    if (auto pos = content.find("INSTRUCTION_LENGTH"); pos != std::string_view::npos) {
-        auto start = content.find("IS", pos);
-        auto end = content.find(";", pos);
-        if (start != std::string_view::npos && end != std::string_view::npos) {
-            auto numSv = trim(content.substr(start + 2, end - (start + 2)));
-            // Convertir string a int
-            std::from_chars(numSv.data(), numSv.data() + numSv.size(), data.instructionLength);
+    // Descarta hasta el ';' que cierra la sentencia (incluido), respetando paréntesis
+    void skipStatement() {
+        int depth = 0;
+        while (current.kind != Kind::END) {
+            Token token = next();
+            if (token.kind != Kind::SYMBOL) continue;
+            if (token.text == "(") depth++;
+            else if (token.text == ")") depth = std::max(0, depth - 1);
+            else if (token.text == ";" && depth == 0) return;
         }
     }
 
-    // 5. INSTRUCTION OPCODE
-    if (auto pos = content.find("INSTRUCTION_OPCODE"); pos != std::string_view::npos) {
-        auto startQuote = content.find('"', pos);
-        auto endSemi = content.find(";", pos);
-        if (startQuote != std::string_view::npos && endSemi != std::string_view::npos) {
-            auto endQuote = content.rfind('"', endSemi);
-            if (endQuote > startQuote) {
-                parseInstructionOpcodeRaw(content.substr(startQuote + 1, endQuote - startQuote - 1));
+private:
+    Token lex() {
+        for (;;) {
+            while (pos < src.size() && isSpace(src[pos])) pos++;
+            if (pos + 1 < src.size() && src[pos] == '-' && src[pos + 1] == '-') {
+                pos = std::min(src.find('\n', pos), src.size());
+                continue;
             }
+            break;
         }
-    }
+        if (pos >= src.size()) return {};
 
-    // 6. PIN MAP STRING
-    if (auto pos = content.find("PIN_MAP_STRING"); pos != std::string_view::npos) {
-        auto startQuote = content.find(":=", pos);
-        auto endSemi = content.find(";", pos);
-        if (startQuote != std::string_view::npos && endSemi != std::string_view::npos) {
-            auto raw = trim(content.substr(startQuote + 2, endSemi - (startQuote + 2)));
-            parsePinMapRaw(raw);
-        }
-    }
+        const size_t start = pos;
+        const char c = src[pos];
 
-    // 7. BOUNDARY REGISTER (Aquí se usan los nuevos enums)
-    auto brPos = content.find("BOUNDARY_REGISTER");
-    if (brPos != std::string_view::npos) {
-        auto startQuote = content.find('"', brPos);
-        auto endQuote = content.rfind('"');
-        if (startQuote != std::string_view::npos && endQuote != std::string_view::npos && endQuote > startQuote) {
-            parseBoundaryRegisterRaw(content.substr(startQuote + 1, endQuote - startQuote - 1));
+        if (isAlpha(c) || c == '_') {
+            while (pos < src.size() && isIdentChar(src[pos])) pos++;
+            return { Kind::IDENT, src.substr(start, pos - start) };
+        }
+        if (isDigit(c)) {
+            // Incluye reales y notación científica sencilla (10.0e6)
+            while (pos < src.size() && (isIdentChar(src[pos]) || src[pos] == '.')) pos++;
+            return { Kind::NUMBER, src.substr(start, pos - start) };
+        }
+        if (c == '"') {
+            size_t close = src.find('"', start + 1);
+            if (close == std::string_view::npos) close = src.size();
+            pos = std::min(close + 1, src.size());
+            return { Kind::STRING, src.substr(start + 1, close - start - 1) };
         }
+        if (c == ':' && pos + 1 < src.size() && src[pos + 1] == '=') {
+            pos += 2;
+            return { Kind::SYMBOL, src.substr(start, 2) };
+        }
+        pos++;
+        return { Kind::SYMBOL, src.substr(start, 1) };
     }
 
-    // 8. IDCODE REGISTER
-    if (auto pos = content.find("IDCODE_REGISTER"); pos != std::string_view::npos) {
-        auto isPos = content.find(" IS ", pos);
-        if (isPos != std::string_view::npos) {
-            auto startQuote = content.find('"', isPos);
-            auto endSemi = content.find(";", isPos);
-            if (startQuote != std::string_view::npos && endSemi != std::string_view::npos) {
-                auto rawId = trim(content.substr(startQuote + 1, endSemi - startQuote - 1));
-                std::string binStr;
-                for (char c : rawId) if (c == '0' || c == '1') binStr += c;
-                if (!binStr.empty()) {
-                    try { data.idCode = std::stoul(binStr, nullptr, 2); }
-                    catch (...) { data.idCode = 0; }
-                }
-            }
+    std::string_view src;
+    size_t pos = 0;
+    Token current;
+};
+
+using Kind = BSDLLexer::Kind;
+
+// ============================================================================
+// PARSER PRINCIPAL
+// ============================================================================
+
+bool BSDLParser::parse(const std::filesystem::path& filename) {
+    // Proyección en memoria: los tokens apuntan directamente a las páginas del fichero
+    JTAG::MappedFile file;
+    if (!file.open(filename)) return false;
+
+    return parseText(std::string_view(reinterpret_cast<const char*>(file.data()), file.size()));
+}
+
+bool BSDLParser::parseText(std::string_view content) {
+    data = BSDLData{};
+    vectorPorts.clear();
+    pinMapMatched = false;
+
+    BSDLLexer lex(content);
+    while (lex.peek().kind != Kind::END) {
+        if (lex.acceptWord("ENTITY")) {
+            // "ENTITY nombre IS" no termina en ';'
+            if (lex.peek().kind == Kind::IDENT) data.entityName = upper(lex.next().text);
+            lex.acceptWord("IS");
         }
+        else if (lex.acceptWord("GENERIC")) parseGeneric(lex);
+        else if (lex.acceptWord("PORT")) parsePortClause(lex);
+        else if (lex.acceptWord("ATTRIBUTE")) parseAttribute(lex);
+        else if (lex.acceptWord("CONSTANT")) parseConstant(lex);
+        else lex.skipStatement();   // USE, END, sentencias no soportadas
     }
 
-    // 9. TAP SIGNALS
-    auto parseTapAttr = [&](std::string_view attrName) -> std::string {
-        auto pos = content.find(attrName);
-        if (pos != std::string_view::npos) {
-            auto ofPos = content.find(" OF ", pos);
-            auto colonPos = content.find(" :", pos);
-            if (ofPos != std::string_view::npos && colonPos != std::string_view::npos) {
-                size_t start = ofPos + 4;
-                return std::string(trim(content.substr(start, colonPos - start)));
-            }
+    expandVectorPinMaps();
+    return true;
+}
+
+// GENERIC (PHYSICAL_PIN_MAP : STRING := "PAQUETE");
+void BSDLParser::parseGeneric(BSDLLexer& lex) {
+    int depth = 0;
+    while (lex.peek().kind != Kind::END) {
+        BSDLLexer::Token token = lex.next();
+        if (token.kind == Kind::STRING) {
+            if (data.physicalPinMap.empty()) data.physicalPinMap = upper(trim(token.text));
+        }
+        else if (token.kind == Kind::SYMBOL) {
+            if (token.text == "(") depth++;
+            else if (token.text == ")") depth = std::max(0, depth - 1);
+            else if (token.text == ";" && depth == 0) return;
         }
-        return "";
-        };
+    }
+}
 
-    data.tapTCK = parseTapAttr("TAP_SCAN_CLOCK");
-    data.tapTMS = parseTapAttr("TAP_SCAN_MODE");
-    data.tapTDI = parseTapAttr("TAP_SCAN_IN");
-    data.tapTDO = parseTapAttr("TAP_SCAN_OUT");
-    data.tapTRST = parseTapAttr("TAP_SCAN_RESET");
+// PORT ( a, b : IN BIT; v : INOUT BIT_VECTOR (0 TO 7); ... );
+void BSDLParser::parsePortClause(BSDLLexer& lex) {
+    if (!lex.accept("(")) {
+        lex.skipStatement();
+        return;
+    }
 
-    return true;
-}
+    std::vector<std::string_view> names;
+    while (lex.peek().kind == Kind::IDENT) {
+        names.clear();
+        do {
+            if (lex.peek().kind != Kind::IDENT) break;
+            names.push_back(lex.next().text);
+        } while (lex.accept(","));
 
-// --- RAW MEMBERS ---
+        if (!lex.accept(":")) break;
 
-void BSDLParser::parsePortsRaw(std::string_view content) {
-    auto groups = splitSv(content, ';');
-    for (auto group : groups) {
-        group = trim(group);
-        if (group.empty()) continue;
-        auto colonPos = group.find(':');
-        if (colonPos == std::string_view::npos) continue;
-        auto namesPart = group.substr(0, colonPos);
-        auto typePart = trim(group.substr(colonPos + 1));
+        std::string_view dirWord = lex.next().text;
+        std::string_view typeWord = lex.next().text;
 
         std::string dir = "in";
-        auto has = [&](std::string_view haystack, std::string_view needle) {
-            auto it = std::search(haystack.begin(), haystack.end(), needle.begin(), needle.end(),
-                [](char a, char b) { return std::toupper(a) == std::toupper(b); });
-            return it != haystack.end();
-            };
-
-        if (has(typePart, "INOUT")) dir = "inout";
-        else if (has(typePart, "OUT")) dir = "out";
-        else if (has(typePart, "BUFFER")) dir = "buffer";
-        else if (has(typePart, "LINKAGE")) dir = "linkage";
+        if (iequals(dirWord, "INOUT")) dir = "inout";
+        else if (iequals(dirWord, "OUT")) dir = "out";
+        else if (iequals(dirWord, "BUFFER")) dir = "buffer";
+        else if (iequals(dirWord, "LINKAGE")) dir = "linkage";
 
         int vecStart = 0, vecEnd = 0;
-        bool isVector = has(typePart, "VECTOR") && parseVhdlRange(typePart, vecStart, vecEnd);
+        bool isVector = false;
+        if (lex.accept("(")) {
+            BSDLLexer::Token first = lex.next();
+            bool downto = lex.acceptWord("DOWNTO");
+            bool to = !downto && lex.acceptWord("TO");
+            BSDLLexer::Token last = lex.next();
+            if ((to || downto) && first.kind == Kind::NUMBER && last.kind == Kind::NUMBER) {
+                auto r1 = std::from_chars(first.text.data(), first.text.data() + first.text.size(), vecStart);
+                auto r2 = std::from_chars(last.text.data(), last.text.data() + last.text.size(), vecEnd);
+                isVector = icontains(typeWord, "VECTOR") && r1.ec == std::errc() && r2.ec == std::errc();
+            }
+            while (lex.peek().kind != Kind::END && !lex.accept(")")) lex.next();
+        }
 
-        auto names = splitSv(namesPart, ',');
-        for (auto name : names) {
-            name = trim(name);
-            if (name.empty()) continue;
+        for (std::string_view name : names) {
+            std::string baseName = upper(name);
             if (isVector) {
+                vectorPorts[baseName] = { vecStart, vecEnd };
                 int step = (vecStart <= vecEnd) ? 1 : -1;
-                int current = vecStart;
-                while (true) {
+                for (int current = vecStart;; current += step) {
                     Port p;
-                    p.name = std::string(name) + "(" + std::to_string(current) + ")";
+                    p.name = baseName + "(" + std::to_string(current) + ")";
                     p.direction = dir;
                     p.type = "bit";
-                    data.ports.push_back(p);
+                    data.ports.push_back(std::move(p));
                     if (current == vecEnd) break;
-                    current += step;
                 }
             }
             else {
                 Port p;
-                p.name = std::string(name);
+                p.name = std::move(baseName);
                 p.direction = dir;
                 p.type = "bit";
-                data.ports.push_back(p);
+                data.ports.push_back(std::move(p));
             }
         }
+
+        if (!lex.accept(";")) break;   // ')' cierra la lista
+    }
+
+    lex.skipStatement();
+}
+
+// ATTRIBUTE nombre OF destino : clase IS valor ;
+void BSDLParser::parseAttribute(BSDLLexer& lex) {
+    std::string_view name = lex.next().text;
+    if (!lex.acceptWord("OF")) {   // Declaración de atributo (sin valor)
+        lex.skipStatement();
+        return;
+    }
+    std::string_view target = lex.next().text;
+    if (!lex.accept(":")) {
+        lex.skipStatement();
+        return;
+    }
+    lex.next();   // ENTITY / SIGNAL
+    if (!lex.acceptWord("IS")) {
+        lex.skipStatement();
+        return;
+    }
+
+    auto readInt = [&lex](int& out) {
+        if (lex.peek().kind != Kind::NUMBER) return;
+        std::string_view text = lex.next().text;
+        std::from_chars(text.data(), text.data() + text.size(), out);
+    };
+
+    if (iequals(name, "BOUNDARY_LENGTH")) readInt(data.boundaryLength);
+    else if (iequals(name, "INSTRUCTION_LENGTH")) readInt(data.instructionLength);
+    else if (iequals(name, "INSTRUCTION_OPCODE")) parseInstructionOpcodeRaw(readStringValue(lex));
+    else if (iequals(name, "INSTRUCTION_CAPTURE")) data.instructionCapture = upper(trim(readStringValue(lex)));
+    else if (iequals(name, "IDCODE_REGISTER")) parseIdcodeRaw(readStringValue(lex));
+    else if (iequals(name, "BOUNDARY_REGISTER")) parseBoundaryRegisterRaw(readStringValue(lex));
+    else if (iequals(name, "TAP_SCAN_CLOCK")) data.tapTCK = upper(target);
+    else if (iequals(name, "TAP_SCAN_MODE")) data.tapTMS = upper(target);
+    else if (iequals(name, "TAP_SCAN_IN")) data.tapTDI = upper(target);
+    else if (iequals(name, "TAP_SCAN_OUT")) data.tapTDO = upper(target);
+    else if (iequals(name, "TAP_SCAN_RESET")) data.tapTRST = upper(target);
+
+    lex.skipStatement();
+}
+
+// CONSTANT paquete : PIN_MAP_STRING := "..." & "..." ;
+void BSDLParser::parseConstant(BSDLLexer& lex) {
+    std::string_view name = lex.next().text;
+    if (!lex.accept(":") || !lex.acceptWord("PIN_MAP_STRING") || !lex.accept(":=")) {
+        lex.skipStatement();
+        return;
+    }
+
+    std::string_view value = readStringValue(lex);
+
+    // Se usa la constante que nombra PHYSICAL_PIN_MAP; si no aparece, la primera
+    bool matches = !data.physicalPinMap.empty() && iequals(name, data.physicalPinMap);
+    if (matches && !pinMapMatched) {
+        data.pinMaps.clear();
+        parsePinMapRaw(value);
+        pinMapMatched = true;
+    }
+    else if (!pinMapMatched && data.pinMaps.empty()) {
+        parsePinMapRaw(value);
+    }
+
+    lex.skipStatement();
+}
+
+// Cadena literal con concatenaciones '&'. Con un solo segmento se devuelve la
+// vista sobre el buffer original; con varios, el buffer de trabajo (válido
+// hasta la siguiente llamada)
+std::string_view BSDLParser::readStringValue(BSDLLexer& lex) {
+    std::string_view first;
+    int segments = 0;
+    while (lex.peek().kind == Kind::STRING) {
+        std::string_view segment = lex.next().text;
+        if (segments == 0) first = segment;
+        else {
+            if (segments == 1) scratch.assign(first);
+            scratch.append(segment);
+        }
+        segments++;
+        if (!lex.accept("&")) break;
     }
+    return segments > 1 ? std::string_view(scratch) : first;
 }
 
+// "V : (A1, A2, ...)" asigna un pin por elemento del bit_vector, en el orden del rango
+void BSDLParser::expandVectorPinMaps() {
+    for (const auto& [name, range] : vectorPorts) {
+        auto it = data.pinMaps.find(name);
+        if (it == data.pinMaps.end()) continue;
+
+        const std::vector<std::string> pins = it->second;
+        size_t count = static_cast<size_t>(std::abs(range.second - range.first)) + 1;
+        if (pins.size() != count) continue;
+
+        int step = (range.first <= range.second) ? 1 : -1;
+        int index = range.first;
+        for (const std::string& pin : pins) {
+            auto& element = data.pinMaps[name + "(" + std::to_string(index) + ")"];
+            if (element.empty()) element.push_back(pin);
+            index += step;
+        }
+    }
+}
+
+// --- RAW MEMBERS ---
+
 void BSDLParser::parseInstructionOpcodeRaw(std::string_view content) {
     const char* ptr = content.data();
     const char* end = content.data() + content.size();
+    auto skipSpace = [&]() { while (ptr < end && isSpace(*ptr)) ptr++; };
+
     while (ptr < end) {
-        while (ptr < end && !std::isalnum(static_cast<unsigned char>(*ptr)) && *ptr != '(') ptr++;
+        while (ptr < end && !isAlpha(*ptr) && *ptr != '_') ptr++;
         if (ptr >= end) break;
-        if (*ptr == '(') { ptr++; continue; }
+
         const char* nameStart = ptr;
-        while (ptr < end && (std::isalnum(static_cast<unsigned char>(*ptr)) || *ptr == '_')) ptr++;
-        std::string name(nameStart, ptr - nameStart);
-        while (ptr < end && *ptr != '(') ptr++;
+        while (ptr < end && isIdentChar(*ptr)) ptr++;
+        Instruction instr;
+        instr.name = upper(std::string_view(nameStart, ptr - nameStart));
+
+        skipSpace();
+        if (ptr >= end || *ptr != '(') continue;
         ptr++;
-        const char* codeStart = ptr;
-        while (ptr < end && (*ptr == '0' || *ptr == '1' || *ptr == 'X')) ptr++;
-        std::string code(codeStart, ptr - codeStart);
-        if (!name.empty() && !code.empty()) {
-            Instruction instr; instr.name = name; instr.opcodes.push_back(code);
-            data.instructions.push_back(instr);
+
+        // Una instrucción puede tener varios códigos: NOMBRE (c1, c2, ...)
+        while (ptr < end && *ptr != ')') {
+            skipSpace();
+            const char* codeStart = ptr;
+            while (ptr < end && (*ptr == '0' || *ptr == '1' || *ptr == 'X' || *ptr == 'x')) ptr++;
+            if (ptr > codeStart) instr.opcodes.push_back(upper(std::string_view(codeStart, ptr - codeStart)));
+            while (ptr < end && *ptr != ',' && *ptr != ')') ptr++;
+            if (ptr < end && *ptr == ',') ptr++;
         }
-        while (ptr < end && *ptr != ',') ptr++;
-        ptr++;
+        if (ptr < end) ptr++;
+
+        if (!instr.opcodes.empty()) data.instructions.push_back(std::move(instr));
     }
 }
 
+// "LOGICO : FISICO, VECTOR : (P1, P2, ...), ..."
 void BSDLParser::parsePinMapRaw(std::string_view content) {
-    std::string clean; clean.reserve(content.size());
-    for (char c : content) if (c != '"' && c != '&') clean += c;
-    std::string_view sv(clean);
-    auto pairs = splitSv(sv, ',');
-    for (auto pair : pairs) {
-        auto colon = pair.find(':');
-        if (colon != std::string_view::npos) {
-            auto logic = trim(pair.substr(0, colon));
-            auto phys = trim(pair.substr(colon + 1));
-            if (!logic.empty() && !phys.empty()) {
-                data.pinMaps[std::string(logic)].push_back(std::string(phys));
+    const char* ptr = content.data();
+    const char* end = content.data() + content.size();
+    auto skipSpace = [&]() { while (ptr < end && isSpace(*ptr)) ptr++; };
+    auto readItem = [&](char stop) {
+        const char* start = ptr;
+        while (ptr < end && *ptr != ',' && *ptr != stop) ptr++;
+        return trim(std::string_view(start, ptr - start));
+    };
+
+    while (ptr < end) {
+        while (ptr < end && (isSpace(*ptr) || *ptr == ',')) ptr++;
+        if (ptr >= end) break;
+
+        const char* nameStart = ptr;
+        while (ptr < end && isIdentChar(*ptr)) ptr++;
+        std::string_view logic(nameStart, ptr - nameStart);
+
+        skipSpace();
+        if (logic.empty() || ptr >= end || *ptr != ':') {
+            while (ptr < end && *ptr != ',') ptr++;   // Entrada mal formada
+            continue;
+        }
+        ptr++;
+        skipSpace();
+
+        std::vector<std::string>& pins = data.pinMaps[upper(logic)];
+        if (ptr < end && *ptr == '(') {
+            ptr++;
+            while (ptr < end && *ptr != ')') {
+                std::string_view phys = readItem(')');
+                if (!phys.empty()) pins.push_back(upper(phys));
+                if (ptr < end && *ptr == ',') ptr++;
             }
+            if (ptr < end) ptr++;
+        }
+        else {
+            std::string_view phys = readItem(',');
+            if (!phys.empty()) pins.push_back(upper(phys));
         }
     }
 }
 
+// Bits MSB primero; los 'X' (no importa) se toman como 0
+void BSDLParser::parseIdcodeRaw(std::string_view content) {
+    uint32_t value = 0;
+    for (char c : content) {
+        if (c == '0' || c == 'X' || c == 'x') value <<= 1;
+        else if (c == '1') value = (value << 1) | 1u;
+    }
+    data.idCode = value;
+}
+
 void BSDLParser::parseBoundaryRegisterRaw(std::string_view content) {
     data.boundaryCells.reserve(data.boundaryLength > 0 ? data.boundaryLength : 100);
     const char* ptr = content.data();
     const char* end = content.data() + content.size();
 
     while (ptr < end) {
-        while (ptr < end && !std::isdigit(static_cast<unsigned char>(*ptr))) ptr++;
+        while (ptr < end && !isDigit(*ptr)) ptr++;
         if (ptr == end) break;
 
         BoundaryCell cell;
-        std::from_chars(ptr, end, cell.cellNumber);
+        ptr = std::from_chars(ptr, end, cell.cellNumber).ptr;
 
         while (ptr < end && *ptr != '(') ptr++;
-        if (ptr == end) break; ptr++;
+        if (ptr == end) break;
+        ptr++;
 
+        // Campos separados por ',' al nivel superior: el puerto puede ser "D(3)"
         int fieldIdx = 0;
-        while (ptr < end && *ptr != ')') {
-            while (ptr < end && std::isspace(static_cast<unsigned char>(*ptr))) ptr++;
+        bool closed = false;
+        while (ptr < end && !closed) {
             const char* tokenStart = ptr;
-            while (ptr < end && *ptr != ',' && *ptr != ')') ptr++;
-            std::string_view token(tokenStart, ptr - tokenStart);
-            token = trim(token);
+            int depth = 0;
+            while (ptr < end) {
+                if (*ptr == '(') depth++;
+                else if (*ptr == ')') { if (depth == 0) break; depth--; }
+                else if (*ptr == ',' && depth == 0) break;
+                ptr++;
+            }
+            std::string_view token = trim(std::string_view(tokenStart, ptr - tokenStart));
 
-            if (fieldIdx == 0) cell.cellType = std::string(token);
-            else if (fieldIdx == 1) cell.portName = std::string(token);
-            else if (fieldIdx == 2) cell.function = stringToFunction(token); // CONVERSIÓN A ENUM
-            else if (fieldIdx == 3) cell.safeValue = stringToSafeBit(token); // CONVERSIÓN A ENUM
+            if (fieldIdx == 0) cell.cellType = upper(token);
+            else if (fieldIdx == 1) cell.portName = upper(token);
+            else if (fieldIdx == 2) cell.function = stringToFunction(token);
+            else if (fieldIdx == 3) cell.safeValue = stringToSafeBit(token);
             else if (fieldIdx == 4) {
-                if (token == "*") cell.controlCell = -1;
-                else cell.controlCell = std::atoi(std::string(token).c_str());
+                cell.controlCell = -1;
+                if (token != "*") std::from_chars(token.data(), token.data() + token.size(), cell.controlCell);
             }
-            else if (fieldIdx == 5) cell.disableValue = stringToSafeBit(token); // CONVERSIÓN A ENUM
+            else if (fieldIdx == 5) cell.disableValue = stringToSafeBit(token);
 
-            if (*ptr == ',') ptr++;
+            if (ptr < end && *ptr == ')') closed = true;
+            if (ptr < end) ptr++;
             fieldIdx++;
         }
         data.boundaryCells.push_back(std::move(cell));
     }
-}
\ No newline at end of file
+}
@@ -63,21 +63,43 @@ struct BSDLData {
     std::vector<BoundaryCell> boundaryCells;
 };
 
+class BSDLLexer;
+
+/**
+ * Parser de BSDL (subconjunto VHDL de IEEE 1149.1) en una sola pasada.
+ *
+ * El texto se tokeniza una vez, sin copia previa en mayúsculas: los tokens son
+ * string_view sobre el buffer original (fichero proyectado en memoria) y las
+ * sentencias ATTRIBUTE se despachan por nombre. Las cadenas concatenadas con
+ * '&' se leen segmento a segmento; solo cuando hay más de uno se unen en un
+ * buffer de trabajo reutilizado. BSDLData conserva std::string porque el modelo
+ * sobrevive al fichero; los identificadores se guardan en mayúsculas.
+ */
 class BSDLParser {
 private:
     BSDLData data;
-    std::string fileBuffer;
+    std::string scratch;                                    // Concatenación "a" & "b" (reutilizado)
+    std::map<std::string, std::pair<int, int>> vectorPorts; // Rango de cada bit_vector del PORT
+    bool pinMapMatched = false;                             // Ya se leyó la constante de PHYSICAL_PIN_MAP
+
+    void parseGeneric(BSDLLexer& lex);
+    void parsePortClause(BSDLLexer& lex);
+    void parseAttribute(BSDLLexer& lex);
+    void parseConstant(BSDLLexer& lex);
+    std::string_view readStringValue(BSDLLexer& lex);
+    void expandVectorPinMaps();
 
     void parseBoundaryRegisterRaw(std::string_view content);
     void parseInstructionOpcodeRaw(std::string_view content);
-    void parsePortsRaw(std::string_view content);
     void parsePinMapRaw(std::string_view content);
+    void parseIdcodeRaw(std::string_view content);
 
 public:
     BSDLParser() = default;
     ~BSDLParser() = default;
 
     bool parse(const std::filesystem::path& filename);
+    bool parseText(std::string_view content);      // Texto BSDL ya en memoria
     const BSDLData& getData() const { return data; }
 };
 
@@ -0,0 +1,582 @@
+#include "RpcServer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace JTAG {
+
+    namespace {
+
+        constexpr intptr_t INVALID_HANDLE = -1;
+        constexpr int POLL_INTERVAL_MS = 200;           // Cadencia con la que los hilos miran 'stopping'
+        constexpr size_t MAX_LINE_BYTES = 16u << 20;    // Un mensaje mayor cierra la conexión
+
+#ifdef _WIN32
+        using NativeSocket = SOCKET;
+        using PollFd = WSAPOLLFD;
+        constexpr int SEND_FLAGS = 0;
+
+        int pollSockets(PollFd* fds, size_t count, int timeoutMs) {
+            return ::WSAPoll(fds, static_cast<ULONG>(count), timeoutMs);
+        }
+        void closeSocket(intptr_t socket) { ::closesocket(static_cast<NativeSocket>(socket)); }
+        void shutdownSocket(intptr_t socket) { ::shutdown(static_cast<NativeSocket>(socket), SD_BOTH); }
+
+        bool initSockets() {
+            static const bool ok = [] {
+                WSADATA data;
+                return ::WSAStartup(MAKEWORD(2, 2), &data) == 0;
+            }();
+            return ok;
+        }
+#else
+        using NativeSocket = int;
+        using PollFd = pollfd;
+#ifdef MSG_NOSIGNAL
+        constexpr int SEND_FLAGS = MSG_NOSIGNAL;        // Cliente caído: error, no SIGPIPE
+#else
+        constexpr int SEND_FLAGS = 0;
+#endif
+
+        int pollSockets(PollFd* fds, size_t count, int timeoutMs) {
+            return ::poll(fds, static_cast<nfds_t>(count), timeoutMs);
+        }
+        void closeSocket(intptr_t socket) { ::close(static_cast<NativeSocket>(socket)); }
+        void shutdownSocket(intptr_t socket) { ::shutdown(static_cast<NativeSocket>(socket), SHUT_RDWR); }
+        bool initSockets() { return true; }
+#endif
+
+        NativeSocket native(intptr_t socket) { return static_cast<NativeSocket>(socket); }
+
+        // Espera datos (o una conexión entrante) como mucho POLL_INTERVAL_MS
+        bool waitReadable(intptr_t socket) {
+            PollFd fd{};
+            fd.fd = native(socket);
+            fd.events = POLLIN;
+            return pollSockets(&fd, 1, POLL_INTERVAL_MS) > 0;
+        }
+
+        bool sendAll(intptr_t socket, const std::string& data) {
+            size_t sent = 0;
+            while (sent < data.size()) {
+                const auto n = ::send(native(socket), data.data() + sent,
+                                      static_cast<int>(data.size() - sent), SEND_FLAGS);
+                if (n <= 0) return false;
+                sent += static_cast<size_t>(n);
+            }
+            return true;
+        }
+
+        JsonValue errorResponse(JsonValue id, int code, const std::string& message) {
+            JsonValue error = JsonValue::object();
+            error.set("code", code);
+            error.set("message", message);
+
+            JsonValue response = JsonValue::object();
+            response.set("jsonrpc", "2.0");
+            response.set("error", std::move(error));
+            response.set("id", std::move(id));
+            return response;
+        }
+
+        // Tiempo independiente de dónde difieren (el token no se adivina por prefijos)
+        bool sameToken(const std::string& a, const std::string& b) {
+            unsigned char diff = a.size() == b.size() ? 0 : 1;
+            for (size_t i = 0; i < a.size(); ++i) {
+                diff |= static_cast<unsigned char>(a[i] ^ (i < b.size() ? b[i] : 0));
+            }
+            return diff == 0;
+        }
+
+    } // namespace
+
+    struct RpcServer::Connection {
+        uint64_t id = 0;
+        intptr_t socket = INVALID_HANDLE;
+        std::mutex sendMutex;                        // Respuestas (hilo de la conexión) vs. notify
+        std::mutex hooksMutex;
+        std::vector<std::function<void()>> closeHooks;
+        std::thread thread;
+        std::atomic<bool> finished{ false };
+        bool open = true;                            // Protegido por sendMutex
+
+        bool sendLine(const std::string& line) {
+            std::lock_guard<std::mutex> lock(sendMutex);
+            if (!open) return false;
+            return sendAll(socket, line + "\n");
+        }
+    };
+
+    // ============================================================================
+    // CONTEXTO
+    // ============================================================================
+
+    bool RpcContext::notify(const std::string& method, JsonValue params) const {
+        return server.notify(clientId, method, std::move(params));
+    }
+
+    void RpcContext::onClose(std::function<void()> hook) const {
+        server.addCloseHook(clientId, std::move(hook));
+    }
+
+    // ============================================================================
+    // CICLO DE VIDA
+    // ============================================================================
+
+    RpcServer::RpcServer() = default;
+
+    RpcServer::~RpcServer() {
+        stop();
+    }
+
+    void RpcServer::registerMethod(std::string name, Handler handler) {
+        methods[std::move(name)] = std::move(handler);
+    }
+
+    std::string RpcServer::generateToken() {
+        std::random_device device;
+        std::string token;
+        char text[9];
+        for (int i = 0; i < 4; ++i) {
+            std::snprintf(text, sizeof(text), "%08x", static_cast<unsigned>(device()));
+            token += text;
+        }
+        return token;
+    }
+
+    bool RpcServer::writeTokenFile(const std::filesystem::path& path) {
+        if (authToken.empty()) {
+            lastError = "No auth token set";
+            return false;
+        }
+        std::error_code ec;
+        if (path.has_parent_path()) std::filesystem::create_directories(path.parent_path(), ec);
+        std::filesystem::remove(path, ec);   // Uno anterior puede tener otros permisos
+
+#ifdef _WIN32
+        // El perfil del usuario ya restringe el acceso
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file || !(file << authToken << "\n")) {
+            lastError = "Cannot write token file " + path.string();
+            return false;
+        }
+#else
+        // Creado ya con 0600: no hay ventana en la que otro usuario pueda leerlo
+        const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+        if (fd < 0) {
+            lastError = "Cannot create token file " + path.string();
+            return false;
+        }
+        const std::string line = authToken + "\n";
+        const bool written = ::write(fd, line.data(), line.size()) == static_cast<ssize_t>(line.size());
+        ::close(fd);
+        if (!written) {
+            std::filesystem::remove(path, ec);
+            lastError = "Cannot write token file " + path.string();
+            return false;
+        }
+#endif
+        tokenPath = path;
+        return true;
+    }
+
+    bool RpcServer::listenTcp(uint16_t requestedPort) {
+        if (running) {
+            lastError = "Server already listening";
+            return false;
+        }
+        if (!initSockets()) {
+            lastError = "Cannot initialize sockets";
+            return false;
+        }
+
+        intptr_t socket = static_cast<intptr_t>(::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
+        if (socket == INVALID_HANDLE) {
+            lastError = "Cannot create TCP socket";
+            return false;
+        }
+
+#ifndef _WIN32
+        // Reiniciar la aplicación sin esperar a TIME_WAIT (en Windows permitiría robar el puerto)
+        int reuse = 1;
+        ::setsockopt(native(socket), SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+#endif
+
+        // Solo la máquina local (y con token si se configuró)
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(requestedPort);
+        if (::bind(native(socket), reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            closeSocket(socket);
+            lastError = "Cannot bind 127.0.0.1:" + std::to_string(requestedPort);
+            return false;
+        }
+
+        socklen_t length = sizeof(address);
+        ::getsockname(native(socket), reinterpret_cast<sockaddr*>(&address), &length);
+        port = ntohs(address.sin_port);
+
+        if (!startListening(socket)) return false;
+        std::cout << "[RpcServer] Listening on 127.0.0.1:" << port << "\n";
+        return true;
+    }
+
+    bool RpcServer::listenUnix(const std::filesystem::path& path) {
+#ifdef _WIN32
+        (void)path;
+        lastError = "Unix domain sockets not supported on this platform (use TCP)";
+        return false;
+#else
+        if (running) {
+            lastError = "Server already listening";
+            return false;
+        }
+
+        sockaddr_un address{};
+        const std::string pathText = path.string();
+        if (pathText.size() >= sizeof(address.sun_path)) {
+            lastError = "Socket path too long: " + pathText;
+            return false;
+        }
+
+        intptr_t socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (socket == INVALID_HANDLE) {
+            lastError = "Cannot create Unix socket";
+            return false;
+        }
+
+        // Socket de una ejecución anterior que no se cerró limpiamente
+        std::error_code ec;
+        if (std::filesystem::is_socket(path, ec)) std::filesystem::remove(path, ec);
+
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, pathText.c_str(), pathText.size() + 1);
+        if (::bind(native(socket), reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            closeSocket(socket);
+            lastError = "Cannot bind " + pathText;
+            return false;
+        }
+        // Solo el usuario puede conectar; antes de listen() nadie más ha podido hacerlo
+        if (::chmod(pathText.c_str(), S_IRUSR | S_IWUSR) != 0) {
+            closeSocket(socket);
+            std::filesystem::remove(path, ec);
+            lastError = "Cannot restrict permissions of " + pathText;
+            return false;
+        }
+
+        unixPath = path;
+        if (!startListening(socket)) return false;
+        std::cout << "[RpcServer] Listening on " << pathText << "\n";
+        return true;
+#endif
+    }
+
+    bool RpcServer::startListening(intptr_t socket) {
+        if (::listen(native(socket), SOMAXCONN) != 0) {
+            closeSocket(socket);
+            lastError = "listen() failed";
+            return false;
+        }
+        listener = socket;
+        stopping = false;
+        running = true;
+        acceptThread = std::thread(&RpcServer::acceptLoop, this);
+        return true;
+    }
+
+    void RpcServer::stop() {
+        // También si listen*() falló después de escribir el token
+        if (!tokenPath.empty()) {
+            std::error_code ec;
+            std::filesystem::remove(tokenPath, ec);
+            tokenPath.clear();
+        }
+        if (!running) return;
+        stopping = true;
+
+        if (acceptThread.joinable()) acceptThread.join();
+        closeSocket(listener);
+        listener = INVALID_HANDLE;
+        if (!unixPath.empty()) {
+            std::error_code ec;
+            std::filesystem::remove(unixPath, ec);
+            unixPath.clear();
+        }
+
+        // Desbloquear recv/send pendientes; cada hilo sale en su siguiente poll
+        {
+            std::lock_guard<std::mutex> lock(connectionsMutex);
+            for (auto& [id, connection] : connections) shutdownSocket(connection->socket);
+        }
+        reapFinished(true);
+
+        running = false;
+        stopping = false;
+        std::cout << "[RpcServer] Stopped\n";
+    }
+
+    size_t RpcServer::getClientCount() const {
+        std::lock_guard<std::mutex> lock(connectionsMutex);
+        return connections.size();
+    }
+
+    // ============================================================================
+    // CONEXIONES
+    // ============================================================================
+
+    void RpcServer::acceptLoop() {
+        while (!stopping) {
+            reapFinished(false);
+            if (!waitReadable(listener)) continue;
+
+            intptr_t socket = static_cast<intptr_t>(::accept(native(listener), nullptr, nullptr));
+            if (socket == INVALID_HANDLE) continue;
+
+            auto connection = std::make_shared<Connection>();
+            connection->socket = socket;
+            {
+                std::lock_guard<std::mutex> lock(connectionsMutex);
+                connection->id = nextClientId++;
+                connections[connection->id] = connection;
+            }
+            connection->thread = std::thread(&RpcServer::serveConnection, this, connection);
+        }
+    }
+
+    void RpcServer::reapFinished(bool all) {
+        std::vector<std::shared_ptr<Connection>> done;
+        {
+            std::lock_guard<std::mutex> lock(connectionsMutex);
+            for (auto it = connections.begin(); it != connections.end();) {
+                if (all || it->second->finished) {
+                    done.push_back(it->second);
+                    it = connections.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+        // Fuera del lock: un hilo que termina puede estar en notify()/addCloseHook
+        for (auto& connection : done) {
+            if (connection->thread.joinable()) connection->thread.join();
+        }
+    }
+
+    void RpcServer::serveConnection(std::shared_ptr<Connection> connection) {
+        RpcContext context(*this, connection->id);
+        std::string buffer;
+        char chunk[4096];
+
+        bool connected = true;
+        while (connected && !stopping) {
+            if (!waitReadable(connection->socket)) continue;
+
+            const auto n = ::recv(native(connection->socket), chunk, sizeof(chunk), 0);
+            if (n <= 0) break;   // Cliente cerró (o shutdown desde stop())
+            buffer.append(chunk, static_cast<size_t>(n));
+
+            // Un mensaje por línea; el lote es un único array JSON en su línea
+            size_t start = 0;
+            for (size_t end; connected && (end = buffer.find('\n', start)) != std::string::npos; start = end + 1) {
+                std::string_view line(buffer.data() + start, end - start);
+                if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+                if (line.empty()) continue;
+
+                bool closeConnection = false;
+                const std::string response = handleMessage(line, context, &closeConnection);
+                if (!response.empty()) connected = connection->sendLine(response);
+                if (closeConnection) {
+                    std::cerr << "[RpcServer] Client #" << connection->id << " rejected, closing\n";
+                    connected = false;
+                }
+            }
+            buffer.erase(0, start);
+            if (buffer.size() > MAX_LINE_BYTES) {
+                std::cerr << "[RpcServer] Client #" << connection->id << " exceeded message size limit\n";
+                break;
+            }
+        }
+
+        std::vector<std::function<void()>> hooks;
+        {
+            std::lock_guard<std::mutex> lock(connection->hooksMutex);
+            hooks.swap(connection->closeHooks);
+        }
+        for (auto& hook : hooks) hook();
+
+        {
+            std::lock_guard<std::mutex> lock(authMutex);
+            authenticatedClients.erase(connection->id);
+        }
+        {
+            std::lock_guard<std::mutex> lock(connection->sendMutex);
+            connection->open = false;
+            closeSocket(connection->socket);
+        }
+        connection->finished = true;
+    }
+
+    void RpcServer::addCloseHook(uint64_t clientId, std::function<void()> hook) {
+        std::shared_ptr<Connection> connection;
+        {
+            std::lock_guard<std::mutex> lock(connectionsMutex);
+            auto it = connections.find(clientId);
+            if (it != connections.end()) connection = it->second;
+        }
+        if (!connection) return;
+
+        std::lock_guard<std::mutex> lock(connection->hooksMutex);
+        connection->closeHooks.push_back(std::move(hook));
+    }
+
+    bool RpcServer::notify(uint64_t clientId, const std::string& method, JsonValue params) {
+        std::shared_ptr<Connection> connection;
+        {
+            std::lock_guard<std::mutex> lock(connectionsMutex);
+            auto it = connections.find(clientId);
+            if (it == connections.end()) return false;
+            connection = it->second;
+        }
+
+        JsonValue message = JsonValue::object();
+        message.set("jsonrpc", "2.0");
+        message.set("method", method);
+        message.set("params", std::move(params));
+        return connection->sendLine(message.dump());
+    }
+
+    // ============================================================================
+    // PROTOCOLO
+    // ============================================================================
+
+    std::string RpcServer::handleMessage(std::string_view text, const RpcContext& context,
+                                         bool* closeConnection) {
+        if (closeConnection) *closeConnection = false;
+
+        // Quien no habla JSON (p.ej. un navegador) no tiene nada más que decir
+        std::string parseError;
+        auto message = JsonValue::parse(text, &parseError);
+        if (!message) {
+            if (closeConnection) *closeConnection = true;
+            return errorResponse(nullptr, RpcErrorCode::PARSE_ERROR, "Parse error: " + parseError).dump();
+        }
+
+        // Con token, el primer mensaje debe ser rpc.auth; cualquier otra cosa cierra
+        if (!authToken.empty() && !isAuthenticated(context.getClientId())) {
+            bool accepted = false;
+            JsonValue response = authenticate(*message, context.getClientId(), accepted);
+            if (!accepted && closeConnection) *closeConnection = true;
+            return response.dump();
+        }
+
+        if (!message->isArray()) {
+            bool isNotification = false;
+            JsonValue response = dispatch(*message, context, isNotification);
+            return isNotification ? std::string() : response.dump();
+        }
+
+        // Lote: en orden, una respuesta por petición con id
+        if (message->size() == 0) {
+            return errorResponse(nullptr, RpcErrorCode::INVALID_REQUEST, "Empty batch").dump();
+        }
+        JsonValue responses = JsonValue::array();
+        for (const JsonValue& request : message->asArray()) {
+            bool isNotification = false;
+            JsonValue response = dispatch(request, context, isNotification);
+            if (!isNotification) responses.push(std::move(response));
+        }
+        return responses.size() == 0 ? std::string() : responses.dump();
+    }
+
+    bool RpcServer::isAuthenticated(uint64_t clientId) const {
+        std::lock_guard<std::mutex> lock(authMutex);
+        return authenticatedClients.count(clientId) != 0;
+    }
+
+    JsonValue RpcServer::authenticate(const JsonValue& request, uint64_t clientId, bool& accepted) {
+        accepted = false;
+        const JsonValue* idMember = request.isObject() ? request.find("id") : nullptr;
+        JsonValue id = idMember ? *idMember : JsonValue();
+
+        if (!request.isObject() || request["method"].asString() != "rpc.auth") {
+            return errorResponse(std::move(id), RpcErrorCode::UNAUTHORIZED, "Authentication required (rpc.auth)");
+        }
+        const JsonValue& token = request["params"]["token"];
+        if (!token.isString() || !sameToken(token.asString(), authToken)) {
+            return errorResponse(std::move(id), RpcErrorCode::UNAUTHORIZED, "Invalid token");
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(authMutex);
+            authenticatedClients.insert(clientId);
+        }
+        accepted = true;
+        JsonValue result = JsonValue::object();
+        result.set("authenticated", true);
+
+        JsonValue response = JsonValue::object();
+        response.set("jsonrpc", "2.0");
+        response.set("result", std::move(result));
+        response.set("id", std::move(id));
+        return response;
+    }
+
+    JsonValue RpcServer::dispatch(const JsonValue& request, const RpcContext& context, bool& isNotification) {
+        isNotification = false;
+        if (!request.isObject() || !request["method"].isString()) {
+            return errorResponse(nullptr, RpcErrorCode::INVALID_REQUEST, "Invalid request");
+        }
+
+        const JsonValue* idMember = request.find("id");
+        isNotification = idMember == nullptr;
+        JsonValue id = idMember ? *idMember : JsonValue();
+
+        const std::string& name = request["method"].asString();
+        auto it = methods.find(name);
+        if (it == methods.end()) {
+            return errorResponse(std::move(id), RpcErrorCode::METHOD_NOT_FOUND, "Method not found: " + name);
+        }
+
+        const JsonValue* params = request.find("params");
+        if (params && !params->isObject() && !params->isArray()) {
+            return errorResponse(std::move(id), RpcErrorCode::INVALID_PARAMS, "params must be an object or array");
+        }
+
+        try {
+            JsonValue result = it->second(params ? *params : JsonValue::object(), context);
+
+            JsonValue response = JsonValue::object();
+            response.set("jsonrpc", "2.0");
+            response.set("result", std::move(result));
+            response.set("id", std::move(id));
+            return response;
+        }
+        catch (const RpcError& error) {
+            return errorResponse(std::move(id), error.code, error.message);
+        }
+        catch (const std::exception& e) {
+            return errorResponse(std::move(id), RpcErrorCode::INTERNAL_ERROR, e.what());
+        }
+    }
+
+} // namespace JTAG
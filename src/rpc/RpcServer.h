@@ -0,0 +1,143 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "../core/Json.h"
+
+namespace JTAG {
+
+    // Códigos de error JSON-RPC 2.0 (-32000: fallo de la operación JTAG)
+    namespace RpcErrorCode {
+        constexpr int PARSE_ERROR = -32700;
+        constexpr int INVALID_REQUEST = -32600;
+        constexpr int METHOD_NOT_FOUND = -32601;
+        constexpr int INVALID_PARAMS = -32602;
+        constexpr int INTERNAL_ERROR = -32603;
+        constexpr int OPERATION_FAILED = -32000;
+        constexpr int UNAUTHORIZED = -32001;        // Falta rpc.auth o el token no coincide
+    }
+
+    // Lanzada por los métodos registrados; se convierte en la respuesta de error
+    struct RpcError {
+        int code = RpcErrorCode::OPERATION_FAILED;
+        std::string message;
+    };
+
+    class RpcServer;
+
+    // Cliente que hizo la petición: notificaciones dirigidas y limpieza al desconectar
+    class RpcContext {
+    public:
+        RpcContext(RpcServer& server, uint64_t clientId) : server(server), clientId(clientId) {}
+
+        uint64_t getClientId() const { return clientId; }
+        bool notify(const std::string& method, JsonValue params) const;
+        // Se ejecuta en el hilo de la conexión cuando el cliente se desconecta
+        void onClose(std::function<void()> hook) const;
+
+    private:
+        RpcServer& server;
+        uint64_t clientId;
+    };
+
+    /**
+     * @brief Servidor JSON-RPC 2.0 local para automatización (sin Qt)
+     *
+     * Transporte: TCP en 127.0.0.1 o socket Unix (POSIX), un mensaje JSON por
+     * línea en ambos sentidos. Admite peticiones en lote (array JSON: se
+     * ejecutan en orden y se responde con un array) y notificaciones del
+     * servidor hacia un cliente concreto (notify), p.ej. eventos de watch.
+     *
+     * Un hilo de aceptación y un hilo por conexión: los métodos se ejecutan en
+     * el hilo de su conexión y deben ser thread-safe o delegar en el hilo que
+     * corresponda. Registrar los métodos antes de listen*().
+     *
+     * Con setAuthToken() el primer mensaje de cada conexión debe ser
+     * {"method":"rpc.auth","params":{"token":...}}; cualquier otro mensaje, un
+     * token erróneo o una línea que no sea JSON (p.ej. la cabecera de un POST
+     * HTTP desde un navegador) responde con error y cierra la conexión.
+     */
+    class RpcServer {
+    public:
+        using Handler = std::function<JsonValue(const JsonValue& params, const RpcContext& context)>;
+
+        RpcServer();
+        ~RpcServer();
+
+        RpcServer(const RpcServer&) = delete;
+        RpcServer& operator=(const RpcServer&) = delete;
+
+        void registerMethod(std::string name, Handler handler);
+
+        // Token de la sesión (vacío = sin autenticación); antes de listen*()
+        void setAuthToken(std::string token) { authToken = std::move(token); }
+        const std::string& getAuthToken() const { return authToken; }
+        // Escribe el token en un fichero nuevo legible solo por el usuario (0600);
+        // se borra en stop()
+        bool writeTokenFile(const std::filesystem::path& path);
+        static std::string generateToken();                     // 128 bits aleatorios en hex
+
+        bool listenTcp(uint16_t port);                          // Solo 127.0.0.1; 0 = puerto libre
+        bool listenUnix(const std::filesystem::path& path);     // POSIX, modo 0600; sustituye un socket huérfano
+        void stop();                                            // Cierra conexiones y espera a los hilos
+
+        bool isRunning() const { return running.load(); }
+        bool isStopping() const { return stopping.load(); }
+        uint16_t getPort() const { return port; }
+        size_t getClientCount() const;
+        const std::string& getLastError() const { return lastError; }
+
+        // Notificación JSON-RPC a un cliente; false si ya se desconectó
+        bool notify(uint64_t clientId, const std::string& method, JsonValue params);
+
+        // Procesa un mensaje (objeto o lote). Devuelve la respuesta serializada o
+        // una cadena vacía si solo contenía notificaciones del cliente.
+        // closeConnection: la conexión debe cerrarse tras enviar la respuesta
+        std::string handleMessage(std::string_view text, const RpcContext& context,
+                                  bool* closeConnection = nullptr);
+
+    private:
+        struct Connection;
+        friend class RpcContext;
+
+        bool startListening(intptr_t socket);
+        void acceptLoop();
+        void serveConnection(std::shared_ptr<Connection> connection);
+        void reapFinished(bool all);
+        void addCloseHook(uint64_t clientId, std::function<void()> hook);
+        JsonValue dispatch(const JsonValue& request, const RpcContext& context, bool& isNotification);
+        bool isAuthenticated(uint64_t clientId) const;
+        JsonValue authenticate(const JsonValue& request, uint64_t clientId, bool& accepted);
+
+        std::map<std::string, Handler> methods;
+
+        std::string authToken;
+        std::filesystem::path tokenPath;
+        mutable std::mutex authMutex;
+        std::set<uint64_t> authenticatedClients;
+
+        intptr_t listener = -1;
+        std::filesystem::path unixPath;
+        uint16_t port = 0;
+        std::thread acceptThread;
+        std::atomic<bool> running{ false };
+        std::atomic<bool> stopping{ false };
+
+        mutable std::mutex connectionsMutex;
+        std::map<uint64_t, std::shared_ptr<Connection>> connections;
+        uint64_t nextClientId = 1;
+
+        std::string lastError;
+    };
+
+} // namespace JTAG
@@ -0,0 +1,358 @@
+#include "SvfParser.h"
+#include <iostream>
+#include <fstream>
+#include <cctype>
+#include <charconv>
+
+namespace JTAG {
+
+    // --- HELPERS ESTÁTICOS ---
+
+    static int hexNibble(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    // "(0A3F)" → LSB-first. El último dígito hex contiene los bits 0..3.
+    static bool decodeHex(std::string_view group, size_t length, std::vector<uint8_t>& out) {
+        if (group.size() < 2 || group.front() != '(' || group.back() != ')') return false;
+        group = group.substr(1, group.size() - 2);
+
+        out.assign((length + 7) / 8, 0);
+        size_t bit = 0;
+        for (auto it = group.rbegin(); it != group.rend() && bit < length; ++it) {
+            int nibble = hexNibble(*it);
+            if (nibble < 0) return false;
+            for (int k = 0; k < 4 && bit < length; ++k, ++bit) {
+                if ((nibble >> k) & 1) out[bit / 8] |= static_cast<uint8_t>(1u << (bit % 8));
+            }
+        }
+        return true;
+    }
+
+    // from_chars no depende del locale (strtod lee "1,5" con LC_NUMERIC de coma decimal)
+    static bool parseNumber(const std::string& token, double& value) {
+        const char* first = token.data();
+        const char* last = first + token.size();
+        if (first != last && *first == '+') ++first;
+        const auto result = std::from_chars(first, last, value);
+        return result.ec == std::errc() && result.ptr == last;
+    }
+
+    static int scanIndex(SvfOp op) {
+        return static_cast<int>(op);  // SIR..TDR ocupan 0..5
+    }
+
+    // --- NOMBRES DE ESTADO SVF ---
+
+    std::optional<TAPState> SvfParser::stateFromName(std::string_view name) {
+        if (name == "RESET")     return TAPState::TEST_LOGIC_RESET;
+        if (name == "IDLE")      return TAPState::RUN_TEST_IDLE;
+        if (name == "DRSELECT")  return TAPState::SELECT_DR_SCAN;
+        if (name == "DRCAPTURE") return TAPState::CAPTURE_DR;
+        if (name == "DRSHIFT")   return TAPState::SHIFT_DR;
+        if (name == "DREXIT1")   return TAPState::EXIT1_DR;
+        if (name == "DRPAUSE")   return TAPState::PAUSE_DR;
+        if (name == "DREXIT2")   return TAPState::EXIT2_DR;
+        if (name == "DRUPDATE")  return TAPState::UPDATE_DR;
+        if (name == "IRSELECT")  return TAPState::SELECT_IR_SCAN;
+        if (name == "IRCAPTURE") return TAPState::CAPTURE_IR;
+        if (name == "IRSHIFT")   return TAPState::SHIFT_IR;
+        if (name == "IREXIT1")   return TAPState::EXIT1_IR;
+        if (name == "IRPAUSE")   return TAPState::PAUSE_IR;
+        if (name == "IREXIT2")   return TAPState::EXIT2_IR;
+        if (name == "IRUPDATE")  return TAPState::UPDATE_IR;
+        return std::nullopt;
+    }
+
+    const char* SvfParser::stateToName(TAPState state) {
+        switch (state) {
+        case TAPState::TEST_LOGIC_RESET: return "RESET";
+        case TAPState::RUN_TEST_IDLE:    return "IDLE";
+        case TAPState::SELECT_DR_SCAN:   return "DRSELECT";
+        case TAPState::CAPTURE_DR:       return "DRCAPTURE";
+        case TAPState::SHIFT_DR:         return "DRSHIFT";
+        case TAPState::EXIT1_DR:         return "DREXIT1";
+        case TAPState::PAUSE_DR:         return "DRPAUSE";
+        case TAPState::EXIT2_DR:         return "DREXIT2";
+        case TAPState::UPDATE_DR:        return "DRUPDATE";
+        case TAPState::SELECT_IR_SCAN:   return "IRSELECT";
+        case TAPState::CAPTURE_IR:       return "IRCAPTURE";
+        case TAPState::SHIFT_IR:         return "IRSHIFT";
+        case TAPState::EXIT1_IR:         return "IREXIT1";
+        case TAPState::PAUSE_IR:         return "IRPAUSE";
+        case TAPState::EXIT2_IR:         return "IREXIT2";
+        case TAPState::UPDATE_IR:        return "IRUPDATE";
+        default:                         return "IDLE";
+        }
+    }
+
+    // --- PARSER PRINCIPAL ---
+
+    bool SvfParser::parse(const std::filesystem::path& filename) {
+        std::ifstream in(filename, std::ios::in | std::ios::binary);
+        if (!in) {
+            lastError = "Cannot open SVF file: " + filename.string();
+            return false;
+        }
+
+        in.seekg(0, std::ios::end);
+        std::string buffer;
+        buffer.resize(static_cast<size_t>(in.tellg()));
+        in.seekg(0, std::ios::beg);
+        in.read(&buffer[0], buffer.size());
+
+        return parseText(buffer);
+    }
+
+    bool SvfParser::parseText(std::string_view text) {
+        commands.clear();
+        lastError.clear();
+        for (auto& p : previous) p = SvfBits{};
+
+        std::vector<std::string> tokens;
+        std::string current;
+        size_t line = 1;
+        size_t statementLine = 0;
+        bool inComment = false;
+        bool inGroup = false;
+
+        auto flushToken = [&]() {
+            if (!current.empty()) {
+                if (tokens.empty()) statementLine = line;
+                tokens.push_back(std::move(current));
+                current.clear();
+            }
+        };
+
+        for (size_t i = 0; i < text.size(); ++i) {
+            char c = text[i];
+
+            if (c == '\n') {
+                line++;
+                inComment = false;
+                if (!inGroup) flushToken();
+                continue;
+            }
+            if (inComment) continue;
+
+            if (c == '!' || (c == '/' && i + 1 < text.size() && text[i + 1] == '/')) {
+                inComment = true;
+                continue;
+            }
+
+            if (inGroup) {
+                // Dentro de "( ... )" los espacios y saltos de línea no separan tokens
+                if (std::isspace(static_cast<unsigned char>(c))) continue;
+                current += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+                if (c == ')') {
+                    inGroup = false;
+                    flushToken();
+                }
+                continue;
+            }
+
+            if (c == '(') {
+                flushToken();
+                inGroup = true;
+                current += c;
+                continue;
+            }
+
+            if (c == ';') {
+                flushToken();
+                if (!tokens.empty()) {
+                    if (!parseStatement(tokens, statementLine)) return false;
+                    tokens.clear();
+                }
+                continue;
+            }
+
+            if (std::isspace(static_cast<unsigned char>(c))) {
+                flushToken();
+                continue;
+            }
+
+            current += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        }
+
+        flushToken();
+        if (!tokens.empty()) {
+            return fail(statementLine, "Missing ';' at end of file");
+        }
+
+        std::cout << "[SvfParser] Parsed " << commands.size() << " SVF commands\n";
+        return true;
+    }
+
+    bool SvfParser::fail(size_t line, const std::string& message) {
+        lastError = "SVF line " + std::to_string(line) + ": " + message;
+        std::cerr << "[SvfParser] " << lastError << "\n";
+        return false;
+    }
+
+    bool SvfParser::parseStatement(const std::vector<std::string>& tokens, size_t line) {
+        const std::string& cmd = tokens[0];
+
+        if (cmd == "SIR") return parseScan(SvfOp::SIR, tokens, line);
+        if (cmd == "SDR") return parseScan(SvfOp::SDR, tokens, line);
+        if (cmd == "HIR") return parseScan(SvfOp::HIR, tokens, line);
+        if (cmd == "HDR") return parseScan(SvfOp::HDR, tokens, line);
+        if (cmd == "TIR") return parseScan(SvfOp::TIR, tokens, line);
+        if (cmd == "TDR") return parseScan(SvfOp::TDR, tokens, line);
+        if (cmd == "RUNTEST") return parseRunTest(tokens, line);
+
+        SvfCommand command;
+        command.line = line;
+
+        if (cmd == "STATE" || cmd == "ENDIR" || cmd == "ENDDR") {
+            command.op = (cmd == "STATE") ? SvfOp::STATE : (cmd == "ENDIR") ? SvfOp::ENDIR : SvfOp::ENDDR;
+            for (size_t i = 1; i < tokens.size(); ++i) {
+                auto state = stateFromName(tokens[i]);
+                if (!state) return fail(line, "Unknown TAP state '" + tokens[i] + "'");
+                command.states.push_back(*state);
+            }
+            if (command.states.empty()) return fail(line, cmd + " requires a state");
+            if (command.op != SvfOp::STATE && command.states.size() != 1) {
+                return fail(line, cmd + " takes a single state");
+            }
+            commands.push_back(std::move(command));
+            return true;
+        }
+
+        if (cmd == "FREQUENCY") {
+            command.op = SvfOp::FREQUENCY;
+            if (tokens.size() >= 2 && !parseNumber(tokens[1], command.frequencyHz)) {
+                return fail(line, "Invalid FREQUENCY value");
+            }
+            commands.push_back(std::move(command));
+            return true;
+        }
+
+        if (cmd == "TRST") {
+            command.op = SvfOp::TRST;
+            commands.push_back(std::move(command));
+            return true;
+        }
+
+        if (cmd == "PIO" || cmd == "PIOMAP") {
+            command.op = SvfOp::IGNORED;
+            commands.push_back(std::move(command));
+            return true;
+        }
+
+        return fail(line, "Unknown SVF command '" + cmd + "'");
+    }
+
+    bool SvfParser::parseScan(SvfOp op, const std::vector<std::string>& tokens, size_t line) {
+        if (tokens.size() < 2) return fail(line, tokens[0] + " requires a length");
+
+        double lengthValue = 0;
+        if (!parseNumber(tokens[1], lengthValue) || lengthValue < 0) {
+            return fail(line, "Invalid scan length '" + tokens[1] + "'");
+        }
+
+        SvfCommand command;
+        command.op = op;
+        command.line = line;
+        SvfBits& bits = command.bits;
+        bits.length = static_cast<size_t>(lengthValue);
+
+        bool hasTdi = false, hasMask = false;
+        for (size_t i = 2; i + 1 < tokens.size(); i += 2) {
+            const std::string& key = tokens[i];
+            const std::string& value = tokens[i + 1];
+            std::vector<uint8_t> decoded;
+            if (!decodeHex(value, bits.length, decoded)) {
+                return fail(line, "Invalid hex operand for " + key);
+            }
+            if (key == "TDI") { bits.tdi = std::move(decoded); hasTdi = true; }
+            else if (key == "TDO") { bits.tdo = std::move(decoded); bits.hasTdo = true; }
+            else if (key == "MASK") { bits.mask = std::move(decoded); hasMask = true; }
+            else if (key == "SMASK") { /* SMASK solo documenta bits don't-care de TDI */ }
+            else return fail(line, "Unknown scan operand '" + key + "'");
+        }
+        if ((tokens.size() - 2) % 2 != 0) {
+            return fail(line, "Scan operand without value");
+        }
+
+        // Resolver valores heredados (SVF: TDI y MASK persisten si la longitud no cambia)
+        SvfBits& prev = previous[scanIndex(op)];
+        bool sameLength = (prev.length == bits.length);
+
+        if (!hasTdi) {
+            if (sameLength && !prev.tdi.empty()) bits.tdi = prev.tdi;
+            else bits.tdi.assign((bits.length + 7) / 8, 0);
+        }
+        if (!hasMask) {
+            if (sameLength && !prev.mask.empty()) {
+                bits.mask = prev.mask;
+            } else {
+                bits.mask.assign((bits.length + 7) / 8, 0xFF);
+                if (bits.length % 8 != 0 && !bits.mask.empty()) {
+                    bits.mask.back() = static_cast<uint8_t>((1u << (bits.length % 8)) - 1);
+                }
+            }
+        }
+
+        prev.length = bits.length;
+        prev.tdi = bits.tdi;
+        prev.mask = bits.mask;
+
+        commands.push_back(std::move(command));
+        return true;
+    }
+
+    bool SvfParser::parseRunTest(const std::vector<std::string>& tokens, size_t line) {
+        SvfCommand command;
+        command.op = SvfOp::RUNTEST;
+        command.line = line;
+
+        size_t i = 1;
+        if (i < tokens.size()) {
+            if (auto state = stateFromName(tokens[i])) {
+                command.runState = state;
+                i++;
+            }
+        }
+
+        while (i < tokens.size()) {
+            const std::string& token = tokens[i];
+
+            if (token == "ENDSTATE") {
+                if (i + 1 >= tokens.size()) return fail(line, "ENDSTATE requires a state");
+                auto state = stateFromName(tokens[i + 1]);
+                if (!state) return fail(line, "Unknown TAP state '" + tokens[i + 1] + "'");
+                command.endState = state;
+                i += 2;
+                continue;
+            }
+
+            if (token == "MAXIMUM") {
+                // El tiempo máximo no se puede garantizar desde el host: se ignora
+                i += 3;
+                continue;
+            }
+
+            double value = 0;
+            if (!parseNumber(token, value) || i + 1 >= tokens.size()) {
+                return fail(line, "Invalid RUNTEST operand '" + token + "'");
+            }
+
+            const std::string& unit = tokens[i + 1];
+            if (unit == "TCK" || unit == "SCK") {
+                command.runCount = static_cast<uint64_t>(value);
+            } else if (unit == "SEC") {
+                command.minTimeSec = value;
+            } else {
+                return fail(line, "Unknown RUNTEST unit '" + unit + "'");
+            }
+            i += 2;
+        }
+
+        commands.push_back(std::move(command));
+        return true;
+    }
+
+} // namespace JTAG
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <cstdint>
+#include <filesystem>
+
+#include "../core/JtagStateMachine.h"
+
+namespace JTAG {
+
+    // Comandos SVF soportados (Serial Vector Format, rev E)
+    enum class SvfOp : uint8_t {
+        SIR, SDR,             // Scans de instrucción / datos
+        HIR, HDR, TIR, TDR,   // Header / trailer de la cadena (dispositivos en bypass)
+        RUNTEST,
+        STATE,
+        ENDIR, ENDDR,
+        FREQUENCY,
+        TRST,
+        IGNORED               // PIO, PIOMAP... (se aceptan pero no se ejecutan)
+    };
+
+    // Patrón de bits ya normalizado: LSB-first, longitud exacta en bits.
+    // TDI y MASK están resueltos (SVF los hereda del comando anterior del mismo tipo).
+    struct SvfBits {
+        size_t length = 0;
+        std::vector<uint8_t> tdi;
+        std::vector<uint8_t> tdo;     // Vacío si el comando no compara TDO
+        std::vector<uint8_t> mask;
+        bool hasTdo = false;
+    };
+
+    struct SvfCommand {
+        SvfOp op = SvfOp::IGNORED;
+        size_t line = 0;              // Línea del fichero donde empieza el comando
+
+        SvfBits bits;                 // SIR/SDR/HIR/HDR/TIR/TDR
+
+        // RUNTEST
+        std::optional<TAPState> runState;
+        uint64_t runCount = 0;        // Ciclos de TCK (0 = solo tiempo)
+        double minTimeSec = 0.0;
+        std::optional<TAPState> endState;
+
+        // STATE (ruta) / ENDIR / ENDDR (un único estado)
+        std::vector<TAPState> states;
+
+        double frequencyHz = 0.0;     // FREQUENCY
+    };
+
+    /**
+     * @brief Parser de ficheros SVF
+     *
+     * Elimina comentarios ('!' y '//'), separa sentencias por ';' y decodifica
+     * los operandos hexadecimales a buffers LSB-first listos para el compilador
+     * de vectores.
+     */
+    class SvfParser {
+    public:
+        SvfParser() = default;
+        ~SvfParser() = default;
+
+        bool parse(const std::filesystem::path& filename);
+        bool parseText(std::string_view text);
+
+        const std::vector<SvfCommand>& getCommands() const { return commands; }
+        const std::string& getLastError() const { return lastError; }
+
+        static std::optional<TAPState> stateFromName(std::string_view name);
+        static const char* stateToName(TAPState state);
+
+    private:
+        bool parseStatement(const std::vector<std::string>& tokens, size_t line);
+        bool parseScan(SvfOp op, const std::vector<std::string>& tokens, size_t line);
+        bool parseRunTest(const std::vector<std::string>& tokens, size_t line);
+        bool fail(size_t line, const std::string& message);
+
+        std::vector<SvfCommand> commands;
+        std::string lastError;
+
+        // Valores heredados (TDI / MASK son "sticky" en SVF)
+        SvfBits previous[6];
+    };
+
+} // namespace JTAG
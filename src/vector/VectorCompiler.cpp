@@ -0,0 +1,358 @@
+#include "VectorCompiler.h"
+#include "../core/BitUtils.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+namespace JTAG {
+
+    VectorCompiler::VectorCompiler() = default;
+
+    VectorCompiler::VectorCompiler(Options options)
+        : options(std::move(options))
+    {
+    }
+
+    void VectorCompiler::reset() {
+        stats = Stats{};
+        lastError.clear();
+        state = endIRState = endDRState = runState = runEndState = TAPState::RUN_TEST_IDLE;
+        frequencyHz = 0.0;
+        headerIR = trailerIR = headerDR = trailerDR = SvfBits{};
+        chunkBits = 0;
+        chunkChecks = false;
+        chunkFlags = 0;
+        records.clear();
+        pool.clear();
+        patternIndex.clear();
+        maxVectorBits = 0;
+    }
+
+    // ============================================================================
+    // COMPILACIÓN SVF
+    // ============================================================================
+
+    bool VectorCompiler::compileSVF(const std::filesystem::path& svfPath) {
+        SvfParser parser;
+        if (!parser.parse(svfPath)) {
+            lastError = parser.getLastError();
+            return false;
+        }
+        return compileCommands(parser.getCommands());
+    }
+
+    bool VectorCompiler::compileCommands(const std::vector<SvfCommand>& commands) {
+        for (const auto& cmd : commands) {
+            stats.commands++;
+
+            switch (cmd.op) {
+            case SvfOp::SIR:
+            case SvfOp::SDR: {
+                const SvfBits& b = cmd.bits;
+                appendScan(cmd.op == SvfOp::SIR, b.length, b.tdi.data(),
+                           b.hasTdo ? b.tdo.data() : nullptr,
+                           b.hasTdo ? b.mask.data() : nullptr, cmd.line);
+                break;
+            }
+            case SvfOp::HIR: headerIR = cmd.bits; break;
+            case SvfOp::TIR: trailerIR = cmd.bits; break;
+            case SvfOp::HDR: headerDR = cmd.bits; break;
+            case SvfOp::TDR: trailerDR = cmd.bits; break;
+
+            case SvfOp::RUNTEST:
+                if (cmd.runState) {
+                    runState = *cmd.runState;
+                    runEndState = *cmd.runState;  // ENDSTATE por defecto = run_state
+                }
+                if (cmd.endState) runEndState = *cmd.endState;
+                appendRunTest(cmd.runCount, cmd.minTimeSec, cmd.line);
+                break;
+
+            case SvfOp::STATE:
+                for (TAPState s : cmd.states) appendState(s, cmd.line);
+                break;
+
+            case SvfOp::ENDIR: endIRState = cmd.states.front(); break;
+            case SvfOp::ENDDR: endDRState = cmd.states.front(); break;
+
+            case SvfOp::FREQUENCY:
+                if (frequencyHz == 0.0) frequencyHz = cmd.frequencyHz;
+                break;
+
+            case SvfOp::TRST:
+            case SvfOp::IGNORED:
+                // Los adaptadores actuales no exponen TRST/PIO: sin efecto
+                break;
+            }
+        }
+
+        flushChunk();
+        return true;
+    }
+
+    // ============================================================================
+    // CONSTRUCCIÓN DEL STREAM CRUDO
+    // ============================================================================
+
+    void VectorCompiler::growChunk(size_t extraBits) {
+        size_t bytes = bytesForBits(chunkBits + extraBits);
+        if (chunkTdi.size() < bytes) {
+            chunkTdi.resize(bytes, 0);
+            chunkTms.resize(bytes, 0);
+            chunkTdo.resize(bytes, 0);
+            chunkMask.resize(bytes, 0);
+        }
+    }
+
+    void VectorCompiler::appendConstantBits(bool tms, size_t count) {
+        growChunk(count);
+        for (size_t i = 0; i < count; ++i) {
+            setBit(chunkTms.data(), chunkBits + i, tms);  // TDI, TDO y MASK quedan a 0
+        }
+        chunkBits += count;
+    }
+
+    void VectorCompiler::appendNavigation(TAPState target) {
+        if (target == TAPState::TEST_LOGIC_RESET) {
+            // 5×TMS=1 alcanza Test-Logic-Reset desde cualquier estado
+            appendConstantBits(true, 5);
+            state = target;
+            return;
+        }
+
+        JtagPath path = JtagStateMachine::getPath(state, target);
+        growChunk(path.bitCount);
+        for (int i = 0; i < path.bitCount; ++i) {
+            setBit(chunkTms.data(), chunkBits + i, (path.tmsBits >> i) & 1);
+        }
+        chunkBits += path.bitCount;
+        state = target;
+    }
+
+    void VectorCompiler::setEndStates(TAPState endIR, TAPState endDR) {
+        endIRState = endIR;
+        endDRState = endDR;
+    }
+
+    void VectorCompiler::appendScan(bool isIR, size_t numBits, const uint8_t* tdi,
+                                    const uint8_t* tdo, const uint8_t* mask, size_t line) {
+        const SvfBits& header = isIR ? headerIR : headerDR;
+        const SvfBits& trailer = isIR ? trailerIR : trailerDR;
+        size_t totalBits = header.length + numBits + trailer.length;
+        TAPState endState = isIR ? endIRState : endDRState;
+
+        if (totalBits == 0) {
+            appendNavigation(endState);
+            return;
+        }
+
+        // Evitar vectores enormes: cerrar el actual si el scan no cabe
+        if (chunkBits > 0 && chunkBits + totalBits + 16 > options.maxChunkBits) {
+            flushChunk();
+        }
+
+        appendNavigation(isIR ? TAPState::SHIFT_IR : TAPState::SHIFT_DR);
+
+        growChunk(totalBits);
+        size_t base = chunkBits;
+
+        // Orden de desplazamiento: header, datos, trailer (LSB primero)
+        auto place = [&](const SvfBits& part, size_t offset) {
+            if (part.length == 0) return;
+            copyBits(part.tdi.data(), 0, chunkTdi.data(), base + offset, part.length);
+            if (part.hasTdo) {
+                copyBits(part.tdo.data(), 0, chunkTdo.data(), base + offset, part.length);
+                copyBits(part.mask.data(), 0, chunkMask.data(), base + offset, part.length);
+                chunkChecks = true;
+            }
+        };
+
+        place(header, 0);
+        if (numBits > 0) {
+            if (tdi) copyBits(tdi, 0, chunkTdi.data(), base + header.length, numBits);
+            if (tdo) {
+                copyBits(tdo, 0, chunkTdo.data(), base + header.length, numBits);
+                if (mask) {
+                    copyBits(mask, 0, chunkMask.data(), base + header.length, numBits);
+                } else {
+                    for (size_t i = 0; i < numBits; ++i) setBit(chunkMask.data(), base + header.length + i, true);
+                }
+                chunkChecks = true;
+            }
+        }
+        place(trailer, header.length + numBits);
+
+        // Último bit con TMS=1: Shift → Exit1
+        setBit(chunkTms.data(), base + totalBits - 1, true);
+        chunkBits += totalBits;
+        state = isIR ? TAPState::EXIT1_IR : TAPState::EXIT1_DR;
+
+        appendNavigation(endState);
+
+        chunkFlags |= isIR ? VECTOR_HAS_IR : VECTOR_HAS_DR;
+        chunkLine = line;
+
+        // Un scan con comparación cierra el vector (diagnóstico por línea SVF)
+        if (chunkChecks) flushChunk();
+    }
+
+    void VectorCompiler::appendRunTest(uint64_t cycles, double minTimeSec, size_t line) {
+        appendNavigation(runState);
+
+        double freq = (frequencyHz > 0.0) ? frequencyHz : 1.0e6;
+        uint64_t clocked = std::min<uint64_t>(cycles, options.maxRunTestCycles);
+        double remainingSec = std::max(minTimeSec, static_cast<double>(cycles) / freq)
+                            - static_cast<double>(clocked) / freq;
+
+        if (clocked > 0) {
+            // En Test-Logic-Reset el reloj libre requiere TMS=1; en el resto TMS=0
+            appendConstantBits(runState == TAPState::TEST_LOGIC_RESET, static_cast<size_t>(clocked));
+        }
+
+        chunkLine = line;
+        appendNavigation(runEndState);
+
+        // El tiempo que no cubren los TCK se espera en el host tras enviar el vector
+        if (remainingSec > 0.0) {
+            flushChunk(static_cast<uint32_t>(std::ceil(remainingSec * 1.0e6)));
+        } else if (chunkBits >= options.maxChunkBits) {
+            flushChunk();
+        }
+    }
+
+    void VectorCompiler::appendState(TAPState target, size_t line) {
+        appendNavigation(target);
+        chunkLine = line;
+    }
+
+    // ============================================================================
+    // CIERRE DE VECTORES Y POOL DEDUPLICADO
+    // ============================================================================
+
+    uint32_t VectorCompiler::internPattern(const uint8_t* data, size_t size) {
+        std::string key(reinterpret_cast<const char*>(data), size);
+        auto it = patternIndex.find(key);
+        if (it != patternIndex.end()) {
+            stats.dedupBytesSaved += size;
+            return it->second;
+        }
+
+        uint32_t offset = static_cast<uint32_t>(pool.size());
+        pool.insert(pool.end(), data, data + size);
+        patternIndex.emplace(std::move(key), offset);
+        stats.uniquePatterns++;
+        return offset;
+    }
+
+    void VectorCompiler::flushChunk(uint32_t delayUs) {
+        if (chunkBits == 0) {
+            // Espera pura: se asocia al vector anterior si existe
+            if (delayUs > 0 && !records.empty()) records.back().delayUs += delayUs;
+            return;
+        }
+
+        size_t bytes = bytesForBits(chunkBits);
+
+        VectorRecord rec{};
+        rec.numBits = static_cast<uint32_t>(chunkBits);
+        rec.tdiOffset = internPattern(chunkTdi.data(), bytes);
+        rec.tmsOffset = internPattern(chunkTms.data(), bytes);
+        if (chunkChecks) {
+            // TDO esperado pre-enmascarado: el ejecutor solo hace ((tdo ^ exp) & mask)
+            for (size_t i = 0; i < bytes; ++i) chunkTdo[i] &= chunkMask[i];
+            rec.tdoOffset = internPattern(chunkTdo.data(), bytes);
+            rec.maskOffset = internPattern(chunkMask.data(), bytes);
+            rec.flags = static_cast<uint16_t>(chunkFlags | VECTOR_CHECK_TDO);
+        } else {
+            rec.tdoOffset = JVEC_NO_PATTERN;
+            rec.maskOffset = JVEC_NO_PATTERN;
+            rec.flags = chunkFlags;
+        }
+        rec.delayUs = delayUs;
+        rec.sourceLine = static_cast<uint32_t>(chunkLine);
+        records.push_back(rec);
+
+        maxVectorBits = std::max<uint32_t>(maxVectorBits, rec.numBits);
+        stats.vectors++;
+        stats.totalBits += chunkBits;
+
+        // Reiniciar el vector en construcción (se conserva la capacidad)
+        std::fill(chunkTdi.begin(), chunkTdi.begin() + bytes, 0);
+        std::fill(chunkTms.begin(), chunkTms.begin() + bytes, 0);
+        std::fill(chunkTdo.begin(), chunkTdo.begin() + bytes, 0);
+        std::fill(chunkMask.begin(), chunkMask.begin() + bytes, 0);
+        chunkBits = 0;
+        chunkChecks = false;
+        chunkFlags = 0;
+    }
+
+    // ============================================================================
+    // ESCRITURA DEL FICHERO
+    // ============================================================================
+
+    bool VectorCompiler::write(const std::filesystem::path& outputPath) {
+        flushChunk();
+
+        std::vector<ChainDeviceEntry> chain;
+        for (const auto& dev : options.chain) {
+            ChainDeviceEntry entry{};
+            entry.idcode = dev.idcode;
+            entry.irLength = static_cast<uint16_t>(dev.irLength);
+            std::strncpy(entry.name, dev.name.c_str(), sizeof(entry.name) - 1);
+            chain.push_back(entry);
+        }
+
+        VectorFileHeader header{};
+        std::memcpy(header.magic, JVEC_MAGIC, sizeof(header.magic));
+        header.version = JVEC_VERSION;
+        header.headerSize = sizeof(VectorFileHeader);
+        header.frequencyHz = static_cast<uint32_t>(frequencyHz);
+        header.chainDeviceCount = static_cast<uint32_t>(chain.size());
+        header.vectorCount = static_cast<uint32_t>(records.size());
+        header.maxVectorBits = maxVectorBits;
+        header.headerIRBits = static_cast<uint32_t>(headerIR.length);
+        header.trailerIRBits = static_cast<uint32_t>(trailerIR.length);
+        header.headerDRBits = static_cast<uint32_t>(headerDR.length);
+        header.trailerDRBits = static_cast<uint32_t>(trailerDR.length);
+        header.chainOffset = sizeof(VectorFileHeader);
+        header.vectorTableOffset = header.chainOffset + chain.size() * sizeof(ChainDeviceEntry);
+        header.poolOffset = header.vectorTableOffset + records.size() * sizeof(VectorRecord);
+        header.poolSize = pool.size();
+        header.totalBits = stats.totalBits;
+        header.sourceCommands = static_cast<uint32_t>(stats.commands);
+
+        uint32_t checksum = 0x811C9DC5u;
+        checksum = fnv1a32(reinterpret_cast<const uint8_t*>(chain.data()), chain.size() * sizeof(ChainDeviceEntry), checksum);
+        checksum = fnv1a32(reinterpret_cast<const uint8_t*>(records.data()), records.size() * sizeof(VectorRecord), checksum);
+        checksum = fnv1a32(pool.data(), pool.size(), checksum);
+        header.checksum = checksum;
+
+        std::ofstream out(outputPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!out) {
+            lastError = "Cannot create output file: " + outputPath.string();
+            std::cerr << "[VectorCompiler] " << lastError << "\n";
+            return false;
+        }
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(chain.data()), chain.size() * sizeof(ChainDeviceEntry));
+        out.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(VectorRecord));
+        out.write(reinterpret_cast<const char*>(pool.data()), pool.size());
+
+        if (!out) {
+            lastError = "Write error on " + outputPath.string();
+            std::cerr << "[VectorCompiler] " << lastError << "\n";
+            return false;
+        }
+
+        stats.poolBytes = pool.size();
+        std::cout << "[VectorCompiler] Wrote " << outputPath.string() << ": "
+                  << stats.commands << " commands -> " << stats.vectors << " vectors, "
+                  << stats.uniquePatterns << " unique patterns (" << stats.poolBytes
+                  << " bytes, " << stats.dedupBytesSaved << " bytes deduplicated)\n";
+        return true;
+    }
+
+} // namespace JTAG
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <filesystem>
+
+#include "SvfParser.h"
+#include "VectorFormat.h"
+#include "../core/JtagStateMachine.h"
+
+namespace JTAG {
+
+    // Dispositivo de la cadena descrito en la cabecera del .jvec
+    struct ChainDeviceInfo {
+        uint32_t idcode = 0;
+        size_t irLength = 0;
+        std::string name;
+    };
+
+    /**
+     * @brief Compilador SVF (o sesiones grabadas) → vectores binarios .jvec
+     *
+     * - Cada SIR/SDR/RUNTEST/STATE se traduce a un stream crudo TMS/TDI con la
+     *   navegación TAP incluida (nada que calcular al ejecutar).
+     * - Comandos consecutivos sin comparación de TDO se fusionan en un único
+     *   vector (una sola transferencia USB) hasta maxChunkBits.
+     * - Un scan con TDO cierra el vector: un fallo apunta a su línea SVF.
+     * - Los patrones idénticos (típico en programación de CPLD) se guardan una vez.
+     */
+    class VectorCompiler {
+    public:
+        struct Options {
+            std::vector<ChainDeviceInfo> chain;
+            size_t maxChunkBits = 64 * 1024;      // Tamaño objetivo de cada vector
+            uint64_t maxRunTestCycles = 1 << 20;  // Por encima → espera en lugar de TCK
+        };
+
+        struct Stats {
+            size_t commands = 0;
+            size_t vectors = 0;
+            size_t uniquePatterns = 0;
+            size_t poolBytes = 0;
+            size_t dedupBytesSaved = 0;
+            uint64_t totalBits = 0;
+        };
+
+        VectorCompiler();
+        explicit VectorCompiler(Options options);
+        ~VectorCompiler() = default;
+
+        bool compileSVF(const std::filesystem::path& svfPath);
+        bool compileCommands(const std::vector<SvfCommand>& commands);
+
+        // ========== API DE BAJO NIVEL (conversión de grabaciones) ==========
+        // Scan completo (IR o DR) desde el estado actual, terminando en ENDIR/ENDDR.
+        // tdo/mask pueden ser nullptr (sin comparación).
+        void appendScan(bool isIR, size_t numBits, const uint8_t* tdi,
+                        const uint8_t* tdo, const uint8_t* mask, size_t line = 0);
+        void appendRunTest(uint64_t cycles, double minTimeSec, size_t line = 0);
+        void appendState(TAPState target, size_t line = 0);
+        void setEndStates(TAPState endIR, TAPState endDR);
+
+        bool write(const std::filesystem::path& outputPath);
+        void reset();
+
+        const Stats& getStats() const { return stats; }
+        const std::string& getLastError() const { return lastError; }
+
+    private:
+        void appendNavigation(TAPState target);
+        void appendConstantBits(bool tms, size_t count);
+        void growChunk(size_t extraBits);
+        void flushChunk(uint32_t delayUs = 0);
+        uint32_t internPattern(const uint8_t* data, size_t size);
+
+        Options options;
+        Stats stats;
+        std::string lastError;
+
+        // Estado TAP simulado y estados finales SVF
+        TAPState state = TAPState::RUN_TEST_IDLE;
+        TAPState endIRState = TAPState::RUN_TEST_IDLE;
+        TAPState endDRState = TAPState::RUN_TEST_IDLE;
+        TAPState runState = TAPState::RUN_TEST_IDLE;
+        TAPState runEndState = TAPState::RUN_TEST_IDLE;
+        double frequencyHz = 0.0;
+
+        // Header / trailer de la cadena (HIR, TIR, HDR, TDR)
+        SvfBits headerIR, trailerIR, headerDR, trailerDR;
+
+        // Vector en construcción
+        std::vector<uint8_t> chunkTdi, chunkTms, chunkTdo, chunkMask;
+        size_t chunkBits = 0;
+        bool chunkChecks = false;
+        uint16_t chunkFlags = 0;
+        size_t chunkLine = 0;
+
+        // Salida
+        std::vector<VectorRecord> records;
+        std::vector<uint8_t> pool;
+        std::unordered_map<std::string, uint32_t> patternIndex;
+        uint32_t maxVectorBits = 0;
+    };
+
+} // namespace JTAG
@@ -0,0 +1,164 @@
+#include "VectorExecutor.h"
+#include "../core/BitUtils.h"
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <cstring>
+
+namespace JTAG {
+
+    VectorExecutor::VectorExecutor(IJTAGAdapter* adapter)
+        : adapter(adapter)
+    {
+    }
+
+    void VectorExecutor::close() {
+        file.close();
+        header = nullptr;
+        records = nullptr;
+        pool = nullptr;
+    }
+
+    bool VectorExecutor::open(const std::filesystem::path& path) {
+        close();
+
+        if (!file.open(path)) {
+            lastError = "Cannot map vector file: " + path.string();
+            std::cerr << "[VectorExecutor] " << lastError << "\n";
+            return false;
+        }
+
+        const uint8_t* base = file.data();
+        size_t size = file.size();
+
+        if (size < sizeof(VectorFileHeader)) {
+            lastError = "File too small for a JVEC header";
+            close();
+            return false;
+        }
+
+        header = reinterpret_cast<const VectorFileHeader*>(base);
+        if (std::memcmp(header->magic, JVEC_MAGIC, sizeof(header->magic)) != 0 ||
+            header->version != JVEC_VERSION ||
+            header->headerSize != sizeof(VectorFileHeader)) {
+            lastError = "Not a JVEC v" + std::to_string(JVEC_VERSION) + " file";
+            close();
+            return false;
+        }
+
+        uint64_t tableEnd = header->vectorTableOffset + uint64_t(header->vectorCount) * sizeof(VectorRecord);
+        if (header->chainOffset + uint64_t(header->chainDeviceCount) * sizeof(ChainDeviceEntry) > size ||
+            tableEnd > size || header->poolOffset + header->poolSize > size) {
+            lastError = "Truncated JVEC file";
+            close();
+            return false;
+        }
+
+        uint32_t checksum = fnv1a32(base + header->chainOffset, size - header->chainOffset);
+        if (checksum != header->checksum) {
+            lastError = "JVEC checksum mismatch";
+            close();
+            return false;
+        }
+
+        records = reinterpret_cast<const VectorRecord*>(base + header->vectorTableOffset);
+        pool = base + header->poolOffset;
+
+        // Validar offsets una sola vez: el bucle de ejecución no comprueba nada
+        for (uint32_t i = 0; i < header->vectorCount; ++i) {
+            const VectorRecord& rec = records[i];
+            uint64_t bytes = bytesForBits(rec.numBits);
+            bool badTdo = (rec.flags & VECTOR_CHECK_TDO) &&
+                          (rec.tdoOffset + bytes > header->poolSize || rec.maskOffset + bytes > header->poolSize);
+            if (rec.numBits > header->maxVectorBits ||
+                rec.tdiOffset + bytes > header->poolSize ||
+                rec.tmsOffset + bytes > header->poolSize || badTdo) {
+                lastError = "Corrupt vector record " + std::to_string(i);
+                close();
+                return false;
+            }
+        }
+
+        tdoBuffer.assign(bytesForBits(header->maxVectorBits), 0);
+
+        std::cout << "[VectorExecutor] Loaded " << path.string() << ": "
+                  << header->vectorCount << " vectors, " << header->totalBits << " bits, "
+                  << header->poolSize << " pool bytes\n";
+        return true;
+    }
+
+    VectorExecutor::Result VectorExecutor::run(const ProgressCallback& progress) {
+        Result result;
+
+        if (!header) {
+            result.error = "No vector file loaded";
+            return result;
+        }
+        if (!adapter || !adapter->isConnected()) {
+            result.error = "Adapter not connected";
+            return result;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        const uint32_t count = header->vectorCount;
+
+        for (uint32_t i = 0; i < count; ++i) {
+            const VectorRecord& rec = records[i];
+            const bool check = (rec.flags & VECTOR_CHECK_TDO) != 0;
+
+            if (!adapter->shiftRaw(pattern(rec.tdiOffset), pattern(rec.tmsOffset),
+                                   check ? tdoBuffer.data() : nullptr, rec.numBits)) {
+                result.error = "Adapter shift failed";
+                result.failedVector = i;
+                result.sourceLine = rec.sourceLine;
+                break;
+            }
+
+            if (check) {
+                // El TDO esperado ya viene enmascarado por el compilador
+                const uint8_t* expected = pattern(rec.tdoOffset);
+                const uint8_t* mask = pattern(rec.maskOffset);
+                size_t bytes = bytesForBits(rec.numBits);
+                bool mismatch = false;
+                for (size_t b = 0; b < bytes; ++b) {
+                    if ((tdoBuffer[b] & mask[b]) != expected[b]) { mismatch = true; break; }
+                }
+                if (mismatch) {
+                    result.error = "TDO mismatch";
+                    result.failedVector = i;
+                    result.sourceLine = rec.sourceLine;
+                    break;
+                }
+            }
+
+            if (rec.delayUs > 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(rec.delayUs));
+            }
+
+            result.vectorsExecuted++;
+            result.bitsShifted += rec.numBits;
+
+            if (progress && (i & 0xFF) == 0 && !progress(i, count)) {
+                result.error = "Cancelled";
+                result.failedVector = i;
+                result.sourceLine = rec.sourceLine;
+                break;
+            }
+        }
+
+        result.ok = result.error.empty();
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (result.ok) {
+            std::cout << "[VectorExecutor] " << result.vectorsExecuted << " vectors OK in "
+                      << result.seconds << " s\n";
+        } else {
+            std::cerr << "[VectorExecutor] " << result.error << " at vector " << result.failedVector
+                      << " (SVF line " << result.sourceLine << ")\n";
+        }
+        if (progress) progress(result.vectorsExecuted, count);
+
+        return result;
+    }
+
+} // namespace JTAG
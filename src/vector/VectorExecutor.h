@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+
+#include "VectorFormat.h"
+#include "../core/MappedFile.h"
+#include "../hal/IJTAGAdapter.h"
+
+namespace JTAG {
+
+    /**
+     * @brief Ejecutor de vectores compilados (.jvec)
+     *
+     * El fichero se proyecta en memoria y los patrones se pasan directamente al
+     * adaptador (shiftRaw) sin copias ni parseo. Supone el TAP en Run-Test/Idle
+     * al empezar (estado en el que BoundaryScanEngine deja siempre la cadena).
+     */
+    class VectorExecutor {
+    public:
+        struct Result {
+            bool ok = false;
+            size_t vectorsExecuted = 0;
+            size_t failedVector = 0;       // Índice del vector que falló (si !ok)
+            size_t sourceLine = 0;         // Línea SVF correspondiente
+            uint64_t bitsShifted = 0;
+            double seconds = 0.0;
+            std::string error;
+        };
+
+        // Progreso: (vectores ejecutados, total). Devolver false cancela.
+        using ProgressCallback = std::function<bool(size_t, size_t)>;
+
+        explicit VectorExecutor(IJTAGAdapter* adapter);
+        ~VectorExecutor() = default;
+
+        bool open(const std::filesystem::path& path);
+        void close();
+
+        Result run(const ProgressCallback& progress = nullptr);
+
+        const VectorFileHeader* getHeader() const { return header; }
+        const std::string& getLastError() const { return lastError; }
+
+    private:
+        const uint8_t* pattern(uint32_t offset) const { return pool + offset; }
+
+        IJTAGAdapter* adapter;
+        MappedFile file;
+        const VectorFileHeader* header = nullptr;
+        const VectorRecord* records = nullptr;
+        const uint8_t* pool = nullptr;
+        std::vector<uint8_t> tdoBuffer;   // Reservado una vez (maxVectorBits)
+        std::string lastError;
+    };
+
+} // namespace JTAG
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace JTAG {
+
+    // ============================================================================
+    // FORMATO BINARIO DE VECTORES (.jvec) - estilo XSVF
+    // ============================================================================
+    //
+    // [VectorFileHeader]
+    // [ChainDeviceEntry x chainDeviceCount]     Descripción de la cadena
+    // [VectorRecord x vectorCount]              Tabla de vectores (tamaño fijo)
+    // [Pool de patrones]                        Bloques TDI/TMS/TDO/MASK deduplicados
+    //
+    // Todos los patrones están en el layout nativo de los adaptadores:
+    // LSB-first, un bit de TMS por cada bit de TDI (stream crudo para shiftRaw()).
+    // Cada vector incluye ya la navegación TAP, así que el ejecutor no calcula nada:
+    // solo pasa punteros del fichero proyectado en memoria al adaptador.
+    //
+    // Todos los campos multibyte son little-endian.
+
+    constexpr char     JVEC_MAGIC[4] = { 'J', 'V', 'E', 'C' };
+    constexpr uint16_t JVEC_VERSION = 1;
+    constexpr uint32_t JVEC_NO_PATTERN = 0xFFFFFFFF;
+
+    // Flags de VectorRecord
+    enum VectorFlags : uint16_t {
+        VECTOR_CHECK_TDO = 0x0001,   // Comparar TDO capturado con (tdo, mask)
+        VECTOR_HAS_IR    = 0x0002,   // Contiene al menos un scan de IR
+        VECTOR_HAS_DR    = 0x0004    // Contiene al menos un scan de DR
+    };
+
+#pragma pack(push, 1)
+
+    struct VectorFileHeader {
+        char     magic[4];           ///< "JVEC"
+        uint16_t version;            ///< JVEC_VERSION
+        uint16_t headerSize;         ///< sizeof(VectorFileHeader)
+        uint32_t frequencyHz;        ///< FREQUENCY del SVF (0 = no especificada)
+        uint32_t chainDeviceCount;
+        uint32_t vectorCount;
+        uint32_t maxVectorBits;      ///< Para reservar el buffer TDO una sola vez
+        uint32_t headerIRBits;       ///< HIR/TIR/HDR/TDR efectivos al compilar
+        uint32_t trailerIRBits;
+        uint32_t headerDRBits;
+        uint32_t trailerDRBits;
+        uint64_t chainOffset;
+        uint64_t vectorTableOffset;
+        uint64_t poolOffset;
+        uint64_t poolSize;
+        uint64_t totalBits;          ///< Suma de numBits de todos los vectores
+        uint32_t sourceCommands;     ///< Comandos SVF compilados
+        uint32_t checksum;           ///< FNV-1a de todo lo que sigue a la cabecera
+    };
+
+    struct ChainDeviceEntry {
+        uint32_t idcode;
+        uint16_t irLength;
+        uint16_t reserved;
+        char     name[24];           ///< Entity BSDL (truncado, terminado en '\0')
+    };
+
+    struct VectorRecord {
+        uint32_t numBits;
+        uint32_t tdiOffset;          ///< Offset en el pool
+        uint32_t tmsOffset;
+        uint32_t tdoOffset;          ///< JVEC_NO_PATTERN si no se compara
+        uint32_t maskOffset;         ///< JVEC_NO_PATTERN si no se compara
+        uint32_t delayUs;            ///< Espera tras el vector (RUNTEST con tiempo mínimo)
+        uint32_t sourceLine;         ///< Línea SVF del último comando del vector
+        uint16_t flags;              ///< VectorFlags
+        uint16_t reserved;
+    };
+
+#pragma pack(pop)
+
+    static_assert(sizeof(VectorRecord) == 32, "VectorRecord debe ocupar 32 bytes");
+
+    inline uint32_t fnv1a32(const uint8_t* data, size_t size, uint32_t hash = 0x811C9DC5u) {
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= data[i];
+            hash *= 0x01000193u;
+        }
+        return hash;
+    }
+
+} // namespace JTAG
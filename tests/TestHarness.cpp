@@ -0,0 +1,112 @@
+// jtag_tests - Pruebas unitarias de jtag_core (sin Qt)
+//
+// Uso: jtag_tests [prefijo]     p.ej. "json" o "json.parse_numbers"
+//      jtag_tests --list
+//
+// Código de salida 0 si todos los casos seleccionados pasan.
+
+#include "TestHarness.h"
+
+#include <iostream>
+#include <chrono>
+#include <atomic>
+#include <exception>
+#include <clocale>
+
+#ifndef JTAG_TEST_DATA_DIR
+#define JTAG_TEST_DATA_DIR "test_files"
+#endif
+
+namespace fs = std::filesystem;
+
+namespace JTAG {
+
+    namespace {
+        size_t currentFailures = 0;
+        fs::path currentTempDir;
+    }
+
+    std::vector<TestCase>& testRegistry() {
+        static std::vector<TestCase> registry;
+        return registry;
+    }
+
+    void testFailure(const char* file, int line, const std::string& message) {
+        currentFailures++;
+        std::cerr << "    " << fs::path(file).filename().string() << ":" << line << ": " << message << "\n";
+    }
+
+    fs::path testTempDir() {
+        if (currentTempDir.empty()) {
+            static std::atomic<unsigned> counter{ 0 };
+            const auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+            currentTempDir = fs::temp_directory_path()
+                             / ("jtag_tests_" + std::to_string(stamp) + "_" + std::to_string(counter++));
+            fs::create_directories(currentTempDir);
+        }
+        return currentTempDir;
+    }
+
+    fs::path testDataPath(const std::string& name) {
+        return fs::path(JTAG_TEST_DATA_DIR) / name;
+    }
+
+    ScopedDecimalCommaLocale::ScopedDecimalCommaLocale() {
+        const std::string current = std::setlocale(LC_NUMERIC, nullptr);
+        for (const char* name : { "de_DE.UTF-8", "de_DE.utf8", "es_ES.UTF-8", "fr_FR.UTF-8", "German", "Spanish" }) {
+            if (std::setlocale(LC_NUMERIC, name) && std::localeconv()->decimal_point[0] == ',') {
+                previous = current;
+                return;
+            }
+        }
+        std::setlocale(LC_NUMERIC, current.c_str());
+    }
+
+    ScopedDecimalCommaLocale::~ScopedDecimalCommaLocale() {
+        if (active()) std::setlocale(LC_NUMERIC, previous.c_str());
+    }
+
+} // namespace JTAG
+
+int main(int argc, char** argv) {
+    using namespace JTAG;
+
+    std::string filter;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--list") {
+            for (const auto& test : testRegistry()) std::cout << test.name << "\n";
+            return 0;
+        }
+        filter = arg;
+    }
+
+    size_t run = 0, failed = 0;
+    for (const auto& test : testRegistry()) {
+        if (test.name.compare(0, filter.size(), filter) != 0) continue;
+        run++;
+        currentFailures = 0;
+        try {
+            test.body();
+        }
+        catch (const TestAbort&) {
+        }
+        catch (const std::exception& e) {
+            testFailure(__FILE__, __LINE__, std::string("Unexpected exception: ") + e.what());
+        }
+        if (!currentTempDir.empty()) {
+            std::error_code ec;
+            fs::remove_all(currentTempDir, ec);
+            currentTempDir.clear();
+        }
+        if (currentFailures) failed++;
+        std::cerr << (currentFailures ? "[FAIL] " : "[ OK ] ") << test.name << "\n";
+    }
+
+    if (run == 0) {
+        std::cerr << "No tests match '" << filter << "'\n";
+        return 1;
+    }
+    std::cerr << run - failed << "/" << run << " passed\n";
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <functional>
+#include <filesystem>
+
+namespace JTAG {
+
+    // ============================================================================
+    // PRUEBAS UNITARIAS (sin dependencias externas)
+    // ============================================================================
+    // Cada caso se registra con JTAG_TEST(grupo, nombre) y se ejecuta como
+    // "grupo.nombre". jtag_tests [filtro] ejecuta los casos cuyo nombre empieza
+    // por el filtro; CTest registra un test por grupo. Un CHECK fallido se
+    // informa y el caso sigue; REQUIRE aborta el caso.
+
+    struct TestCase {
+        std::string name;
+        std::function<void()> body;
+    };
+
+    std::vector<TestCase>& testRegistry();
+
+    struct TestRegistrar {
+        TestRegistrar(std::string name, std::function<void()> body) {
+            testRegistry().push_back({ std::move(name), std::move(body) });
+        }
+    };
+
+    // Registra un fallo del caso en curso
+    void testFailure(const char* file, int line, const std::string& message);
+
+    // Lanzada por REQUIRE para abandonar el caso
+    struct TestAbort {};
+
+    // Directorio temporal propio de cada caso (se borra al terminar)
+    std::filesystem::path testTempDir();
+
+    // Ficheros de test_files/ (BSDL de ejemplo)
+    std::filesystem::path testDataPath(const std::string& name);
+
+    // LC_NUMERIC con coma decimal mientras vive (como tras el setlocale de Qt).
+    // active() es false si el sistema no tiene ninguno instalado
+    class ScopedDecimalCommaLocale {
+    public:
+        ScopedDecimalCommaLocale();
+        ~ScopedDecimalCommaLocale();
+        bool active() const { return !previous.empty(); }
+
+    private:
+        std::string previous;
+    };
+
+    template <typename A, typename B>
+    std::string describeMismatch(const char* expression, const A& actual, const B& expected) {
+        std::ostringstream out;
+        out << expression << ": got '" << actual << "', expected '" << expected << "'";
+        return out.str();
+    }
+
+} // namespace JTAG
+
+#define JTAG_TEST_CONCAT2(a, b) a##b
+#define JTAG_TEST_CONCAT(a, b) JTAG_TEST_CONCAT2(a, b)
+
+#define JTAG_TEST(group, name)                                                             \
+    static void JTAG_TEST_CONCAT(test_##group##_, name)();                                 \
+    static const ::JTAG::TestRegistrar JTAG_TEST_CONCAT(registrar_##group##_, name)(       \
+        #group "." #name, &JTAG_TEST_CONCAT(test_##group##_, name));                       \
+    static void JTAG_TEST_CONCAT(test_##group##_, name)()
+
+#define CHECK(condition)                                                                   \
+    do {                                                                                   \
+        if (!(condition)) ::JTAG::testFailure(__FILE__, __LINE__, "CHECK(" #condition ")"); \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                                         \
+    do {                                                                                   \
+        const auto& checkActual_ = (actual);                                               \
+        const auto& checkExpected_ = (expected);                                           \
+        if (!(checkActual_ == checkExpected_)) {                                           \
+            ::JTAG::testFailure(__FILE__, __LINE__,                                        \
+                ::JTAG::describeMismatch(#actual, checkActual_, checkExpected_));          \
+        }                                                                                  \
+    } while (0)
+
+#define REQUIRE(condition)                                                                 \
+    do {                                                                                   \
+        if (!(condition)) {                                                                \
+            ::JTAG::testFailure(__FILE__, __LINE__, "REQUIRE(" #condition ")");            \
+            throw ::JTAG::TestAbort{};                                                     \
+        }                                                                                  \
+    } while (0)
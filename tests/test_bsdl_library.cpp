@@ -0,0 +1,80 @@
+#include "TestHarness.h"
+#include "bsdl/BsdlLibrary.h"
+
+#include <fstream>
+
+using namespace JTAG;
+namespace fs = std::filesystem;
+
+namespace {
+
+    // Misma longitud con y sin IDCODE: un cambio que no altera el tamaño
+    const char* WITH_IDCODE =
+        "entity CHIP is\n"
+        "attribute INSTRUCTION_LENGTH of CHIP : entity is 4;\n"
+        "attribute IDCODE_REGISTER of CHIP : entity is \"0001001000110100010101100111100X\";\n"
+        "end CHIP;\n";
+    const char* WITHOUT_IDCODE =
+        "entity CHIP is\n"
+        "attribute INSTRUCTION_LENGTH of CHIP : entity is 4;\n"
+        "attribute XXXXXXXXXXXXXXX of CHIP : entity is \"0001001000110100010101100111100X\";\n"
+        "end CHIP;\n";
+
+    void writeFile(const fs::path& path, const char* text) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << text;
+    }
+
+} // namespace
+
+JTAG_TEST(bsdllib, retry_without_idcode) {
+    const fs::path dir = testTempDir() / "lib";
+    fs::create_directories(dir);
+    const fs::path file = dir / "chip.bsd";
+    writeFile(file, WITHOUT_IDCODE);
+    const auto stamp = fs::last_write_time(file);
+
+    BsdlLibrary library;
+    library.setDirectories({ dir });
+    auto stats = library.refresh(1);
+    CHECK_EQ(stats.files, size_t(1));
+    CHECK_EQ(stats.withoutIdcode, size_t(1));
+
+    // Mismo tamaño y fecha: sin IDCODE no se da por bueno y se vuelve a leer
+    writeFile(file, WITH_IDCODE);
+    fs::last_write_time(file, stamp);
+    stats = library.refresh(1);
+    CHECK_EQ(stats.scanned, size_t(1));
+    CHECK_EQ(stats.withoutIdcode, size_t(0));
+    REQUIRE(library.findByIdcode(0x12345679).size() == 1);
+    CHECK_EQ(library.findByIdcode(0x12345678)[0].entityName, std::string("CHIP"));
+
+    // Con IDCODE y sin cambios se reutiliza
+    stats = library.refresh(1);
+    CHECK_EQ(stats.scanned, size_t(0));
+    CHECK_EQ(stats.reused, size_t(1));
+}
+
+JTAG_TEST(bsdllib, prune_deleted) {
+    const fs::path dir = testTempDir() / "lib";
+    fs::create_directories(dir);
+    writeFile(dir / "a.bsd", WITH_IDCODE);
+    writeFile(dir / "b.bsdl", WITH_IDCODE);
+
+    BsdlLibrary library;
+    library.setDirectories({ dir });
+    library.setIndexPath(testTempDir() / "index.json");
+    CHECK_EQ(library.refresh(1).files, size_t(2));
+
+    fs::remove(dir / "a.bsd");
+    auto stats = library.refresh(1);
+    CHECK_EQ(stats.removed, size_t(1));
+    CHECK_EQ(library.size(), size_t(1));
+
+    // El índice en disco tampoco conserva la ruta borrada
+    BsdlLibrary reloaded;
+    reloaded.setIndexPath(testTempDir() / "index.json");
+    REQUIRE(reloaded.loadIndex());
+    REQUIRE(reloaded.size() == 1);
+    CHECK(reloaded.getEntries()[0].path.filename() == fs::path("b.bsdl"));
+}
@@ -0,0 +1,183 @@
+#include "TestHarness.h"
+#include "controller/EngineExecutor.h"
+#include "hal/drivers/MockAdapter.h"
+#include "hal/drivers/RecordingAdapter.h"
+
+#include <future>
+#include <thread>
+#include <vector>
+
+using namespace JTAG;
+
+namespace {
+
+    // Sesión MockAdapter en EXTEST (sin latencia simulada) con su executor
+    struct ExecutorFixture {
+        JtagSession session;
+        std::unique_ptr<EngineExecutor> executor;
+
+        ExecutorFixture() {
+            REQUIRE(session.connectAdapter(AdapterType::MOCK));
+            auto* recorder = static_cast<RecordingAdapter*>(session.getAdapter());
+            static_cast<MockAdapter*>(recorder->getInner())->setLatencyEnabled(false);
+            REQUIRE(session.initialize());
+            REQUIRE(session.enterEXTEST());     // Las capturas no pisan las escrituras pendientes
+            executor = std::make_unique<EngineExecutor>(session);
+        }
+
+        // Retiene el hilo del executor: lo encolado hasta release() llega en un único lote
+        struct Gate {
+            std::promise<void> open;
+            std::promise<void> entered;
+            void release() { open.set_value(); }
+        };
+
+        std::shared_ptr<Gate> hold() {
+            auto gate = std::make_shared<Gate>();
+            executor->post([gate](JtagSession&) {
+                gate->entered.set_value();
+                gate->open.get_future().wait();
+            });
+            gate->entered.get_future().wait();
+            return gate;
+        }
+
+        EngineExecutor::Stats delta(const EngineExecutor::Stats& before) const {
+            EngineExecutor::Stats now = executor->getStats();
+            return { now.commands - before.commands, now.batches - before.batches,
+                     now.scans - before.scans, now.mergedScans - before.mergedScans };
+        }
+
+        std::optional<PinLevel> cell(size_t index) {
+            return executor->call([index](JtagSession& s) { return s.getEngine()->getPin(index); });
+        }
+    };
+
+    bool allTrue(std::vector<std::future<bool>>& futures) {
+        bool ok = true;
+        for (auto& future : futures) ok &= future.get();
+        return ok;
+    }
+
+} // namespace
+
+JTAG_TEST(executor, compatible_writes_share_one_scan) {
+    ExecutorFixture fx;
+    const auto before = fx.executor->getStats();
+
+    auto gate = fx.hold();
+    std::vector<std::future<bool>> results;
+    results.push_back(fx.executor->writePins({ { 0, PinLevel::HIGH } }, true));
+    results.push_back(fx.executor->writePins({ { 8, PinLevel::LOW }, { 16, PinLevel::HIGH } }, true));
+    results.push_back(fx.executor->writePins({ { 0, PinLevel::HIGH } }, true));   // Mismo nivel: no es conflicto
+    gate->release();
+
+    CHECK(allTrue(results));
+    const auto stats = fx.delta(before);
+    CHECK_EQ(stats.commands, uint64_t(4));      // Barrera + 3 escrituras
+    CHECK_EQ(stats.scans, uint64_t(1));
+    CHECK_EQ(stats.mergedScans, uint64_t(2));
+    CHECK(fx.cell(0) == PinLevel::HIGH);
+    CHECK(fx.cell(8) == PinLevel::LOW);
+    CHECK(fx.cell(16) == PinLevel::HIGH);
+}
+
+JTAG_TEST(executor, conflicting_write_gets_its_own_scan) {
+    ExecutorFixture fx;
+    const auto before = fx.executor->getStats();
+
+    // El pulso 1 → 0 tiene que llegar al pin: dos Update-DR
+    auto gate = fx.hold();
+    std::vector<std::future<bool>> results;
+    results.push_back(fx.executor->writePins({ { 0, PinLevel::HIGH } }, true));
+    results.push_back(fx.executor->writePins({ { 0, PinLevel::LOW } }, true));
+    results.push_back(fx.executor->writePins({ { 8, PinLevel::HIGH } }, true));   // Se une al segundo grupo
+    gate->release();
+
+    CHECK(allTrue(results));
+    const auto stats = fx.delta(before);
+    CHECK_EQ(stats.scans, uint64_t(2));
+    CHECK_EQ(stats.mergedScans, uint64_t(1));
+    CHECK(fx.cell(0) == PinLevel::LOW);
+    CHECK(fx.cell(8) == PinLevel::HIGH);
+}
+
+JTAG_TEST(executor, buffered_writes_and_group_boundaries) {
+    ExecutorFixture fx;
+    const auto before = fx.executor->getStats();
+
+    auto gate = fx.hold();
+    std::vector<std::future<bool>> results;
+    // Sin Update-DR delante de una que aplica: mismo grupo, un scan
+    results.push_back(fx.executor->writePins({ { 0, PinLevel::HIGH } }, false));
+    results.push_back(fx.executor->writePins({ { 8, PinLevel::HIGH } }, true));
+    // Tras una que aplica, una sin Update-DR abre grupo propio (sin scan)
+    results.push_back(fx.executor->writePins({ { 16, PinLevel::HIGH } }, false));
+    // Una captura corta el grupo: la escritura siguiente va en otro scan
+    results.push_back(fx.executor->sample());
+    results.push_back(fx.executor->writePins({ { 24, PinLevel::HIGH } }, true));
+    gate->release();
+
+    CHECK(allTrue(results));
+    const auto stats = fx.delta(before);
+    CHECK_EQ(stats.commands, uint64_t(6));
+    CHECK_EQ(stats.scans, uint64_t(3));         // {0,8} + sample + {16,24}
+    CHECK_EQ(stats.mergedScans, uint64_t(0));
+    CHECK(fx.cell(16) == PinLevel::HIGH);
+}
+
+JTAG_TEST(executor, samples_share_one_scan) {
+    ExecutorFixture fx;
+    const auto before = fx.executor->getStats();
+
+    auto gate = fx.hold();
+    std::vector<std::future<bool>> results;
+    for (int i = 0; i < 4; ++i) results.push_back(fx.executor->sample());
+    gate->release();
+
+    CHECK(allTrue(results));
+    const auto stats = fx.delta(before);
+    CHECK_EQ(stats.scans, uint64_t(1));
+    CHECK_EQ(stats.mergedScans, uint64_t(3));
+}
+
+JTAG_TEST(executor, eight_producers) {
+    // Pensado también para -fsanitize=thread: 8 hilos encolan a la vez escrituras,
+    // capturas y barreras; solo el hilo del executor toca la sesión
+    ExecutorFixture fx;
+    constexpr int PRODUCERS = 8;
+    constexpr int ROUNDS = 200;
+    const auto before = fx.executor->getStats();
+
+    std::vector<std::thread> producers;
+    std::vector<int> failures(PRODUCERS, 0);
+    for (int p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&fx, &failures, p]() {
+            const size_t cell = static_cast<size_t>(p) * 8;   // Celdas propias: sin conflictos entre hilos
+            for (int i = 0; i < ROUNDS; ++i) {
+                const PinLevel level = (i & 1) ? PinLevel::HIGH : PinLevel::LOW;
+                std::future<bool> written = fx.executor->writePins({ { cell, level } }, true);
+                if (i % 16 == 0 && !fx.executor->sample().get()) failures[p]++;
+                if (i % 32 == 0) {
+                    const bool seen = fx.executor->call([cell](JtagSession& s) {
+                        return s.getEngine()->getPin(cell).has_value();
+                    });
+                    if (!seen) failures[p]++;
+                }
+                if (!written.get()) failures[p]++;
+            }
+        });
+    }
+    for (auto& producer : producers) producer.join();
+
+    for (int p = 0; p < PRODUCERS; ++p) CHECK_EQ(failures[p], 0);
+    const auto stats = fx.delta(before);
+    const uint64_t writes = uint64_t(PRODUCERS) * ROUNDS;
+    const uint64_t samples = uint64_t(PRODUCERS) * ((ROUNDS + 15) / 16);
+    const uint64_t calls = uint64_t(PRODUCERS) * ((ROUNDS + 31) / 32);
+    CHECK_EQ(stats.commands, writes + samples + calls);
+    // Cada escritura o captura está en un scan propio o fusionada con otra
+    CHECK_EQ(stats.scans + stats.mergedScans, writes + samples);
+    // Última escritura de cada hilo: i = ROUNDS - 1 (impar) → HIGH
+    for (int p = 0; p < PRODUCERS; ++p) CHECK(fx.cell(size_t(p) * 8) == PinLevel::HIGH);
+}
@@ -0,0 +1,104 @@
+#include "TestHarness.h"
+#include "core/Json.h"
+
+#include <iostream>
+
+using namespace JTAG;
+
+JTAG_TEST(json, parse_scalars) {
+    auto doc = JsonValue::parse(R"({"a":1,"b":-2.5,"c":true,"d":null,"e":"x"})");
+    REQUIRE(doc);
+    CHECK_EQ((*doc)["a"].asInt(), 1);
+    CHECK_EQ((*doc)["b"].asNumber(), -2.5);
+    CHECK((*doc)["c"].asBool());
+    CHECK((*doc)["d"].isNull());
+    CHECK_EQ((*doc)["e"].asString(), std::string("x"));
+    CHECK((*doc)["missing"].isNull());
+}
+
+JTAG_TEST(json, parse_nested) {
+    auto doc = JsonValue::parse(" [ {\"k\" : [1, 2, [3]]}, [] , {} ] ");
+    REQUIRE(doc);
+    REQUIRE(doc->isArray());
+    CHECK_EQ(doc->size(), size_t(3));
+    CHECK_EQ((*doc)[0]["k"][2][0].asInt(), 3);
+    CHECK((*doc)[1].isArray());
+    CHECK((*doc)[2].isObject());
+}
+
+JTAG_TEST(json, parse_escapes) {
+    auto doc = JsonValue::parse(R"(["a\"b\\c\/\n\t", "\u00e9A", "\ud83d\ude00"])");
+    REQUIRE(doc);
+    CHECK_EQ((*doc)[0].asString(), std::string("a\"b\\c/\n\t"));
+    CHECK_EQ((*doc)[1].asString(), std::string("\xC3\xA9" "A"));
+    CHECK_EQ((*doc)[2].asString(), std::string("\xF0\x9F\x98\x80"));
+}
+
+JTAG_TEST(json, reject_malformed) {
+    const char* bad[] = {
+        "", "{", "[1,]", "{\"a\" 1}", "{\"a\":1,}", "tru", "\"abc", "[1 2]",
+        "\"\\ud800\"", "\"\\udc00\"", "\"\\ud800\\u0041\"", "\"\\x\"", "1 2",
+    };
+    for (const char* text : bad) {
+        std::string error;
+        if (JsonValue::parse(text, &error)) testFailure(__FILE__, __LINE__, std::string("accepted: ") + text);
+        else CHECK(!error.empty());
+    }
+}
+
+JTAG_TEST(json, dump_roundtrip) {
+    JsonValue value = JsonValue::object();
+    value.set("int", 42);
+    value.set("neg", -7);
+    value.set("frac", 0.25);
+    value.set("text", "quote\" and \x01");
+    JsonValue list = JsonValue::array();
+    list.push(true);
+    list.push(nullptr);
+    value.set("list", std::move(list));
+
+    const std::string text = value.dump();
+    CHECK_EQ(text, std::string(R"({"int":42,"neg":-7,"frac":0.25,"text":"quote\" and \u0001","list":[true,null]})"));
+
+    auto back = JsonValue::parse(text);
+    REQUIRE(back);
+    CHECK_EQ(back->dump(), text);
+}
+
+JTAG_TEST(json, set_replaces_member) {
+    JsonValue value = JsonValue::object();
+    value.set("a", 1);
+    value.set("a", 2);
+    CHECK_EQ(value.size(), size_t(1));
+    CHECK_EQ(value["a"].asInt(), 2);
+}
+
+JTAG_TEST(json, strict_numbers) {
+    const char* bad[] = { "01", "-01", "1.", ".5", "-", "1e", "1e+", "+1", "0x10", "1.5.2", "--1", "[1,02]" };
+    for (const char* text : bad) {
+        if (JsonValue::parse(text)) testFailure(__FILE__, __LINE__, std::string("accepted: ") + text);
+    }
+    auto doc = JsonValue::parse("[0, -0, 0.5, -12.25e1, 1E+2, 3e-2]");
+    REQUIRE(doc);
+    CHECK_EQ((*doc)[0].asNumber(), 0.0);
+    CHECK_EQ((*doc)[2].asNumber(), 0.5);
+    CHECK_EQ((*doc)[3].asNumber(), -122.5);
+    CHECK_EQ((*doc)[4].asNumber(), 100.0);
+    CHECK_EQ((*doc)[5].asNumber(), 0.03);
+}
+
+JTAG_TEST(json, reject_raw_control_characters) {
+    CHECK(!JsonValue::parse("\"a\nb\""));
+    CHECK(!JsonValue::parse(std::string("\"a\x01" "b\"")));
+    CHECK(JsonValue::parse("\"a\\nb\""));
+}
+
+JTAG_TEST(json, numbers_ignore_locale) {
+    ScopedDecimalCommaLocale locale;
+    auto doc = JsonValue::parse("[2.5, 1e-3]");
+    REQUIRE(doc);
+    CHECK_EQ((*doc)[0].asNumber(), 2.5);
+    CHECK_EQ((*doc)[1].asNumber(), 1e-3);
+    CHECK_EQ(doc->dump(), std::string("[2.5,0.001]"));
+    if (!locale.active()) std::cerr << "    (no decimal-comma locale installed)\n";
+}
@@ -0,0 +1,106 @@
+#include "TestHarness.h"
+#include "bsdl/ModelCache.h"
+
+#include <fstream>
+#include <iterator>
+
+using namespace JTAG;
+namespace fs = std::filesystem;
+
+namespace {
+
+    // Mismo contenido pin a pin (nombres, números, tipos y celdas)
+    void checkSameModel(const DeviceModel& a, const DeviceModel& b) {
+        CHECK_EQ(a.getDeviceName(), b.getDeviceName());
+        CHECK_EQ(a.getIDCODE(), b.getIDCODE());
+        CHECK_EQ(a.getIRLength(), b.getIRLength());
+        CHECK_EQ(a.getBSRLength(), b.getBSRLength());
+        REQUIRE(a.getPinCount() == b.getPinCount());
+        for (size_t i = 0; i < a.getPinCount(); ++i) {
+            const PinView pa = a.getPin(i), pb = b.getPin(i);
+            CHECK_EQ(pa.name, pb.name);
+            CHECK_EQ(pa.pinNumber, pb.pinNumber);
+            CHECK(pa.type == pb.type);
+            CHECK_EQ(pa.outputCell, pb.outputCell);
+            CHECK_EQ(pa.inputCell, pb.inputCell);
+            CHECK_EQ(pa.controlCell, pb.controlCell);
+        }
+    }
+
+} // namespace
+
+JTAG_TEST(modelcache, miss_then_hit) {
+    const fs::path bsdl = testDataPath("tp1_laRVa.bsdl");
+    ModelCache cache(testTempDir() / "cache");
+
+    auto parsed = cache.load(bsdl);
+    REQUIRE(parsed);
+    CHECK(parsed->getPinCount() > 0);
+    CHECK_EQ(cache.getStats().misses, size_t(1));
+    CHECK_EQ(cache.getStats().hits, size_t(0));
+
+    auto cached = cache.load(bsdl);
+    REQUIRE(cached);
+    CHECK_EQ(cache.getStats().hits, size_t(1));
+    checkSameModel(*parsed, *cached);
+    CHECK_EQ(cached->findPin("TXD"), parsed->findPin("TXD"));
+}
+
+JTAG_TEST(modelcache, corrupt_file_is_replaced) {
+    const fs::path bsdl = testDataPath("tp1_laRVa.bsdl");
+    ModelCache cache(testTempDir() / "cache");
+    auto first = cache.load(bsdl);
+    REQUIRE(first);
+
+    // Corromper el cuerpo del .jbmc: el checksum ya no coincide
+    fs::path compiled;
+    for (const auto& entry : fs::directory_iterator(cache.getDirectory())) compiled = entry.path();
+    REQUIRE(!compiled.empty());
+    {
+        std::fstream file(compiled, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(static_cast<std::streamoff>(fs::file_size(compiled) - 1));
+        file.put('\x5A');
+    }
+
+    auto second = cache.load(bsdl);
+    REQUIRE(second);
+    CHECK_EQ(cache.getStats().invalidated, size_t(1));
+    checkSameModel(*first, *second);
+
+    auto third = cache.load(bsdl);
+    REQUIRE(third);
+    CHECK_EQ(cache.getStats().hits, size_t(1));
+}
+
+JTAG_TEST(modelcache, disabled_always_parses) {
+    ModelCache cache;
+    CHECK(!cache.isEnabled());
+    CHECK(cache.load(testDataPath("tp1_laRVa.bsdl")));
+    CHECK(cache.load(testDataPath("tp1_laRVa.bsdl")));
+    CHECK_EQ(cache.getStats().hits, size_t(0));
+    CHECK(!cache.load(testTempDir() / "missing.bsdl"));
+}
+
+JTAG_TEST(modelcache, split_phases) {
+    // lookup / parse / insert por separado (JtagSession solo bloquea lookup e insert)
+    std::ifstream in(testDataPath("tp1_laRVa.bsdl"), std::ios::binary);
+    const std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    REQUIRE(!text.empty());
+    const auto* bytes = reinterpret_cast<const uint8_t*>(text.data());
+    const uint64_t hash = fnv1a64(bytes, text.size());
+
+    ModelCache cache(testTempDir() / "cache");
+    CHECK(!cache.lookup(hash, text.size()));
+    CHECK_EQ(cache.getStats().misses, size_t(1));
+
+    auto parsed = ModelCache::parse(bytes, text.size());
+    REQUIRE(parsed);
+    cache.insert(*parsed, hash, text.size());
+    CHECK_EQ(cache.getStats().writeErrors, size_t(0));
+
+    auto cached = cache.lookup(hash, text.size());
+    REQUIRE(cached);
+    CHECK_EQ(cache.getStats().hits, size_t(1));
+    checkSameModel(*parsed, *cached);
+    CHECK(!cache.lookup(hash, text.size() + 1));   // Mismo hash, otro tamaño: obsoleto
+}
@@ -0,0 +1,165 @@
+#include "TestHarness.h"
+#include "bsdl/PinDecoder.h"
+#include "bsdl/PinNumberKey.h"
+#include "bsdl/DeviceModel.h"
+
+#include <algorithm>
+
+using namespace JTAG;
+
+// ============================================================================
+// PinNumberKey
+// ============================================================================
+
+namespace {
+
+    std::vector<std::string> sortedByKey(std::vector<std::string> numbers) {
+        std::stable_sort(numbers.begin(), numbers.end(), [](const std::string& a, const std::string& b) {
+            // Mismo criterio que DeviceModel: clave y, en empate, comparación natural
+            const auto keyA = makePinNumberKey(a), keyB = makePinNumberKey(b);
+            if (keyA.sortKey != keyB.sortKey) return keyA.sortKey < keyB.sortKey;
+            return comparePinNumbers(a, b) < 0;
+        });
+        return numbers;
+    }
+
+} // namespace
+
+JTAG_TEST(pinkey, natural_order) {
+    const std::vector<std::string> expected = { "1", "2", "10", "A1", "A2", "A10", "AA1", "B1", "B2" };
+    auto shuffled = expected;
+    std::reverse(shuffled.begin(), shuffled.end());
+    CHECK(sortedByKey(shuffled) == expected);
+}
+
+JTAG_TEST(pinkey, natural_order_on_key_ties) {
+    // Prefijos de más de 4 letras y texto tras el número empatan en la clave
+    CHECK(makePinNumberKey("ABCDE10").sortKey == makePinNumberKey("ABCDE2").sortKey);
+    CHECK(makePinNumberKey("A1B10").sortKey == makePinNumberKey("A1B2").sortKey);
+
+    const std::vector<std::string> expected = { "A1B2", "A1B10", "A1C1", "ABCDE2", "ABCDE10", "ABCDF1" };
+    auto shuffled = expected;
+    std::reverse(shuffled.begin(), shuffled.end());
+    CHECK(sortedByKey(shuffled) == expected);
+
+    CHECK(comparePinNumbers("ABCDE2", "ABCDE10") < 0);
+    CHECK(comparePinNumbers("A1B10", "A1B2") > 0);
+    CHECK(comparePinNumbers("A01", "A1") > 0);       // Mismo valor: menos ceros primero
+    CHECK(comparePinNumbers("A007B2", "A7B10") < 0); // ...pero los tramos siguientes mandan
+    CHECK(comparePinNumbers("A1", "A1") == 0);
+    CHECK(comparePinNumbers("A1", "A1B") < 0);
+}
+
+JTAG_TEST(pinkey, device_model_order) {
+    BSDLData data;
+    data.entityName = "ORDER";
+    data.boundaryLength = 4;
+    data.instructionLength = 2;
+    const char* numbers[] = { "ABCDE10", "A1B10", "ABCDE2", "A1B2", "B1" };
+    for (int i = 0; i < 5; ++i) {
+        const std::string port = "P" + std::to_string(i);
+        data.ports.push_back({ port, "linkage", "bit" });
+        data.pinMaps[port].push_back(numbers[i]);
+    }
+
+    DeviceModel model;
+    model.loadFromData(data);
+    std::vector<std::string> order;
+    for (const auto& pin : model.getAllPins()) order.emplace_back(pin.pinNumber);
+    CHECK(order == (std::vector<std::string>{ "A1B2", "A1B10", "ABCDE2", "ABCDE10", "B1" }));
+}
+
+JTAG_TEST(pinkey, grid_position) {
+    auto a1 = makePinNumberKey("A1");
+    CHECK(a1.isGrid());
+    CHECK_EQ(a1.row, 0);
+    CHECK_EQ(a1.col, 0);
+
+    auto c12 = makePinNumberKey("C12");
+    CHECK_EQ(c12.row, 2);
+    CHECK_EQ(c12.col, 11);
+
+    auto aa3 = makePinNumberKey("AA3");
+    CHECK_EQ(aa3.row, 26);
+    CHECK_EQ(aa3.col, 2);
+
+    auto numeric = makePinNumberKey("17");
+    CHECK_EQ(numeric.row, 0);
+    CHECK_EQ(numeric.col, 16);
+
+    CHECK(!makePinNumberKey("A1B").isGrid());
+    CHECK(!makePinNumberKey("VCC").isGrid());
+    CHECK(!makePinNumberKey("").isGrid());
+}
+
+// ============================================================================
+// PinDecoder
+// ============================================================================
+
+namespace {
+
+    // Pin 0: entrada 0. Pin 1: salida 1, control 2 (disable 0). Pin 2: inout
+    // (entrada 3, salida 4, control 5, disable 1). Pin 3: sin celdas.
+    PinDecodePlan makePlan() {
+        PinDecodePlan plan;
+        plan.build(6, { 0, -1, 3, -1 }, { -1, 1, 4, -1 }, { -1, 2, 5, -1 }, { -1, 0, 1, -1 });
+        return plan;
+    }
+
+} // namespace
+
+JTAG_TEST(pindecoder, decode_states) {
+    const PinDecodePlan plan = makePlan();
+    REQUIRE(plan.size() == 4);
+
+    // capture: celda 0 = 1, celda 3 = 0. drive: salida 1 = 1 con control 2 = 1
+    // (habilitada), salida 4 = 1 con control 5 = 1 (deshabilitada)
+    const uint8_t capture[] = { 0b000001 };
+    const uint8_t drive[] = { 0b110110 };
+
+    PinDecoder decoder;
+    std::vector<PinState> states;
+    decoder.decode(plan, capture, drive, states);
+    REQUIRE(states.size() == 4);
+
+    CHECK(states[0].isRead());
+    CHECK(states[0].value());
+    CHECK(!states[0].isDriven());
+
+    CHECK(!states[1].isRead());
+    CHECK(states[1].isDriven());
+    CHECK(states[1].value());           // Sin entrada: valor de la salida
+    CHECK(states[1].outputValue());
+
+    CHECK(states[2].isRead());
+    CHECK(!states[2].value());
+    CHECK(states[2].isTristated());
+    CHECK(states[2].outputValue());
+
+    CHECK(!states[3].hasData());
+
+    for (size_t pin = 0; pin < plan.size(); ++pin) {
+        CHECK_EQ(int(PinDecoder::decodePin(plan, pin, capture, drive).bits), int(states[pin].bits));
+    }
+}
+
+JTAG_TEST(pindecoder, long_chain) {
+    // 1000 pines de solo entrada: el pin i lee la celda i
+    const size_t count = 1000;
+    std::vector<int32_t> in(count), none(count, -1);
+    std::vector<int8_t> disable(count, -1);
+    for (size_t i = 0; i < count; ++i) in[i] = static_cast<int32_t>(i);
+    PinDecodePlan plan;
+    plan.build(count, in, none, none, disable);
+
+    std::vector<uint8_t> capture((count + 7) / 8);
+    for (size_t i = 0; i < count; i += 3) capture[i / 8] |= uint8_t(1u << (i % 8));
+
+    PinDecoder decoder;
+    std::vector<PinState> states;
+    decoder.decode(plan, capture.data(), capture.data(), states);
+    REQUIRE(states.size() == count);
+    size_t mismatches = 0;
+    for (size_t i = 0; i < count; ++i) mismatches += states[i].value() != (i % 3 == 0);
+    CHECK_EQ(mismatches, size_t(0));
+}
@@ -0,0 +1,174 @@
+#include "TestHarness.h"
+#include "rpc/RpcServer.h"
+
+#include <algorithm>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+using namespace JTAG;
+
+namespace {
+
+    // Servidor sin sockets: handleMessage() directamente
+    struct RpcFixture {
+        RpcServer server;
+        RpcContext context{ server, 1 };
+
+        RpcFixture() {
+            server.registerMethod("sum", [](const JsonValue& params, const RpcContext&) {
+                if (!params["a"].isNumber() || !params["b"].isNumber()) {
+                    throw RpcError{ RpcErrorCode::INVALID_PARAMS, "a and b required" };
+                }
+                return JsonValue(params["a"].asNumber() + params["b"].asNumber());
+            });
+            server.registerMethod("fail", [](const JsonValue&, const RpcContext&) -> JsonValue {
+                throw RpcError{ RpcErrorCode::OPERATION_FAILED, "boom" };
+            });
+        }
+
+        JsonValue call(const std::string& message, bool* closeConnection = nullptr) {
+            const std::string response = server.handleMessage(message, context, closeConnection);
+            if (response.empty()) return JsonValue();
+            auto parsed = JsonValue::parse(response);
+            return parsed ? *parsed : JsonValue("unparseable");
+        }
+    };
+
+} // namespace
+
+JTAG_TEST(rpc, result_and_id) {
+    RpcFixture rpc;
+    JsonValue response = rpc.call(R"({"jsonrpc":"2.0","id":7,"method":"sum","params":{"a":2,"b":3}})");
+    CHECK_EQ(response["result"].asInt(), 5);
+    CHECK_EQ(response["id"].asInt(), 7);
+    CHECK(!response.contains("error"));
+}
+
+JTAG_TEST(rpc, error_codes) {
+    RpcFixture rpc;
+    CHECK_EQ(rpc.call(R"({"id":1,"method":"nope"})")["error"]["code"].asInt(), RpcErrorCode::METHOD_NOT_FOUND);
+    CHECK_EQ(rpc.call(R"({"id":1,"method":"sum","params":{}})")["error"]["code"].asInt(), RpcErrorCode::INVALID_PARAMS);
+    CHECK_EQ(rpc.call(R"({"id":1,"method":"sum","params":3})")["error"]["code"].asInt(), RpcErrorCode::INVALID_PARAMS);
+    CHECK_EQ(rpc.call(R"({"id":1,"method":"fail"})")["error"]["code"].asInt(), RpcErrorCode::OPERATION_FAILED);
+    CHECK_EQ(rpc.call(R"({"id":1})")["error"]["code"].asInt(), RpcErrorCode::INVALID_REQUEST);
+    CHECK_EQ(rpc.call("{not json")["error"]["code"].asInt(), RpcErrorCode::PARSE_ERROR);
+    CHECK_EQ(rpc.call("[]")["error"]["code"].asInt(), RpcErrorCode::INVALID_REQUEST);
+}
+
+JTAG_TEST(rpc, notification_has_no_response) {
+    RpcFixture rpc;
+    CHECK(rpc.server.handleMessage(R"({"method":"sum","params":{"a":1,"b":1}})", rpc.context).empty());
+}
+
+JTAG_TEST(rpc, batch_in_order) {
+    RpcFixture rpc;
+    JsonValue responses = rpc.call(R"([
+        {"id":"x","method":"sum","params":{"a":1,"b":1}},
+        {"method":"sum","params":{"a":0,"b":0}},
+        {"id":"y","method":"nope"}
+    ])");
+    REQUIRE(responses.isArray());
+    REQUIRE(responses.size() == 2);
+    CHECK_EQ(responses[0]["id"].asString(), std::string("x"));
+    CHECK_EQ(responses[0]["result"].asInt(), 2);
+    CHECK_EQ(responses[1]["id"].asString(), std::string("y"));
+    CHECK_EQ(responses[1]["error"]["code"].asInt(), RpcErrorCode::METHOD_NOT_FOUND);
+}
+
+JTAG_TEST(rpc, non_json_line_closes_connection) {
+    RpcFixture rpc;
+    bool close = true;
+    CHECK_EQ(rpc.call(R"({"id":1,"method":"sum","params":{"a":1,"b":1}})", &close)["result"].asInt(), 2);
+    CHECK(!close);
+    CHECK_EQ(rpc.call("POST /rpc HTTP/1.1", &close)["error"]["code"].asInt(), RpcErrorCode::PARSE_ERROR);
+    CHECK(close);
+}
+
+JTAG_TEST(rpc, token_required_before_any_method) {
+    RpcFixture rpc;
+    rpc.server.setAuthToken(RpcServer::generateToken());
+    CHECK_EQ(rpc.server.getAuthToken().size(), size_t(32));
+    CHECK(RpcServer::generateToken() != rpc.server.getAuthToken());
+
+    bool close = false;
+    JsonValue response = rpc.call(R"({"id":1,"method":"sum","params":{"a":1,"b":1}})", &close);
+    CHECK_EQ(response["error"]["code"].asInt(), RpcErrorCode::UNAUTHORIZED);
+    CHECK(close);
+
+    // Un lote tampoco se cuela sin autenticar
+    close = false;
+    rpc.call(R"([{"id":1,"method":"rpc.auth","params":{"token":"x"}}])", &close);
+    CHECK(close);
+
+    close = false;
+    response = rpc.call(R"({"id":2,"method":"rpc.auth","params":{"token":"0123"}})", &close);
+    CHECK_EQ(response["error"]["code"].asInt(), RpcErrorCode::UNAUTHORIZED);
+    CHECK(close);
+
+    JsonValue auth = JsonValue::object();
+    auth.set("id", 3);
+    auth.set("method", "rpc.auth");
+    JsonValue params = JsonValue::object();
+    params.set("token", rpc.server.getAuthToken());
+    auth.set("params", std::move(params));
+    response = rpc.call(auth.dump(), &close);
+    CHECK(response["result"]["authenticated"].asBool(false));
+    CHECK(!close);
+
+    CHECK_EQ(rpc.call(R"({"id":4,"method":"sum","params":{"a":2,"b":2}})", &close)["result"].asInt(), 4);
+    CHECK(!close);
+
+    // Otro cliente sigue sin autenticar
+    RpcContext other(rpc.server, 2);
+    CHECK(rpc.server.handleMessage(R"({"id":5,"method":"sum","params":{"a":1,"b":1}})", other, &close)
+              .find("Authentication required") != std::string::npos);
+    CHECK(close);
+}
+
+#ifndef _WIN32
+JTAG_TEST(rpc, unix_socket_owner_only_and_closes_on_http) {
+    RpcFixture rpc;
+    rpc.server.setAuthToken("secret");
+    const auto path = testTempDir() / "rpc.sock";
+    const auto tokenPath = testTempDir() / "token" / "rpc-token";
+    REQUIRE(rpc.server.writeTokenFile(tokenPath));
+    REQUIRE(rpc.server.listenUnix(path));
+
+    struct stat info {};
+    REQUIRE(::stat(path.c_str(), &info) == 0);
+    CHECK_EQ(int(info.st_mode & 0777), 0600);
+    REQUIRE(::stat(tokenPath.c_str(), &info) == 0);
+    CHECK_EQ(int(info.st_mode & 0777), 0600);
+
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    REQUIRE(fd >= 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    REQUIRE(::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+
+    // Cabecera HTTP seguida de un cuerpo JSON válido: el cuerpo no se ejecuta
+    const std::string request = "POST / HTTP/1.1\r\n"
+                                "{\"id\":1,\"method\":\"rpc.auth\",\"params\":{\"token\":\"secret\"}}\n";
+    REQUIRE(::send(fd, request.data(), request.size(), 0) == static_cast<ssize_t>(request.size()));
+
+    std::string received;
+    char chunk[512];
+    for (ssize_t n; (n = ::recv(fd, chunk, sizeof(chunk), 0)) > 0;) received.append(chunk, size_t(n));
+    ::close(fd);
+
+    CHECK(received.find("Parse error") != std::string::npos);
+    CHECK(received.find("authenticated") == std::string::npos);
+    CHECK_EQ(std::count(received.begin(), received.end(), '\n'), std::ptrdiff_t(1));
+
+    rpc.server.stop();
+    CHECK(!std::filesystem::exists(path));
+    CHECK(!std::filesystem::exists(tokenPath));
+}
+#endif
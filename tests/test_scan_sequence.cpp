@@ -0,0 +1,30 @@
+#include "TestHarness.h"
+#include "bus/ScanSequence.h"
+#include "hal/drivers/MockAdapter.h"
+
+using namespace JTAG;
+
+JTAG_TEST(scanseq, execute_is_repeatable) {
+    MockAdapter adapter;
+    adapter.setLatencyEnabled(false);
+    REQUIRE(adapter.open());
+
+    ScanSequence seq(16, { 0x00, 0x00 });
+    seq.image()[0] = 0x01;
+    seq.commit();
+    seq.image()[1] = 0x80;
+    const size_t slot = seq.commit(true);   // Último paso observado: hace falta un scan extra
+    REQUIRE(seq.size() == 2);
+
+    // El mock devuelve en cada scan la imagen del anterior
+    REQUIRE(seq.execute(&adapter, 1));
+    CHECK_EQ(seq.size(), size_t(2));
+    CHECK_EQ(seq.getBatchCount(), size_t(3));
+    CHECK_EQ(int(seq.capture(slot)[0]), 0x01);
+    CHECK_EQ(int(seq.capture(slot)[1]), 0x80);
+
+    REQUIRE(seq.execute(&adapter));
+    CHECK_EQ(seq.size(), size_t(2));
+    CHECK_EQ(seq.getBatchCount(), size_t(1));
+    CHECK_EQ(int(seq.capture(slot)[1]), 0x80);
+}
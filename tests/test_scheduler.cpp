@@ -0,0 +1,65 @@
+#include "TestHarness.h"
+#include "controller/SampleScheduler.h"
+
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace JTAG;
+
+#if defined(__linux__)
+namespace {
+
+    cpu_set_t currentMask() {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        pthread_getaffinity_np(pthread_self(), sizeof(set), &set);
+        return set;
+    }
+
+} // namespace
+#endif
+
+// Hilo limitado de antemano (taskset/cgroups): ni cpu = -1 ni la restauración
+// deben ampliarlo a todas las CPUs de la máquina
+JTAG_TEST(scheduler, restores_original_affinity) {
+#if defined(__linux__)
+    bool sameAfterAny = false, pinned = false, sameAfterRestore = false;
+    std::thread([&]() {
+        cpu_set_t original = currentMask();
+        int first = -1;
+        for (int c = 0; c < CPU_SETSIZE && first < 0; ++c) {
+            if (CPU_ISSET(c, &original)) first = c;
+        }
+        if (first < 0) return;
+
+        cpu_set_t narrowed;
+        CPU_ZERO(&narrowed);
+        CPU_SET(first, &narrowed);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(narrowed), &narrowed) != 0) return;
+
+        SampleScheduler scheduler;
+        SchedulerOptions options;
+        options.cpu = -1;
+        scheduler.setOptions(options);
+        scheduler.applyThreadOptions();
+        cpu_set_t mask = currentMask();
+        sameAfterAny = CPU_EQUAL(&mask, &narrowed);
+
+        options.cpu = first;
+        scheduler.setOptions(options);
+        pinned = scheduler.applyThreadOptions() && scheduler.hasThreadOptionsActive();
+
+        SampleScheduler::restoreDefaultThreadOptions();
+        mask = currentMask();
+        sameAfterRestore = CPU_EQUAL(&mask, &narrowed);
+    }).join();
+
+    CHECK(sameAfterAny);
+    CHECK(pinned);
+    CHECK(sameAfterRestore);
+#endif
+}
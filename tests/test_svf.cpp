@@ -0,0 +1,126 @@
+#include "TestHarness.h"
+#include "vector/SvfParser.h"
+#include "vector/VectorCompiler.h"
+#include "vector/VectorExecutor.h"
+#include "hal/drivers/MockAdapter.h"
+
+#include <iostream>
+
+using namespace JTAG;
+
+namespace {
+
+    // Loopback TDI → TDO (MockAdapter::shiftRaw): un TDO esperado igual al TDI pasa
+    VectorExecutor::Result compileAndRun(const std::string& svf, VectorCompiler::Stats* stats = nullptr) {
+        SvfParser parser;
+        if (!parser.parseText(svf)) {
+            VectorExecutor::Result result;
+            result.error = parser.getLastError();
+            return result;
+        }
+        VectorCompiler compiler;
+        const auto jvec = testTempDir() / "test.jvec";
+        if (!compiler.compileCommands(parser.getCommands()) || !compiler.write(jvec)) {
+            VectorExecutor::Result result;
+            result.error = compiler.getLastError();
+            return result;
+        }
+        if (stats) *stats = compiler.getStats();
+
+        MockAdapter adapter;
+        adapter.setLatencyEnabled(false);
+        adapter.open();
+        VectorExecutor executor(&adapter);
+        if (!executor.open(jvec)) {
+            VectorExecutor::Result result;
+            result.error = executor.getLastError();
+            return result;
+        }
+        return executor.run();
+    }
+
+} // namespace
+
+JTAG_TEST(svf, parse_scan_lsb_first) {
+    SvfParser parser;
+    REQUIRE(parser.parseText("SDR 12 TDI (A5F) TDO (0C3) MASK (FFF);"));
+    REQUIRE(parser.getCommands().size() == 1);
+    const SvfCommand& sdr = parser.getCommands()[0];
+    CHECK(sdr.op == SvfOp::SDR);
+    CHECK_EQ(sdr.bits.length, size_t(12));
+    REQUIRE(sdr.bits.tdi.size() == 2);
+    CHECK_EQ(int(sdr.bits.tdi[0]), 0x5F);
+    CHECK_EQ(int(sdr.bits.tdi[1]), 0x0A);
+    CHECK(sdr.bits.hasTdo);
+    CHECK_EQ(int(sdr.bits.tdo[0]), 0xC3);
+}
+
+JTAG_TEST(svf, sticky_tdi_and_comments) {
+    SvfParser parser;
+    REQUIRE(parser.parseText(
+        "! comentario\n"
+        "SIR 8 TDI (3C); // otro\n"
+        "SIR 8;\n"
+        "RUNTEST 100 TCK;\n"
+        "ENDDR DRPAUSE;\n"));
+    const auto& commands = parser.getCommands();
+    REQUIRE(commands.size() == 4);
+    CHECK_EQ(int(commands[1].bits.tdi[0]), 0x3C);   // TDI heredado del SIR anterior
+    CHECK_EQ(commands[1].line, size_t(3));
+    CHECK(commands[2].op == SvfOp::RUNTEST);
+    CHECK_EQ(commands[2].runCount, uint64_t(100));
+    REQUIRE(commands[3].states.size() == 1);
+    CHECK(commands[3].states[0] == TAPState::PAUSE_DR);
+}
+
+JTAG_TEST(svf, runtest_time) {
+    SvfParser parser;
+    REQUIRE(parser.parseText("RUNTEST IDLE 1.5E-3 SEC;"));
+    REQUIRE(parser.getCommands().size() == 1);
+    CHECK_EQ(parser.getCommands()[0].minTimeSec, 1.5e-3);
+}
+
+JTAG_TEST(svf, numbers_ignore_locale) {
+    ScopedDecimalCommaLocale locale;
+    SvfParser parser;
+    REQUIRE(parser.parseText("FREQUENCY 2.5E+06 HZ;\nRUNTEST IDLE 1.5E-3 SEC;"));
+    REQUIRE(parser.getCommands().size() == 2);
+    CHECK_EQ(parser.getCommands()[0].frequencyHz, 2.5e6);
+    CHECK_EQ(parser.getCommands()[1].minTimeSec, 1.5e-3);
+    if (!locale.active()) std::cerr << "    (no decimal-comma locale installed)\n";
+}
+
+JTAG_TEST(svf, reject_invalid) {
+    SvfParser parser;
+    CHECK(!parser.parseText("SDR 8 TDI (GG);"));
+    CHECK(!parser.parseText("STATE NOWHERE;"));
+    CHECK(!parser.getLastError().empty());
+}
+
+JTAG_TEST(svf, compile_and_execute) {
+    VectorCompiler::Stats stats;
+    auto result = compileAndRun(
+        "SIR 8 TDI (02);\n"
+        "SDR 16 TDI (1234);\n"
+        "SDR 16 TDI (1234);\n"
+        "SDR 16 TDI (BEEF) TDO (BEEF) MASK (FFFF);\n", &stats);
+    CHECK(result.ok);
+    CHECK(result.error.empty());
+    CHECK_EQ(stats.commands, size_t(4));
+    // Los scans sin TDO se fusionan con el que compara: un único vector
+    CHECK_EQ(stats.vectors, size_t(1));
+}
+
+JTAG_TEST(svf, tdo_mismatch_reports_line) {
+    auto result = compileAndRun(
+        "SDR 8 TDI (AA);\n"
+        "SDR 8 TDI (55) TDO (AA) MASK (FF);\n");
+    CHECK(!result.ok);
+    CHECK_EQ(result.error, std::string("TDO mismatch"));
+    CHECK_EQ(result.sourceLine, size_t(2));
+}
+
+JTAG_TEST(svf, masked_bits_ignored) {
+    auto result = compileAndRun("SDR 8 TDI (5A) TDO (50) MASK (F0);\n");
+    CHECK(result.ok);
+}
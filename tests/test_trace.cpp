@@ -0,0 +1,68 @@
+#include "TestHarness.h"
+#include "hal/trace/TraceRecorder.h"
+
+#include <thread>
+#include <fstream>
+#include <iterator>
+#include <cstring>
+
+using namespace JTAG;
+
+namespace {
+
+    // Recorre el fichero registro a registro; false si alguno está cortado
+    bool countRecords(const std::filesystem::path& path, uint64_t& records) {
+        std::ifstream in(path, std::ios::binary);
+        std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        if (data.size() < sizeof(TraceFileHeader)) return false;
+        size_t pos = sizeof(TraceFileHeader);
+        records = 0;
+        while (pos < data.size()) {
+            if (data.size() - pos < sizeof(TraceRecordHeader)) return false;
+            TraceRecordHeader header;
+            std::memcpy(&header, data.data() + pos, sizeof(header));
+            pos += sizeof(header);
+            if (data.size() - pos < header.payloadBytes) return false;
+            for (uint32_t i = 0; i < header.payloadBytes; ++i) {
+                if (uint8_t(data[pos + i]) != uint8_t(header.numBits)) return false;
+            }
+            pos += header.payloadBytes;
+            records++;
+        }
+        return true;
+    }
+
+} // namespace
+
+JTAG_TEST(trace, stop_while_appending) {
+    // stop() desde otro hilo con un productor activo: el fichero solo contiene registros completos
+    for (int round = 0; round < 20; ++round) {
+        TraceRecorder recorder(4096);
+        const auto path = testTempDir() / ("race_" + std::to_string(round) + ".jtr");
+        REQUIRE(recorder.start(path, "test", 1000000));
+
+        std::atomic<bool> running{ true };
+        std::thread producer([&] {
+            uint8_t payload[64];
+            for (uint32_t i = 0; running.load(); ++i) {
+                TraceRecordHeader header{};
+                header.op = static_cast<uint8_t>(TraceOp::SHIFT_RAW);
+                header.numBits = i & 0xFF;
+                std::memset(payload, int(i & 0xFF), sizeof(payload));
+                recorder.append(header, payload, 1 + i % 40, payload, i % 24);
+            }
+        });
+        std::this_thread::sleep_for(std::chrono::microseconds(200 * (round % 5)));
+        recorder.stop();
+        const uint64_t recorded = recorder.getRecordCount();
+        const uint64_t bytes = recorder.getBytesWritten();
+        running.store(false);
+        producer.join();
+
+        uint64_t records = 0;
+        CHECK(countRecords(path, records));
+        CHECK_EQ(records, recorded);
+        CHECK_EQ(uint64_t(std::filesystem::file_size(path)), bytes);
+        CHECK_EQ(recorder.getRecordCount(), recorded);   // Nada entra tras stop()
+    }
+}
@@ -0,0 +1,106 @@
+#include "TestHarness.h"
+#include "monitor/TriggerEngine.h"
+
+using namespace JTAG;
+
+namespace {
+
+    // Imagen de 16 celdas con el valor dado (bit i = celda i)
+    std::vector<uint8_t> image(uint16_t value) {
+        return { static_cast<uint8_t>(value & 0xFF), static_cast<uint8_t>(value >> 8) };
+    }
+
+} // namespace
+
+JTAG_TEST(trigger, rising_edge_window) {
+    TriggerSpec spec;
+    spec.stages.push_back({ { { 3, TriggerTerm::Kind::RISING } } });
+    spec.preTriggerSamples = 2;
+    spec.postTriggerSamples = 3;
+
+    TriggerEngine engine;
+    std::string error;
+    REQUIRE(engine.configure(spec, 16, &error));
+    engine.arm();
+    CHECK(engine.isActive());
+
+    // Muestras 0..4 con la celda 3 a 0, subida en la 5
+    bool complete = false;
+    uint64_t t = 0;
+    for (int i = 0; i < 5; ++i) complete = engine.feed(image(uint16_t(i)).data(), t++);   // i < 8: celda 3 a 0
+    CHECK(!complete);
+    CHECK(engine.getState() == TriggerEngine::State::ARMED);
+
+    complete = engine.feed(image(0x0008).data(), t++);
+    CHECK(!complete);
+    CHECK(engine.getState() == TriggerEngine::State::TRIGGERED);
+    for (int i = 0; i < 3; ++i) complete = engine.feed(image(0x0008 | uint16_t(0x100 << i)).data(), t++);
+    CHECK(complete);
+    CHECK(engine.getState() == TriggerEngine::State::COMPLETE);
+
+    auto capture = engine.takeCapture();
+    REQUIRE(capture);
+    CHECK_EQ(capture->sampleCount, size_t(6));     // pre + disparo + post
+    CHECK_EQ(capture->triggerIndex, size_t(2));
+    CHECK_EQ(int(capture->sample(2)[0]), 0x08);
+    CHECK_EQ(capture->timestampsNs[0], uint64_t(3));
+    CHECK_EQ(capture->timestampsNs[5], uint64_t(8));
+    CHECK_EQ(engine.getTriggerCount(), uint64_t(1));
+    CHECK(!engine.isActive());
+}
+
+JTAG_TEST(trigger, level_sequence) {
+    // Etapa 1: celda 0 a 1; etapa 2: celda 9 a 0 y celda 10 a 1
+    TriggerSpec spec;
+    spec.stages.push_back({ { { 0, TriggerTerm::Kind::HIGH } } });
+    spec.stages.push_back({ { { 9, TriggerTerm::Kind::LOW }, { 10, TriggerTerm::Kind::HIGH } } });
+    spec.preTriggerSamples = 0;
+    spec.postTriggerSamples = 0;
+
+    TriggerEngine engine;
+    REQUIRE(engine.configure(spec, 16));
+    engine.arm();
+
+    CHECK(!engine.feed(image(0x0400).data(), 0));  // Etapa 2 cumplida antes de la 1: no cuenta
+    CHECK_EQ(engine.getCurrentStage(), size_t(0));
+    CHECK(!engine.feed(image(0x0001).data(), 1));
+    CHECK_EQ(engine.getCurrentStage(), size_t(1));
+    CHECK(!engine.feed(image(0x0600).data(), 2));  // Celda 9 a 1: no
+    CHECK(engine.feed(image(0x0400).data(), 3));
+    auto capture = engine.takeCapture();
+    REQUIRE(capture);
+    CHECK_EQ(capture->sampleCount, size_t(1));
+    CHECK_EQ(capture->timestampsNs[0], uint64_t(3));
+}
+
+JTAG_TEST(trigger, rearm) {
+    TriggerSpec spec;
+    spec.stages.push_back({ { { 1, TriggerTerm::Kind::EITHER_EDGE } } });
+    spec.preTriggerSamples = 0;
+    spec.postTriggerSamples = 0;
+    spec.rearm = true;
+
+    TriggerEngine engine;
+    REQUIRE(engine.configure(spec, 16));
+    engine.arm();
+    CHECK(!engine.feed(image(0).data(), 0));
+    CHECK(engine.feed(image(2).data(), 1));
+    CHECK(engine.takeCapture());
+    CHECK(engine.isActive());
+    // Re-armar olvida la muestra previa: el flanco se mide desde la siguiente
+    CHECK(!engine.feed(image(2).data(), 2));
+    CHECK(engine.feed(image(0).data(), 3));
+    CHECK_EQ(engine.getTriggerCount(), uint64_t(2));
+}
+
+JTAG_TEST(trigger, reject_bad_spec) {
+    TriggerEngine engine;
+    TriggerSpec empty;
+    CHECK(!engine.configure(empty, 16));
+
+    TriggerSpec outOfRange;
+    outOfRange.stages.push_back({ { { 40, TriggerTerm::Kind::HIGH } } });
+    std::string error;
+    CHECK(!engine.configure(outOfRange, 16, &error));
+    CHECK(!error.empty());
+}
@@ -0,0 +1,497 @@
+// jtag_cli - Ejecución boundary scan sin GUI para scripts de producción
+//
+// Uso: jtag_cli [opciones] <comando> [argumentos]
+//
+// Comandos:
+//   adapters                 Sondas disponibles (no abre ninguna)
+//   detect                   IDCODE de la cadena y BSDL candidatos (--library)
+//   info                     Resumen del dispositivo y lista de pines
+//   sample [pin...]          Capturas SAMPLE (--count, --interval-ms)
+//   extest PIN=0|1 ...       Entra en EXTEST, conduce los pines y relee la BSR
+//   svf <fichero.svf>        Compila a .jvec (--jvec o temporal) y lo ejecuta
+//   run <fichero.jvec>       Ejecuta vectores precompilados
+//
+// Opciones:
+//   --adapter <tipo>[:<id>]  mock (defecto), pico, jlink[:serie], replay:<traza.jtr>
+//   --clock <Hz>             Frecuencia TCK (defecto 1000000)
+//   --bsdl <fichero>         BSDL del dispositivo
+//   --library <dir>          Directorio de BSDL para autodetección por IDCODE (repetible)
+//   --cache <dir>            Caché de modelos compilados (.jbmc)
+//   --record <traza.jtr>     Graba todas las transacciones JTAG de la ejecución
+//   --verbose                Log de la librería por stderr
+//   --help                   Esta ayuda por stdout (sin JSON)
+//
+// Salida: un único objeto JSON por stdout ({"ok":...}). Código de salida 0 si
+// la operación tuvo éxito, 1 ante un error de uso y 2 si falló la operación.
+// No depende de Qt: arranca en milisegundos y puede lanzarse en paralelo en
+// varias estaciones.
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "controller/JtagSession.h"
+#include "bsdl/BsdlLibrary.h"
+#include "core/Json.h"
+#include "core/MonotonicClock.h"
+#include "hal/factory/AdapterFactory.h"
+
+using namespace JTAG;
+
+namespace {
+
+    struct CliOptions {
+        std::string adapter = "mock";
+        uint32_t clockSpeed = 1000000;
+        std::filesystem::path bsdl;
+        std::vector<std::filesystem::path> libraryDirs;
+        std::filesystem::path cacheDir;
+        std::filesystem::path record;
+        std::filesystem::path jvec;
+        size_t count = 1;
+        unsigned intervalMs = 0;
+        bool verbose = false;
+        bool help = false;
+
+        std::string command;
+        std::vector<std::string> args;
+    };
+
+    // Error de uso o de operación con el mensaje ya preparado para el JSON
+    struct CliError {
+        std::string message;
+        int exitCode;
+        bool showUsage = false;   // Error en la línea de comandos: se imprime también el uso
+    };
+
+    std::string hex32(uint32_t value) {
+        char text[11];
+        std::snprintf(text, sizeof(text), "0x%08X", value);
+        return text;
+    }
+
+    // Estado decodificado → "0"/"1"/"Z"; null si el pin no tiene celdas
+    JsonValue levelJson(PinState state) {
+        auto level = toPinLevel(state);
+        if (!level) return nullptr;
+        switch (*level) {
+        case PinLevel::HIGH:   return "1";
+        case PinLevel::LOW:    return "0";
+        default:               return "Z";
+        }
+    }
+
+    void printUsage(std::ostream& out) {
+        out << "Usage: jtag_cli [--adapter <type>[:<id>]] [--clock <Hz>] [--bsdl <file>]\n"
+               "                [--library <dir>] [--cache <dir>] [--record <trace.jtr>]\n"
+               "                [--count <n>] [--interval-ms <ms>] [--jvec <file>] [--verbose]\n"
+               "                adapters | detect | info | sample [pin...] | extest PIN=0|1...\n"
+               "                | svf <file.svf> | run <file.jvec>\n"
+               "       jtag_cli --help\n";
+    }
+
+    // Entero decimal completo dentro de [minimum, maximum]; si no, error de uso
+    uint64_t parseNumber(const std::string& option, const std::string& text, uint64_t minimum, uint64_t maximum) {
+        uint64_t value = 0;
+        const char* first = text.data();
+        const char* last = first + text.size();
+        const auto result = std::from_chars(first, last, value);
+        if (text.empty() || result.ec != std::errc() || result.ptr != last || value < minimum || value > maximum) {
+            throw CliError{ "Invalid value for " + option + ": '" + text + "' (expected an integer in " +
+                            std::to_string(minimum) + ".." + std::to_string(maximum) + ")", 1, true };
+        }
+        return value;
+    }
+
+    bool parseArgs(int argc, char* argv[], CliOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto value = [&]() -> std::string {
+                if (i + 1 >= argc) throw CliError{ "Missing value for " + arg, 1, true };
+                return argv[++i];
+            };
+
+            if (arg == "--help" || arg == "-h") options.help = true;
+            else if (arg == "--adapter")     options.adapter = value();
+            else if (arg == "--clock")       options.clockSpeed = static_cast<uint32_t>(parseNumber(arg, value(), 1, UINT32_MAX));
+            else if (arg == "--bsdl")        options.bsdl = std::filesystem::u8path(value());
+            else if (arg == "--library")     options.libraryDirs.push_back(std::filesystem::u8path(value()));
+            else if (arg == "--cache")       options.cacheDir = std::filesystem::u8path(value());
+            else if (arg == "--record")      options.record = std::filesystem::u8path(value());
+            else if (arg == "--jvec")        options.jvec = std::filesystem::u8path(value());
+            else if (arg == "--count")       options.count = static_cast<size_t>(parseNumber(arg, value(), 1, UINT32_MAX));
+            else if (arg == "--interval-ms") options.intervalMs = static_cast<unsigned>(parseNumber(arg, value(), 0, UINT32_MAX));
+            else if (arg == "--verbose")     options.verbose = true;
+            else if (arg.rfind("--", 0) == 0) throw CliError{ "Unknown option: " + arg, 1, true };
+            else if (options.command.empty()) options.command = arg;
+            else options.args.push_back(arg);
+        }
+        return options.help || !options.command.empty();
+    }
+
+    // "<tipo>[:<id>]" → descriptor para la factoría
+    AdapterDescriptor parseAdapter(const std::string& spec) {
+        AdapterDescriptor descriptor;
+        const size_t colon = spec.find(':');
+        const std::string typeName = spec.substr(0, colon);
+        const std::string id = colon == std::string::npos ? std::string() : spec.substr(colon + 1);
+
+        try {
+            descriptor.type = AdapterFactory::stringToType(typeName);
+        }
+        catch (const std::exception&) {
+            throw CliError{ "Unknown adapter type: " + typeName, 1 };
+        }
+        descriptor.name = typeName;
+        if (descriptor.type == AdapterType::JLINK && !id.empty()) descriptor.deviceID = "JLINK_" + id;
+        if (descriptor.type == AdapterType::REPLAY) {
+            if (id.empty()) throw CliError{ "replay adapter needs a trace: --adapter replay:<file.jtr>", 1 };
+            descriptor.deviceID = "REPLAY_" + id;
+        }
+        return descriptor;
+    }
+
+    // ========================================================================
+    // COMANDOS
+    // ========================================================================
+
+    class CliRunner {
+    public:
+        explicit CliRunner(const CliOptions& options) : options(options) {}
+
+        JsonValue run() {
+            static const char* const commands[] = { "detect", "info", "sample", "extest", "svf", "run" };
+            if (options.command == "adapters") return listAdapters();
+            if (std::find(std::begin(commands), std::end(commands), options.command) == std::end(commands)) {
+                throw CliError{ "Unknown command: " + options.command, 1 };
+            }
+
+            connect();
+            JsonValue result = dispatch();
+            if (session.isRecording()) {
+                session.stopRecording();
+                result.set("trace", options.record.u8string());
+            }
+            return result;
+        }
+
+    private:
+        JsonValue dispatch() {
+            if (options.command == "detect") return detect();
+            if (options.command == "info")   return info();
+            if (options.command == "sample") return sample();
+            if (options.command == "extest") return extest();
+            if (options.command == "svf")    return runSvf();
+            if (options.command == "run")    return runVectors();
+            throw CliError{ "Unknown command: " + options.command, 1 };
+        }
+
+        [[noreturn]] void failOperation(const std::string& what) {
+            const std::string& detail = session.getLastError();
+            throw CliError{ detail.empty() ? what : what + ": " + detail, 2 };
+        }
+
+        JsonValue listAdapters() {
+            JsonValue adapters = JsonValue::array();
+            for (const auto& descriptor : AdapterFactory::getAvailableAdapters()) {
+                JsonValue entry = JsonValue::object();
+                entry.set("type", AdapterFactory::typeToString(descriptor.type));
+                entry.set("name", descriptor.name);
+                entry.set("serial", descriptor.serialNumber);
+                entry.set("id", descriptor.deviceID);
+                adapters.push(std::move(entry));
+            }
+            JsonValue result = JsonValue::object();
+            result.set("adapters", std::move(adapters));
+            return result;
+        }
+
+        void connect() {
+            const AdapterDescriptor descriptor = parseAdapter(options.adapter);
+            if (!session.connectAdapter(descriptor, options.clockSpeed)) failOperation("Cannot connect adapter");
+            if (!options.cacheDir.empty()) session.setModelCacheDirectory(options.cacheDir);
+            if (!options.record.empty() && !session.startRecording(options.record)) {
+                failOperation("Cannot start recording");
+            }
+        }
+
+        std::vector<BsdlLibraryEntry> findCandidates(uint32_t idcode) {
+            if (options.libraryDirs.empty()) return {};
+            BsdlLibrary library;
+            library.setDirectories(options.libraryDirs);
+            library.refresh();
+            return library.findByIdcode(idcode);
+        }
+
+        // --bsdl explícito; si no, el modelo simulado del mock o autodetección por IDCODE
+        void requireModel() {
+            if (!options.bsdl.empty()) {
+                if (!session.loadBSDL(options.bsdl)) failOperation("Cannot load BSDL");
+                return;
+            }
+            if (session.getDeviceModel() && session.getEngine()) return;
+            if (options.libraryDirs.empty()) throw CliError{ "No device model: use --bsdl or --library", 1 };
+
+            const uint32_t idcode = session.detectDevice();
+            if (idcode == 0) failOperation("Cannot read IDCODE");
+            auto candidates = findCandidates(idcode);
+            if (candidates.empty()) throw CliError{ "No BSDL in library matches IDCODE " + hex32(idcode), 2 };
+            if (!session.loadBSDL(candidates.front().path)) failOperation("Cannot load BSDL");
+        }
+
+        JsonValue deviceJson() const {
+            const DeviceModel& model = *session.getDeviceModel();
+            JsonValue device = JsonValue::object();
+            device.set("name", model.getDeviceName());
+            device.set("package", model.getPackageInfo());
+            device.set("idcode", hex32(model.getIDCODE()));
+            device.set("irLength", static_cast<uint64_t>(model.getIRLength()));
+            device.set("bsrLength", static_cast<uint64_t>(model.getBSRLength()));
+            device.set("pins", static_cast<uint64_t>(model.getPinCount()));
+            return device;
+        }
+
+        // Pines pedidos (por nombre) o todos; índice en getAllPins()
+        std::vector<size_t> selectPins(const std::vector<std::string>& names) const {
+            const DeviceModel& model = *session.getDeviceModel();
+            std::vector<size_t> pins;
+            if (names.empty()) {
+                pins.resize(model.getPinCount());
+                for (size_t i = 0; i < pins.size(); ++i) pins[i] = i;
+                return pins;
+            }
+            for (const auto& name : names) {
+                const int32_t pin = model.findPin(name);
+                if (pin < 0) throw CliError{ "Pin not found: " + name, 1 };
+                pins.push_back(static_cast<size_t>(pin));
+            }
+            return pins;
+        }
+
+        JsonValue pinLevels(const std::vector<size_t>& pins, const uint8_t* drive) {
+            const DeviceModel& model = *session.getDeviceModel();
+            const BoundaryScanEngine& engine = *session.getEngine();
+            decoder.decode(model.getDecodePlan(), engine.getBSRCapture().data(), drive, states);
+
+            const PinRange all = model.getAllPins();
+            JsonValue levels = JsonValue::object();
+            for (size_t pin : pins) {
+                levels.set(std::string(all[pin].name), levelJson(states[pin]));
+            }
+            return levels;
+        }
+
+        JsonValue detect() {
+            const uint32_t idcode = session.detectDevice();
+            if (idcode == 0) failOperation("Cannot read IDCODE");
+
+            JsonValue result = JsonValue::object();
+            result.set("idcode", hex32(idcode));
+            result.set("manufacturer", hex32((idcode >> 1) & 0x7FF));
+            result.set("part", hex32((idcode >> 12) & 0xFFFF));
+            result.set("version", static_cast<uint32_t>(idcode >> 28));
+
+            if (!options.libraryDirs.empty()) {
+                JsonValue candidates = JsonValue::array();
+                for (const auto& entry : findCandidates(idcode)) {
+                    JsonValue candidate = JsonValue::object();
+                    candidate.set("path", entry.path.u8string());
+                    candidate.set("entity", entry.entityName);
+                    candidates.push(std::move(candidate));
+                }
+                result.set("candidates", std::move(candidates));
+            }
+            return result;
+        }
+
+        JsonValue info() {
+            requireModel();
+            const DeviceModel& model = *session.getDeviceModel();
+
+            JsonValue pins = JsonValue::array();
+            for (const PinView pin : model.getAllPins()) {
+                JsonValue entry = JsonValue::object();
+                entry.set("name", std::string(pin.name));
+                entry.set("number", std::string(pin.pinNumber));
+                entry.set("port", std::string(pin.port));
+                entry.set("type", pinTypeName(pin.type));
+                pins.push(std::move(entry));
+            }
+
+            JsonValue result = JsonValue::object();
+            result.set("device", deviceJson());
+            result.set("pins", std::move(pins));
+            return result;
+        }
+
+        JsonValue sample() {
+            requireModel();
+            const std::vector<size_t> pins = selectPins(options.args);
+            if (!session.initialize() || !session.enterSAMPLE()) failOperation("Cannot enter SAMPLE");
+
+            BoundaryScanEngine& engine = *session.getEngine();
+            JsonValue samples = JsonValue::array();
+            for (size_t i = 0; i < options.count; ++i) {
+                // enterSAMPLE ya hizo la primera captura
+                if (i > 0) {
+                    if (options.intervalMs) std::this_thread::sleep_for(std::chrono::milliseconds(options.intervalMs));
+                    if (!engine.samplePins()) failOperation("Sample failed");
+                }
+                JsonValue entry = JsonValue::object();
+                entry.set("timeNs", monotonicNowNs());
+                // En SAMPLE las salidas también se leen de la captura
+                entry.set("pins", pinLevels(pins, engine.getBSRCapture().data()));
+                samples.push(std::move(entry));
+            }
+
+            JsonValue result = JsonValue::object();
+            result.set("device", deviceJson());
+            result.set("noTarget", engine.isNoTargetDetected());
+            result.set("samples", std::move(samples));
+            return result;
+        }
+
+        JsonValue extest() {
+            requireModel();
+            if (options.args.empty()) throw CliError{ "extest needs PIN=0|1 assignments", 1 };
+
+            // Validar todo antes de tocar el TAP
+            std::vector<std::pair<std::string, PinLevel>> assignments;
+            std::vector<std::string> names;
+            for (const auto& arg : options.args) {
+                const size_t eq = arg.find('=');
+                const std::string value = eq == std::string::npos ? std::string() : arg.substr(eq + 1);
+                if (value != "0" && value != "1") throw CliError{ "Expected PIN=0|1, got: " + arg, 1 };
+                assignments.emplace_back(arg.substr(0, eq), value == "1" ? PinLevel::HIGH : PinLevel::LOW);
+                names.push_back(arg.substr(0, eq));
+            }
+            const std::vector<size_t> pins = selectPins(names);
+
+            if (!session.initialize() || !session.enterEXTEST()) failOperation("Cannot enter EXTEST");
+            for (const auto& [name, level] : assignments) {
+                if (!session.setPin(name, level)) failOperation("Cannot drive " + name);
+            }
+            if (!session.applyChanges()) failOperation("Cannot apply EXTEST vector");
+
+            JsonValue result = JsonValue::object();
+            result.set("device", deviceJson());
+            result.set("pins", pinLevels(pins, session.getEngine()->getBSR().data()));
+            return result;
+        }
+
+        JsonValue runSvf() {
+            if (options.args.size() != 1) throw CliError{ "svf needs exactly one .svf file", 1 };
+            if (!options.bsdl.empty()) requireModel();   // Solo describe la cadena en la cabecera
+
+            const std::filesystem::path svf = std::filesystem::u8path(options.args[0]);
+            const bool temporary = options.jvec.empty();
+            const std::filesystem::path jvec = temporary
+                ? std::filesystem::temp_directory_path() / (svf.stem().string() + ".jvec")
+                : options.jvec;
+
+            if (!session.compileSVF(svf, jvec)) failOperation("SVF compile failed");
+            JsonValue result = executeVectors(jvec);
+            if (temporary) {
+                std::error_code ec;
+                std::filesystem::remove(jvec, ec);
+            } else {
+                result.set("jvec", jvec.u8string());
+            }
+            return result;
+        }
+
+        JsonValue runVectors() {
+            if (options.args.size() != 1) throw CliError{ "run needs exactly one .jvec file", 1 };
+            return executeVectors(std::filesystem::u8path(options.args[0]));
+        }
+
+        JsonValue executeVectors(const std::filesystem::path& jvec) {
+            const uint64_t start = monotonicNowNs();
+            uint32_t failedLine = 0;
+            const bool ok = session.runVectorFile(jvec, &failedLine);
+            const uint64_t elapsed = monotonicNowNs() - start;
+
+            if (!ok) {
+                if (failedLine == 0) failOperation("Vector execution failed");
+                JsonValue result = JsonValue::object();
+                result.set("ok", false);
+                result.set("error", session.getLastError());
+                result.set("failedLine", failedLine);
+                result.set("elapsedNs", elapsed);
+                return result;
+            }
+
+            JsonValue result = JsonValue::object();
+            result.set("elapsedNs", elapsed);
+            return result;
+        }
+
+        const CliOptions& options;
+        JtagSession session;
+        PinDecoder decoder;
+        std::vector<PinState> states;
+    };
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    // stdout queda reservado al JSON: el log de la librería va a stderr o se descarta
+    std::ostream json(std::cout.rdbuf());
+    std::streambuf* stdoutBuffer = std::cout.rdbuf();
+
+    CliOptions options;
+    JsonValue body = JsonValue::object();
+    bool ok = true;
+    int exitCode = 0;
+
+    try {
+        if (!parseArgs(argc, argv, options)) {
+            printUsage(std::cerr);
+            return 1;
+        }
+        if (options.help) {
+            printUsage(std::cout);
+            return 0;
+        }
+        std::cout.rdbuf(options.verbose ? std::cerr.rdbuf() : nullptr);
+
+        CliRunner runner(options);
+        body = runner.run();
+        // Los vectores pueden fallar con detalle (línea SVF) sin excepción
+        if (body.contains("ok") && !body["ok"].asBool()) {
+            ok = false;
+            exitCode = 2;
+        }
+    }
+    catch (const CliError& error) {
+        if (error.showUsage) printUsage(std::cerr);
+        ok = false;
+        body = JsonValue::object();
+        body.set("error", error.message);
+        exitCode = error.exitCode;
+    }
+    catch (const std::exception& e) {
+        ok = false;
+        body = JsonValue::object();
+        body.set("error", e.what());
+        exitCode = 2;
+    }
+    std::cout.rdbuf(stdoutBuffer);
+
+    JsonValue result = JsonValue::object();
+    result.set("ok", ok);
+    result.set("command", options.command);
+    for (const auto& [key, value] : body.asObject()) {
+        if (key != "ok") result.set(key, value);
+    }
+    json << result.dump() << "\n";
+    return exitCode;
+}
@@ -0,0 +1,44 @@
+// svf2jvec - Compilador de línea de comandos SVF → vectores binarios .jvec
+//
+// Uso: svf2jvec <entrada.svf> <salida.jvec> [--chunk <bits>]
+//
+// No depende de Qt: puede usarse en la máquina de build o en CI para
+// precompilar los ficheros de programación una sola vez.
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+#include "vector/VectorCompiler.h"
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: svf2jvec <input.svf> <output.jvec> [--chunk <bits>]\n";
+        return 1;
+    }
+
+    JTAG::VectorCompiler::Options options;
+    for (int i = 3; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--chunk" && i + 1 < argc) {
+            options.maxChunkBits = std::strtoul(argv[++i], nullptr, 10);
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    JTAG::VectorCompiler compiler(options);
+    if (!compiler.compileSVF(argv[1])) {
+        std::cerr << "Error: " << compiler.getLastError() << "\n";
+        return 2;
+    }
+    if (!compiler.write(argv[2])) {
+        std::cerr << "Error: " << compiler.getLastError() << "\n";
+        return 3;
+    }
+
+    const auto& stats = compiler.getStats();
+    std::cout << "Total bits: " << stats.totalBits << "\n";
+    return 0;
+}